@@ -328,6 +328,9 @@ typedef enum sr_conn_flag_e {
                                        if the library cannot connect to the sysrepo daemon  (and return an error instead). */
     SR_CONN_DAEMON_START = 2,     /**< If sysrepo daemon is not running, and SR_CONN_DAEMON_REQUIRED was specified,
                                        start it (only if the process calling ::sr_connect is running under root privileges). */
+    SR_CONN_SHM_TRANSPORT = 4,    /**< Exchange the messages with Sysrepo Engine via shared memory instead of copying them
+                                       through the socket (the socket is used only for notifications about new messages).
+                                       Falls back to the socket if the shared memory is not supported by the engine. */
 } sr_conn_flag_t;
 
 /**
@@ -912,6 +915,45 @@ typedef enum sr_move_position_e {
     SR_MOVE_LAST = 3,      /**< Move the specified item to the position of the last child. */
 } sr_move_position_t;
 
+/**
+ * @brief Type of an operation within the batched edit (see ::sr_edit_batch).
+ */
+typedef enum sr_edit_op_type_e {
+    SR_EDIT_OP_SET,      /**< Set the value of the data element (see ::sr_set_item). */
+    SR_EDIT_OP_SET_STR,  /**< Set the value of the data element provided as string (see ::sr_set_item_str). */
+    SR_EDIT_OP_DELETE,   /**< Delete the nodes under the xpath (see ::sr_delete_item). */
+    SR_EDIT_OP_MOVE,     /**< Move the instance of an user-ordered list or leaf-list (see ::sr_move_item). */
+} sr_edit_op_type_t;
+
+/**
+ * @brief Single operation within the batched edit (see ::sr_edit_batch).
+ */
+typedef struct sr_edit_op_s {
+    sr_edit_op_type_t type;         /**< Type of the operation. */
+    const char *xpath;              /**< @ref xp_page "XPath" identifier of the data element the operation applies to. */
+    const sr_val_t *value;          /**< Value to be set (::SR_EDIT_OP_SET only, can be NULL). */
+    const char *str_value;          /**< String representation of the value to be set (::SR_EDIT_OP_SET_STR only, can be NULL). */
+    sr_edit_options_t opts;         /**< Options of the operation (::SR_EDIT_OP_SET, ::SR_EDIT_OP_SET_STR, ::SR_EDIT_OP_DELETE). */
+    sr_move_position_t position;    /**< Requested move direction (::SR_EDIT_OP_MOVE only). */
+    const char *relative_item;      /**< Relative sibling of the moved item (::SR_EDIT_OP_MOVE only, see ::sr_move_item). */
+} sr_edit_op_t;
+
+/**
+ * @brief Format of the serialized data (see ::sr_import_data).
+ */
+typedef enum sr_data_format_e {
+    SR_DATA_XML,   /**< XML instance data. */
+    SR_DATA_JSON,  /**< JSON instance data (RFC 7951). */
+} sr_data_format_t;
+
+/**
+ * @brief Mode of the data import (see ::sr_import_data).
+ */
+typedef enum sr_import_mode_e {
+    SR_IMPORT_MERGE,    /**< Merge the imported data with the current data of the module. */
+    SR_IMPORT_REPLACE,  /**< Replace all data of the module with the imported data. */
+} sr_import_mode_t;
+
 /**
  * @brief Sets the value of the leaf, leaf-list, list or presence container.
  *
@@ -981,6 +1023,45 @@ int sr_delete_item(sr_session_ctx_t *session, const char *xpath, const sr_edit_o
  */
 int sr_move_item(sr_session_ctx_t *session, const char *xpath, const sr_move_position_t position, const char *relative_item);
 
+/**
+ * @brief Applies a batch of set / delete / move operations within one request, which saves
+ * the round-trip to sysrepo for each of the operations.
+ *
+ * Operations are applied in the order in which they are provided. Each operation behaves the same way
+ * as the corresponding single-operation call (::sr_set_item, ::sr_set_item_str, ::sr_delete_item,
+ * ::sr_move_item), an operation that fails does not prevent the following operations from being applied.
+ *
+ * @see Use ::sr_get_last_errors to retrieve error information of all failed operations.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] ops Array of operations to be applied.
+ * @param[in] op_cnt Number of operations in the ops array.
+ * @param[out] results (optional) Array of op_cnt elements, filled with the error code of each operation
+ * (SR_ERR_OK for successfully applied operations).
+ *
+ * @return Error code (SR_ERR_OK if all operations have been applied successfully, otherwise the error code
+ * of the first failed operation).
+ */
+int sr_edit_batch(sr_session_ctx_t *session, const sr_edit_op_t *ops, size_t op_cnt, int *results);
+
+/**
+ * @brief Imports serialized configuration data of a module in one request. The data are parsed
+ * on the sysrepo side and either merged with or replace the current data of the module, which is much
+ * cheaper than applying the differences item by item. The import is logged as a single operation
+ * of the session, validation is postponed to ::sr_validate / ::sr_commit as with other edit calls.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] module_name Name of the module whose data are imported. The data must not contain
+ * nodes of other modules.
+ * @param[in] data Serialized configuration data.
+ * @param[in] format Format of the serialized data.
+ * @param[in] mode Whether the data are merged with or replace the current data of the module.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_import_data(sr_session_ctx_t *session, const char *module_name, const char *data, sr_data_format_t format,
+        sr_import_mode_t mode);
+
 /**
  * @brief Perform the validation of changes made in current session, but do not
  * commit nor discard them.
@@ -1053,6 +1134,78 @@ int sr_copy_config(sr_session_ctx_t *session, const char *module_name,
         sr_datastore_t src_datastore, sr_datastore_t dst_datastore);
 
 
+////////////////////////////////////////////////////////////////////////////////
+// Asynchronous Requests API
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Handle of a request sent by one of the asynchronous calls (e.g. ::sr_get_items_async),
+ * whose response has not been retrieved yet by ::sr_async_wait.
+ */
+typedef struct sr_async_req_s sr_async_req_t;
+
+/**
+ * @brief Sends the request for retrieving an array of data elements (see ::sr_get_items)
+ * without waiting for the response.
+ *
+ * Multiple requests (also within one session) can be outstanding on one connection at the same time,
+ * requests of one session are processed by sysrepo in the order in which they were sent. The response
+ * needs to be retrieved by ::sr_async_wait call, all outstanding requests of the session must be waited
+ * for before the session is stopped.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] xpath @ref xp_page "XPath" identifier of the data elements to be retrieved.
+ * @param[out] req Handle of the request, to be passed to ::sr_async_wait.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_get_items_async(sr_session_ctx_t *session, const char *xpath, sr_async_req_t **req);
+
+/**
+ * @brief Sends the request for setting the value of the given data element (see ::sr_set_item)
+ * without waiting for the response. The result needs to be retrieved by ::sr_async_wait call.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] xpath @ref xp_page "XPath" identifier of the data element to be set.
+ * @param[in] value Value to be set on specified xpath (see ::sr_set_item). Can be released right after the call.
+ * @param[in] opts Options overriding default behavior of this call.
+ * @param[out] req Handle of the request, to be passed to ::sr_async_wait.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_set_item_async(sr_session_ctx_t *session, const char *xpath, const sr_val_t *value,
+        const sr_edit_options_t opts, sr_async_req_t **req);
+
+/**
+ * @brief Sends the request for deleting the nodes under the specified xpath (see ::sr_delete_item)
+ * without waiting for the response. The result needs to be retrieved by ::sr_async_wait call.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] xpath @ref xp_page "XPath" identifier of the data element to be deleted.
+ * @param[in] opts Options overriding default behavior of this call.
+ * @param[out] req Handle of the request, to be passed to ::sr_async_wait.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_delete_item_async(sr_session_ctx_t *session, const char *xpath, const sr_edit_options_t opts, sr_async_req_t **req);
+
+/**
+ * @brief Waits for the response of a request sent by one of the asynchronous calls and returns its result.
+ * The request handle is released by this call (also in case of an error).
+ *
+ * @note Detailed error information (see ::sr_get_last_error) reflects the last completed request of the session.
+ *
+ * @param[in] req Handle of the request acquired by an asynchronous call.
+ * @param[out] values Array of requested nodes, in case of a ::sr_get_items_async request (allocated by the function,
+ * it is supposed to be freed by caller using ::sr_free_values call). Can be NULL for other requests.
+ * @param[out] value_cnt Number of returned elements in the values array. Can be NULL for other requests.
+ *
+ * @return Result of the request (SR_ERR_OK on success, SR_ERR_NOT_FOUND if a ::sr_get_items_async
+ * request matched no data, SR_ERR_TIME_OUT if the response has not arrived in time).
+ */
+int sr_async_wait(sr_async_req_t *req, sr_val_t **values, size_t *value_cnt);
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // Locking API
 ////////////////////////////////////////////////////////////////////////////////
@@ -1177,6 +1330,14 @@ typedef enum sr_subscr_flag_e {
      * and replay has finished (::SR_EV_NOTIF_REPLAY_COMPLETE is delivered).
      */
     SR_SUBSCR_NOTIF_REPLAY_FIRST = 32,
+
+    /**
+     * @brief The changes of the subscribed data are sent to the subscriber together with the ::sr_module_change_subscribe
+     * and ::sr_subtree_change_subscribe notifications. ::sr_get_changes_iter called from the callback with the xpath
+     * of the subscription (or with "/module-name:*" in case of module change subscriptions) then reads them without
+     * any further round-trips to Sysrepo Engine. Other xpaths are still served by Sysrepo Engine.
+     */
+    SR_SUBSCR_INLINE_CHANGES = 64,
 } sr_subscr_flag_t;
 
 /**
@@ -1185,6 +1346,19 @@ typedef enum sr_subscr_flag_e {
  */
 typedef uint32_t sr_subscr_options_t;
 
+/**
+ * @brief Position of the operational data cache TTL within ::sr_subscr_options_t, see ::SR_SUBSCR_DP_CACHE_TTL.
+ */
+#define SR_SUBSCR_DP_CACHE_TTL_SHIFT 16
+
+/**
+ * @brief Option of ::sr_dp_get_items_subscribe and ::sr_dp_get_items_batch_subscribe enabling caching of the provided
+ * operational data in Sysrepo Engine for given number of seconds (1 - 65535). Until the data expire (or are invalidated
+ * by ::sr_dp_cache_invalidate), requests for them are served without calling the provider.
+ * Can be bitwise OR-ed with ::sr_subscr_flag_t flags.
+ */
+#define SR_SUBSCR_DP_CACHE_TTL(seconds) ((((sr_subscr_options_t)(seconds)) & 0xFFFF) << SR_SUBSCR_DP_CACHE_TTL_SHIFT)
+
 /**
  * @brief Type of the notification event that has occurred (passed to notification callbacks).
  *
@@ -1860,6 +2034,58 @@ typedef int (*sr_dp_get_items_cb)(const char *xpath, sr_val_t **values, size_t *
 int sr_dp_get_items_subscribe(sr_session_ctx_t *session, const char *xpath, sr_dp_get_items_cb callback, void *private_ctx,
         sr_subscr_options_t opts, sr_subscription_ctx_t **subscription);
 
+/**
+ * @brief Callback to be called when operational data at the selected levels are requested.
+ * Subscribe to it by ::sr_dp_get_items_batch_subscribe call.
+ *
+ * Batch variant of ::sr_dp_get_items_cb. Sysrepo requests data of all instances of a list
+ * (or of all nested nodes of the same schema node) at once, the provider is supposed to return
+ * data for all the xpaths in a single array, following the same rules as ::sr_dp_get_items_cb.
+ *
+ * @param[in] xpaths XPaths identifying the levels under which the nodes are requested.
+ * @param[in] xpath_cnt Number of xpaths in the batch.
+ * @param[out] values Array of values at the selected levels (allocated by the provider).
+ * @param[out] values_cnt Number of values returned.
+ * @param[in] private_ctx Private context opaque to sysrepo, as passed to ::sr_dp_get_items_batch_subscribe call.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+typedef int (*sr_dp_get_items_batch_cb)(const char **xpaths, size_t xpath_cnt, sr_val_t **values, size_t *values_cnt,
+        void *private_ctx);
+
+/**
+ * @brief Registers for providing of operational data under given xpath, the provider
+ * receives the requests for multiple xpaths at once.
+ *
+ * @note The XPath must be generic - must not include any list key values.
+ * @note This API works only for operational data (subtrees marked in YANG as "config false").
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] xpath XPath identifying the subtree under which the provider is able to provide
+ * operational data.
+ * @param[in] callback Callback to be called when the operational data under given xpath are needed.
+ * @param[in] private_ctx Private context passed to the callback function, opaque to sysrepo.
+ * @param[in] opts Options overriding default behavior of the subscription, it is supposed to be
+ * a bitwise OR-ed value of any ::sr_subscr_flag_t flags.
+ * @param[in,out] subscription Subscription context that is supposed to be released by ::sr_unsubscribe.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_dp_get_items_batch_subscribe(sr_session_ctx_t *session, const char *xpath, sr_dp_get_items_batch_cb callback,
+        void *private_ctx, sr_subscr_options_t opts, sr_subscription_ctx_t **subscription);
+
+/**
+ * @brief Invalidates operational data cached in Sysrepo Engine for data providers subscribed
+ * with ::SR_SUBSCR_DP_CACHE_TTL option. Drops all cached data at, under, or above given xpath,
+ * so that they are requested from the data provider next time.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] xpath XPath identifying the changed operational data (may include list keys).
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_dp_cache_invalidate(sr_session_ctx_t *session, const char *xpath);
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Application-local File Descriptor Watcher API
@@ -32,6 +32,11 @@
 #include "request_processor.h"
 #include "access_control.h"
 
+#ifdef HAVE_SETFSUID
+#include <sys/fsuid.h>
+#include <sys/syscall.h>
+#endif
+
 /**
  * @brief Access Control module context.
  */
@@ -40,7 +45,14 @@ typedef struct ac_ctx_s {
     bool priviledged_process;     /**< Sysrepo Engine is running within an privileged process */
     uid_t proc_euid;              /**< Effective uid of the process at the time of initialization. */
     gid_t proc_egid;              /**< Effective gid of the process at the time of initialization. */
+#ifdef HAVE_SETFSUID
+    gid_t *proc_groups;           /**< Supplementary groups of the process at the time of initialization. */
+    size_t proc_group_cnt;        /**< Number of supplementary groups of the process. */
+    sr_btree_t *user_groups;      /**< Cache of supplementary groups of users (ac_user_groups_t). */
+    pthread_rwlock_t user_groups_lock;  /**< Lock guarding the user_groups cache. */
+#else
     pthread_mutex_t lock;         /**< Context lock. Used for mutual exclusion if we are changing process-wide settings. */
+#endif
 } ac_ctx_t;
 
 /**
@@ -71,6 +83,51 @@ typedef struct ac_module_info_s {
     ac_permission_t read_write_permission;  /**< Read & write permissions are granted. */
 } ac_module_info_t;
 
+#ifdef HAVE_SETFSUID
+/**
+ * @brief Supplementary groups of a user, cached in the Access Control module context.
+ */
+typedef struct ac_user_groups_s {
+    uid_t uid;        /**< User ID. */
+    gid_t gid;        /**< Primary group ID the supplementary groups were computed for. */
+    gid_t *groups;    /**< Supplementary groups of the user. */
+    size_t count;     /**< Number of supplementary groups. */
+} ac_user_groups_t;
+
+/**
+ * @brief Compares two ac_user_groups_t structures stored in the binary tree.
+ */
+static int
+ac_user_groups_cmp_cb(const void *a, const void *b)
+{
+    assert(a);
+    assert(b);
+    const ac_user_groups_t *groups_a = (const ac_user_groups_t *) a;
+    const ac_user_groups_t *groups_b = (const ac_user_groups_t *) b;
+
+    if (groups_a->uid != groups_b->uid) {
+        return (groups_a->uid < groups_b->uid) ? -1 : 1;
+    }
+    if (groups_a->gid != groups_b->gid) {
+        return (groups_a->gid < groups_b->gid) ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Frees ac_user_groups_t stored in the binary tree.
+ */
+static void
+ac_user_groups_free_cb(void *item)
+{
+    ac_user_groups_t *groups = (ac_user_groups_t *) item;
+    if (NULL != groups) {
+        free(groups->groups);
+    }
+    free(groups);
+}
+#endif
+
 /**
  * @brief Compares two ac_module_info_t structures stored in the binary tree.
  */
@@ -138,11 +195,146 @@ ac_check_file_access(const char *file_name, const ac_operation_t operation)
     return SR_ERR_OK;
 }
 
+#ifdef HAVE_SETFSUID
+
+#ifdef SYS_setgroups32
+#define AC_SYS_SETGROUPS SYS_setgroups32  /**< setgroups syscall working with 32-bit group IDs. */
+#else
+#define AC_SYS_SETGROUPS SYS_setgroups    /**< setgroups syscall. */
+#endif
+
+/**
+ * @brief Returns supplementary groups of given user (cached in the Access Control module context).
+ */
+static int
+ac_get_user_groups(ac_ctx_t *ac_ctx, const uid_t uid, const gid_t gid, const ac_user_groups_t **user_groups_p)
+{
+    ac_user_groups_t lookup = { 0, }, *user_groups = NULL, *existing = NULL;
+    char *username = NULL;
+    gid_t *tmp = NULL;
+    int group_cnt = 16, ret = 0;
+    size_t max_attempts = 10;
+    int rc = SR_ERR_OK;
+
+    lookup.uid = uid;
+    lookup.gid = gid;
+
+    pthread_rwlock_rdlock(&ac_ctx->user_groups_lock);
+    existing = sr_btree_search(ac_ctx->user_groups, &lookup);
+    pthread_rwlock_unlock(&ac_ctx->user_groups_lock);
+    if (NULL != existing) {
+        *user_groups_p = existing;
+        return SR_ERR_OK;
+    }
+
+    /* not cached yet, get the groups from the system */
+    rc = sr_get_user_name(uid, &username);
+    CHECK_RC_LOG_RETURN(rc, "Failed to get username for UID %d.", uid);
+
+    user_groups = calloc(1, sizeof(*user_groups));
+    CHECK_NULL_NOMEM_GOTO(user_groups, rc, cleanup);
+    user_groups->uid = uid;
+    user_groups->gid = gid;
+
+    user_groups->groups = calloc(group_cnt, sizeof(*user_groups->groups));
+    CHECK_NULL_NOMEM_GOTO(user_groups->groups, rc, cleanup);
+
+    while (max_attempts && (ret = getgrouplist(username, gid, user_groups->groups, &group_cnt)) < 0) {
+        tmp = realloc(user_groups->groups, group_cnt * sizeof(*tmp));
+        CHECK_NULL_NOMEM_GOTO(tmp, rc, cleanup);
+        user_groups->groups = tmp;
+        --max_attempts;
+    }
+    CHECK_NOT_MINUS1_LOG_GOTO(ret, rc, SR_ERR_INTERNAL, cleanup,
+            "Failed to get the list of supplementary groups for user '%s'.", username);
+    user_groups->count = group_cnt;
+
+    pthread_rwlock_wrlock(&ac_ctx->user_groups_lock);
+    existing = sr_btree_search(ac_ctx->user_groups, &lookup);
+    if (NULL == existing) {
+        rc = sr_btree_insert(ac_ctx->user_groups, user_groups);
+        if (SR_ERR_OK == rc) {
+            existing = user_groups;
+            user_groups = NULL;
+        }
+    }
+    pthread_rwlock_unlock(&ac_ctx->user_groups_lock);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot insert new entry into binary tree for user groups.");
+
+    *user_groups_p = existing;
+
+cleanup:
+    ac_user_groups_free_cb(user_groups);
+    free(username);
+    return rc;
+}
+
+/**
+ * @brief Sets filesystem identity of the current thread to given uid, gid and supplementary groups.
+ *
+ * Unlike seteuid / setegid / setgroups wrappers of the C library, the raw syscalls
+ * affect only the calling thread, so no process-wide mutual exclusion is needed.
+ */
+static int
+ac_set_thread_identity(const uid_t fsuid, const gid_t fsgid, const gid_t *groups, const size_t group_cnt)
+{
+    int ret = 0;
+
+    SR_LOG_DBG("Switching filesystem identity of the thread to UID='%d' and GID='%d'.", fsuid, fsgid);
+
+    /* set secondary groups (of this thread only) */
+    ret = syscall(AC_SYS_SETGROUPS, group_cnt, groups);
+    CHECK_NOT_MINUS1_LOG_RETURN(ret, SR_ERR_INTERNAL,
+            "Unable to switch the set of supplementary groups: %s", sr_strerror_safe(errno));
+
+    /* set gid, setfsgid does not report errors, check the result by reading the value back */
+    setfsgid(fsgid);
+    if ((gid_t)setfsgid(-1) != fsgid) {
+        SR_LOG_ERR("Unable to switch filesystem gid to %d.", fsgid);
+        return SR_ERR_INTERNAL;
+    }
+
+    /* set uid */
+    setfsuid(fsuid);
+    if ((uid_t)setfsuid(-1) != fsuid) {
+        SR_LOG_ERR("Unable to switch filesystem uid to %d.", fsuid);
+        return SR_ERR_INTERNAL;
+    }
+
+    return SR_ERR_OK;
+}
+
 /**
- * @brief Sets identity of current thread / process to given effective uid and gid.
+ * @brief Sets identity of current thread to given uid and gid.
  */
 static int
-ac_set_identity(const uid_t euid, const gid_t egid)
+ac_set_identity(ac_ctx_t *ac_ctx, const uid_t euid, const gid_t egid)
+{
+    const ac_user_groups_t *user_groups = NULL;
+    int rc = SR_ERR_OK;
+
+    if (euid == ac_ctx->proc_euid && egid == ac_ctx->proc_egid) {
+        /* switch back to the process identity */
+        return ac_set_thread_identity(euid, egid, ac_ctx->proc_groups, ac_ctx->proc_group_cnt);
+    }
+
+    rc = ac_get_user_groups(ac_ctx, euid, egid, &user_groups);
+    if (SR_ERR_OK != rc) {
+        return rc;
+    }
+
+    return ac_set_thread_identity(euid, egid, user_groups->groups, user_groups->count);
+}
+
+#else /* HAVE_SETFSUID */
+
+/**
+ * @brief Sets identity of the process to given effective uid and gid.
+ *
+ * @note The change is process-wide, ac_ctx->lock must be held by the caller.
+ */
+static int
+ac_set_identity(ac_ctx_t *ac_ctx, const uid_t euid, const gid_t egid)
 {
     int rc = SR_ERR_OK;
     int ret = -1;
@@ -183,6 +375,8 @@ cleanup:
     return rc;
 }
 
+#endif /* HAVE_SETFSUID */
+
 /**
  * @brief Checks if provided uid and gid can access provided file for specified operation.
  */
@@ -194,17 +388,21 @@ ac_check_file_access_with_eid(ac_ctx_t *ac_ctx, const char *file_name,
 
     CHECK_NULL_ARG2(ac_ctx, file_name);
 
+#ifndef HAVE_SETFSUID
     pthread_mutex_lock(&ac_ctx->lock);
+#endif
 
-    rc_tmp = ac_set_identity(euid, egid);
+    rc_tmp = ac_set_identity(ac_ctx, euid, egid);
 
     if (SR_ERR_OK == rc_tmp) {
         rc = ac_check_file_access(file_name, operation);
 
-        rc_tmp = ac_set_identity(ac_ctx->proc_euid, ac_ctx->proc_egid);
+        rc_tmp = ac_set_identity(ac_ctx, ac_ctx->proc_euid, ac_ctx->proc_egid);
     }
 
+#ifndef HAVE_SETFSUID
     pthread_mutex_unlock(&ac_ctx->lock);
+#endif
 
     return (SR_ERR_OK == rc_tmp) ? rc : rc_tmp;
 }
@@ -308,6 +506,9 @@ ac_init(const char *data_search_dir, ac_ctx_t **ac_ctx)
 {
     ac_ctx_t *ctx = NULL;
     int rc = SR_ERR_OK;
+#ifdef HAVE_SETFSUID
+    int ret = 0;
+#endif
 
     CHECK_NULL_ARG(ac_ctx);
 
@@ -315,7 +516,13 @@ ac_init(const char *data_search_dir, ac_ctx_t **ac_ctx)
     ctx = calloc(1, sizeof(*ctx));
     CHECK_NULL_NOMEM_RETURN(ctx);
 
+#ifdef HAVE_SETFSUID
+    pthread_rwlock_init(&ctx->user_groups_lock, NULL);
+    rc = sr_btree_init(ac_user_groups_cmp_cb, ac_user_groups_free_cb, &ctx->user_groups);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate binary tree for user groups.");
+#else
     pthread_mutex_init(&ctx->lock, NULL);
+#endif
 
     ctx->data_search_dir = strdup(data_search_dir);
     CHECK_NULL_NOMEM_GOTO(ctx->data_search_dir, rc, cleanup);
@@ -331,6 +538,23 @@ ac_init(const char *data_search_dir, ac_ctx_t **ac_ctx)
         ctx->priviledged_process = false;
     }
 
+#ifdef HAVE_SETFSUID
+    if (ctx->priviledged_process) {
+        /* save supplementary groups of the process, to be restored after each identity switch */
+        ret = getgroups(0, NULL);
+        CHECK_NOT_MINUS1_LOG_GOTO(ret, rc, SR_ERR_INTERNAL, cleanup,
+                "Unable to get supplementary groups of the process: %s", sr_strerror_safe(errno));
+        if (ret > 0) {
+            ctx->proc_groups = calloc(ret, sizeof(*ctx->proc_groups));
+            CHECK_NULL_NOMEM_GOTO(ctx->proc_groups, rc, cleanup);
+            ret = getgroups(ret, ctx->proc_groups);
+            CHECK_NOT_MINUS1_LOG_GOTO(ret, rc, SR_ERR_INTERNAL, cleanup,
+                    "Unable to get supplementary groups of the process: %s", sr_strerror_safe(errno));
+        }
+        ctx->proc_group_cnt = ret;
+    }
+#endif
+
     *ac_ctx = ctx;
     return rc;
 
@@ -344,7 +568,13 @@ ac_cleanup(ac_ctx_t *ac_ctx)
 {
     if (NULL != ac_ctx) {
         free((void*)ac_ctx->data_search_dir);
+#ifdef HAVE_SETFSUID
+        sr_btree_cleanup(ac_ctx->user_groups);
+        pthread_rwlock_destroy(&ac_ctx->user_groups_lock);
+        free(ac_ctx->proc_groups);
+#else
         pthread_mutex_destroy(&ac_ctx->lock);
+#endif
         free(ac_ctx);
     }
 }
@@ -475,17 +705,20 @@ ac_set_user_identity(ac_ctx_t *ac_ctx, const ac_ucred_t *user_credentials)
             return SR_ERR_OK;
         }
 
+#ifndef HAVE_SETFSUID
+        /* the identity switch is process-wide */
         pthread_mutex_lock(&ac_ctx->lock);
+#endif
 
         if (0 == user_credentials->r_uid) {
             /* real user-id is root */
             if (NULL != user_credentials->e_username) {
                 /* effective username was set, change identity to effective */
-                rc = ac_set_identity(user_credentials->e_uid, user_credentials->e_gid);
+                rc = ac_set_identity(ac_ctx, user_credentials->e_uid, user_credentials->e_gid);
             }
         } else {
             /* real user-id is non-root, change identity to real */
-            rc = ac_set_identity(user_credentials->r_uid, user_credentials->r_gid);
+            rc = ac_set_identity(ac_ctx, user_credentials->r_uid, user_credentials->r_gid);
         }
     }
 
@@ -505,9 +738,11 @@ ac_unset_user_identity(ac_ctx_t *ac_ctx)
     }
 
     /* set the identity back to process original */
-    rc = ac_set_identity(ac_ctx->proc_euid, ac_ctx->proc_egid);
+    rc = ac_set_identity(ac_ctx, ac_ctx->proc_euid, ac_ctx->proc_egid);
 
+#ifndef HAVE_SETFSUID
     pthread_mutex_unlock(&ac_ctx->lock);
+#endif
 
     return rc;
 }
@@ -152,6 +152,9 @@ int ac_check_file_permissions(ac_session_t *session, const char *file_name, cons
  * This call should be issued before accessing any data files for reading or
  * writing to prevent privilege escalation and TOCTOU races.
  *
+ * @note On Linux, only the filesystem identity of the calling thread is switched,
+ * other threads are not affected and can switch their identities concurrently.
+ *
  * @note On non-Linux platforms, this call will block any subsequent
  * ::ac_set_user_identity calls from other threads, until ::ac_unset_user_identity
  * is called. Therefore it is very important to always call ::ac_unset_user_identity
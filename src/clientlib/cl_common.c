@@ -25,6 +25,8 @@
 #include <inttypes.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <poll.h>
+#include <time.h>
 #include <pthread.h>
 
 #include "cl_common.h"
@@ -132,7 +134,8 @@ cl_conn_msg_buf_expand(sr_conn_ctx_t *conn_ctx, size_t required_size)
 static int
 cl_message_send(sr_conn_ctx_t *conn_ctx, Sr__Msg *msg)
 {
-    size_t msg_size = 0;
+    uint8_t *shm_data = NULL;
+    size_t msg_size = 0, frame_size = 0;
     int pos = 0, sent = 0;
     int rc = SR_ERR_OK;
 
@@ -145,22 +148,37 @@ cl_message_send(sr_conn_ctx_t *conn_ctx, Sr__Msg *msg)
         return SR_ERR_INTERNAL;
     }
 
+    if (NULL != conn_ctx->shm && sr_shm_channel_reserve(conn_ctx->shm, msg_size, &shm_data)) {
+        /* pack the message directly into the shared memory, only the doorbell goes over the socket */
+        frame_size = SR_MSG_CTRL_SIZE;
+    } else {
+        frame_size = msg_size + SR_MSG_PREAM_SIZE;
+    }
+
     /* expand the buffer if needed */
-    rc = cl_conn_msg_buf_expand(conn_ctx, msg_size + SR_MSG_PREAM_SIZE);
+    rc = cl_conn_msg_buf_expand(conn_ctx, frame_size);
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR_MSG("Cannot expand buffer for the message.");
         return rc;
     }
 
-    /* write 4-byte length */
-    sr_uint32_to_buff(msg_size, conn_ctx->msg_buf);
+    if (NULL != shm_data) {
+        /* pack the message and write the doorbell */
+        sr__msg__pack(msg, shm_data);
+        sr_shm_channel_commit(conn_ctx->shm);
+        sr_uint32_to_buff(0, conn_ctx->msg_buf);
+        sr_uint32_to_buff(SR_MSG_CTRL_SHM_DOORBELL, (conn_ctx->msg_buf + SR_MSG_PREAM_SIZE));
+    } else {
+        /* write 4-byte length */
+        sr_uint32_to_buff(msg_size, conn_ctx->msg_buf);
 
-    /* pack the message */
-    sr__msg__pack(msg, (conn_ctx->msg_buf + SR_MSG_PREAM_SIZE));
+        /* pack the message */
+        sr__msg__pack(msg, (conn_ctx->msg_buf + SR_MSG_PREAM_SIZE));
+    }
 
     /* send the message */
     do {
-        sent = send(conn_ctx->fd, (conn_ctx->msg_buf + pos), (msg_size + SR_MSG_PREAM_SIZE - pos), 0);
+        sent = send(conn_ctx->fd, (conn_ctx->msg_buf + pos), (frame_size - pos), 0);
         if (sent > 0) {
             pos += sent;
         } else {
@@ -170,92 +188,200 @@ cl_message_send(sr_conn_ctx_t *conn_ctx, Sr__Msg *msg)
             SR_LOG_ERR("Error by sending of the message: %s.", sr_strerror_safe(errno));
             return SR_ERR_DISCONNECT;
         }
-    } while ((pos < (msg_size + SR_MSG_PREAM_SIZE)) && (sent > 0));
+    } while ((pos < frame_size) && (sent > 0));
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Request waiting for the response on a connection.
+ */
+struct cl_pending_req_s {
+    uint64_t request_id;                /**< ID of the request, echoed back in the response. */
+    Sr__Operation operation;            /**< Operation of the request. */
+    sr_mem_ctx_t *sr_mem_resp;          /**< Sysrepo memory context to use for the response (can be NULL). */
+    struct timespec deadline;           /**< Time (CLOCK_REALTIME) until which the response is awaited. */
+    Sr__Msg *msg_resp;                  /**< Received response. */
+    int rc;                             /**< Result of the receiving of the response. */
+    bool done;                          /**< TRUE if the response has been received or receiving failed. */
+    bool claimed;                       /**< TRUE if the response is just being unpacked by the receiving thread. */
+    struct cl_pending_req_s *next;      /**< Next request in the linked-list. */
+};
+
+/**
+ * @brief Expands receive buffer of a connection to fit given size, if needed.
+ */
+static int
+cl_conn_recv_buf_expand(sr_conn_ctx_t *conn_ctx, size_t required_size)
+{
+    uint8_t *tmp = NULL;
+
+    CHECK_NULL_ARG(conn_ctx);
+
+    if (conn_ctx->recv_buf_size < required_size) {
+        tmp = realloc(conn_ctx->recv_buf, required_size * sizeof(*tmp));
+        if (NULL == tmp) {
+            SR_LOG_ERR("Unable to expand receive buffer of connection=%p.", (void*)conn_ctx);
+            return SR_ERR_NOMEM;
+        }
+        conn_ctx->recv_buf = tmp;
+        conn_ctx->recv_buf_size = required_size;
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Reads available data from the connection into the receive buffer, waits at most until the deadline.
+ */
+static int
+cl_conn_recv_data(sr_conn_ctx_t *conn_ctx, const struct timespec *deadline)
+{
+    struct pollfd pfd = { 0, };
+    struct timespec now = { 0, };
+    long timeout_ms = 0;
+    ssize_t len = 0;
+    int ret = 0;
+
+    pfd.fd = conn_ctx->fd;
+    pfd.events = POLLIN;
+
+    do {
+        sr_clock_get_time(CLOCK_REALTIME, &now);
+        timeout_ms = (deadline->tv_sec - now.tv_sec) * 1000 + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+        if (timeout_ms < 0) {
+            timeout_ms = 0;
+        }
+        ret = poll(&pfd, 1, (int)timeout_ms);
+    } while (-1 == ret && EINTR == errno);
+
+    if (-1 == ret) {
+        SR_LOG_ERR("Error by waiting for the message: %s.", sr_strerror_safe(errno));
+        return SR_ERR_DISCONNECT;
+    }
+    if (0 == ret) {
+        SR_LOG_ERR_MSG("While waiting for a response, timeout has expired.");
+        return SR_ERR_TIME_OUT;
+    }
+
+    do {
+        len = recv(conn_ctx->fd, (conn_ctx->recv_buf + conn_ctx->recv_buf_len),
+                (conn_ctx->recv_buf_size - conn_ctx->recv_buf_len), 0);
+    } while (-1 == len && EINTR == errno);
+
+    if (-1 == len) {
+        if (EAGAIN == errno || EWOULDBLOCK == errno) {
+            /* spurious wake-up, try again later */
+            return SR_ERR_OK;
+        }
+        SR_LOG_ERR("Error by receiving of the message: %s.", sr_strerror_safe(errno));
+        return SR_ERR_DISCONNECT;
+    }
+    if (0 == len) {
+        SR_LOG_ERR_MSG("Sysrepo server disconnected.");
+        return SR_ERR_DISCONNECT;
+    }
+    conn_ctx->recv_buf_len += len;
 
     return SR_ERR_OK;
 }
 
 /*
- * @brief Receives a message on provided connection (blocks until a message is received).
+ * @brief Receives a message frame on provided connection (blocks until a whole message is received
+ * or the deadline expires). The frame is left at the beginning of the receive buffer, bytes received
+ * beyond the frame (beginning of the following messages) are preserved. If the frame is a doorbell,
+ * the returned message data point into the shared-memory channel of the connection.
  */
 static int
-cl_message_recv(sr_conn_ctx_t *conn_ctx, Sr__Msg **msg, sr_mem_ctx_t *sr_mem_resp)
+cl_message_recv(sr_conn_ctx_t *conn_ctx, const struct timespec *deadline, const uint8_t **msg_data_p,
+        size_t *msg_size_p)
 {
-    size_t len = 0, pos = 0;
     size_t msg_size = 0;
-    sr_mem_ctx_t *sr_mem = sr_mem_resp;
-    int rc = 0;
+    int rc = SR_ERR_OK;
 
     /* expand the buffer if needed */
-    rc = cl_conn_msg_buf_expand(conn_ctx, SR_MSG_PREAM_SIZE);
+    rc = cl_conn_recv_buf_expand(conn_ctx, SR_MSG_PREAM_SIZE);
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR_MSG("Cannot expand buffer for the message.");
         return rc;
     }
 
     /* read at least first 4 bytes with length of the message */
-    while (pos < SR_MSG_PREAM_SIZE) {
-        len = recv(conn_ctx->fd, conn_ctx->msg_buf, conn_ctx->msg_buf_size, 0);
-        if (-1 == len) {
-            if (errno == EINTR) {
-                continue;
-            }
-            if (EAGAIN == errno || EWOULDBLOCK == errno) {
-                SR_LOG_ERR_MSG("While waiting for a response, timeout has expired.");
-                return SR_ERR_TIME_OUT;
+    while (conn_ctx->recv_buf_len < SR_MSG_PREAM_SIZE) {
+        rc = cl_conn_recv_data(conn_ctx, deadline);
+        if (SR_ERR_OK != rc) {
+            return rc;
+        }
+    }
+    msg_size = sr_buff_to_uint32(conn_ctx->recv_buf);
+
+    if (0 == msg_size) {
+        /* control frame, only doorbells are expected once the connection is established */
+        rc = cl_conn_recv_buf_expand(conn_ctx, SR_MSG_CTRL_SIZE);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR_MSG("Cannot expand buffer for the message.");
+            return rc;
+        }
+        while (conn_ctx->recv_buf_len < SR_MSG_CTRL_SIZE) {
+            rc = cl_conn_recv_data(conn_ctx, deadline);
+            if (SR_ERR_OK != rc) {
+                return rc;
             }
-            SR_LOG_ERR("Error by receiving of the message: %s.", sr_strerror_safe(errno));
-            return SR_ERR_DISCONNECT;
         }
-        if (0 == len) {
-            SR_LOG_ERR_MSG("Sysrepo server disconnected.");
-            return SR_ERR_DISCONNECT;
+        if (NULL == conn_ctx->shm ||
+                SR_MSG_CTRL_SHM_DOORBELL != sr_buff_to_uint32(conn_ctx->recv_buf + SR_MSG_PREAM_SIZE)) {
+            SR_LOG_ERR_MSG("Unexpected control frame received.");
+            return SR_ERR_MALFORMED_MSG;
+        }
+        rc = sr_shm_channel_peek(conn_ctx->shm, msg_data_p, msg_size_p);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR_MSG("Unable to read the message from the shared-memory channel.");
+            return SR_ERR_MALFORMED_MSG;
         }
-        pos += len;
+        return SR_ERR_OK;
     }
-    msg_size = sr_buff_to_uint32(conn_ctx->msg_buf);
 
     /* check message size bounds */
-    if ((msg_size <= 0) || (msg_size > SR_MAX_MSG_SIZE)) {
+    if (msg_size > SR_MAX_MSG_SIZE) {
         SR_LOG_ERR("Invalid message size in the message preamble (%zu).", msg_size);
         return SR_ERR_MALFORMED_MSG;
     }
 
     /* expand the buffer if needed */
-    rc = cl_conn_msg_buf_expand(conn_ctx, (msg_size + SR_MSG_PREAM_SIZE));
+    rc = cl_conn_recv_buf_expand(conn_ctx, (msg_size + SR_MSG_PREAM_SIZE));
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR_MSG("Cannot expand buffer for the message.");
         return rc;
     }
 
     /* read the rest of the message */
-    while (pos < (msg_size + SR_MSG_PREAM_SIZE)) {
-        len = recv(conn_ctx->fd, (conn_ctx->msg_buf + pos), (conn_ctx->msg_buf_size - pos), 0);
-        if (-1 == len) {
-            if (errno == EINTR) {
-                continue;
-            }
-            if (EAGAIN == errno || EWOULDBLOCK == errno) {
-                SR_LOG_ERR_MSG("While waiting for a response, timeout has expired.");
-                return SR_ERR_TIME_OUT;
-            }
-            SR_LOG_ERR("Error by receiving of the message: %s.", sr_strerror_safe(errno));
-            return SR_ERR_DISCONNECT;
-        }
-        if (0 == len) {
-            SR_LOG_ERR_MSG("Sysrepo server disconnected.");
-            return SR_ERR_DISCONNECT;
+    while (conn_ctx->recv_buf_len < (msg_size + SR_MSG_PREAM_SIZE)) {
+        rc = cl_conn_recv_data(conn_ctx, deadline);
+        if (SR_ERR_OK != rc) {
+            return rc;
         }
-        pos += len;
     }
 
-    /* unpack the message */
+    *msg_data_p = conn_ctx->recv_buf + SR_MSG_PREAM_SIZE;
+    *msg_size_p = msg_size;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Unpacks the message received by ::cl_message_recv.
+ */
+static int
+cl_message_unpack(const uint8_t *msg_data, size_t msg_size, sr_mem_ctx_t *sr_mem_resp, Sr__Msg **msg)
+{
+    sr_mem_ctx_t *sr_mem = sr_mem_resp;
+    int rc = SR_ERR_OK;
+
     if (NULL == sr_mem) {
         rc = sr_mem_new(msg_size, &sr_mem);
         CHECK_RC_MSG_RETURN(rc, "Failed to create a new Sysrepo memory context.");
     }
     ProtobufCAllocator allocator = sr_get_protobuf_allocator(sr_mem);
-    *msg = sr__msg__unpack(&allocator, msg_size, (const uint8_t*)(conn_ctx->msg_buf + SR_MSG_PREAM_SIZE));
+    *msg = sr__msg__unpack(&allocator, msg_size, msg_data);
     if (NULL == *msg) {
         if (NULL == sr_mem_resp) {
             sr_mem_free(sr_mem);
@@ -264,6 +390,9 @@ cl_message_recv(sr_conn_ctx_t *conn_ctx, Sr__Msg **msg, sr_mem_ctx_t *sr_mem_res
         return SR_ERR_MALFORMED_MSG;
     }
 
+    /* internal pointer, must never be taken over from the peer */
+    (*msg)->_packed_payload = 0;
+
     /* associate message with context */
     if (NULL != sr_mem) {
         (*msg)->_sysrepo_mem_ctx = (uint64_t)sr_mem;
@@ -273,6 +402,104 @@ cl_message_recv(sr_conn_ctx_t *conn_ctx, Sr__Msg **msg, sr_mem_ctx_t *sr_mem_res
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Removes the message frame from the beginning of the receive buffer
+ * (and the announced message from the shared-memory channel in case of a doorbell).
+ */
+static void
+cl_message_consume(sr_conn_ctx_t *conn_ctx, size_t msg_size)
+{
+    size_t frame_size = msg_size + SR_MSG_PREAM_SIZE;
+
+    if (0 == sr_buff_to_uint32(conn_ctx->recv_buf)) {
+        sr_shm_channel_consume(conn_ctx->shm);
+        frame_size = SR_MSG_CTRL_SIZE;
+    }
+
+    if (conn_ctx->recv_buf_len > frame_size) {
+        memmove(conn_ctx->recv_buf, conn_ctx->recv_buf + frame_size, conn_ctx->recv_buf_len - frame_size);
+    }
+    conn_ctx->recv_buf_len -= frame_size;
+}
+
+/**
+ * @brief Finds the pending request the response with given request ID belongs to and marks it as claimed,
+ * so that it is not abandoned while the response is being unpacked outside of the resp_lock.
+ * Expects the resp_lock of the connection to be held.
+ */
+static cl_pending_req_t *
+cl_pending_req_claim(sr_conn_ctx_t *conn_ctx, bool has_request_id, uint64_t request_id)
+{
+    cl_pending_req_t *pending = NULL;
+
+    for (pending = conn_ctx->pending_reqs; NULL != pending; pending = pending->next) {
+        if (pending->done) {
+            continue;
+        }
+        if (!has_request_id || request_id == pending->request_id) {
+            /* servers not echoing request IDs respond in the order of requests */
+            pending->claimed = true;
+            break;
+        }
+    }
+
+    if (NULL == pending) {
+        /* the request has been abandoned (e.g. timed out) */
+        SR_LOG_WRN("Discarding a response with no matching request (request id=%"PRIu64").", request_id);
+    }
+
+    return pending;
+}
+
+/**
+ * @brief Hands the unpacked response (or the error of its unpacking) over to the claimed pending request.
+ * Expects the resp_lock of the connection to be held.
+ */
+static void
+cl_response_dispatch(cl_pending_req_t *pending, int rc, Sr__Msg *msg)
+{
+    pending->claimed = false;
+    pending->rc = rc;
+    pending->msg_resp = msg;
+    pending->done = true;
+}
+
+/**
+ * @brief Marks all pending requests of the connection as failed with provided error.
+ * Expects the resp_lock of the connection to be held.
+ */
+static void
+cl_pending_reqs_fail(sr_conn_ctx_t *conn_ctx, int rc)
+{
+    for (cl_pending_req_t *pending = conn_ctx->pending_reqs; NULL != pending; pending = pending->next) {
+        if (!pending->done) {
+            pending->rc = rc;
+            pending->done = true;
+        }
+    }
+}
+
+/**
+ * @brief Removes the pending request from the list of pending requests of the connection.
+ * Expects the resp_lock of the connection to be held.
+ */
+static void
+cl_pending_req_remove(sr_conn_ctx_t *conn_ctx, cl_pending_req_t *pending)
+{
+    cl_pending_req_t *tmp = NULL, *prev = NULL;
+
+    for (tmp = conn_ctx->pending_reqs; NULL != tmp; prev = tmp, tmp = tmp->next) {
+        if (tmp == pending) {
+            if (NULL == prev) {
+                conn_ctx->pending_reqs = tmp->next;
+            } else {
+                prev->next = tmp->next;
+            }
+            break;
+        }
+    }
+}
+
 int
 cl_connection_create(sr_conn_ctx_t **conn_ctx_p)
 {
@@ -291,6 +518,23 @@ cl_connection_create(sr_conn_ctx_t **conn_ctx_p)
         return SR_ERR_INIT_FAILED;
     }
 
+    /* init response mutex and condition variable */
+    rc = pthread_mutex_init(&connection->resp_lock, NULL);
+    if (0 != rc) {
+        SR_LOG_ERR_MSG("Cannot initialize connection response mutex.");
+        pthread_mutex_destroy(&connection->lock);
+        free(connection);
+        return SR_ERR_INIT_FAILED;
+    }
+    rc = pthread_cond_init(&connection->resp_cond, NULL);
+    if (0 != rc) {
+        SR_LOG_ERR_MSG("Cannot initialize connection response condition variable.");
+        pthread_mutex_destroy(&connection->resp_lock);
+        pthread_mutex_destroy(&connection->lock);
+        free(connection);
+        return SR_ERR_INIT_FAILED;
+    }
+
     connection->fd = -1;
 
     *conn_ctx_p = connection;
@@ -312,7 +556,11 @@ cl_connection_cleanup(sr_conn_ctx_t *conn_ctx)
         }
 
         pthread_mutex_destroy(&conn_ctx->lock);
+        pthread_mutex_destroy(&conn_ctx->resp_lock);
+        pthread_cond_destroy(&conn_ctx->resp_cond);
         free(conn_ctx->msg_buf);
+        free(conn_ctx->recv_buf);
+        sr_shm_channel_cleanup(conn_ctx->shm);
         free((void*)conn_ctx->dst_address);
         if (-1 != conn_ctx->fd) {
             close(conn_ctx->fd);
@@ -409,67 +657,252 @@ cl_socket_connect(sr_conn_ctx_t *conn_ctx, const char *socket_path)
 }
 
 int
-cl_request_process(sr_session_ctx_t *session, Sr__Msg *msg_req, Sr__Msg **msg_resp,
-        sr_mem_ctx_t *sr_mem_resp, const Sr__Operation expected_response_op)
+cl_shm_channel_negotiate(sr_conn_ctx_t *conn_ctx)
+{
+    uint8_t frame[SR_MSG_CTRL_SIZE] = { 0, };
+    struct msghdr msgh = { 0, };
+    struct iovec iov = { 0, };
+    struct cmsghdr *cmsg = NULL;
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    size_t pos = 0;
+    ssize_t len = 0;
+    int fd = -1, rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG(conn_ctx);
+
+    /* request the channel */
+    sr_uint32_to_buff(0, frame);
+    sr_uint32_to_buff(SR_MSG_CTRL_SHM_REQUEST, frame + SR_MSG_PREAM_SIZE);
+    do {
+        len = send(conn_ctx->fd, frame + pos, SR_MSG_CTRL_SIZE - pos, 0);
+        if (len > 0) {
+            pos += len;
+        }
+    } while ((len > 0 && pos < SR_MSG_CTRL_SIZE) || (-1 == len && EINTR == errno));
+    if (-1 == len) {
+        SR_LOG_ERR("Error by sending of the shared-memory channel request: %s.", sr_strerror_safe(errno));
+        return SR_ERR_DISCONNECT;
+    }
+
+    /* receive the answer, the descriptor of the segment arrives along with it (receive is limited by SO_RCVTIMEO) */
+    for (pos = 0; pos < SR_MSG_CTRL_SIZE; pos += len) {
+        memset(&msgh, 0, sizeof(msgh));
+        memset(&control, 0, sizeof(control));
+        iov.iov_base = frame + pos;
+        iov.iov_len = SR_MSG_CTRL_SIZE - pos;
+        msgh.msg_iov = &iov;
+        msgh.msg_iovlen = 1;
+        msgh.msg_control = control.buf;
+        msgh.msg_controllen = sizeof(control.buf);
+        do {
+            len = recvmsg(conn_ctx->fd, &msgh, MSG_CMSG_CLOEXEC);
+        } while (-1 == len && EINTR == errno);
+        if (len <= 0) {
+            SR_LOG_ERR("Error by receiving of the shared-memory channel answer: %s.",
+                    (0 == len) ? "disconnected" : sr_strerror_safe(errno));
+            rc = SR_ERR_DISCONNECT;
+            goto cleanup;
+        }
+        for (cmsg = CMSG_FIRSTHDR(&msgh); NULL != cmsg; cmsg = CMSG_NXTHDR(&msgh, cmsg)) {
+            if (SOL_SOCKET == cmsg->cmsg_level && SCM_RIGHTS == cmsg->cmsg_type &&
+                    CMSG_LEN(sizeof(int)) == cmsg->cmsg_len && -1 == fd) {
+                memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+            }
+        }
+    }
+
+    if (0 != sr_buff_to_uint32(frame)) {
+        SR_LOG_ERR_MSG("Unexpected answer to the shared-memory channel request.");
+        rc = SR_ERR_MALFORMED_MSG;
+        goto cleanup;
+    }
+    if (SR_MSG_CTRL_SHM_ACCEPT != sr_buff_to_uint32(frame + SR_MSG_PREAM_SIZE)) {
+        SR_LOG_INF_MSG("Shared-memory channel rejected by Sysrepo Engine, using the socket only.");
+        goto cleanup;
+    }
+    if (-1 == fd) {
+        SR_LOG_ERR_MSG("Shared-memory channel accepted, but no segment has been received.");
+        rc = SR_ERR_MALFORMED_MSG;
+        goto cleanup;
+    }
+
+    rc = sr_shm_channel_attach(fd, &conn_ctx->shm);
+    if (SR_ERR_OK != rc) {
+        /* the engine would announce messages in the channel, the connection cannot be used */
+        SR_LOG_ERR_MSG("Unable to attach to the shared-memory channel.");
+        goto cleanup;
+    }
+    SR_LOG_DBG("Shared-memory channel established on fd %d.", conn_ctx->fd);
+
+cleanup:
+    if (-1 != fd) {
+        close(fd);
+    }
+    return rc;
+}
+
+int
+cl_request_send(sr_session_ctx_t *session, Sr__Msg *msg_req, sr_mem_ctx_t *sr_mem_resp,
+        const Sr__Operation expected_response_op, cl_pending_req_t **pending_p)
 {
+    sr_conn_ctx_t *conn_ctx = NULL;
+    cl_pending_req_t *pending = NULL, *tmp = NULL;
     int rc = SR_ERR_OK;
-    struct timeval tv = { 0, };
 
-    CHECK_NULL_ARG4(session, session->conn_ctx, msg_req, msg_resp);
+    CHECK_NULL_ARG4(session, session->conn_ctx, msg_req, pending_p);
+    conn_ctx = session->conn_ctx;
 
-    SR_LOG_DBG("Sending %s request.", sr_gpb_operation_name(expected_response_op));
+    pending = calloc(1, sizeof(*pending));
+    CHECK_NULL_NOMEM_RETURN(pending);
+    pending->operation = expected_response_op;
+    pending->sr_mem_resp = sr_mem_resp;
 
-    pthread_mutex_lock(&session->conn_ctx->lock);
-    /* some operation may take more time, raise the timeout */
+    /* some operation may take more time, use longer timeout */
+    sr_clock_get_time(CLOCK_REALTIME, &pending->deadline);
     if (SR__OPERATION__COMMIT == expected_response_op || SR__OPERATION__COPY_CONFIG == expected_response_op ||
             SR__OPERATION__RPC == expected_response_op || SR__OPERATION__ACTION == expected_response_op) {
-        tv.tv_sec = SR_LONG_REQUEST_TIMEOUT;
-        tv.tv_usec = 0;
-        rc = setsockopt(session->conn_ctx->fd, SOL_SOCKET, SO_RCVTIMEO, (char *)&tv, sizeof(tv));
-        if (-1 == rc) {
-            SR_LOG_WRN("Unable to set timeout for socket operations: %s", sr_strerror_safe(errno));
-        }
+        pending->deadline.tv_sec += SR_LONG_REQUEST_TIMEOUT;
+    } else {
+        pending->deadline.tv_sec += SR_REQUEST_TIMEOUT;
+    }
+
+    SR_LOG_DBG("Sending %s request.", sr_gpb_operation_name(expected_response_op));
+
+    pthread_mutex_lock(&conn_ctx->lock);
+
+    /* register the request before sending, the response may be received by another thread */
+    pthread_mutex_lock(&conn_ctx->resp_lock);
+    pending->request_id = ++conn_ctx->last_request_id;
+    if (NULL == conn_ctx->pending_reqs) {
+        conn_ctx->pending_reqs = pending;
+    } else {
+        for (tmp = conn_ctx->pending_reqs; NULL != tmp->next; tmp = tmp->next);
+        tmp->next = pending;
     }
+    pthread_mutex_unlock(&conn_ctx->resp_lock);
+
+    msg_req->has_request_id = true;
+    msg_req->request_id = pending->request_id;
 
     /* send the request */
-    rc = cl_message_send(session->conn_ctx, msg_req);
+    rc = cl_message_send(conn_ctx, msg_req);
+
+    pthread_mutex_unlock(&conn_ctx->lock);
+
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR("Unable to send the message with request (session id=%"PRIu32", operation=%s).",
                 session->id, sr_gpb_operation_name(msg_req->request->operation));
-        pthread_mutex_unlock(&session->conn_ctx->lock);
+        pthread_mutex_lock(&conn_ctx->resp_lock);
+        cl_pending_req_remove(conn_ctx, pending);
+        pthread_mutex_unlock(&conn_ctx->resp_lock);
+        free(pending);
         return rc;
     }
 
-    SR_LOG_DBG("%s request sent, waiting for response.", sr_gpb_operation_name(expected_response_op));
+    SR_LOG_DBG("%s request sent (request id=%"PRIu64").", sr_gpb_operation_name(expected_response_op),
+            pending->request_id);
 
-    /* receive the response */
-    rc = cl_message_recv(session->conn_ctx, msg_resp, sr_mem_resp);
-    if (SR_ERR_OK != rc) {
-        SR_LOG_ERR("Unable to receive the message with response (session id=%"PRIu32", operation=%s).",
-                session->id, sr_gpb_operation_name(msg_req->request->operation));
-        pthread_mutex_unlock(&session->conn_ctx->lock);
-        return rc;
-    }
+    *pending_p = pending;
+    return SR_ERR_OK;
+}
 
-    /* change socket timeout to the standard value */
-    if (SR__OPERATION__COMMIT == expected_response_op || SR__OPERATION__COPY_CONFIG == expected_response_op ||
-            SR__OPERATION__RPC == expected_response_op || SR__OPERATION__ACTION == expected_response_op) {
-        tv.tv_sec = SR_REQUEST_TIMEOUT;
-        rc = setsockopt(session->conn_ctx->fd, SOL_SOCKET, SO_RCVTIMEO, (char *)&tv, sizeof(tv));
-        if (-1 == rc) {
-            SR_LOG_WRN("Unable to set timeout for socket operations: %s", sr_strerror_safe(errno));
+int
+cl_request_wait(sr_session_ctx_t *session, cl_pending_req_t *pending, Sr__Msg **msg_resp)
+{
+    sr_conn_ctx_t *conn_ctx = NULL;
+    Sr__Operation operation = SR__OPERATION__SESSION_START;
+    Sr__Msg *msg = NULL;
+    cl_pending_req_t *target = NULL;
+    const uint8_t *msg_data = NULL;
+    size_t msg_size = 0;
+    uint64_t request_id = 0;
+    bool has_request_id = false;
+    int rc = SR_ERR_OK, unpack_rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(session, session->conn_ctx, pending, msg_resp);
+    conn_ctx = session->conn_ctx;
+    operation = pending->operation;
+
+    pthread_mutex_lock(&conn_ctx->resp_lock);
+    while (!pending->done) {
+        if (!conn_ctx->receiving) {
+            /* nobody is receiving from the connection, receive the responses in this thread */
+            conn_ctx->receiving = true;
+            pthread_mutex_unlock(&conn_ctx->resp_lock);
+
+            msg = NULL;
+            target = NULL;
+            rc = cl_message_recv(conn_ctx, &pending->deadline, &msg_data, &msg_size);
+            if (SR_ERR_OK == rc) {
+                rc = sr_gpb_msg_peek_request_id(msg_data, msg_size, &has_request_id, &request_id);
+                if (SR_ERR_OK != rc) {
+                    SR_LOG_ERR_MSG("Malformed message received.");
+                }
+            }
+            if (SR_ERR_OK == rc) {
+                /* find out where the response belongs to, so that it is unpacked only once, without holding the lock */
+                pthread_mutex_lock(&conn_ctx->resp_lock);
+                target = cl_pending_req_claim(conn_ctx, has_request_id, request_id);
+                pthread_mutex_unlock(&conn_ctx->resp_lock);
+                if (NULL != target) {
+                    unpack_rc = cl_message_unpack(msg_data, msg_size, target->sr_mem_resp, &msg);
+                }
+            }
+
+            pthread_mutex_lock(&conn_ctx->resp_lock);
+            if (SR_ERR_OK == rc) {
+                if (NULL != target) {
+                    cl_response_dispatch(target, unpack_rc, msg);
+                }
+                cl_message_consume(conn_ctx, msg_size);
+            } else if (SR_ERR_TIME_OUT == rc) {
+                /* own timeout expired, let another thread continue receiving */
+                pending->rc = rc;
+                pending->done = true;
+            } else {
+                /* the stream is broken, no other response can be received */
+                cl_pending_reqs_fail(conn_ctx, rc);
+            }
+            conn_ctx->receiving = false;
+            pthread_cond_broadcast(&conn_ctx->resp_cond);
+        } else {
+            /* wait until the receiving thread hands over the response */
+            if (pending->claimed) {
+                /* the response has already arrived and is just being unpacked */
+                rc = pthread_cond_wait(&conn_ctx->resp_cond, &conn_ctx->resp_lock);
+            } else {
+                rc = pthread_cond_timedwait(&conn_ctx->resp_cond, &conn_ctx->resp_lock, &pending->deadline);
+            }
+            if (ETIMEDOUT == rc && !pending->done && !pending->claimed) {
+                SR_LOG_ERR_MSG("While waiting for a response, timeout has expired.");
+                pending->rc = SR_ERR_TIME_OUT;
+                pending->done = true;
+            }
         }
     }
+    cl_pending_req_remove(conn_ctx, pending);
+    pthread_mutex_unlock(&conn_ctx->resp_lock);
 
-    pthread_mutex_unlock(&session->conn_ctx->lock);
+    rc = pending->rc;
+    *msg_resp = pending->msg_resp;
+    free(pending);
 
-    SR_LOG_DBG("%s response received, processing.", sr_gpb_operation_name(expected_response_op));
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Unable to receive the message with response (session id=%"PRIu32", operation=%s).",
+                session->id, sr_gpb_operation_name(operation));
+        return rc;
+    }
+
+    SR_LOG_DBG("%s response received, processing.", sr_gpb_operation_name(operation));
 
     /* validate the response */
-    rc = sr_gpb_msg_validate(*msg_resp, SR__MSG__MSG_TYPE__RESPONSE, expected_response_op);
+    rc = sr_gpb_msg_validate(*msg_resp, SR__MSG__MSG_TYPE__RESPONSE, operation);
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR("Malformed message with response received (session id=%"PRIu32", operation=%s).",
-                session->id, sr_gpb_operation_name(msg_req->request->operation));
+                session->id, sr_gpb_operation_name(operation));
         return rc;
     }
 
@@ -485,7 +918,7 @@ cl_request_process(sr_session_ctx_t *session, Sr__Msg *msg_req, Sr__Msg **msg_re
                 SR_ERR_UNAUTHORIZED != (*msg_resp)->response->result &&
                 SR_ERR_OPERATION_FAILED != (*msg_resp)->response->result) {
             SR_LOG_ERR("Error by processing of the %s request (session id=%"PRIu32"): %s.",
-                    sr_gpb_operation_name(msg_req->request->operation), session->id,
+                    sr_gpb_operation_name(operation), session->id,
                 (NULL != (*msg_resp)->response->error && NULL != (*msg_resp)->response->error->message) ?
                         (*msg_resp)->response->error->message : sr_strerror((*msg_resp)->response->result));
         }
@@ -495,6 +928,23 @@ cl_request_process(sr_session_ctx_t *session, Sr__Msg *msg_req, Sr__Msg **msg_re
     return rc;
 }
 
+int
+cl_request_process(sr_session_ctx_t *session, Sr__Msg *msg_req, Sr__Msg **msg_resp,
+        sr_mem_ctx_t *sr_mem_resp, const Sr__Operation expected_response_op)
+{
+    cl_pending_req_t *pending = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(session, session->conn_ctx, msg_req, msg_resp);
+
+    rc = cl_request_send(session, msg_req, sr_mem_resp, expected_response_op, &pending);
+    if (SR_ERR_OK != rc) {
+        return rc;
+    }
+
+    return cl_request_wait(session, pending, msg_resp);
+}
+
 int
 cl_session_set_error(sr_session_ctx_t *session, const char *error_message, const char *error_path)
 {
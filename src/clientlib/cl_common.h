@@ -26,6 +26,7 @@
 #include "sr_common.h"
 
 typedef struct cm_ctx_s cm_ctx_t;
+typedef struct cl_pending_req_s cl_pending_req_t;  /**< Forward-declaration of a request waiting for the response. */
 
 /**
  * @brief Connection context used to identify a connection to sysrepo datastore.
@@ -35,10 +36,20 @@ typedef struct sr_conn_ctx_s {
     const char *dst_address;                 /**< Destination socket address. */
     uint32_t dst_pid;                        /**< Destination PID (used only to to guarantee that there is
                                                   still the same process at the dst_address). */
-    pthread_mutex_t lock;                    /**< Mutex of the connection to guarantee that requests on the
-                                                  same connection are processed serially (one after another). */
-    uint8_t *msg_buf;                        /**< Buffer used for sending / receiving messages. */
+    pthread_mutex_t lock;                    /**< Mutex of the connection guarding the session list and sending
+                                                  of the messages (requests are sent one after another). */
+    uint8_t *msg_buf;                        /**< Buffer used for sending messages. */
     size_t msg_buf_size;                     /**< Length of the message buffer. */
+    uint8_t *recv_buf;                       /**< Buffer used for receiving messages. */
+    size_t recv_buf_size;                    /**< Length of the receive buffer. */
+    size_t recv_buf_len;                     /**< Number of received, not yet processed bytes in the receive buffer. */
+    sr_shm_channel_t *shm;                   /**< Shared-memory channel negotiated with the engine (NULL if messages
+                                                  go over the socket only). */
+    pthread_mutex_t resp_lock;               /**< Mutex guarding the list of pending requests and the receiving flag. */
+    pthread_cond_t resp_cond;                /**< Condition signalled when a pending request has been completed. */
+    cl_pending_req_t *pending_reqs;          /**< Linked-list of requests waiting for the response (in the order of sending). */
+    uint64_t last_request_id;                /**< ID assigned to the last request sent over the connection. */
+    bool receiving;                          /**< TRUE if a thread is currently receiving responses from the connection. */
     struct sr_session_list_s *session_list;  /**< Linked-list of associated sessions. */
     bool library_mode;                       /**< Determine if we are connected to sysrepo daemon
                                                   or our own sysrepo engine (library mode). */
@@ -57,6 +68,7 @@ typedef struct sr_session_ctx_s {
     size_t error_cnt;             /**< Number of errors that occurred within last API call. */
     bool notif_session;           /**< Distinguishes internal notification session from other ones. */
     uint32_t commit_id;           /**< ID of the commit in case that this is a notification session (0 otherwise). */
+    const Sr__Msg *notif_msg;     /**< Change notification being processed by a callback on this session (NULL otherwise). */
 } sr_session_ctx_t;
 
 /**
@@ -110,6 +122,49 @@ void cl_session_cleanup(sr_session_ctx_t *session);
  */
 int cl_socket_connect(sr_conn_ctx_t *conn_ctx, const char *socket_path);
 
+/**
+ * @brief Negotiates a shared-memory channel with the Sysrepo Engine on a freshly connected
+ * connection. If established, messages are packed directly into / unpacked directly from the shared
+ * memory and the socket carries only the doorbells. If the engine rejects the channel,
+ * the connection keeps using the socket only.
+ *
+ * @param[in] conn_ctx Connection context connected by ::cl_socket_connect call, no request
+ * can be sent over the connection yet.
+ *
+ * @return Error code (SR_ERR_OK on success, also if the channel has been rejected by the engine).
+ */
+int cl_shm_channel_negotiate(sr_conn_ctx_t *conn_ctx);
+
+/**
+ * @brief Sends the request over the connection without waiting for the response. Multiple requests
+ * (also within the same session) can be outstanding on one connection, responses are matched
+ * with the requests by the request ID. Requests of the same session are processed in the order of sending.
+ *
+ * @param[in] session Session context acquired by ::cl_session_create call.
+ * @param[in] msg_req GPB message with the request to be sent. Can be released right after the call.
+ * @param[in] sr_mem_resp Sysrepo memory context to use for the allocation of the response.
+ *                        If NULL, then a new context will be created.
+ * @param[in] expected_response_op Expected message type of the response.
+ * @param[out] pending Pending request context, to be passed to ::cl_request_wait.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int cl_request_send(sr_session_ctx_t *session, Sr__Msg *msg_req, sr_mem_ctx_t *sr_mem_resp,
+        const Sr__Operation expected_response_op, cl_pending_req_t **pending);
+
+/**
+ * @brief Waits for the response of the request sent by ::cl_request_send. While waiting, the calling thread
+ * may receive responses of other requests outstanding on the connection and hand them over to their owners.
+ * Pending request context is released by this call.
+ *
+ * @param[in] session Session context acquired by ::cl_session_create call.
+ * @param[in] pending Pending request context acquired by ::cl_request_send call.
+ * @param[out] msg_resp GPB message with the response.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int cl_request_wait(sr_session_ctx_t *session, cl_pending_req_t *pending, Sr__Msg **msg_resp);
+
 /**
  * @brief Processes (sends) the request over the connection and receive the response.
  *
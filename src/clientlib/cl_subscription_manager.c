@@ -691,19 +691,24 @@ cl_sm_notif_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn, Sr__Msg *msg)
             break;
         case SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS:
             SR_LOG_DBG("Calling module-change callback for subscription id=%"PRIu32".", subscription->id);
+            /* changes sent inline are read by sr_get_changes_iter from the notification */
+            data_session->notif_msg = msg;
             rc = subscription->callback.module_change_cb(
                     data_session,
                     msg->notification->module_change_notif->module_name,
                     sr_notification_event_gpb_to_sr(msg->notification->module_change_notif->event),
                     subscription->private_ctx);
+            data_session->notif_msg = NULL;
             break;
         case SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS:
             SR_LOG_DBG("Calling subtree-change callback for subscription id=%"PRIu32".", subscription->id);
+            data_session->notif_msg = msg;
             rc = subscription->callback.subtree_change_cb(
                     data_session,
                     msg->notification->subtree_change_notif->xpath,
                     sr_notification_event_gpb_to_sr(msg->notification->subtree_change_notif->event),
                     subscription->private_ctx);
+            data_session->notif_msg = NULL;
             break;
         case SR__SUBSCRIPTION_TYPE__HELLO_SUBS:
             SR_LOG_DBG("HELLO notification received on subscription id=%"PRIu32".", subscription->id);
@@ -767,6 +772,69 @@ ack:
     return rc;
 }
 
+/**
+ * @brief Calls a non-batch data provider callback for each xpath of a batched data-provide request
+ * and collects the provided values into one GPB array.
+ */
+static int
+cl_sm_dp_request_collect(cl_sm_subscription_ctx_t *subscription, const char **xpaths, size_t xpath_cnt,
+        Sr__Value ***gpb_values_p, size_t *gpb_value_cnt_p)
+{
+    Sr__Value **gpb_values = NULL, **tmp = NULL;
+    size_t gpb_value_cnt = 0;
+    sr_val_t *values = NULL, value = { 0, };
+    size_t values_cnt = 0;
+    int rc = SR_ERR_OK, cb_rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(subscription, xpaths, gpb_values_p, gpb_value_cnt_p);
+
+    for (size_t i = 0; i < xpath_cnt; i++) {
+        values = NULL;
+        values_cnt = 0;
+        rc = subscription->callback.dp_get_items_cb(xpaths[i], &values, &values_cnt, subscription->private_ctx);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_WRN("Data provider failed to provide data for xpath %s: %s.", xpaths[i], sr_strerror(rc));
+            sr_free_values(values, values_cnt);
+            cb_rc = rc;
+            continue;
+        }
+        if (0 == values_cnt) {
+            sr_free_values(values, values_cnt);
+            continue;
+        }
+        tmp = realloc(gpb_values, (gpb_value_cnt + values_cnt) * sizeof(*gpb_values));
+        if (NULL == tmp) {
+            sr_free_values(values, values_cnt);
+        }
+        CHECK_NULL_NOMEM_GOTO(tmp, rc, cleanup);
+        gpb_values = tmp;
+
+        /* values of the individual calls may live in different memory contexts, deep copy them into GPB */
+        for (size_t j = 0; j < values_cnt; j++) {
+            value = values[j];
+            value._sr_mem = NULL;
+            rc = sr_dup_val_t_to_gpb(&value, &gpb_values[gpb_value_cnt]);
+            if (SR_ERR_OK != rc) {
+                sr_free_values(values, values_cnt);
+            }
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to duplicate sr_val_t to GPB.");
+            gpb_value_cnt++;
+        }
+        sr_free_values(values, values_cnt);
+    }
+
+    *gpb_values_p = gpb_values;
+    *gpb_value_cnt_p = gpb_value_cnt;
+    return cb_rc;
+
+cleanup:
+    for (size_t i = 0; i < gpb_value_cnt; i++) {
+        sr__value__free_unpacked(gpb_values[i], NULL);
+    }
+    free(gpb_values);
+    return rc;
+}
+
 /**
  * @brief Processes an incoming data-provide request message.
  */
@@ -775,33 +843,56 @@ cl_sm_dp_request_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn, Sr__Msg *m
 {
     cl_sm_subscription_ctx_t *subscription = NULL;
     cl_sm_subscription_ctx_t subscription_lookup = { 0, };
+    Sr__DataProvideReq *dp_req = NULL;
+    Sr__DataProvideResp *dp_resp = NULL;
     Sr__Msg *resp = NULL;
     sr_mem_ctx_t *sr_mem_resp = NULL;
     sr_val_t *values = NULL;
     size_t values_cnt = 0;
+    Sr__Value **gpb_values = NULL;
+    size_t gpb_value_cnt = 0;
+    const char **xpaths = NULL;
+    size_t xpath_cnt = 0;
+    bool collected = false;
     int rc = SR_ERR_OK, cb_rc = SR_ERR_OK;
 
     CHECK_NULL_ARG4(sm_ctx, msg, msg->request, msg->request->data_provide_req);
 
-    SR_LOG_DBG("Received a data-provide request for subscription id=%"PRIu32".", msg->request->data_provide_req->subscription_id);
+    dp_req = msg->request->data_provide_req;
+    if (dp_req->n_xpaths > 0) {
+        xpaths = (const char **) dp_req->xpaths;
+        xpath_cnt = dp_req->n_xpaths;
+    } else {
+        xpaths = (const char **) &dp_req->xpath;
+        xpath_cnt = 1;
+    }
+
+    SR_LOG_DBG("Received a data-provide request (%zu xpaths) for subscription id=%"PRIu32".", xpath_cnt,
+            dp_req->subscription_id);
 
     pthread_mutex_lock(&sm_ctx->subscriptions_lock);
 
     /* find the subscription according to id */
-    subscription_lookup.id = msg->request->data_provide_req->subscription_id;
+    subscription_lookup.id = dp_req->subscription_id;
     subscription = sr_btree_search(sm_ctx->subscriptions_btree, &subscription_lookup);
     if (NULL == subscription) {
         pthread_mutex_unlock(&sm_ctx->subscriptions_lock);
-        SR_LOG_ERR("No matching subscription for subscription id=%"PRIu32".", msg->request->data_provide_req->subscription_id);
+        SR_LOG_ERR("No matching subscription for subscription id=%"PRIu32".", dp_req->subscription_id);
         goto cleanup;
     }
 
-    SR_LOG_DBG("Calling dp_get_items_cb callback for subscription id=%"PRIu32".", subscription->id);
-
-    cb_rc = subscription->callback.dp_get_items_cb(
-            msg->request->data_provide_req->xpath,
-            &values, &values_cnt,
-            subscription->private_ctx);
+    if (subscription->dp_batch) {
+        SR_LOG_DBG("Calling dp_get_items_batch_cb callback for subscription id=%"PRIu32".", subscription->id);
+        cb_rc = subscription->callback.dp_get_items_batch_cb(xpaths, xpath_cnt, &values, &values_cnt,
+                subscription->private_ctx);
+    } else if (1 == xpath_cnt) {
+        SR_LOG_DBG("Calling dp_get_items_cb callback for subscription id=%"PRIu32".", subscription->id);
+        cb_rc = subscription->callback.dp_get_items_cb(xpaths[0], &values, &values_cnt, subscription->private_ctx);
+    } else {
+        SR_LOG_DBG("Calling dp_get_items_cb callback %zu times for subscription id=%"PRIu32".", xpath_cnt, subscription->id);
+        cb_rc = cl_sm_dp_request_collect(subscription, xpaths, xpath_cnt, &gpb_values, &gpb_value_cnt);
+        collected = true;
+    }
 
     pthread_mutex_unlock(&sm_ctx->subscriptions_lock);
 
@@ -810,17 +901,34 @@ cl_sm_dp_request_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn, Sr__Msg *m
         sr_mem_resp = values[0]._sr_mem;
     }
     rc = sr_gpb_resp_alloc(sr_mem_resp, SR__OPERATION__DATA_PROVIDE, msg->session_id, &resp);
-    CHECK_RC_MSG_RETURN(rc, "Allocation of data-provide response failed.");
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Allocation of data-provide response failed.");
 
+    dp_resp = resp->response->data_provide_resp;
     resp->response->result = cb_rc;
-    resp->response->data_provide_resp->request_id = msg->request->data_provide_req->request_id;
-    sr_mem_edit_string(sr_mem_resp, &resp->response->data_provide_resp->xpath, msg->request->data_provide_req->xpath);
-    CHECK_NULL_NOMEM_GOTO(resp->response->data_provide_resp->xpath, rc, cleanup);
+    dp_resp->request_id = dp_req->request_id;
+    sr_mem_edit_string(sr_mem_resp, &dp_resp->xpath, xpaths[0]);
+    CHECK_NULL_NOMEM_GOTO(dp_resp->xpath, rc, cleanup);
+
+    /* echo all xpaths of the batch */
+    if (dp_req->n_xpaths > 0) {
+        dp_resp->xpaths = sr_calloc(sr_mem_resp, xpath_cnt, sizeof(*dp_resp->xpaths));
+        CHECK_NULL_NOMEM_GOTO(dp_resp->xpaths, rc, cleanup);
+        for (size_t i = 0; i < xpath_cnt; i++) {
+            sr_mem_edit_string(sr_mem_resp, &dp_resp->xpaths[i], xpaths[i]);
+            CHECK_NULL_NOMEM_GOTO(dp_resp->xpaths[i], rc, cleanup);
+            dp_resp->n_xpaths++;
+        }
+    }
 
     /* copy output values to GPB */
-    if (SR_ERR_OK == cb_rc) {
-        rc = sr_values_sr_to_gpb(values, values_cnt, &resp->response->data_provide_resp->values,
-                &resp->response->data_provide_resp->n_values);
+    if (collected) {
+        /* values provided by the individual calls are already in GPB, possibly partial in case of an error */
+        dp_resp->values = gpb_values;
+        dp_resp->n_values = gpb_value_cnt;
+        gpb_values = NULL;
+        gpb_value_cnt = 0;
+    } else if (SR_ERR_OK == cb_rc) {
+        rc = sr_values_sr_to_gpb(values, values_cnt, &dp_resp->values, &dp_resp->n_values);
         if (SR_ERR_OK != rc) {
             SR_LOG_ERR_MSG("Error by copying output values to GPB.");
         }
@@ -830,6 +938,10 @@ cl_sm_dp_request_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn, Sr__Msg *m
     rc = cl_sm_msg_send_connection(sm_ctx, conn, resp);
 
 cleanup:
+    for (size_t i = 0; i < gpb_value_cnt; i++) {
+        sr__value__free_unpacked(gpb_values[i], NULL);
+    }
+    free(gpb_values);
     sr_free_values(values, values_cnt);
     sr_msg_free(resp);
     return rc;
@@ -1044,6 +1156,9 @@ cl_sm_conn_msg_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn, uint8_t *msg
         return SR_ERR_INTERNAL;
     }
 
+    /* internal pointer, must never be taken over from the peer */
+    msg->_packed_payload = 0;
+
     /* associate message with context */
     if (NULL != sr_mem) {
         msg->_sysrepo_mem_ctx = (uint64_t)sr_mem;
@@ -51,6 +51,7 @@ typedef union cl_sm_callback_u {
         sr_module_change_cb module_change_cb;    /**< Callback to be called by module change event. */
         sr_subtree_change_cb subtree_change_cb;  /**< Callback to be called by subtree change event. */
         sr_dp_get_items_cb dp_get_items_cb;      /**< Callback to be called by operational data requests. */
+        sr_dp_get_items_batch_cb dp_get_items_batch_cb;  /**< Callback to be called by batched operational data requests. */
         sr_rpc_cb rpc_cb;                        /**< Callback to be called by RPC delivery. */
         sr_rpc_tree_cb rpc_tree_cb;              /**< Callback to be called by RPC delivery -- the *tree* variant */
         sr_action_cb action_cb;                  /**< Callback to be called by Action delivery. */
@@ -75,6 +76,7 @@ typedef struct cl_sm_subscription_ctx_s {
     void *private_ctx;                           /**< Private context pointer, opaque to sysrepo. */
     int opts;                                    /**< Subscription options. */
     bool replay_completed;                       /**< TRUE in case of an event notification subscription, if replay has completed. */
+    bool dp_batch;                               /**< TRUE in case of a data provider subscription with batch callback. */
 } cl_sm_subscription_ctx_t;
 
 /**
@@ -93,8 +93,18 @@ typedef struct sr_change_iter_s {
     sr_val_t **old_values;          /**< Buffered old values. */
     size_t index;                   /**< Index into buff_values pointing to the value to be returned by next call. */
     size_t count;                   /**< Number of elements currently buffered. */
+    bool complete;                  /**< TRUE if all changes are buffered (sent inline with the notification). */
 } sr_change_iter_t;
 
+/**
+ * @brief Handle of an asynchronous request (::sr_get_items_async, ::sr_set_item_async, ::sr_delete_item_async).
+ */
+typedef struct sr_async_req_s {
+    sr_session_ctx_t *session;      /**< Session the request has been sent within. */
+    cl_pending_req_t *pending;      /**< Pending request in the connection, awaiting the response. */
+    Sr__Operation operation;        /**< Operation of the request. */
+} sr_async_req_t;
+
 static int connections_cnt = 0;               /**< Number of active connections to the Sysrepo Engine. */
 static int subscriptions_cnt = 0;             /**< Number of active subscriptions. */
 static cm_ctx_t *local_cm_ctx = NULL;         /**< Local Connection Manager context in case of library mode. */
@@ -445,6 +455,11 @@ sr_connect(const char *app_name, const sr_conn_options_t opts, sr_conn_ctx_t **c
         SR_LOG_INF("Connected to daemon Sysrepo Engine at socket=%s", SR_DAEMON_SOCKET);
     }
 
+    if (opts & SR_CONN_SHM_TRANSPORT) {
+        rc = cl_shm_channel_negotiate(connection);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to negotiate the shared-memory channel.");
+    }
+
     if (NULL != cm_ctx) {
         local_cm_ctx = cm_ctx;
     }
@@ -1999,6 +2014,221 @@ cleanup:
     return cl_session_return(session, rc);
 }
 
+/**
+ * @brief Fills one operation of the edit_batch request.
+ */
+static int
+cl_edit_batch_op_fill(sr_mem_ctx_t *sr_mem, const sr_edit_op_t *op, Sr__EditOperation *gpb_op)
+{
+    sr_val_t tmp_value = { 0, };
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(op, op->xpath, gpb_op);
+
+    switch (op->type) {
+        case SR_EDIT_OP_SET:
+            gpb_op->set_item = sr_calloc(sr_mem, 1, sizeof(*gpb_op->set_item));
+            CHECK_NULL_NOMEM_RETURN(gpb_op->set_item);
+            sr__set_item_req__init(gpb_op->set_item);
+            sr_mem_edit_string(sr_mem, &gpb_op->set_item->xpath, op->xpath);
+            CHECK_NULL_NOMEM_RETURN(gpb_op->set_item->xpath);
+            gpb_op->set_item->options = op->opts;
+            if (NULL != op->value) {
+                /* duplicate the value within the memory context of the request */
+                tmp_value = *op->value;
+                tmp_value._sr_mem = sr_mem;
+                rc = sr_dup_val_t_to_gpb(&tmp_value, &gpb_op->set_item->value);
+                CHECK_RC_LOG_RETURN(rc, "Value duplication failed for xpath '%s'.", op->xpath);
+            }
+            break;
+        case SR_EDIT_OP_SET_STR:
+            gpb_op->set_item_str = sr_calloc(sr_mem, 1, sizeof(*gpb_op->set_item_str));
+            CHECK_NULL_NOMEM_RETURN(gpb_op->set_item_str);
+            sr__set_item_str_req__init(gpb_op->set_item_str);
+            sr_mem_edit_string(sr_mem, &gpb_op->set_item_str->xpath, op->xpath);
+            CHECK_NULL_NOMEM_RETURN(gpb_op->set_item_str->xpath);
+            gpb_op->set_item_str->options = op->opts;
+            if (NULL != op->str_value) {
+                sr_mem_edit_string(sr_mem, &gpb_op->set_item_str->value, op->str_value);
+                CHECK_NULL_NOMEM_RETURN(gpb_op->set_item_str->value);
+            }
+            break;
+        case SR_EDIT_OP_DELETE:
+            gpb_op->delete_item = sr_calloc(sr_mem, 1, sizeof(*gpb_op->delete_item));
+            CHECK_NULL_NOMEM_RETURN(gpb_op->delete_item);
+            sr__delete_item_req__init(gpb_op->delete_item);
+            sr_mem_edit_string(sr_mem, &gpb_op->delete_item->xpath, op->xpath);
+            CHECK_NULL_NOMEM_RETURN(gpb_op->delete_item->xpath);
+            gpb_op->delete_item->options = op->opts;
+            break;
+        case SR_EDIT_OP_MOVE:
+            gpb_op->move_item = sr_calloc(sr_mem, 1, sizeof(*gpb_op->move_item));
+            CHECK_NULL_NOMEM_RETURN(gpb_op->move_item);
+            sr__move_item_req__init(gpb_op->move_item);
+            sr_mem_edit_string(sr_mem, &gpb_op->move_item->xpath, op->xpath);
+            CHECK_NULL_NOMEM_RETURN(gpb_op->move_item->xpath);
+            gpb_op->move_item->position = sr_move_position_sr_to_gpb(op->position);
+            if (NULL != op->relative_item) {
+                sr_mem_edit_string(sr_mem, &gpb_op->move_item->relative_item, op->relative_item);
+                CHECK_NULL_NOMEM_RETURN(gpb_op->move_item->relative_item);
+            }
+            break;
+        default:
+            SR_LOG_ERR("Unknown edit operation type %d for xpath '%s'.", op->type, op->xpath);
+            return SR_ERR_INVAL_ARG;
+    }
+
+    return SR_ERR_OK;
+}
+
+int
+sr_edit_batch(sr_session_ctx_t *session, const sr_edit_op_t *ops, size_t op_cnt, int *results)
+{
+    Sr__Msg *msg_req = NULL, *msg_resp = NULL;
+    Sr__EditBatchReq *batch_req = NULL;
+    Sr__EditBatchResp *batch_resp = NULL;
+    Sr__EditOperation *gpb_op = NULL;
+    Sr__Error **errors = NULL;
+    size_t error_cnt = 0;
+    sr_mem_ctx_t *sr_mem = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(session, session->conn_ctx, ops);
+
+    cl_session_clear_errors(session);
+
+    /* prepare edit_batch message */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_req_alloc(sr_mem, SR__OPERATION__EDIT_BATCH, session->id, &msg_req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate GPB message.");
+    batch_req = msg_req->request->edit_batch_req;
+
+    /* fill in the operations */
+    if (op_cnt > 0) {
+        batch_req->operations = sr_calloc(sr_mem, op_cnt, sizeof(*batch_req->operations));
+        CHECK_NULL_NOMEM_GOTO(batch_req->operations, rc, cleanup);
+    }
+    for (size_t i = 0; i < op_cnt; i++) {
+        gpb_op = sr_calloc(sr_mem, 1, sizeof(*gpb_op));
+        CHECK_NULL_NOMEM_GOTO(gpb_op, rc, cleanup);
+        sr__edit_operation__init(gpb_op);
+        batch_req->operations[batch_req->n_operations++] = gpb_op;
+
+        rc = cl_edit_batch_op_fill(sr_mem, &ops[i], gpb_op);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to prepare operation %zu of the edit batch.", i);
+    }
+
+    /* send the request and receive the response */
+    rc = cl_request_process(session, msg_req, &msg_resp, NULL, SR__OPERATION__EDIT_BATCH);
+
+    if (NULL != msg_resp && NULL != msg_resp->response && NULL != msg_resp->response->edit_batch_resp) {
+        batch_resp = msg_resp->response->edit_batch_resp;
+        if (NULL != results) {
+            for (size_t i = 0; i < op_cnt; i++) {
+                results[i] = SR_ERR_OK;
+            }
+        }
+        if (batch_resp->n_failed > 0) {
+            SR_LOG_ERR("%zu of %zu operations of the edit batch failed.", batch_resp->n_failed, op_cnt);
+            errors = calloc(batch_resp->n_failed, sizeof(*errors));
+            CHECK_NULL_NOMEM_GOTO(errors, rc, cleanup);
+        }
+        for (size_t i = 0; i < batch_resp->n_failed; i++) {
+            if (NULL != results && batch_resp->failed[i]->index < op_cnt) {
+                results[batch_resp->failed[i]->index] = batch_resp->failed[i]->result;
+            }
+            if (NULL != batch_resp->failed[i]->error) {
+                errors[error_cnt++] = batch_resp->failed[i]->error;
+            }
+        }
+        /* store errors of all failed operations within the session */
+        if (error_cnt > 0) {
+            cl_session_set_errors(session, errors, error_cnt);
+        }
+    } else if (NULL != results) {
+        /* the batch has not been processed at all */
+        for (size_t i = 0; i < op_cnt; i++) {
+            results[i] = rc;
+        }
+    }
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Error by processing of the request.");
+
+cleanup:
+    free(errors);
+    if (NULL != msg_req) {
+        sr_msg_free(msg_req);
+    } else {
+        sr_mem_free(sr_mem);
+    }
+    if (NULL != msg_resp) {
+        sr_msg_free(msg_resp);
+    }
+    return cl_session_return(session, rc);
+}
+
+int
+sr_import_data(sr_session_ctx_t *session, const char *module_name, const char *data, sr_data_format_t format,
+        sr_import_mode_t mode)
+{
+    Sr__Msg *msg_req = NULL, *msg_resp = NULL;
+    Sr__ImportDataReq *import_req = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(session, session->conn_ctx, module_name, data);
+
+    cl_session_clear_errors(session);
+
+    /* prepare import_data message */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_req_alloc(sr_mem, SR__OPERATION__IMPORT_DATA, session->id, &msg_req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate GPB message.");
+    import_req = msg_req->request->import_data_req;
+
+    /* fill in the module name, data and options */
+    sr_mem_edit_string(sr_mem, &import_req->module_name, module_name);
+    CHECK_NULL_NOMEM_GOTO(import_req->module_name, rc, cleanup);
+
+    sr_mem_edit_string(sr_mem, &import_req->data, data);
+    CHECK_NULL_NOMEM_GOTO(import_req->data, rc, cleanup);
+
+    switch (format) {
+        case SR_DATA_XML:
+            import_req->format = SR__IMPORT_DATA_REQ__FORMAT__XML;
+            break;
+        case SR_DATA_JSON:
+            import_req->format = SR__IMPORT_DATA_REQ__FORMAT__JSON;
+            break;
+        default:
+            SR_LOG_ERR("Unsupported format of imported data: %d.", format);
+            rc = SR_ERR_INVAL_ARG;
+            goto cleanup;
+    }
+    import_req->replace = (SR_IMPORT_REPLACE == mode);
+
+    /* send the request and receive the response */
+    rc = cl_request_process(session, msg_req, &msg_resp, NULL, SR__OPERATION__IMPORT_DATA);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Error by processing of the request.");
+
+    sr_msg_free(msg_req);
+    sr_msg_free(msg_resp);
+
+    return cl_session_return(session, SR_ERR_OK);
+
+cleanup:
+    if (NULL != msg_req) {
+        sr_msg_free(msg_req);
+    } else {
+        sr_mem_free(sr_mem);
+    }
+    if (NULL != msg_resp) {
+        sr_msg_free(msg_resp);
+    }
+    return cl_session_return(session, rc);
+}
+
 int
 sr_validate(sr_session_ctx_t *session)
 {
@@ -2189,6 +2419,195 @@ cleanup:
     return cl_session_return(session, rc);
 }
 
+/**
+ * @brief Allocates the asynchronous request handle and sends the request.
+ */
+static int
+cl_async_request_send(sr_session_ctx_t *session, Sr__Msg *msg_req, const Sr__Operation operation, sr_async_req_t **req_p)
+{
+    sr_async_req_t *req = NULL;
+    int rc = SR_ERR_OK;
+
+    req = calloc(1, sizeof(*req));
+    CHECK_NULL_NOMEM_RETURN(req);
+
+    req->session = session;
+    req->operation = operation;
+
+    rc = cl_request_send(session, msg_req, NULL, operation, &req->pending);
+    if (SR_ERR_OK != rc) {
+        free(req);
+        return rc;
+    }
+
+    *req_p = req;
+    return SR_ERR_OK;
+}
+
+int
+sr_get_items_async(sr_session_ctx_t *session, const char *xpath, sr_async_req_t **req)
+{
+    Sr__Msg *msg_req = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(session, session->conn_ctx, xpath, req);
+
+    cl_session_clear_errors(session);
+
+    /* prepare get_item message */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_req_alloc(sr_mem, SR__OPERATION__GET_ITEMS, session->id, &msg_req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate GPB message.");
+
+    /* fill in the path */
+    sr_mem_edit_string(sr_mem, &msg_req->request->get_items_req->xpath, xpath);
+    CHECK_NULL_NOMEM_GOTO(msg_req->request->get_items_req->xpath, rc, cleanup);
+
+    /* send the request */
+    rc = cl_async_request_send(session, msg_req, SR__OPERATION__GET_ITEMS, req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Error by sending of the request.");
+
+cleanup:
+    if (NULL != msg_req) {
+        sr_msg_free(msg_req);
+    } else {
+        sr_mem_free(sr_mem);
+    }
+    return cl_session_return(session, rc);
+}
+
+int
+sr_set_item_async(sr_session_ctx_t *session, const char *xpath, const sr_val_t *value,
+        const sr_edit_options_t opts, sr_async_req_t **req)
+{
+    Sr__Msg *msg_req = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    sr_mem_snapshot_t snapshot = { 0, };
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(session, session->conn_ctx, xpath, req);
+
+    cl_session_clear_errors(session);
+
+    /* prepare set_item message */
+    if (NULL != value) {
+        sr_mem = value->_sr_mem;
+        sr_mem_snapshot(sr_mem, &snapshot);
+    } else {
+        rc = sr_mem_new(0, &sr_mem);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to create a new Sysrepo memory context.");
+    }
+    rc = sr_gpb_req_alloc(sr_mem, SR__OPERATION__SET_ITEM, session->id, &msg_req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate GPB message.");
+
+    /* fill in the path and options */
+    sr_mem_edit_string(sr_mem, &msg_req->request->set_item_req->xpath, xpath);
+    CHECK_NULL_NOMEM_GOTO(msg_req->request->set_item_req->xpath, rc, cleanup);
+
+    msg_req->request->set_item_req->options = opts;
+
+    /* duplicate the content of sr_val_t to gpb */
+    if (NULL != value) {
+        rc = sr_dup_val_t_to_gpb(value, &msg_req->request->set_item_req->value);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "value duplication failed.");
+    }
+
+    /* send the request */
+    rc = cl_async_request_send(session, msg_req, SR__OPERATION__SET_ITEM, req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Error by sending of the request.");
+
+    sr_msg_free(msg_req);
+
+    return cl_session_return(session, SR_ERR_OK);
+
+cleanup:
+    if (NULL != sr_mem) {
+        if (NULL != value) {
+            sr_mem_restore(&snapshot);
+        } else {
+            if (NULL != msg_req) {
+                sr_msg_free(msg_req);
+            } else {
+                sr_mem_free(sr_mem);
+            }
+        }
+    } else {
+        sr_msg_free(msg_req);
+    }
+    return cl_session_return(session, rc);
+}
+
+int
+sr_delete_item_async(sr_session_ctx_t *session, const char *xpath, const sr_edit_options_t opts, sr_async_req_t **req)
+{
+    Sr__Msg *msg_req = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(session, session->conn_ctx, xpath, req);
+
+    cl_session_clear_errors(session);
+
+    /* prepare delete_item message */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_req_alloc(sr_mem, SR__OPERATION__DELETE_ITEM, session->id, &msg_req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate GPB message.");
+
+    /* fill in the path and options */
+    sr_mem_edit_string(sr_mem, &msg_req->request->delete_item_req->xpath, xpath);
+    CHECK_NULL_NOMEM_GOTO(msg_req->request->delete_item_req->xpath, rc, cleanup);
+
+    msg_req->request->delete_item_req->options = opts;
+
+    /* send the request */
+    rc = cl_async_request_send(session, msg_req, SR__OPERATION__DELETE_ITEM, req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Error by sending of the request.");
+
+cleanup:
+    if (NULL != msg_req) {
+        sr_msg_free(msg_req);
+    } else {
+        sr_mem_free(sr_mem);
+    }
+    return cl_session_return(session, rc);
+}
+
+int
+sr_async_wait(sr_async_req_t *req, sr_val_t **values, size_t *value_cnt)
+{
+    sr_session_ctx_t *session = NULL;
+    Sr__Msg *msg_resp = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG(req);
+    session = req->session;
+
+    /* receive the response */
+    rc = cl_request_wait(session, req->pending, &msg_resp);
+    if (SR_ERR_NOT_FOUND == rc) {
+        /* not an error, so no logging */
+        goto cleanup;
+    }
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Error by processing of the %s request.", sr_gpb_operation_name(req->operation));
+
+    if (SR__OPERATION__GET_ITEMS == req->operation && NULL != values && NULL != value_cnt) {
+        /* copy the content of gpb values to sr_val_t */
+        rc = sr_values_gpb_to_sr((sr_mem_ctx_t *)msg_resp->_sysrepo_mem_ctx, msg_resp->response->get_items_resp->values,
+                                 msg_resp->response->get_items_resp->n_values, values, value_cnt);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Error by copying the values from GPB.");
+    }
+
+cleanup:
+    free(req);
+    if (NULL != msg_resp) {
+        sr_msg_free(msg_resp);
+    }
+    return cl_session_return(session, rc);
+}
+
 int
 sr_lock_datastore(sr_session_ctx_t *session)
 {
@@ -2534,6 +2953,8 @@ sr_module_change_subscribe(sr_session_ctx_t *session, const char *module_name, s
     msg_req->request->subscribe_req->enable_running = !(opts & SR_SUBSCR_PASSIVE);
     msg_req->request->subscribe_req->has_enable_event = true;
     msg_req->request->subscribe_req->enable_event = (opts & SR_SUBSCR_EV_ENABLED);
+    msg_req->request->subscribe_req->has_inline_changes = true;
+    msg_req->request->subscribe_req->inline_changes = (opts & SR_SUBSCR_INLINE_CHANGES);
 
     /* send the request and receive the response */
     rc = cl_request_process(session, msg_req, &msg_resp, NULL, SR__OPERATION__SUBSCRIBE);
@@ -2607,6 +3028,8 @@ sr_subtree_change_subscribe(sr_session_ctx_t *session, const char *xpath, sr_sub
     msg_req->request->subscribe_req->enable_running = !(opts & SR_SUBSCR_PASSIVE);
     msg_req->request->subscribe_req->has_enable_event = true;
     msg_req->request->subscribe_req->enable_event = (opts & SR_SUBSCR_EV_ENABLED);
+    msg_req->request->subscribe_req->has_inline_changes = true;
+    msg_req->request->subscribe_req->inline_changes = (opts & SR_SUBSCR_INLINE_CHANGES);
 
     /* send the request and receive the response */
     rc = cl_request_process(session, msg_req, &msg_resp, NULL, SR__OPERATION__SUBSCRIBE);
@@ -2635,32 +3058,80 @@ cleanup:
     return cl_session_return(session, rc);
 }
 
+/**
+ * @brief Returns the changes sent inline with the change notification being processed on the session,
+ * if they cover the changes selected by the xpath.
+ */
+static bool
+cl_inline_changes_get(const sr_session_ctx_t *session, const char *xpath, Sr__Change ***changes, size_t *change_cnt)
+{
+    const Sr__Notification *notif = NULL;
+    char module_xpath[PATH_MAX] = { 0, };
+
+    if (NULL == session->notif_msg || NULL == session->notif_msg->notification) {
+        return false;
+    }
+    notif = session->notif_msg->notification;
+
+    if (NULL != notif->module_change_notif && notif->module_change_notif->inline_changes) {
+        /* module change subscription covers the whole module */
+        snprintf(module_xpath, PATH_MAX, "/%s:*", notif->module_change_notif->module_name);
+        if (0 == strcmp(xpath, module_xpath)) {
+            *changes = notif->module_change_notif->changes;
+            *change_cnt = notif->module_change_notif->n_changes;
+            return true;
+        }
+    }
+    if (NULL != notif->subtree_change_notif && notif->subtree_change_notif->inline_changes) {
+        if (0 == strcmp(xpath, notif->subtree_change_notif->xpath)) {
+            *changes = notif->subtree_change_notif->changes;
+            *change_cnt = notif->subtree_change_notif->n_changes;
+            return true;
+        }
+    }
+    return false;
+}
+
 int
 sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath, sr_change_iter_t **iter)
 {
     Sr__Msg *msg_resp = NULL;
     sr_change_iter_t *it = NULL;
+    Sr__Change **changes = NULL;
+    size_t change_cnt = 0;
+    sr_mem_ctx_t *sr_mem = NULL;
+    bool inline_changes = false;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG4(session, session->conn_ctx, xpath, iter);
 
     cl_session_clear_errors(session);
 
-    rc = cl_send_get_changes(session, xpath, 0, CL_GET_ITEMS_FETCH_LIMIT, &msg_resp);
-    if (SR_ERR_NOT_FOUND == rc) {
-        SR_LOG_DBG("No items found for xpath '%s'", xpath);
-        /* SR_ERR_NOT_FOUND will be returned on get_change_next call */
-        rc = SR_ERR_OK;
+    inline_changes = cl_inline_changes_get(session, xpath, &changes, &change_cnt);
+    if (inline_changes) {
+        SR_LOG_DBG("Using changes sent with the notification for xpath '%s'", xpath);
+        sr_mem = (sr_mem_ctx_t *)session->notif_msg->_sysrepo_mem_ctx;
     } else {
-        CHECK_RC_LOG_GOTO(rc, cleanup, "Sending get_changes request failed '%s'", xpath);
+        rc = cl_send_get_changes(session, xpath, 0, CL_GET_ITEMS_FETCH_LIMIT, &msg_resp);
+        if (SR_ERR_NOT_FOUND == rc) {
+            SR_LOG_DBG("No items found for xpath '%s'", xpath);
+            /* SR_ERR_NOT_FOUND will be returned on get_change_next call */
+            rc = SR_ERR_OK;
+        } else {
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Sending get_changes request failed '%s'", xpath);
+        }
+        changes = msg_resp->response->get_changes_resp->changes;
+        change_cnt = msg_resp->response->get_changes_resp->n_changes;
+        sr_mem = (sr_mem_ctx_t *)msg_resp->_sysrepo_mem_ctx;
     }
 
     it = calloc(1, sizeof(*it));
     CHECK_NULL_NOMEM_GOTO(it, rc, cleanup);
 
     it->index = 0;
-    it->count = msg_resp->response->get_changes_resp->n_changes;
+    it->count = change_cnt;
     it->offset = it->count;
+    it->complete = inline_changes;
 
     it->xpath = strdup(xpath);
     CHECK_NULL_NOMEM_GOTO(it->xpath, rc, cleanup);
@@ -2676,17 +3147,15 @@ sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath, sr_change_iter
 
     /* copy the content of gpb to sr_val_t */
     for (size_t i = 0; i < it->count; i++) {
-        if (NULL != msg_resp->response->get_changes_resp->changes[i]->new_value) {
-            rc = sr_dup_gpb_to_val_t((sr_mem_ctx_t *)msg_resp->_sysrepo_mem_ctx,
-                                     msg_resp->response->get_changes_resp->changes[i]->new_value, &it->new_values[i]);
+        if (NULL != changes[i]->new_value) {
+            rc = sr_dup_gpb_to_val_t(sr_mem, changes[i]->new_value, &it->new_values[i]);
             CHECK_RC_MSG_GOTO(rc, cleanup, "Copying from gpb to sr_val_t failed");
         }
-        if (NULL != msg_resp->response->get_changes_resp->changes[i]->old_value) {
-            rc = sr_dup_gpb_to_val_t((sr_mem_ctx_t *)msg_resp->_sysrepo_mem_ctx,
-                                     msg_resp->response->get_changes_resp->changes[i]->old_value, &it->old_values[i]);
+        if (NULL != changes[i]->old_value) {
+            rc = sr_dup_gpb_to_val_t(sr_mem, changes[i]->old_value, &it->old_values[i]);
             CHECK_RC_MSG_GOTO(rc, cleanup, "Copying from gpb to sr_val_t failed");
         }
-        it->operations[i] = sr_change_op_gpb_to_sr(msg_resp->response->get_changes_resp->changes[i]->changeoperation);
+        it->operations[i] = sr_change_op_gpb_to_sr(changes[i]->changeoperation);
     }
 
     *iter = it;
@@ -2727,6 +3196,11 @@ sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_
         *old_value = iter->old_values[iter->index];
         *new_value = iter->new_values[iter->index];
         iter->index++;
+    } else if (iter->complete) {
+        /* All changes have been read */
+        *new_value = NULL;
+        *old_value = NULL;
+        return SR_ERR_NOT_FOUND;
     } else {
         /* Fetch more items */
         rc = cl_send_get_changes(session, iter->xpath, iter->offset,
@@ -3388,18 +3862,22 @@ sr_action_send_tree(sr_session_ctx_t *session, const char *xpath,
     return cl_rpc_send_tree(session, xpath, true, input, input_cnt, output, output_cnt);
 }
 
-int
-sr_dp_get_items_subscribe(sr_session_ctx_t *session, const char *xpath, sr_dp_get_items_cb callback, void *private_ctx,
-        sr_subscr_options_t opts, sr_subscription_ctx_t **subscription_p)
+/**
+ * @brief Subscribes for providing operational data, either with a single-xpath or with a batch callback.
+ */
+static int
+cl_dp_get_items_subscribe(sr_session_ctx_t *session, const char *xpath, cl_sm_callback_t callback, bool batch,
+        void *private_ctx, sr_subscr_options_t opts, sr_subscription_ctx_t **subscription_p)
 {
     Sr__Msg *msg_req = NULL, *msg_resp = NULL;
     sr_subscription_ctx_t *sr_subscription = NULL;
     cl_sm_subscription_ctx_t *sm_subscription = NULL;
     char *module_name = NULL;
     sr_mem_ctx_t *sr_mem = NULL;
+    uint32_t ttl = 0;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG3(session, callback, subscription_p);
+    CHECK_NULL_ARG3(session, callback.dp_get_items_cb, subscription_p);
 
     cl_session_clear_errors(session);
 
@@ -3415,7 +3893,8 @@ sr_dp_get_items_subscribe(sr_session_ctx_t *session, const char *xpath, sr_dp_ge
             private_ctx, &sr_subscription, &sm_subscription, &msg_req);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Error by initialization of the subscription in the client library.");
 
-    sm_subscription->callback.dp_get_items_cb = callback;
+    sm_subscription->callback = callback;
+    sm_subscription->dp_batch = batch;
 
     /* Fill-in GPB subscription information */
     sr_mem = (sr_mem_ctx_t *)msg_req->_sysrepo_mem_ctx;
@@ -3428,6 +3907,12 @@ sr_dp_get_items_subscribe(sr_session_ctx_t *session, const char *xpath, sr_dp_ge
     msg_req->request->subscribe_req->has_enable_running = true;
     msg_req->request->subscribe_req->enable_running = !(opts & SR_SUBSCR_PASSIVE);
 
+    ttl = (opts >> SR_SUBSCR_DP_CACHE_TTL_SHIFT) & 0xFFFF;
+    if (ttl > 0) {
+        msg_req->request->subscribe_req->has_dp_cache_ttl = true;
+        msg_req->request->subscribe_req->dp_cache_ttl = ttl;
+    }
+
     /* send the request and receive the response */
     rc = cl_request_process(session, msg_req, &msg_resp, NULL, SR__OPERATION__SUBSCRIBE);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Error by processing of the request.");
@@ -3455,6 +3940,66 @@ cleanup:
     return cl_session_return(session, rc);
 }
 
+int
+sr_dp_get_items_subscribe(sr_session_ctx_t *session, const char *xpath, sr_dp_get_items_cb callback, void *private_ctx,
+        sr_subscr_options_t opts, sr_subscription_ctx_t **subscription_p)
+{
+    cl_sm_callback_t callback_u;
+    callback_u.dp_get_items_cb = callback;
+    return cl_dp_get_items_subscribe(session, xpath, callback_u, false, private_ctx, opts, subscription_p);
+}
+
+int
+sr_dp_get_items_batch_subscribe(sr_session_ctx_t *session, const char *xpath, sr_dp_get_items_batch_cb callback,
+        void *private_ctx, sr_subscr_options_t opts, sr_subscription_ctx_t **subscription_p)
+{
+    cl_sm_callback_t callback_u;
+    callback_u.dp_get_items_batch_cb = callback;
+    return cl_dp_get_items_subscribe(session, xpath, callback_u, true, private_ctx, opts, subscription_p);
+}
+
+int
+sr_dp_cache_invalidate(sr_session_ctx_t *session, const char *xpath)
+{
+    Sr__Msg *msg_req = NULL, *msg_resp = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(session, xpath);
+
+    cl_session_clear_errors(session);
+
+    /* prepare request message */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_req_alloc(sr_mem, SR__OPERATION__DP_CACHE_INVALIDATE, session->id, &msg_req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate GPB message.");
+
+    /* fill-in xpath */
+    sr_mem_edit_string(sr_mem, &msg_req->request->dp_cache_invalidate_req->xpath, xpath);
+    CHECK_NULL_NOMEM_GOTO(msg_req->request->dp_cache_invalidate_req->xpath, rc, cleanup);
+
+    /* send the request and receive the response */
+    rc = cl_request_process(session, msg_req, &msg_resp, NULL, SR__OPERATION__DP_CACHE_INVALIDATE);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Error by processing of the request.");
+
+    sr_msg_free(msg_req);
+    sr_msg_free(msg_resp);
+
+    return cl_session_return(session, SR_ERR_OK);
+
+cleanup:
+    if (NULL != msg_req) {
+        sr_msg_free(msg_req);
+    } else {
+        sr_mem_free(sr_mem);
+    }
+    if (NULL != msg_resp) {
+        sr_msg_free(msg_resp);
+    }
+    return cl_session_return(session, rc);
+}
+
 /**
  * @brief Subscribes for delivery of event notification specified by xpath.
  *
@@ -26,7 +26,7 @@
 #include <string.h>
 #include <assert.h>
 #include <time.h>
-#include <pwd.h>
+#include <pthread.h>
 #include <sys/types.h>
 
 #include "sr_common.h"
@@ -37,6 +37,10 @@
 #define SM_SESSION_ID_MAX_ATTEMPTS 100  /**< Maximum number of attempts to generate unused random session id. */
 #define SM_FD_INVALID -1                /**< Invalid value of file descriptor. */
 
+#define SM_RDLOCK(ctx) pthread_rwlock_rdlock((pthread_rwlock_t*)&(ctx)->lock)  /**< Locks SM context for reading. */
+#define SM_WRLOCK(ctx) pthread_rwlock_wrlock((pthread_rwlock_t*)&(ctx)->lock)  /**< Locks SM context for writing. */
+#define SM_UNLOCK(ctx) pthread_rwlock_unlock((pthread_rwlock_t*)&(ctx)->lock)  /**< Unlocks SM context. */
+
 /**
  * @brief Session Manager context.
  */
@@ -46,6 +50,8 @@ typedef struct sm_ctx_s {
     sr_btree_t *session_id_btree;         /**< Binary tree for fast session lookup by id. */
     sr_btree_t *connection_fd_btree;      /**< Binary tree for fast connection lookup by file descriptor. */
     sr_btree_t *connection_dst_btree;     /**< Binary tree for fast connection lookup by destination address. */
+    pthread_rwlock_t lock;                /**< RW-lock guarding the binary trees (SM is used from multiple I/O loops). */
+    uint32_t io_loop_cnt;                 /**< Number of I/O loops serving the connections. */
 } sm_ctx_t;
 
 /**
@@ -91,8 +97,8 @@ sm_connection_cmp_fd(const void *a, const void *b)
 }
 
 /**
- * @brief Compares two connections by associated destination addresses
- * (used by lookups in fd binary tree).
+ * @brief Compares two connections by associated destination addresses and I/O loops
+ * (used by lookups in dst binary tree).
  */
 static int
 sm_connection_cmp_dst(const void *a, const void *b)
@@ -109,7 +115,10 @@ sm_connection_cmp_dst(const void *a, const void *b)
 
     res = strcmp(conn_a->dst_address, conn_b->dst_address);
     if (res == 0) {
-        return 0;
+        if (conn_a->io_loop == conn_b->io_loop) {
+            return 0;
+        }
+        return (conn_a->io_loop < conn_b->io_loop) ? -1 : 1;
     } else if (res < 0) {
         return -1;
     } else {
@@ -242,13 +251,19 @@ sm_connection_remove_session(const sm_ctx_t *sm_ctx, sm_connection_t *connection
 }
 
 int
-sm_init(sm_cleanup_cb session_cleanup_cb, sm_cleanup_cb connection_cleanup_cb, sm_ctx_t **sm_ctx)
+sm_init(sm_cleanup_cb session_cleanup_cb, sm_cleanup_cb connection_cleanup_cb, uint32_t io_loop_cnt,
+        sm_ctx_t **sm_ctx)
 {
     sm_ctx_t *ctx = NULL;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG(sm_ctx);
 
+    if (0 == io_loop_cnt) {
+        SR_LOG_ERR_MSG("At least one I/O loop is required by Session Manager.");
+        return SR_ERR_INVAL_ARG;
+    }
+
     ctx = calloc(1, sizeof(*ctx));
     if (NULL == ctx) {
         SR_LOG_ERR_MSG("Cannot allocate memory for Session Manager.");
@@ -257,6 +272,8 @@ sm_init(sm_cleanup_cb session_cleanup_cb, sm_cleanup_cb connection_cleanup_cb, s
     }
     ctx->session_cleanup_cb = session_cleanup_cb;
     ctx->connection_cleanup_cb = connection_cleanup_cb;
+    ctx->io_loop_cnt = io_loop_cnt;
+    pthread_rwlock_init(&ctx->lock, NULL);
 
     /* create binary tree for fast session lookup by id,
      * with automatic cleanup when the session is removed from tree */
@@ -309,6 +326,7 @@ sm_cleanup(sm_ctx_t *sm_ctx)
         if (NULL != sm_ctx->connection_dst_btree) {
             sr_btree_cleanup(sm_ctx->connection_dst_btree);
         }
+        pthread_rwlock_destroy(&sm_ctx->lock);
         free(sm_ctx);
     }
 }
@@ -343,7 +361,9 @@ sm_connection_start(const sm_ctx_t *sm_ctx, const sm_connection_type_t type, con
     }
 
     /* insert connection into binary tree for fast lookup by fd */
+    SM_WRLOCK(sm_ctx);
     rc = sr_btree_insert(sm_ctx->connection_fd_btree, connection);
+    SM_UNLOCK(sm_ctx);
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR_MSG("Cannot insert new entry into fd binary tree (duplicate fd?).");
         free(connection);
@@ -374,7 +394,9 @@ sm_connection_stop(const sm_ctx_t *sm_ctx, sm_connection_t *connection)
         tmp = tmp->next;
     }
 
+    SM_WRLOCK(sm_ctx);
     sr_btree_delete(sm_ctx->connection_fd_btree, connection); /* sm_connection_cleanup auto-invoked */
+    SM_UNLOCK(sm_ctx);
 
     return SR_ERR_OK;
 }
@@ -384,10 +406,10 @@ sm_session_create(const sm_ctx_t *sm_ctx, sm_connection_t *connection,
         const char *effective_user, sm_session_t **session_p)
 {
     sm_session_t *session = NULL;
-    struct passwd *pws = NULL;
+    uint32_t id = 0;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG2(sm_ctx, session_p);
+    CHECK_NULL_ARG3(sm_ctx, connection, session_p);
 
     /* allocate session context */
     session = calloc(1, sizeof(*session));
@@ -398,17 +420,11 @@ sm_session_create(const sm_ctx_t *sm_ctx, sm_connection_t *connection,
     }
     session->sm_ctx = (sm_ctx_t*)sm_ctx;
 
-    /* save real user credentials */
-    pws = getpwuid(connection->uid);
-    if (NULL == pws) {
-        SR_LOG_ERR("Cannot retrieve credentials of the real user: %s", sr_strerror_safe(errno));
-        rc = SR_ERR_INTERNAL;
-        goto cleanup;
-    }
-    session->credentials.r_username = strdup(pws->pw_name);
-    if (NULL == session->credentials.r_username) {
-        SR_LOG_ERR_MSG("Cannot allocate memory for real user name.");
-        rc = SR_ERR_NOMEM;
+    /* save real user credentials (reentrant lookups, sessions are created from multiple I/O loops) */
+    rc = sr_get_user_name(connection->uid, (char**)&session->credentials.r_username);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Cannot retrieve credentials of the real user (uid=%d).", connection->uid);
+        rc = (SR_ERR_NOMEM == rc) ? SR_ERR_NOMEM : SR_ERR_INTERNAL;
         goto cleanup;
     }
     session->credentials.r_uid = connection->uid;
@@ -416,9 +432,8 @@ sm_session_create(const sm_ctx_t *sm_ctx, sm_connection_t *connection,
 
     /* save effective user credentials */
     if (NULL != effective_user) {
-        errno = 0;
-        pws = getpwnam(effective_user);
-        if (NULL == pws) {
+        rc = sr_get_user_id(effective_user, &session->credentials.e_uid, &session->credentials.e_gid);
+        if (SR_ERR_OK != rc) {
             SR_LOG_ERR("Cannot retrieve credentials of the effective user ('%s'): Invalid username?", effective_user);
             rc = SR_ERR_INVAL_USER;
             goto cleanup;
@@ -429,18 +444,20 @@ sm_session_create(const sm_ctx_t *sm_ctx, sm_connection_t *connection,
             rc = SR_ERR_NOMEM;
             goto cleanup;
         }
-        session->credentials.e_uid = pws->pw_uid;
-        session->credentials.e_gid = pws->pw_gid;
     }
 
-    /* generate unused random session_id */
+    /* generate unused random session_id, encoding the I/O loop of the connection */
     size_t attempts = 0;
+    SM_WRLOCK(sm_ctx);
     do {
-        session->id = rand();
+        id = rand();
+        id = id - (id % sm_ctx->io_loop_cnt) + (connection->io_loop % sm_ctx->io_loop_cnt);
+        session->id = id;
         if (NULL != sr_btree_search(sm_ctx->session_id_btree, session)) {
             session->id = SM_SESSION_ID_INVALID;
         }
         if (++attempts > SM_SESSION_ID_MAX_ATTEMPTS) {
+            SM_UNLOCK(sm_ctx);
             SR_LOG_ERR_MSG("Unable to generate an unique session_id.");
             rc = SR_ERR_INTERNAL;
             goto cleanup;
@@ -449,7 +466,8 @@ sm_session_create(const sm_ctx_t *sm_ctx, sm_connection_t *connection,
 
     /* insert into binary tree for fast lookup by id */
     rc = sr_btree_insert(sm_ctx->session_id_btree, session);
-        if (SR_ERR_OK != rc) {
+    SM_UNLOCK(sm_ctx);
+    if (SR_ERR_OK != rc) {
         SR_LOG_ERR_MSG("Cannot insert new entry into session binary tree (duplicate id?).");
         rc = SR_ERR_INTERNAL;
         goto cleanup;
@@ -488,7 +506,9 @@ sm_session_drop(const sm_ctx_t *sm_ctx, sm_session_t *session)
         SR_LOG_WRN("Cannot remove the session from connection (id=%"PRIu32").", session->id);
     }
 
+    SM_WRLOCK(sm_ctx);
     sr_btree_delete(sm_ctx->session_id_btree, session); /* sm_session_cleanup auto-invoked */
+    SM_UNLOCK(sm_ctx);
 
     return SR_ERR_OK;
 }
@@ -506,7 +526,9 @@ sm_session_find_id(const sm_ctx_t *sm_ctx, uint32_t session_id, sm_session_t **s
     }
 
     tmp.id = session_id;
+    SM_RDLOCK(sm_ctx);
     *session = sr_btree_search(sm_ctx->session_id_btree, &tmp);
+    SM_UNLOCK(sm_ctx);
 
     if (NULL == *session) {
         SR_LOG_DBG("Cannot find the session with id=%"PRIu32".", session_id);
@@ -515,6 +537,15 @@ sm_session_find_id(const sm_ctx_t *sm_ctx, uint32_t session_id, sm_session_t **s
     return SR_ERR_OK;
 }
 
+uint32_t
+sm_session_io_loop(const sm_ctx_t *sm_ctx, uint32_t session_id)
+{
+    if (NULL == sm_ctx) {
+        return 0;
+    }
+    return session_id % sm_ctx->io_loop_cnt;
+}
+
 int
 sm_connection_find_fd(const sm_ctx_t *sm_ctx, const int fd, sm_connection_t **connection)
 {
@@ -528,7 +559,9 @@ sm_connection_find_fd(const sm_ctx_t *sm_ctx, const int fd, sm_connection_t **co
     }
 
     tmp_conn.fd = fd;
+    SM_RDLOCK(sm_ctx);
     *connection = sr_btree_search(sm_ctx->connection_fd_btree, &tmp_conn);
+    SM_UNLOCK(sm_ctx);
 
     if (NULL == *connection) {
         SR_LOG_WRN("Cannot find the connection with fd=%d.", fd);
@@ -551,7 +584,9 @@ sm_connection_assign_dst(const sm_ctx_t *sm_ctx, sm_connection_t *connection, co
     }
 
     /* insert connection into binary tree for fast lookup by destination address */
+    SM_WRLOCK(sm_ctx);
     rc = sr_btree_insert(sm_ctx->connection_dst_btree, connection);
+    SM_UNLOCK(sm_ctx);
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR_MSG("Cannot insert new entry into fd binary tree (duplicate destination address?).");
     }
@@ -560,14 +595,18 @@ sm_connection_assign_dst(const sm_ctx_t *sm_ctx, sm_connection_t *connection, co
 }
 
 int
-sm_connection_find_dst(const sm_ctx_t *sm_ctx, const char *dst_address, sm_connection_t **connection)
+sm_connection_find_dst(const sm_ctx_t *sm_ctx, const char *dst_address, uint32_t io_loop,
+        sm_connection_t **connection)
 {
     sm_connection_t tmp_conn = { 0, };
 
     CHECK_NULL_ARG3(sm_ctx, dst_address, connection);
 
     tmp_conn.dst_address = dst_address;
+    tmp_conn.io_loop = io_loop;
+    SM_RDLOCK(sm_ctx);
     *connection = sr_btree_search(sm_ctx->connection_dst_btree, &tmp_conn);
+    SM_UNLOCK(sm_ctx);
 
     if (NULL == *connection) {
         SR_LOG_DBG("Cannot find the connection with dst_address address='%s'.", dst_address);
@@ -581,7 +620,10 @@ sm_session_get_index(const sm_ctx_t *sm_ctx, uint32_t index, sm_session_t **sess
 {
     CHECK_NULL_ARG2(sm_ctx, session);
 
+    /* write lock - iteration state is kept inside of the tree */
+    SM_WRLOCK(sm_ctx);
     *session = sr_btree_get_at(sm_ctx->session_id_btree, index);
+    SM_UNLOCK(sm_ctx);
 
     if (NULL == *session) {
         return SR_ERR_NOT_FOUND;
@@ -46,6 +46,12 @@ typedef struct cm_connection_ctx_s cm_connection_ctx_t;  /**< Forward-declaratio
  * SM allows fast session lookup by provided session_id (::sm_session_t#id
  * - see ::sm_session_find_id) and connection lookup by associated file descriptor
  * (::sm_connection_t#fd - see ::sm_connection_find_fd).
+ *
+ * All SM calls are thread-safe. Connection Manager may serve connections from
+ * multiple I/O loops (threads). Each connection is tied to one of them
+ * (::sm_connection_t#io_loop) and so are its sessions - the I/O loop index is
+ * encoded in the session ID (see ::sm_session_io_loop). Session and connection
+ * contexts returned by SM may be accessed only from the thread of their I/O loop.
  */
 
 /**
@@ -98,6 +104,8 @@ typedef struct sm_connection_s {
 
     int fd;                           /**< File descriptor of the connection. */
     const char *dst_address;          /**< Address of the destination by type == CM_AF_UNIX_SERVER */
+    uint32_t io_loop;                 /**< Index of the I/O loop serving the connection, needs to be set
+                                           before any session is created or destination address assigned. */
 
     uid_t uid;                        /**< Peer's effective user ID. */
     gid_t gid;                        /**< Peer's effective group ID. */
@@ -112,11 +120,13 @@ typedef struct sm_connection_s {
  *
  * @param[in] session_cleanup_cb Callback called by session cleanup (used to free CM-related data).
  * @param[in] connection_cleanup_cb Callback called by connection cleanup (used to free CM-related data).
+ * @param[in] io_loop_cnt Number of I/O loops serving the connections (at least 1).
  * @param[out] sm_ctx Allocated Session Manager context that can be used in subsequent SM requests.
  *
  * @return Error code (SR_ERR_OK on success).
  */
-int sm_init(sm_cleanup_cb session_cleanup_cb, sm_cleanup_cb connection_cleanup_cb, sm_ctx_t **sm_ctx);
+int sm_init(sm_cleanup_cb session_cleanup_cb, sm_cleanup_cb connection_cleanup_cb, uint32_t io_loop_cnt,
+        sm_ctx_t **sm_ctx);
 
 /**
  * @brief Cleans up Session Manager.
@@ -208,6 +218,17 @@ int sm_session_drop(const sm_ctx_t *sm_ctx, sm_session_t *session);
  */
 int sm_session_find_id(const sm_ctx_t *sm_ctx, uint32_t session_id, sm_session_t **session);
 
+/**
+ * @brief Returns index of the I/O loop serving the session with provided ID.
+ * No lookup is performed, therefore it can be used from any thread.
+ *
+ * @param[in] sm_ctx Session Manager context.
+ * @param[in] session_id ID of the session (0 maps to the I/O loop 0).
+ *
+ * @return Index of the I/O loop.
+ */
+uint32_t sm_session_io_loop(const sm_ctx_t *sm_ctx, uint32_t session_id);
+
 /**
  * @brief Finds connection context associated to provided file descriptor.
  *
@@ -235,15 +256,18 @@ int sm_connection_assign_dst(const sm_ctx_t *sm_ctx, sm_connection_t *connection
 /**
  * @brief Finds session context associated to provided destination address
  * (previously assigned to the connection by ::sm_connection_assign_dst).
+ * Each I/O loop uses its own connections to the destinations.
  *
  * @param[in] sm_ctx Session Manager context.
  * @param[in] dst_address Destination address string.
+ * @param[in] io_loop Index of the I/O loop the connection should belong to.
  * @param[out] connection Connection context matching with provided destination address.
  *
  * @return Error code (SR_ERR_OK on success, SR_ERR_NOT_FOUND if the connection
  * matching to the destination address cannot be found).
  */
-int sm_connection_find_dst(const sm_ctx_t *sm_ctx, const char *dst_address, sm_connection_t **connection);
+int sm_connection_find_dst(const sm_ctx_t *sm_ctx, const char *dst_address, uint32_t io_loop,
+        sm_connection_t **connection);
 
 /**
  * @brief Returns session context at given index (position) in a list (starting
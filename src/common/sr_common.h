@@ -44,6 +44,7 @@
 
 #include "sr_utils.h"
 #include "sr_data_structs.h"
+#include "sr_shm_channel.h"
 #include "sr_logger.h"
 #include "sr_protobuf.h"
 #include "sr_mem_mgmt.h"
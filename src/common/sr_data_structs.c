@@ -544,6 +544,180 @@ sr_cbuff_items_in_queue(sr_cbuff_t *buffer)
     }
 }
 
+#define SR_MPMC_QUEUE_CACHE_LINE 64  /**< Size of a CPU cache line, used to avoid false sharing of queue indexes. */
+
+/**
+ * @brief Cell of the MPMC queue.
+ */
+typedef struct sr_mpmc_queue_cell_s {
+    size_t sequence;  /**< Sequence number guarding the access to the cell data. */
+    uint8_t data[];   /**< Data of the cell. */
+} sr_mpmc_queue_cell_t;
+
+/**
+ * @brief Bounded lock-free MPMC queue context (based on the algorithm by Dmitry Vyukov).
+ */
+typedef struct sr_mpmc_queue_s {
+    uint8_t *cells;         /**< Array of queue cells. */
+    size_t cell_size;       /**< Size of one cell (sequence + element data) in bytes. */
+    size_t elem_size;       /**< Size of one element in the queue. */
+    size_t mask;            /**< Capacity - 1, used instead of the modulo operation. */
+    uint8_t pad0[SR_MPMC_QUEUE_CACHE_LINE];
+    size_t enqueue_pos;     /**< Position of the next enqueue (modified by producers only). */
+    uint8_t pad1[SR_MPMC_QUEUE_CACHE_LINE - sizeof(size_t)];
+    size_t dequeue_pos;     /**< Position of the next dequeue (modified by consumers only). */
+    uint8_t pad2[SR_MPMC_QUEUE_CACHE_LINE - sizeof(size_t)];
+} sr_mpmc_queue_t;
+
+/**
+ * @brief Returns the cell of the MPMC queue at given position.
+ */
+static inline sr_mpmc_queue_cell_t *
+sr_mpmc_queue_cell(sr_mpmc_queue_t *queue, size_t pos)
+{
+    return (sr_mpmc_queue_cell_t *)(queue->cells + ((pos & queue->mask) * queue->cell_size));
+}
+
+int
+sr_mpmc_queue_init(const size_t capacity, const size_t elem_size, sr_mpmc_queue_t **queue_p)
+{
+    sr_mpmc_queue_t *queue = NULL;
+    size_t real_capacity = 2, i = 0;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG(queue_p);
+
+    /* round the capacity up to the power of two */
+    while (real_capacity < capacity) {
+        real_capacity *= 2;
+    }
+
+    SR_LOG_DBG("Initiating MPMC queue for %zu elements.", real_capacity);
+
+    queue = calloc(1, sizeof(*queue));
+    CHECK_NULL_NOMEM_RETURN(queue);
+
+    queue->elem_size = elem_size;
+    queue->cell_size = sizeof(sr_mpmc_queue_cell_t) + elem_size;
+    /* keep the sequence numbers aligned */
+    queue->cell_size = (queue->cell_size + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t);
+    queue->mask = real_capacity - 1;
+
+    queue->cells = calloc(real_capacity, queue->cell_size);
+    CHECK_NULL_NOMEM_GOTO(queue->cells, rc, cleanup);
+
+    for (i = 0; i < real_capacity; i++) {
+        sr_mpmc_queue_cell(queue, i)->sequence = i;
+    }
+    queue->enqueue_pos = 0;
+    queue->dequeue_pos = 0;
+
+    *queue_p = queue;
+    return SR_ERR_OK;
+
+cleanup:
+    free(queue);
+    return rc;
+}
+
+void
+sr_mpmc_queue_cleanup(sr_mpmc_queue_t *queue)
+{
+    if (NULL != queue) {
+        free(queue->cells);
+        free(queue);
+    }
+}
+
+bool
+sr_mpmc_queue_enqueue(sr_mpmc_queue_t *queue, const void *item)
+{
+    sr_mpmc_queue_cell_t *cell = NULL;
+    size_t pos = 0, seq = 0;
+    intptr_t diff = 0;
+
+    if (NULL == queue || NULL == item) {
+        return false;
+    }
+
+    pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        cell = sr_mpmc_queue_cell(queue, pos);
+        seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        diff = (intptr_t)seq - (intptr_t)pos;
+        if (0 == diff) {
+            /* the cell is free, try to claim it */
+            if (__atomic_compare_exchange_n(&queue->enqueue_pos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+            /* pos has been updated by the failed CAS */
+        } else if (diff < 0) {
+            /* the cell has not been consumed yet - the queue is full */
+            return false;
+        } else {
+            /* another producer has claimed the cell */
+            pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(cell->data, item, queue->elem_size);
+    __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+bool
+sr_mpmc_queue_dequeue(sr_mpmc_queue_t *queue, void *item)
+{
+    sr_mpmc_queue_cell_t *cell = NULL;
+    size_t pos = 0, seq = 0;
+    intptr_t diff = 0;
+
+    if (NULL == queue || NULL == item) {
+        return false;
+    }
+
+    pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        cell = sr_mpmc_queue_cell(queue, pos);
+        seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (0 == diff) {
+            /* the cell is filled, try to claim it */
+            if (__atomic_compare_exchange_n(&queue->dequeue_pos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* the cell has not been filled yet - the queue is empty */
+            return false;
+        } else {
+            /* another consumer has claimed the cell */
+            pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(item, cell->data, queue->elem_size);
+    /* release the cell for the producer in the next round */
+    __atomic_store_n(&cell->sequence, pos + queue->mask + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+size_t
+sr_mpmc_queue_items_in_queue(sr_mpmc_queue_t *queue)
+{
+    size_t enqueue_pos = 0, dequeue_pos = 0;
+
+    if (NULL == queue) {
+        return 0;
+    }
+
+    dequeue_pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_SEQ_CST);
+    enqueue_pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_SEQ_CST);
+
+    return (enqueue_pos > dequeue_pos) ? (enqueue_pos - dequeue_pos) : 0;
+}
+
 /**
  * @brief Holds binary tree with filename -> fd maping. This structure
  * is used to check file locks inside of the process and to avoid
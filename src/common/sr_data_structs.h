@@ -27,7 +27,7 @@
  * @ingroup common
  * @{
  *
- * @brief Data structures used in sysrepo (list, linked-list, self-balanced binary tree, circular buffer).
+ * @brief Data structures used in sysrepo (list, linked-list, self-balanced binary tree, circular buffer, lock-free queue).
  */
 
 #include <stdint.h>
@@ -325,6 +325,72 @@ bool sr_cbuff_dequeue(sr_cbuff_t *buffer, void *item);
  */
 size_t sr_cbuff_items_in_queue(sr_cbuff_t *buffer);
 
+/**
+ * @brief Bounded lock-free multi-producer multi-consumer FIFO queue context.
+ */
+typedef struct sr_mpmc_queue_s sr_mpmc_queue_t;
+
+/**
+ * @brief Initializes a bounded lock-free MPMC queue of elements with given size.
+ *
+ * Unlike ::sr_cbuff_t, the queue can be safely accessed from multiple threads
+ * without any external locking. The capacity is fixed (rounded up to the
+ * nearest power of two), enqueue fails if the queue is full.
+ *
+ * @param[in] capacity Minimal queue capacity in number of elements.
+ * @param[in] elem_size Size of one element (in bytes).
+ * @param[out] queue MPMC queue context.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_mpmc_queue_init(const size_t capacity, const size_t elem_size, sr_mpmc_queue_t **queue);
+
+/**
+ * @brief Cleans up MPMC queue.
+ *
+ * All memory allocated within provided queue context will be freed.
+ * Must not be called while any other thread still accesses the queue.
+ *
+ * @param[in] queue MPMC queue context.
+ */
+void sr_mpmc_queue_cleanup(sr_mpmc_queue_t *queue);
+
+/**
+ * @brief Enqueues an element into MPMC queue. Thread-safe, lock-free.
+ *
+ * @note O(1).
+ *
+ * @param[in] queue MPMC queue context.
+ * @param[in] item The element to be enqueued (pointer to memory from where
+ * the data will be copied to the queue).
+ *
+ * @return TRUE if the element was enqueued, FALSE if the queue is full.
+ */
+bool sr_mpmc_queue_enqueue(sr_mpmc_queue_t *queue, const void *item);
+
+/**
+ * @brief Dequeues an element from MPMC queue. Thread-safe, lock-free.
+ *
+ * @note O(1).
+ *
+ * @param[in] queue MPMC queue context.
+ * @param[out] item Pointer to memory where dequeued data will be copied.
+ *
+ * @return TRUE if an element was dequeued, FALSE if the queue is empty.
+ */
+bool sr_mpmc_queue_dequeue(sr_mpmc_queue_t *queue, void *item);
+
+/**
+ * @brief Return number of elements currently stored in the queue.
+ *
+ * @note The value is only approximate if the queue is being concurrently modified.
+ *
+ * @param[in] queue MPMC queue context.
+ *
+ * @return Number of elements currently stored in the queue.
+ */
+size_t sr_mpmc_queue_items_in_queue(sr_mpmc_queue_t *queue);
+
 /**
  * @brief Locking set context.
  */
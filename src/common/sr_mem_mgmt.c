@@ -507,6 +507,9 @@ sr_msg_free(Sr__Msg *msg)
 
     sr_mem_ctx_t *sr_mem = (sr_mem_ctx_t *)msg->_sysrepo_mem_ctx;
 
+    sr_packed_payload_release((sr_packed_payload_t *)msg->_packed_payload);
+    msg->_packed_payload = 0;
+
     if (sr_mem) {
         if (0 == --sr_mem->obj_count) {
             sr_mem_free(sr_mem);
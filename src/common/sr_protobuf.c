@@ -65,6 +65,10 @@ sr_gpb_operation_name(Sr__Operation operation)
         return "delete-item";
     case SR__OPERATION__MOVE_ITEM:
         return "move-item";
+    case SR__OPERATION__EDIT_BATCH:
+        return "edit-batch";
+    case SR__OPERATION__IMPORT_DATA:
+        return "import-data";
     case SR__OPERATION__VALIDATE:
         return "validate";
     case SR__OPERATION__COMMIT:
@@ -101,6 +105,8 @@ sr_gpb_operation_name(Sr__Operation operation)
         return "event-notification";
     case SR__OPERATION__EVENT_NOTIF_REPLAY:
         return "event-notification-replay";
+    case SR__OPERATION__DP_CACHE_INVALIDATE:
+        return "dp-cache-invalidate";
     case SR__OPERATION__OPER_DATA_TIMEOUT:
         return "oper-data-timeout";
     case SR__OPERATION__INTERNAL_STATE_DATA:
@@ -248,6 +254,18 @@ sr_gpb_req_alloc(sr_mem_ctx_t *sr_mem, const Sr__Operation operation, const uint
             sr__set_item_str_req__init((Sr__SetItemStrReq*)sub_msg);
             req->set_item_str_req = (Sr__SetItemStrReq*)sub_msg;
             break;
+        case SR__OPERATION__EDIT_BATCH:
+            sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__EditBatchReq));
+            CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
+            sr__edit_batch_req__init((Sr__EditBatchReq*)sub_msg);
+            req->edit_batch_req = (Sr__EditBatchReq*)sub_msg;
+            break;
+        case SR__OPERATION__IMPORT_DATA:
+            sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__ImportDataReq));
+            CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
+            sr__import_data_req__init((Sr__ImportDataReq*)sub_msg);
+            req->import_data_req = (Sr__ImportDataReq*)sub_msg;
+            break;
         case SR__OPERATION__DELETE_ITEM:
             sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__DeleteItemReq));
             CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
@@ -351,6 +369,12 @@ sr_gpb_req_alloc(sr_mem_ctx_t *sr_mem, const Sr__Operation operation, const uint
             sr__event_notif_replay_req__init((Sr__EventNotifReplayReq*)sub_msg);
             req->event_notif_replay_req = (Sr__EventNotifReplayReq*)sub_msg;
             break;
+        case SR__OPERATION__DP_CACHE_INVALIDATE:
+            sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__DpCacheInvalidateReq));
+            CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
+            sr__dp_cache_invalidate_req__init((Sr__DpCacheInvalidateReq*)sub_msg);
+            req->dp_cache_invalidate_req = (Sr__DpCacheInvalidateReq*)sub_msg;
+            break;
         default:
             rc = SR_ERR_UNSUPPORTED;
             goto error;
@@ -510,6 +534,18 @@ sr_gpb_resp_alloc(sr_mem_ctx_t *sr_mem, const Sr__Operation operation, const uin
             sr__set_item_str_resp__init((Sr__SetItemStrResp*)sub_msg);
             resp->set_item_str_resp = (Sr__SetItemStrResp*)sub_msg;
             break;
+        case SR__OPERATION__EDIT_BATCH:
+            sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__EditBatchResp));
+            CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
+            sr__edit_batch_resp__init((Sr__EditBatchResp*)sub_msg);
+            resp->edit_batch_resp = (Sr__EditBatchResp*)sub_msg;
+            break;
+        case SR__OPERATION__IMPORT_DATA:
+            sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__ImportDataResp));
+            CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
+            sr__import_data_resp__init((Sr__ImportDataResp*)sub_msg);
+            resp->import_data_resp = (Sr__ImportDataResp*)sub_msg;
+            break;
         case SR__OPERATION__DELETE_ITEM:
             sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__DeleteItemResp));
             CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
@@ -613,6 +649,12 @@ sr_gpb_resp_alloc(sr_mem_ctx_t *sr_mem, const Sr__Operation operation, const uin
             sr__event_notif_replay_resp__init((Sr__EventNotifReplayResp*)sub_msg);
             resp->event_notif_replay_resp = (Sr__EventNotifReplayResp*)sub_msg;
             break;
+        case SR__OPERATION__DP_CACHE_INVALIDATE:
+            sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__DpCacheInvalidateResp));
+            CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
+            sr__dp_cache_invalidate_resp__init((Sr__DpCacheInvalidateResp*)sub_msg);
+            resp->dp_cache_invalidate_resp = (Sr__DpCacheInvalidateResp*)sub_msg;
+            break;
         default:
             rc = SR_ERR_UNSUPPORTED;
             goto error;
@@ -931,6 +973,12 @@ sr_gpb_msg_validate(const Sr__Msg *msg, const Sr__Msg__MsgType type, const Sr__O
             case SR__OPERATION__SET_ITEM_STR:
                 CHECK_NULL_RETURN(msg->request->set_item_str_req, SR_ERR_MALFORMED_MSG);
                 break;
+            case SR__OPERATION__EDIT_BATCH:
+                CHECK_NULL_RETURN(msg->request->edit_batch_req, SR_ERR_MALFORMED_MSG);
+                break;
+            case SR__OPERATION__IMPORT_DATA:
+                CHECK_NULL_RETURN(msg->request->import_data_req, SR_ERR_MALFORMED_MSG);
+                break;
             case SR__OPERATION__DELETE_ITEM:
                 CHECK_NULL_RETURN(msg->request->delete_item_req, SR_ERR_MALFORMED_MSG);
                 break;
@@ -983,6 +1031,9 @@ sr_gpb_msg_validate(const Sr__Msg *msg, const Sr__Msg__MsgType type, const Sr__O
             case SR__OPERATION__EVENT_NOTIF_REPLAY:
                 CHECK_NULL_RETURN(msg->request->event_notif_replay_req, SR_ERR_MALFORMED_MSG);
                 break;
+            case SR__OPERATION__DP_CACHE_INVALIDATE:
+                CHECK_NULL_RETURN(msg->request->dp_cache_invalidate_req, SR_ERR_MALFORMED_MSG);
+                break;
             default:
                 return SR_ERR_MALFORMED_MSG;
         }
@@ -1044,6 +1095,12 @@ sr_gpb_msg_validate(const Sr__Msg *msg, const Sr__Msg__MsgType type, const Sr__O
             case SR__OPERATION__SET_ITEM_STR:
                 CHECK_NULL_RETURN(msg->response->set_item_str_resp, SR_ERR_MALFORMED_MSG);
                 break;
+            case SR__OPERATION__EDIT_BATCH:
+                CHECK_NULL_RETURN(msg->response->edit_batch_resp, SR_ERR_MALFORMED_MSG);
+                break;
+            case SR__OPERATION__IMPORT_DATA:
+                CHECK_NULL_RETURN(msg->response->import_data_resp, SR_ERR_MALFORMED_MSG);
+                break;
             case SR__OPERATION__DELETE_ITEM:
                 CHECK_NULL_RETURN(msg->response->delete_item_resp, SR_ERR_MALFORMED_MSG);
                 break;
@@ -1096,6 +1153,9 @@ sr_gpb_msg_validate(const Sr__Msg *msg, const Sr__Msg__MsgType type, const Sr__O
             case SR__OPERATION__EVENT_NOTIF_REPLAY:
                 CHECK_NULL_RETURN(msg->response->event_notif_replay_resp, SR_ERR_MALFORMED_MSG);
                 break;
+            case SR__OPERATION__DP_CACHE_INVALIDATE:
+                CHECK_NULL_RETURN(msg->response->dp_cache_invalidate_resp, SR_ERR_MALFORMED_MSG);
+                break;
             default:
                 return SR_ERR_MALFORMED_MSG;
         }
@@ -1986,6 +2046,150 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Copies a libyang node and its descendants directly into a GPB tree allocated in the memory context.
+ * Scalar values are stored into the memory context once and shared by the GPB tree.
+ */
+static int
+sr_copy_node_to_gpb_tree(sr_mem_ctx_t *sr_mem, const struct lyd_node *parent, const struct lyd_node *node,
+        sr_tree_pruning_cb pruning_cb, void *pruning_ctx, Sr__Node **gpb_tree)
+{
+    Sr__Node *gpb = NULL;
+    sr_val_t value = { 0, };
+    const struct lyd_node *child = NULL;
+    size_t children_cnt = 0;
+    bool prune = false;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(sr_mem, node, node->schema, gpb_tree);
+
+    gpb = sr_calloc(sr_mem, 1, sizeof(*gpb));
+    CHECK_NULL_NOMEM_RETURN(gpb);
+    sr__node__init(gpb);
+    gpb->value = sr_calloc(sr_mem, 1, sizeof(*gpb->value));
+    CHECK_NULL_NOMEM_RETURN(gpb->value);
+    sr__value__init(gpb->value);
+
+    /* type and value, strings are allocated in sr_mem and shared with GPB */
+    value._sr_mem = sr_mem;
+    switch (node->schema->nodetype) {
+        case LYS_LEAF:
+        case LYS_LEAFLIST:
+            value.type = sr_libyang_leaf_get_type((const struct lyd_node_leaf_list *)node);
+            rc = sr_libyang_leaf_copy_value((const struct lyd_node_leaf_list *)node, &value);
+            CHECK_RC_LOG_RETURN(rc, "Error returned from sr_libyang_leaf_copy_value: %s.", sr_strerror(rc));
+            break;
+        case LYS_CONTAINER:
+            value.type = ((struct lys_node_container *)node->schema)->presence != NULL ?
+                    SR_CONTAINER_PRESENCE_T : SR_CONTAINER_T;
+            break;
+        case LYS_LIST:
+            value.type = SR_LIST_T;
+            break;
+        case LYS_ANYXML:
+        case LYS_ANYDATA:
+            value.type = (LYS_ANYXML == node->schema->nodetype) ? SR_ANYXML_T : SR_ANYDATA_T;
+            rc = sr_libyang_anydata_copy_value((const struct lyd_node_anydata *)node, &value);
+            CHECK_RC_LOG_RETURN(rc, "Error returned from sr_libyang_anydata_copy_value: %s.", sr_strerror(rc));
+            break;
+        default:
+            SR_LOG_ERR("Detected unsupported node data type (schema name: %s).", node->schema->name);
+            return SR_ERR_UNSUPPORTED;
+    }
+    value.dflt = node->dflt;
+
+    rc = sr_set_val_t_type_in_gpb(&value, gpb->value);
+    CHECK_RC_LOG_RETURN(rc, "Setting value type in gpb tree failed for node '%s'", node->schema->name);
+
+    rc = sr_set_val_t_value_in_gpb(&value, gpb->value);
+    CHECK_RC_LOG_RETURN(rc, "Setting value in gpb tree failed for node '%s'", node->schema->name);
+
+    /* node name is transferred in the xpath member */
+    rc = sr_mem_edit_string(sr_mem, &gpb->value->xpath, node->schema->name);
+    CHECK_RC_MSG_RETURN(rc, "Failed to set name of a GPB node.");
+
+    if (NULL == parent || lyd_node_module(parent) != lyd_node_module(node)) {
+        rc = sr_mem_edit_string(sr_mem, &gpb->module_name, lyd_node_module(node)->name);
+        CHECK_RC_MSG_RETURN(rc, "Failed to set module of a GPB node.");
+    }
+
+    /* children */
+    if ((LYS_CONTAINER | LYS_LIST) & node->schema->nodetype) {
+        LY_TREE_FOR(node->child, child) {
+            ++children_cnt;
+        }
+        if (0 < children_cnt) {
+            gpb->children = sr_calloc(sr_mem, children_cnt, sizeof(*gpb->children));
+            CHECK_NULL_NOMEM_RETURN(gpb->children);
+        }
+        LY_TREE_FOR(node->child, child) {
+            prune = false;
+            if (NULL != pruning_cb) {
+                rc = pruning_cb(pruning_ctx, child, &prune);
+                CHECK_RC_MSG_RETURN(rc, "Tree pruning has failed.");
+            }
+            if (prune) {
+                continue;
+            }
+            rc = sr_copy_node_to_gpb_tree(sr_mem, node, child, pruning_cb, pruning_ctx,
+                    gpb->children + gpb->n_children);
+            if (SR_ERR_OK != rc) {
+                return rc;
+            }
+            ++gpb->n_children;
+        }
+    }
+
+    *gpb_tree = gpb;
+    return rc;
+}
+
+int
+sr_nodes_to_gpb_trees(struct ly_set *nodes, sr_mem_ctx_t *sr_mem, sr_tree_pruning_cb pruning_cb, void *pruning_ctx,
+        Sr__Node ***gpb_trees_p, size_t *gpb_tree_cnt_p)
+{
+    Sr__Node **gpb_trees = NULL;
+    size_t tree_cnt = 0;
+    sr_mem_snapshot_t snapshot = { 0, };
+    bool prune = false;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(nodes, sr_mem, gpb_trees_p, gpb_tree_cnt_p);
+
+    if (0 == nodes->number) {
+        *gpb_trees_p = NULL;
+        *gpb_tree_cnt_p = 0;
+        return rc;
+    }
+
+    sr_mem_snapshot(sr_mem, &snapshot);
+
+    gpb_trees = sr_calloc(sr_mem, nodes->number, sizeof(*gpb_trees));
+    CHECK_NULL_NOMEM_RETURN(gpb_trees);
+
+    for (size_t i = 0; i < nodes->number; ++i) {
+        prune = false;
+        if (NULL != pruning_cb) {
+            rc = pruning_cb(pruning_ctx, nodes->set.d[i], &prune);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Tree pruning has failed.");
+        }
+        if (prune) {
+            continue;
+        }
+        rc = sr_copy_node_to_gpb_tree(sr_mem, NULL, nodes->set.d[i], pruning_cb, pruning_ctx, gpb_trees + tree_cnt);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to copy libyang node to GPB.");
+        ++tree_cnt;
+    }
+
+    *gpb_trees_p = 0 < tree_cnt ? gpb_trees : NULL;
+    *gpb_tree_cnt_p = tree_cnt;
+    return SR_ERR_OK;
+
+cleanup:
+    sr_mem_restore(&snapshot);
+    return rc;
+}
+
 int
 sr_changes_sr_to_gpb(sr_list_t *sr_changes, sr_mem_ctx_t *sr_mem, Sr__Change ***gpb_changes_p, size_t *gpb_count)
 {
@@ -2779,3 +2983,327 @@ sr_gpb_fill_errors(sr_error_info_t *sr_errors, size_t sr_error_cnt, sr_mem_ctx_t
 
     return SR_ERR_OK;
 }
+
+/** Wire types of the protocol buffers encoding used when splicing a packed payload into a message. */
+#define SR_GPB_WIRE_VARINT 0
+#define SR_GPB_WIRE_64BIT  1
+#define SR_GPB_WIRE_LEN    2
+#define SR_GPB_WIRE_32BIT  5
+
+/**
+ * @brief Returns the number of the field of the message as defined in sysrepo.proto.
+ */
+static uint32_t
+sr_gpb_field_id(const ProtobufCMessageDescriptor *descriptor, const char *name)
+{
+    const ProtobufCFieldDescriptor *field = protobuf_c_message_descriptor_get_field_by_name(descriptor, name);
+    return (NULL != field) ? field->id : 0;
+}
+
+/**
+ * @brief Returns the number of bytes needed to encode the value as varint.
+ */
+static size_t
+sr_gpb_varint_size(uint64_t value)
+{
+    size_t size = 1;
+
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+/**
+ * @brief Encodes the value as varint, returns the number of bytes written.
+ */
+static size_t
+sr_gpb_varint_pack(uint64_t value, uint8_t *buff)
+{
+    size_t size = 0;
+
+    while (value >= 0x80) {
+        buff[size++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    buff[size++] = (uint8_t)value;
+    return size;
+}
+
+/**
+ * @brief Decodes a varint from the buffer, returns the number of bytes read or 0 if the buffer ends prematurely.
+ */
+static size_t
+sr_gpb_varint_unpack(const uint8_t *buff, size_t size, uint64_t *value)
+{
+    size_t pos = 0;
+
+    *value = 0;
+    while (pos < size && pos < 10) {
+        *value |= (uint64_t)(buff[pos] & 0x7f) << (7 * pos);
+        if (0 == (buff[pos++] & 0x80)) {
+            return pos;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns the size of the encoded field key (field number and wire type).
+ */
+static size_t
+sr_gpb_key_size(uint32_t field_id)
+{
+    return sr_gpb_varint_size((uint64_t)field_id << 3);
+}
+
+/**
+ * @brief Encodes the field key (field number and wire type), returns the number of bytes written.
+ */
+static size_t
+sr_gpb_key_pack(uint32_t field_id, uint8_t wire_type, uint8_t *buff)
+{
+    return sr_gpb_varint_pack(((uint64_t)field_id << 3) | wire_type, buff);
+}
+
+/**
+ * @brief Sizes of the nested messages of an event notification request with attached payload.
+ */
+typedef struct sr_gpb_spliced_sizes_s {
+    size_t event_notif_req;   /**< size of the EventNotifReq content (payload and subscriber details) */
+    size_t request;           /**< size of the Request content */
+    size_t msg;               /**< size of the whole Msg */
+} sr_gpb_spliced_sizes_t;
+
+/**
+ * @brief Returns the attached payload if the message is an event notification request that can be packed with it.
+ */
+static const sr_packed_payload_t *
+sr_gpb_msg_payload(const Sr__Msg *msg)
+{
+    if (0 == msg->_packed_payload || SR__MSG__MSG_TYPE__REQUEST != msg->type || NULL == msg->request ||
+            SR__OPERATION__EVENT_NOTIF != msg->request->operation || NULL == msg->request->event_notif_req) {
+        return NULL;
+    }
+    return (const sr_packed_payload_t *)msg->_packed_payload;
+}
+
+/**
+ * @brief Computes the sizes of the nested messages of an event notification request with attached payload.
+ */
+static void
+sr_gpb_spliced_sizes(const Sr__Msg *msg, const sr_packed_payload_t *payload, sr_gpb_spliced_sizes_t *sizes)
+{
+    const Sr__EventNotifReq *req = msg->request->event_notif_req;
+    size_t len = 0;
+
+    /* EventNotifReq: payload followed by the subscriber details */
+    sizes->event_notif_req = payload->size;
+    if (NULL != req->subscriber_address) {
+        len = strlen(req->subscriber_address);
+        sizes->event_notif_req += sr_gpb_key_size(sr_gpb_field_id(&sr__event_notif_req__descriptor, "subscriber_address")) +
+                sr_gpb_varint_size(len) + len;
+    }
+    if (req->has_subscription_id) {
+        sizes->event_notif_req += sr_gpb_key_size(sr_gpb_field_id(&sr__event_notif_req__descriptor, "subscription_id")) +
+                sr_gpb_varint_size(req->subscription_id);
+    }
+
+    /* Request: operation and the event notification request */
+    sizes->request = sr_gpb_key_size(sr_gpb_field_id(&sr__request__descriptor, "operation")) +
+            sr_gpb_varint_size(msg->request->operation) +
+            sr_gpb_key_size(sr_gpb_field_id(&sr__request__descriptor, "event_notif_req")) +
+            sr_gpb_varint_size(sizes->event_notif_req) + sizes->event_notif_req;
+
+    /* Msg: type, session id, request, request id and memory context (required, sent as 0) */
+    sizes->msg = sr_gpb_key_size(sr_gpb_field_id(&sr__msg__descriptor, "type")) + sr_gpb_varint_size(msg->type) +
+            sr_gpb_key_size(sr_gpb_field_id(&sr__msg__descriptor, "session_id")) + sr_gpb_varint_size(msg->session_id) +
+            sr_gpb_key_size(sr_gpb_field_id(&sr__msg__descriptor, "request")) +
+            sr_gpb_varint_size(sizes->request) + sizes->request +
+            sr_gpb_key_size(sr_gpb_field_id(&sr__msg__descriptor, "_sysrepo_mem_ctx")) + sr_gpb_varint_size(0);
+    if (msg->has_request_id) {
+        sizes->msg += sr_gpb_key_size(sr_gpb_field_id(&sr__msg__descriptor, "request_id")) +
+                sr_gpb_varint_size(msg->request_id);
+    }
+}
+
+int
+sr_gpb_event_notif_payload_pack(const Sr__EventNotifReq *event_notif_req, sr_packed_payload_t **payload_p)
+{
+    Sr__EventNotifReq content;
+    sr_packed_payload_t *payload = NULL;
+
+    CHECK_NULL_ARG2(event_notif_req, payload_p);
+
+    /* everything except the subscriber details */
+    content = *event_notif_req;
+    content.subscriber_address = NULL;
+    content.has_subscription_id = false;
+
+    payload = calloc(1, sizeof(*payload));
+    CHECK_NULL_NOMEM_RETURN(payload);
+
+    payload->size = sr__event_notif_req__get_packed_size(&content);
+    payload->data = malloc(payload->size ? payload->size : 1);
+    if (NULL == payload->data) {
+        free(payload);
+        SR_LOG_ERR_MSG("Unable to allocate memory for the packed payload.");
+        return SR_ERR_NOMEM;
+    }
+    sr__event_notif_req__pack(&content, payload->data);
+    payload->ref_count = 1;
+
+    *payload_p = payload;
+    return SR_ERR_OK;
+}
+
+int
+sr_gpb_msg_attach_payload(Sr__Msg *msg, sr_packed_payload_t *payload)
+{
+    CHECK_NULL_ARG4(msg, msg->request, msg->request->event_notif_req, payload);
+
+    if (SR__OPERATION__EVENT_NOTIF != msg->request->operation) {
+        SR_LOG_ERR_MSG("Payload can be attached only to an event notification request.");
+        return SR_ERR_INVAL_ARG;
+    }
+
+    __atomic_add_fetch(&payload->ref_count, 1, __ATOMIC_RELAXED);
+    sr_packed_payload_release((sr_packed_payload_t *)msg->_packed_payload);
+    msg->_packed_payload = (uint64_t)payload;
+
+    return SR_ERR_OK;
+}
+
+void
+sr_packed_payload_release(sr_packed_payload_t *payload)
+{
+    if (NULL == payload) {
+        return;
+    }
+    if (0 == __atomic_sub_fetch(&payload->ref_count, 1, __ATOMIC_ACQ_REL)) {
+        free(payload->data);
+        free(payload);
+    }
+}
+
+size_t
+sr_gpb_msg_get_packed_size(const Sr__Msg *msg)
+{
+    const sr_packed_payload_t *payload = sr_gpb_msg_payload(msg);
+    sr_gpb_spliced_sizes_t sizes = { 0, };
+
+    if (NULL == payload) {
+        return sr__msg__get_packed_size(msg);
+    }
+
+    sr_gpb_spliced_sizes(msg, payload, &sizes);
+    return sizes.msg;
+}
+
+size_t
+sr_gpb_msg_pack(const Sr__Msg *msg, uint8_t *buff)
+{
+    const sr_packed_payload_t *payload = sr_gpb_msg_payload(msg);
+    const Sr__EventNotifReq *req = NULL;
+    sr_gpb_spliced_sizes_t sizes = { 0, };
+    size_t pos = 0, len = 0;
+
+    if (NULL == payload) {
+        return sr__msg__pack(msg, buff);
+    }
+    req = msg->request->event_notif_req;
+    sr_gpb_spliced_sizes(msg, payload, &sizes);
+
+    /* Msg */
+    pos += sr_gpb_key_pack(sr_gpb_field_id(&sr__msg__descriptor, "type"), SR_GPB_WIRE_VARINT, buff + pos);
+    pos += sr_gpb_varint_pack(msg->type, buff + pos);
+    pos += sr_gpb_key_pack(sr_gpb_field_id(&sr__msg__descriptor, "session_id"), SR_GPB_WIRE_VARINT, buff + pos);
+    pos += sr_gpb_varint_pack(msg->session_id, buff + pos);
+    pos += sr_gpb_key_pack(sr_gpb_field_id(&sr__msg__descriptor, "request"), SR_GPB_WIRE_LEN, buff + pos);
+    pos += sr_gpb_varint_pack(sizes.request, buff + pos);
+
+    /* Request */
+    pos += sr_gpb_key_pack(sr_gpb_field_id(&sr__request__descriptor, "operation"), SR_GPB_WIRE_VARINT, buff + pos);
+    pos += sr_gpb_varint_pack(msg->request->operation, buff + pos);
+    pos += sr_gpb_key_pack(sr_gpb_field_id(&sr__request__descriptor, "event_notif_req"), SR_GPB_WIRE_LEN, buff + pos);
+    pos += sr_gpb_varint_pack(sizes.event_notif_req, buff + pos);
+
+    /* EventNotifReq: the shared payload and the subscriber details */
+    memcpy(buff + pos, payload->data, payload->size);
+    pos += payload->size;
+    if (NULL != req->subscriber_address) {
+        len = strlen(req->subscriber_address);
+        pos += sr_gpb_key_pack(sr_gpb_field_id(&sr__event_notif_req__descriptor, "subscriber_address"), SR_GPB_WIRE_LEN, buff + pos);
+        pos += sr_gpb_varint_pack(len, buff + pos);
+        memcpy(buff + pos, req->subscriber_address, len);
+        pos += len;
+    }
+    if (req->has_subscription_id) {
+        pos += sr_gpb_key_pack(sr_gpb_field_id(&sr__event_notif_req__descriptor, "subscription_id"), SR_GPB_WIRE_VARINT, buff + pos);
+        pos += sr_gpb_varint_pack(req->subscription_id, buff + pos);
+    }
+
+    /* rest of Msg */
+    if (msg->has_request_id) {
+        pos += sr_gpb_key_pack(sr_gpb_field_id(&sr__msg__descriptor, "request_id"), SR_GPB_WIRE_VARINT, buff + pos);
+        pos += sr_gpb_varint_pack(msg->request_id, buff + pos);
+    }
+    pos += sr_gpb_key_pack(sr_gpb_field_id(&sr__msg__descriptor, "_sysrepo_mem_ctx"), SR_GPB_WIRE_VARINT, buff + pos);
+    pos += sr_gpb_varint_pack(0, buff + pos);
+
+    return pos;
+}
+
+int
+sr_gpb_msg_peek_request_id(const uint8_t *msg_data, size_t msg_size, bool *has_request_id, uint64_t *request_id)
+{
+    uint32_t request_id_field = sr_gpb_field_id(&sr__msg__descriptor, "request_id");
+    uint64_t key = 0, value = 0;
+    size_t pos = 0, len = 0;
+
+    CHECK_NULL_ARG3(msg_data, has_request_id, request_id);
+
+    *has_request_id = false;
+    *request_id = 0;
+
+    /* walk the top-level fields of Msg without decoding the nested messages */
+    while (pos < msg_size) {
+        len = sr_gpb_varint_unpack(msg_data + pos, msg_size - pos, &key);
+        if (0 == len) {
+            return SR_ERR_MALFORMED_MSG;
+        }
+        pos += len;
+        switch (key & 0x7) {
+            case SR_GPB_WIRE_VARINT:
+                len = sr_gpb_varint_unpack(msg_data + pos, msg_size - pos, &value);
+                if (0 == len) {
+                    return SR_ERR_MALFORMED_MSG;
+                }
+                pos += len;
+                if ((key >> 3) == request_id_field) {
+                    /* the last occurrence wins, as in the regular unpack */
+                    *has_request_id = true;
+                    *request_id = value;
+                }
+                break;
+            case SR_GPB_WIRE_64BIT:
+                pos += 8;
+                break;
+            case SR_GPB_WIRE_LEN:
+                len = sr_gpb_varint_unpack(msg_data + pos, msg_size - pos, &value);
+                if (0 == len || value > msg_size - pos - len) {
+                    return SR_ERR_MALFORMED_MSG;
+                }
+                pos += len + value;
+                break;
+            case SR_GPB_WIRE_32BIT:
+                pos += 4;
+                break;
+            default:
+                return SR_ERR_MALFORMED_MSG;
+        }
+    }
+
+    return (pos == msg_size) ? SR_ERR_OK : SR_ERR_MALFORMED_MSG;
+}
@@ -220,6 +220,23 @@ int sr_copy_gpb_to_tree(const Sr__Node *gpb_tree, sr_node_t *sr_tree);
  */
 int sr_trees_sr_to_gpb(const sr_node_t *sr_trees, const size_t sr_tree_cnt, Sr__Node ***gpb_trees, size_t *gpb_tree_cnt);
 
+/**
+ * @brief Converts a set of libyang nodes directly into an array of GPB trees, without building
+ * intermediate sysrepo trees. For each node a corresponding GPB (sub)tree is constructed.
+ * It is assumed that the input nodes are not descendants and predecessors of each other.
+ *
+ * @param[in] nodes A set of libyang nodes.
+ * @param[in] sr_mem Sysrepo memory context where the GPB trees are allocated (cannot be NULL).
+ * @param[in] pruning_cb For each subtree this callback decides if it should be pruned away.
+ * @param[in] pruning_ctx Context to pruning callback, opaque to this function.
+ * @param[out] gpb_trees Array of GPB trees.
+ * @param[out] gpb_tree_cnt Number of GPB trees as returned in gpb_trees.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_nodes_to_gpb_trees(struct ly_set *nodes, sr_mem_ctx_t *sr_mem, sr_tree_pruning_cb pruning_cb, void *pruning_ctx,
+        Sr__Node ***gpb_trees, size_t *gpb_tree_cnt);
+
 /**
  * @brief Copies and transforms an array of GPB trees into the array of sysrepo-represented trees.
  *
@@ -450,6 +467,77 @@ int sr_gpb_fill_error(const char *error_message, const char *error_path, sr_mem_
 int sr_gpb_fill_errors(sr_error_info_t *sr_errors, size_t sr_error_cnt, sr_mem_ctx_t *sr_mem, Sr__Error ***gpb_errors,
         size_t *gpb_error_cnt);
 
+/**
+ * @brief Content of a message packed once and shared by multiple messages, e.g. the content of an event
+ * notification delivered to many subscribers. A message references the payload using its _packed_payload field,
+ * the payload is released together with the message (see ::sr_msg_free).
+ */
+typedef struct sr_packed_payload_s {
+    uint8_t *data;          /**< Packed fields of the event notification request. */
+    size_t size;            /**< Size of the packed data. */
+    uint32_t ref_count;     /**< Number of references to the payload (updated atomically). */
+} sr_packed_payload_t;
+
+/**
+ * @brief Packs the content of the event notification request (all fields except the subscriber
+ * address and subscription id) into a shared payload.
+ *
+ * @param[in] event_notif_req Event notification request.
+ * @param[out] payload Packed payload with one reference held by the caller (release with ::sr_packed_payload_release).
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_gpb_event_notif_payload_pack(const Sr__EventNotifReq *event_notif_req, sr_packed_payload_t **payload);
+
+/**
+ * @brief Attaches the payload to an event notification request message. The content of the payload is spliced
+ * into the packed message by ::sr_gpb_msg_pack, the message itself should carry only the subscriber details.
+ *
+ * @param[in] msg Event notification request message.
+ * @param[in] payload Payload, a new reference is acquired for the message.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_gpb_msg_attach_payload(Sr__Msg *msg, sr_packed_payload_t *payload);
+
+/**
+ * @brief Releases a reference to the payload, the payload is freed once there are no references left.
+ *
+ * @param[in] payload Payload, can be NULL.
+ */
+void sr_packed_payload_release(sr_packed_payload_t *payload);
+
+/**
+ * @brief Returns the size of the packed message, including the attached payload.
+ *
+ * @param[in] msg Message.
+ *
+ * @return Size of the packed message.
+ */
+size_t sr_gpb_msg_get_packed_size(const Sr__Msg *msg);
+
+/**
+ * @brief Packs the message, the attached payload (if any) is spliced in without packing its content again.
+ *
+ * @param[in] msg Message.
+ * @param[out] buff Buffer of the size returned by ::sr_gpb_msg_get_packed_size.
+ *
+ * @return Number of bytes written into the buffer.
+ */
+size_t sr_gpb_msg_pack(const Sr__Msg *msg, uint8_t *buff);
+
+/**
+ * @brief Reads the request ID from the packed message without unpacking the whole message.
+ *
+ * @param[in] msg_data Packed message.
+ * @param[in] msg_size Size of the packed message.
+ * @param[out] has_request_id TRUE if the message carries a request ID.
+ * @param[out] request_id Request ID of the message (0 if not present).
+ *
+ * @return Error code (SR_ERR_OK on success, SR_ERR_MALFORMED_MSG if the message can not be walked through).
+ */
+int sr_gpb_msg_peek_request_id(const uint8_t *msg_data, size_t msg_size, bool *has_request_id, uint64_t *request_id);
+
 /**@} gpb_wrappers */
 
 #endif /* SR_PROTOBUF_H_ */
@@ -0,0 +1,335 @@
+/**
+ * @file sr_shm_channel.c
+ * @author agent <agent@local>
+ * @brief Shared-memory channel implementation.
+ *
+ * @copyright
+ * Copyright 2026 agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "sr_common.h"
+#include "sr_shm_channel.h"
+
+#ifdef HAVE_MEMFD_CREATE
+#include <sys/syscall.h>
+#include <linux/memfd.h>
+
+/* file sealing is declared by fcntl.h only with _GNU_SOURCE */
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS (1024 + 9)
+#define F_SEAL_SEAL 0x0001
+#define F_SEAL_SHRINK 0x0002
+#define F_SEAL_GROW 0x0004
+#endif
+#endif
+
+#define SR_SHM_MAGIC 0x53525348     /**< Magic number identifying a sysrepo shared-memory segment ("SRSH"). */
+#define SR_SHM_VERSION 1            /**< Version of the layout of the shared-memory segment. */
+#define SR_SHM_CACHE_LINE 64        /**< Alignment of the ring indexes (avoids false sharing between the peers). */
+#define SR_SHM_FRAME_HDR_SIZE 8     /**< Size of the header of a message in a ring. */
+#define SR_SHM_WRAP_MARK UINT32_MAX /**< Message size denoting that the next message starts at the beginning of the ring. */
+
+/** Size of a message in a ring including its header and padding. */
+#define SR_SHM_FRAME_SIZE(MSG_SIZE) (((MSG_SIZE) + SR_SHM_FRAME_HDR_SIZE + 7) & ~((size_t)7))
+
+/**
+ * @brief Indexes of one ring, placed in the shared memory. Indexes grow monotonically,
+ * position in the ring is given by the index modulo the size of the ring.
+ */
+typedef struct sr_shm_ring_hdr_s {
+    uint64_t head;                                          /**< Index of the first unconsumed byte, written by the consumer. */
+    uint8_t head_pad[SR_SHM_CACHE_LINE - sizeof(uint64_t)];
+    uint64_t tail;                                          /**< Index after the last published byte, written by the producer. */
+    uint8_t tail_pad[SR_SHM_CACHE_LINE - sizeof(uint64_t)];
+} sr_shm_ring_hdr_t;
+
+/**
+ * @brief Header of the shared-memory segment, followed by the data of the two rings.
+ */
+typedef struct sr_shm_segment_hdr_s {
+    uint32_t magic;                                         /**< SR_SHM_MAGIC */
+    uint32_t version;                                       /**< SR_SHM_VERSION */
+    uint64_t ring_size;                                     /**< Size of the data of each ring. */
+    uint8_t pad[SR_SHM_CACHE_LINE - 2 * sizeof(uint32_t) - sizeof(uint64_t)];
+    sr_shm_ring_hdr_t rings[2];                             /**< Ring 0 is written by the creator, ring 1 by the attached side. */
+} sr_shm_segment_hdr_t;
+
+/**
+ * @brief Process-local view of one ring. The index owned by this side is kept locally
+ * and only published into the shared memory, so that the peer cannot corrupt it.
+ */
+typedef struct sr_shm_ring_s {
+    sr_shm_ring_hdr_t *hdr;  /**< Indexes of the ring in the shared memory. */
+    uint8_t *data;           /**< Data of the ring in the shared memory. */
+    uint64_t pos;            /**< Own index - tail of the sending ring, head of the receiving ring. */
+    uint64_t next_pos;       /**< Own index after the reserved / peeked message is committed / consumed. */
+} sr_shm_ring_t;
+
+/**
+ * @brief Shared-memory channel context.
+ */
+struct sr_shm_channel_s {
+    void *segment;           /**< Mapped shared-memory segment. */
+    size_t segment_size;     /**< Size of the mapped segment. */
+    size_t ring_size;        /**< Size of the data of each ring. */
+    sr_shm_ring_t tx;        /**< Ring used for sending. */
+    sr_shm_ring_t rx;        /**< Ring used for receiving. */
+};
+
+/**
+ * @brief Maps the segment and sets up the rings of the channel.
+ */
+static int
+sr_shm_channel_map(int fd, size_t segment_size, bool creator, sr_shm_channel_t **channel_p)
+{
+    sr_shm_channel_t *channel = NULL;
+    sr_shm_segment_hdr_t *hdr = NULL;
+    uint8_t *data = NULL;
+
+    channel = calloc(1, sizeof(*channel));
+    CHECK_NULL_NOMEM_RETURN(channel);
+
+    channel->segment = mmap(NULL, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == channel->segment) {
+        SR_LOG_ERR("Unable to map the shared-memory segment: %s.", sr_strerror_safe(errno));
+        free(channel);
+        return SR_ERR_INTERNAL;
+    }
+    channel->segment_size = segment_size;
+
+    hdr = (sr_shm_segment_hdr_t *) channel->segment;
+    if (creator) {
+        hdr->magic = SR_SHM_MAGIC;
+        hdr->version = SR_SHM_VERSION;
+        hdr->ring_size = segment_size - sizeof(*hdr);
+        hdr->ring_size /= 2;
+    } else if (SR_SHM_MAGIC != hdr->magic || SR_SHM_VERSION != hdr->version ||
+            0 != hdr->ring_size % 8 || hdr->ring_size < SR_SHM_CACHE_LINE ||
+            hdr->ring_size > (segment_size - sizeof(*hdr)) / 2) {
+        SR_LOG_ERR_MSG("Invalid layout of the shared-memory segment.");
+        munmap(channel->segment, segment_size);
+        free(channel);
+        return SR_ERR_MALFORMED_MSG;
+    }
+    channel->ring_size = hdr->ring_size;
+
+    data = (uint8_t *) channel->segment + sizeof(*hdr);
+    channel->tx.hdr = &hdr->rings[creator ? 0 : 1];
+    channel->tx.data = data + (creator ? 0 : channel->ring_size);
+    channel->rx.hdr = &hdr->rings[creator ? 1 : 0];
+    channel->rx.data = data + (creator ? channel->ring_size : 0);
+
+    /* continue from the indexes published in the segment */
+    channel->tx.pos = channel->tx.next_pos = __atomic_load_n(&channel->tx.hdr->tail, __ATOMIC_ACQUIRE);
+    channel->rx.pos = channel->rx.next_pos = __atomic_load_n(&channel->rx.hdr->head, __ATOMIC_ACQUIRE);
+
+    *channel_p = channel;
+    return SR_ERR_OK;
+}
+
+int
+sr_shm_channel_create(size_t ring_size, int *fd_p, sr_shm_channel_t **channel_p)
+{
+#ifdef HAVE_MEMFD_CREATE
+    size_t segment_size = 0;
+    int fd = -1, rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(fd_p, channel_p);
+
+    ring_size = (ring_size + 7) & ~((size_t)7);
+    if (ring_size < SR_SHM_CACHE_LINE) {
+        ring_size = SR_SHM_CACHE_LINE;
+    }
+    segment_size = sizeof(sr_shm_segment_hdr_t) + 2 * ring_size;
+
+    fd = syscall(SYS_memfd_create, "sysrepo-shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (-1 == fd) {
+        SR_LOG_ERR("Unable to create a shared-memory segment: %s.", sr_strerror_safe(errno));
+        return SR_ERR_INTERNAL;
+    }
+    if (-1 == ftruncate(fd, segment_size)) {
+        SR_LOG_ERR("Unable to set the size of the shared-memory segment: %s.", sr_strerror_safe(errno));
+        rc = SR_ERR_INTERNAL;
+        goto cleanup;
+    }
+    /* the peer must not be able to shrink the segment under our mapping */
+    if (-1 == fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL)) {
+        SR_LOG_ERR("Unable to seal the shared-memory segment: %s.", sr_strerror_safe(errno));
+        rc = SR_ERR_INTERNAL;
+        goto cleanup;
+    }
+
+    rc = sr_shm_channel_map(fd, segment_size, true, channel_p);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to map the shared-memory channel.");
+
+    SR_LOG_DBG("Shared-memory channel with rings of %zu bytes created.", ring_size);
+
+    *fd_p = fd;
+    return SR_ERR_OK;
+
+cleanup:
+    close(fd);
+    return rc;
+#else
+    (void)ring_size;
+    (void)fd_p;
+    (void)channel_p;
+    SR_LOG_WRN_MSG("Shared-memory channels are not supported on this platform.");
+    return SR_ERR_UNSUPPORTED;
+#endif
+}
+
+int
+sr_shm_channel_attach(int fd, sr_shm_channel_t **channel_p)
+{
+    struct stat st = { 0, };
+
+    CHECK_NULL_ARG(channel_p);
+
+    if (-1 == fstat(fd, &st)) {
+        SR_LOG_ERR("Unable to stat the shared-memory segment: %s.", sr_strerror_safe(errno));
+        return SR_ERR_INTERNAL;
+    }
+    if (st.st_size < (off_t)(sizeof(sr_shm_segment_hdr_t) + 2 * SR_SHM_CACHE_LINE)) {
+        SR_LOG_ERR("Shared-memory segment too small (%lld bytes).", (long long)st.st_size);
+        return SR_ERR_MALFORMED_MSG;
+    }
+
+    return sr_shm_channel_map(fd, st.st_size, false, channel_p);
+}
+
+void
+sr_shm_channel_cleanup(sr_shm_channel_t *channel)
+{
+    if (NULL != channel) {
+        munmap(channel->segment, channel->segment_size);
+        free(channel);
+    }
+}
+
+bool
+sr_shm_channel_reserve(sr_shm_channel_t *channel, size_t size, uint8_t **data)
+{
+    sr_shm_ring_t *ring = NULL;
+    uint64_t head = 0, used = 0;
+    size_t frame_size = 0, offset = 0, skip = 0;
+
+    if (NULL == channel || NULL == data || size >= SR_SHM_WRAP_MARK) {
+        return false;
+    }
+    ring = &channel->tx;
+
+    frame_size = SR_SHM_FRAME_SIZE(size);
+    if (frame_size > channel->ring_size) {
+        return false;
+    }
+
+    head = __atomic_load_n(&ring->hdr->head, __ATOMIC_ACQUIRE);
+    used = ring->pos - head;
+    if (used > channel->ring_size) {
+        /* the head has been corrupted by the peer, do not use the ring anymore */
+        return false;
+    }
+
+    /* messages are contiguous, skip the end of the ring if the message does not fit there */
+    offset = ring->pos % channel->ring_size;
+    if (channel->ring_size - offset < frame_size) {
+        skip = channel->ring_size - offset;
+    }
+    if (channel->ring_size - used < skip + frame_size) {
+        return false;
+    }
+
+    if (skip > 0) {
+        *(uint32_t *)(ring->data + offset) = SR_SHM_WRAP_MARK;
+        offset = 0;
+    }
+    *(uint32_t *)(ring->data + offset) = (uint32_t)size;
+
+    ring->next_pos = ring->pos + skip + frame_size;
+    *data = ring->data + offset + SR_SHM_FRAME_HDR_SIZE;
+
+    return true;
+}
+
+void
+sr_shm_channel_commit(sr_shm_channel_t *channel)
+{
+    if (NULL != channel) {
+        channel->tx.pos = channel->tx.next_pos;
+        __atomic_store_n(&channel->tx.hdr->tail, channel->tx.pos, __ATOMIC_RELEASE);
+    }
+}
+
+int
+sr_shm_channel_peek(sr_shm_channel_t *channel, const uint8_t **data, size_t *size)
+{
+    sr_shm_ring_t *ring = NULL;
+    uint64_t tail = 0, avail = 0;
+    size_t offset = 0, skip = 0;
+    uint32_t msg_size = 0;
+
+    CHECK_NULL_ARG3(channel, data, size);
+    ring = &channel->rx;
+
+    tail = __atomic_load_n(&ring->hdr->tail, __ATOMIC_ACQUIRE);
+    avail = tail - ring->pos;
+    if (0 == avail) {
+        return SR_ERR_NOT_FOUND;
+    }
+    if (avail > channel->ring_size) {
+        SR_LOG_ERR_MSG("Invalid tail index of the shared-memory ring.");
+        return SR_ERR_MALFORMED_MSG;
+    }
+
+    offset = ring->pos % channel->ring_size;
+    msg_size = __atomic_load_n((uint32_t *)(ring->data + offset), __ATOMIC_RELAXED);
+    if (SR_SHM_WRAP_MARK == msg_size) {
+        skip = channel->ring_size - offset;
+        if (avail <= skip) {
+            SR_LOG_ERR_MSG("Shared-memory ring wrapped without a message.");
+            return SR_ERR_MALFORMED_MSG;
+        }
+        offset = 0;
+        msg_size = __atomic_load_n((uint32_t *)ring->data, __ATOMIC_RELAXED);
+    }
+    if (0 == msg_size || (channel->ring_size - offset) < SR_SHM_FRAME_SIZE((size_t)msg_size) ||
+            (avail - skip) < SR_SHM_FRAME_SIZE((size_t)msg_size)) {
+        SR_LOG_ERR("Invalid size of a message in the shared-memory ring (%"PRIu32").", msg_size);
+        return SR_ERR_MALFORMED_MSG;
+    }
+
+    ring->next_pos = ring->pos + skip + SR_SHM_FRAME_SIZE((size_t)msg_size);
+    *data = ring->data + offset + SR_SHM_FRAME_HDR_SIZE;
+    *size = msg_size;
+
+    return SR_ERR_OK;
+}
+
+void
+sr_shm_channel_consume(sr_shm_channel_t *channel)
+{
+    if (NULL != channel) {
+        channel->rx.pos = channel->rx.next_pos;
+        __atomic_store_n(&channel->rx.hdr->head, channel->rx.pos, __ATOMIC_RELEASE);
+    }
+}
@@ -0,0 +1,122 @@
+/**
+ * @file sr_shm_channel.h
+ * @author agent <agent@local>
+ * @brief Shared-memory channel API.
+ *
+ * @copyright
+ * Copyright 2026 agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SR_SHM_CHANNEL_H_
+#define SR_SHM_CHANNEL_H_
+
+/**
+ * @defgroup shm_channel Shared-memory Channel
+ * @ingroup common
+ * @{
+ *
+ * @brief Pair of single-producer single-consumer rings of messages in a memory segment
+ * shared between the Client Library and Sysrepo Engine. Messages are written into and read
+ * from the rings in place, the unix-domain socket of the connection is used only to notify
+ * the peer about new messages (see @ref SR_MSG_CTRL_SHM_DOORBELL).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+/**
+ * @brief Shared-memory channel context - a pair of single-producer single-consumer
+ * byte rings in a memory segment shared between two processes (one ring for each direction).
+ */
+typedef struct sr_shm_channel_s sr_shm_channel_t;
+
+/**
+ * @brief Creates a new shared-memory channel. The segment is sealed against resizing,
+ * so that the peer cannot make the mapping of the creator invalid.
+ *
+ * @param[in] ring_size Size of each of the two rings (in bytes, rounded up to a multiple of 8).
+ * @param[out] fd File descriptor of the shared-memory segment, to be passed to the peer
+ * (see ::sr_shm_channel_attach) and closed by the caller.
+ * @param[out] channel Shared-memory channel context.
+ *
+ * @return Error code (SR_ERR_OK on success), SR_ERR_UNSUPPORTED if shared-memory
+ * segments are not supported on this platform.
+ */
+int sr_shm_channel_create(size_t ring_size, int *fd, sr_shm_channel_t **channel);
+
+/**
+ * @brief Attaches to the shared-memory channel created by the peer. The ring used for sending
+ * by the creator is used for receiving by the attached side and vice versa.
+ *
+ * @param[in] fd File descriptor of the shared-memory segment (can be closed after the call).
+ * @param[out] channel Shared-memory channel context.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_shm_channel_attach(int fd, sr_shm_channel_t **channel);
+
+/**
+ * @brief Unmaps the shared-memory channel and frees the context.
+ *
+ * @param[in] channel Shared-memory channel context.
+ */
+void sr_shm_channel_cleanup(sr_shm_channel_t *channel);
+
+/**
+ * @brief Reserves a contiguous space for a message in the sending ring.
+ * The message becomes visible to the peer after ::sr_shm_channel_commit.
+ *
+ * @note Only one thread at a time can send messages over a channel.
+ *
+ * @param[in] channel Shared-memory channel context.
+ * @param[in] size Size of the message.
+ * @param[out] data Space where the message should be written to.
+ *
+ * @return TRUE if the space has been reserved, FALSE if the ring does not have enough free space.
+ */
+bool sr_shm_channel_reserve(sr_shm_channel_t *channel, size_t size, uint8_t **data);
+
+/**
+ * @brief Publishes the message written into the space obtained by ::sr_shm_channel_reserve.
+ *
+ * @param[in] channel Shared-memory channel context.
+ */
+void sr_shm_channel_commit(sr_shm_channel_t *channel);
+
+/**
+ * @brief Returns the oldest message in the receiving ring without removing it.
+ * The message stays valid until ::sr_shm_channel_consume is called.
+ *
+ * @note Only one thread at a time can receive messages from a channel.
+ *
+ * @param[in] channel Shared-memory channel context.
+ * @param[out] data Pointer to the message.
+ * @param[out] size Size of the message.
+ *
+ * @return Error code (SR_ERR_OK on success), SR_ERR_NOT_FOUND if the ring is empty,
+ * SR_ERR_MALFORMED_MSG if the content of the ring is not consistent.
+ */
+int sr_shm_channel_peek(sr_shm_channel_t *channel, const uint8_t **data, size_t *size);
+
+/**
+ * @brief Removes the message returned by ::sr_shm_channel_peek from the receiving ring.
+ *
+ * @param[in] channel Shared-memory channel context.
+ */
+void sr_shm_channel_consume(sr_shm_channel_t *channel);
+
+/**@} shm_channel */
+
+#endif /* SR_SHM_CHANNEL_H_ */
@@ -22,6 +22,8 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <inttypes.h>
@@ -598,6 +600,469 @@ cleanup:
     return rc;
 }
 
+/** Magic number at the beginning of a data file in the sysrepo binary format. */
+#define SR_BIN_MAGIC "SRB1"
+/** Length of the magic number. */
+#define SR_BIN_MAGIC_LEN 4
+
+/** Record kinds of the sysrepo binary format. */
+#define SR_BIN_END   0   /**< end of the list of siblings */
+#define SR_BIN_INNER 1   /**< container or list, followed by children records */
+#define SR_BIN_LEAF  2   /**< leaf or leaf-list, followed by the value */
+
+/**
+ * @brief Growing buffer used to serialize a data tree into the binary format.
+ */
+typedef struct sr_bin_writer_s {
+    char *data;             /**< serialized data nodes */
+    size_t size;            /**< allocated size of data */
+    size_t used;            /**< used size of data */
+    sr_list_t *modules;     /**< modules referenced by the data nodes, record refer to them by index */
+} sr_bin_writer_t;
+
+/**
+ * @brief Mapped binary data file that is being parsed.
+ */
+typedef struct sr_bin_reader_s {
+    const char *data;                   /**< mapped content of the file */
+    size_t size;                        /**< size of the file */
+    size_t pos;                         /**< current read position */
+    const struct lys_module **modules;  /**< module table of the file */
+    uint32_t module_cnt;                /**< number of modules in the module table */
+    char *str;                          /**< buffer for null-terminated strings */
+    size_t str_size;                    /**< allocated size of str */
+} sr_bin_reader_t;
+
+static int
+sr_bin_write(sr_bin_writer_t *writer, const void *data, size_t len)
+{
+    char *tmp = NULL;
+    size_t new_size = 0;
+
+    if (writer->used + len > writer->size) {
+        new_size = writer->size ? writer->size : 4096;
+        while (writer->used + len > new_size) {
+            new_size *= 2;
+        }
+        tmp = realloc(writer->data, new_size);
+        CHECK_NULL_NOMEM_RETURN(tmp);
+        writer->data = tmp;
+        writer->size = new_size;
+    }
+    memcpy(writer->data + writer->used, data, len);
+    writer->used += len;
+    return SR_ERR_OK;
+}
+
+static int
+sr_bin_write_str(sr_bin_writer_t *writer, const char *str, bool long_str)
+{
+    int rc = SR_ERR_OK;
+    size_t len = (NULL != str) ? strlen(str) : 0;
+
+    if (long_str) {
+        uint32_t len32 = len;
+        rc = sr_bin_write(writer, &len32, sizeof(len32));
+    } else {
+        if (len > UINT16_MAX) {
+            return SR_ERR_UNSUPPORTED;
+        }
+        uint16_t len16 = len;
+        rc = sr_bin_write(writer, &len16, sizeof(len16));
+    }
+    if (SR_ERR_OK == rc && len > 0) {
+        rc = sr_bin_write(writer, str, len);
+    }
+    return rc;
+}
+
+/**
+ * @brief Serializes data node siblings (and their descendants) in preorder.
+ */
+static int
+sr_bin_write_siblings(sr_bin_writer_t *writer, const struct lyd_node *node)
+{
+    int rc = SR_ERR_OK;
+    uint8_t kind = 0;
+    uint16_t module_idx = 0;
+    const struct lys_module *module = NULL;
+    size_t i = 0;
+
+    for (; NULL != node; node = node->next) {
+        if (node->dflt) {
+            /* default nodes are recreated by validation */
+            continue;
+        }
+        switch (node->schema->nodetype) {
+            case LYS_CONTAINER:
+            case LYS_LIST:
+                kind = SR_BIN_INNER;
+                break;
+            case LYS_LEAF:
+            case LYS_LEAFLIST:
+                kind = SR_BIN_LEAF;
+                break;
+            default:
+                SR_LOG_DBG("Node %s can not be represented in the binary format", node->schema->name);
+                return SR_ERR_UNSUPPORTED;
+        }
+
+        module = lys_node_module(node->schema);
+        for (i = 0; i < writer->modules->count; i++) {
+            if (module == writer->modules->data[i]) {
+                break;
+            }
+        }
+        if (i == writer->modules->count) {
+            rc = sr_list_add(writer->modules, (void *) module);
+            CHECK_RC_MSG_RETURN(rc, "List add failed");
+        }
+        module_idx = i;
+
+        rc = sr_bin_write(writer, &kind, sizeof(kind));
+        if (SR_ERR_OK == rc) {
+            rc = sr_bin_write(writer, &module_idx, sizeof(module_idx));
+        }
+        if (SR_ERR_OK == rc) {
+            rc = sr_bin_write_str(writer, node->schema->name, false);
+        }
+        if (SR_ERR_OK == rc) {
+            if (SR_BIN_LEAF == kind) {
+                rc = sr_bin_write_str(writer, ((struct lyd_node_leaf_list *) node)->value_str, true);
+            } else {
+                rc = sr_bin_write_siblings(writer, node->child);
+            }
+        }
+        if (SR_ERR_OK != rc) {
+            return rc;
+        }
+    }
+
+    kind = SR_BIN_END;
+    return sr_bin_write(writer, &kind, sizeof(kind));
+}
+
+int
+sr_lyd_print_binary_fd(int fd, const struct lyd_node *root)
+{
+    int rc = SR_ERR_OK;
+    sr_bin_writer_t writer = {0};
+    sr_bin_writer_t header = {0};
+    uint32_t module_cnt = 0;
+    const struct lys_module *module = NULL;
+    const char *data = NULL;
+    size_t len = 0;
+    ssize_t ret = 0;
+
+    rc = sr_list_init(&writer.modules);
+    CHECK_RC_MSG_RETURN(rc, "List init failed");
+
+    rc = sr_bin_write_siblings(&writer, root);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to serialize the data tree");
+
+    /* header: magic and module table */
+    rc = sr_bin_write(&header, SR_BIN_MAGIC, SR_BIN_MAGIC_LEN);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to serialize the data tree");
+    module_cnt = writer.modules->count;
+    rc = sr_bin_write(&header, &module_cnt, sizeof(module_cnt));
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to serialize the data tree");
+    for (size_t i = 0; i < writer.modules->count; i++) {
+        module = writer.modules->data[i];
+        rc = sr_bin_write_str(&header, module->name, false);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to serialize the data tree");
+    }
+
+    for (int i = 0; i < 2; i++) {
+        data = (0 == i) ? header.data : writer.data;
+        len = (0 == i) ? header.used : writer.used;
+        while (len > 0) {
+            ret = write(fd, data, len);
+            if (-1 == ret) {
+                if (EINTR == errno) {
+                    continue;
+                }
+                SR_LOG_ERR("Failed to write binary data: %s", sr_strerror_safe(errno));
+                rc = SR_ERR_IO;
+                goto cleanup;
+            }
+            data += ret;
+            len -= ret;
+        }
+    }
+
+cleanup:
+    free(writer.data);
+    free(header.data);
+    sr_list_cleanup(writer.modules);
+    return rc;
+}
+
+static int
+sr_bin_read(sr_bin_reader_t *reader, void *dst, size_t len)
+{
+    if (reader->pos + len > reader->size) {
+        SR_LOG_ERR_MSG("Unexpected end of binary data");
+        return SR_ERR_MALFORMED_MSG;
+    }
+    memcpy(dst, reader->data + reader->pos, len);
+    reader->pos += len;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Reads a string, returned pointer refers to the reader's buffer and is valid until the next call.
+ */
+static int
+sr_bin_read_str(sr_bin_reader_t *reader, bool long_str, const char **str)
+{
+    int rc = SR_ERR_OK;
+    uint32_t len = 0;
+    uint16_t len16 = 0;
+    char *tmp = NULL;
+
+    if (long_str) {
+        rc = sr_bin_read(reader, &len, sizeof(len));
+    } else {
+        rc = sr_bin_read(reader, &len16, sizeof(len16));
+        len = len16;
+    }
+    CHECK_RC_MSG_RETURN(rc, "Failed to read string length");
+
+    if (len + 1 > reader->str_size) {
+        tmp = realloc(reader->str, len + 1);
+        CHECK_NULL_NOMEM_RETURN(tmp);
+        reader->str = tmp;
+        reader->str_size = len + 1;
+    }
+    rc = sr_bin_read(reader, reader->str, len);
+    CHECK_RC_MSG_RETURN(rc, "Failed to read string");
+    reader->str[len] = '\0';
+
+    *str = reader->str;
+    return rc;
+}
+
+/**
+ * @brief Rebuilds data node siblings (and their descendants) from the binary records.
+ */
+static int
+sr_bin_read_siblings(sr_bin_reader_t *reader, struct lyd_node *parent, struct lyd_node **first)
+{
+    int rc = SR_ERR_OK;
+    uint8_t kind = 0;
+    uint16_t module_idx = 0;
+    const struct lys_module *module = NULL;
+    const char *str = NULL;
+    char *name = NULL;
+    struct lyd_node *node = NULL, *last = NULL;
+
+    while (SR_ERR_OK == (rc = sr_bin_read(reader, &kind, sizeof(kind))) && SR_BIN_END != kind) {
+        rc = sr_bin_read(reader, &module_idx, sizeof(module_idx));
+        CHECK_RC_MSG_RETURN(rc, "Failed to read module index");
+        if (module_idx >= reader->module_cnt) {
+            SR_LOG_ERR("Invalid module index %u in binary data", module_idx);
+            return SR_ERR_MALFORMED_MSG;
+        }
+        module = reader->modules[module_idx];
+
+        rc = sr_bin_read_str(reader, false, &str);
+        CHECK_RC_MSG_RETURN(rc, "Failed to read node name");
+        name = strdup(str);
+        CHECK_NULL_NOMEM_RETURN(name);
+
+        if (SR_BIN_INNER == kind) {
+            node = lyd_new(parent, module, name);
+        } else if (SR_BIN_LEAF == kind) {
+            rc = sr_bin_read_str(reader, true, &str);
+            if (SR_ERR_OK != rc) {
+                free(name);
+                return rc;
+            }
+            node = lyd_new_leaf(parent, module, name, str);
+        } else {
+            SR_LOG_ERR("Invalid record kind %u in binary data", kind);
+            free(name);
+            return SR_ERR_MALFORMED_MSG;
+        }
+        if (NULL == node) {
+            SR_LOG_ERR("Failed to create node %s:%s: %s", module->name, name, ly_errmsg());
+            free(name);
+            return SR_ERR_INTERNAL;
+        }
+        free(name);
+        name = NULL;
+
+        if (NULL == parent) {
+            /* link top-level siblings */
+            if (NULL == last) {
+                *first = node;
+            } else if (0 != lyd_insert_after(last, node)) {
+                SR_LOG_ERR("Failed to insert top-level node: %s", ly_errmsg());
+                lyd_free(node);
+                return SR_ERR_INTERNAL;
+            }
+            last = node;
+        }
+
+        if (SR_BIN_INNER == kind) {
+            rc = sr_bin_read_siblings(reader, node, NULL);
+            CHECK_RC_MSG_RETURN(rc, "Failed to read children");
+        }
+    }
+
+    return rc;
+}
+
+int
+sr_lyd_parse_binary_mem(struct ly_ctx *ly_ctx, const char *data, size_t size, struct lyd_node **root)
+{
+    CHECK_NULL_ARG3(ly_ctx, data, root);
+    int rc = SR_ERR_OK;
+    sr_bin_reader_t reader = {0};
+    char magic[SR_BIN_MAGIC_LEN] = {0};
+    const char *str = NULL;
+    struct lyd_node *data_tree = NULL;
+    ly_module_clb module_clb = NULL;
+    void *module_clb_data = NULL;
+
+    *root = NULL;
+    reader.data = data;
+    reader.size = size;
+
+    rc = sr_bin_read(&reader, magic, SR_BIN_MAGIC_LEN);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to read the binary data header");
+    if (0 != memcmp(magic, SR_BIN_MAGIC, SR_BIN_MAGIC_LEN)) {
+        SR_LOG_ERR_MSG("Data file is not in the sysrepo binary format");
+        rc = SR_ERR_MALFORMED_MSG;
+        goto cleanup;
+    }
+
+    /* resolve the module table */
+    module_clb = ly_ctx_get_module_data_clb(ly_ctx, &module_clb_data);
+
+    rc = sr_bin_read(&reader, &reader.module_cnt, sizeof(reader.module_cnt));
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to read the binary data header");
+    if (reader.module_cnt > reader.size) {
+        SR_LOG_ERR_MSG("Invalid module count in binary data");
+        rc = SR_ERR_MALFORMED_MSG;
+        goto cleanup;
+    }
+    if (reader.module_cnt > 0) {
+        reader.modules = calloc(reader.module_cnt, sizeof(*reader.modules));
+        CHECK_NULL_NOMEM_GOTO(reader.modules, rc, cleanup);
+    }
+    for (uint32_t i = 0; i < reader.module_cnt; i++) {
+        rc = sr_bin_read_str(&reader, false, &str);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to read the module table");
+        reader.modules[i] = ly_ctx_get_module(ly_ctx, str, NULL);
+        if (NULL == reader.modules[i] && NULL != module_clb) {
+            /* let the context load the missing module the same way as the XML parser would */
+            reader.modules[i] = module_clb(ly_ctx, str, NULL, 0, module_clb_data);
+        }
+        if (NULL == reader.modules[i]) {
+            SR_LOG_ERR("Module %s referenced by binary data not found", str);
+            rc = SR_ERR_UNKNOWN_MODEL;
+            goto cleanup;
+        }
+    }
+
+    rc = sr_bin_read_siblings(&reader, NULL, &data_tree);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to parse binary data");
+
+cleanup:
+    free(reader.modules);
+    free(reader.str);
+    if (SR_ERR_OK == rc) {
+        *root = data_tree;
+    } else {
+        lyd_free_withsiblings(data_tree);
+    }
+    return rc;
+}
+
+int
+sr_lyd_parse_binary_fd(struct ly_ctx *ly_ctx, int fd, struct lyd_node **root)
+{
+    CHECK_NULL_ARG2(ly_ctx, root);
+    int rc = SR_ERR_OK;
+    struct stat st = {0};
+    void *addr = MAP_FAILED;
+
+    *root = NULL;
+
+    if (-1 == fstat(fd, &st)) {
+        SR_LOG_ERR("Stat of the binary data file failed: %s", sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
+    if (0 == st.st_size) {
+        return SR_ERR_OK;
+    }
+
+    addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == addr) {
+        SR_LOG_ERR("Mapping of the binary data file failed: %s", sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
+
+    rc = sr_lyd_parse_binary_mem(ly_ctx, addr, st.st_size, root);
+
+    munmap(addr, st.st_size);
+    return rc;
+}
+
+int
+sr_lyd_parse_data_fd(struct ly_ctx *ly_ctx, int fd, int options, struct lyd_node **root)
+{
+    CHECK_NULL_ARG2(ly_ctx, root);
+    int rc = SR_ERR_OK;
+    char magic[SR_BIN_MAGIC_LEN] = {0};
+
+    if (SR_BIN_MAGIC_LEN == pread(fd, magic, SR_BIN_MAGIC_LEN, 0) && 0 == memcmp(magic, SR_BIN_MAGIC, SR_BIN_MAGIC_LEN)) {
+        rc = sr_lyd_parse_binary_fd(ly_ctx, fd, root);
+        CHECK_RC_MSG_RETURN(rc, "Parsing of binary data failed");
+        /* default nodes are not stored in the binary file, let them be created (and the tree validated)
+         * with the same options the XML parser would use, so that both formats yield the same tree */
+        ly_errno = LY_SUCCESS;
+        if (NULL != *root && 0 != lyd_validate(root, options, ly_ctx)) {
+            SR_LOG_ERR("Validation of binary data failed: %s", ly_errmsg());
+            lyd_free_withsiblings(*root);
+            *root = NULL;
+            return SR_ERR_INTERNAL;
+        }
+        return SR_ERR_OK;
+    }
+
+    ly_errno = LY_SUCCESS;
+    *root = lyd_parse_fd(ly_ctx, fd, LYD_XML, options);
+    if (NULL == *root && LY_SUCCESS != ly_errno) {
+        SR_LOG_ERR("Parsing of XML data failed: %s", ly_errmsg());
+        return SR_ERR_INTERNAL;
+    }
+    return SR_ERR_OK;
+}
+
+int
+sr_lyd_print_data_fd(int fd, const struct lyd_node *root, bool binary)
+{
+    int rc = SR_ERR_OK;
+
+    if (binary) {
+        rc = sr_lyd_print_binary_fd(fd, root);
+        if (SR_ERR_UNSUPPORTED != rc) {
+            return rc;
+        }
+        /* nothing has been written yet, fall back to XML */
+        SR_LOG_DBG_MSG("Data tree can not be printed in the binary format, XML will be used");
+    }
+
+    ly_errno = LY_SUCCESS;
+    if (0 != lyd_print_fd(fd, root, LYD_XML, LYP_WITHSIBLINGS | LYP_FORMAT)) {
+        SR_LOG_ERR("Printing of XML data failed: %s", (LY_SUCCESS != ly_errno) ? ly_errmsg() : sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+    }
+    return rc;
+}
+
 int
 sr_ly_set_contains(const struct ly_set *set, void *node, bool sorted)
 {
@@ -718,6 +1183,11 @@ struct lyd_node*
 sr_dup_datatree_to_ctx(struct lyd_node *root, struct ly_ctx *ctx) {
     struct lyd_node *dup = NULL;
 
+    if (NULL != root && root->schema->module->ctx == ctx) {
+        /* no need to resolve the schema nodes in the destination context */
+        return sr_dup_datatree(root);
+    }
+
     while (NULL != root) {
         /* dup the first one, rest should be done by one merge */
         if (NULL == dup){
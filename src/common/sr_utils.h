@@ -346,6 +346,70 @@ int sr_get_peer_eid(int fd, uid_t *uid, gid_t *gid);
  */
 int sr_save_data_tree_file(const char *file_name, const struct lyd_node *data_tree);
 
+/**
+ * @brief Prints the data tree (including its siblings) into the file in the sysrepo binary format.
+ * The format is a compact preorder serialization of data nodes (host byte order) that can be loaded
+ * without tokenizing text. Nodes with default values are not printed.
+ *
+ * @param [in] fd File descriptor to write into.
+ * @param [in] root Data tree to be printed, can be NULL.
+ *
+ * @return Error code (SR_ERR_OK on success), SR_ERR_UNSUPPORTED if the data tree contains a node
+ * that can not be represented in the binary format (e.g. anydata), nothing is written in that case.
+ */
+int sr_lyd_print_binary_fd(int fd, const struct lyd_node *root);
+
+/**
+ * @brief Loads the data tree from the file in the sysrepo binary format. The file is mapped into
+ * the memory and data nodes are rebuilt directly from the mapped content. Loaded data are not validated.
+ *
+ * @param [in] ly_ctx Libyang context with the modules of the data.
+ * @param [in] fd File descriptor to read from.
+ * @param [out] root Loaded data tree, NULL if the file contains no data.
+ *
+ * @return Error code (SR_ERR_OK on success)
+ */
+int sr_lyd_parse_binary_fd(struct ly_ctx *ly_ctx, int fd, struct lyd_node **root);
+
+/**
+ * @brief Loads the data tree from a memory buffer with the content in the sysrepo binary format
+ * (e.g. a part of a mapped file). Loaded data are not validated.
+ *
+ * @param [in] ly_ctx Libyang context with the modules of the data.
+ * @param [in] data Content in the sysrepo binary format, starting with the magic number.
+ * @param [in] size Size of the content.
+ * @param [out] root Loaded data tree, NULL if the content contains no data.
+ *
+ * @return Error code (SR_ERR_OK on success)
+ */
+int sr_lyd_parse_binary_mem(struct ly_ctx *ly_ctx, const char *data, size_t size, struct lyd_node **root);
+
+/**
+ * @brief Loads the data tree from the data file in either XML or sysrepo binary format,
+ * the format is detected from the content of the file.
+ *
+ * @param [in] ly_ctx Libyang context with the modules of the data.
+ * @param [in] fd File descriptor to read from.
+ * @param [in] options Libyang parser options. For binary data they are used to validate the loaded tree
+ * and to create its default nodes, so that the result is the same as for XML data.
+ * @param [out] root Loaded data tree, NULL if the file contains no data.
+ *
+ * @return Error code (SR_ERR_OK on success)
+ */
+int sr_lyd_parse_data_fd(struct ly_ctx *ly_ctx, int fd, int options, struct lyd_node **root);
+
+/**
+ * @brief Prints the data tree (including its siblings) into the data file.
+ *
+ * @param [in] fd File descriptor to write into.
+ * @param [in] root Data tree to be printed, can be NULL.
+ * @param [in] binary If set to true, the sysrepo binary format is used if the data tree can be represented in it,
+ * formatted XML is used otherwise.
+ *
+ * @return Error code (SR_ERR_OK on success)
+ */
+int sr_lyd_print_data_fd(int fd, const struct lyd_node *root, bool binary);
+
 /**
  * @brief Check if the set contains the specified object.
  * @param[in] set Set to explore.
@@ -392,6 +456,9 @@ struct lyd_node* sr_dup_datatree(struct lyd_node *root);
  * not loaded in destination context (unresolved instance ids do not cause problem).
  * consider calling ::dm_remove_added_data_trees_by_module_name or ::dm_remove_added_data_trees
  *
+ * @note If the data tree already belongs to the destination context, it is duplicated
+ * as by ::sr_dup_datatree.
+ *
  * @param [in] root Data tree to be duplicated
  * @param [in] ctx Destination context where the data tree should be duplicated to
  * @return duplicated data tree using the provided context
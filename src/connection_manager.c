@@ -43,13 +43,57 @@
 #define CM_BUFF_ALLOC_CHUNK 1024  /**< Chunk size for buffer expansions. */
 
 #define CM_INIT_MSG_QUEUE_SIZE 10      /**< Initial size of the message queue. */
+#define CM_INIT_CONN_QUEUE_SIZE 10     /**< Initial size of the queue of connections handed over to an I/O loop. */
 #define CM_INIT_SESS_REQ_QUEUE_SIZE 2  /**< Initial size of the request queue buffer. */
 
+#define CM_IO_LOOP_COUNT_DAEMON 4  /**< Default number of I/O loops (threads) in daemon mode. */
+#define CM_IO_LOOP_COUNT_LOCAL 1   /**< Default number of I/O loops (threads) in local (library) mode. */
+#define CM_IO_LOOP_COUNT_MAX 64    /**< Maximum number of I/O loops (threads). */
+
 #define CM_MAX_SIGNAL_WATCHERS 2  /**< Maximum number of signals that Connection Manager can watch for. */
 
 #define CM_SUBSCRIBER_DISCONNECT_TIMEOUT 1  /**< Timeout (in seconds) to wait after disconnection of a subscriber
                                                  before removing of the subscription. */
 
+/**
+ * @brief Context of an I/O loop of Connection Manager.
+ *
+ * Each connection is served by exactly one I/O loop, sessions are served by the
+ * I/O loop of their connection (the loop index is encoded in the session ID).
+ * All processing of a connection and its sessions happens in the thread of its
+ * I/O loop, other threads communicate with the loop only via its queues.
+ */
+typedef struct cm_io_loop_s {
+    /** Connection Manager context. */
+    struct cm_ctx_s *cm_ctx;
+    /** Index of the loop within Connection Manager context. */
+    uint32_t index;
+
+    /** Event loop context. */
+    struct ev_loop *event_loop;
+    /** Thread where the loop runs (not used by the loop 0, which runs in Connection Manager's thread). */
+    pthread_t thread;
+    /** TRUE if the thread of the loop is running. */
+    bool running;
+
+    /** Queue of messages to be sent to their recipients. */
+    sr_cbuff_t *msg_queue;
+    /** Queue of file descriptors of accepted client connections to be served by this loop. */
+    sr_cbuff_t *conn_queue;
+    /** Mutex guarding message and connection queues. */
+    pthread_mutex_t queue_mutex;
+
+    /** Linked-list of all delayed requests (to be sent to the Request Processor after some timeout). */
+    struct cm_delayed_request_ctx_s *delayed_requests;
+
+    /** Watcher for stop request events. */
+    ev_async stop_watcher;
+    /** Watcher for message enqueue events. */
+    ev_async msg_queue_watcher;
+    /** Watcher for connection enqueue events. */
+    ev_async conn_queue_watcher;
+} cm_io_loop_t;
+
 /**
  * @brief Connection Manager context.
  */
@@ -67,27 +111,21 @@ typedef struct cm_ctx_s {
     /** Socket descriptor used to listen & accept new unix-domain connections. */
     int listen_socket_fd;
 
-    /** Queue of messages to be sent to their recipients. */
-    sr_cbuff_t *msg_queue;
-    /** Message queue mutex. */
-    pthread_mutex_t msg_queue_mutex;
-
     /** Queue of requests to be sent to the Request Processor after some timeout. */
     sr_cbuff_t *delayed_requests_queue;
-    /** Linked-list of all delayed requests (to be sent to the Request Processor after some timeout). */
-    struct cm_delayed_request_ctx_s *delayed_requests;
 
     /** Thread where event loop will be running in case of library mode. */
     pthread_t event_loop_thread;
 
-    /** Event loop context. */
-    struct ev_loop *event_loop;
+    /** I/O loops, the loop 0 also accepts new connections and watches for signals. */
+    cm_io_loop_t *io_loops;
+    /** Number of I/O loops. */
+    uint32_t io_loop_cnt;
+    /** I/O loop where the next accepted connection will be assigned to (round-robin). */
+    uint32_t next_io_loop;
+
     /** Watcher for events on server unix-domain socket. */
     ev_io server_watcher;
-    /** Watcher for stop request events. */
-    ev_async stop_watcher;
-    /** Watcher for message enqueue events. */
-    ev_async msg_queue_watcher;
     /** Watcher for signals. */
     ev_signal signal_watchers[CM_MAX_SIGNAL_WATCHERS];
     /** Callbacks called by individual signal watchers. */
@@ -111,6 +149,8 @@ typedef struct cm_session_ctx_s {
     uint32_t rp_req_cnt;           /**< Number of session-related outstanding requests in Request Processor. */
     sr_cbuff_t *rp_request_queue;  /**< Queue of requests waiting for forwarding to Request Processor. */
     uint32_t rp_resp_expected;     /**< Number of expected session-related responses to be forwarded to Request Processor. */
+    bool has_rp_req_id;            /**< TRUE if the request being processed in Request Processor carries a request ID. */
+    uint64_t rp_req_id;            /**< Request ID of the request being processed in Request Processor (echoed in the response). */
     rp_session_t *rp_session;      /**< Request Processor's session context. */
     bool stop_requested;           /**< Session-stop requested, but there are still some outstanding requests in RP.
                                         Session will be freed as soon as the response comes from RP. */
@@ -121,17 +161,19 @@ typedef struct cm_session_ctx_s {
  */
 typedef struct cm_connection_ctx_s {
     cm_ctx_t *cm_ctx;      /**< Connection Manager context related to this connection. */
+    cm_io_loop_t *io_loop; /**< I/O loop serving this connection. */
     cm_buffer_t in_buff;   /**< Input buffer. If not empty, there is some received data to be processed. */
     cm_buffer_t out_buff;  /**< Output buffer. If not empty, there is some data to be sent when receiver is ready. */
     ev_io read_watcher;    /**< Watcher for readable events on connection's socket. */
     ev_io write_watcher;   /**< Watcher for writable events on connection's socket. */
+    sr_shm_channel_t *shm; /**< Shared-memory channel negotiated by the client (NULL if messages go over the socket only). */
 } cm_connection_ctx_t;
 
 /**
  * @brief Context of a delayed request (request to be sent to the Request Processor after some timeout).
  */
 typedef struct cm_delayed_request_ctx_s {
-    cm_ctx_t *cm_ctx;                       /**< Connection Manager context related to this request. */
+    cm_io_loop_t *io_loop;                  /**< I/O loop where the request has been scheduled. */
     cm_session_ctx_t *session;              /**< Session context related to this request. */
     Sr__Msg *msg;                           /**< Message with the request. */
     ev_timer timer;                         /**< Timer used to determine when to send the request. */
@@ -253,6 +295,7 @@ cm_connection_data_cleanup(void *connection)
     if ((NULL != sm_connection) && (NULL != sm_connection->cm_data)) {
         free(sm_connection->cm_data->in_buff.data);
         free(sm_connection->cm_data->out_buff.data);
+        sr_shm_channel_cleanup(sm_connection->cm_data->shm);
         free(sm_connection->cm_data);
         sm_connection->cm_data = NULL;
     }
@@ -265,6 +308,7 @@ static void
 cm_delayed_request_cb(struct ev_loop *loop, ev_timer *w, int revents)
 {
     cm_delayed_request_ctx_t *req = NULL, *prev = NULL;
+    cm_ctx_t *cm_ctx = NULL;
     sm_session_t *sm_session = NULL;
     bool ignore = false;
     int rc = SR_ERR_OK;
@@ -272,11 +316,12 @@ cm_delayed_request_cb(struct ev_loop *loop, ev_timer *w, int revents)
     CHECK_NULL_ARG_VOID2(w, w->data);
     req = (cm_delayed_request_ctx_t*)w->data;
 
-    CHECK_NULL_ARG_VOID3(req, req->cm_ctx, req->msg);
+    CHECK_NULL_ARG_VOID4(req, req->io_loop, req->io_loop->cm_ctx, req->msg);
+    cm_ctx = req->io_loop->cm_ctx;
 
     if (NULL != req->session) {
         /* check if the session is still active */
-        rc = sm_session_find_id(req->cm_ctx->sm_ctx, req->msg->session_id, &sm_session);
+        rc = sm_session_find_id(cm_ctx->sm_ctx, req->msg->session_id, &sm_session);
         if (SR_ERR_OK != rc) {
             SR_LOG_DBG("Unable to find session context for delayed request with session id=%"PRIu32", "
                     "ignoring the request.", req->msg->session_id);
@@ -286,7 +331,7 @@ cm_delayed_request_cb(struct ev_loop *loop, ev_timer *w, int revents)
 
     if (!ignore) {
         /* send the request to Request processor */
-        rc = rp_msg_process(req->cm_ctx->rp_ctx, (NULL != req->session ? req->session->rp_session : NULL), req->msg);
+        rc = rp_msg_process(cm_ctx->rp_ctx, (NULL != req->session ? req->session->rp_session : NULL), req->msg);
         if (SR_ERR_OK != rc) {
             SR_LOG_WRN_MSG("Unable to send the delayed request to the Request Processor.");
         } else {
@@ -295,10 +340,10 @@ cm_delayed_request_cb(struct ev_loop *loop, ev_timer *w, int revents)
     }
 
     /* remove the request from linked list */
-    if (req == req->cm_ctx->delayed_requests) {
-        req->cm_ctx->delayed_requests = req->next;
+    if (req == req->io_loop->delayed_requests) {
+        req->io_loop->delayed_requests = req->next;
     } else {
-        prev = req->cm_ctx->delayed_requests;
+        prev = req->io_loop->delayed_requests;
         while ((NULL != prev) && (req != prev->next)) {
             prev = prev->next;
         }
@@ -317,11 +362,11 @@ cm_delayed_request_cb(struct ev_loop *loop, ev_timer *w, int revents)
  * @brief Sends a message to the Request Processor after specified timeout.
  */
 static int
-cm_delayed_msg_process(cm_ctx_t *cm_ctx, cm_session_ctx_t *session, Sr__Msg *msg, double timeout)
+cm_delayed_msg_process(cm_io_loop_t *io_loop, cm_session_ctx_t *session, Sr__Msg *msg, double timeout)
 {
     cm_delayed_request_ctx_t *req = NULL, *prev = NULL;
 
-    CHECK_NULL_ARG2(cm_ctx, msg);
+    CHECK_NULL_ARG2(io_loop, msg);
 
     SR_LOG_DBG("Scheduling a delayed request for %f seconds.", timeout);
 
@@ -329,15 +374,15 @@ cm_delayed_msg_process(cm_ctx_t *cm_ctx, cm_session_ctx_t *session, Sr__Msg *msg
     req = calloc(1, sizeof(*req));
     CHECK_NULL_NOMEM_RETURN(req);
 
-    req->cm_ctx = cm_ctx;
+    req->io_loop = io_loop;
     req->session = session;
     req->msg = msg;
 
-    /* put the context at the end of the linked-list in CM context */
-    if (NULL == cm_ctx->delayed_requests) {
-        cm_ctx->delayed_requests = req;
+    /* put the context at the end of the linked-list in I/O loop context */
+    if (NULL == io_loop->delayed_requests) {
+        io_loop->delayed_requests = req;
     } else {
-        prev = cm_ctx->delayed_requests;
+        prev = io_loop->delayed_requests;
         while (NULL != prev->next) {
             prev = prev->next;
         }
@@ -347,7 +392,7 @@ cm_delayed_msg_process(cm_ctx_t *cm_ctx, cm_session_ctx_t *session, Sr__Msg *msg
     /* schedule the timer */
     ev_timer_init(&req->timer, cm_delayed_request_cb, timeout, 0.);
     req->timer.data = req;
-    ev_timer_start(cm_ctx->event_loop, &req->timer);
+    ev_timer_start(io_loop->event_loop, &req->timer);
 
     return SR_ERR_OK;
 }
@@ -356,13 +401,13 @@ cm_delayed_msg_process(cm_ctx_t *cm_ctx, cm_session_ctx_t *session, Sr__Msg *msg
  * @brief Request removal of subscriptions with the specified destination address.
  */
 static int
-cm_subscr_unsubscribe_destination(cm_ctx_t *cm_ctx, const char *destination_address, double delay)
+cm_subscr_unsubscribe_destination(cm_io_loop_t *io_loop, const char *destination_address, double delay)
 {
     Sr__Msg *msg_req = NULL;
     sr_mem_ctx_t *sr_mem = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG2(cm_ctx, destination_address);
+    CHECK_NULL_ARG3(io_loop, io_loop->cm_ctx, destination_address);
 
     SR_LOG_DBG("Requesting removal of subscriptions for the destination '%s'.", destination_address);
 
@@ -377,10 +422,10 @@ cm_subscr_unsubscribe_destination(cm_ctx_t *cm_ctx, const char *destination_addr
 
     if (delay > 0) {
         /* unsubscribe after timeout to prevent configuration flaps in running ds */
-        rc = cm_delayed_msg_process(cm_ctx, NULL, msg_req, delay);
+        rc = cm_delayed_msg_process(io_loop, NULL, msg_req, delay);
     } else {
         /* unsubscribe immediately */
-        rc = rp_msg_process(cm_ctx->rp_ctx, NULL, msg_req);
+        rc = rp_msg_process(io_loop->cm_ctx->rp_ctx, NULL, msg_req);
     }
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR("Unable to remove subscriptions for the destination '%s'.", destination_address);
@@ -403,6 +448,7 @@ cleanup:
 static int
 cm_conn_close(cm_ctx_t *cm_ctx, sm_connection_t *conn)
 {
+    cm_io_loop_t *io_loop = NULL;
     sm_session_list_t *sess = NULL;
     bool drop_session = false;
 
@@ -410,9 +456,12 @@ cm_conn_close(cm_ctx_t *cm_ctx, sm_connection_t *conn)
 
     SR_LOG_INF("Closing the connection %p.", (void*)conn);
 
+    io_loop = &cm_ctx->io_loops[conn->io_loop];
+
+    /* watchers must be stopped before the fd is closed (the fd number can be reused immediately) */
     if (NULL != conn->cm_data) {
-        ev_io_stop(cm_ctx->event_loop, &conn->cm_data->read_watcher);
-        ev_io_stop(cm_ctx->event_loop, &conn->cm_data->write_watcher);
+        ev_io_stop(io_loop->event_loop, &conn->cm_data->read_watcher);
+        ev_io_stop(io_loop->event_loop, &conn->cm_data->write_watcher);
     }
     close(conn->fd);
 
@@ -446,7 +495,7 @@ cm_conn_close(cm_ctx_t *cm_ctx, sm_connection_t *conn)
         /* this was a subscriber connection, remove the subscriptions for that destination */
         SR_LOG_DBG("Subscription server at '%s' has disconnected.", conn->dst_address);
         /* unsubscribe after timeout to prevent configuration flaps in running ds */
-        cm_subscr_unsubscribe_destination(cm_ctx, conn->dst_address, CM_SUBSCRIBER_DISCONNECT_TIMEOUT);
+        cm_subscr_unsubscribe_destination(io_loop, conn->dst_address, CM_SUBSCRIBER_DISCONNECT_TIMEOUT);
     }
 
     /* cleanup connection, pointers to the connection from outstanding sessions will be set to NULL */
@@ -517,7 +566,7 @@ cm_conn_out_buff_flush(cm_ctx_t *cm_ctx, sm_connection_t *connection)
                 /* mark the position where the unsent data start */
                 connection->cm_data->out_buff.start = buff_pos;
                 /* monitor fd for writable event */
-                ev_io_start(cm_ctx->event_loop, &connection->cm_data->write_watcher);
+                ev_io_start(connection->cm_data->io_loop->event_loop, &connection->cm_data->write_watcher);
                 break;
             } else {
                 /* error by writing - close the connection due to an error */
@@ -544,6 +593,7 @@ static int
 cm_msg_send_connection(cm_ctx_t *cm_ctx, sm_connection_t *connection, Sr__Msg *msg)
 {
     cm_buffer_t *buff = NULL;
+    uint8_t *shm_data = NULL;
     size_t msg_size = 0;
     int rc = SR_ERR_OK;
 
@@ -552,12 +602,31 @@ cm_msg_send_connection(cm_ctx_t *cm_ctx, sm_connection_t *connection, Sr__Msg *m
     buff = &connection->cm_data->out_buff;
 
     /* find out required message size */
-    msg_size = sr__msg__get_packed_size(msg);
+    msg_size = sr_gpb_msg_get_packed_size(msg);
     if ((msg_size <= 0) || (msg_size > SR_MAX_MSG_SIZE)) {
         SR_LOG_ERR("Unable to send the message of size %zuB.", msg_size);
         return SR_ERR_INTERNAL;
     }
 
+    if (NULL != connection->cm_data->shm && sr_shm_channel_reserve(connection->cm_data->shm, msg_size, &shm_data)) {
+        /* pack the message directly into the shared memory, only the doorbell goes over the socket */
+        rc = cm_conn_buffer_expand(connection, buff, SR_MSG_CTRL_SIZE);
+        if (SR_ERR_OK == rc) {
+            sr_gpb_msg_pack(msg, shm_data);
+            sr_shm_channel_commit(connection->cm_data->shm);
+
+            sr_uint32_to_buff(0, (buff->data + buff->pos));
+            sr_uint32_to_buff(SR_MSG_CTRL_SHM_DOORBELL, (buff->data + buff->pos + SR_MSG_PREAM_SIZE));
+            buff->pos += SR_MSG_CTRL_SIZE;
+
+            rc = cm_conn_out_buff_flush(cm_ctx, connection);
+            if ((connection->close_requested) || (SR_ERR_OK != rc)) {
+                cm_conn_close(cm_ctx, connection);
+            }
+        }
+        return rc;
+    }
+
     /* expand the buffer if needed */
     rc = cm_conn_buffer_expand(connection, buff, SR_MSG_PREAM_SIZE + msg_size);
 
@@ -567,7 +636,7 @@ cm_msg_send_connection(cm_ctx_t *cm_ctx, sm_connection_t *connection, Sr__Msg *m
         buff->pos += SR_MSG_PREAM_SIZE;
 
         /* write the message */
-        sr__msg__pack(msg, (buff->data + buff->pos));
+        sr_gpb_msg_pack(msg, (buff->data + buff->pos));
         buff->pos += msg_size;
 
         /* flush the buffer */
@@ -666,6 +735,10 @@ cm_session_start_req_process(cm_ctx_t *cm_ctx, sm_connection_t *conn, Sr__Msg *m
             (msg_in->request->session_start_req->has_commit_id ? msg_in->request->session_start_req->commit_id : 0),
             &session);
 
+    /* echo the request ID */
+    msg->has_request_id = msg_in->has_request_id;
+    msg->request_id = msg_in->request_id;
+
     if (SR_ERR_OK == rc) {
         /* set the id to response */
         msg->session_id = session->id;
@@ -736,6 +809,10 @@ cm_session_stop_req_process(cm_ctx_t *cm_ctx, sm_session_t *session, Sr__Msg *ms
         }
     }
 
+    /* echo the request ID */
+    msg_out->has_request_id = msg_in->has_request_id;
+    msg_out->request_id = msg_in->request_id;
+
     if (SR_ERR_OK == rc) {
         /* set the id to response */
         msg_out->response->session_stop_resp->session_id = session->id;
@@ -789,6 +866,8 @@ cm_session_check_req_process(cm_ctx_t *cm_ctx, sm_session_t *session, Sr__Msg *m
     }
 
     msg->session_id = session->id;
+    msg->has_request_id = msg_in->has_request_id;
+    msg->request_id = msg_in->request_id;
 
     /* send the response */
     rc = cm_msg_send_connection(cm_ctx, session->connection, msg);
@@ -855,6 +934,8 @@ cm_req_process(cm_ctx_t *cm_ctx, sm_connection_t *conn, sm_session_t *session, S
             } else {
                 /* no outstanding requests in RP, we can forward the message to request Processor */
                 session->cm_data->rp_req_cnt += 1;
+                session->cm_data->has_rp_req_id = msg->has_request_id;
+                session->cm_data->rp_req_id = msg->request_id;
                 rc = rp_msg_process(cm_ctx->rp_ctx, session->cm_data->rp_session, msg);
                 if (SR_ERR_OK != rc) {
                     session->cm_data->rp_req_cnt -= 1;
@@ -962,6 +1043,8 @@ cm_conn_msg_process(cm_ctx_t *cm_ctx, sm_connection_t *conn, uint8_t *msg_data,
         rc = SR_ERR_INTERNAL;
         goto cleanup;
     }
+    /* internal pointer, must never be taken over from the peer */
+    msg->_packed_payload = 0;
     if (NULL != sr_mem) {
         msg->_sysrepo_mem_ctx = (uint64_t)sr_mem;
         ++sr_mem->obj_count;
@@ -980,6 +1063,13 @@ cm_conn_msg_process(cm_ctx_t *cm_ctx, sm_connection_t *conn, uint8_t *msg_data,
     /* find matching session (except for some exceptions) */
     if (SR__MSG__MSG_TYPE__NOTIFICATION_ACK != msg->type &&
             ((SR__MSG__MSG_TYPE__REQUEST != msg->type) || (SR__OPERATION__SESSION_START != msg->request->operation))) {
+        if (sm_session_io_loop(cm_ctx->sm_ctx, msg->session_id) != conn->io_loop) {
+            /* sessions can be accessed only from their own I/O loop */
+            SR_LOG_ERR("Session id=%"PRIu32" is not served by the I/O loop of the connection (conn=%p).",
+                    msg->session_id, (void*)conn);
+            rc = SR_ERR_INVAL_ARG;
+            goto cleanup;
+        }
         rc = sm_session_find_id(cm_ctx->sm_ctx, msg->session_id, &session);
         if (SR_ERR_OK != rc) {
             SR_LOG_ERR("Unable to find session context for session id=%"PRIu32" (conn=%p).",
@@ -1022,6 +1112,159 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Sends a transport control frame to the peer of the connection.
+ */
+static int
+cm_conn_ctrl_send(cm_ctx_t *cm_ctx, sm_connection_t *conn, uint32_t code)
+{
+    cm_buffer_t *buff = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(cm_ctx, conn, conn->cm_data);
+
+    buff = &conn->cm_data->out_buff;
+
+    rc = cm_conn_buffer_expand(conn, buff, SR_MSG_CTRL_SIZE);
+    CHECK_RC_MSG_RETURN(rc, "Unable to expand the output buffer.");
+
+    sr_uint32_to_buff(0, (buff->data + buff->pos));
+    sr_uint32_to_buff(code, (buff->data + buff->pos + SR_MSG_PREAM_SIZE));
+    buff->pos += SR_MSG_CTRL_SIZE;
+
+    return cm_conn_out_buff_flush(cm_ctx, conn);
+}
+
+/**
+ * @brief Processes a request for a shared-memory channel. The segment of the channel is created
+ * by the engine and passed to the client along with the accepting control frame.
+ */
+static int
+cm_conn_shm_request_process(cm_ctx_t *cm_ctx, sm_connection_t *conn)
+{
+    sr_shm_channel_t *shm = NULL;
+    uint8_t frame[SR_MSG_CTRL_SIZE] = { 0, };
+    struct msghdr msgh = { 0, };
+    struct iovec iov = { 0, };
+    struct cmsghdr *cmsg = NULL;
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    ssize_t sent = 0;
+    int fd = -1, rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(cm_ctx, conn, conn->cm_data);
+
+    if (CM_AF_UNIX_CLIENT != conn->type || NULL != conn->cm_data->shm || 0 != conn->cm_data->out_buff.pos) {
+        /* the descriptor has to be the first data sent on the connection */
+        SR_LOG_WRN("Unexpected request for a shared-memory channel (conn=%p).", (void*)conn);
+        return cm_conn_ctrl_send(cm_ctx, conn, SR_MSG_CTRL_SHM_REJECT);
+    }
+
+    rc = sr_shm_channel_create(SR_SHM_RING_SIZE, &fd, &shm);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_WRN("Unable to create a shared-memory channel (conn=%p), using the socket only.", (void*)conn);
+        return cm_conn_ctrl_send(cm_ctx, conn, SR_MSG_CTRL_SHM_REJECT);
+    }
+
+    sr_uint32_to_buff(0, frame);
+    sr_uint32_to_buff(SR_MSG_CTRL_SHM_ACCEPT, frame + SR_MSG_PREAM_SIZE);
+    iov.iov_base = frame;
+    iov.iov_len = SR_MSG_CTRL_SIZE;
+    msgh.msg_iov = &iov;
+    msgh.msg_iovlen = 1;
+
+    memset(&control, 0, sizeof(control));
+    msgh.msg_control = control.buf;
+    msgh.msg_controllen = sizeof(control.buf);
+    cmsg = CMSG_FIRSTHDR(&msgh);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    do {
+        sent = sendmsg(conn->fd, &msgh, 0);
+    } while (-1 == sent && EINTR == errno);
+    close(fd);
+
+    if (SR_MSG_CTRL_SIZE != sent) {
+        /* the socket buffer of a fresh connection cannot be full, the connection is broken */
+        SR_LOG_ERR("Unable to pass the shared-memory segment to fd %d: %s.", conn->fd,
+                (-1 == sent) ? sr_strerror_safe(errno) : "partial write");
+        sr_shm_channel_cleanup(shm);
+        return SR_ERR_DISCONNECT;
+    }
+
+    SR_LOG_DBG("Shared-memory channel established on fd %d.", conn->fd);
+    conn->cm_data->shm = shm;
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Processes a message announced by a doorbell control frame, the message is unpacked
+ * directly from the shared-memory channel of the connection.
+ */
+static int
+cm_conn_shm_msg_process(cm_ctx_t *cm_ctx, sm_connection_t *conn)
+{
+    sr_shm_channel_t *shm = NULL;
+    const uint8_t *msg_data = NULL;
+    uint8_t *msg_copy = NULL;
+    size_t msg_size = 0;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(cm_ctx, conn, conn->cm_data);
+
+    shm = conn->cm_data->shm;
+    if (NULL == shm) {
+        SR_LOG_ERR("Doorbell received on a connection without shared-memory channel (conn=%p).", (void*)conn);
+        return SR_ERR_MALFORMED_MSG;
+    }
+
+    rc = sr_shm_channel_peek(shm, &msg_data, &msg_size);
+    if (SR_ERR_NOT_FOUND == rc) {
+        SR_LOG_ERR("Doorbell received, but the shared-memory channel is empty (conn=%p).", (void*)conn);
+        return SR_ERR_MALFORMED_MSG;
+    }
+    CHECK_RC_MSG_RETURN(rc, "Unable to read the message from the shared-memory channel.");
+
+    if (conn->uid != geteuid()) {
+        /* the peer can rewrite the shared memory at any time, unpack messages of other users from a private copy */
+        msg_copy = malloc(msg_size);
+        CHECK_NULL_NOMEM_RETURN(msg_copy);
+        memcpy(msg_copy, msg_data, msg_size);
+        msg_data = msg_copy;
+    }
+
+    SR_LOG_DBG("New message of size %zu bytes received via shared memory.", msg_size);
+    rc = cm_conn_msg_process(cm_ctx, conn, (uint8_t*)msg_data, msg_size);
+
+    sr_shm_channel_consume(shm);
+    free(msg_copy);
+
+    return rc;
+}
+
+/**
+ * @brief Processes a transport control frame received on connection.
+ */
+static int
+cm_conn_ctrl_process(cm_ctx_t *cm_ctx, sm_connection_t *conn, uint32_t code)
+{
+    switch (code) {
+        case SR_MSG_CTRL_SHM_REQUEST:
+            return cm_conn_shm_request_process(cm_ctx, conn);
+        case SR_MSG_CTRL_SHM_DOORBELL:
+            return cm_conn_shm_msg_process(cm_ctx, conn);
+        default:
+            SR_LOG_ERR("Invalid control code received (%"PRIu32").", code);
+            return SR_ERR_MALFORMED_MSG;
+    }
+}
+
 /**
  * @brief Processes the content of input buffer of a connection.
  */
@@ -1045,11 +1288,22 @@ cm_conn_in_buff_process(cm_ctx_t *cm_ctx, sm_connection_t *conn)
 
     while ((buff_size - buff_pos) > SR_MSG_PREAM_SIZE) {
         msg_size = sr_buff_to_uint32(buff->data + buff_pos);
-        if ((msg_size <= 0) || (msg_size > SR_MAX_MSG_SIZE)) {
+        if (0 == msg_size) {
+            /* transport control frame */
+            if ((buff_size - buff_pos) < SR_MSG_CTRL_SIZE) {
+                break;
+            }
+            rc = cm_conn_ctrl_process(cm_ctx, conn, sr_buff_to_uint32(buff->data + buff_pos + SR_MSG_PREAM_SIZE));
+            buff_pos += SR_MSG_CTRL_SIZE;
+            if (SR_ERR_OK != rc) {
+                SR_LOG_ERR_MSG("Error by processing of the control frame.");
+                return rc;
+            }
+        } else if (msg_size > SR_MAX_MSG_SIZE) {
             /* invalid message size */
             SR_LOG_ERR("Invalid message size in the message preamble (%zu).", msg_size);
             return SR_ERR_MALFORMED_MSG;
-        } else if ((buff_size - buff_pos) >= msg_size) {
+        } else if ((buff_size - buff_pos - SR_MSG_PREAM_SIZE) >= msg_size) {
             /* the message is completely retrieved, parse it */
             SR_LOG_DBG("New message of size %zu bytes received.", msg_size);
             rc = cm_conn_msg_process(cm_ctx, conn,
@@ -1167,7 +1421,7 @@ cm_conn_write_cb(struct ev_loop *loop, ev_io *w, int revents)
 
     SR_LOG_DBG("fd %d writeable", conn->fd);
 
-    ev_io_stop(cm_ctx->event_loop, &conn->cm_data->write_watcher);
+    ev_io_stop(loop, &conn->cm_data->write_watcher);
 
     /* flush the output buffer */
     rc = cm_conn_out_buff_flush(cm_ctx, conn);
@@ -1182,9 +1436,9 @@ cm_conn_write_cb(struct ev_loop *loop, ev_io *w, int revents)
  * @brief Initializes read and write watchers for the file descriptor of provided connection.
  */
 static int
-cm_conn_watcher_init(cm_ctx_t *cm_ctx, sm_connection_t *conn)
+cm_conn_watcher_init(cm_io_loop_t *io_loop, sm_connection_t *conn)
 {
-    CHECK_NULL_ARG2(cm_ctx, conn);
+    CHECK_NULL_ARG2(io_loop, conn);
 
     conn->cm_data = calloc(1, sizeof(*(conn->cm_data)));
     if (NULL == conn->cm_data) {
@@ -1192,11 +1446,12 @@ cm_conn_watcher_init(cm_ctx_t *cm_ctx, sm_connection_t *conn)
         return SR_ERR_NOMEM;
     }
 
-    conn->cm_data->cm_ctx = cm_ctx;
+    conn->cm_data->cm_ctx = io_loop->cm_ctx;
+    conn->cm_data->io_loop = io_loop;
 
     ev_io_init(&conn->cm_data->read_watcher, cm_conn_read_cb, conn->fd, EV_READ);
     conn->cm_data->read_watcher.data = (void*)conn;
-    ev_io_start(cm_ctx->event_loop, &conn->cm_data->read_watcher);
+    ev_io_start(io_loop->event_loop, &conn->cm_data->read_watcher);
 
     ev_io_init(&conn->cm_data->write_watcher, cm_conn_write_cb, conn->fd, EV_WRITE);
     conn->cm_data->write_watcher.data = (void*)conn;
@@ -1205,16 +1460,90 @@ cm_conn_watcher_init(cm_ctx_t *cm_ctx, sm_connection_t *conn)
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Starts serving of an accepted client connection in provided I/O loop.
+ * Must be called from the thread of the I/O loop.
+ */
+static int
+cm_client_conn_start(cm_io_loop_t *io_loop, int clnt_fd)
+{
+    cm_ctx_t *cm_ctx = NULL;
+    sm_connection_t *connection = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(io_loop, io_loop->cm_ctx);
+    cm_ctx = io_loop->cm_ctx;
+
+    /* start connection in session manager */
+    rc = sm_connection_start(cm_ctx->sm_ctx, CM_AF_UNIX_CLIENT, clnt_fd, &connection);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Cannot start connection in Session manager (fd=%d).", clnt_fd);
+        close(clnt_fd);
+        return rc;
+    }
+    connection->io_loop = io_loop->index;
+
+    /* check uid in case of local (library) mode */
+    if (CM_MODE_LOCAL == cm_ctx->mode) {
+        if (connection->uid != geteuid()) {
+            SR_LOG_ERR("Peer's uid=%d does not match with local uid=%d "
+                    "(required by local mode).", connection->uid, geteuid());
+            sm_connection_stop(cm_ctx->sm_ctx, connection);
+            close(clnt_fd);
+            return SR_ERR_UNAUTHORIZED;
+        }
+    }
+
+    /* start watching this fd */
+    rc = cm_conn_watcher_init(io_loop, connection);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Cannot initialize watcher for fd=%d.", clnt_fd);
+        sm_connection_stop(cm_ctx->sm_ctx, connection);
+        close(clnt_fd);
+        return rc;
+    }
+
+    SR_LOG_DBG("Client connection on fd %d served by the I/O loop %"PRIu32".", clnt_fd, io_loop->index);
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Callback called by the event loop watcher when a connection has been
+ * handed over to the I/O loop.
+ */
+static void
+cm_conn_enqueue_cb(struct ev_loop *loop, ev_async *w, int revents)
+{
+    cm_io_loop_t *io_loop = NULL;
+    bool dequeued = false;
+
+    CHECK_NULL_ARG_VOID2(w, w->data);
+    io_loop = (cm_io_loop_t*)w->data;
+
+    do {
+        int clnt_fd = -1;
+
+        pthread_mutex_lock(&io_loop->queue_mutex);
+        dequeued = sr_cbuff_dequeue(io_loop->conn_queue, &clnt_fd);
+        pthread_mutex_unlock(&io_loop->queue_mutex);
+
+        if (dequeued) {
+            cm_client_conn_start(io_loop, clnt_fd);
+        }
+    } while (dequeued);
+}
+
 /**
  * @brief Callback called by the event loop watcher when a new connection is detected
- * on the server socket. Accepts new connections to the server and starts
- * monitoring the new client file descriptors.
+ * on the server socket. Accepts new connections to the server and distributes
+ * them across the I/O loops, which start monitoring the new client file descriptors.
  */
 static void
 cm_server_watcher_cb(struct ev_loop *loop, ev_io *w, int revents)
 {
     cm_ctx_t *cm_ctx = NULL;
-    sm_connection_t *connection = NULL;
+    cm_io_loop_t *io_loop = NULL;
     int clnt_fd = -1;
     int rc = SR_ERR_OK;
 
@@ -1233,29 +1562,23 @@ cm_server_watcher_cb(struct ev_loop *loop, ev_io *w, int revents)
                 close(clnt_fd);
                 continue;
             }
-            /* start connection in session manager */
-            rc = sm_connection_start(cm_ctx->sm_ctx, CM_AF_UNIX_CLIENT, clnt_fd, &connection);
-            if (SR_ERR_OK != rc) {
-                SR_LOG_ERR("Cannot start connection in Session manager (fd=%d).", clnt_fd);
-                close(clnt_fd);
-                continue;
-            }
-            /* check uid in case of local (library) mode */
-            if (CM_MODE_LOCAL == cm_ctx->mode) {
-                if (connection->uid != geteuid()) {
-                    SR_LOG_ERR("Peer's uid=%d does not match with local uid=%d "
-                            "(required by local mode).", connection->uid, geteuid());
-                    sm_connection_stop(cm_ctx->sm_ctx, connection);
+            /* assign the connection to an I/O loop (round-robin) */
+            io_loop = &cm_ctx->io_loops[cm_ctx->next_io_loop];
+            cm_ctx->next_io_loop = (cm_ctx->next_io_loop + 1) % cm_ctx->io_loop_cnt;
+            if (loop == io_loop->event_loop) {
+                /* served by this loop */
+                cm_client_conn_start(io_loop, clnt_fd);
+            } else {
+                /* hand the connection over to the thread of the I/O loop */
+                pthread_mutex_lock(&io_loop->queue_mutex);
+                rc = sr_cbuff_enqueue(io_loop->conn_queue, &clnt_fd);
+                pthread_mutex_unlock(&io_loop->queue_mutex);
+                if (SR_ERR_OK != rc) {
+                    SR_LOG_ERR("Cannot hand over fd=%d to the I/O loop %"PRIu32".", clnt_fd, io_loop->index);
                     close(clnt_fd);
                     continue;
                 }
-            }
-            /* start watching this fd */
-            rc = cm_conn_watcher_init(cm_ctx, connection);
-            if (SR_ERR_OK != rc) {
-                SR_LOG_ERR("Cannot initialize watcher for fd=%d.", clnt_fd);
-                close(clnt_fd);
-                continue;
+                ev_async_send(io_loop->event_loop, &io_loop->conn_queue_watcher);
             }
         } else {
             if ((EWOULDBLOCK == errno) || (EAGAIN == errno)) {
@@ -1273,13 +1596,17 @@ cm_server_watcher_cb(struct ev_loop *loop, ev_io *w, int revents)
  * @brief Creates a new connection to the subscriber destination address.
  */
 static int
-cm_subscr_conn_create(cm_ctx_t *cm_ctx, const char *socket_path, sm_connection_t **connection_p)
+cm_subscr_conn_create(cm_io_loop_t *io_loop, const char *socket_path, sm_connection_t **connection_p)
 {
+    cm_ctx_t *cm_ctx = NULL;
     int fd = -1;
     struct sockaddr_un addr = { 0, };
     sm_connection_t *connection = NULL;
     int rc = SR_ERR_OK;
 
+    CHECK_NULL_ARG4(io_loop, io_loop->cm_ctx, socket_path, connection_p);
+    cm_ctx = io_loop->cm_ctx;
+
     /* prepare a socket */
     fd = socket(AF_UNIX, SOCK_STREAM, 0);
     if (-1 == fd) {
@@ -1302,6 +1629,7 @@ cm_subscr_conn_create(cm_ctx_t *cm_ctx, const char *socket_path, sm_connection_t
         rc = SR_ERR_INTERNAL;
         goto cleanup;
     }
+    connection->io_loop = io_loop->index;
 
     /* assign socket path as destination address */
     rc = sm_connection_assign_dst(cm_ctx->sm_ctx, connection, socket_path);
@@ -1312,7 +1640,7 @@ cm_subscr_conn_create(cm_ctx_t *cm_ctx, const char *socket_path, sm_connection_t
     }
 
     /* initialize connection watchers */
-    rc = cm_conn_watcher_init(cm_ctx, connection);
+    rc = cm_conn_watcher_init(io_loop, connection);
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR("Cannot initialize watcher for fd=%d.", fd);
         rc = SR_ERR_INTERNAL;
@@ -1361,12 +1689,14 @@ cleanup:
  * @brief Processes an outgoing notification (notification to be sent to the client library).
  */
 static int
-cm_out_notif_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
+cm_out_notif_process(cm_io_loop_t *io_loop, Sr__Msg *msg)
 {
+    cm_ctx_t *cm_ctx = NULL;
     sm_connection_t *connection = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG3(cm_ctx, msg, msg->notification);
+    CHECK_NULL_ARG3(io_loop, msg, msg->notification);
+    cm_ctx = io_loop->cm_ctx;
 
     SR_LOG_DBG("Sending a notification to '%s'.", msg->notification->destination_address);
 
@@ -1376,7 +1706,7 @@ cm_out_notif_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
     msg->notification->source_pid = (uint32_t)getpid();
 
     /* get a connection to the notification destination */
-    rc = sm_connection_find_dst(cm_ctx->sm_ctx, msg->notification->destination_address, &connection);
+    rc = sm_connection_find_dst(cm_ctx->sm_ctx, msg->notification->destination_address, io_loop->index, &connection);
     if (SR_ERR_OK == rc) {
         /* a connection to the destination already exists - reuse */
         SR_LOG_DBG("Reusing existing connection on fd=%d for the notification destination '%s'",
@@ -1384,7 +1714,7 @@ cm_out_notif_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
     } else {
         /* connection to that destination does not exist - connect */
         SR_LOG_DBG("Creating a new connection for the notification destination '%s'", msg->notification->destination_address);
-        rc = cm_subscr_conn_create(cm_ctx, msg->notification->destination_address, &connection);
+        rc = cm_subscr_conn_create(io_loop, msg->notification->destination_address, &connection);
     }
 
     /* send the message */
@@ -1394,7 +1724,7 @@ cm_out_notif_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
 
     if (SR_ERR_OK != rc && SR_ERR_DISCONNECT != rc) {
         /* by error, remove subscriptions on this destination */
-        cm_subscr_unsubscribe_destination(cm_ctx, msg->notification->destination_address, 0);
+        cm_subscr_unsubscribe_destination(io_loop, msg->notification->destination_address, 0);
     }
 
     sr_msg_free(msg);
@@ -1406,14 +1736,16 @@ cm_out_notif_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
  * @brief Processes an outgoing data-provide request (to be sent to the client library).
  */
 static int
-cm_out_dp_request_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
+cm_out_dp_request_process(cm_io_loop_t *io_loop, Sr__Msg *msg)
 {
+    cm_ctx_t *cm_ctx = NULL;
     sm_session_t *session = NULL;
     sm_connection_t *connection = NULL;
     char *destination_address = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG4(cm_ctx, msg, msg->request, msg->request->data_provide_req);
+    CHECK_NULL_ARG4(io_loop, msg, msg->request, msg->request->data_provide_req);
+    cm_ctx = io_loop->cm_ctx;
 
     destination_address = msg->request->data_provide_req->subscriber_address;
 
@@ -1436,7 +1768,7 @@ cm_out_dp_request_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
     session->cm_data->rp_resp_expected += 1;
 
     /* get a connection for the request destination */
-    rc = sm_connection_find_dst(cm_ctx->sm_ctx, destination_address, &connection);
+    rc = sm_connection_find_dst(cm_ctx->sm_ctx, destination_address, io_loop->index, &connection);
     if (SR_ERR_OK == rc) {
         /* a connection to the destination already exists - reuse */
         SR_LOG_DBG("Reusing existing connection on fd=%d for the data-provide request destination '%s'",
@@ -1444,7 +1776,7 @@ cm_out_dp_request_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
     } else {
         /* connection to that destination does not exist - connect */
         SR_LOG_DBG("Creating a new connection for the data-provide request destination '%s'", destination_address);
-        rc = cm_subscr_conn_create(cm_ctx, destination_address, &connection);
+        rc = cm_subscr_conn_create(io_loop, destination_address, &connection);
     }
 
     /* send the message */
@@ -1454,7 +1786,7 @@ cm_out_dp_request_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
 
     if (SR_ERR_OK != rc && SR_ERR_DISCONNECT != rc) {
         /* by error, remove subscriptions on this destination */
-        cm_subscr_unsubscribe_destination(cm_ctx, msg->request->data_provide_req->subscriber_address, 0);
+        cm_subscr_unsubscribe_destination(io_loop, msg->request->data_provide_req->subscriber_address, 0);
     }
 
     sr_msg_free(msg);
@@ -1466,15 +1798,17 @@ cm_out_dp_request_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
  * @brief Processes an outgoing RPC/Action (RPC/Action to be sent to the client library).
  */
 static int
-cm_out_rpc_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
+cm_out_rpc_process(cm_io_loop_t *io_loop, Sr__Msg *msg)
 {
+    cm_ctx_t *cm_ctx = NULL;
     sm_session_t *session = NULL;
     sm_connection_t *connection = NULL;
     char *destination_address = NULL;
     const char *op_name = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG4(cm_ctx, msg, msg->request, msg->request->rpc_req);
+    CHECK_NULL_ARG4(io_loop, msg, msg->request, msg->request->rpc_req);
+    cm_ctx = io_loop->cm_ctx;
 
     op_name = (msg->request->rpc_req->action ? "Action" : "RPC");
     destination_address = msg->request->rpc_req->subscriber_address;
@@ -1498,7 +1832,7 @@ cm_out_rpc_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
     session->cm_data->rp_resp_expected += 1;
 
     /* get a connection to the RPC/Action destination */
-    rc = sm_connection_find_dst(cm_ctx->sm_ctx, destination_address, &connection);
+    rc = sm_connection_find_dst(cm_ctx->sm_ctx, destination_address, io_loop->index, &connection);
     if (SR_ERR_OK == rc) {
         /* a connection to the destination already exists - reuse */
         SR_LOG_DBG("Reusing existing connection on fd=%d for the %s destination '%s'",
@@ -1506,7 +1840,7 @@ cm_out_rpc_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
     } else {
         /* connection to that destination does not exist - connect */
         SR_LOG_DBG("Creating a new connection for the %s destination '%s'", op_name, destination_address);
-        rc = cm_subscr_conn_create(cm_ctx, destination_address, &connection);
+        rc = cm_subscr_conn_create(io_loop, destination_address, &connection);
     }
 
     /* send the message */
@@ -1516,7 +1850,7 @@ cm_out_rpc_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
 
     if (SR_ERR_OK != rc && SR_ERR_DISCONNECT != rc) {
         /* by error, remove subscriptions on this destination */
-        cm_subscr_unsubscribe_destination(cm_ctx, destination_address, 0);
+        cm_subscr_unsubscribe_destination(io_loop, destination_address, 0);
     }
 
     sr_msg_free(msg);
@@ -1528,14 +1862,16 @@ cm_out_rpc_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
  * @brief Processes an outgoing event notification (notification to be sent to the client library).
  */
 static int
-cm_out_event_notif_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
+cm_out_event_notif_process(cm_io_loop_t *io_loop, Sr__Msg *msg)
 {
+    cm_ctx_t *cm_ctx = NULL;
     sm_session_t *session = NULL;
     sm_connection_t *connection = NULL;
     char *destination_address = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG4(cm_ctx, msg, msg->request, msg->request->event_notif_req);
+    CHECK_NULL_ARG4(io_loop, msg, msg->request, msg->request->event_notif_req);
+    cm_ctx = io_loop->cm_ctx;
 
     destination_address = msg->request->event_notif_req->subscriber_address;
 
@@ -1560,7 +1896,7 @@ cm_out_event_notif_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
     }
 
     /* get a connection to the notification destination */
-    rc = sm_connection_find_dst(cm_ctx->sm_ctx, destination_address, &connection);
+    rc = sm_connection_find_dst(cm_ctx->sm_ctx, destination_address, io_loop->index, &connection);
     if (SR_ERR_OK == rc) {
         /* a connection to the destination already exists - reuse */
         SR_LOG_DBG("Reusing existing connection on fd=%d for the event notification destination '%s'",
@@ -1568,7 +1904,7 @@ cm_out_event_notif_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
     } else {
         /* connection to that destination does not exist - connect */
         SR_LOG_DBG("Creating a new connection for the event notification destination '%s'", destination_address);
-        rc = cm_subscr_conn_create(cm_ctx, destination_address, &connection);
+        rc = cm_subscr_conn_create(io_loop, destination_address, &connection);
     }
 
     /* send the message */
@@ -1578,7 +1914,7 @@ cm_out_event_notif_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
 
     if (SR_ERR_OK != rc && SR_ERR_DISCONNECT != rc) {
         /* by error, remove subscriptions on this destination */
-        cm_subscr_unsubscribe_destination(cm_ctx, destination_address, 0);
+        cm_subscr_unsubscribe_destination(io_loop, destination_address, 0);
     }
 
     sr_msg_free(msg);
@@ -1590,12 +1926,14 @@ cm_out_event_notif_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
  * @brief Processes an internal request received from Request Processor.
  */
 static int
-cm_internal_msg_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
+cm_internal_msg_process(cm_io_loop_t *io_loop, Sr__Msg *msg)
 {
+    cm_ctx_t *cm_ctx = NULL;
     sm_session_t *session = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG3(cm_ctx, msg, msg->internal_request);
+    CHECK_NULL_ARG3(io_loop, msg, msg->internal_request);
+    cm_ctx = io_loop->cm_ctx;
 
     if (SR__OPERATION__OPER_DATA_TIMEOUT == msg->internal_request->operation) {
         /* find the session */
@@ -1610,7 +1948,7 @@ cm_internal_msg_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
 
     if (msg->internal_request->has_postpone_timeout) {
         /* schedule delivery of message with postpone timeout */
-        rc = cm_delayed_msg_process(cm_ctx, (NULL != session ? session->cm_data : NULL),
+        rc = cm_delayed_msg_process(io_loop, (NULL != session ? session->cm_data : NULL),
                 msg, msg->internal_request->postpone_timeout);
     } else {
         /* deliver the message immediately */
@@ -1629,16 +1967,18 @@ cm_internal_msg_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
  * @brief Processes an outgoing message (message to be sent to the client library).
  */
 static int
-cm_out_msg_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
+cm_out_msg_process(cm_io_loop_t *io_loop, Sr__Msg *msg)
 {
+    cm_ctx_t *cm_ctx = NULL;
     sm_session_t *session = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG2(cm_ctx, msg);
+    CHECK_NULL_ARG3(io_loop, io_loop->cm_ctx, msg);
+    cm_ctx = io_loop->cm_ctx;
 
     if (SR__MSG__MSG_TYPE__INTERNAL_REQUEST == msg->type) {
         /* handle as an internal request from RP */
-        return cm_internal_msg_process(cm_ctx, msg);
+        return cm_internal_msg_process(io_loop, msg);
     }
 
     /* find the session */
@@ -1660,6 +2000,9 @@ cm_out_msg_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
     if (SR__MSG__MSG_TYPE__RESPONSE == msg->type) {
         if (session->cm_data->rp_req_cnt > 0) {
             session->cm_data->rp_req_cnt -= 1;
+            /* RP processes one request of a session at a time, the response belongs to the last forwarded one */
+            msg->has_request_id = session->cm_data->has_rp_req_id;
+            msg->request_id = session->cm_data->rp_req_id;
         }
     } else if (SR__MSG__MSG_TYPE__REQUEST == msg->type) {
         session->cm_data->rp_resp_expected += 1;
@@ -1687,6 +2030,8 @@ cm_out_msg_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
             /* if there are some requests waiting for to be processed, process next one */
             if (sr_cbuff_dequeue(session->cm_data->rp_request_queue, &msg)) {
                 session->cm_data->rp_req_cnt += 1;
+                session->cm_data->has_rp_req_id = msg->has_request_id;
+                session->cm_data->rp_req_id = msg->request_id;
                 rc = rp_msg_process(cm_ctx->rp_ctx, session->cm_data->rp_session, msg);
                 if (SR_ERR_OK != rc) {
                     session->cm_data->rp_req_cnt -= 1;
@@ -1704,41 +2049,41 @@ cm_out_msg_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
 static void
 cm_msg_enqueue_cb(struct ev_loop *loop, ev_async *w, int revents)
 {
-    cm_ctx_t *cm_ctx = NULL;
+    cm_io_loop_t *io_loop = NULL;
     bool dequeued = false;
 
     CHECK_NULL_ARG_VOID2(w, w->data);
-    cm_ctx = (cm_ctx_t*)w->data;
+    io_loop = (cm_io_loop_t*)w->data;
 
-    SR_LOG_DBG_MSG("New message enqueued into CM message queue.");
+    SR_LOG_DBG("New message enqueued into CM message queue of the I/O loop %"PRIu32".", io_loop->index);
 
     do {
         Sr__Msg *msg = NULL;
 
-        pthread_mutex_lock(&cm_ctx->msg_queue_mutex);
-        dequeued = sr_cbuff_dequeue(cm_ctx->msg_queue, &msg);
-        pthread_mutex_unlock(&cm_ctx->msg_queue_mutex);
+        pthread_mutex_lock(&io_loop->queue_mutex);
+        dequeued = sr_cbuff_dequeue(io_loop->msg_queue, &msg);
+        pthread_mutex_unlock(&io_loop->queue_mutex);
 
         if (dequeued) {
             if (SR__MSG__MSG_TYPE__NOTIFICATION == msg->type) {
                 /* send the notification via subscriber connection */
-                cm_out_notif_process(cm_ctx, msg);
+                cm_out_notif_process(io_loop, msg);
             } else if ((SR__MSG__MSG_TYPE__REQUEST == msg->type) &&
                     (SR__OPERATION__DATA_PROVIDE == msg->request->operation)) {
                 /* send the data-provide request via subscriber connection */
-                cm_out_dp_request_process(cm_ctx, msg);
+                cm_out_dp_request_process(io_loop, msg);
             } else if ((SR__MSG__MSG_TYPE__REQUEST == msg->type) &&
                             (SR__OPERATION__RPC == msg->request->operation ||
                              SR__OPERATION__ACTION == msg->request->operation)) {
                /* send the RPC request via subscriber connection */
-               cm_out_rpc_process(cm_ctx, msg);
+               cm_out_rpc_process(io_loop, msg);
             } else if ((SR__MSG__MSG_TYPE__REQUEST == msg->type) &&
                    (SR__OPERATION__EVENT_NOTIF == msg->request->operation)) {
                /* send the event notification via subscriber connection */
-               cm_out_event_notif_process(cm_ctx, msg);
+               cm_out_event_notif_process(io_loop, msg);
            } else {
                 /* process as a normal message */
-                cm_out_msg_process(cm_ctx, msg);
+                cm_out_msg_process(io_loop, msg);
             }
         }
     } while (dequeued);
@@ -1750,14 +2095,11 @@ cm_msg_enqueue_cb(struct ev_loop *loop, ev_async *w, int revents)
 static void
 cm_stop_cb(struct ev_loop *loop, ev_async *w, int revents)
 {
-    cm_ctx_t *cm_ctx = NULL;
-
-    CHECK_NULL_ARG_VOID3(loop, w, w->data);
-    cm_ctx = (cm_ctx_t*)w->data;
+    CHECK_NULL_ARG_VOID2(loop, w);
 
     SR_LOG_DBG_MSG("Event loop stop requested.");
 
-    ev_break(cm_ctx->event_loop, EVBREAK_ALL);
+    ev_break(loop, EVBREAK_ALL);
 }
 
 /**
@@ -1782,9 +2124,209 @@ cm_signal_cb_internal(struct ev_loop *loop, struct ev_signal *w, int revents)
 }
 
 /**
- * @brief Event loop of Connection Manager. Monitors all connections for events
- * and calls proper callback handlers for each event. This function call blocks
- * until stop is requested via async stop request.
+ * @brief Returns the number of I/O loops to be used - CM_IO_LOOP_COUNT_DAEMON or
+ * CM_IO_LOOP_COUNT_LOCAL, unless overridden by the environment variable SR_CM_IO_LOOP_COUNT_ENV.
+ */
+static uint32_t
+cm_get_io_loop_count(const cm_connection_mode_t mode)
+{
+    const char *env_str = NULL;
+    char *endptr = NULL;
+    long count = 0;
+    uint32_t dflt = (CM_MODE_DAEMON == mode) ? CM_IO_LOOP_COUNT_DAEMON : CM_IO_LOOP_COUNT_LOCAL;
+
+    env_str = getenv(SR_CM_IO_LOOP_COUNT_ENV);
+    if (NULL == env_str) {
+        return dflt;
+    }
+
+    count = strtol(env_str, &endptr, 10);
+    if ('\0' == *env_str || '\0' != *endptr || count < 1 || count > CM_IO_LOOP_COUNT_MAX) {
+        SR_LOG_WRN("Invalid value '%s' of %s (expected 1-%d), using %"PRIu32" I/O loops.", env_str,
+                SR_CM_IO_LOOP_COUNT_ENV, CM_IO_LOOP_COUNT_MAX, dflt);
+        return dflt;
+    }
+
+    return (uint32_t)count;
+}
+
+/**
+ * @brief Returns the backends to be used by the I/O event loops.
+ *
+ * EPOLL used to be disabled, since it is significantly slower than poll for a
+ * few file descriptors (each watcher change costs an extra epoll_ctl syscall).
+ * That holds only for the local (library) mode, where just a handful of
+ * connections is served. In daemon mode each I/O loop serves a share of all
+ * client connections, where EPOLL scales much better than poll/select.
+ */
+static unsigned int
+cm_event_loop_backends(const cm_connection_mode_t mode)
+{
+    unsigned int backends = ev_recommended_backends();
+
+    if ((CM_MODE_LOCAL == mode) && (0 != (backends & ~EVBACKEND_EPOLL))) {
+        backends &= ~EVBACKEND_EPOLL;
+    }
+
+    return backends;
+}
+
+/**
+ * @brief Initializes an I/O loop.
+ */
+static int
+cm_io_loop_init(cm_ctx_t *cm_ctx, uint32_t index)
+{
+    cm_io_loop_t *io_loop = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(cm_ctx, cm_ctx->io_loops);
+
+    io_loop = &cm_ctx->io_loops[index];
+    io_loop->cm_ctx = cm_ctx;
+    io_loop->index = index;
+    pthread_mutex_init(&io_loop->queue_mutex, NULL);
+
+    /* initialize message and connection queues */
+    rc = sr_cbuff_init(CM_INIT_MSG_QUEUE_SIZE, sizeof(Sr__Msg*), &io_loop->msg_queue);
+    CHECK_RC_MSG_RETURN(rc, "CM message queue initialization failed.");
+    rc = sr_cbuff_init(CM_INIT_CONN_QUEUE_SIZE, sizeof(int), &io_loop->conn_queue);
+    CHECK_RC_MSG_RETURN(rc, "CM connection queue initialization failed.");
+
+    /* initialize event loop */
+    io_loop->event_loop = ev_loop_new(cm_event_loop_backends(cm_ctx->mode) | EVFLAG_NOENV);
+    if (NULL == io_loop->event_loop) {
+        SR_LOG_ERR("Cannot initialize the event loop %"PRIu32".", index);
+        return SR_ERR_INIT_FAILED;
+    }
+
+    /* initialize event watcher for async stop requests */
+    ev_async_init(&io_loop->stop_watcher, cm_stop_cb);
+    io_loop->stop_watcher.data = (void*)io_loop;
+    ev_async_start(io_loop->event_loop, &io_loop->stop_watcher);
+
+    /* initialize event watcher for message enqueue events */
+    ev_async_init(&io_loop->msg_queue_watcher, cm_msg_enqueue_cb);
+    io_loop->msg_queue_watcher.data = (void*)io_loop;
+    ev_async_start(io_loop->event_loop, &io_loop->msg_queue_watcher);
+
+    /* initialize event watcher for connection enqueue events */
+    ev_async_init(&io_loop->conn_queue_watcher, cm_conn_enqueue_cb);
+    io_loop->conn_queue_watcher.data = (void*)io_loop;
+    ev_async_start(io_loop->event_loop, &io_loop->conn_queue_watcher);
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Cleans up an I/O loop (its thread must not be running).
+ */
+static void
+cm_io_loop_cleanup(cm_io_loop_t *io_loop)
+{
+    Sr__Msg *msg = NULL;
+    cm_delayed_request_ctx_t *req = NULL, *tmp = NULL;
+    int fd = -1;
+
+    if (NULL == io_loop || NULL == io_loop->cm_ctx) {
+        return;
+    }
+
+    if (NULL != io_loop->event_loop) {
+        ev_loop_destroy(io_loop->event_loop);
+    }
+
+    if (NULL != io_loop->msg_queue) {
+        while (sr_cbuff_dequeue(io_loop->msg_queue, &msg)) {
+            sr_msg_free(msg);
+        }
+        sr_cbuff_cleanup(io_loop->msg_queue);
+    }
+    if (NULL != io_loop->conn_queue) {
+        while (sr_cbuff_dequeue(io_loop->conn_queue, &fd)) {
+            close(fd);
+        }
+        sr_cbuff_cleanup(io_loop->conn_queue);
+    }
+    pthread_mutex_destroy(&io_loop->queue_mutex);
+
+    tmp = io_loop->delayed_requests;
+    while (NULL != tmp) {
+        req = tmp;
+        tmp = tmp->next;
+        sr_msg_free(req->msg);
+        free(req);
+    }
+}
+
+/**
+ * @brief Executes an I/O loop in its own thread. Monitors connections served by
+ * the loop for events and calls proper callback handlers for each event.
+ */
+static void *
+cm_io_loop_threaded(void *io_loop_p)
+{
+    if (NULL == io_loop_p) {
+        return NULL;
+    }
+
+    cm_io_loop_t *io_loop = (cm_io_loop_t*)io_loop_p;
+
+    SR_LOG_DBG("Starting CM I/O loop %"PRIu32".", io_loop->index);
+
+    ev_run(io_loop->event_loop, 0);
+
+    SR_LOG_DBG("CM I/O loop %"PRIu32" finished.", io_loop->index);
+
+    return NULL;
+}
+
+/**
+ * @brief Stops threads of all I/O loops except of the loop 0.
+ */
+static void
+cm_io_loops_stop(cm_ctx_t *cm_ctx)
+{
+    CHECK_NULL_ARG_VOID(cm_ctx);
+
+    for (uint32_t i = 1; i < cm_ctx->io_loop_cnt; i++) {
+        if (cm_ctx->io_loops[i].running) {
+            ev_async_send(cm_ctx->io_loops[i].event_loop, &cm_ctx->io_loops[i].stop_watcher);
+            pthread_join(cm_ctx->io_loops[i].thread, NULL);
+            cm_ctx->io_loops[i].running = false;
+        }
+    }
+}
+
+/**
+ * @brief Starts threads of all I/O loops except of the loop 0, which is executed
+ * in Connection Manager's thread by ::cm_event_loop.
+ */
+static int
+cm_io_loops_start(cm_ctx_t *cm_ctx)
+{
+    int ret = 0;
+
+    CHECK_NULL_ARG(cm_ctx);
+
+    for (uint32_t i = 1; i < cm_ctx->io_loop_cnt; i++) {
+        ret = pthread_create(&cm_ctx->io_loops[i].thread, NULL, cm_io_loop_threaded, &cm_ctx->io_loops[i]);
+        if (0 != ret) {
+            SR_LOG_ERR("Error by creating a new thread: %s", sr_strerror_safe(ret));
+            cm_io_loops_stop(cm_ctx);
+            return SR_ERR_INTERNAL;
+        }
+        cm_ctx->io_loops[i].running = true;
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Event loop of Connection Manager. Monitors the server socket and connections
+ * served by the I/O loop 0 for events and calls proper callback handlers for each event.
+ * This function call blocks until stop is requested via async stop request, then it
+ * stops the other I/O loops as well.
  */
 static void
 cm_event_loop(cm_ctx_t *cm_ctx)
@@ -1793,7 +2335,9 @@ cm_event_loop(cm_ctx_t *cm_ctx)
 
     SR_LOG_DBG_MSG("Starting CM event loop.");
 
-    ev_run(cm_ctx->event_loop, 0);
+    ev_run(cm_ctx->io_loops[0].event_loop, 0);
+
+    cm_io_loops_stop(cm_ctx);
 
     SR_LOG_DBG_MSG("CM event loop finished.");
 }
@@ -1819,6 +2363,7 @@ int
 cm_init(const cm_connection_mode_t mode, const char *socket_path, cm_ctx_t **cm_ctx_p)
 {
     cm_ctx_t *ctx = NULL;
+    uint32_t io_loop_cnt = 0;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG2(socket_path, cm_ctx_p);
@@ -1832,17 +2377,26 @@ cm_init(const cm_connection_mode_t mode, const char *socket_path, cm_ctx_t **cm_
         goto cleanup;
     }
     ctx->mode = mode;
+    ctx->listen_socket_fd = -1;
 
-    /* initialize message queue */
-    pthread_mutex_init(&ctx->msg_queue_mutex, NULL);
-    rc = sr_cbuff_init(CM_INIT_MSG_QUEUE_SIZE, sizeof(Sr__Msg*), &ctx->msg_queue);
-    if (SR_ERR_OK != rc){
-        SR_LOG_ERR_MSG("CM message queue initialization failed.");
-        goto cleanup;
+    /* initialize I/O loops */
+    io_loop_cnt = cm_get_io_loop_count(mode);
+    ctx->io_loops = calloc(io_loop_cnt, sizeof(*ctx->io_loops));
+    CHECK_NULL_NOMEM_GOTO(ctx->io_loops, rc, cleanup);
+    ctx->io_loop_cnt = io_loop_cnt;
+
+    SR_LOG_DBG("Connection Manager will use %"PRIu32" I/O loops.", io_loop_cnt);
+
+    for (uint32_t i = 0; i < io_loop_cnt; i++) {
+        rc = cm_io_loop_init(ctx, i);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Cannot initialize the I/O loop %"PRIu32".", i);
+            goto cleanup;
+        }
     }
 
     /* initialize Session Manager */
-    rc = sm_init(cm_session_data_cleanup, cm_connection_data_cleanup, &ctx->sm_ctx);
+    rc = sm_init(cm_session_data_cleanup, cm_connection_data_cleanup, io_loop_cnt, &ctx->sm_ctx);
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR_MSG("Cannot initialize Session Manager.");
         goto cleanup;
@@ -1855,25 +2409,10 @@ cm_init(const cm_connection_mode_t mode, const char *socket_path, cm_ctx_t **cm_
         goto cleanup;
     }
 
-    /* initialize event loop */
-    /* According to our measurements, EPOLL backend is significantly slower for
-     * fewer file descriptors, so we are disabling it for now. */
-    ctx->event_loop = ev_loop_new((EVBACKEND_ALL ^ EVBACKEND_EPOLL) | EVFLAG_NOENV);
-
-    /* initialize event watcher for unix-domain server socket */
+    /* initialize event watcher for unix-domain server socket (in the I/O loop 0) */
     ev_io_init(&ctx->server_watcher, cm_server_watcher_cb, ctx->listen_socket_fd, EV_READ);
     ctx->server_watcher.data = (void*)ctx;
-    ev_io_start(ctx->event_loop, &ctx->server_watcher);
-
-    /* initialize event watcher for async stop requests */
-    ev_async_init(&ctx->stop_watcher, cm_stop_cb);
-    ctx->stop_watcher.data = (void*)ctx;
-    ev_async_start(ctx->event_loop, &ctx->stop_watcher);
-
-    /* initialize event watcher for message enqueue events */
-    ev_async_init(&ctx->msg_queue_watcher, cm_msg_enqueue_cb);
-    ctx->msg_queue_watcher.data = (void*)ctx;
-    ev_async_start(ctx->event_loop, &ctx->msg_queue_watcher);
+    ev_io_start(ctx->io_loops[0].event_loop, &ctx->server_watcher);
 
     /* initialize Request Processor */
     rc = rp_init(ctx, &ctx->rp_ctx);
@@ -1897,8 +2436,6 @@ cm_cleanup(cm_ctx_t *cm_ctx)
 {
     size_t i = 0;
     sm_session_t *session = NULL;
-    Sr__Msg *msg = NULL;
-    cm_delayed_request_ctx_t *req = NULL, *tmp = NULL;
     int rc = SR_ERR_OK;
 
     if (NULL != cm_ctx) {
@@ -1913,22 +2450,13 @@ cm_cleanup(cm_ctx_t *cm_ctx)
         rp_cleanup(cm_ctx->rp_ctx);
         sm_cleanup(cm_ctx->sm_ctx);
 
-        ev_loop_destroy(cm_ctx->event_loop);
-        cm_server_cleanup(cm_ctx);
-
-        while (sr_cbuff_dequeue(cm_ctx->msg_queue, &msg)) {
-            sr_msg_free(msg);
-        }
-        sr_cbuff_cleanup(cm_ctx->msg_queue);
-        pthread_mutex_destroy(&cm_ctx->msg_queue_mutex);
-
-        tmp = cm_ctx->delayed_requests;
-        while (NULL != tmp) {
-            req = tmp;
-            tmp = tmp->next;
-            sr_msg_free(req->msg);
-            free(req);
+        if (NULL != cm_ctx->io_loops) {
+            for (uint32_t j = 0; j < cm_ctx->io_loop_cnt; j++) {
+                cm_io_loop_cleanup(&cm_ctx->io_loops[j]);
+            }
+            free(cm_ctx->io_loops);
         }
+        cm_server_cleanup(cm_ctx);
 
         free(cm_ctx);
     }
@@ -1942,6 +2470,10 @@ cm_start(cm_ctx_t *cm_ctx)
 
     CHECK_NULL_ARG(cm_ctx);
 
+    /* start the I/O loops running in their own threads */
+    rc = cm_io_loops_start(cm_ctx);
+    CHECK_RC_MSG_RETURN(rc, "Cannot start Connection Manager I/O loops.");
+
     if (CM_MODE_DAEMON == cm_ctx->mode) {
         /* run the event loop in this thread */
         cm_event_loop(cm_ctx);
@@ -1951,6 +2483,7 @@ cm_start(cm_ctx_t *cm_ctx)
                 cm_event_loop_threaded, cm_ctx);
         if (0 != rc) {
             SR_LOG_ERR("Error by creating a new thread: %s", sr_strerror_safe(errno));
+            cm_io_loops_stop(cm_ctx);
             rc = SR_ERR_INTERNAL;
         }
     }
@@ -1965,8 +2498,8 @@ cm_stop(cm_ctx_t *cm_ctx)
 
     SR_LOG_INF_MSG("Connection Manager stop requested.");
 
-    /* send async event to the event loop */
-    ev_async_send(cm_ctx->event_loop, &cm_ctx->stop_watcher);
+    /* send async event to the event loop, it stops the other I/O loops afterwards */
+    ev_async_send(cm_ctx->io_loops[0].event_loop, &cm_ctx->io_loops[0].stop_watcher);
 
     if (CM_MODE_LOCAL == cm_ctx->mode) {
         /* block until cleanup is finished and the thread with event loop exits */
@@ -1979,6 +2512,7 @@ cm_stop(cm_ctx_t *cm_ctx)
 int
 cm_msg_send(cm_ctx_t *cm_ctx, Sr__Msg *msg)
 {
+    cm_io_loop_t *io_loop = NULL;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG_NORET2(rc, cm_ctx, msg);
@@ -1990,13 +2524,16 @@ cm_msg_send(cm_ctx_t *cm_ctx, Sr__Msg *msg)
         return rc;
     }
 
-    pthread_mutex_lock(&cm_ctx->msg_queue_mutex);
-    rc = sr_cbuff_enqueue(cm_ctx->msg_queue, &msg);
-    pthread_mutex_unlock(&cm_ctx->msg_queue_mutex);
+    /* the message is processed by the I/O loop serving the session (messages without a session by the loop 0) */
+    io_loop = &cm_ctx->io_loops[sm_session_io_loop(cm_ctx->sm_ctx, msg->session_id)];
+
+    pthread_mutex_lock(&io_loop->queue_mutex);
+    rc = sr_cbuff_enqueue(io_loop->msg_queue, &msg);
+    pthread_mutex_unlock(&io_loop->queue_mutex);
 
     if (SR_ERR_OK == rc) {
         /* send async event to the event loop */
-        ev_async_send(cm_ctx->event_loop, &cm_ctx->msg_queue_watcher);
+        ev_async_send(io_loop->event_loop, &io_loop->msg_queue_watcher);
     } else {
         /* release the message by error */
         SR_LOG_ERR_MSG("Unable to send the message, skipping.");
@@ -2017,7 +2554,7 @@ cm_watch_signal(cm_ctx_t *cm_ctx, int signum, cm_signal_cb callback)
             cm_ctx->signal_callbacks[i] = callback;
             ev_signal_init(&cm_ctx->signal_watchers[i], cm_signal_cb_internal, signum);
             cm_ctx->signal_watchers[i].data = (void*)cm_ctx;
-            ev_signal_start(cm_ctx->event_loop, &cm_ctx->signal_watchers[i]);
+            ev_signal_start(cm_ctx->io_loops[0].event_loop, &cm_ctx->signal_watchers[i]);
             return SR_ERR_OK;
         }
     }
@@ -40,6 +40,12 @@
  * the main thread in daemon mode (making the main thread blocked until stop
  * is requested by ::cm_stop), whereas in local (library( mode the event loop
  * runs in a new dedicated thread (to not block caller thread).
+ *
+ * Connections can be served by multiple I/O loops, each running in its own
+ * thread (4 in daemon mode and 1 in local mode by default, configurable by
+ * SR_CM_IO_LOOP_COUNT_ENV). Accepted connections are distributed across
+ * the I/O loops in round-robin fashion, a session is always served by the I/O
+ * loop of its connection.
  */
 
 #include "sysrepo.pb-c.h"
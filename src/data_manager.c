@@ -43,16 +43,82 @@
 #include "rp_dt_edit.h"
 #include "module_dependencies.h"
 #include "nacm.h"
+#include "dm_journal.h"
+
+/** @brief Maximal number of temporary libyang contexts held in the pool */
+#define DM_TMP_LY_CTX_POOL_SIZE 4
+
+/** @brief Signature of a temporary libyang context where the modules are loaded on demand by ::dm_module_clb */
+#define DM_TMP_LY_CTX_ON_DEMAND "*"
+
+/**
+ * @brief Pool of temporary libyang contexts. The contexts are cached by the set of loaded
+ * modules, so that the schemas are parsed only once. If there is no idle context with the requested
+ * set of modules and the pool is full, the least recently used idle context is rebuilt.
+ */
+typedef struct dm_tmp_ly_ctx_pool_s {
+    dm_tmp_ly_ctx_t *ctxs[DM_TMP_LY_CTX_POOL_SIZE];  /**< contexts in the pool */
+    size_t count;                 /**< number of contexts in the pool */
+    uint64_t usage_counter;       /**< counter incremented with each acquisition, used for LRU eviction */
+    uint32_t generation;          /**< incremented when the schemas change, contexts built in older generation are not reused */
+    pthread_mutex_t mutex;        /**< mutex guarding the pool */
+    pthread_cond_t cond;          /**< condition signaled when a context is released */
+} dm_tmp_ly_ctx_pool_t;
+
+/**
+ * @brief Immutable data tree loaded from the data file of running or startup datastore.
+ * Snapshot is shared by all sessions that read the data tree, a session makes its private copy
+ * only before the data tree is modified (see ::dm_data_info_make_private). Commit swaps in a new
+ * snapshot, the replaced one is freed once it is no longer referenced.
+ */
+typedef struct dm_data_snapshot_s {
+    dm_schema_info_t *schema;     /**< schema info the data tree belongs to */
+    sr_datastore_t ds;            /**< datastore of the data file */
+    struct lyd_node *node;        /**< data tree, must not be modified */
+    struct timespec timestamp;    /**< mtime of the data file corresponding to the data tree */
+    uint64_t journal_seq;         /**< journal sequence number corresponding to the data tree (if commits are journaled) */
+    size_t ref_count;             /**< number of data infos referencing the snapshot (+1 while cached) */
+    pthread_mutex_t *lock;        /**< lock guarding ref_count (the lock of the snapshot cache) */
+} dm_data_snapshot_t;
 
 /**
- * @brief Structure holding an instance of temporary libyang context that can be used
- * for validation or parsing
+ * @brief Commit journal of a module in running or startup datastore (see ::dm_journal_t).
  */
-typedef struct dm_tmp_ly_ctx_s {
-    pthread_mutex_t mutex;
-    struct ly_ctx *ctx;
-    sr_list_t *loaded_modules;
-} dm_tmp_ly_ctx_t;
+typedef struct dm_module_journal_s {
+    char *module_name;            /**< module the journal belongs to */
+    sr_datastore_t ds;            /**< datastore of the journal */
+    dm_journal_t *journal;        /**< the journal */
+} dm_module_journal_t;
+
+/**
+ * @brief Set of independent jobs executed by the work pool.
+ */
+typedef struct dm_work_batch_s {
+    void (*execute)(void *job);   /**< function executing one job */
+    char *jobs;                   /**< array of jobs */
+    size_t job_size;              /**< size of one job in the array */
+    size_t count;                 /**< number of jobs */
+    size_t next;                  /**< index of the next job to be picked up */
+    size_t done;                  /**< number of finished jobs */
+} dm_work_batch_t;
+
+/**
+ * @brief Pool of threads executing per-module parts of commits that do not depend on each other
+ * (validation of modules without data dependencies, printing and fsync of data files). The pool executes
+ * one batch at a time, the thread that submitted the batch takes part in the execution. The worker threads
+ * are started with the first batch, processes that never commit more than one module do not start them.
+ */
+typedef struct dm_work_pool_s {
+    pthread_t *threads;           /**< worker threads */
+    size_t max_threads;           /**< number of worker threads to be started, 0 if all jobs are executed by the submitting thread */
+    size_t thread_count;          /**< number of started worker threads */
+    dm_work_batch_t *batch;       /**< batch being executed, NULL if the pool is idle */
+    bool initialized;             /**< flag whether the synchronization primitives have been initialized */
+    bool stop;                    /**< flag requesting the worker threads to stop */
+    pthread_mutex_t mutex;        /**< mutex guarding the pool and the batch */
+    pthread_cond_t cond;          /**< condition signaled when a batch is submitted or the pool should stop */
+    pthread_cond_t done_cond;     /**< condition signaled when the last job of the batch finishes */
+} dm_work_pool_t;
 
 /**
  * @brief Data manager context holding loaded schemas, data trees
@@ -72,10 +138,29 @@ typedef struct dm_ctx_s {
     pthread_mutex_t ds_lock_mutex;/**< Data store lock mutex */
     sr_btree_t *schema_info_tree; /**< Binary tree holding information about schemas */
     pthread_rwlock_t schema_tree_lock;  /**< rwlock for access schema_info_tree */
+    struct ly_ctx *shared_ly_ctx; /**< Context shared by all installed modules, NULL if each module has its own context */
+    dm_tmp_ly_ctx_t shared_tmp_ly_ctx;  /**< Stands in for the temporary contexts if the context is shared (wraps shared_ly_ctx) */
+    pthread_rwlock_t shared_ly_ctx_lock;  /**< rwlock for shared_ly_ctx, read-locked while it is used as temporary context,
+                                   * write-locked while it is modified */
     dm_commit_ctxs_t commit_ctxs; /**< Structure holding commit contexts and corresponding lock */
     struct timespec last_commit_time;  /**< Time of the last commit */
-    dm_tmp_ly_ctx_t *tmp_ly_ctx;  /**< Structure wrapping libyang context that is used to validate/print/parse date
+    dm_tmp_ly_ctx_pool_t tmp_ly_ctx_pool;  /**< Pool of libyang contexts that are used to validate/print/parse data
                                    * where the set of required yang module can vary */
+    sr_btree_t *snapshot_cache;   /**< Binary tree holding shared snapshots of running and startup data trees */
+    pthread_mutex_t snapshot_cache_lock;  /**< mutex guarding snapshot_cache and reference counts of the snapshots */
+    bool binary_data_files;       /**< Flag whether the data files of this repository are written in the binary format */
+    bool full_validation;         /**< Flag whether whole data trees are validated instead of only the modified subtrees */
+    bool journal_commits;         /**< Flag whether the commits into startup and running are appended to the journals of the modules
+                                   * instead of rewriting the data files */
+    sr_btree_t *journals;         /**< Binary tree holding the commit journals of the modules (opened on the first access) */
+    pthread_mutex_t journals_lock;  /**< mutex guarding journals */
+    pthread_t checkpoint_thread;  /**< Thread folding the journal records into the data files */
+    bool checkpoint_thread_running;  /**< Flag whether the checkpoint thread has been started */
+    bool checkpoint_stop;         /**< Flag requesting the checkpoint thread to stop */
+    bool checkpoint_requested;    /**< Flag requesting an immediate checkpoint */
+    pthread_mutex_t checkpoint_mutex;  /**< Mutex guarding the checkpoint flags */
+    pthread_cond_t checkpoint_cond;    /**< Condition signaled when a checkpoint is requested or the thread should stop */
+    dm_work_pool_t work_pool;     /**< Pool of threads processing independent modules of a commit in parallel */
 
 } dm_ctx_t;
 
@@ -132,6 +217,18 @@ typedef enum dm_procedure_e {
  */
 #define NANOSEC_THRESHOLD 10000000
 
+/** @brief Interval (in seconds) between two checkpoints of the commit journal. */
+#define DM_JOURNAL_CHECKPOINT_INTERVAL 60
+
+/** @brief Size of the commit journal (in bytes) that triggers an immediate checkpoint. */
+#define DM_JOURNAL_CHECKPOINT_SIZE (1024 * 1024)
+
+/** @brief Default number of worker threads processing independent modules of a commit. */
+#define DM_WORK_THREAD_COUNT 4
+
+/** @brief Maximum number of worker threads processing independent modules of a commit. */
+#define DM_WORK_THREAD_COUNT_MAX 64
+
 /**
  * @brief Maximum number of seconds that function will wait for ongoing commit
  * to finish when the cleanup was requested.
@@ -222,6 +319,68 @@ dm_module_difflist_cmp(const void *a, const void *b)
     }
 }
 
+/**
+ * @brief Compares two data snapshots by module name and datastore
+ */
+static int
+dm_data_snapshot_cmp(const void *a, const void *b)
+{
+    assert(a);
+    assert(b);
+    dm_data_snapshot_t *snap_a = (dm_data_snapshot_t *) a;
+    dm_data_snapshot_t *snap_b = (dm_data_snapshot_t *) b;
+
+    int res = strcmp(snap_a->schema->module_name, snap_b->schema->module_name);
+    if (0 == res) {
+        res = (int) snap_a->ds - (int) snap_b->ds;
+    }
+    if (res == 0) {
+        return 0;
+    } else if (res < 0) {
+        return -1;
+    } else {
+        return 1;
+    }
+}
+
+/**
+ * @brief Compares two module journals by module name and datastore
+ */
+static int
+dm_module_journal_cmp(const void *a, const void *b)
+{
+    assert(a);
+    assert(b);
+    dm_module_journal_t *mj_a = (dm_module_journal_t *) a;
+    dm_module_journal_t *mj_b = (dm_module_journal_t *) b;
+
+    int res = strcmp(mj_a->module_name, mj_b->module_name);
+    if (0 == res) {
+        res = (int) mj_a->ds - (int) mj_b->ds;
+    }
+    if (res == 0) {
+        return 0;
+    } else if (res < 0) {
+        return -1;
+    } else {
+        return 1;
+    }
+}
+
+/**
+ * @brief Frees the module journal
+ */
+static void
+dm_module_journal_free(void *module_journal)
+{
+    dm_module_journal_t *mj = (dm_module_journal_t *) module_journal;
+    if (NULL != mj) {
+        dm_journal_cleanup(mj->journal);
+        free(mj->module_name);
+        free(mj);
+    }
+}
+
 /**
  * @brief Compares two commit context by id
  */
@@ -270,6 +429,21 @@ dm_set_node_xpath_hash(struct lys_node *node, uint32_t hash)
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Frees the dependencies among the top-level subtrees of a module.
+ * @param [in] deps
+ */
+static void
+dm_subtree_deps_free(dm_subtree_deps_t *deps)
+{
+    if (NULL != deps) {
+        free(deps->nodes);
+        free(deps->refs_any);
+        free(deps->refs);
+        free(deps);
+    }
+}
+
 /**
  * @brief Sets the depth of any potential instance of the given schema node.
  */
@@ -300,13 +474,78 @@ dm_free_schema_info(void *schema_info)
     dm_schema_info_t *si = (dm_schema_info_t *) schema_info;
     free(si->module_name);
     pthread_rwlock_destroy(&si->model_lock);
+    pthread_rwlock_destroy(&si->commit_lock);
     pthread_mutex_destroy(&si->usage_count_mutex);
-    if (NULL != si->ly_ctx) {
+    dm_subtree_deps_free(si->subtree_deps);
+    if (NULL != si->ly_ctx && !si->shared_ly_ctx) {
         ly_ctx_destroy(si->ly_ctx, dm_free_lys_private_data);
     }
     free(si);
 }
 
+/**
+ * @brief Drops one reference of the snapshot, frees the snapshot if it is not referenced anymore.
+ * Used also as free callback of the snapshot cache.
+ *
+ * @note Function expects that the snapshot cache lock is held.
+ */
+static void
+dm_data_snapshot_release_locked(void *item)
+{
+    dm_data_snapshot_t *snapshot = (dm_data_snapshot_t *) item;
+    if (NULL == snapshot) {
+        return;
+    }
+    if (0 != --snapshot->ref_count) {
+        return;
+    }
+    lyd_free_withsiblings(snapshot->node);
+    /* decrement the number of usage of the module */
+    pthread_mutex_lock(&snapshot->schema->usage_count_mutex);
+    snapshot->schema->usage_count--;
+    SR_LOG_DBG("Usage count %s decremented (value=%zu)", snapshot->schema->module_name, snapshot->schema->usage_count);
+    pthread_mutex_unlock(&snapshot->schema->usage_count_mutex);
+    free(snapshot);
+}
+
+/**
+ * @brief Drops one reference of the snapshot.
+ */
+static void
+dm_data_snapshot_release(dm_data_snapshot_t *snapshot)
+{
+    if (NULL == snapshot) {
+        return;
+    }
+    pthread_mutex_t *lock = snapshot->lock;
+    pthread_mutex_lock(lock);
+    dm_data_snapshot_release_locked(snapshot);
+    pthread_mutex_unlock(lock);
+}
+
+/**
+ * @brief Releases cached snapshots of the module. Snapshots that are still referenced
+ * by a session are freed when the last reference is dropped.
+ */
+static void
+dm_data_snapshot_invalidate(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info)
+{
+    CHECK_NULL_ARG_VOID2(dm_ctx, schema_info);
+    dm_data_snapshot_t lookup = {0}, *snap = NULL;
+    sr_datastore_t ds[] = {SR_DS_STARTUP, SR_DS_RUNNING};
+
+    lookup.schema = schema_info;
+    pthread_mutex_lock(&dm_ctx->snapshot_cache_lock);
+    for (size_t i = 0; i < sizeof(ds) / sizeof(*ds); i++) {
+        lookup.ds = ds[i];
+        snap = sr_btree_search(dm_ctx->snapshot_cache, &lookup);
+        if (NULL != snap) {
+            sr_btree_delete(dm_ctx->snapshot_cache, snap);
+        }
+    }
+    pthread_mutex_unlock(&dm_ctx->snapshot_cache_lock);
+}
+
 /**
  * @brief frees the dm_data_info stored in binary tree
  */
@@ -315,7 +554,10 @@ dm_data_info_free(void *item)
 {
     dm_data_info_t *info = (dm_data_info_t *) item;
     if (NULL != info && !info->rdonly_copy) {
-        lyd_free_withsiblings(info->node);
+        if (!info->shared) {
+            lyd_free_withsiblings(info->node);
+        }
+        dm_data_snapshot_release(info->snapshot);
         sr_free_list_of_strings(info->required_modules);
         /* decrement the number of usage of the module */
         pthread_mutex_lock(&info->schema->usage_count_mutex);
@@ -323,6 +565,9 @@ dm_data_info_free(void *item)
         SR_LOG_DBG("Usage count %s decremented (value=%zu)", info->schema->module_name, info->schema->usage_count);
         pthread_mutex_unlock(&info->schema->usage_count_mutex);
     }
+    if (NULL != info) {
+        sr_free_list_of_strings(info->modified_subtrees);
+    }
     free(info);
 }
 
@@ -333,6 +578,8 @@ dm_model_subscription_free(void *sub)
     if (NULL != ms) {
         np_subscriptions_list_cleanup(ms->subscriptions);
         free(ms->nodes);
+        sr_btree_cleanup(ms->node_index);
+        free(ms->matched);
         lyd_free_diff(ms->difflist);
         if (NULL != ms->changes) {
             for (int i = 0; i < ms->changes->count; i++) {
@@ -481,185 +728,576 @@ static void
 dm_free_tmp_ly_ctx(dm_tmp_ly_ctx_t *ctx)
 {
     if (NULL != ctx) {
-        pthread_mutex_destroy(&ctx->mutex);
-        sr_free_list_of_strings(ctx->loaded_modules);
-        ly_ctx_destroy(ctx->ctx, NULL);
+        free(ctx->signature);
+        if (NULL != ctx->ctx) {
+            ly_ctx_destroy(ctx->ctx, NULL);
+        }
         free(ctx);
     }
 }
 
+/**
+ * @brief Compares two module names, used to sort the set of modules.
+ */
+static int
+dm_module_name_cmp(const void *a, const void *b)
+{
+    assert(a);
+    assert(b);
+    return strcmp(*(const char **) a, *(const char **) b);
+}
 
 /**
- * @brief Acquires temporary libyang context, that can be used to parse/validate/print data that
- * requires schemas different from installation time dependencies.
- * @param [in] dm_ctx
- * @param [in] models_to_be_loaded - list of modules that should be loaded into temporary context
- * @param [out] tmp_ctx - acquired context. Once the context is no more needed it should be released
- * using ::dm_release_tmp_ly_ctx
+ * @brief Creates the signature of the set of modules that identifies temporary libyang context
+ * where the modules are loaded.
+ * @param [in] models_to_be_loaded - list of module names, NULL if the modules are loaded on demand
+ * @param [out] signature_p
  * @return Error code (SR_ERR_OK on success)
  */
 static int
-dm_get_tmp_ly_ctx(dm_ctx_t *dm_ctx, sr_list_t *models_to_be_loaded, dm_tmp_ly_ctx_t **tmp_ctx)
+dm_tmp_ly_ctx_signature(sr_list_t *models_to_be_loaded, char **signature_p)
 {
-    CHECK_NULL_ARG2(dm_ctx, tmp_ctx);
+    CHECK_NULL_ARG(signature_p);
     int rc = SR_ERR_OK;
-    dm_tmp_ly_ctx_t *t_ctx = NULL;
-    char *module_name = NULL;
-    md_module_t *module = NULL;
-    bool locked = false;
-    const struct lys_module *ly_module = NULL;
-
-    /* dequeue reusable structure */
-    //TODO: implement as queue that is capable to hold multiple tmp_ctx_s
-    t_ctx = dm_ctx->tmp_ly_ctx;
-
-    /* acquire mutex */
-    MUTEX_LOCK_TIMED_CHECK_RETURN(&t_ctx->mutex);
-
-    /* load requested modules */
-    if (NULL != models_to_be_loaded) {
-        md_ctx_lock(dm_ctx->md_ctx, false);
-        locked = true;
-        for (size_t i = 0; i < models_to_be_loaded->count; i++) {
-            module_name = (char *) models_to_be_loaded->data[i];
-            rc = md_get_module_info(dm_ctx->md_ctx, module_name, NULL, &module);
-            CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to get md_get_info for %s", module_name);
+    const char **names = NULL;
+    char *signature = NULL;
+    size_t len = 1;
 
-            ly_module = lys_parse_path(t_ctx->ctx, module->filepath, LYS_IN_YANG);
-            if (NULL == ly_module) {
-                SR_LOG_ERR("Failed to load module %s", module_name);
-                rc = SR_ERR_INTERNAL;
-                goto cleanup;
-            }
-            /* enable requested features */
-            rc = dm_enable_features_in_tmp_module(dm_ctx, module, ly_module);
-            CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to enable features in module %s", module_name);
-        }
+    if (NULL == models_to_be_loaded) {
+        *signature_p = strdup(DM_TMP_LY_CTX_ON_DEMAND);
+        CHECK_NULL_NOMEM_RETURN(*signature_p);
+        return SR_ERR_OK;
+    }
 
+    if (models_to_be_loaded->count > 0) {
+        /* the order of the modules does not matter */
+        names = calloc(models_to_be_loaded->count, sizeof(*names));
+        CHECK_NULL_NOMEM_RETURN(names);
+        memcpy(names, models_to_be_loaded->data, models_to_be_loaded->count * sizeof(*names));
+        qsort(names, models_to_be_loaded->count, sizeof(*names), dm_module_name_cmp);
     }
-cleanup:
-    if (locked) {
-        md_ctx_unlock(dm_ctx->md_ctx);
+
+    for (size_t i = 0; i < models_to_be_loaded->count; i++) {
+        len += strlen(names[i]) + 1 /* separator */;
     }
-    if (SR_ERR_OK == rc)  {
-        *tmp_ctx = t_ctx;
-    } else {
-        pthread_mutex_unlock(&t_ctx->mutex);
+    signature = calloc(len, sizeof(*signature));
+    CHECK_NULL_NOMEM_GOTO(signature, rc, cleanup);
+
+    for (size_t i = 0; i < models_to_be_loaded->count; i++) {
+        strcat(signature, names[i]);
+        strcat(signature, ";");
     }
+    *signature_p = signature;
 
+cleanup:
+    free(names);
     return rc;
-
 }
 
 /**
- * @brief Releases the previously acquired tmp ly_ctx.
+ * @brief Loads the modules into the empty temporary libyang context.
  * @param [in] dm_ctx
- * @param [in] tmp_ctx
+ * @param [in] t_ctx
+ * @param [in] models_to_be_loaded - list of modules that should be loaded into temporary context
  * @return Error code (SR_ERR_OK on success)
  */
 static int
-dm_release_tmp_ly_ctx(dm_ctx_t *dm_ctx, dm_tmp_ly_ctx_t *tmp_ctx)
+dm_tmp_ly_ctx_load_modules(dm_ctx_t *dm_ctx, dm_tmp_ly_ctx_t *t_ctx, sr_list_t *models_to_be_loaded)
 {
-    CHECK_NULL_ARG2(dm_ctx, tmp_ctx);
+    CHECK_NULL_ARG3(dm_ctx, t_ctx, models_to_be_loaded);
     int rc = SR_ERR_OK;
-    uint32_t idx = 0;
-    const struct lys_module *module = NULL;
+    char *module_name = NULL;
+    md_module_t *module = NULL;
+    const struct lys_module *ly_module = NULL;
 
-    /* disable all modules */
-    while (NULL == (module = ly_ctx_get_module_iter(tmp_ctx->ctx, &idx))) {
-        lys_set_disabled(module);
+    md_ctx_lock(dm_ctx->md_ctx, false);
+    for (size_t i = 0; i < models_to_be_loaded->count; i++) {
+        module_name = (char *) models_to_be_loaded->data[i];
+        rc = md_get_module_info(dm_ctx->md_ctx, module_name, NULL, &module);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to get md_get_info for %s", module_name);
+
+        ly_module = lys_parse_path(t_ctx->ctx, module->filepath, LYS_IN_YANG);
+        if (NULL == ly_module) {
+            SR_LOG_ERR("Failed to load module %s", module_name);
+            rc = SR_ERR_INTERNAL;
+            goto cleanup;
+        }
+        /* enable requested features */
+        rc = dm_enable_features_in_tmp_module(dm_ctx, module, ly_module);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to enable features in module %s", module_name);
     }
 
-    ly_ctx_set_module_data_clb(tmp_ctx->ctx, NULL, NULL);
-    pthread_mutex_unlock(&tmp_ctx->mutex);
-
+cleanup:
+    md_ctx_unlock(dm_ctx->md_ctx);
     return rc;
 }
 
-static int
-dm_schema_info_init(const char *schema_search_dir, dm_schema_info_t **schema_info)
+int
+dm_release_tmp_ly_ctx(dm_ctx_t *dm_ctx, dm_tmp_ly_ctx_t *tmp_ctx)
 {
-    CHECK_NULL_ARG2(schema_search_dir, schema_info);
-    int rc = SR_ERR_OK;
-    dm_schema_info_t *si = NULL;
+    CHECK_NULL_ARG2(dm_ctx, tmp_ctx);
+    dm_tmp_ly_ctx_pool_t *pool = &dm_ctx->tmp_ly_ctx_pool;
 
-    si = calloc(1, sizeof(*si));
-    CHECK_NULL_NOMEM_RETURN(si);
+    if (tmp_ctx == &dm_ctx->shared_tmp_ly_ctx) {
+        /* shared context is not part of the pool */
+        pthread_rwlock_unlock(&dm_ctx->shared_ly_ctx_lock);
+        return SR_ERR_OK;
+    }
 
-    si->ly_ctx = ly_ctx_new(schema_search_dir);
-    CHECK_NULL_NOMEM_GOTO(si->ly_ctx, rc, cleanup);
+    if (NULL != tmp_ctx->ctx) {
+        ly_ctx_set_module_data_clb(tmp_ctx->ctx, NULL, NULL);
+    }
 
-    pthread_rwlock_init(&si->model_lock, NULL);
-    pthread_mutex_init(&si->usage_count_mutex, NULL);
+    pthread_mutex_lock(&pool->mutex);
+    tmp_ctx->in_use = false;
+    pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
 
-cleanup:
-    if (SR_ERR_OK != rc) {
-        free(si);
-    } else {
-        *schema_info = si;
-    }
-    return rc;
+    return SR_ERR_OK;
 }
 
-/**
- * @brief Creates the copy of dm_data_info structure and inserts it into binary tree
- * @param [in] tree
- * @param [in] di
- * @return Error code (SR_ERR_OK on success)
- */
-static int
-dm_insert_data_info_copy(sr_btree_t *tree, const dm_data_info_t *di)
+int
+dm_get_tmp_ly_ctx(dm_ctx_t *dm_ctx, sr_list_t *models_to_be_loaded, dm_tmp_ly_ctx_t **tmp_ctx)
 {
-    CHECK_NULL_ARG2(tree, di);
+    CHECK_NULL_ARG2(dm_ctx, tmp_ctx);
     int rc = SR_ERR_OK;
-    dm_data_info_t *copy = NULL;
-    copy = calloc (1, sizeof(*copy));
-    CHECK_NULL_NOMEM_RETURN(copy);
+    dm_tmp_ly_ctx_pool_t *pool = &dm_ctx->tmp_ly_ctx_pool;
+    dm_tmp_ly_ctx_t *t_ctx = NULL, *lru = NULL, *iter = NULL;
+    char *signature = NULL;
+    uint32_t generation = 0;
+    struct timespec ts = { 0, };
+    int ret = 0;
 
-    if (NULL != di->node) {
-        copy->node = sr_dup_datatree(di->node);
-        CHECK_NULL_NOMEM_GOTO(copy->node, rc, cleanup);
+    if (NULL != dm_ctx->shared_ly_ctx) {
+        RWLOCK_RDLOCK_TIMED_CHECK_RETURN(&dm_ctx->shared_ly_ctx_lock);
+        *tmp_ctx = &dm_ctx->shared_tmp_ly_ctx;
+        return SR_ERR_OK;
     }
 
-    pthread_mutex_lock(&di->schema->usage_count_mutex);
-    di->schema->usage_count++;
-    SR_LOG_DBG("Usage count %s incremented (value=%zu)", di->schema->module_name, di->schema->usage_count);
-    pthread_mutex_unlock(&di->schema->usage_count_mutex);
-    copy->schema = di->schema;
-    copy->timestamp = di->timestamp;
+    rc = dm_tmp_ly_ctx_signature(models_to_be_loaded, &signature);
+    CHECK_RC_MSG_RETURN(rc, "Failed to create signature of the set of modules");
+
+    sr_clock_get_time(CLOCK_REALTIME, &ts);
+    ts.tv_sec += MUTEX_WAIT_TIME;
+
+    MUTEX_LOCK_TIMED_CHECK_GOTO(&pool->mutex, rc, cleanup);
+    while (NULL == t_ctx) {
+        lru = NULL;
+        for (size_t i = 0; i < pool->count; i++) {
+            iter = pool->ctxs[i];
+            if (iter->in_use) {
+                continue;
+            }
+            if (NULL != iter->signature && iter->generation == pool->generation && 0 == strcmp(iter->signature, signature)) {
+                t_ctx = iter;
+                break;
+            }
+            if (NULL == lru || iter->last_used < lru->last_used) {
+                lru = iter;
+            }
+        }
+        if (NULL == t_ctx && pool->count < DM_TMP_LY_CTX_POOL_SIZE) {
+            /* add new context into the pool */
+            t_ctx = calloc(1, sizeof(*t_ctx));
+            if (NULL == t_ctx) {
+                rc = SR_ERR_NOMEM;
+                break;
+            }
+            pool->ctxs[pool->count++] = t_ctx;
+        } else if (NULL == t_ctx && NULL != lru) {
+            /* evict the least recently used context, it will be rebuilt */
+            SR_LOG_DBG("Evicting temporary libyang context with modules '%s'", NULL != lru->signature ? lru->signature : "");
+            t_ctx = lru;
+            free(t_ctx->signature);
+            t_ctx->signature = NULL;
+        } else if (NULL == t_ctx) {
+            /* all contexts are in use, wait until one is released */
+            ret = pthread_cond_timedwait(&pool->cond, &pool->mutex, &ts);
+            if (0 != ret) {
+                SR_LOG_ERR("Temporary libyang context can not be acquired %s", sr_strerror_safe(ret));
+                rc = SR_ERR_TIME_OUT;
+                break;
+            }
+        }
+    }
+    if (NULL != t_ctx) {
+        t_ctx->in_use = true;
+        t_ctx->last_used = ++pool->usage_counter;
+    }
+    generation = pool->generation;
+    pthread_mutex_unlock(&pool->mutex);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to acquire temporary libyang context");
+
+    if (NULL != t_ctx->signature) {
+        SR_LOG_DBG("Reusing temporary libyang context with modules '%s'", signature);
+        goto cleanup;
+    }
+
+    /* (re)build the context */
+    if (NULL != t_ctx->ctx) {
+        ly_ctx_destroy(t_ctx->ctx, NULL);
+    }
+    t_ctx->ctx = ly_ctx_new(dm_ctx->schema_search_dir);
+    CHECK_NULL_NOMEM_GOTO(t_ctx->ctx, rc, cleanup);
+
+    /* load requested modules */
+    if (NULL != models_to_be_loaded) {
+        rc = dm_tmp_ly_ctx_load_modules(dm_ctx, t_ctx, models_to_be_loaded);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to load modules into temporary libyang context");
+    }
+
+    t_ctx->signature = signature;
+    t_ctx->generation = generation;
+    signature = NULL;
 
-    rc = sr_btree_insert(tree, (void *) copy);
 cleanup:
-    if (SR_ERR_OK != rc) {
-        dm_data_info_free(copy);
+    if (SR_ERR_OK == rc)  {
+        *tmp_ctx = t_ctx;
+    } else if (NULL != t_ctx) {
+        /* signature is not set, the context will be rebuilt */
+        dm_release_tmp_ly_ctx(dm_ctx, t_ctx);
     }
+    free(signature);
+
     return rc;
 }
 
 /**
- * @brief Function verifies that current module is not used by a session
- * and dis/enable the feature
- *
- * @note Function expects that a schema info is locked for writing.
- *
+ * @brief Makes the contexts in the pool of temporary libyang contexts outdated, so that they are
+ * rebuilt before the next use. Called when the schemas or their features change.
  * @param [in] dm_ctx
- * @param [in] schema_info - schema info that is locked
- * @param [in] module_name
- * @param [in] feature_name
- * @param [in] enable Flag denoting whether feature should be enabled or disabled
- * @return Error code (SR_ERR_OK on success)
  */
-static int
-dm_feature_enable_internal(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info, const char *module_name, const char *feature_name, bool enable)
+static void
+dm_tmp_ly_ctx_pool_invalidate(dm_ctx_t *dm_ctx)
 {
-    CHECK_NULL_ARG4(dm_ctx, schema_info, module_name, feature_name);
-    int rc = SR_ERR_OK;
+    pthread_mutex_lock(&dm_ctx->tmp_ly_ctx_pool.mutex);
+    dm_ctx->tmp_ly_ctx_pool.generation++;
+    pthread_mutex_unlock(&dm_ctx->tmp_ly_ctx_pool.mutex);
+}
 
-    pthread_mutex_lock(&schema_info->usage_count_mutex);
-    if (0 != schema_info->usage_count) {
-        SR_LOG_ERR("Feature state can not be modified because %zu is using the module", schema_info->usage_count);
-        pthread_mutex_unlock(&schema_info->usage_count_mutex);
-        return SR_ERR_OPERATION_FAILED;
+/**
+ * @brief Frees all contexts in the pool of temporary libyang contexts.
+ * @param [in] pool
+ */
+static void
+dm_tmp_ly_ctx_pool_cleanup(dm_tmp_ly_ctx_pool_t *pool)
+{
+    for (size_t i = 0; i < pool->count; i++) {
+        dm_free_tmp_ly_ctx(pool->ctxs[i]);
+        pool->ctxs[i] = NULL;
+    }
+    pool->count = 0;
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->cond);
+}
+
+/**
+ * @brief Picks up the next job of the batch and executes it. Expects the mutex of the pool to be held,
+ * the mutex is released for the time of the execution.
+ * @param [in] pool
+ * @param [in] batch
+ * @return True if a job has been executed, false if all jobs of the batch have already been picked up.
+ */
+static bool
+dm_work_batch_execute_next(dm_work_pool_t *pool, dm_work_batch_t *batch)
+{
+    size_t index = 0;
+
+    if (batch->next >= batch->count) {
+        return false;
+    }
+    index = batch->next++;
+    pthread_mutex_unlock(&pool->mutex);
+
+    batch->execute(batch->jobs + index * batch->job_size);
+
+    pthread_mutex_lock(&pool->mutex);
+    if (++batch->done == batch->count) {
+        pthread_cond_signal(&pool->done_cond);
+    }
+    return true;
+}
+
+/**
+ * @brief Body of a worker thread of the work pool.
+ */
+static void *
+dm_work_pool_thread(void *arg)
+{
+    dm_work_pool_t *pool = (dm_work_pool_t *) arg;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (!pool->stop) {
+        if (NULL == pool->batch || !dm_work_batch_execute_next(pool, pool->batch)) {
+            pthread_cond_wait(&pool->cond, &pool->mutex);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+/**
+ * @brief Returns the number of worker threads of the work pool - DM_WORK_THREAD_COUNT,
+ * unless overridden by the environment variable SR_COMMIT_THREAD_COUNT_ENV.
+ */
+static size_t
+dm_get_work_thread_count()
+{
+    const char *env_str = NULL;
+    char *endptr = NULL;
+    long count = 0;
+
+    env_str = getenv(SR_COMMIT_THREAD_COUNT_ENV);
+    if (NULL == env_str) {
+        return DM_WORK_THREAD_COUNT;
+    }
+
+    count = strtol(env_str, &endptr, 10);
+    if ('\0' == *env_str || '\0' != *endptr || count < 0 || count > DM_WORK_THREAD_COUNT_MAX) {
+        SR_LOG_WRN("Invalid value '%s' of %s (expected 0-%d), using %d threads.", env_str, SR_COMMIT_THREAD_COUNT_ENV,
+                DM_WORK_THREAD_COUNT_MAX, DM_WORK_THREAD_COUNT);
+        return DM_WORK_THREAD_COUNT;
+    }
+
+    return (size_t)count;
+}
+
+/**
+ * @brief Initializes the work pool, the worker threads are started by ::dm_work_pool_start.
+ * @param [in] pool
+ * @param [in] thread_count Number of worker threads, 0 if the jobs should be executed by the submitting thread.
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_work_pool_init(dm_work_pool_t *pool, size_t thread_count)
+{
+    CHECK_NULL_ARG(pool);
+    int rc = SR_ERR_OK;
+
+    rc = pthread_mutex_init(&pool->mutex, NULL);
+    CHECK_ZERO_MSG_RETURN(rc, SR_ERR_INTERNAL, "Work pool mutex init failed");
+    rc = pthread_cond_init(&pool->cond, NULL);
+    CHECK_ZERO_MSG_RETURN(rc, SR_ERR_INTERNAL, "Work pool cond init failed");
+    rc = pthread_cond_init(&pool->done_cond, NULL);
+    CHECK_ZERO_MSG_RETURN(rc, SR_ERR_INTERNAL, "Work pool cond init failed");
+    pool->max_threads = thread_count;
+    pool->initialized = true;
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Starts the worker threads of the pool unless they have already been started. Expects the mutex
+ * of the pool to be held. If a thread can not be started, the pool continues with the threads started so far.
+ * @param [in] pool
+ */
+static void
+dm_work_pool_start(dm_work_pool_t *pool)
+{
+    int ret = 0;
+
+    if (NULL != pool->threads || 0 == pool->max_threads) {
+        return;
+    }
+
+    pool->threads = calloc(pool->max_threads, sizeof(*pool->threads));
+    if (NULL == pool->threads) {
+        SR_LOG_WRN_MSG("Unable to allocate the work pool threads, jobs will be executed sequentially");
+        pool->max_threads = 0;
+        return;
+    }
+
+    for (size_t i = 0; i < pool->max_threads; i++) {
+        ret = pthread_create(&pool->threads[i], NULL, dm_work_pool_thread, pool);
+        if (0 != ret) {
+            SR_LOG_WRN("Failed to start a work pool thread: %s", sr_strerror_safe(ret));
+            break;
+        }
+        pool->thread_count++;
+    }
+    pool->max_threads = pool->thread_count;
+    SR_LOG_DBG("Started %zu work pool threads", pool->thread_count);
+}
+
+/**
+ * @brief Stops the worker threads and frees the resources held by the work pool.
+ * @param [in] pool
+ */
+static void
+dm_work_pool_cleanup(dm_work_pool_t *pool)
+{
+    if (!pool->initialized) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (size_t i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    free(pool->threads);
+    pool->threads = NULL;
+    pool->thread_count = 0;
+
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->cond);
+    pthread_cond_destroy(&pool->done_cond);
+    pool->initialized = false;
+}
+
+/**
+ * @brief Executes the jobs in parallel using the work pool and waits until all of them finish.
+ * The worker threads are started with the first batch of more than one job. If the pool is not available
+ * (NULL, without threads or busy with a batch of another commit), the jobs are executed by the calling thread.
+ *
+ * @param [in] pool Work pool, can be NULL.
+ * @param [in] execute Function executing one job, the jobs must not depend on each other.
+ * @param [in] jobs Array of jobs.
+ * @param [in] job_size Size of one job in the array.
+ * @param [in] count Number of jobs.
+ */
+static void
+dm_work_pool_execute(dm_work_pool_t *pool, void (*execute)(void *job), void *jobs, size_t job_size, size_t count)
+{
+    dm_work_batch_t batch = { .execute = execute, .jobs = jobs, .job_size = job_size, .count = count };
+
+    if (NULL != pool && pool->initialized && count > 1) {
+        pthread_mutex_lock(&pool->mutex);
+        if (NULL == pool->batch && !pool->stop) {
+            dm_work_pool_start(pool);
+        }
+        if (NULL == pool->batch && !pool->stop && 0 != pool->thread_count) {
+            pool->batch = &batch;
+            pthread_cond_broadcast(&pool->cond);
+            while (dm_work_batch_execute_next(pool, &batch));
+            while (batch.done < batch.count) {
+                pthread_cond_wait(&pool->done_cond, &pool->mutex);
+            }
+            pool->batch = NULL;
+            pthread_mutex_unlock(&pool->mutex);
+            return;
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        execute(batch.jobs + i * job_size);
+    }
+}
+
+/**
+ * @brief Allocates the schema info. The schema info gets either its own empty libyang context
+ * or the context shared by all modules.
+ * @param [in] dm_ctx
+ * @param [out] schema_info
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_schema_info_init(dm_ctx_t *dm_ctx, dm_schema_info_t **schema_info)
+{
+    CHECK_NULL_ARG2(dm_ctx, schema_info);
+    int rc = SR_ERR_OK;
+    dm_schema_info_t *si = NULL;
+
+    si = calloc(1, sizeof(*si));
+    CHECK_NULL_NOMEM_RETURN(si);
+
+    if (NULL != dm_ctx->shared_ly_ctx) {
+        si->ly_ctx = dm_ctx->shared_ly_ctx;
+        si->shared_ly_ctx = true;
+    } else {
+        si->ly_ctx = ly_ctx_new(dm_ctx->schema_search_dir);
+        CHECK_NULL_NOMEM_GOTO(si->ly_ctx, rc, cleanup);
+    }
+
+    pthread_rwlock_init(&si->model_lock, NULL);
+    pthread_mutex_init(&si->usage_count_mutex, NULL);
+
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+#if defined(HAVE_PTHREAD_RWLOCKATTR_SETKIND_NP)
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    pthread_rwlock_init(&si->commit_lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+
+cleanup:
+    if (SR_ERR_OK != rc) {
+        free(si);
+    } else {
+        *schema_info = si;
+    }
+    return rc;
+}
+
+/**
+ * @brief Creates the copy of dm_data_info structure and inserts it into binary tree
+ * @param [in] tree
+ * @param [in] di
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_insert_data_info_copy(sr_btree_t *tree, const dm_data_info_t *di)
+{
+    CHECK_NULL_ARG2(tree, di);
+    int rc = SR_ERR_OK;
+    dm_data_info_t *copy = NULL;
+    copy = calloc (1, sizeof(*copy));
+    CHECK_NULL_NOMEM_RETURN(copy);
+
+    if (NULL != di->node) {
+        copy->node = sr_dup_datatree(di->node);
+        CHECK_NULL_NOMEM_GOTO(copy->node, rc, cleanup);
+    }
+
+    pthread_mutex_lock(&di->schema->usage_count_mutex);
+    di->schema->usage_count++;
+    SR_LOG_DBG("Usage count %s incremented (value=%zu)", di->schema->module_name, di->schema->usage_count);
+    pthread_mutex_unlock(&di->schema->usage_count_mutex);
+    copy->schema = di->schema;
+    copy->timestamp = di->timestamp;
+    copy->journal_seq = di->journal_seq;
+
+    rc = sr_btree_insert(tree, (void *) copy);
+cleanup:
+    if (SR_ERR_OK != rc) {
+        dm_data_info_free(copy);
+    }
+    return rc;
+}
+
+/**
+ * @brief Function verifies that current module is not used by a session
+ * and dis/enable the feature
+ *
+ * @note Function expects that a schema info is locked for writing.
+ *
+ * @param [in] dm_ctx
+ * @param [in] schema_info - schema info that is locked
+ * @param [in] module_name
+ * @param [in] feature_name
+ * @param [in] enable Flag denoting whether feature should be enabled or disabled
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_feature_enable_internal(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info, const char *module_name, const char *feature_name, bool enable)
+{
+    CHECK_NULL_ARG4(dm_ctx, schema_info, module_name, feature_name);
+    int rc = SR_ERR_OK;
+
+    /* cached snapshots and subtree dependencies do not match the modified schema */
+    dm_data_snapshot_invalidate(dm_ctx, schema_info);
+    dm_subtree_deps_free(__atomic_exchange_n(&schema_info->subtree_deps, NULL, __ATOMIC_ACQ_REL));
+
+    pthread_mutex_lock(&schema_info->usage_count_mutex);
+    if (0 != schema_info->usage_count) {
+        SR_LOG_ERR("Feature state can not be modified because %zu is using the module", schema_info->usage_count);
+        pthread_mutex_unlock(&schema_info->usage_count_mutex);
+        return SR_ERR_OPERATION_FAILED;
     }
 
     const struct lys_module *module = ly_ctx_get_module(schema_info->ly_ctx, module_name, NULL);
@@ -902,7 +1540,7 @@ dm_load_schema_file(dm_ctx_t *dm_ctx, const char *schema_filepath, bool append,
         si = *schema_info;
     } else {
         /* allocate new structure where schemas will be loaded*/
-        rc = dm_schema_info_init(dm_ctx->schema_search_dir, &si);
+        rc = dm_schema_info_init(dm_ctx, &si);
         CHECK_RC_MSG_RETURN(rc, "Schema info init failed");
     }
 
@@ -949,6 +1587,13 @@ dm_load_module(dm_ctx_t *dm_ctx, const char *module_name, const char *revision,
     md_dep_t *dep = NULL;
     sr_llist_node_t *ll_node = NULL;
 
+    if (NULL != dm_ctx->shared_ly_ctx) {
+        /* all installed modules have been loaded when the shared context was built */
+        SR_LOG_ERR("Module '%s:%s' is not installed.", module_name, revision ? revision : "<latest>");
+        *schema_info = NULL;
+        return SR_ERR_UNKNOWN_MODEL;
+    }
+
     /* search for the module to use */
     md_ctx_lock(dm_ctx->md_ctx, false);
     rc = md_get_module_info(dm_ctx->md_ctx, module_name, revision, &module);
@@ -1050,67 +1695,444 @@ cleanup:
 }
 
 /**
- * @brief Function removes the subtrees that doesn't belong to the selected module.
+ * @brief Loads the installed modules that are not loaded yet into the context shared by all modules
+ * and attaches their schema infos to it (the schema infos are created if necessary). Used to build
+ * the shared context and to extend it with newly installed modules.
+ *
+ * @note Function expects that md_ctx is locked, that the schema tree is locked for writing and that
+ * the shared context is not accessed by other threads (see ::dm_lock_schema_infos_write).
+ *
+ * @param [in] dm_ctx
+ * @param [in] session - session that requested the load, can be NULL
+ * @return Error code (SR_ERR_OK on success)
  */
 static int
-dm_remove_added_data_trees_by_module_name(const char *module_name, struct lyd_node **root)
+dm_shared_ly_ctx_load(dm_ctx_t *dm_ctx, dm_session_t *session)
 {
-    CHECK_NULL_ARG(module_name);
+    CHECK_NULL_ARG2(dm_ctx, dm_ctx->shared_ly_ctx); /* session can be NULL */
     int rc = SR_ERR_OK;
-    if (NULL != *root) {
-        struct ly_ctx *ctx = (*root)->schema->module->ctx;
-        const struct lys_module *module = ly_ctx_get_module(ctx, module_name, NULL);
-        if (NULL == module) {
-            SR_LOG_ERR("Module %s not found", module_name);
-            return SR_ERR_INTERNAL;
+    md_module_t *module = NULL;
+    md_dep_t *dep = NULL;
+    sr_llist_node_t *ll_node = NULL, *ll_dep = NULL;
+    const struct lys_module *ly_module = NULL;
+    const char *revision = NULL;
+    dm_schema_info_t lookup = {0}, *si = NULL;
+    sr_list_t *loaded = NULL;
+
+    rc = sr_list_init(&loaded);
+    CHECK_RC_MSG_RETURN(rc, "List init failed");
+
+    for (ll_node = dm_ctx->md_ctx->modules->first; NULL != ll_node; ll_node = ll_node->next) {
+        module = (md_module_t *) ll_node->data;
+        if (module->submodule || !module->implemented || !module->latest_revision) {
+            /* imports are loaded automatically by libyang */
+            continue;
         }
-        if (module != (*root)->schema->module) {
-            lyd_free_withsiblings(*root);
-            *root = NULL;
-            return SR_ERR_OK;
+        lookup.module_name = module->name;
+        si = sr_btree_search(dm_ctx->schema_info_tree, &lookup);
+        if (NULL != si && NULL != si->ly_ctx) {
+            continue;
         }
-        struct lyd_node *n = *root;
-        struct lyd_node *tmp = NULL;
 
-        while (n) {
-           tmp = n;
-           n = n->next;
-           if (module != tmp->schema->module) {
-              lyd_free(tmp);
-           }
+        revision = (NULL != module->revision_date && '\0' != module->revision_date[0]) ? module->revision_date : NULL;
+        ly_module = ly_ctx_get_module(dm_ctx->shared_ly_ctx, module->name, revision);
+        if (NULL == ly_module || !ly_module->implemented) {
+            LYS_INFORMAT fmt = sr_str_ends_with(module->filepath, SR_SCHEMA_YIN_FILE_EXT) ? LYS_IN_YIN : LYS_IN_YANG;
+            ly_module = lys_parse_path(dm_ctx->shared_ly_ctx, module->filepath, fmt);
+            if (NULL == ly_module) {
+                SR_LOG_ERR("Unable to parse a schema file: %s", module->filepath);
+                rc = SR_ERR_INTERNAL;
+                goto cleanup;
+            }
+        }
+
+        if (NULL == si) {
+            rc = dm_schema_info_init(dm_ctx, &si);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Schema info init failed");
+            si->module_name = strdup(module->name);
+            if (NULL == si->module_name) {
+                dm_free_schema_info(si);
+                rc = SR_ERR_NOMEM;
+                goto cleanup;
+            }
+            rc = sr_btree_insert(dm_ctx->schema_info_tree, si);
+            if (SR_ERR_OK != rc) {
+                dm_free_schema_info(si);
+                SR_LOG_ERR("Insert into schema binary tree failed. %s", sr_strerror(rc));
+                goto cleanup;
+            }
+        } else {
+            /* module has been uninstalled and installed again */
+            si->ly_ctx = dm_ctx->shared_ly_ctx;
+            si->shared_ly_ctx = true;
+        }
+        si->module = ly_module;
+        si->has_instance_id = NULL != module->inst_ids->first;
+        si->cross_module_data_dependency = false;
+        for (ll_dep = module->deps->first; NULL != ll_dep; ll_dep = ll_dep->next) {
+            dep = (md_dep_t *) ll_dep->data;
+            if (MD_DEP_DATA == dep->type) {
+                si->cross_module_data_dependency = true;
+            }
+        }
+        si->can_not_be_locked = !module->has_data;
+
+        rc = sr_list_add(loaded, module);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
+    }
+
+    /* compute xpath hashes for all schema nodes, including the ones added to already loaded modules by augments */
+    for (size_t i = 0; NULL != (si = sr_btree_get_at(dm_ctx->schema_info_tree, i)); i++) {
+        dm_subtree_deps_free(__atomic_exchange_n(&si->subtree_deps, NULL, __ATOMIC_ACQ_REL));
+        if (NULL != si->ly_ctx) {
+            rc = dm_init_missing_node_priv_data(si);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to initialize private data for module %s", si->module_name);
+        }
+    }
+
+    /* apply persist data enable features, running datastore */
+    for (size_t i = 0; i < loaded->count; i++) {
+        module = (md_module_t *) loaded->data[i];
+        if (module->has_persist) {
+            lookup.module_name = module->name;
+            si = sr_btree_search(dm_ctx->schema_info_tree, &lookup);
+            rc = dm_apply_persist_data_for_model(dm_ctx, session, module->name, si);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to apply persist data for module %s", module->name);
         }
     }
+    SR_LOG_DBG("%zu module(s) loaded into the shared schema context", loaded->count);
 
+cleanup:
+    sr_list_cleanup(loaded);
     return rc;
 }
 
 /**
- * @brief Tries to load data tree from provided opened file.
+ * @brief Builds the context shared by all installed modules.
  * @param [in] dm_ctx
- * @param [in] fd to be read from, function does not close it
- * If NULL passed data info with empty data will be created
- * @param [in] schema_info
- * @param [in] data_info
  * @return Error code (SR_ERR_OK on success)
  */
 static int
-dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_schema_info_t *schema_info, dm_data_info_t **data_info)
+dm_shared_ly_ctx_init(dm_ctx_t *dm_ctx)
+{
+    CHECK_NULL_ARG(dm_ctx);
+    int rc = SR_ERR_OK;
+
+    dm_ctx->shared_ly_ctx = ly_ctx_new(dm_ctx->schema_search_dir);
+    CHECK_NULL_NOMEM_RETURN(dm_ctx->shared_ly_ctx);
+    dm_ctx->shared_tmp_ly_ctx.ctx = dm_ctx->shared_ly_ctx;
+
+    md_ctx_lock(dm_ctx->md_ctx, false);
+    pthread_rwlock_wrlock(&dm_ctx->schema_tree_lock);
+    rc = dm_shared_ly_ctx_load(dm_ctx, NULL);
+    pthread_rwlock_unlock(&dm_ctx->schema_tree_lock);
+    md_ctx_unlock(dm_ctx->md_ctx);
+
+    return rc;
+}
+
+/**
+ * @brief Releases the locks acquired by ::dm_lock_schema_infos_write.
+ * @param [in] dm_ctx
+ * @param [in] locked - list of the locked schema infos, freed by the function
+ */
+static void
+dm_unlock_schema_infos(dm_ctx_t *dm_ctx, sr_list_t *locked)
+{
+    if (NULL != locked) {
+        pthread_rwlock_unlock(&dm_ctx->shared_ly_ctx_lock);
+        for (size_t i = 0; i < locked->count; i++) {
+            pthread_rwlock_unlock(&((dm_schema_info_t *) locked->data[i])->model_lock);
+        }
+        sr_list_cleanup(locked);
+    }
+}
+
+/**
+ * @brief Locks all schema infos and the context shared by all modules for writing, so that the shared
+ * context can be modified.
+ *
+ * @note Function expects that the schema tree is locked for writing.
+ *
+ * @param [in] dm_ctx
+ * @param [out] locked - list of the locked schema infos, to be passed to ::dm_unlock_schema_infos
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_lock_schema_infos_write(dm_ctx_t *dm_ctx, sr_list_t **locked)
+{
+    CHECK_NULL_ARG2(dm_ctx, locked);
+    int rc = SR_ERR_OK;
+    dm_schema_info_t *si = NULL;
+    sr_list_t *list = NULL;
+
+    rc = sr_list_init(&list);
+    CHECK_RC_MSG_RETURN(rc, "List init failed");
+
+    for (size_t i = 0; NULL != (si = sr_btree_get_at(dm_ctx->schema_info_tree, i)); i++) {
+        RWLOCK_WRLOCK_TIMED_CHECK_GOTO(&si->model_lock, rc, cleanup);
+        rc = sr_list_add(list, si);
+        if (SR_ERR_OK != rc) {
+            pthread_rwlock_unlock(&si->model_lock);
+            goto cleanup;
+        }
+    }
+
+    /* the shared context is also used as temporary context, without the schema info locks */
+    RWLOCK_WRLOCK_TIMED_CHECK_GOTO(&dm_ctx->shared_ly_ctx_lock, rc, cleanup);
+
+cleanup:
+    if (SR_ERR_OK != rc) {
+        for (size_t i = 0; i < list->count; i++) {
+            pthread_rwlock_unlock(&((dm_schema_info_t *) list->data[i])->model_lock);
+        }
+        sr_list_cleanup(list);
+    } else {
+        *locked = list;
+    }
+    return rc;
+}
+
+/**
+ * @brief Prepares the module for a modification of its schema nodes in the shared context (e.g. by an augment
+ * or a feature of another module). Cached snapshots and subtree dependencies are dropped, data trees
+ * of the module must not exist, since they reference the schema nodes. Data trees of the other
+ * modules are not affected.
+ *
+ * @note Function expects that the schema info is locked for writing.
+ *
+ * @param [in] dm_ctx
+ * @param [in] schema_info
+ * @return Error code (SR_ERR_OK on success), SR_ERR_OPERATION_FAILED if the module is being used
+ */
+static int
+dm_shared_ly_ctx_prepare_modify(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info)
+{
+    CHECK_NULL_ARG2(dm_ctx, schema_info);
+    int rc = SR_ERR_OK;
+    size_t pinned = 0;
+
+    dm_data_snapshot_invalidate(dm_ctx, schema_info);
+    dm_subtree_deps_free(__atomic_exchange_n(&schema_info->subtree_deps, NULL, __ATOMIC_ACQ_REL));
+
+    /* NACM references its schema info only to prevent the uninstallation of its module */
+    pinned = (NULL != dm_ctx->nacm_ctx && schema_info == dm_ctx->nacm_ctx->schema_info) ? 1 : 0;
+    pthread_mutex_lock(&schema_info->usage_count_mutex);
+    if (schema_info->usage_count > pinned) {
+        SR_LOG_ERR("Schema of module %s can not be modified because it is being used. (referenced by %zu)",
+                schema_info->module_name, schema_info->usage_count - pinned);
+        rc = SR_ERR_OPERATION_FAILED;
+    }
+    pthread_mutex_unlock(&schema_info->usage_count_mutex);
+
+    return rc;
+}
+
+/**
+ * @brief Applies ::dm_shared_ly_ctx_prepare_modify on the modules augmented by the module.
+ *
+ * @note Function expects that md_ctx is locked and that the schema infos are locked for writing.
+ *
+ * @param [in] dm_ctx
+ * @param [in] module
+ * @return Error code (SR_ERR_OK on success), SR_ERR_OPERATION_FAILED if an augmented module is being used
+ */
+static int
+dm_shared_ly_ctx_prepare_augmented(dm_ctx_t *dm_ctx, md_module_t *module)
+{
+    CHECK_NULL_ARG2(dm_ctx, module);
+    int rc = SR_ERR_OK;
+    md_dep_t *dep = NULL;
+    dm_schema_info_t lookup = {0}, *si = NULL;
+
+    for (sr_llist_node_t *ll_node = module->inv_deps->first; NULL != ll_node; ll_node = ll_node->next) {
+        dep = (md_dep_t *) ll_node->data;
+        if (MD_DEP_EXTENSION == dep->type && dep->dest->latest_revision) {
+            lookup.module_name = (char *) dep->dest->name;
+            si = sr_btree_search(dm_ctx->schema_info_tree, &lookup);
+            if (NULL != si && NULL != si->ly_ctx) {
+                rc = dm_shared_ly_ctx_prepare_modify(dm_ctx, si);
+                CHECK_RC_LOG_RETURN(rc, "Module %s augmented by %s is being used", si->module_name, module->name);
+            }
+        }
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Function removes the subtrees that doesn't belong to the selected module.
+ */
+static int
+dm_remove_added_data_trees_by_module_name(const char *module_name, struct lyd_node **root)
+{
+    CHECK_NULL_ARG(module_name);
+    int rc = SR_ERR_OK;
+    if (NULL != *root) {
+        struct ly_ctx *ctx = (*root)->schema->module->ctx;
+        const struct lys_module *module = ly_ctx_get_module(ctx, module_name, NULL);
+        if (NULL == module) {
+            SR_LOG_ERR("Module %s not found", module_name);
+            return SR_ERR_INTERNAL;
+        }
+        if (module != (*root)->schema->module) {
+            lyd_free_withsiblings(*root);
+            *root = NULL;
+            return SR_ERR_OK;
+        }
+        struct lyd_node *n = *root;
+        struct lyd_node *tmp = NULL;
+
+        while (n) {
+           tmp = n;
+           n = n->next;
+           if (module != tmp->schema->module) {
+              lyd_free(tmp);
+           }
+        }
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Returns true if the commits into the datastore are appended to the journals of the modules.
+ */
+static bool
+dm_is_journaled(dm_ctx_t *dm_ctx, sr_datastore_t ds)
+{
+    return NULL != dm_ctx && dm_ctx->journal_commits && (SR_DS_STARTUP == ds || SR_DS_RUNNING == ds);
+}
+
+/**
+ * @brief Returns the commit journal of the module, the journal is opened on the first access.
+ *
+ * @param [in] dm_ctx
+ * @param [in] ds
+ * @param [in] module_name
+ * @param [out] journal Journal of the module, NULL if the commits into the datastore rewrite the data files
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_get_journal(dm_ctx_t *dm_ctx, sr_datastore_t ds, const char *module_name, dm_journal_t **journal)
+{
+    CHECK_NULL_ARG3(dm_ctx, module_name, journal);
+    dm_module_journal_t lookup = {0}, *mj = NULL;
+    int rc = SR_ERR_OK;
+
+    *journal = NULL;
+    if (!dm_is_journaled(dm_ctx, ds)) {
+        return SR_ERR_OK;
+    }
+
+    lookup.module_name = (char *) module_name;
+    lookup.ds = ds;
+    pthread_mutex_lock(&dm_ctx->journals_lock);
+    mj = sr_btree_search(dm_ctx->journals, &lookup);
+    if (NULL == mj) {
+        mj = calloc(1, sizeof(*mj));
+        CHECK_NULL_NOMEM_GOTO(mj, rc, cleanup);
+        mj->ds = ds;
+        mj->module_name = strdup(module_name);
+        CHECK_NULL_NOMEM_GOTO(mj->module_name, rc, cleanup);
+        rc = dm_journal_init(dm_ctx->data_search_dir, module_name, ds, &mj->journal);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to initialize the journal of module %s", module_name);
+        rc = sr_btree_insert(dm_ctx->journals, mj);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Insert into journal tree failed");
+    }
+    *journal = mj->journal;
+    mj = NULL;
+
+cleanup:
+    pthread_mutex_unlock(&dm_ctx->journals_lock);
+    dm_module_journal_free(mj);
+    return rc;
+}
+
+/**
+ * @brief Returns the journal sequence number identifying the content of the module,
+ * 0 if the commits into the datastore are not journaled.
+ */
+static int
+dm_get_journal_seq(dm_ctx_t *dm_ctx, sr_datastore_t ds, const char *module_name, uint64_t *seq)
+{
+    CHECK_NULL_ARG(seq);
+    dm_journal_t *journal = NULL;
+    int rc = SR_ERR_OK;
+
+    *seq = 0;
+    rc = dm_get_journal(dm_ctx, ds, module_name, &journal);
+    if (SR_ERR_OK == rc && NULL != journal) {
+        rc = dm_journal_get_seq(journal, seq);
+    }
+    return rc;
+}
+
+/**
+ * @brief Parses the data tree from the data file, or from the image taken from the commit journal.
+ */
+static int
+dm_parse_data_tree(struct ly_ctx *ly_ctx, int fd, const char *image, struct lyd_node **root)
+{
+    if (NULL == image) {
+        return sr_lyd_parse_data_fd(ly_ctx, fd, LYD_OPT_TRUSTED | LYD_OPT_CONFIG, root);
+    }
+
+    *root = NULL;
+    if ('\0' != image[0]) {
+        ly_errno = LY_SUCCESS;
+        *root = lyd_parse_mem(ly_ctx, image, LYD_XML, LYD_OPT_TRUSTED | LYD_OPT_CONFIG);
+        if (NULL == *root && LY_SUCCESS != ly_errno) {
+            SR_LOG_ERR("Parsing of the journal image failed: %s", ly_errmsg());
+            return SR_ERR_INTERNAL;
+        }
+    }
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Tries to load data tree from provided opened file.
+ * @param [in] dm_ctx
+ * @param [in] fd to be read from, function does not close it
+ * If NULL passed data info with empty data will be created
+ * @param [in] schema_info
+ * @param [in] ds datastore the data file belongs to, the journal of the module is applied on the loaded data
+ * @param [in] data_info
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_schema_info_t *schema_info, sr_datastore_t ds,
+        dm_data_info_t **data_info)
 {
     CHECK_NULL_ARG4(dm_ctx, schema_info, data_filename, data_info);
     int rc = SR_ERR_OK;
     struct lyd_node *data_tree = NULL;
+    dm_journal_t *journal = NULL;
+    char *image = NULL;
     *data_info = NULL;
 
     dm_data_info_t *data = NULL;
     data = calloc(1, sizeof(*data));
     CHECK_NULL_NOMEM_RETURN(data);
 
+    rc = dm_get_journal(dm_ctx, ds, schema_info->module_name, &journal);
+    if (SR_ERR_OK == rc && NULL != journal) {
+        /* the last image in the journal supersedes the data file (e.g. interrupted checkpoint) */
+        rc = dm_journal_get_image(journal, &image);
+    }
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Failed to read the journal of module %s", schema_info->module_name);
+        free(data);
+        return rc;
+    }
+
     if (-1 != fd) {
 #ifdef HAVE_STAT_ST_MTIM
         struct stat st = {0};
         rc = stat(data_filename, &st);
         if (-1 == rc) {
             SR_LOG_ERR_MSG("Stat failed");
+            free(image);
             free(data);
             return SR_ERR_INTERNAL;
         }
@@ -1119,18 +2141,31 @@ dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_s
                 (long long) st.st_mtim.tv_sec,
                 (long long) st.st_mtim.tv_nsec);
 #endif
-        if (schema_info->has_instance_id) {
+    }
+
+    if (-1 != fd || NULL != image) {
+        if (schema_info->has_instance_id && !schema_info->shared_ly_ctx) {
+            /* instance identifiers may reference modules not loaded in the context of the module
+             * (the shared context contains all installed modules) */
             struct lyd_node *tmp_node = NULL;
             dm_tmp_ly_ctx_t *tmp_ctx = NULL;
 
             rc = dm_get_tmp_ly_ctx(dm_ctx, NULL, &tmp_ctx);
+            if (SR_ERR_OK != rc) {
+                SR_LOG_ERR("Failed to acquire temporary libyang context to parse %s", data_filename);
+                free(image);
+                free(data);
+                return rc;
+            }
             md_ctx_lock(dm_ctx->md_ctx, false);
             ly_ctx_set_module_data_clb(tmp_ctx->ctx, dm_module_clb, dm_ctx);
             md_ctx_unlock(dm_ctx->md_ctx);
 
-            tmp_node = lyd_parse_fd(tmp_ctx->ctx, fd, LYD_XML, LYD_OPT_TRUSTED | LYD_OPT_CONFIG);
-            if (NULL == tmp_node && LY_SUCCESS != ly_errno) {
-                SR_LOG_ERR("Parsing data tree from file %s failed: %s", data_filename, ly_errmsg());
+            rc = dm_parse_data_tree(tmp_ctx->ctx, fd, image, &tmp_node);
+            if (SR_ERR_OK != rc) {
+                SR_LOG_ERR("Parsing data tree from file %s failed", data_filename);
+                dm_release_tmp_ly_ctx(dm_ctx, tmp_ctx);
+                free(image);
                 free(data);
                 return SR_ERR_INTERNAL;
             }
@@ -1143,16 +2178,28 @@ dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_s
             lyd_free_withsiblings(tmp_node);
             dm_release_tmp_ly_ctx(dm_ctx, tmp_ctx);
         } else {
-            ly_errno = 0;
             /* use LYD_OPT_TRUSTED, validation will be done later */
-            data_tree = lyd_parse_fd(schema_info->ly_ctx, fd, LYD_XML, LYD_OPT_TRUSTED | LYD_OPT_CONFIG);
-            if (NULL == data_tree && LY_SUCCESS != ly_errno) {
-                SR_LOG_ERR("Parsing data tree from file %s failed: %s", data_filename, ly_errmsg());
+            rc = dm_parse_data_tree(schema_info->ly_ctx, fd, image, &data_tree);
+            if (SR_ERR_OK != rc) {
+                SR_LOG_ERR("Parsing data tree from file %s failed", data_filename);
+                free(image);
                 free(data);
                 return SR_ERR_INTERNAL;
             }
         }
     }
+    free(image);
+
+    if (NULL != journal) {
+        /* apply the changes committed since the last checkpoint */
+        rc = dm_journal_replay(journal, schema_info->ly_ctx, &data_tree, &data->journal_seq);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Replay of the journal on data file %s failed", data_filename);
+            lyd_free_withsiblings(data_tree);
+            free(data);
+            return rc;
+        }
+    }
 
     /* if there is no data dependency validate it with of LYD_OPT_STRICT, validate it (only non-empty data trees are validated)*/
     if (!schema_info->cross_module_data_dependency) {
@@ -1197,55 +2244,303 @@ dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_s
     return rc;
 }
 
+#ifdef HAVE_STAT_ST_MTIM
 /**
- * @brief Loads data tree from file. Module and datastore argument are used to
- * determine the file name.
- *
- * @note Function expects that a schema info is locked for reading.
+ * @brief Checks whether the timestamp is older than NANOSEC_THRESHOLD. A data file whose mtime
+ * is that old can not be overwritten without changing its mtime, therefore the content
+ * of the file can be identified by its mtime.
+ */
+static bool
+dm_is_timestamp_settled(const struct timespec *ts)
+{
+    struct timespec now = {0};
+    sr_clock_get_time(CLOCK_REALTIME, &now);
+    long long diff = ((long long) now.tv_sec - (long long) ts->tv_sec) * 1000000000LL + (now.tv_nsec - ts->tv_nsec);
+    return diff >= NANOSEC_THRESHOLD;
+}
+#endif
+
+/**
+ * @brief Inserts a new snapshot of the data tree into the snapshot cache. The snapshot
+ * previously cached for the same module and datastore is released.
  *
  * @param [in] dm_ctx
- * @param [in] dm_session_ctx
  * @param [in] schema_info
  * @param [in] ds
- * @param [out] data_info
- * @return Error code (SR_ERR_OK on success), SR_ERR_INTERAL if the parsing of the data tree fails.
+ * @param [in] timestamp mtime of the data file the data tree corresponds to
+ * @param [in] journal_seq journal sequence number the data tree corresponds to (0 if commits are not journaled)
+ * @param [in] node data tree, the snapshot takes over its ownership on success
+ * @param [out] snapshot if not NULL, an additional reference of the created snapshot is returned
+ * @return Error code (SR_ERR_OK on success)
  */
 static int
-dm_load_data_tree(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, dm_schema_info_t *schema_info, sr_datastore_t ds, dm_data_info_t **data_info)
+dm_data_snapshot_insert(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info, sr_datastore_t ds, const struct timespec *timestamp,
+        uint64_t journal_seq, struct lyd_node *node, dm_data_snapshot_t **snapshot)
 {
-    CHECK_NULL_ARG4(dm_ctx, schema_info, schema_info->module, schema_info->module->name);
-
-    char *data_filename = NULL;
-    int rc = 0;
-    *data_info = NULL;
-    rc = sr_get_data_file_name(dm_ctx->data_search_dir, schema_info->module->name, ds, &data_filename);
-    CHECK_RC_LOG_RETURN(rc, "Get data_filename failed for %s", schema_info->module->name);
-
-    ac_set_user_identity(dm_ctx->ac_ctx, dm_session_ctx->user_credentials);
-
-    int fd = open(data_filename, O_RDONLY);
+    CHECK_NULL_ARG3(dm_ctx, schema_info, timestamp);
+    int rc = SR_ERR_OK;
+    dm_data_snapshot_t *snap = NULL, *old = NULL;
+
+    snap = calloc(1, sizeof(*snap));
+    CHECK_NULL_NOMEM_RETURN(snap);
+    snap->schema = schema_info;
+    snap->ds = ds;
+    snap->node = node;
+    snap->timestamp = *timestamp;
+    snap->journal_seq = journal_seq;
+    snap->ref_count = (NULL != snapshot) ? 2 : 1;
+    snap->lock = &dm_ctx->snapshot_cache_lock;
 
-    ac_unset_user_identity(dm_ctx->ac_ctx);
+    /* increment counter of data tree using the module */
+    pthread_mutex_lock(&schema_info->usage_count_mutex);
+    schema_info->usage_count++;
+    SR_LOG_DBG("Usage count %s incremented (value=%zu)", schema_info->module_name, schema_info->usage_count);
+    pthread_mutex_unlock(&schema_info->usage_count_mutex);
 
-    if (-1 != fd) {
-        /* lock, read-only, blocking */
-        sr_lock_fd(fd, false, true);
-    } else if (ENOENT == errno) {
-        SR_LOG_DBG("Data file %s does not exist, creating empty data tree", data_filename);
-    } else if (EACCES == errno) {
-        SR_LOG_DBG("Data file %s can't be read because of access rights", data_filename);
-        free(data_filename);
-        return SR_ERR_UNAUTHORIZED;
+    pthread_mutex_lock(&dm_ctx->snapshot_cache_lock);
+    old = sr_btree_search(dm_ctx->snapshot_cache, snap);
+    if (NULL != old) {
+        /* drops the reference held by the cache */
+        sr_btree_delete(dm_ctx->snapshot_cache, old);
     }
-
-    rc = dm_load_data_tree_file(dm_ctx, fd, data_filename, schema_info, data_info);
-
-    if (-1 != fd) {
-        sr_unlock_fd(fd);
-        close(fd);
+    rc = sr_btree_insert(dm_ctx->snapshot_cache, snap);
+    pthread_mutex_unlock(&dm_ctx->snapshot_cache_lock);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Insert into snapshot cache failed module %s", schema_info->module_name);
+        pthread_mutex_lock(&schema_info->usage_count_mutex);
+        schema_info->usage_count--;
+        pthread_mutex_unlock(&schema_info->usage_count_mutex);
+        free(snap);
+        return rc;
     }
 
-    free(data_filename);
+    if (NULL != snapshot) {
+        *snapshot = snap;
+    }
+    return rc;
+}
+
+/**
+ * @brief Swaps in a new snapshot of the data tree that has just been written into the data file
+ * (or appended to the commit journal). Errors are not fatal, if the new snapshot can not be created
+ * the cached one is invalidated.
+ *
+ * @param [in] dm_ctx
+ * @param [in] schema_info
+ * @param [in] ds
+ * @param [in] fd file descriptor of the written data file
+ * @param [in] node data tree that has been written, a copy of it is stored in the snapshot
+ */
+static void
+dm_data_snapshot_update(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info, sr_datastore_t ds, int fd, const struct lyd_node *node)
+{
+    CHECK_NULL_ARG_VOID2(dm_ctx, schema_info);
+#ifdef HAVE_STAT_ST_MTIM
+    struct stat st = {0};
+    struct lyd_node *dup = NULL;
+    uint64_t seq = 0;
+
+    if (SR_DS_RUNNING == ds || SR_DS_STARTUP == ds) {
+        if (0 == fstat(fd, &st) && SR_ERR_OK == dm_get_journal_seq(dm_ctx, ds, schema_info->module_name, &seq)) {
+            dup = sr_dup_datatree((struct lyd_node *) node);
+            if ((NULL == node || NULL != dup) &&
+                    SR_ERR_OK == dm_data_snapshot_insert(dm_ctx, schema_info, ds, &st.st_mtim, seq, dup, NULL)) {
+                SR_LOG_DBG("Snapshot of module %s updated", schema_info->module_name);
+                return;
+            }
+            lyd_free_withsiblings(dup);
+        }
+        SR_LOG_WRN("Failed to update snapshot of module %s", schema_info->module_name);
+        dm_data_snapshot_invalidate(dm_ctx, schema_info);
+    }
+#endif
+}
+
+/**
+ * @brief Makes the data tree of the data info private, so that it can be modified. If the data
+ * info borrows the data tree from a snapshot, the data tree is duplicated. The reference
+ * of the snapshot is kept as long as the data info exists.
+ *
+ * @param [in] info
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_data_info_make_private(dm_data_info_t *info)
+{
+    CHECK_NULL_ARG(info);
+    struct lyd_node *dup = NULL;
+
+    if (!info->shared) {
+        return SR_ERR_OK;
+    }
+    if (NULL != info->node) {
+        dup = sr_dup_datatree(info->node);
+        CHECK_NULL_NOMEM_RETURN(dup);
+    }
+    info->node = dup;
+    info->shared = false;
+    SR_LOG_DBG("Private copy of data tree %s created", info->schema->module_name);
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Loads data tree of running or startup datastore from provided opened file. If the snapshot
+ * of the data file is cached and its timestamp matches the mtime of the file, the data tree
+ * is taken from the snapshot without parsing the file. Otherwise the file is parsed and
+ * the snapshot is created. If the commits into the datastore are journaled, the journal
+ * sequence number of the module must match as well.
+ *
+ * @param [in] dm_ctx
+ * @param [in] fd to be read from, function does not close it
+ * @param [in] data_filename
+ * @param [in] schema_info
+ * @param [in] ds datastore the data file belongs to
+ * @param [in] shared if set to true returned data info can borrow the data tree from the snapshot
+ * (::dm_data_info_make_private must be called before the data tree is modified)
+ * @param [out] data_info
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_load_data_tree_file_cached(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_schema_info_t *schema_info,
+        sr_datastore_t ds, bool shared, dm_data_info_t **data_info)
+{
+    CHECK_NULL_ARG4(dm_ctx, schema_info, data_filename, data_info);
+#ifdef HAVE_STAT_ST_MTIM
+    int rc = SR_ERR_OK;
+    struct stat st = {0};
+    dm_data_snapshot_t lookup = {0}, *snapshot = NULL;
+    dm_data_info_t *di = NULL;
+    struct lyd_node *dup = NULL;
+    uint64_t seq = 0;
+
+    if (dm_is_journaled(dm_ctx, ds)) {
+        /* the content is identified by the journal sequence number and the mtime of the data file,
+         * that changes only when the file is rewritten, there is no need to wait until the mtime settles */
+        if ((-1 != fd && 0 != fstat(fd, &st)) || SR_ERR_OK != dm_get_journal_seq(dm_ctx, ds, schema_info->module_name, &seq)) {
+            return dm_load_data_tree_file(dm_ctx, fd, data_filename, schema_info, ds, data_info);
+        }
+    } else if (-1 == fd || (SR_DS_RUNNING != ds && SR_DS_STARTUP != ds) || 0 != fstat(fd, &st) ||
+            !dm_is_timestamp_settled(&st.st_mtim)) {
+        /* the content of the file can not be identified by its mtime */
+        return dm_load_data_tree_file(dm_ctx, fd, data_filename, schema_info, ds, data_info);
+    }
+
+    lookup.schema = schema_info;
+    lookup.ds = ds;
+    pthread_mutex_lock(&dm_ctx->snapshot_cache_lock);
+    snapshot = sr_btree_search(dm_ctx->snapshot_cache, &lookup);
+    if (NULL != snapshot && (snapshot->schema != schema_info || snapshot->journal_seq != seq ||
+            snapshot->timestamp.tv_sec != st.st_mtim.tv_sec || snapshot->timestamp.tv_nsec != st.st_mtim.tv_nsec)) {
+        snapshot = NULL;
+    }
+    if (NULL != snapshot) {
+        snapshot->ref_count++;
+    }
+    pthread_mutex_unlock(&dm_ctx->snapshot_cache_lock);
+
+    if (NULL != snapshot) {
+        di = calloc(1, sizeof(*di));
+        CHECK_NULL_NOMEM_GOTO(di, rc, cleanup);
+        di->schema = schema_info;
+        di->timestamp = snapshot->timestamp;
+        di->journal_seq = snapshot->journal_seq;
+        di->snapshot = snapshot;
+        di->shared = true;
+        di->node = snapshot->node;
+        snapshot = NULL;
+
+        pthread_mutex_lock(&schema_info->usage_count_mutex);
+        schema_info->usage_count++;
+        SR_LOG_DBG("Usage count %s incremented (value=%zu)", schema_info->module_name, schema_info->usage_count);
+        pthread_mutex_unlock(&schema_info->usage_count_mutex);
+
+        if (!shared) {
+            rc = dm_data_info_make_private(di);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to copy snapshot of module %s", schema_info->module_name);
+        }
+        SR_LOG_DBG("Data tree %s taken from snapshot", data_filename);
+        *data_info = di;
+        return rc;
+    }
+
+    /* snapshot is not available, parse the file */
+    rc = dm_load_data_tree_file(dm_ctx, fd, data_filename, schema_info, ds, &di);
+    CHECK_RC_LOG_RETURN(rc, "Loading of data tree %s failed", data_filename);
+
+    if (shared) {
+        /* the snapshot takes over the parsed data tree, the data info borrows it */
+        if (SR_ERR_OK == dm_data_snapshot_insert(dm_ctx, schema_info, ds, &st.st_mtim, di->journal_seq, di->node, &di->snapshot)) {
+            di->shared = true;
+        }
+    } else if (NULL == di->node || NULL != (dup = sr_dup_datatree(di->node))) {
+        if (SR_ERR_OK != dm_data_snapshot_insert(dm_ctx, schema_info, ds, &st.st_mtim, di->journal_seq, dup, NULL)) {
+            lyd_free_withsiblings(dup);
+        }
+    }
+    /* failure to create the snapshot is not fatal */
+    *data_info = di;
+    return SR_ERR_OK;
+
+cleanup:
+    dm_data_snapshot_release(snapshot);
+    dm_data_info_free(di);
+    return rc;
+#else
+    return dm_load_data_tree_file(dm_ctx, fd, data_filename, schema_info, ds, data_info);
+#endif
+}
+
+/**
+ * @brief Loads data tree from file. Module and datastore argument are used to
+ * determine the file name.
+ *
+ * @note Function expects that a schema info is locked for reading.
+ *
+ * @param [in] dm_ctx
+ * @param [in] dm_session_ctx
+ * @param [in] schema_info
+ * @param [in] ds
+ * @param [in] shared flag whether the returned data tree can be borrowed from the shared snapshot
+ * @param [out] data_info
+ * @return Error code (SR_ERR_OK on success), SR_ERR_INTERAL if the parsing of the data tree fails.
+ */
+static int
+dm_load_data_tree(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, dm_schema_info_t *schema_info, sr_datastore_t ds,
+        bool shared, dm_data_info_t **data_info)
+{
+    CHECK_NULL_ARG4(dm_ctx, schema_info, schema_info->module, schema_info->module->name);
+
+    char *data_filename = NULL;
+    int rc = 0;
+    *data_info = NULL;
+    rc = sr_get_data_file_name(dm_ctx->data_search_dir, schema_info->module->name, ds, &data_filename);
+    CHECK_RC_LOG_RETURN(rc, "Get data_filename failed for %s", schema_info->module->name);
+
+    ac_set_user_identity(dm_ctx->ac_ctx, dm_session_ctx->user_credentials);
+
+    int fd = open(data_filename, O_RDONLY);
+
+    ac_unset_user_identity(dm_ctx->ac_ctx);
+
+    if (-1 != fd) {
+        /* lock, read-only, blocking */
+        sr_lock_fd(fd, false, true);
+    } else if (ENOENT == errno) {
+        SR_LOG_DBG("Data file %s does not exist, creating empty data tree", data_filename);
+    } else if (EACCES == errno) {
+        SR_LOG_DBG("Data file %s can't be read because of access rights", data_filename);
+        free(data_filename);
+        return SR_ERR_UNAUTHORIZED;
+    }
+
+    rc = dm_load_data_tree_file_cached(dm_ctx, fd, data_filename, schema_info, ds, shared, data_info);
+
+    if (-1 != fd) {
+        sr_unlock_fd(fd);
+        close(fd);
+    }
+
+    free(data_filename);
     return rc;
 }
 
@@ -1262,6 +2557,11 @@ dm_free_sess_op(dm_sess_op_t *op)
     } else if (DM_MOVE_OP == op->op) {
         free(op->detail.mov.relative_item);
         op->detail.mov.relative_item = NULL;
+    } else if (DM_IMPORT_OP == op->op) {
+        free(op->detail.imp.module_name);
+        free(op->detail.imp.data);
+        op->detail.imp.module_name = NULL;
+        op->detail.imp.data = NULL;
     }
 }
 
@@ -1612,6 +2912,58 @@ dm_alloc_operation(dm_session_t *session, dm_operation_t op, const char *xpath)
     return rc;
 }
 
+int
+dm_add_import_operation(dm_session_t *session, const char *module_name, char *data, LYD_FORMAT format, bool replace)
+{
+    int rc = SR_ERR_OK;
+    char *xpath = NULL;
+    CHECK_NULL_ARG_NORET3(rc, session, module_name, data);
+    if (SR_ERR_OK != rc) {
+        goto cleanup;
+    }
+
+    /* the operation applies to the whole module */
+    rc = sr_asprintf(&xpath, "/%s:*", module_name);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to allocate xpath");
+
+    rc = dm_alloc_operation(session, DM_IMPORT_OP, xpath);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to allocate operation");
+
+    int index = session->oper_count[session->datastore];
+
+    session->operations[session->datastore][index].detail.imp.module_name = strdup(module_name);
+    CHECK_NULL_NOMEM_GOTO(session->operations[session->datastore][index].detail.imp.module_name, rc, cleanup);
+    session->operations[session->datastore][index].detail.imp.data = data;
+    session->operations[session->datastore][index].detail.imp.format = format;
+    session->operations[session->datastore][index].detail.imp.replace = replace;
+
+    session->oper_count[session->datastore]++;
+    free(xpath);
+    return rc;
+cleanup:
+    free(xpath);
+    free(data);
+    return rc;
+}
+
+int
+dm_reserve_operations(dm_session_t *session, size_t count)
+{
+    CHECK_NULL_ARG(session);
+    size_t required = session->oper_count[session->datastore] + count;
+
+    if (required <= session->oper_size[session->datastore]) {
+        return SR_ERR_OK;
+    }
+
+    dm_sess_op_t *tmp_op = realloc(session->operations[session->datastore], required * sizeof(*session->operations[session->datastore]));
+    CHECK_NULL_NOMEM_RETURN(tmp_op);
+    session->operations[session->datastore] = tmp_op;
+    session->oper_size[session->datastore] = required;
+
+    return SR_ERR_OK;
+}
+
 int
 dm_add_set_operation(dm_session_t *session, const char *xpath, sr_val_t *val, char *str_val, sr_edit_options_t opts)
 {
@@ -1933,62 +3285,396 @@ unlock:
     return rc;
 }
 
-int
-dm_init(ac_ctx_t *ac_ctx, np_ctx_t *np_ctx, pm_ctx_t *pm_ctx, const cm_connection_mode_t conn_mode,
-        const char *schema_search_dir, const char *data_search_dir, dm_ctx_t **dm_ctx)
+/**
+ * @brief Determines the format of data files used in the repository. The format can be selected
+ * per repository by the SR_DATA_FORMAT_FILE placed in the data search dir containing either
+ * "binary" or "xml". If the file is missing, compile-time default is used.
+ *
+ * @param [in] data_search_dir Location of the data files.
+ * @param [out] binary Set to true if the binary format should be used for writing.
+ */
+static void
+dm_get_data_file_format(const char *data_search_dir, bool *binary)
 {
-    CHECK_NULL_ARG3(schema_search_dir, data_search_dir, dm_ctx);
+    CHECK_NULL_ARG_VOID2(data_search_dir, binary);
+    char *format_file = NULL;
+    char format[16] = {0};
+    FILE *fp = NULL;
+    int rc = SR_ERR_OK;
 
-    SR_LOG_INF("Initializing Data Manager, schema_search_dir=%s, data_search_dir=%s", schema_search_dir, data_search_dir);
+#ifdef BINARY_DATA_FILES
+    *binary = true;
+#else
+    *binary = false;
+#endif
 
-    dm_ctx_t *ctx = NULL;
-    dm_tmp_ly_ctx_t *t_ctx = NULL;
+    rc = sr_str_join(data_search_dir, SR_DATA_FORMAT_FILE, &format_file);
+    if (SR_ERR_OK != rc) {
+        return;
+    }
+    fp = fopen(format_file, "r");
+    if (NULL != fp) {
+        if (NULL != fgets(format, sizeof(format), fp)) {
+            if (0 == strncmp(format, "binary", strlen("binary"))) {
+                *binary = true;
+            } else if (0 == strncmp(format, "xml", strlen("xml"))) {
+                *binary = false;
+            } else {
+                SR_LOG_WRN("Unknown data file format specified in %s, using the default one.", format_file);
+            }
+        }
+        fclose(fp);
+    }
+    free(format_file);
+}
+
+/**
+ * @brief Determines whether the commits into the repository are journaled. The mode can be selected
+ * per repository by the SR_DATA_PERSISTENCE_FILE placed in the data search dir containing either
+ * "journal" or "files". If the file is missing, compile-time default is used.
+ *
+ * @param [in] data_search_dir Location of the data files.
+ * @param [out] journal Set to true if the commits should be appended to the journal.
+ */
+static void
+dm_get_data_persistence(const char *data_search_dir, bool *journal)
+{
+    CHECK_NULL_ARG_VOID2(data_search_dir, journal);
+    char *persistence_file = NULL;
+    char persistence[16] = {0};
+    FILE *fp = NULL;
     int rc = SR_ERR_OK;
-    pthread_rwlockattr_t attr;
-    pthread_rwlockattr_init(&attr);
-    char *internal_schema_search_dir = NULL, *internal_data_search_dir = NULL;
-    ctx = calloc(1, sizeof(*ctx));
-    CHECK_NULL_NOMEM_GOTO(ctx, rc, cleanup);
-    ctx->ac_ctx = ac_ctx;
-    ctx->np_ctx = np_ctx;
-    ctx->pm_ctx = pm_ctx;
-    ctx->conn_mode = conn_mode;
 
-    ly_set_log_clb(dm_ly_log_cb, 1);
+#ifdef COMMIT_JOURNAL
+    *journal = true;
+#else
+    *journal = false;
+#endif
 
-    ctx->schema_search_dir = strdup(schema_search_dir);
-    CHECK_NULL_NOMEM_GOTO(ctx->schema_search_dir, rc, cleanup);
+    rc = sr_str_join(data_search_dir, SR_DATA_PERSISTENCE_FILE, &persistence_file);
+    if (SR_ERR_OK != rc) {
+        return;
+    }
+    fp = fopen(persistence_file, "r");
+    if (NULL != fp) {
+        if (NULL != fgets(persistence, sizeof(persistence), fp)) {
+            if (0 == strncmp(persistence, "journal", strlen("journal"))) {
+                *journal = true;
+            } else if (0 == strncmp(persistence, "files", strlen("files"))) {
+                *journal = false;
+            } else {
+                SR_LOG_WRN("Unknown data persistence specified in %s, using the default one.", persistence_file);
+            }
+        }
+        fclose(fp);
+    }
+    free(persistence_file);
+}
 
-    ctx->data_search_dir = strdup(data_search_dir);
-    CHECK_NULL_NOMEM_GOTO(ctx->data_search_dir, rc, cleanup);
+/**
+ * @brief Appends the image of the data tree to the journal of the module, the data file and the preceding
+ * records of the module are not used anymore.
+ * @note Expects that the data file of the module is locked for writing.
+ *
+ * @param [in] dm_ctx
+ * @param [in] ds
+ * @param [in] module_name
+ * @param [in] root Data tree of the module
+ * @param [out] seq Sequence number of the appended record
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_journal_append_image(dm_ctx_t *dm_ctx, sr_datastore_t ds, const char *module_name, const struct lyd_node *root,
+        uint64_t *seq)
+{
+    CHECK_NULL_ARG3(dm_ctx, module_name, seq);
+    dm_journal_t *journal = NULL;
+    dm_journal_batch_t *batch = NULL;
+    int rc = SR_ERR_OK;
 
-    ctx->ds_lock = calloc(DM_DATASTORE_COUNT, sizeof(*ctx->ds_lock));
-    CHECK_NULL_NOMEM_GOTO(ctx->ds_lock, rc, cleanup);
+    rc = dm_get_journal(dm_ctx, ds, module_name, &journal);
+    if (SR_ERR_OK == rc && NULL == journal) {
+        rc = SR_ERR_INTERNAL;
+    }
+    CHECK_RC_LOG_RETURN(rc, "Failed to get the journal of module %s", module_name);
 
-    rc = sr_locking_set_init(&ctx->locking_ctx);
-    CHECK_RC_MSG_GOTO(rc, cleanup, "Locking set init failed");
+    rc = dm_journal_batch_new(&batch);
+    CHECK_RC_MSG_RETURN(rc, "Journal batch allocation failed");
+    rc = dm_journal_batch_add_image(batch, root);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to create the image of module %s", module_name);
+    rc = dm_journal_append(journal, batch, seq);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to append the image of module %s", module_name);
 
-#if defined(HAVE_PTHREAD_RWLOCKATTR_SETKIND_NP)
-    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
-#endif
+cleanup:
+    dm_journal_batch_free(batch);
+    return rc;
+}
 
-    rc = pthread_rwlock_init(&ctx->schema_tree_lock, &attr);
-    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "lyctx mutex initialization failed");
+/**
+ * @brief Folds the journal records of the module into its data file and truncates the journal.
+ * An image of the module is appended to the journal before the data file is rewritten, the data file
+ * is not used until the journal is truncated, so that an interrupted checkpoint never replays the records
+ * on the rewritten data file. The checkpoint is postponed if the module is locked at the moment
+ * (e.g. being committed).
+ *
+ * @param [in] dm_ctx
+ * @param [in] ds
+ * @param [in] module_name
+ * @return Error code (SR_ERR_OK on success), SR_ERR_LOCKED if the checkpoint has been postponed
+ */
+static int
+dm_journal_checkpoint(dm_ctx_t *dm_ctx, sr_datastore_t ds, const char *module_name)
+{
+    CHECK_NULL_ARG2(dm_ctx, module_name);
+    dm_journal_t *journal = NULL;
+    dm_session_t *session = NULL;
+    dm_schema_info_t *schema_info = NULL;
+    dm_data_info_t *info = NULL;
+    char *file_name = NULL;
+    bool journal_locked = false;
+    uint64_t seq = 0;
+    int fd = -1;
+    int ret = 0;
+    int rc = SR_ERR_OK;
 
-    rc = sr_btree_init(dm_schema_info_cmp, dm_free_schema_info, &ctx->schema_info_tree);
-    CHECK_RC_MSG_GOTO(rc, cleanup, "Schema binary tree allocation failed");
+    rc = dm_get_journal(dm_ctx, ds, module_name, &journal);
+    CHECK_RC_LOG_RETURN(rc, "Failed to get the journal of module %s", module_name);
+    if (NULL == journal || 0 == dm_journal_size(journal)) {
+        return SR_ERR_OK;
+    }
 
-    rc = sr_btree_init(dm_c_ctx_id_cmp, dm_free_commit_context, &ctx->commit_ctxs.tree);
-    CHECK_RC_MSG_GOTO(rc, cleanup, "Commit context binary tree initialization failed");
+    rc = dm_session_start(dm_ctx, NULL, ds, &session);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Creating of temporary session failed");
 
-    rc = pthread_rwlock_init(&ctx->commit_ctxs.lock, &attr);
-    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "c_ctxs_lock init failed");
+    rc = dm_lock_module(dm_ctx, session, module_name);
+    if (SR_ERR_UNKNOWN_MODEL == rc) {
+        /* the journal of an uninstalled module is not used anymore */
+        SR_LOG_DBG("Journal of unknown module %s skipped", module_name);
+        rc = SR_ERR_OK;
+        goto cleanup;
+    }
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Module %s can not be locked, checkpoint postponed", module_name);
 
-    rc = pthread_mutex_init(&ctx->commit_ctxs.empty_mutex, NULL);
-    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "c_ctxs_empty_mutex init failed");
+    rc = dm_get_module_and_lock(dm_ctx, module_name, &schema_info);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to get schema of module %s", module_name);
 
-    rc = pthread_cond_init(&ctx->commit_ctxs.empty_cond, NULL);
-    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "c_ctxs_empty_cond init failed");
+    rc = sr_get_data_file_name(dm_ctx->data_search_dir, module_name, ds, &file_name);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Get data file name failed");
+
+    fd = open(file_name, O_RDWR);
+    if (-1 == fd) {
+        /* the checkpoint is left to a process allowed to write the data of the module */
+        SR_LOG_DBG("File %s can not be opened for writing, checkpoint postponed", file_name);
+        rc = EACCES == errno ? SR_ERR_UNAUTHORIZED : SR_ERR_IO;
+        goto cleanup;
+    }
+
+    /* try to lock for write, non-blocking */
+    rc = sr_lock_fd(fd, true, false);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "File %s can not be locked, checkpoint postponed", file_name);
+
+    rc = dm_journal_lock(journal, true);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to lock the journal of module %s", module_name);
+    journal_locked = true;
+
+    rc = dm_load_data_tree_file(dm_ctx, fd, file_name, schema_info, ds, &info);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Loading of data file %s failed", file_name);
+
+    rc = dm_journal_append_image(dm_ctx, ds, module_name, info->node, &seq);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to start the checkpoint");
+
+    ret = ftruncate(fd, 0);
+    if (0 == ret) {
+        ret = sr_lyd_print_data_fd(fd, info->node, dm_ctx->binary_data_files);
+    }
+    if (0 == ret) {
+        ret = fsync(fd);
+    }
+    if (0 != ret) {
+        /* the image is kept in the journal, the data file is not used until the next checkpoint */
+        SR_LOG_ERR("Failed to write data of '%s' module: %s", module_name, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+
+    rc = dm_journal_truncate(journal, &seq);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to truncate the journal of module %s", module_name);
+
+    dm_data_snapshot_update(dm_ctx, schema_info, ds, fd, info->node);
+    SR_LOG_INF("Checkpoint of the %s journal of module %s done", sr_ds_to_str(ds), module_name);
+
+cleanup:
+    if (journal_locked) {
+        dm_journal_unlock(journal);
+    }
+    if (NULL != info) {
+        dm_data_info_free(info);
+    }
+    if (-1 != fd) {
+        sr_unlock_fd(fd);
+        close(fd);
+    }
+    if (NULL != schema_info) {
+        pthread_rwlock_unlock(&schema_info->model_lock);
+    }
+    if (NULL != session) {
+        dm_session_stop(dm_ctx, session);
+    }
+    free(file_name);
+    return rc;
+}
+
+/**
+ * @brief Checkpoints all journals of startup and running datastore that contain some records,
+ * including the journals left by other processes.
+ */
+static void
+dm_journal_checkpoint_all(dm_ctx_t *dm_ctx)
+{
+    const char *exts[] = {SR_STARTUP_FILE_EXT SR_JOURNAL_FILE_EXT, SR_RUNNING_FILE_EXT SR_JOURNAL_FILE_EXT};
+    sr_datastore_t ds[] = {SR_DS_STARTUP, SR_DS_RUNNING};
+    DIR *dir = NULL;
+    struct dirent *entry = NULL;
+    char *module_name = NULL;
+    size_t len = 0, ext_len = 0;
+    int rc = SR_ERR_OK;
+
+    dir = opendir(dm_ctx->data_search_dir);
+    if (NULL == dir) {
+        SR_LOG_WRN("Unable to open the data directory %s: %s", dm_ctx->data_search_dir, sr_strerror_safe(errno));
+        return;
+    }
+    while (NULL != (entry = readdir(dir))) {
+        len = strlen(entry->d_name);
+        for (size_t i = 0; i < sizeof(ds) / sizeof(*ds); i++) {
+            ext_len = strlen(exts[i]);
+            if (len <= ext_len || 0 != strcmp(entry->d_name + len - ext_len, exts[i])) {
+                continue;
+            }
+            module_name = strndup(entry->d_name, len - ext_len);
+            rc = (NULL != module_name) ? dm_journal_checkpoint(dm_ctx, ds[i], module_name) : SR_ERR_NOMEM;
+            if (SR_ERR_OK != rc && SR_ERR_UNAUTHORIZED != rc) {
+                SR_LOG_WRN("Checkpoint of the journal %s failed, it will be retried later", entry->d_name);
+            }
+            free(module_name);
+        }
+    }
+    closedir(dir);
+}
+
+/**
+ * @brief Body of the thread that periodically folds the journal records into the data files.
+ */
+static void *
+dm_journal_checkpoint_thread(void *arg)
+{
+    dm_ctx_t *dm_ctx = (dm_ctx_t *) arg;
+    struct timespec ts = {0};
+
+    pthread_mutex_lock(&dm_ctx->checkpoint_mutex);
+    while (!dm_ctx->checkpoint_stop) {
+        if (!dm_ctx->checkpoint_requested) {
+            sr_clock_get_time(CLOCK_REALTIME, &ts);
+            ts.tv_sec += DM_JOURNAL_CHECKPOINT_INTERVAL;
+            pthread_cond_timedwait(&dm_ctx->checkpoint_cond, &dm_ctx->checkpoint_mutex, &ts);
+        }
+        if (dm_ctx->checkpoint_stop) {
+            break;
+        }
+        dm_ctx->checkpoint_requested = false;
+        pthread_mutex_unlock(&dm_ctx->checkpoint_mutex);
+
+        dm_journal_checkpoint_all(dm_ctx);
+
+        pthread_mutex_lock(&dm_ctx->checkpoint_mutex);
+    }
+    pthread_mutex_unlock(&dm_ctx->checkpoint_mutex);
+
+    return NULL;
+}
+
+int
+dm_init(ac_ctx_t *ac_ctx, np_ctx_t *np_ctx, pm_ctx_t *pm_ctx, const cm_connection_mode_t conn_mode,
+        const char *schema_search_dir, const char *data_search_dir, dm_ctx_t **dm_ctx)
+{
+    CHECK_NULL_ARG3(schema_search_dir, data_search_dir, dm_ctx);
+
+    SR_LOG_INF("Initializing Data Manager, schema_search_dir=%s, data_search_dir=%s", schema_search_dir, data_search_dir);
+
+    dm_ctx_t *ctx = NULL;
+    int rc = SR_ERR_OK;
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+    char *internal_schema_search_dir = NULL, *internal_data_search_dir = NULL;
+    ctx = calloc(1, sizeof(*ctx));
+    CHECK_NULL_NOMEM_GOTO(ctx, rc, cleanup);
+    ctx->ac_ctx = ac_ctx;
+    ctx->np_ctx = np_ctx;
+    ctx->pm_ctx = pm_ctx;
+    ctx->conn_mode = conn_mode;
+
+    ly_set_log_clb(dm_ly_log_cb, 1);
+
+    ctx->schema_search_dir = strdup(schema_search_dir);
+    CHECK_NULL_NOMEM_GOTO(ctx->schema_search_dir, rc, cleanup);
+
+    ctx->data_search_dir = strdup(data_search_dir);
+    CHECK_NULL_NOMEM_GOTO(ctx->data_search_dir, rc, cleanup);
+
+    dm_get_data_file_format(ctx->data_search_dir, &ctx->binary_data_files);
+    SR_LOG_INF("Data files are written in the %s format", ctx->binary_data_files ? "binary" : "XML");
+
+    dm_get_data_persistence(ctx->data_search_dir, &ctx->journal_commits);
+    if (ctx->journal_commits) {
+        SR_LOG_INF_MSG("Commits are appended to the journals of the modules");
+    }
+    rc = sr_btree_init(dm_module_journal_cmp, dm_module_journal_free, &ctx->journals);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Journal binary tree allocation failed");
+    pthread_mutex_init(&ctx->journals_lock, NULL);
+    pthread_mutex_init(&ctx->checkpoint_mutex, NULL);
+    pthread_cond_init(&ctx->checkpoint_cond, NULL);
+
+    ctx->full_validation = NULL != getenv(SR_FULL_VALIDATION_ENV) && 0 == strcmp(getenv(SR_FULL_VALIDATION_ENV), "1");
+    if (ctx->full_validation) {
+        SR_LOG_INF_MSG("Whole data trees will be validated on each change");
+    }
+
+    ctx->ds_lock = calloc(DM_DATASTORE_COUNT, sizeof(*ctx->ds_lock));
+    CHECK_NULL_NOMEM_GOTO(ctx->ds_lock, rc, cleanup);
+
+    rc = sr_locking_set_init(&ctx->locking_ctx);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Locking set init failed");
+
+#if defined(HAVE_PTHREAD_RWLOCKATTR_SETKIND_NP)
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+
+    rc = pthread_rwlock_init(&ctx->schema_tree_lock, &attr);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "lyctx mutex initialization failed");
+
+    rc = pthread_rwlock_init(&ctx->shared_ly_ctx_lock, NULL);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "shared lyctx lock initialization failed");
+
+    rc = sr_btree_init(dm_schema_info_cmp, dm_free_schema_info, &ctx->schema_info_tree);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Schema binary tree allocation failed");
+
+    rc = sr_btree_init(dm_c_ctx_id_cmp, dm_free_commit_context, &ctx->commit_ctxs.tree);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Commit context binary tree initialization failed");
+
+    rc = sr_btree_init(dm_data_snapshot_cmp, dm_data_snapshot_release_locked, &ctx->snapshot_cache);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Snapshot cache binary tree initialization failed");
+
+    rc = pthread_mutex_init(&ctx->snapshot_cache_lock, NULL);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "snapshot_cache_lock init failed");
+
+    rc = pthread_rwlock_init(&ctx->commit_ctxs.lock, &attr);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "c_ctxs_lock init failed");
+
+    rc = pthread_mutex_init(&ctx->commit_ctxs.empty_mutex, NULL);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "c_ctxs_empty_mutex init failed");
+
+    rc = pthread_cond_init(&ctx->commit_ctxs.empty_cond, NULL);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "c_ctxs_empty_cond init failed");
 
     ctx->commit_ctxs.empty = true;
 
@@ -2001,6 +3687,26 @@ dm_init(ac_ctx_t *ac_ctx, np_ctx_t *np_ctx, pm_ctx_t *pm_ctx, const cm_connectio
                  internal_data_search_dir, false, &ctx->md_ctx);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to initialize Module Dependencies context.");
 
+    if (NULL != getenv(SR_SHARED_SCHEMA_CTX_ENV) && 0 == strcmp(getenv(SR_SHARED_SCHEMA_CTX_ENV), "1")) {
+        rc = dm_shared_ly_ctx_init(ctx);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to build the shared schema context.");
+        SR_LOG_INF_MSG("All installed modules share a single schema context");
+    }
+
+    rc = pthread_mutex_init(&ctx->tmp_ly_ctx_pool.mutex, NULL);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "tmp_ly_ctx_pool mutex init failed");
+
+    rc = pthread_cond_init(&ctx->tmp_ly_ctx_pool.cond, NULL);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "tmp_ly_ctx_pool cond init failed");
+
+    rc = dm_work_pool_init(&ctx->work_pool, dm_get_work_thread_count());
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to start the work pool");
+
+    if (ctx->journal_commits) {
+        /* fold the records left by a previous run into the data files before anything reads them */
+        dm_journal_checkpoint_all(ctx);
+    }
+
 #ifdef ENABLE_NACM
     if (CM_MODE_DAEMON == conn_mode) {
         rc = nacm_init(ctx, ctx->data_search_dir, &ctx->nacm_ctx);
@@ -2009,18 +3715,12 @@ dm_init(ac_ctx_t *ac_ctx, np_ctx_t *np_ctx, pm_ctx_t *pm_ctx, const cm_connectio
         SR_LOG_INF_MSG("Sysrepo is running in the local mode => NACM will be disabled.");
     }
 #endif
-    t_ctx = calloc(1, sizeof(*t_ctx));
-    CHECK_NULL_NOMEM_GOTO(t_ctx, rc, cleanup);
-
-    pthread_mutex_init(&t_ctx->mutex, NULL);
-    rc = sr_list_init(&t_ctx->loaded_modules);
-    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to initialize a list");
-
-    t_ctx->ctx = ly_ctx_new(ctx->schema_search_dir);
-    CHECK_NULL_NOMEM_GOTO(t_ctx->ctx, rc, cleanup);
 
-    ctx->tmp_ly_ctx = t_ctx;
-    t_ctx = NULL;
+    if (ctx->journal_commits) {
+        rc = pthread_create(&ctx->checkpoint_thread, NULL, dm_journal_checkpoint_thread, ctx);
+        CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "Failed to start the journal checkpoint thread");
+        ctx->checkpoint_thread_running = true;
+    }
 
     *dm_ctx = ctx;
 
@@ -2030,7 +3730,6 @@ cleanup:
     pthread_rwlockattr_destroy(&attr);
     if (SR_ERR_OK != rc) {
         dm_cleanup(ctx);
-        dm_free_tmp_ly_ctx(t_ctx);
     }
     return rc;
 
@@ -2040,20 +3739,40 @@ void
 dm_cleanup(dm_ctx_t *dm_ctx)
 {
     if (NULL != dm_ctx) {
+        if (dm_ctx->checkpoint_thread_running) {
+            pthread_mutex_lock(&dm_ctx->checkpoint_mutex);
+            dm_ctx->checkpoint_stop = true;
+            pthread_cond_signal(&dm_ctx->checkpoint_cond);
+            pthread_mutex_unlock(&dm_ctx->checkpoint_mutex);
+            pthread_join(dm_ctx->checkpoint_thread, NULL);
+            /* leave the data files up to date */
+            dm_journal_checkpoint_all(dm_ctx);
+        }
+        dm_work_pool_cleanup(&dm_ctx->work_pool);
         nacm_cleanup(dm_ctx->nacm_ctx);
         sr_btree_cleanup(dm_ctx->commit_ctxs.tree);
         free(dm_ctx->schema_search_dir);
         free(dm_ctx->data_search_dir);
         free(dm_ctx->ds_lock);
+        sr_btree_cleanup(dm_ctx->snapshot_cache);
+        pthread_mutex_destroy(&dm_ctx->snapshot_cache_lock);
         sr_btree_cleanup(dm_ctx->schema_info_tree);
+        if (NULL != dm_ctx->shared_ly_ctx) {
+            ly_ctx_destroy(dm_ctx->shared_ly_ctx, dm_free_lys_private_data);
+        }
         md_destroy(dm_ctx->md_ctx);
         pthread_rwlock_destroy(&dm_ctx->schema_tree_lock);
+        pthread_rwlock_destroy(&dm_ctx->shared_ly_ctx_lock);
         sr_locking_set_cleanup(dm_ctx->locking_ctx);
         pthread_mutex_destroy(&dm_ctx->ds_lock_mutex);
         pthread_rwlock_destroy(&dm_ctx->commit_ctxs.lock);
         pthread_mutex_destroy(&dm_ctx->commit_ctxs.empty_mutex);
         pthread_cond_destroy(&dm_ctx->commit_ctxs.empty_cond);
-        dm_free_tmp_ly_ctx(dm_ctx->tmp_ly_ctx);
+        dm_tmp_ly_ctx_pool_cleanup(&dm_ctx->tmp_ly_ctx_pool);
+        sr_btree_cleanup(dm_ctx->journals);
+        pthread_mutex_destroy(&dm_ctx->journals_lock);
+        pthread_mutex_destroy(&dm_ctx->checkpoint_mutex);
+        pthread_cond_destroy(&dm_ctx->checkpoint_cond);
         free(dm_ctx);
     }
 }
@@ -2261,8 +3980,19 @@ cleanup:
     return rc;
 }
 
-int
-dm_get_data_info(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, dm_data_info_t **info)
+/**
+ * @brief Returns the session copy of the data tree, loads it if it has not been loaded yet.
+ *
+ * @param [in] dm_ctx
+ * @param [in] dm_session_ctx
+ * @param [in] module_name
+ * @param [in] rdonly if set to false, the data tree of the returned data info is made private (editable)
+ * @param [out] info
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_get_data_info_internal(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, bool rdonly,
+        dm_data_info_t **info)
 {
     CHECK_NULL_ARG4(dm_ctx, dm_session_ctx, module_name, info);
     int rc = SR_ERR_OK;
@@ -2277,6 +4007,10 @@ dm_get_data_info(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *mod
     exisiting_data_info = sr_btree_search(dm_session_ctx->session_modules[dm_session_ctx->datastore], &lookup_data);
 
     if (NULL != exisiting_data_info) {
+        if (!rdonly) {
+            rc = dm_data_info_make_private(exisiting_data_info);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to make data tree %s private", module_name);
+        }
         *info = exisiting_data_info;
         SR_LOG_DBG("Module %s already loaded", module_name);
         goto cleanup;
@@ -2285,7 +4019,7 @@ dm_get_data_info(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *mod
     /* session copy not found load it from file system */
     dm_data_info_t *di = NULL;
     if (SR_DS_CANDIDATE == dm_session_ctx->datastore) {
-        rc = dm_load_data_tree(dm_ctx, dm_session_ctx, schema_info, SR_DS_RUNNING, &di);
+        rc = dm_load_data_tree(dm_ctx, dm_session_ctx, schema_info, SR_DS_RUNNING, false, &di);
         CHECK_RC_LOG_GOTO(rc, cleanup, "Getting data tree for %s failed.", module_name);
         rc = dm_remove_not_enabled_nodes(di);
         if (SR_ERR_OK != rc) {
@@ -2295,7 +4029,7 @@ dm_get_data_info(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *mod
         }
     }
     else {
-        rc = dm_load_data_tree(dm_ctx, dm_session_ctx, schema_info, dm_session_ctx->datastore, &di);
+        rc = dm_load_data_tree(dm_ctx, dm_session_ctx, schema_info, dm_session_ctx->datastore, rdonly, &di);
         CHECK_RC_LOG_GOTO(rc, cleanup, "Getting data tree for %s failed.", module_name);
     }
 
@@ -2314,13 +4048,25 @@ cleanup:
     return rc;
 }
 
+int
+dm_get_data_info(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, dm_data_info_t **info)
+{
+    return dm_get_data_info_internal(dm_ctx, dm_session_ctx, module_name, false, info);
+}
+
+int
+dm_get_data_info_rdonly(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, dm_data_info_t **info)
+{
+    return dm_get_data_info_internal(dm_ctx, dm_session_ctx, module_name, true, info);
+}
+
 int
 dm_get_datatree(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, struct lyd_node **data_tree)
 {
     CHECK_NULL_ARG4(dm_ctx, dm_session_ctx, module_name, data_tree);
     int rc = SR_ERR_OK;
     dm_data_info_t *info = NULL;
-    rc = dm_get_data_info(dm_ctx, dm_session_ctx, module_name, &info);
+    rc = dm_get_data_info_rdonly(dm_ctx, dm_session_ctx, module_name, &info);
     CHECK_RC_LOG_RETURN(rc, "Get data info failed for module %s", module_name);
     *data_tree = info->node;
     if (NULL == info->node) {
@@ -2415,93 +4161,272 @@ dm_get_module_without_lock(dm_ctx_t *dm_ctx, const char *module_name, dm_schema_
     return rc;
 }
 
+/**
+ * @brief Inserts the schema info into the commit lock set keeping the set sorted by module name.
+ * If the module is already in the set, the lock type is upgraded to write if requested.
+ */
 static int
-dm_list_rev_file(dm_ctx_t *dm_ctx, sr_mem_ctx_t *sr_mem, const char *module_name, const char *rev_date, sr_sch_revision_t *rev)
+dm_commit_lock_set_insert(dm_commit_lock_set_t *set, dm_schema_info_t *schema_info, bool write)
 {
-    CHECK_NULL_ARG3(dm_ctx, module_name, rev);
-    int rc = SR_ERR_OK;
-    char *file_name = NULL;
+    CHECK_NULL_ARG2(set, schema_info);
+    dm_schema_info_t **tmp_schemas = NULL;
+    bool *tmp_write = NULL;
+    size_t pos = 0;
+    int cmp = 0;
 
-    if (NULL != rev_date && 0 != strcmp("", rev_date)) {
-        sr_mem_edit_string(sr_mem, (char **)&rev->revision, rev_date);
-        CHECK_NULL_NOMEM_GOTO(rev->revision, rc, cleanup);
+    if (set->locked) {
+        SR_LOG_ERR_MSG("Module can not be added into the commit lock set that is already locked");
+        return SR_ERR_INTERNAL;
     }
 
-    rc = sr_get_schema_file_name(dm_ctx->schema_search_dir, module_name, rev_date, true, &file_name);
-    if (SR_ERR_OK == rc) {
-        if (-1 != access(file_name, F_OK)) {
-            rc = sr_mem_edit_string(sr_mem, (char **)&rev->file_path_yang, file_name);
+    for (pos = 0; pos < set->count; pos++) {
+        cmp = strcmp(set->schemas[pos]->module_name, schema_info->module_name);
+        if (0 == cmp) {
+            set->write[pos] = set->write[pos] || write;
+            return SR_ERR_OK;
+        } else if (cmp > 0) {
+            break;
         }
     }
-    CHECK_RC_MSG_GOTO(rc, cleanup, "Get schema file name failed");
-
-    free(file_name);
-    file_name = NULL;
 
-    rc = sr_get_schema_file_name(dm_ctx->schema_search_dir, module_name, rev_date, false, &file_name);
-    if (SR_ERR_OK == rc) {
-        if (-1 != access(file_name, F_OK)) {
-            sr_mem_edit_string(sr_mem, (char **)&rev->file_path_yin, file_name);
-        }
+    if (set->count == set->size) {
+        set->size = 0 == set->size ? 4 : set->size * 2;
+        tmp_schemas = realloc(set->schemas, set->size * sizeof(*set->schemas));
+        CHECK_NULL_NOMEM_RETURN(tmp_schemas);
+        set->schemas = tmp_schemas;
+        tmp_write = realloc(set->write, set->size * sizeof(*set->write));
+        CHECK_NULL_NOMEM_RETURN(tmp_write);
+        set->write = tmp_write;
     }
-    CHECK_RC_MSG_GOTO(rc, cleanup, "Get schema file name failed");
+    memmove(&set->schemas[pos + 1], &set->schemas[pos], (set->count - pos) * sizeof(*set->schemas));
+    memmove(&set->write[pos + 1], &set->write[pos], (set->count - pos) * sizeof(*set->write));
+    set->schemas[pos] = schema_info;
+    set->write[pos] = write;
+    set->count++;
 
-    free(file_name);
-    return rc;
-
-cleanup:
-    free(file_name);
-    if (NULL == sr_mem) {
-        free((void*) rev->revision);
-        free((void*) rev->file_path_yang);
-        free((void*) rev->file_path_yin);
-    }
-    return rc;
+    return SR_ERR_OK;
 }
 
-/**
- * @brief Fills the schema_t structure for one module all its revisions and submodules
- * @param [in] dm_ctx
- * @param [in] dm_session
- * @param [in] module
- * @param [in] schs
- * @return Error code (SR_ERR_OK on success)
- */
-static int
-dm_list_module(dm_ctx_t *dm_ctx, dm_session_t *dm_session, md_module_t *module, sr_schema_t *schema)
+int
+dm_commit_lock_set_add(dm_ctx_t *dm_ctx, dm_commit_lock_set_t *set, const char *module_name, bool write)
 {
-    CHECK_NULL_ARG4(dm_ctx, dm_session, module, schema);
+    CHECK_NULL_ARG3(dm_ctx, set, module_name);
+    dm_schema_info_t *schema_info = NULL;
+    md_module_t *module = NULL;
+    md_dep_t *dep = NULL;
+    sr_llist_node_t *ll_node = NULL;
+    sr_list_t *data_deps = NULL;
+    char *dep_name = NULL;
     int rc = SR_ERR_OK;
-    bool module_enabled = false;
-    size_t enabled_subtrees_cnt = 0;
-    char **enabled_subtrees = NULL;
-    sr_llist_node_t *dep = NULL;
-    md_dep_t *dep_mod = NULL;
-    size_t submod_cnt = 0;
-    sr_mem_ctx_t *sr_mem = schema->_sr_mem;
 
-    sr_mem_edit_string(sr_mem, (char **)&schema->module_name, module->name);
-    CHECK_NULL_NOMEM_GOTO(schema->module_name, rc, cleanup);
+    rc = dm_get_module_without_lock(dm_ctx, module_name, &schema_info);
+    if (SR_ERR_OK != rc) {
+        /* unknown module, nothing to be locked */
+        return SR_ERR_OK;
+    }
 
-    sr_mem_edit_string(sr_mem, (char **)&schema->ns, module->ns);
-    CHECK_NULL_NOMEM_GOTO(schema->ns, rc, cleanup);
+    rc = dm_commit_lock_set_insert(set, schema_info, write);
+    CHECK_RC_LOG_RETURN(rc, "Failed to add module %s into the commit lock set", module_name);
 
-    sr_mem_edit_string(sr_mem, (char **)&schema->prefix, module->prefix);
-    CHECK_NULL_NOMEM_GOTO(schema->prefix, rc, cleanup);
+    if (!schema_info->cross_module_data_dependency) {
+        return SR_ERR_OK;
+    }
 
-    schema->implemented = module->implemented;
+    /* the data of the modules this module depends on are read during validation */
+    rc = sr_list_init(&data_deps);
+    CHECK_RC_MSG_RETURN(rc, "List init failed");
 
-    rc = dm_list_rev_file(dm_ctx, sr_mem, module->name, module->revision_date, &schema->revision);
-    CHECK_RC_LOG_GOTO(rc, cleanup, "List rev file failed module %s", module->name);
+    md_ctx_lock(dm_ctx->md_ctx, false);
+    rc = md_get_module_info(dm_ctx->md_ctx, module_name, NULL, &module);
+    if (SR_ERR_OK == rc) {
+        ll_node = module->deps->first;
+        while (SR_ERR_OK == rc && ll_node) {
+            dep = (md_dep_t *)ll_node->data;
+            if (MD_DEP_DATA == dep->type && dep->dest->latest_revision) {
+                dep_name = strdup(dep->dest->name);
+                rc = NULL != dep_name ? sr_list_add(data_deps, dep_name) : SR_ERR_NOMEM;
+                if (SR_ERR_OK != rc) {
+                    free(dep_name);
+                }
+            }
+            ll_node = ll_node->next;
+        }
+    }
+    md_ctx_unlock(dm_ctx->md_ctx);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to get the list of dependencies for module '%s'.", module_name);
 
-    dep = module->deps->first;
-    while (NULL != dep) {
-        dep_mod = (md_dep_t *) dep->data;
-        dep = dep->next;
-        if (!dep_mod->dest->submodule) {
-            continue;
+    /* md deps are transitively closed, no recursion needed */
+    for (size_t i = 0; i < data_deps->count; i++) {
+        if (SR_ERR_OK == dm_get_module_without_lock(dm_ctx, data_deps->data[i], &schema_info)) {
+            rc = dm_commit_lock_set_insert(set, schema_info, false);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to add module %s into the commit lock set", (char *) data_deps->data[i]);
         }
-        submod_cnt++;
+    }
+
+cleanup:
+    sr_free_list_of_strings(data_deps);
+    return rc;
+}
+
+int
+dm_commit_lock_set_add_session_modules(dm_ctx_t *dm_ctx, dm_commit_lock_set_t *set, dm_session_t *session,
+        bool modified_only, bool write)
+{
+    CHECK_NULL_ARG3(dm_ctx, set, session);
+    dm_data_info_t *info = NULL;
+    size_t i = 0;
+    int rc = SR_ERR_OK;
+
+    while (NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], i++))) {
+        if (modified_only && !info->modified) {
+            continue;
+        }
+        rc = dm_commit_lock_set_add(dm_ctx, set, info->schema->module_name, write);
+        CHECK_RC_MSG_RETURN(rc, "Failed to add session module into the commit lock set");
+    }
+    return rc;
+}
+
+int
+dm_commit_lock_set_add_all(dm_ctx_t *dm_ctx, dm_commit_lock_set_t *set, dm_session_t *session, bool write)
+{
+    CHECK_NULL_ARG3(dm_ctx, set, session);
+    sr_list_t *modules = NULL;
+    int rc = SR_ERR_OK;
+
+    rc = dm_get_all_modules(dm_ctx, session, false, &modules);
+    CHECK_RC_MSG_RETURN(rc, "Get all modules failed");
+
+    for (size_t i = 0; i < modules->count; i++) {
+        rc = dm_commit_lock_set_add(dm_ctx, set, modules->data[i], write);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to add module into the commit lock set");
+    }
+
+cleanup:
+    sr_list_cleanup(modules);
+    return rc;
+}
+
+void
+dm_commit_lock_set_acquire(dm_commit_lock_set_t *set)
+{
+    CHECK_NULL_ARG_VOID(set);
+
+    if (set->locked) {
+        return;
+    }
+    for (size_t i = 0; i < set->count; i++) {
+        if (set->write[i]) {
+            pthread_rwlock_wrlock(&set->schemas[i]->commit_lock);
+        } else {
+            pthread_rwlock_rdlock(&set->schemas[i]->commit_lock);
+        }
+    }
+    set->locked = true;
+}
+
+void
+dm_commit_lock_set_cleanup(dm_commit_lock_set_t *set)
+{
+    CHECK_NULL_ARG_VOID(set);
+
+    if (set->locked) {
+        for (size_t i = set->count; i > 0; i--) {
+            pthread_rwlock_unlock(&set->schemas[i - 1]->commit_lock);
+        }
+    }
+    free(set->schemas);
+    free(set->write);
+    memset(set, 0, sizeof(*set));
+}
+
+static int
+dm_list_rev_file(dm_ctx_t *dm_ctx, sr_mem_ctx_t *sr_mem, const char *module_name, const char *rev_date, sr_sch_revision_t *rev)
+{
+    CHECK_NULL_ARG3(dm_ctx, module_name, rev);
+    int rc = SR_ERR_OK;
+    char *file_name = NULL;
+
+    if (NULL != rev_date && 0 != strcmp("", rev_date)) {
+        sr_mem_edit_string(sr_mem, (char **)&rev->revision, rev_date);
+        CHECK_NULL_NOMEM_GOTO(rev->revision, rc, cleanup);
+    }
+
+    rc = sr_get_schema_file_name(dm_ctx->schema_search_dir, module_name, rev_date, true, &file_name);
+    if (SR_ERR_OK == rc) {
+        if (-1 != access(file_name, F_OK)) {
+            rc = sr_mem_edit_string(sr_mem, (char **)&rev->file_path_yang, file_name);
+        }
+    }
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Get schema file name failed");
+
+    free(file_name);
+    file_name = NULL;
+
+    rc = sr_get_schema_file_name(dm_ctx->schema_search_dir, module_name, rev_date, false, &file_name);
+    if (SR_ERR_OK == rc) {
+        if (-1 != access(file_name, F_OK)) {
+            sr_mem_edit_string(sr_mem, (char **)&rev->file_path_yin, file_name);
+        }
+    }
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Get schema file name failed");
+
+    free(file_name);
+    return rc;
+
+cleanup:
+    free(file_name);
+    if (NULL == sr_mem) {
+        free((void*) rev->revision);
+        free((void*) rev->file_path_yang);
+        free((void*) rev->file_path_yin);
+    }
+    return rc;
+}
+
+/**
+ * @brief Fills the schema_t structure for one module all its revisions and submodules
+ * @param [in] dm_ctx
+ * @param [in] dm_session
+ * @param [in] module
+ * @param [in] schs
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_list_module(dm_ctx_t *dm_ctx, dm_session_t *dm_session, md_module_t *module, sr_schema_t *schema)
+{
+    CHECK_NULL_ARG4(dm_ctx, dm_session, module, schema);
+    int rc = SR_ERR_OK;
+    bool module_enabled = false;
+    size_t enabled_subtrees_cnt = 0;
+    char **enabled_subtrees = NULL;
+    sr_llist_node_t *dep = NULL;
+    md_dep_t *dep_mod = NULL;
+    size_t submod_cnt = 0;
+    sr_mem_ctx_t *sr_mem = schema->_sr_mem;
+
+    sr_mem_edit_string(sr_mem, (char **)&schema->module_name, module->name);
+    CHECK_NULL_NOMEM_GOTO(schema->module_name, rc, cleanup);
+
+    sr_mem_edit_string(sr_mem, (char **)&schema->ns, module->ns);
+    CHECK_NULL_NOMEM_GOTO(schema->ns, rc, cleanup);
+
+    sr_mem_edit_string(sr_mem, (char **)&schema->prefix, module->prefix);
+    CHECK_NULL_NOMEM_GOTO(schema->prefix, rc, cleanup);
+
+    schema->implemented = module->implemented;
+
+    rc = dm_list_rev_file(dm_ctx, sr_mem, module->name, module->revision_date, &schema->revision);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "List rev file failed module %s", module->name);
+
+    dep = module->deps->first;
+    while (NULL != dep) {
+        dep_mod = (md_dep_t *) dep->data;
+        dep = dep->next;
+        if (!dep_mod->dest->submodule) {
+            continue;
+        }
+        submod_cnt++;
     }
 
     if (0 < submod_cnt) {
@@ -2842,80 +4767,752 @@ dm_requires_tmp_context(dm_ctx_t *dm_ctx, dm_session_t *session, dm_data_info_t
                     rc = sr_list_init(required_data);
                     CHECK_RC_MSG_GOTO(rc, cleanup, "List initialization failed");
 
-                    /* insert module itself */
-                    module_name = strdup(di->schema->module_name);
-                    CHECK_NULL_NOMEM_GOTO(module_name, rc, cleanup);
+                    /* insert module itself */
+                    module_name = strdup(di->schema->module_name);
+                    CHECK_NULL_NOMEM_GOTO(module_name, rc, cleanup);
+
+                    rc = sr_list_insert_unique_ord(*required_modules, module_name, dm_string_cmp, &inserted);
+                    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to insert item into the list");
+
+                    rc = sr_list_add(*required_data, module_name);
+                    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to insert item into the list");
+
+                    /* add installation time dependencies */
+                    ll_dep = module->deps->first;
+                    while (ll_dep) {
+                       dep = (md_dep_t *) ll_dep->data;
+                       ll_dep = ll_dep->next;
+
+                       module_name = strdup(dep->dest->name);
+                       CHECK_NULL_NOMEM_GOTO(module_name, rc, cleanup);
+
+                       rc = sr_list_insert_unique_ord(*required_modules, module_name, dm_string_cmp, &inserted);
+                       CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to insert item into the list");
+
+                       if (inserted && dep->dest->has_data) {
+                           rc = sr_list_add(*required_data, module_name);
+                           CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to add item into the list");
+                       }
+
+                       /* if dep has instanced id and it was inserted call recursively */
+                       if (inserted && NULL != dep->dest->inst_ids->first) {
+                           rc = dm_get_data_info(dm_ctx, session, dep->dest->name, &recursive_info);
+                           CHECK_RC_LOG_GOTO(rc, cleanup, "Get data info failed for %s", dep->dest->name);
+
+                           rc = dm_requires_tmp_context(dm_ctx, session, recursive_info, required_data, required_modules);
+                           CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to resolve recusrive deps in %s", recursive_info->schema->module_name);
+
+                       } else if (!inserted){
+                           free(module_name);
+                       }
+                    }
+                }
+                inserted = false;
+                rc = sr_list_insert_unique_ord(*required_modules, namespace, dm_string_cmp, &inserted);
+                CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
+                inserted_namespace = namespace;
+                namespace = NULL; /* do not free namespace in this function case of cleanup */
+
+                if (inserted) {
+                    rc = sr_list_add(*required_data, inserted_namespace);
+                    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to insert an item into the list");
+
+                    /* call recursively */
+                    rc = dm_get_data_info(dm_ctx, session, inserted_namespace, &recursive_info);
+                    CHECK_RC_LOG_GOTO(rc, cleanup, "Get data info failed for %s", inserted_namespace);
+
+                    rc = dm_requires_tmp_context(dm_ctx, session, recursive_info, required_data, required_modules);
+                    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to resolve recusrive deps in %s", recursive_info->schema->module_name);
+                }
+            }
+        }
+        ly_set_free(set);
+        set = NULL;
+    }
+
+cleanup:
+    if (SR_ERR_OK != rc) {
+        sr_free_list_of_strings(*required_modules);
+        *required_modules = NULL;
+    }
+    free(namespace);
+    ly_set_free(set);
+    md_ctx_unlock(dm_ctx->md_ctx);
+    return rc;
+}
+
+/**
+ * @brief Clears the record of the changes made since the last successful validation.
+ * @param [in] info
+ */
+static void
+dm_data_info_reset_modified_subtrees(dm_data_info_t *info)
+{
+    sr_free_list_of_strings(info->modified_subtrees);
+    info->modified_subtrees = NULL;
+    info->modified_untracked = false;
+}
+
+int
+dm_data_info_set_modified(dm_data_info_t *info, const char *xpath)
+{
+    CHECK_NULL_ARG(info);
+    int rc = SR_ERR_OK;
+    const char *name = NULL;
+    char *subtree = NULL;
+    size_t len = 0, mod_len = 0;
+
+    info->modified = true;
+    if (info->modified_untracked) {
+        return SR_ERR_OK;
+    }
+
+    /* extract the name of the top-level node from /module:node... */
+    if (NULL != xpath && NULL != info->schema && NULL != info->schema->module_name && '/' == xpath[0]) {
+        mod_len = strlen(info->schema->module_name);
+        if (0 == strncmp(xpath + 1, info->schema->module_name, mod_len) && ':' == xpath[mod_len + 1]) {
+            name = xpath + mod_len + 2;
+            len = strcspn(name, "/[");
+        }
+    }
+    if (0 == len || NULL != memchr(name, '*', len)) {
+        /* the change can not be attributed to a single top-level subtree */
+        dm_data_info_reset_modified_subtrees(info);
+        info->modified_untracked = true;
+        return SR_ERR_OK;
+    }
+
+    for (size_t i = 0; NULL != info->modified_subtrees && i < info->modified_subtrees->count; i++) {
+        subtree = (char *) info->modified_subtrees->data[i];
+        if (0 == strncmp(subtree, name, len) && '\0' == subtree[len]) {
+            return SR_ERR_OK;
+        }
+    }
+
+    if (NULL == info->modified_subtrees) {
+        rc = sr_list_init(&info->modified_subtrees);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "List init failed");
+    }
+    subtree = strndup(name, len);
+    CHECK_NULL_NOMEM_GOTO(subtree, rc, cleanup);
+    rc = sr_list_add(info->modified_subtrees, subtree);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
+    subtree = NULL;
+
+cleanup:
+    free(subtree);
+    if (SR_ERR_OK != rc) {
+        /* the change must not be lost, the whole tree will be validated */
+        dm_data_info_reset_modified_subtrees(info);
+        info->modified_untracked = true;
+    }
+    return rc;
+}
+
+/**
+ * @brief Returns the index of the top-level subtree the schema node belongs to, -1 if the node
+ * is not part of the data of the module.
+ */
+static int
+dm_subtree_deps_index(const dm_subtree_deps_t *deps, const struct lys_node *node)
+{
+    const struct lys_node *top = NULL;
+
+    for (; NULL != node; node = lys_parent(node)) {
+        if ((LYS_CONTAINER | LYS_LIST | LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA) & node->nodetype) {
+            top = node;
+        }
+    }
+    for (size_t i = 0; NULL != top && i < deps->count; i++) {
+        if (deps->nodes[i] == top) {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Records that the constraints in the subtree reference the schema node.
+ */
+static void
+dm_subtree_deps_add_ref(dm_subtree_deps_t *deps, size_t idx, const struct lys_node *target)
+{
+    int target_idx = dm_subtree_deps_index(deps, target);
+
+    if (target_idx < 0) {
+        /* data of another module or a node that can not be attributed to a subtree */
+        deps->refs_any[idx] = true;
+    } else {
+        deps->refs[idx * deps->count + target_idx] = true;
+    }
+}
+
+/**
+ * @brief Records the schema nodes accessed by the must or when expression evaluated in the context of the node.
+ */
+static void
+dm_subtree_deps_add_xpath(dm_subtree_deps_t *deps, size_t idx, const struct lys_node *ctx_node, const char *expr,
+        int options)
+{
+    struct ly_set *atoms = NULL;
+
+    /* expressions of choice, case and uses are evaluated in the context of the closest data node */
+    while (NULL != ctx_node && !((LYS_CONTAINER | LYS_LIST | LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA) & ctx_node->nodetype)) {
+        ctx_node = lys_parent(ctx_node);
+    }
+    if (NULL == ctx_node || NULL == expr) {
+        deps->refs_any[idx] = true;
+        return;
+    }
+
+    atoms = lys_xpath_atomize(ctx_node, LYXP_NODE_ELEM, expr, options);
+    if (NULL == atoms) {
+        SR_LOG_WRN("Failed to atomize xpath '%s', the whole data tree will be validated.", expr);
+        deps->refs_any[idx] = true;
+        return;
+    }
+    for (unsigned int i = 0; i < atoms->number && !deps->refs_any[idx]; i++) {
+        dm_subtree_deps_add_ref(deps, idx, atoms->set.s[i]);
+    }
+    ly_set_free(atoms);
+}
+
+/**
+ * @brief Records the data referenced by the type if it is (or is a union containing) a leafref
+ * or an instance-identifier.
+ */
+static void
+dm_subtree_deps_add_type(dm_subtree_deps_t *deps, size_t idx, const struct lys_type *type)
+{
+    if (LY_TYPE_LEAFREF == type->base) {
+        if (NULL == type->info.lref.target) {
+            deps->refs_any[idx] = true;
+        } else {
+            dm_subtree_deps_add_ref(deps, idx, (const struct lys_node *) type->info.lref.target);
+        }
+    } else if (LY_TYPE_INST == type->base) {
+        /* the instance can be anywhere */
+        deps->refs_any[idx] = true;
+    } else if (LY_TYPE_UNION == type->base) {
+        /* member types are stored in the typedef that introduced the union */
+        while (0 == type->info.uni.count && NULL != type->der) {
+            type = &type->der->type;
+        }
+        for (unsigned int i = 0; i < type->info.uni.count; i++) {
+            dm_subtree_deps_add_type(deps, idx, &type->info.uni.types[i]);
+        }
+    }
+}
+
+/**
+ * @brief Records the data referenced by the must and when conditions, leafrefs and instance-identifiers
+ * of the schema node.
+ */
+static void
+dm_subtree_deps_add_node(dm_subtree_deps_t *deps, size_t idx, const struct lys_node *node)
+{
+    const struct lys_when *when = NULL;
+    const struct lys_restr *must = NULL;
+    uint8_t must_size = 0;
+
+    switch (node->nodetype) {
+        case LYS_CONTAINER:
+            when = ((struct lys_node_container *) node)->when;
+            must = ((struct lys_node_container *) node)->must;
+            must_size = ((struct lys_node_container *) node)->must_size;
+            break;
+        case LYS_LIST:
+            when = ((struct lys_node_list *) node)->when;
+            must = ((struct lys_node_list *) node)->must;
+            must_size = ((struct lys_node_list *) node)->must_size;
+            break;
+        case LYS_CHOICE:
+            when = ((struct lys_node_choice *) node)->when;
+            break;
+        case LYS_CASE:
+            when = ((struct lys_node_case *) node)->when;
+            break;
+        case LYS_USES:
+            when = ((struct lys_node_uses *) node)->when;
+            break;
+        case LYS_ANYDATA:
+        case LYS_ANYXML:
+            when = ((struct lys_node_anydata *) node)->when;
+            must = ((struct lys_node_anydata *) node)->must;
+            must_size = ((struct lys_node_anydata *) node)->must_size;
+            break;
+        case LYS_LEAF:
+        case LYS_LEAFLIST:
+            when = ((struct lys_node_leaf *) node)->when;
+            must = ((struct lys_node_leaf *) node)->must;
+            must_size = ((struct lys_node_leaf *) node)->must_size;
+            dm_subtree_deps_add_type(deps, idx, &((struct lys_node_leaf *) node)->type);
+            break;
+        default:
+            break;
+    }
+
+    if (NULL != when) {
+        dm_subtree_deps_add_xpath(deps, idx, node, when->cond, LYXP_WHEN);
+    }
+    for (uint8_t i = 0; i < must_size; i++) {
+        dm_subtree_deps_add_xpath(deps, idx, node, must[i].expr, LYXP_MUST);
+    }
+
+    /* condition of the augment is evaluated in the context of its target */
+    if (NULL != node->parent && LYS_AUGMENT == node->parent->nodetype && node->parent->child == node &&
+            NULL != ((struct lys_node_augment *) node->parent)->when) {
+        dm_subtree_deps_add_xpath(deps, idx, ((struct lys_node_augment *) node->parent)->target,
+                ((struct lys_node_augment *) node->parent)->when->cond, LYXP_WHEN);
+    }
+}
+
+/**
+ * @brief Records the dependencies of the top-level subtree on the other subtrees. Config false nodes
+ * are skipped, they are not validated.
+ */
+static void
+dm_subtree_deps_add_subtree(dm_subtree_deps_t *deps, size_t idx)
+{
+    const struct lys_node *root = deps->nodes[idx], *node = root;
+    bool backtracking = false;
+
+    while (NULL != node && !deps->refs_any[idx]) {
+        if (backtracking) {
+            if (node == root) {
+                break;
+            }
+            if (node->next) {
+                node = node->next;
+                backtracking = false;
+            } else {
+                node = node->parent;
+                if (NULL != node && LYS_AUGMENT == node->nodetype) {
+                    node = ((struct lys_node_augment *)node)->target;
+                }
+            }
+        } else {
+            if (LYS_CONFIG_R & node->flags) {
+                backtracking = true;
+                continue;
+            }
+            dm_subtree_deps_add_node(deps, idx, node);
+            if (!(node->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA | LYS_GROUPING | LYS_RPC | LYS_ACTION | LYS_NOTIF))
+                    && node->child) {
+                node = node->child;
+            } else {
+                backtracking = true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Computes the dependencies among the top-level subtrees of the module (including augments
+ * from other modules).
+ * @param [in] module
+ * @param [out] deps_p
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_subtree_deps_compute(const struct lys_module *module, dm_subtree_deps_t **deps_p)
+{
+    CHECK_NULL_ARG2(module, deps_p);
+    int rc = SR_ERR_OK;
+    dm_subtree_deps_t *deps = NULL;
+    const struct lys_node *iter = NULL;
+    size_t count = 0;
+
+    while (NULL != (iter = lys_getnext(iter, NULL, module, 0))) {
+        if ((LYS_CONTAINER | LYS_LIST | LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA) & iter->nodetype) {
+            count++;
+        }
+    }
+
+    deps = calloc(1, sizeof(*deps));
+    CHECK_NULL_NOMEM_GOTO(deps, rc, cleanup);
+    deps->nodes = calloc(count + 1, sizeof(*deps->nodes));
+    CHECK_NULL_NOMEM_GOTO(deps->nodes, rc, cleanup);
+    deps->refs_any = calloc(count + 1, sizeof(*deps->refs_any));
+    CHECK_NULL_NOMEM_GOTO(deps->refs_any, rc, cleanup);
+    deps->refs = calloc(count * count + 1, sizeof(*deps->refs));
+    CHECK_NULL_NOMEM_GOTO(deps->refs, rc, cleanup);
+
+    while (NULL != (iter = lys_getnext(iter, NULL, module, 0))) {
+        if ((LYS_CONTAINER | LYS_LIST | LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA) & iter->nodetype) {
+            deps->nodes[deps->count++] = iter;
+        }
+    }
+    for (size_t i = 0; i < deps->count; i++) {
+        dm_subtree_deps_add_subtree(deps, i);
+    }
+
+    *deps_p = deps;
+    deps = NULL;
+
+cleanup:
+    dm_subtree_deps_free(deps);
+    return rc;
+}
+
+int
+dm_get_subtree_deps(dm_schema_info_t *schema_info, const dm_subtree_deps_t **deps)
+{
+    CHECK_NULL_ARG2(schema_info, deps);
+    dm_subtree_deps_t *computed = __atomic_load_n(&schema_info->subtree_deps, __ATOMIC_ACQUIRE);
+    dm_subtree_deps_t *expected = NULL;
+    int rc = SR_ERR_OK;
+
+    if (NULL == computed) {
+        CHECK_NULL_ARG_NORET2(rc, schema_info->module, schema_info->module_name);
+        if (SR_ERR_OK != rc) {
+            return rc;
+        }
+        rc = dm_subtree_deps_compute(schema_info->module, &computed);
+        CHECK_RC_LOG_RETURN(rc, "Failed to compute subtree dependencies of %s", schema_info->module_name);
+        if (!__atomic_compare_exchange_n(&schema_info->subtree_deps, &expected, computed, false,
+                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            /* computed concurrently */
+            dm_subtree_deps_free(computed);
+            computed = expected;
+        }
+    }
+
+    *deps = computed;
+    return rc;
+}
+
+/**
+ * @brief Decides which top-level subtrees have to be validated: the modified ones, the ones whose
+ * constraints reference the modified ones and, transitively, all subtrees referenced by those.
+ * @param [in] deps
+ * @param [in] modified_subtrees names of the modified top-level nodes
+ * @param [out] scope scope[i] - subtree i has to be validated, array of deps->count items
+ * @return False if the whole data tree has to be validated.
+ */
+static bool
+dm_subtree_deps_scope(const dm_subtree_deps_t *deps, const sr_list_t *modified_subtrees, bool *scope)
+{
+    bool *dependent = NULL;
+    bool found = false, changed = true;
+
+    for (size_t m = 0; m < modified_subtrees->count; m++) {
+        found = false;
+        for (size_t i = 0; i < deps->count; i++) {
+            if (0 == strcmp(deps->nodes[i]->name, (char *) modified_subtrees->data[m])) {
+                scope[i] = found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+
+    /* subtrees whose constraints reference the modified ones */
+    dependent = calloc(deps->count + 1, sizeof(*dependent));
+    if (NULL == dependent) {
+        return false;
+    }
+    for (size_t i = 0; i < deps->count; i++) {
+        dependent[i] = deps->refs_any[i];
+        for (size_t j = 0; !dependent[i] && j < deps->count; j++) {
+            dependent[i] = scope[j] && deps->refs[i * deps->count + j];
+        }
+    }
+    for (size_t i = 0; i < deps->count; i++) {
+        scope[i] = scope[i] || dependent[i];
+    }
+    free(dependent);
+
+    /* everything referenced by the validated subtrees has to be present */
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < deps->count; i++) {
+            if (!scope[i]) {
+                continue;
+            }
+            if (deps->refs_any[i]) {
+                return false;
+            }
+            for (size_t j = 0; j < deps->count; j++) {
+                if (deps->refs[i * deps->count + j] && !scope[j]) {
+                    scope[j] = changed = true;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns true if the absence of the node instances would be reported by the validation
+ * (the node is mandatory or contains mandatory nodes that are not under a presence container).
+ */
+static bool
+dm_lys_node_has_mandatory(const struct lys_node *node)
+{
+    const struct lys_node *child = NULL;
+
+    switch (node->nodetype) {
+        case LYS_LEAF:
+        case LYS_ANYDATA:
+        case LYS_ANYXML:
+            return node->flags & LYS_MAND_TRUE;
+        case LYS_LIST:
+            return ((struct lys_node_list *) node)->min > 0;
+        case LYS_LEAFLIST:
+            return ((struct lys_node_leaflist *) node)->min > 0;
+        case LYS_CHOICE:
+            if (node->flags & LYS_MAND_TRUE) {
+                return true;
+            }
+            break;
+        case LYS_CONTAINER:
+            if (NULL != ((struct lys_node_container *) node)->presence) {
+                return false;
+            }
+            break;
+        case LYS_CASE:
+        case LYS_USES:
+            break;
+        default:
+            return false;
+    }
+
+    LY_TREE_FOR(node->child, child) {
+        if (dm_lys_node_has_mandatory(child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Decides whether the top-level data node has to be present in the data tree
+ * passed to the validation of the modified subtrees.
+ */
+static bool
+dm_top_level_node_needs_validation(const dm_subtree_deps_t *deps, const bool *scope, const struct lyd_node *node)
+{
+    const struct lys_node *parent = NULL;
+    int idx = dm_subtree_deps_index(deps, node->schema);
+
+    if (idx < 0 || scope[idx]) {
+        return true;
+    }
+    /* nodes checked by the validation even if they are missing */
+    for (parent = node->schema->parent; NULL != parent; parent = parent->parent) {
+        if ((LYS_CHOICE | LYS_CASE) & parent->nodetype) {
+            return true;
+        }
+    }
+    return dm_lys_node_has_mandatory(node->schema);
+}
+
+/**
+ * @brief Validates only the modified top-level subtrees of the data tree and the subtrees related to them
+ * by constraints (see ::dm_subtree_deps_scope), the rest is unlinked for the time of the validation.
+ * @param [in] info
+ * @param [in] deps
+ * @param [out] errors
+ * @param [out] err_cnt
+ * @param [out] valid
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_validate_modified_subtrees(dm_data_info_t *info, const dm_subtree_deps_t *deps, sr_error_info_t **errors,
+        size_t *err_cnt, bool *valid)
+{
+    CHECK_NULL_ARG5(info, info->modified_subtrees, deps, errors, err_cnt);
+    CHECK_NULL_ARG(valid);
+    struct lyd_node *iter = NULL, *next = NULL, *unchanged = NULL;
+    bool *scope = NULL;
+    int rc = SR_ERR_OK;
 
-                    rc = sr_list_insert_unique_ord(*required_modules, module_name, dm_string_cmp, &inserted);
-                    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to insert item into the list");
+    scope = calloc(deps->count + 1, sizeof(*scope));
+    CHECK_NULL_NOMEM_RETURN(scope);
+    if (!dm_subtree_deps_scope(deps, info->modified_subtrees, scope)) {
+        /* the modified subtrees may affect any data */
+        memset(scope, true, deps->count * sizeof(*scope));
+    }
+
+    /* set aside the subtrees that do not have to be validated */
+    for (iter = info->node; NULL != iter; iter = next) {
+        next = iter->next;
+        if (!dm_top_level_node_needs_validation(deps, scope, iter)) {
+            rc = sr_lyd_unlink(info, iter);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to unlink unchanged subtree");
+            if (NULL == unchanged) {
+                unchanged = iter;
+            } else if (0 != lyd_insert_after(unchanged->prev, iter)) {
+                SR_LOG_ERR("Failed to unlink subtree %s: %s", iter->schema->name, ly_errmsg());
+                lyd_free(iter);
+                rc = SR_ERR_INTERNAL;
+                goto cleanup;
+            }
+        }
+    }
 
-                    rc = sr_list_add(*required_data, module_name);
-                    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to insert item into the list");
+    *valid = (0 == lyd_validate(&info->node, LYD_OPT_STRICT | LYD_OPT_NOAUTODEL | LYD_OPT_CONFIG, info->schema->ly_ctx));
+    if (!*valid) {
+        if (SR_ERR_OK != sr_add_error(errors, err_cnt, ly_errpath(), "%s", ly_errmsg())) {
+            SR_LOG_WRN_MSG("Failed to record validation error");
+        }
+    }
 
-                    /* add installation time dependencies */
-                    ll_dep = module->deps->first;
-                    while (ll_dep) {
-                       dep = (md_dep_t *) ll_dep->data;
-                       ll_dep = ll_dep->next;
+    /* remove the default nodes added by the validation in place of the unlinked subtrees */
+    for (iter = info->node; NULL != iter; iter = next) {
+        next = iter->next;
+        for (struct lyd_node *aside = unchanged; NULL != aside; aside = aside->next) {
+            if (aside->schema == iter->schema) {
+                sr_lyd_unlink(info, iter);
+                lyd_free(iter);
+                break;
+            }
+        }
+    }
 
-                       module_name = strdup(dep->dest->name);
-                       CHECK_NULL_NOMEM_GOTO(module_name, rc, cleanup);
+cleanup:
+    /* link the unchanged subtrees back */
+    for (iter = unchanged; NULL != iter; iter = next) {
+        next = iter->next;
+        if (NULL == info->node) {
+            lyd_unlink(iter);
+            info->node = iter;
+        } else if (0 != sr_lyd_insert_after(info, info->node->prev, iter)) {
+            SR_LOG_ERR("Failed to link subtree %s back: %s", iter->schema->name, ly_errmsg());
+            lyd_free(iter);
+            rc = SR_ERR_INTERNAL;
+        }
+    }
+    free(scope);
+    return rc;
+}
 
-                       rc = sr_list_insert_unique_ord(*required_modules, module_name, dm_string_cmp, &inserted);
-                       CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to insert item into the list");
+/**
+ * @brief Validation of the data tree of a module that does not depend on data of other modules.
+ * Jobs of different modules are executed in parallel (see ::dm_work_pool_execute).
+ */
+typedef struct dm_validation_job_s {
+    dm_data_info_t *info;         /**< data info to be validated */
+    const dm_subtree_deps_t *deps;  /**< dependencies among the subtrees if only the modified subtrees and the ones
+                                     * related to them should be validated, NULL if the whole tree is validated */
+    bool valid;                   /**< result of the validation */
+    int rc;                       /**< error code of the validation */
+    sr_error_info_t *errors;      /**< validation errors of the module */
+    size_t err_cnt;               /**< number of validation errors */
+} dm_validation_job_t;
 
-                       if (inserted && dep->dest->has_data) {
-                           rc = sr_list_add(*required_data, module_name);
-                           CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to add item into the list");
-                       }
+/**
+ * @brief Validates the data tree of the module, errors are recorded in the job since
+ * libyang error information is thread-specific.
+ * @param [in] job (dm_validation_job_t *)
+ */
+static void
+dm_validation_job_execute(void *job)
+{
+    dm_validation_job_t *v_job = (dm_validation_job_t *) job;
+    dm_data_info_t *info = v_job->info;
 
-                       /* if dep has instanced id and it was inserted call recursively */
-                       if (inserted && NULL != dep->dest->inst_ids->first) {
-                           rc = dm_get_data_info(dm_ctx, session, dep->dest->name, &recursive_info);
-                           CHECK_RC_LOG_GOTO(rc, cleanup, "Get data info failed for %s", dep->dest->name);
+    if (NULL != v_job->deps) {
+        v_job->rc = dm_validate_modified_subtrees(info, v_job->deps, &v_job->errors, &v_job->err_cnt, &v_job->valid);
+        return;
+    }
 
-                           rc = dm_requires_tmp_context(dm_ctx, session, recursive_info, required_data, required_modules);
-                           CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to resolve recusrive deps in %s", recursive_info->schema->module_name);
+    v_job->valid = (0 == lyd_validate(&info->node, LYD_OPT_STRICT | LYD_OPT_NOAUTODEL | LYD_OPT_CONFIG, info->schema->ly_ctx));
+    if (!v_job->valid) {
+        if (SR_ERR_OK != sr_add_error(&v_job->errors, &v_job->err_cnt, ly_errpath(), "%s", ly_errmsg())) {
+            SR_LOG_WRN_MSG("Failed to record validation error");
+        }
+    }
+}
 
-                       } else if (!inserted){
-                           free(module_name);
-                       }
-                    }
-                }
-                inserted = false;
-                rc = sr_list_insert_unique_ord(*required_modules, namespace, dm_string_cmp, &inserted);
-                CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
-                inserted_namespace = namespace;
-                namespace = NULL; /* do not free namespace in this function case of cleanup */
+/**
+ * @brief Validates the modified data trees of the modules that do not depend on data of other modules.
+ * The modules are validated in parallel, the results are kept in the jobs so that the errors can be reported
+ * in the order of the modules, together with the errors of the modules validated afterwards.
+ * @param [in] dm_ctx
+ * @param [in] session_modules List of data infos of the session.
+ * @param [out] jobs_p Executed validation jobs in the order of session_modules, to be freed by ::dm_validation_jobs_free.
+ * @param [out] job_cnt_p Number of the jobs.
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_validate_independent_data_trees(dm_ctx_t *dm_ctx, sr_llist_t *session_modules, dm_validation_job_t **jobs_p,
+        size_t *job_cnt_p)
+{
+    CHECK_NULL_ARG4(dm_ctx, session_modules, jobs_p, job_cnt_p);
+    int rc = SR_ERR_OK;
+    dm_data_info_t *info = NULL;
+    sr_llist_node_t *node = NULL;
+    dm_validation_job_t *jobs = NULL;
+    size_t job_cnt = 0, cnt = 0;
 
-                if (inserted) {
-                    rc = sr_list_add(*required_data, inserted_namespace);
-                    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to insert an item into the list");
+    for (node = session_modules->first; NULL != node; node = node->next) {
+        cnt++;
+    }
+    if (0 == cnt) {
+        goto cleanup;
+    }
+    jobs = calloc(cnt, sizeof(*jobs));
+    CHECK_NULL_NOMEM_RETURN(jobs);
 
-                    /* call recursively */
-                    rc = dm_get_data_info(dm_ctx, session, inserted_namespace, &recursive_info);
-                    CHECK_RC_LOG_GOTO(rc, cleanup, "Get data info failed for %s", inserted_namespace);
+    for (node = session_modules->first; NULL != node; node = node->next) {
+        info = (dm_data_info_t *)node->data;
+        if (!info->modified || info->schema->has_instance_id || info->schema->cross_module_data_dependency) {
+            continue;
+        }
+        if (!info->modified_untracked && NULL == info->modified_subtrees) {
+            /* validity of the module data depends only on the data tree that has not changed since the last validation */
+            SR_LOG_DBG("Data of '%s' module have not changed since the last validation", info->schema->module_name);
+            continue;
+        }
+        if (NULL == info->schema->module || NULL == info->schema->module->name) {
+            SR_LOG_ERR_MSG("Missing schema information");
+            rc = SR_ERR_INTERNAL;
+            goto cleanup;
+        }
+        sr_free_list_of_strings(info->required_modules);
+        info->required_modules = NULL;
 
-                    rc = dm_requires_tmp_context(dm_ctx, session, recursive_info, required_data, required_modules);
-                    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to resolve recusrive deps in %s", recursive_info->schema->module_name);
-                }
+        jobs[job_cnt].info = info;
+        if (!dm_ctx->full_validation && !info->modified_untracked && NULL != info->modified_subtrees) {
+            if (SR_ERR_OK != dm_get_subtree_deps(info->schema, &jobs[job_cnt].deps)) {
+                jobs[job_cnt].deps = NULL;
             }
         }
-        ly_set_free(set);
-        set = NULL;
+        job_cnt++;
     }
 
+    /* modules in the shared context would modify the same dictionary concurrently */
+    dm_work_pool_execute(NULL == dm_ctx->shared_ly_ctx ? &dm_ctx->work_pool : NULL, dm_validation_job_execute,
+            jobs, sizeof(*jobs), job_cnt);
+
 cleanup:
     if (SR_ERR_OK != rc) {
-        sr_free_list_of_strings(*required_modules);
-        *required_modules = NULL;
+        free(jobs);
+    } else {
+        *jobs_p = jobs;
+        *job_cnt_p = job_cnt;
     }
-    free(namespace);
-    ly_set_free(set);
-    md_ctx_unlock(dm_ctx->md_ctx);
     return rc;
 }
 
+/**
+ * @brief Frees the validation jobs and the errors recorded in them.
+ * @param [in] jobs
+ * @param [in] job_cnt
+ */
+static void
+dm_validation_jobs_free(dm_validation_job_t *jobs, size_t job_cnt)
+{
+    for (size_t i = 0; NULL != jobs && i < job_cnt; i++) {
+        sr_free_errors(jobs[i].errors, jobs[i].err_cnt);
+    }
+    free(jobs);
+}
+
 int
 dm_validate_session_data_trees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_error_info_t **errors, size_t *err_cnt)
 {
@@ -2933,6 +5530,8 @@ dm_validate_session_data_trees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_error
     dm_data_info_t *dep_di = NULL;
     sr_list_t *data_for_validation = NULL;
     struct lyd_node *data_tree = NULL;
+    dm_validation_job_t *jobs = NULL, *job = NULL;
+    size_t job_cnt = 0, job_idx = 0;
 
     rc = sr_llist_init(&session_modules);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot initialize temporary linked-list for session modules.");
@@ -2946,11 +5545,36 @@ dm_validate_session_data_trees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_error
         cnt++;
     }
 
+    /* modules without data dependencies first, in parallel, modules depending on them may read their data */
+    rc = dm_validate_independent_data_trees(dm_ctx, session_modules, &jobs, &job_cnt);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Validation of data trees failed");
+
+    /* errors are reported in the order of the modules, regardless of how they were validated */
     node = session_modules->first;
     while (NULL != node) {
         info = (dm_data_info_t *)node->data;
-        /* loaded data trees are valid, so check only the modified ones */
-        if (info->modified) {
+        if (job_idx < job_cnt && info == jobs[job_idx].info) {
+            /* the module has already been validated in parallel */
+            job = &jobs[job_idx++];
+            rc = job->rc;
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Validation of modified subtrees failed for %s", info->schema->module_name);
+            for (size_t e = 0; e < job->err_cnt; e++) {
+                if (SR_ERR_OK != sr_add_error(errors, err_cnt, job->errors[e].xpath, "%s", job->errors[e].message)) {
+                    SR_LOG_WRN_MSG("Failed to record validation error");
+                }
+            }
+            if (!job->valid) {
+                SR_LOG_DBG("Validation failed for %s module", info->schema->module->name);
+                validation_failed = true;
+            } else {
+                SR_LOG_DBG("Validation succeeded for '%s' module", info->schema->module->name);
+            }
+            if (!validation_failed) {
+                /* the data tree is valid, following validations can consider only the changes made after this point */
+                dm_data_info_reset_modified_subtrees(info);
+            }
+        } else if (info->modified && (info->schema->has_instance_id || info->schema->cross_module_data_dependency)) {
+            /* modified modules that depend on data of other modules are validated one after another */
             sr_free_list_of_strings(info->required_modules);
             info->required_modules = NULL;
 
@@ -2960,92 +5584,64 @@ dm_validate_session_data_trees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_error
                 goto cleanup;
             }
             /* attach data dependant modules */
-            if (info->schema->has_instance_id || info->schema->cross_module_data_dependency) {
+            rc = dm_requires_tmp_context(dm_ctx, session, info, &required_data, &info->required_modules);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Require tmp ctx check failed for module %s", info->schema->module_name);
 
-                rc = dm_requires_tmp_context(dm_ctx, session, info, &required_data, &info->required_modules);
-                CHECK_RC_LOG_GOTO(rc, cleanup, "Require tmp ctx check failed for module %s", info->schema->module_name);
+            if (NULL == info->required_modules) {
+                /* only dependencies know since installation time are needed */
+                rc = dm_load_dependant_data(dm_ctx, session, info);
+                CHECK_RC_LOG_GOTO(rc, cleanup, "Loading dependant modules failed for %s", info->schema->module_name);
 
-                if (NULL == info->required_modules) {
-                    /* only dependencies know since installation time are needed */
-                    rc = dm_load_dependant_data(dm_ctx, session, info);
-                    CHECK_RC_LOG_GOTO(rc, cleanup, "Loading dependant modules failed for %s", info->schema->module_name);
-
-                    if (0 != lyd_validate(&info->node, LYD_OPT_STRICT | LYD_OPT_NOAUTODEL | LYD_OPT_CONFIG, info->schema->ly_ctx)) {
-                        SR_LOG_DBG("Validation failed for %s module", info->schema->module->name);
-                        if (SR_ERR_OK != sr_add_error(errors, err_cnt, ly_errpath(), "%s", ly_errmsg())) {
-                            SR_LOG_WRN_MSG("Failed to record validation error");
-                        }
-                        validation_failed = true;
-                    } else {
-                        SR_LOG_DBG("Validation succeeded for '%s' module", info->schema->module->name);
-                    }
-                    if (info->schema->cross_module_data_dependency) {
-                        /* remove data appended from other modules for the purpose of validation */
-                        rc = dm_remove_added_data_trees(session, info);
-                        CHECK_RC_MSG_GOTO(rc, cleanup, "Removing of added data trees failed");
+                if (0 != lyd_validate(&info->node, LYD_OPT_STRICT | LYD_OPT_NOAUTODEL | LYD_OPT_CONFIG, info->schema->ly_ctx)) {
+                    SR_LOG_DBG("Validation failed for %s module", info->schema->module->name);
+                    if (SR_ERR_OK != sr_add_error(errors, err_cnt, ly_errpath(), "%s", ly_errmsg())) {
+                        SR_LOG_WRN_MSG("Failed to record validation error");
                     }
+                    validation_failed = true;
                 } else {
-                    /* validate using tmp ly_ctx */
-
-                    /* since the list hold only pointers, reseting the counter is enough,
-                     *  we don't have to free and calloc the list */
-                    data_for_validation->count = 0;
+                    SR_LOG_DBG("Validation succeeded for '%s' module", info->schema->module->name);
+                }
+                if (info->schema->cross_module_data_dependency) {
+                    /* remove data appended from other modules for the purpose of validation */
+                    rc = dm_remove_added_data_trees(session, info);
+                    CHECK_RC_MSG_GOTO(rc, cleanup, "Removing of added data trees failed");
+                }
+            } else {
+                /* validate using tmp ly_ctx */
 
-                    /* retrieve all required data */
-                    for (size_t i = 0; i < required_data->count; i++) {
-                        SR_LOG_DBG("To pass the validation of '%s' data from module %s is needed", info->schema->module_name, (char *) required_data->data[i]);
-                        rc = dm_get_data_info(dm_ctx, session, (char *) required_data->data[i], &dep_di);
-                        CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to get data infor for module %s", (char *) required_data->data[i]);
+                /* since the list hold only pointers, reseting the counter is enough,
+                 *  we don't have to free and calloc the list */
+                data_for_validation->count = 0;
 
-                        rc = sr_list_add(data_for_validation, dep_di);
-                        CHECK_RC_MSG_GOTO(rc, cleanup, "List insert failed");
-                    }
+                /* retrieve all required data */
+                for (size_t i = 0; i < required_data->count; i++) {
+                    SR_LOG_DBG("To pass the validation of '%s' data from module %s is needed", info->schema->module_name, (char *) required_data->data[i]);
+                    rc = dm_get_data_info(dm_ctx, session, (char *) required_data->data[i], &dep_di);
+                    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to get data infor for module %s", (char *) required_data->data[i]);
 
-                    /* prepare working context*/
-                    rc = dm_get_tmp_ly_ctx(dm_ctx, info->required_modules, &tmp_ctx);
-                    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to acquire tmp ctx");
-
-                    /* migrate data to working context */
-                    for (size_t i = 0; i < data_for_validation->count; i++) {
-                        dm_data_info_t *d = (dm_data_info_t *) data_for_validation->data[i];
-                        if (NULL != d->node) {
-                            if (NULL == data_tree) {
-                                data_tree = sr_dup_datatree_to_ctx(d->node, tmp_ctx->ctx);
-                            } else {
-                                int ret = lyd_merge_to_ctx(&data_tree, d->node, LYD_OPT_EXPLICIT, tmp_ctx->ctx);
-                                CHECK_ZERO_LOG_GOTO(ret, rc, SR_ERR_INTERNAL, cleanup, "Failed to merge data tree '%s'", d->schema->module_name);
-                            }
-                        }
-                    }
+                    rc = sr_list_add(data_for_validation, dep_di);
+                    CHECK_RC_MSG_GOTO(rc, cleanup, "List insert failed");
+                }
 
-                    /* start validation */
-                    if (0 != lyd_validate(&data_tree, LYD_OPT_STRICT | LYD_OPT_NOAUTODEL | LYD_OPT_CONFIG, tmp_ctx->ctx)) {
-                        SR_LOG_DBG("Validation failed for %s module", info->schema->module->name);
-                        if (SR_ERR_OK != sr_add_error(errors, err_cnt, ly_errpath(), "%s", ly_errmsg())) {
-                            SR_LOG_WRN_MSG("Failed to record validation error");
+                /* prepare working context*/
+                rc = dm_get_tmp_ly_ctx(dm_ctx, info->required_modules, &tmp_ctx);
+                CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to acquire tmp ctx");
+
+                /* migrate data to working context */
+                for (size_t i = 0; i < data_for_validation->count; i++) {
+                    dm_data_info_t *d = (dm_data_info_t *) data_for_validation->data[i];
+                    if (NULL != d->node) {
+                        if (NULL == data_tree) {
+                            data_tree = sr_dup_datatree_to_ctx(d->node, tmp_ctx->ctx);
+                        } else {
+                            int ret = lyd_merge_to_ctx(&data_tree, d->node, LYD_OPT_EXPLICIT, tmp_ctx->ctx);
+                            CHECK_ZERO_LOG_GOTO(ret, rc, SR_ERR_INTERNAL, cleanup, "Failed to merge data tree '%s'", d->schema->module_name);
                         }
-                        validation_failed = true;
-                    } else {
-                        SR_LOG_DBG("Validation succeeded for '%s' module", info->schema->module->name);
                     }
-
-                    /* remove data from different modules and replace data in data_info to have default nodes in place */
-                    rc = dm_remove_added_data_trees_by_module_name(info->schema->module_name, &data_tree);
-                    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to remove added data trees");
-
-                    lyd_free_withsiblings(info->node);
-
-                    info->node = sr_dup_datatree_to_ctx(data_tree, info->schema->ly_ctx);
-
-                    /* free data tree */
-                    lyd_free_withsiblings(data_tree);
-
-                    /* release working context */
-                    dm_release_tmp_ly_ctx(dm_ctx, tmp_ctx);
-
                 }
-            } else {
-                if (0 != lyd_validate(&info->node, LYD_OPT_STRICT | LYD_OPT_NOAUTODEL | LYD_OPT_CONFIG, info->schema->ly_ctx)) {
+
+                /* start validation */
+                if (0 != lyd_validate(&data_tree, LYD_OPT_STRICT | LYD_OPT_NOAUTODEL | LYD_OPT_CONFIG, tmp_ctx->ctx)) {
                     SR_LOG_DBG("Validation failed for %s module", info->schema->module->name);
                     if (SR_ERR_OK != sr_add_error(errors, err_cnt, ly_errpath(), "%s", ly_errmsg())) {
                         SR_LOG_WRN_MSG("Failed to record validation error");
@@ -3054,8 +5650,27 @@ dm_validate_session_data_trees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_error
                 } else {
                     SR_LOG_DBG("Validation succeeded for '%s' module", info->schema->module->name);
                 }
-            }
 
+                /* remove data from different modules and replace data in data_info to have default nodes in place */
+                rc = dm_remove_added_data_trees_by_module_name(info->schema->module_name, &data_tree);
+                CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to remove added data trees");
+
+                lyd_free_withsiblings(info->node);
+
+                info->node = sr_dup_datatree_to_ctx(data_tree, info->schema->ly_ctx);
+
+                /* free data tree */
+                lyd_free_withsiblings(data_tree);
+                data_tree = NULL;
+
+                /* release working context */
+                dm_release_tmp_ly_ctx(dm_ctx, tmp_ctx);
+                tmp_ctx = NULL;
+            }
+            if (!validation_failed) {
+                /* the data tree is valid, following validations can consider only the changes made after this point */
+                dm_data_info_reset_modified_subtrees(info);
+            }
         }
         node = node->next;
         sr_list_cleanup(required_data);
@@ -3066,9 +5681,15 @@ cleanup:
     if (validation_failed) {
         rc = SR_ERR_VALIDATION_FAILED;
     }
+    lyd_free_withsiblings(data_tree);
+    if (NULL != tmp_ctx) {
+        /* the context holds the read lock of the shared context */
+        dm_release_tmp_ly_ctx(dm_ctx, tmp_ctx);
+    }
     sr_list_cleanup(required_data);
     sr_list_cleanup(data_for_validation);
     sr_llist_cleanup(session_modules);
+    dm_validation_jobs_free(jobs, job_cnt);
     return rc;
 }
 
@@ -3100,6 +5721,7 @@ dm_remove_modified_flag(dm_session_t* session)
     while (NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], cnt))) {
         /* remove modified flag */
         info->modified = false;
+        dm_data_info_reset_modified_subtrees(info);
         cnt++;
     }
     return rc;
@@ -3116,17 +5738,31 @@ dm_remove_session_operations(dm_session_t *session)
 }
 
 static int
-dm_is_info_copy_uptodate(dm_ctx_t *dm_ctx, const char *file_name, const dm_data_info_t *info, bool *res)
+dm_is_info_copy_uptodate(dm_ctx_t *dm_ctx, const char *file_name, sr_datastore_t ds, const dm_data_info_t *info, bool *res)
 {
     CHECK_NULL_ARG4(dm_ctx, file_name, info, res);
     int rc = SR_ERR_OK;
 #ifdef HAVE_STAT_ST_MTIM
     struct stat st = {0};
+    uint64_t seq = 0;
     rc = stat(file_name, &st);
     if (-1 == rc) {
         SR_LOG_ERR_MSG("Stat failed");
         return SR_ERR_INTERNAL;
     }
+    if (dm_is_journaled(dm_ctx, ds)) {
+        /* each journaled commit changes the sequence number, mtime changes when the file is rewritten */
+        rc = dm_get_journal_seq(dm_ctx, ds, info->schema->module->name, &seq);
+        CHECK_RC_MSG_RETURN(rc, "Failed to get journal sequence number");
+        SR_LOG_DBG("Session copy %s: journal seq=%"PRIu64", current journal seq=%"PRIu64, info->schema->module->name,
+                info->journal_seq, seq);
+        *res = info->journal_seq == seq &&
+                info->timestamp.tv_sec == st.st_mtim.tv_sec && info->timestamp.tv_nsec == st.st_mtim.tv_nsec;
+        if (!*res) {
+            SR_LOG_DBG("Module %s will be refreshed", info->schema->module->name);
+        }
+        return rc;
+    }
     struct timespec now;
     clock_gettime(CLOCK_REALTIME, &now);
     SR_LOG_DBG("Session copy %s: mtime sec=%lld nsec=%lld", info->schema->module->name,
@@ -3199,13 +5835,14 @@ dm_update_session_data_trees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_list_t
         }
 
         /* lock for read, blocking - guards access to the file among processes.
-         * Inside the process access to data files is protected by commit_lock in rp.
+         * Inside the process access to data files is protected by commit locks of the modules.
          * Each request that might need to read data file locks it for read at the beginning
          * of request processing. */
         rc = sr_lock_fd(fd, false, true);
 
         bool copy_uptodate = false;
-        rc = dm_is_info_copy_uptodate(dm_ctx, file_name, info, &copy_uptodate);
+        rc = dm_is_info_copy_uptodate(dm_ctx, file_name, SR_DS_CANDIDATE == session->datastore ? SR_DS_RUNNING : session->datastore,
+                info, &copy_uptodate);
         if (SR_ERR_OK != rc) {
             SR_LOG_ERR_MSG("File up to date check failed");
             close(fd);
@@ -3330,24 +5967,221 @@ not_matched:
  * @param [in] index
  * @return  Schema node of the change
  */
-static const struct lyd_node *
-dm_get_notification_match_node(struct lyd_difflist *diff, size_t index)
+static const struct lyd_node *
+dm_get_notification_match_node(struct lyd_difflist *diff, size_t index)
+{
+    if (NULL == diff) {
+        return NULL;
+    }
+    switch (diff->type[index]) {
+    case LYD_DIFF_MOVEDAFTER2:
+    case LYD_DIFF_CREATED:
+        return diff->second[index];
+    case LYD_DIFF_MOVEDAFTER1:
+    case LYD_DIFF_CHANGED:
+    case LYD_DIFF_DELETED:
+        return diff->first[index];
+    default:
+        /* LYD_DIFF_END */
+        return NULL;
+    }
+}
+
+/**
+ * @brief Subscriptions of a module tied to one schema node, item of
+ * the ::dm_model_subscription_t#node_index.
+ */
+typedef struct dm_node_subscriptions_s {
+    const struct lys_node *node;    /**< subscribed schema node, NULL for module-wide subscriptions */
+    size_t *subs;                   /**< indices of the subscriptions (in ::dm_model_subscription_t#subscriptions) tied to the node */
+    size_t subs_cnt;                /**< number of items in subs */
+    bool has_descendants;           /**< flag whether there is a subscription to a node in the subtree of the node */
+} dm_node_subscriptions_t;
+
+/**
+ * @brief Compares two node subscriptions by the schema node pointer.
+ */
+static int
+dm_node_subscriptions_cmp(const void *a, const void *b)
+{
+    assert(a);
+    assert(b);
+    const dm_node_subscriptions_t *ns_a = (const dm_node_subscriptions_t *) a;
+    const dm_node_subscriptions_t *ns_b = (const dm_node_subscriptions_t *) b;
+
+    if (ns_a->node == ns_b->node) {
+        return 0;
+    }
+    return ((uintptr_t) ns_a->node < (uintptr_t) ns_b->node) ? -1 : 1;
+}
+
+/**
+ * @brief Frees the node subscriptions stored in the binary tree.
+ */
+static void
+dm_node_subscriptions_free(void *item)
+{
+    dm_node_subscriptions_t *ns = (dm_node_subscriptions_t *) item;
+    if (NULL != ns) {
+        free(ns->subs);
+    }
+    free(ns);
+}
+
+/**
+ * @brief Looks up the entry for the schema node in the subscription index, optionally
+ * creates it if it does not exist yet.
+ * @param [in] index
+ * @param [in] node
+ * @param [in] create
+ * @param [out] node_subs found/created entry, NULL if not found
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_node_subscriptions_get(sr_btree_t *index, const struct lys_node *node, bool create, dm_node_subscriptions_t **node_subs)
+{
+    CHECK_NULL_ARG2(index, node_subs);
+    int rc = SR_ERR_OK;
+    dm_node_subscriptions_t lookup = {0}, *ns = NULL;
+
+    lookup.node = node;
+    ns = sr_btree_search(index, &lookup);
+    if (NULL == ns && create) {
+        ns = calloc(1, sizeof(*ns));
+        CHECK_NULL_NOMEM_RETURN(ns);
+        ns->node = node;
+        rc = sr_btree_insert(index, ns);
+        if (SR_ERR_OK != rc) {
+            free(ns);
+            SR_LOG_ERR_MSG("Failed to insert node subscriptions into the index");
+            return rc;
+        }
+    }
+    *node_subs = ns;
+    return rc;
+}
+
+/**
+ * @brief Builds the index of the module subscriptions by the subscribed schema node,
+ * so that the subscriptions matching a change can be found by walking the ancestors
+ * of the changed node instead of testing each subscription against each change.
+ * @param [in] ms
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_build_subscription_index(dm_model_subscription_t *ms)
+{
+    CHECK_NULL_ARG2(ms, ms->subscriptions);
+    int rc = SR_ERR_OK;
+    dm_node_subscriptions_t *ns = NULL;
+    size_t *tmp = NULL;
+
+    rc = sr_btree_init(dm_node_subscriptions_cmp, dm_node_subscriptions_free, &ms->node_index);
+    CHECK_RC_MSG_RETURN(rc, "Binary tree allocation failed");
+
+    for (size_t s = 0; s < ms->subscriptions->count; s++) {
+        rc = dm_node_subscriptions_get(ms->node_index, ms->nodes[s], true, &ns);
+        CHECK_RC_MSG_RETURN(rc, "Failed to get node subscriptions");
+
+        tmp = realloc(ns->subs, (ns->subs_cnt + 1) * sizeof(*ns->subs));
+        CHECK_NULL_NOMEM_RETURN(tmp);
+        ns->subs = tmp;
+        ns->subs[ns->subs_cnt++] = s;
+
+        /* mark the ancestors, a created/deleted container or list has to be searched for the subscribed descendants */
+        for (const struct lys_node *n = NULL == ms->nodes[s] ? NULL : lys_parent(ms->nodes[s]); NULL != n; n = lys_parent(n)) {
+            rc = dm_node_subscriptions_get(ms->node_index, n, true, &ns);
+            CHECK_RC_MSG_RETURN(rc, "Failed to get node subscriptions");
+            if (ns->has_descendants) {
+                /* the rest of ancestors has been already marked */
+                break;
+            }
+            ns->has_descendants = true;
+        }
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Marks the subscriptions tied to the schema node as matched.
+ * @param [in] ms
+ * @param [in] node
+ * @param [in,out] remaining number of subscriptions that have not been matched yet
+ * @return Index entry of the node, NULL if there is none
+ */
+static dm_node_subscriptions_t *
+dm_mark_node_subscriptions(dm_model_subscription_t *ms, const struct lys_node *node, size_t *remaining)
+{
+    dm_node_subscriptions_t *ns = NULL;
+
+    if (SR_ERR_OK != dm_node_subscriptions_get(ms->node_index, node, false, &ns) || NULL == ns) {
+        return NULL;
+    }
+    for (size_t i = 0; i < ns->subs_cnt; i++) {
+        if (!ms->matched[ns->subs[i]]) {
+            ms->matched[ns->subs[i]] = true;
+            (*remaining)--;
+        }
+    }
+    return ns;
+}
+
+/**
+ * @brief Finds out which subscriptions of the module match a change in the difflist
+ * (the same rules as ::dm_match_subscription apply). The result is stored in ms->matched
+ * and it is reused until the difflist is replaced.
+ *
+ * Each change costs a walk through the ancestors of the changed node; the data subtree
+ * of the changed node is searched only if it is a container/list with a subscription
+ * somewhere below it.
+ *
+ * @param [in] ms
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_match_module_subscriptions(dm_model_subscription_t *ms)
 {
-    if (NULL == diff) {
-        return NULL;
+    CHECK_NULL_ARG2(ms, ms->difflist);
+    dm_node_subscriptions_t *ns = NULL;
+    const struct lyd_node *cmp_node = NULL;
+    size_t remaining = 0;
+
+    if (NULL != ms->matched || NULL == ms->subscriptions || 0 == ms->subscriptions->count) {
+        return SR_ERR_OK;
     }
-    switch (diff->type[index]) {
-    case LYD_DIFF_MOVEDAFTER2:
-    case LYD_DIFF_CREATED:
-        return diff->second[index];
-    case LYD_DIFF_MOVEDAFTER1:
-    case LYD_DIFF_CHANGED:
-    case LYD_DIFF_DELETED:
-        return diff->first[index];
-    default:
-        /* LYD_DIFF_END */
-        return NULL;
+    CHECK_NULL_ARG(ms->node_index);
+
+    ms->matched = calloc(ms->subscriptions->count, sizeof(*ms->matched));
+    CHECK_NULL_NOMEM_RETURN(ms->matched);
+    remaining = ms->subscriptions->count;
+
+    for (size_t d = 0; remaining > 0 && LYD_DIFF_END != ms->difflist->type[d]; d++) {
+        cmp_node = dm_get_notification_match_node(ms->difflist, d);
+        if (NULL == cmp_node) {
+            continue;
+        }
+        /* module-wide subscriptions */
+        dm_mark_node_subscriptions(ms, NULL, &remaining);
+
+        /* subscriptions to the changed node or its ancestors */
+        ns = dm_mark_node_subscriptions(ms, cmp_node->schema, &remaining);
+        for (const struct lys_node *n = lys_parent(cmp_node->schema); NULL != n; n = lys_parent(n)) {
+            dm_mark_node_subscriptions(ms, n, &remaining);
+        }
+
+        /* a container/list has been created/deleted, look for the subscribed descendants in its subtree */
+        if (remaining > 0 && NULL != ns && ns->has_descendants && ((LYS_CONTAINER | LYS_LIST) & cmp_node->schema->nodetype)) {
+            struct lyd_node *next = NULL, *iter = NULL;
+            LY_TREE_DFS_BEGIN((struct lyd_node *) cmp_node, next, iter) {
+                if (iter != cmp_node) {
+                    dm_mark_node_subscriptions(ms, iter->schema, &remaining);
+                }
+                LYD_TREE_DFS_END(cmp_node, next, iter);
+            }
+        }
     }
+    return SR_ERR_OK;
 }
 
 /**
@@ -3463,9 +6297,13 @@ dm_prepare_module_subscriptions(dm_ctx_t *dm_ctx, dm_session_t *session, dm_sche
                         &ms->nodes[s]);
                 if (SR_ERR_OK != rc || NULL == ms->nodes[s]) {
                     SR_LOG_WRN("Node for xpath %s has not been found", sub->xpath);
+                    rc = SR_ERR_OK;
                 }
             }
         }
+
+        rc = dm_build_subscription_index(ms);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to index subscriptions for module %s", schema_info->module_name);
     }
 
     ms->schema_info = schema_info;
@@ -3870,7 +6708,7 @@ dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm
         dm_data_info_t *di = NULL;
 
         bool copy_uptodate = false;
-        rc = dm_is_info_copy_uptodate(dm_ctx, file_name, info, &copy_uptodate);
+        rc = dm_is_info_copy_uptodate(dm_ctx, file_name, c_ctx->session->datastore, info, &copy_uptodate);
         CHECK_RC_MSG_GOTO(rc, cleanup, "File up to date check failed");
 
         /* ops are skipped also when candidate is committed to the running */
@@ -3904,7 +6742,8 @@ dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm
 
         } else {
             /* if the file existed pass FILE 'r+', otherwise pass -1 because there is 'w' fd already */
-            rc = dm_load_data_tree_file(dm_ctx, c_ctx->existed[count] ? c_ctx->fds[count] : -1, file_name, info->schema, &di);
+            rc = dm_load_data_tree_file_cached(dm_ctx, c_ctx->existed[count] ? c_ctx->fds[count] : -1, file_name, info->schema,
+                    c_ctx->session->datastore, false, &di);
             CHECK_RC_MSG_GOTO(rc, cleanup, "Loading data file failed");
         }
 
@@ -3919,15 +6758,18 @@ dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm
         CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to get NACM context.");
 
         if (SR_DS_STARTUP != session->datastore || !c_ctx->disabled_config_change ||
-                (NULL != nacm_ctx && (c_ctx->init_session->options & SR_SESS_ENABLE_NACM))) {
+                (NULL != nacm_ctx && (c_ctx->init_session->options & SR_SESS_ENABLE_NACM)) ||
+                dm_is_journaled(dm_ctx, c_ctx->session->datastore)) {
             /**
              * For candidate and running we save prev state.
              * If config change notifications are generated we have to save prev state for startup as well.
              * if NACM is enabled, we need to get the previous state in any case.
+             * If commits are journaled, the changes are computed against the prev state.
              */
             if (SR_DS_CANDIDATE == session->datastore || copy_uptodate) {
-                /* load data tree from file system */
-                rc = dm_load_data_tree_file(dm_ctx, c_ctx->existed[count] ? c_ctx->fds[count] : -1, file_name, info->schema, &di);
+                /* load data tree from file system, previous state is only read so it can be shared */
+                rc = dm_load_data_tree_file_cached(dm_ctx, c_ctx->existed[count] ? c_ctx->fds[count] : -1, file_name, info->schema,
+                        c_ctx->session->datastore, true, &di);
                 CHECK_RC_MSG_GOTO(rc, cleanup, "Loading data file failed");
 
                 rc = sr_btree_insert(c_ctx->prev_data_trees, (void *) di);
@@ -3959,6 +6801,139 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Appends the changes of the module made by the commit to the journal of the module and swaps in
+ * the snapshot of the committed data. If the changes can not be expressed by operations (e.g. moves
+ * in user-ordered lists or data referencing other modules), the image of the committed data is appended instead.
+ *
+ * @param [in] dm_ctx
+ * @param [in] c_ctx
+ * @param [in] merged_info data tree to be committed
+ * @param [in] fd file descriptor of the data file of the module (locked for writing)
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_commit_journal_module(dm_ctx_t *dm_ctx, dm_commit_context_t *c_ctx, dm_data_info_t *merged_info, int fd)
+{
+    CHECK_NULL_ARG4(dm_ctx, c_ctx, c_ctx->session, merged_info);
+    dm_journal_t *journal = NULL;
+    dm_journal_batch_t *batch = NULL;
+    dm_data_info_t *prev_info = NULL, lookup_info = {0};
+    struct lyd_difflist *diff = NULL;
+    dm_tmp_ly_ctx_t *tmp_ctx = NULL;
+    struct lyd_node *tmp_data_tree = NULL;
+    uint64_t seq = 0;
+    int rc = SR_ERR_OK;
+
+    rc = dm_get_journal(dm_ctx, c_ctx->session->datastore, merged_info->schema->module_name, &journal);
+    if (SR_ERR_OK == rc && NULL == journal) {
+        rc = SR_ERR_INTERNAL;
+    }
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to get the journal");
+    rc = dm_journal_batch_new(&batch);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Journal batch allocation failed");
+
+    rc = SR_ERR_UNSUPPORTED;
+    if (NULL == merged_info->required_modules && !merged_info->schema->has_instance_id) {
+        /* data referencing other modules can not be replayed in the context of the module */
+        lookup_info.schema = merged_info->schema;
+        prev_info = sr_btree_search(c_ctx->prev_data_trees, &lookup_info);
+        if (NULL != prev_info) {
+            diff = lyd_diff(prev_info->node, merged_info->node, 0);
+            if (NULL != diff) {
+                rc = dm_journal_batch_add_diff(batch, merged_info->schema->module, diff);
+                lyd_free_diff(diff);
+            } else {
+                SR_LOG_WRN("Failed to compute changes of module %s: %s", merged_info->schema->module_name, ly_errmsg());
+            }
+        } else {
+            SR_LOG_DBG("Previous data tree of module %s not found", merged_info->schema->module_name);
+        }
+    }
+    if (SR_ERR_UNSUPPORTED == rc) {
+        SR_LOG_DBG("Image of module '%s' will be journaled", merged_info->schema->module_name);
+        if (NULL != merged_info->required_modules) {
+            /* print using tmp context if schemas different from installation time deps are needed */
+            rc = dm_get_tmp_ly_ctx(dm_ctx, merged_info->required_modules, &tmp_ctx);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to acquired tmp ly_ctx");
+            tmp_data_tree = sr_dup_datatree_to_ctx(merged_info->node, tmp_ctx->ctx);
+            rc = dm_journal_batch_add_image(batch, tmp_data_tree);
+        } else {
+            rc = dm_journal_batch_add_image(batch, merged_info->node);
+        }
+    }
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to prepare the journal record of module %s", merged_info->schema->module_name);
+
+    rc = dm_journal_append(journal, batch, &seq);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to append the changes of module %s to the journal", merged_info->schema->module_name);
+    SR_LOG_DBG("Changes of module '%s' appended to the journal, sequence number %"PRIu64,
+            merged_info->schema->module_name, seq);
+
+    if (dm_journal_size(journal) >= DM_JOURNAL_CHECKPOINT_SIZE) {
+        pthread_mutex_lock(&dm_ctx->checkpoint_mutex);
+        dm_ctx->checkpoint_requested = true;
+        pthread_cond_signal(&dm_ctx->checkpoint_cond);
+        pthread_mutex_unlock(&dm_ctx->checkpoint_mutex);
+    }
+
+cleanup:
+    lyd_free_withsiblings(tmp_data_tree);
+    if (NULL != tmp_ctx) {
+        dm_release_tmp_ly_ctx(dm_ctx, tmp_ctx);
+    }
+    dm_journal_batch_free(batch);
+    if (SR_ERR_OK == rc && NULL == merged_info->required_modules) {
+        /* swap in the committed data tree, subsequent reads do not need to replay the journal */
+        dm_data_snapshot_update(dm_ctx, merged_info->schema, c_ctx->session->datastore, fd, merged_info->node);
+    } else {
+        dm_data_snapshot_invalidate(dm_ctx, merged_info->schema);
+    }
+    return rc;
+}
+
+/**
+ * @brief Rewrite of the data file of one module by the commit. Jobs of different modules are executed
+ * in parallel (see ::dm_work_pool_execute).
+ */
+typedef struct dm_write_job_s {
+    dm_data_info_t *info;         /**< data info of the module in the session */
+    dm_data_info_t *merged_info;  /**< data info with the committed data */
+    const struct lyd_node *node;  /**< data tree to be written */
+    int fd;                       /**< file descriptor of the data file */
+    bool binary;                  /**< flag whether the data file is written in the binary format */
+    bool executed;                /**< flag whether the job has already been executed */
+    int ret;                      /**< result of the write, 0 on success */
+    char *error;                  /**< error message if the write failed */
+} dm_write_job_t;
+
+/**
+ * @brief Writes the data tree into the data file and makes it durable. Error message is recorded
+ * in the job since libyang error information is thread-specific.
+ * @param [in] job (dm_write_job_t *)
+ */
+static void
+dm_write_job_execute(void *job)
+{
+    dm_write_job_t *w_job = (dm_write_job_t *) job;
+
+    if (w_job->executed) {
+        return;
+    }
+    w_job->executed = true;
+
+    ly_errno = LY_SUCCESS; /* needed to check if the error was in libyang or not below */
+    w_job->ret = ftruncate(w_job->fd, 0);
+    if (0 == w_job->ret) {
+        w_job->ret = sr_lyd_print_data_fd(w_job->fd, w_job->node, w_job->binary);
+    }
+    if (0 == w_job->ret) {
+        w_job->ret = fsync(w_job->fd);
+    }
+    if (0 != w_job->ret) {
+        w_job->error = strdup((ly_errno != LY_SUCCESS) ? ly_errmsg() : sr_strerror_safe(errno));
+    }
+}
+
 int
 dm_commit_write_files(dm_session_t *session, dm_commit_context_t *c_ctx)
 {
@@ -3970,8 +6945,14 @@ dm_commit_write_files(dm_session_t *session, dm_commit_context_t *c_ctx)
     dm_data_info_t *info = NULL;
     dm_tmp_ly_ctx_t *tmp_ctx = NULL;
     struct lyd_node *tmp_data_tree = NULL;
+    bool journaled = dm_is_journaled(session->dm_ctx, c_ctx->session->datastore);
+    dm_write_job_t *jobs = NULL, *job = NULL;
+    size_t job_cnt = 0;
 
-    /* write data trees */
+    jobs = calloc(c_ctx->modif_count + 1, sizeof(*jobs));
+    CHECK_NULL_NOMEM_GOTO(jobs, rc, cleanup);
+
+    /* record the changes into the journal or prepare the rewrites of the data files */
     i = 0;
     dm_data_info_t *merged_info = NULL;
     while (NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], i++))) {
@@ -3986,49 +6967,84 @@ dm_commit_write_files(dm_session_t *session, dm_commit_context_t *c_ctx)
             /* remove attached data trees */
             ret = dm_remove_added_data_trees(session, info);
 
-            /* print using tmp context if schemas different from installation time deps are needed */
-            if (NULL != merged_info->required_modules) {
+            if (journaled) {
+                /* the changes are appended to the journal, the data file is left untouched */
+                if (SR_ERR_OK == ret) {
+                    ret = dm_commit_journal_module(session->dm_ctx, c_ctx, merged_info, c_ctx->fds[count]);
+                }
+                if (SR_ERR_OK != ret) {
+                    SR_LOG_ERR("Failed to journal changes of '%s' module", info->schema->module->name);
+                    rc = SR_ERR_INTERNAL;
+                    dm_data_snapshot_invalidate(session->dm_ctx, info->schema);
+                }
+                count++;
+                continue;
+            }
+
+            job = &jobs[job_cnt++];
+            job->info = info;
+            job->merged_info = merged_info;
+            job->node = merged_info->node;
+            job->fd = c_ctx->fds[count];
+            job->binary = session->dm_ctx->binary_data_files;
+            if (SR_ERR_OK != ret) {
+                job->executed = true;
+                job->ret = ret;
+            } else if (NULL != merged_info->required_modules) {
+                /* print using tmp context if schemas different from installation time deps are needed,
+                 * these are written right away since the pool of tmp contexts is limited */
                 SR_LOG_DBG("Additional schemas are needed to print data of modules %s", merged_info->schema->module_name);
                 rc = dm_get_tmp_ly_ctx(session->dm_ctx, merged_info->required_modules, &tmp_ctx);
-                if (SR_ERR_OK == rc) {
-                    tmp_data_tree = sr_dup_datatree_to_ctx(merged_info->node, tmp_ctx->ctx);
-                } else {
+                if (SR_ERR_OK != rc) {
                     SR_LOG_ERR_MSG("Failed to acquired tmp ly_ctx");
+                    job_cnt--;
+                    count++;
                     continue;
                 }
-            }
-
-            if (SR_ERR_OK == ret) {
-                ret = ftruncate(c_ctx->fds[count], 0);
-            }
-            if (0 == ret) {
-                ly_errno = LY_SUCCESS; /* needed to check if the error was in libyang or not below */
-                ret = lyd_print_fd(c_ctx->fds[count], NULL == merged_info->required_modules ? merged_info->node : tmp_data_tree,
-                            LYD_XML, LYP_WITHSIBLINGS | LYP_FORMAT);
-            }
-
-            if (NULL != merged_info->required_modules) {
+                tmp_data_tree = sr_dup_datatree_to_ctx(merged_info->node, tmp_ctx->ctx);
+                job->node = tmp_data_tree;
+                dm_write_job_execute(job);
+                job->node = NULL;
                 lyd_free_withsiblings(tmp_data_tree);
                 tmp_data_tree = NULL;
                 dm_release_tmp_ly_ctx(session->dm_ctx, tmp_ctx);
             }
+            count++;
+        }
+    }
 
-            if (0 == ret) {
-                ret = fsync(c_ctx->fds[count]);
-            }
-            if (0 != ret) {
-                SR_LOG_ERR("Failed to write data of '%s' module: %s", info->schema->module->name,
-                        (ly_errno != LY_SUCCESS) ? ly_errmsg() : sr_strerror_safe(errno));
-                rc = SR_ERR_INTERNAL;
+    /* data files of different modules are independent, write them in parallel */
+    dm_work_pool_execute(&session->dm_ctx->work_pool, dm_write_job_execute, jobs, sizeof(*jobs), job_cnt);
+
+    for (size_t j = 0; j < job_cnt; j++) {
+        job = &jobs[j];
+        info = job->info;
+        ret = job->ret;
+        if (0 != ret) {
+            SR_LOG_ERR("Failed to write data of '%s' module: %s", info->schema->module->name,
+                    NULL != job->error ? job->error : sr_strerror(ret));
+            rc = SR_ERR_INTERNAL;
+            dm_data_snapshot_invalidate(session->dm_ctx, info->schema);
+        } else {
+            SR_LOG_DBG("Data successfully written for module '%s'", info->schema->module->name);
+            if (NULL != job->merged_info->required_modules) {
+                dm_data_snapshot_invalidate(session->dm_ctx, info->schema);
             } else {
-                SR_LOG_DBG("Data successfully written for module '%s'", info->schema->module->name);
+                /* swap in the committed data tree, subsequent reads do not need to parse the file */
+                dm_data_snapshot_update(session->dm_ctx, info->schema, c_ctx->session->datastore, job->fd,
+                        job->merged_info->node);
             }
-            count++;
         }
     }
+
     /* save time of the last commit */
     sr_clock_get_time(CLOCK_REALTIME, &session->dm_ctx->last_commit_time);
 
+cleanup:
+    for (size_t j = 0; j < job_cnt; j++) {
+        free(jobs[j].error);
+    }
+    free(jobs);
     return rc;
 }
 
@@ -4255,6 +7271,65 @@ dm_should_skip_subscription(np_subscription_t *subscription, dm_commit_context_t
     return false;
 }
 
+/**
+ * @brief Collects the changes of the module matching the subscription, so that they can be
+ * sent together with the notification. The changes are generated from the difflist if it
+ * has not been done yet.
+ *
+ * @param [in] ms
+ * @param [in] index Index of the subscription in ms->subscriptions
+ * @param [out] changes List of the matching changes (sr_change_t owned by ms), NULL if the changes
+ * can not be sent inline and the subscriber has to ask for them.
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_get_subscription_changes(dm_model_subscription_t *ms, size_t index, sr_list_t **changes)
+{
+    CHECK_NULL_ARG3(ms, ms->subscriptions, changes);
+    np_subscription_t *sub = ms->subscriptions->data[index];
+    const struct lys_node *sub_node = ms->nodes[index];
+    sr_list_t *matched = NULL;
+    int rc = SR_ERR_OK;
+
+    *changes = NULL;
+    if (NULL != sub->xpath && NULL == sub_node) {
+        /* the subscription has not been resolved, leave the selection up to GET_CHANGES */
+        return SR_ERR_OK;
+    }
+
+    RWLOCK_WRLOCK_TIMED_CHECK_RETURN(&ms->changes_lock);
+
+    if (!ms->changes_generated) {
+        rc = rp_dt_difflist_to_changes(ms->difflist, &ms->changes);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Difflist to changes failed");
+        ms->changes_generated = true;
+    }
+
+    rc = sr_list_init(&matched);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "List init failed");
+
+    for (size_t i = 0; i < ms->changes->count; i++) {
+        sr_change_t *change = ms->changes->data[i];
+        const struct lys_node *n = change->sch_node;
+        while (NULL != sub_node && NULL != n && sub_node != n) {
+            n = lys_parent(n);
+        }
+        if (NULL == sub_node || NULL != n) {
+            rc = sr_list_add(matched, change);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
+        }
+    }
+
+cleanup:
+    pthread_rwlock_unlock(&ms->changes_lock);
+    if (SR_ERR_OK == rc) {
+        *changes = matched;
+    } else {
+        sr_list_cleanup(matched);
+    }
+    return rc;
+}
+
 int
 dm_commit_notify(dm_ctx_t *dm_ctx, dm_session_t *session, sr_notif_event_t ev, dm_commit_context_t *c_ctx)
 {
@@ -4263,7 +7338,6 @@ dm_commit_notify(dm_ctx_t *dm_ctx, dm_session_t *session, sr_notif_event_t ev, d
     size_t i = 0;
     dm_data_info_t *info = NULL, *commit_info = NULL, *prev_info = NULL, lookup_info = {0};
     dm_model_subscription_t *ms = NULL;
-    bool match = false;
     sr_list_t *notified_notif = NULL;
     dm_module_difflist_t *module_difflist = NULL, lookup_difflist = {0};
     nacm_ctx_t *nacm_ctx = NULL;
@@ -4359,6 +7433,8 @@ dm_commit_notify(dm_ctx_t *dm_ctx, dm_session_t *session, sr_notif_event_t ev, d
             ms->changes_generated = false;
             /* store differences in commit context */
             ms->difflist = diff;
+            free(ms->matched);
+            ms->matched = NULL;
         }
 
         /* Log changes */
@@ -4376,28 +7452,30 @@ dm_commit_notify(dm_ctx_t *dm_ctx, dm_session_t *session, sr_notif_event_t ev, d
         }
 
         /* loop through subscription test if they should be notified */
-        if (NULL != ms->subscriptions) {
+        if (NULL != ms->subscriptions && ms->subscriptions->count > 0) {
+            rc = dm_match_module_subscriptions(ms);
+            if (SR_ERR_OK != rc) {
+                SR_LOG_WRN("Subscription match failed for module %s", info->schema->module->name);
+                continue;
+            }
             for (size_t s = 0; s < ms->subscriptions->count; s++) {
                 np_subscription_t *sub = ms->subscriptions->data[s];
                 if (dm_should_skip_subscription(sub, c_ctx, ev)) {
                     continue;
                 }
 
-                for (d_cnt = 0; LYD_DIFF_END != ms->difflist->type[d_cnt]; d_cnt++) {
-                    const struct lyd_node *cmp_node = dm_get_notification_match_node(ms->difflist, d_cnt);
-                    rc = dm_match_subscription(ms->nodes[s], cmp_node, &match);
-                    if (SR_ERR_OK != rc) {
-                        SR_LOG_WRN_MSG("Subscription match failed");
-                        continue;
-                    }
-                    if (match) {
-                        break;
+                if (ms->matched[s]) {
+                    sr_list_t *changes = NULL;
+                    if (sub->inline_changes) {
+                        rc = dm_get_subscription_changes(ms, s, &changes);
+                        if (SR_ERR_OK != rc) {
+                            SR_LOG_WRN("Unable to collect the changes for the subscription in module %s xpath %s, "
+                                    "they will not be sent inline.", sub->module_name, sub->xpath);
+                        }
                     }
-                }
-
-                if (match) {
                     /* something has been changed for this subscription, send notification */
-                    rc = np_subscription_notify(dm_ctx->np_ctx, sub, ev, c_ctx->id);
+                    rc = np_subscription_notify(dm_ctx->np_ctx, sub, ev, c_ctx->id, changes);
+                    sr_list_cleanup(changes);
                     if (SR_ERR_OK != rc) {
                        SR_LOG_WRN("Unable to send notifications about the changes for the subscription in module %s xpath %s.",
                                sub->module_name,
@@ -4460,6 +7538,36 @@ dm_feature_enable(dm_ctx_t *dm_ctx, const char *module_name, const char *feature
     sr_llist_node_t *ll_node = NULL;
     dm_schema_info_t *si = NULL;
     dm_schema_info_t lookup = {0};
+    sr_list_t *locked = NULL;
+
+    if (NULL != dm_ctx->shared_ly_ctx) {
+        /* the feature affects the schema nodes of the module and of the modules it augments, the same modules
+         * as in separate contexts must not be used, but the context must not be accessed meanwhile */
+        md_ctx_lock(dm_ctx->md_ctx, false);
+        pthread_rwlock_wrlock(&dm_ctx->schema_tree_lock);
+        rc = dm_lock_schema_infos_write(dm_ctx, &locked);
+        if (SR_ERR_OK == rc) {
+            lookup.module_name = (char *) module_name;
+            schema_info = sr_btree_search(dm_ctx->schema_info_tree, &lookup);
+            if (NULL == schema_info || NULL == schema_info->ly_ctx) {
+                SR_LOG_ERR("Unknown schema: %s", module_name);
+                rc = SR_ERR_UNKNOWN_MODEL;
+            } else {
+                rc = md_get_module_info(dm_ctx->md_ctx, module_name, NULL, &module);
+                if (SR_ERR_OK == rc) {
+                    rc = dm_shared_ly_ctx_prepare_augmented(dm_ctx, module);
+                }
+                if (SR_ERR_OK == rc) {
+                    rc = dm_feature_enable_internal(dm_ctx, schema_info, module_name, feature_name, enable);
+                }
+            }
+            dm_unlock_schema_infos(dm_ctx, locked);
+        }
+        pthread_rwlock_unlock(&dm_ctx->schema_tree_lock);
+        md_ctx_unlock(dm_ctx->md_ctx);
+        CHECK_RC_LOG_RETURN(rc, "Failed to %s feature '%s' in module '%s'.", enable ? "enable" : "disable", feature_name, module_name);
+        return rc;
+    }
 
     rc = dm_get_module_and_lockw(dm_ctx, module_name, &schema_info);
     CHECK_RC_LOG_RETURN(rc, "dm_get_module %s and lock failed", module_name);
@@ -4468,6 +7576,9 @@ dm_feature_enable(dm_ctx_t *dm_ctx, const char *module_name, const char *feature
     pthread_rwlock_unlock(&schema_info->model_lock);
     CHECK_RC_LOG_RETURN(rc, "Failed to %s feature '%s' in module '%s'.", enable ? "enable" : "disable", feature_name, module_name);
 
+    /* features are enabled in the temporary contexts when the modules are loaded */
+    dm_tmp_ly_ctx_pool_invalidate(dm_ctx);
+
     /* apply the change in all loaded schema infos */
     md_ctx_lock(dm_ctx->md_ctx, true);
     pthread_rwlock_wrlock(&dm_ctx->schema_tree_lock);
@@ -4512,7 +7623,7 @@ dm_install_module(dm_ctx_t *dm_ctx, dm_session_t *session, const char *module_na
     sr_llist_node_t *ll_node = NULL;
     dm_schema_info_t *si = NULL, *si_ext = NULL;
     dm_schema_info_t lookup = {0};
-    sr_list_t *implicitly_installed = NULL;
+    sr_list_t *implicitly_installed = NULL, *locked = NULL;
 
     /* insert module into the dependency graph */
     md_ctx_lock(dm_ctx->md_ctx, true);
@@ -4524,6 +7635,16 @@ dm_install_module(dm_ctx_t *dm_ctx, dm_session_t *session, const char *module_na
     rc = md_get_module_info(dm_ctx->md_ctx, module_name, revision, &module);
     CHECK_RC_LOG_GOTO(rc, cleanup, "Get module %s info failed", module_name);
 
+    if (NULL != dm_ctx->shared_ly_ctx) {
+        /* load the module into the shared context, the context must not be accessed meanwhile */
+        rc = dm_lock_schema_infos_write(dm_ctx, &locked);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to lock the schema infos");
+        rc = dm_shared_ly_ctx_load(dm_ctx, session);
+        dm_unlock_schema_infos(dm_ctx, locked);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to load module %s into the shared schema context", module_name);
+        goto cleanup;
+    }
+
     lookup.module_name = (char *) module_name;
     si = sr_btree_search(dm_ctx->schema_info_tree, &lookup);
     if (NULL != si) {
@@ -4540,6 +7661,8 @@ dm_install_module(dm_ctx_t *dm_ctx, dm_session_t *session, const char *module_na
         CHECK_RC_LOG_GOTO(rc, unlock, "Failed to load schema %s", module->filepath);
 
         si->module = ly_ctx_get_module(si->ly_ctx, module_name, NULL);
+        dm_subtree_deps_free(si->subtree_deps);
+        si->subtree_deps = NULL;
         if (NULL == si->module){
             rc = SR_ERR_INTERNAL;
             goto unlock;
@@ -4616,6 +7739,8 @@ cleanup:
     pthread_rwlock_unlock(&dm_ctx->schema_tree_lock);
     md_ctx_unlock(dm_ctx->md_ctx);
     if (SR_ERR_OK == rc) {
+        /* the temporary contexts may contain an older revision of the module */
+        dm_tmp_ly_ctx_pool_invalidate(dm_ctx);
         *implicitly_installed_p = implicitly_installed;
     } else {
         md_free_module_key_list(implicitly_installed);
@@ -4645,6 +7770,7 @@ dm_uninstall_module_schema(dm_ctx_t *dm_ctx, const char *module_name, const char
     if (NULL != schema_info) {
         pthread_rwlock_wrlock(&schema_info->model_lock);
         if (NULL != schema_info->ly_ctx){
+            dm_data_snapshot_invalidate(dm_ctx, schema_info);
             pthread_mutex_lock(&schema_info->usage_count_mutex);
             if (0 != schema_info->usage_count) {
                 rc = SR_ERR_OPERATION_FAILED;
@@ -4668,6 +7794,117 @@ dm_uninstall_module_schema(dm_ctx_t *dm_ctx, const char *module_name, const char
     return rc;
 }
 
+/**
+ * @brief Uninstalls the module if the context is shared by all modules. The module is removed from the context
+ * together with its augments, therefore neither the module nor the modules it augments may be used.
+ * Data trees of the other modules stay valid.
+ * @param [in] dm_ctx
+ * @param [in] module_name
+ * @param [in] revision
+ * @param [out] implicitly_removed - list of modules that were removed together with the module
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_uninstall_module_shared(dm_ctx_t *dm_ctx, const char *module_name, const char *revision,
+        sr_list_t **implicitly_removed)
+{
+    CHECK_NULL_ARG3(dm_ctx, module_name, implicitly_removed);
+    int rc = SR_ERR_OK;
+    md_module_t *module = NULL;
+    md_module_key_t *module_key = NULL;
+    dm_schema_info_t lookup = {0};
+    dm_schema_info_t *schema_info = NULL, *si = NULL;
+    const struct lys_module *ly_module = NULL;
+    sr_list_t *locked = NULL;
+
+    md_ctx_lock(dm_ctx->md_ctx, true);
+    pthread_rwlock_wrlock(&dm_ctx->schema_tree_lock);
+
+    rc = dm_lock_schema_infos_write(dm_ctx, &locked);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Module %s can not be uninstalled", module_name);
+
+    rc = md_get_module_info(dm_ctx->md_ctx, module_name, revision, &module);
+    if (NULL == module) {
+        SR_LOG_ERR("Module %s with revision %s was not found", module_name, revision);
+        rc = SR_ERR_NOT_FOUND;
+        goto cleanup;
+    }
+
+    lookup.module_name = (char *) module_name;
+    schema_info = sr_btree_search(dm_ctx->schema_info_tree, &lookup);
+    if (NULL != schema_info && NULL != schema_info->ly_ctx) {
+        dm_data_snapshot_invalidate(dm_ctx, schema_info);
+        pthread_mutex_lock(&schema_info->usage_count_mutex);
+        if (0 != schema_info->usage_count) {
+            rc = SR_ERR_OPERATION_FAILED;
+            SR_LOG_ERR("Module %s can not be uninstalled because it is being used. (referenced by %zu)", module_name, schema_info->usage_count);
+        }
+        pthread_mutex_unlock(&schema_info->usage_count_mutex);
+        if (SR_ERR_OK != rc) {
+            goto cleanup;
+        }
+        ly_module = schema_info->module;
+    }
+
+    /* the augments of the module are removed from the augmented modules */
+    rc = dm_shared_ly_ctx_prepare_augmented(dm_ctx, module);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Module %s can not be uninstalled", module_name);
+
+    /* remove module from the dependency graph */
+    rc = md_remove_module(dm_ctx->md_ctx, module_name, revision, implicitly_removed);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to remove module %s from the dependency graph", module_name);
+
+    for (size_t i = 0; NULL != *implicitly_removed && i < (*implicitly_removed)->count; i++) {
+        module_key = (md_module_key_t *) (*implicitly_removed)->data[i];
+        lookup.module_name = module_key->name;
+        si = sr_btree_search(dm_ctx->schema_info_tree, &lookup);
+        if (NULL != si && NULL != si->ly_ctx) {
+            rc = dm_shared_ly_ctx_prepare_modify(dm_ctx, si);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Module %s can not be uninstalled", si->module_name);
+        }
+    }
+
+    /* libyang removes also the imports that are no longer needed */
+    if (NULL == ly_module) {
+        ly_module = ly_ctx_get_module(dm_ctx->shared_ly_ctx, module_name,
+                (NULL != revision && '\0' != revision[0]) ? revision : NULL);
+    }
+    if (NULL != ly_module && 0 != ly_ctx_remove_module(ly_module, dm_free_lys_private_data)) {
+        SR_LOG_ERR("Failed to remove module %s from the shared schema context", module_name);
+        rc = SR_ERR_INTERNAL;
+        goto cleanup;
+    }
+
+    /* detach the schema infos of the removed modules */
+    for (size_t i = 0; NULL != (si = sr_btree_get_at(dm_ctx->schema_info_tree, i)); i++) {
+        if (NULL == si->ly_ctx) {
+            continue;
+        }
+        ly_module = ly_ctx_get_module(dm_ctx->shared_ly_ctx, si->module_name, NULL);
+        if (si == schema_info || NULL == ly_module || !ly_module->implemented) {
+            si->ly_ctx = NULL;
+            si->module = NULL;
+            dm_subtree_deps_free(__atomic_exchange_n(&si->subtree_deps, NULL, __ATOMIC_ACQ_REL));
+        }
+    }
+    for (size_t i = 0; NULL != *implicitly_removed && i < (*implicitly_removed)->count; i++) {
+        module_key = (md_module_key_t *) (*implicitly_removed)->data[i];
+        lookup.module_name = module_key->name;
+        si = sr_btree_search(dm_ctx->schema_info_tree, &lookup);
+        if (NULL != si) {
+            si->ly_ctx = NULL;
+            si->module = NULL;
+        }
+    }
+    SR_LOG_DBG("Module %s uninstalled", module_name);
+
+cleanup:
+    dm_unlock_schema_infos(dm_ctx, locked);
+    pthread_rwlock_unlock(&dm_ctx->schema_tree_lock);
+    md_ctx_unlock(dm_ctx->md_ctx);
+    return rc;
+}
+
 int
 dm_uninstall_module(dm_ctx_t *dm_ctx, const char *module_name, const char *revision,
         sr_list_t **implicitly_removed_p)
@@ -4678,6 +7915,11 @@ dm_uninstall_module(dm_ctx_t *dm_ctx, const char *module_name, const char *revis
     md_module_key_t *module_key = NULL;
     sr_list_t *implicitly_removed = NULL;
 
+    if (NULL != dm_ctx->shared_ly_ctx) {
+        rc = dm_uninstall_module_shared(dm_ctx, module_name, revision, &implicitly_removed);
+        goto cleanup;
+    }
+
     /* uninstall context with module schema */
     rc = dm_uninstall_module_schema(dm_ctx, module_name, revision);
     if (SR_ERR_OK != rc) {
@@ -4705,6 +7947,7 @@ dm_uninstall_module(dm_ctx_t *dm_ctx, const char *module_name, const char *revis
 
 cleanup:
     if (SR_ERR_OK == rc) {
+        dm_tmp_ly_ctx_pool_invalidate(dm_ctx);
         *implicitly_removed_p = implicitly_removed;
     } else {
         md_free_module_key_list(implicitly_removed);
@@ -4891,7 +8134,7 @@ dm_send_enabled_notification(dm_ctx_t *dm_ctx, dm_commit_context_t *c_ctx, const
     rc = sr_list_add(notif_list, (void *) subscription);
     CHECK_RC_MSG_GOTO(rc, cleanup, "List insert failed");
 
-    rc = np_subscription_notify(dm_ctx->np_ctx, (np_subscription_t *) subscription, SR_EV_ENABLED, commit_id);
+    rc = np_subscription_notify(dm_ctx->np_ctx, (np_subscription_t *) subscription, SR_EV_ENABLED, commit_id, NULL);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Sending of SR_EV_ENABLED notification failed");
 
     rc = np_commit_notifications_sent(dm_ctx->np_ctx, commit_id, true, notif_list);
@@ -4918,6 +8161,8 @@ dm_copy_config(dm_ctx_t *dm_ctx, dm_session_t *session, const sr_list_t *module_
     char *file_name = NULL;
     int *fds = NULL;
     dm_commit_context_t *c_ctx = NULL;
+    bool journaled = dm_is_journaled(dm_ctx, dst);
+    uint64_t seq = 0;
 
     if (src == dst || 0 == module_names->count) {
         return rc;
@@ -4984,8 +8229,8 @@ dm_copy_config(dm_ctx_t *dm_ctx, dm_session_t *session, const sr_list_t *module_
             CHECK_RC_LOG_GOTO(rc, cleanup, "Module %s can not be locked in destination datastore", module_name);
         }
 
-        /* load data tree to be copied*/
-        rc = dm_get_data_info(dm_ctx, src_session, module_name, &(src_infos[i]));
+        /* load data tree to be copied, it is only read */
+        rc = dm_get_data_info_rdonly(dm_ctx, src_session, module_name, &(src_infos[i]));
         CHECK_RC_MSG_GOTO(rc, cleanup, "Get data info failed");
 
         if (NULL != subscription && 0 == i) {
@@ -5002,7 +8247,8 @@ dm_copy_config(dm_ctx_t *dm_ctx, dm_session_t *session, const sr_list_t *module_
             if (NULL != session) {
                 ac_set_user_identity(dm_ctx->ac_ctx, session->user_credentials);
             }
-            fds[opened_files] = open(file_name, O_RDWR | O_TRUNC);
+            /* if the commits are journaled, the data file is not rewritten */
+            fds[opened_files] = open(file_name, journaled ? O_RDWR : O_RDWR | O_TRUNC);
             if (NULL != session) {
                 ac_unset_user_identity(dm_ctx->ac_ctx);
             }
@@ -5012,6 +8258,15 @@ dm_copy_config(dm_ctx_t *dm_ctx, dm_session_t *session, const sr_list_t *module_
                 goto cleanup;
             }
             opened_files++;
+            if (journaled) {
+                /* readers of the data file must not see the journal in the middle of the append */
+                rc = sr_lock_fd(fds[opened_files - 1], true, true);
+                if (SR_ERR_OK != rc) {
+                    SR_LOG_ERR("File %s can not be locked", file_name);
+                    free(file_name);
+                    goto cleanup;
+                }
+            }
             free(file_name);
         }
     }
@@ -5019,9 +8274,20 @@ dm_copy_config(dm_ctx_t *dm_ctx, dm_session_t *session, const sr_list_t *module_
     int ret = 0;
     for (size_t i = 0; i < module_names->count; i++) {
         module_name = module_names->data[i];
-        if (SR_DS_CANDIDATE != dst) {
+        if (SR_DS_CANDIDATE != dst && journaled) {
+            /* the image of the copied data supersedes the data file */
+            if (SR_ERR_OK != dm_journal_append_image(dm_ctx, dst, module_name, src_infos[i]->node, &seq)) {
+                SR_LOG_ERR("Copy of module %s failed", module_name);
+                rc = SR_ERR_INTERNAL;
+            } else {
+                dm_data_snapshot_update(dm_ctx, src_infos[i]->schema, dst, fds[i], src_infos[i]->node);
+            }
+            if (SR_ERR_OK != rc) {
+                dm_data_snapshot_invalidate(dm_ctx, src_infos[i]->schema);
+            }
+        } else if (SR_DS_CANDIDATE != dst) {
             /* write dest file, dst is either startup or running*/
-            if (0 != lyd_print_fd(fds[i], src_infos[i]->node, LYD_XML, LYP_WITHSIBLINGS | LYP_FORMAT)) {
+            if (SR_ERR_OK != sr_lyd_print_data_fd(fds[i], src_infos[i]->node, dm_ctx->binary_data_files)) {
                 SR_LOG_ERR("Copy of module %s failed", module_name);
                 rc = SR_ERR_INTERNAL;
             }
@@ -5031,6 +8297,12 @@ dm_copy_config(dm_ctx_t *dm_ctx, dm_session_t *session, const sr_list_t *module_
                         (ly_errno != LY_SUCCESS) ? ly_errmsg() : sr_strerror_safe(errno));
                 rc = SR_ERR_INTERNAL;
             }
+            if (SR_ERR_OK == rc) {
+                dm_data_snapshot_update(dm_ctx, src_infos[i]->schema, dst, fds[i], src_infos[i]->node);
+            }
+            if (SR_ERR_OK != rc) {
+                dm_data_snapshot_invalidate(dm_ctx, src_infos[i]->schema);
+            }
         } else {
             /* copy data tree into candidate session */
             struct lyd_node *dup = sr_dup_datatree(src_infos[i]->node);
@@ -5045,7 +8317,7 @@ dm_copy_config(dm_ctx_t *dm_ctx, dm_session_t *session, const sr_list_t *module_
             CHECK_RC_MSG_GOTO(rc, cleanup, "Get data info failed");
             lyd_free_withsiblings(di_tmp->node);
             di_tmp->node = dup;
-            di_tmp->modified = true;
+            dm_data_info_set_modified(di_tmp, NULL);
         }
     }
 
@@ -5252,7 +8524,7 @@ dm_copy_subtree_startup_running(dm_ctx_t *ctx, dm_session_t *session, const char
         rc = SR_ERR_OK;
     }
     CHECK_RC_MSG_GOTO(rc, cleanup, "Find nodes for configuration to be enabled failed");
-    candidate_info->modified = true;
+    dm_data_info_set_modified(candidate_info, NULL);
 
     /* insert selected nodes */
     for (unsigned i = 0; NULL != nodes && i < nodes->number; i++) {
@@ -5962,10 +9234,15 @@ dm_copy_modified_session_trees(dm_ctx_t *dm_ctx, dm_session_t *from, dm_session_
         }
 
         new_info->modified = info->modified;
+        new_info->modified_untracked = info->modified;
         new_info->schema = info->schema;
         new_info->timestamp = info->timestamp;
-        lyd_free_withsiblings(new_info->node);
+        new_info->journal_seq = info->journal_seq;
+        if (!new_info->shared) {
+            lyd_free_withsiblings(new_info->node);
+        }
         new_info->node = NULL;
+        new_info->shared = false;
         if (NULL != info->node) {
             new_info->node = sr_dup_datatree(info->node);
         }
@@ -6019,16 +9296,21 @@ dm_copy_session_tree(dm_ctx_t *dm_ctx, dm_session_t *from, dm_session_t *to, con
     }
 
     new_info->modified = info->modified;
+    new_info->modified_untracked = info->modified;
     new_info->schema = info->schema;
     new_info->timestamp = info->timestamp;
+    new_info->journal_seq = info->journal_seq;
     if (NULL != info->node) {
         tmp_node = sr_dup_datatree(info->node);
         CHECK_NULL_NOMEM_ERROR(tmp_node, rc);
     }
 
     if (SR_ERR_OK == rc) {
-        lyd_free_withsiblings(new_info->node);
+        if (!new_info->shared) {
+            lyd_free_withsiblings(new_info->node);
+        }
         new_info->node = tmp_node;
+        new_info->shared = false;
     }
 
     if (!existed) {
@@ -6071,10 +9353,18 @@ dm_create_rdonly_ptr_data_tree(dm_ctx_t *dm_ctx, dm_session_t *from, dm_session_
     }
 
     new_info->modified = info->modified;
+    new_info->modified_untracked = info->modified;
     new_info->schema = info->schema;
     new_info->timestamp = info->timestamp;
+    new_info->journal_seq = info->journal_seq;
     new_info->rdonly_copy = true;
-    lyd_free_withsiblings(new_info->node);
+    if (!new_info->shared) {
+        lyd_free_withsiblings(new_info->node);
+    }
+    /* read-only copy does not hold a reference of the snapshot */
+    dm_data_snapshot_release(new_info->snapshot);
+    new_info->snapshot = NULL;
+    new_info->shared = false;
     new_info->node = info->node;
 
     if (!existed) {
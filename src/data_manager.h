@@ -60,6 +60,18 @@ typedef struct dm_session_s dm_session_t;
  */
 typedef struct rp_session_s rp_session_t;
 
+/**
+ * @brief Dependencies among the top-level subtrees of a module implied by must and when conditions,
+ * leafrefs and instance-identifiers of its config nodes. Used to limit the validation to the modified
+ * subtrees and the subtrees related to them.
+ */
+typedef struct dm_subtree_deps_s {
+    const struct lys_node **nodes;      /**< top-level data nodes of the module */
+    size_t count;                       /**< number of top-level data nodes */
+    bool *refs_any;                     /**< refs_any[i] - constraints in subtree i may reference any data */
+    bool *refs;                         /**< refs[i * count + j] - constraints in subtree i reference data in subtree j */
+} dm_subtree_deps_t;
+
 /**
  * @brief Holds information related to the schema.
  */
@@ -73,12 +85,37 @@ typedef struct dm_schema_info_s {
     struct ly_ctx *ly_ctx;              /**< libyang context contains the module and all its dependencies.
                                          * Can be NULL if module has been uninstalled
                                          * during sysrepo-engine lifetime */
+    bool shared_ly_ctx;                 /**< Flag whether ly_ctx is the context shared by all installed modules,
+                                         * such context is not owned (freed) by the schema info */
     const struct lys_module *module;    /**< Pointer to the module, might be NULL if module has been uninstalled*/
     bool cross_module_data_dependency;  /**< Flag whether data from different module is needed for validation */
     bool has_instance_id;               /**< Flag whether the module contains a node of type instance identifier */
+    dm_subtree_deps_t *subtree_deps;    /**< Cached dependencies among the top-level subtrees, NULL if not computed yet
+                                         * or the schema has changed since, accessed atomically */
     bool can_not_be_locked;             /**< If true module contains no data and lock_module for the module is NOP */
+    pthread_rwlock_t commit_lock;       /**< commit lock of the module data (see ::dm_commit_lock_set_t):
+                                         *  read    - requests reading or editing the data of the module,
+                                         *  write   - commit or copy-config modifying the data of the module */
 }dm_schema_info_t;
 
+/**
+ * @brief Set of per-module commit locks held by a request. Modules are kept sorted by name,
+ * which is the canonical order in which the locks are acquired, so that requests locking
+ * overlapping sets of modules can not deadlock.
+ */
+typedef struct dm_commit_lock_set_s {
+    dm_schema_info_t **schemas;         /**< Modules whose commit lock is part of the set */
+    bool *write;                        /**< Flags whether the lock of the corresponding module is acquired for writing */
+    size_t count;                       /**< Number of modules in the set */
+    size_t size;                        /**< Number of allocated items */
+    bool locked;                        /**< Flag whether the locks are currently held */
+} dm_commit_lock_set_t;
+
+/**
+ * @brief Immutable reference counted data tree shared among sessions.
+ */
+typedef struct dm_data_snapshot_s dm_data_snapshot_t;
+
 /**
  * @brief Structure holds data tree related info
  */
@@ -86,11 +123,30 @@ typedef struct dm_data_info_s{
     bool rdonly_copy;                   /**< node member is only copy of pointer it must not be freed nor modified */
     dm_schema_info_t *schema;           /**< pointer to schema info */
     struct lyd_node *node;              /**< data tree */
+    dm_data_snapshot_t *snapshot;       /**< snapshot the data tree was taken from (reference is held), NULL if none */
+    bool shared;                        /**< node member points into the snapshot, it must not be freed nor modified */
     struct timespec timestamp;          /**< timestamp of this copy (used only if HAVE_ST_MTIM is defined) */
+    uint64_t journal_seq;               /**< journal sequence number of the loaded content (used only if commits are journaled) */
     bool modified;                      /**< flag denoting whether a change has been made*/
     sr_list_t *required_modules;        /**< schemas that needs to be in context to print data */
+    sr_list_t *modified_subtrees;       /**< names of the top-level nodes modified since the last successful validation
+                                         * (see ::dm_data_info_set_modified) */
+    bool modified_untracked;            /**< flag whether the data tree has been modified since the last successful
+                                         * validation in a way that is not tracked in modified_subtrees */
 }dm_data_info_t;
 
+/**
+ * @brief Structure holding an instance of temporary libyang context that can be used
+ * for validation or parsing
+ */
+typedef struct dm_tmp_ly_ctx_s {
+    struct ly_ctx *ctx;           /**< libyang context */
+    char *signature;              /**< signature of the set of modules loaded into the context, NULL if the context needs to be (re)built */
+    uint32_t generation;          /**< generation of the pool the context was built in */
+    uint64_t last_used;           /**< value of the pool usage counter when the context was acquired the last time */
+    bool in_use;                  /**< flag whether the context is acquired */
+} dm_tmp_ly_ctx_t;
+
 /**
  * @brief States of the node in running data store.
  */
@@ -107,6 +163,7 @@ typedef enum dm_operation_e {
     DM_SET_OP,
     DM_DELETE_OP,
     DM_MOVE_OP,
+    DM_IMPORT_OP,
 } dm_operation_t;
 
 /**
@@ -146,6 +203,12 @@ typedef struct dm_sess_op_s{
             sr_move_position_t position; /**< Position */
             char *relative_item;         /**< Xpath of item used for relative moves*/
         }mov;
+        struct imp{
+            char *module_name;           /**< Module whose data are imported */
+            char *data;                  /**< Serialized data tree to be imported */
+            LYD_FORMAT format;           /**< Format of the serialized data tree */
+            bool replace;                /**< Replace the data of the module instead of merging */
+        }imp;
     }detail;
 }dm_sess_op_t;
 
@@ -157,6 +220,8 @@ typedef struct dm_model_subscription_s {
     dm_schema_info_t *schema_info;      /**< schema info identifying the module to which the subscriptions are tied to */
     sr_list_t *subscriptions;           /**< list of struct received from np */
     struct lys_node **nodes;            /**< array of schema nodes corresponding to the subscription */
+    sr_btree_t *node_index;             /**< subscriptions indexed by the subscribed schema node (NULL node for module-wide subscriptions) */
+    bool *matched;                      /**< per-subscription flag whether the difflist contains a matching change, computed once per difflist */
     struct lyd_difflist *difflist;      /**< diff list */
     sr_list_t *changes;                 /**< set of changes for the model */
     bool changes_generated;             /**< Flag signalizing that changes has been generated */
@@ -242,7 +307,10 @@ typedef struct dm_c_ctxs_s {
 
 /**
  * @brief Initializes the data manager context, which will be passed in further
- * data manager related calls.
+ * data manager related calls. By default each module is loaded into its own libyang
+ * context together with its dependencies when it is requested for the first time.
+ * If SR_SHARED_SCHEMA_CTX_ENV environment variable is set, all installed modules are loaded
+ * into a single shared context during the initialization instead.
  * @param [in] ac_ctx Access Control module context
  * @param [in] np_ctx Notification Processor context
  * @param [in] pm_ctx Persistence Manager context
@@ -295,6 +363,22 @@ void dm_session_stop(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx);
  */
 int dm_get_data_info(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, dm_data_info_t **info);
 
+/**
+ * @brief Returns the structure holding data tree for the specified module. Unlike ::dm_get_data_info
+ * the data tree of the returned structure may be shared with other sessions, it must not be modified.
+ * The first read of an unmodified running or startup data tree is thus served from the shared
+ * snapshot without parsing the data file.
+ *
+ * @note Function acquires and releases read lock for the schema info.
+ *
+ * @param [in] dm_ctx
+ * @param [in] dm_session_ctx
+ * @param [in] module_name
+ * @param [out] info
+ * @return Error code (SR_ERR_OK on success), SR_ERR_UNKNOWN_MODEL
+ */
+int dm_get_data_info_rdonly(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, dm_data_info_t **info);
+
 /**
  * @brief Returns the data tree for the specified module.
  * @param [in] dm_ctx
@@ -348,6 +432,57 @@ int dm_get_module_and_lockw(dm_ctx_t *dm_ctx, const char *module_name, dm_schema
  */
 int dm_get_module_without_lock(dm_ctx_t *dm_ctx, const char *module_name, dm_schema_info_t **schema_info);
 
+/**
+ * @brief Adds the module into the commit lock set. If the module depends on the data of other modules
+ * (cross_module_data_dependency), the modules it depends on are added for reading as well. Unknown modules
+ * are skipped, the error is reported by the request processing.
+ *
+ * @param [in] dm_ctx
+ * @param [in] set
+ * @param [in] module_name
+ * @param [in] write - the commit lock of the module is going to be acquired for writing
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_commit_lock_set_add(dm_ctx_t *dm_ctx, dm_commit_lock_set_t *set, const char *module_name, bool write);
+
+/**
+ * @brief Adds the modules whose data are loaded in the session (current datastore) into the commit lock set.
+ *
+ * @param [in] dm_ctx
+ * @param [in] set
+ * @param [in] session
+ * @param [in] modified_only - add only the modules modified in the session
+ * @param [in] write
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_commit_lock_set_add_session_modules(dm_ctx_t *dm_ctx, dm_commit_lock_set_t *set, dm_session_t *session,
+        bool modified_only, bool write);
+
+/**
+ * @brief Adds all installed modules into the commit lock set.
+ *
+ * @param [in] dm_ctx
+ * @param [in] set
+ * @param [in] session
+ * @param [in] write
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_commit_lock_set_add_all(dm_ctx_t *dm_ctx, dm_commit_lock_set_t *set, dm_session_t *session, bool write);
+
+/**
+ * @brief Acquires the commit locks of all modules in the set in the canonical order.
+ *
+ * @param [in] set
+ */
+void dm_commit_lock_set_acquire(dm_commit_lock_set_t *set);
+
+/**
+ * @brief Releases the commit locks held by the set (if any) and frees the content of the set.
+ *
+ * @param [in] set
+ */
+void dm_commit_lock_set_cleanup(dm_commit_lock_set_t *set);
+
 /**
  * @brief Returns an array that contains information about schemas supported by sysrepo.
  * @param [in] dm_ctx
@@ -375,7 +510,23 @@ int dm_list_schemas(dm_ctx_t *dm_ctx, dm_session_t *dm_session, sr_schema_t **sc
 int dm_get_schema(dm_ctx_t *dm_ctx, const char *module_name, const char *module_revision, const char *submodule_name, const char *submodule_revision, bool yang_format, char **schema);
 
 /**
- * @brief Validates the data_trees in session.
+ * @brief Marks the data tree as modified and records which top-level subtree has been changed.
+ * Subtrees changed since the last successful validation are the only ones validated by
+ * ::dm_validate_session_data_trees if the module allows it.
+ *
+ * @param [in] info
+ * @param [in] xpath - xpath of the modified node, NULL if the change can not be attributed to
+ * a single top-level subtree (the whole data tree will be validated)
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_data_info_set_modified(dm_data_info_t *info, const char *xpath);
+
+/**
+ * @brief Validates the data_trees in session. Only the data trees modified since their last
+ * successful validation are validated. If the validity of the module data can not depend on
+ * the data outside of the changed top-level subtree (there are no must, when, leafref or
+ * instance-identifier constraints), only the changed top-level subtrees are validated. Full
+ * validation can be enforced by SR_FULL_VALIDATION_ENV environment variable.
  *
  * @note Function does not acquire nor release a schema lock.
  *
@@ -514,6 +665,27 @@ int dm_add_del_operation(dm_session_t *session, const char *xpath, sr_edit_optio
 
 int dm_add_move_operation(dm_session_t *session, const char *xpath, sr_move_position_t pos, const char *rel_item);
 
+/**
+ * @brief Logs the import of a serialized data tree of the module into session operation list.
+ * Data are freed with the operation list, or right away in case of error.
+ * @param [in] session
+ * @param [in] module_name
+ * @param [in] data - serialized data tree, must be allocated
+ * @param [in] format
+ * @param [in] replace - replace the data of the module instead of merging
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_add_import_operation(dm_session_t *session, const char *module_name, char *data, LYD_FORMAT format, bool replace);
+
+/**
+ * @brief Ensures that the session operation list has room for the specified number of
+ * additional operations, so that a batch of operations can be logged without repeated reallocations.
+ * @param [in] session
+ * @param [in] count - number of operations to be added
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_reserve_operations(dm_session_t *session, size_t count);
+
 /**
  * @brief Removes last logged operation in session
  * @param [in] session
@@ -673,7 +845,9 @@ int dm_unlock_datastore(dm_ctx_t *dm_ctx, dm_session_t *session);
 /**
  * @brief Enables or disables the feature state in the module.
  *
- * @note Function acquires and releases write lock for the schema info.
+ * @note Function acquires and releases write lock for the schema info. If all modules share one context,
+ * write locks of all schema infos are acquired. In both cases the toggle fails if the module or a module
+ * it augments is being used.
  *
  * @param [in] dm_ctx
  * @param [in] module_name
@@ -1122,5 +1296,41 @@ int dm_get_session_datatrees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_btree_t
  * @return Error code (SR_ERR_OK on success)
  */
 int dm_wait_for_commit_context_to_be_empty(dm_ctx_t *dm_ctx);
+
+/**
+ * @brief Acquires temporary libyang context, that can be used to parse/validate/print data that
+ * requires schemas different from installation time dependencies. An idle context from the pool
+ * with the same set of modules is reused, otherwise the modules are loaded into a new context
+ * or into the least recently used idle one. If the context is shared by all installed modules,
+ * the shared context is returned instead, since it already contains any module that can be requested.
+ * @param [in] dm_ctx
+ * @param [in] models_to_be_loaded - list of modules that should be loaded into temporary context,
+ * NULL if the modules are going to be loaded on demand
+ * @param [out] tmp_ctx - acquired context. Once the context is no more needed it should be released
+ * using ::dm_release_tmp_ly_ctx
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_get_tmp_ly_ctx(dm_ctx_t *dm_ctx, sr_list_t *models_to_be_loaded, dm_tmp_ly_ctx_t **tmp_ctx);
+
+/**
+ * @brief Releases the previously acquired tmp ly_ctx.
+ * @param [in] dm_ctx
+ * @param [in] tmp_ctx
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_release_tmp_ly_ctx(dm_ctx_t *dm_ctx, dm_tmp_ly_ctx_t *tmp_ctx);
+
+/**
+ * @brief Returns the dependencies among the top-level subtrees of the module of the schema info
+ * used to limit the validation of modified data. They are computed once and cached until
+ * the schema changes.
+ *
+ * @note Model lock of the schema info is expected to be held.
+ *
+ * @param [in] schema_info
+ * @param [out] deps
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_get_subtree_deps(dm_schema_info_t *schema_info, const dm_subtree_deps_t **deps);
 /**@} Data manager*/
 #endif /* SRC_DATA_MANAGER_H_ */
@@ -0,0 +1,1031 @@
+/**
+ * @file dm_journal.c
+ * @author agent <agent@local>
+ * @brief Write-ahead journal of the changes committed into the modules of a datastore.
+ *
+ * @copyright
+ * Copyright 2026 agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <inttypes.h>
+
+#include "sr_common.h"
+#include "dm_journal.h"
+
+/** Magic number at the beginning of the journal file. */
+#define DM_JOURNAL_MAGIC "SRJ1"
+/** Length of the magic number. */
+#define DM_JOURNAL_MAGIC_LEN 4
+/** Size of the journal header: magic and the sequence number of the last checkpoint. */
+#define DM_JOURNAL_HEADER_SIZE (DM_JOURNAL_MAGIC_LEN + sizeof(uint64_t))
+/** Size of the record frame: length of the rest of the record and its checksum. */
+#define DM_JOURNAL_FRAME_SIZE (2 * sizeof(uint32_t))
+/** Size of the fixed part of the record after the frame: sequence number and kind. */
+#define DM_JOURNAL_RECORD_HEAD_SIZE (sizeof(uint64_t) + sizeof(uint8_t))
+
+/** Record kinds. */
+#define DM_JOURNAL_RECORD_CHANGES 1   /**< changes of the module data */
+#define DM_JOURNAL_RECORD_IMAGE   2   /**< complete content of the module in the XML format */
+
+/** Operations of the changes record. */
+#define DM_JOURNAL_OP_SET    1   /**< create or update the node identified by the path */
+#define DM_JOURNAL_OP_DELETE 2   /**< delete the node identified by the path */
+
+/** Length of the value denoting that the operation has no value. */
+#define DM_JOURNAL_NO_VALUE UINT32_MAX
+
+/**
+ * @brief Index entry of a journal record.
+ */
+typedef struct dm_journal_rec_s {
+    uint64_t seq;               /**< sequence number of the record */
+    bool image;                 /**< flag whether the record is an image record */
+    off_t offset;               /**< offset of the operations (or the image) of the record in the file */
+    size_t size;                /**< size of the operations (or the image) */
+} dm_journal_rec_t;
+
+/**
+ * @brief Journal context.
+ */
+struct dm_journal_s {
+    char *file_name;            /**< path of the journal file */
+    char *data_file_name;       /**< path of the data file of the module, its owner and permissions are used for the journal */
+    int fd;                     /**< file descriptor of the opened journal file, -1 if the file does not exist yet */
+    bool read_only;             /**< flag whether the journal could be opened only for reading */
+    pthread_mutex_t mutex;      /**< mutex serializing the access within the process */
+    pthread_t owner;            /**< thread holding the lock */
+    size_t lock_depth;          /**< number of recursive acquisitions of the lock by the owner */
+    bool write_locked;          /**< flag whether the lock is held for writing */
+    uint64_t base_seq;          /**< sequence number of the last checkpoint */
+    uint64_t last_seq;          /**< sequence number of the last record */
+    off_t indexed_size;         /**< end of the last valid record */
+    dm_journal_rec_t *records;  /**< index of the records */
+    size_t rec_count;           /**< number of records in the index */
+    size_t rec_size;            /**< allocated size of the index */
+};
+
+/**
+ * @brief Batch of the records prepared to be appended.
+ */
+struct dm_journal_batch_s {
+    char *data;                 /**< framed records, sequence numbers and checksums are filled in by append */
+    size_t size;                /**< allocated size of data */
+    size_t used;                /**< used size of data */
+    size_t count;               /**< number of records in the batch */
+};
+
+/**
+ * @brief FNV-1a checksum of the record.
+ */
+static uint32_t
+dm_journal_checksum(const char *data, size_t len)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t) data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int
+dm_journal_pread(int fd, void *buf, size_t len, off_t offset)
+{
+    ssize_t ret = 0;
+    size_t done = 0;
+
+    while (done < len) {
+        ret = pread(fd, (char *) buf + done, len - done, offset + done);
+        if (-1 == ret && EINTR == errno) {
+            continue;
+        }
+        if (ret <= 0) {
+            return SR_ERR_IO;
+        }
+        done += ret;
+    }
+    return SR_ERR_OK;
+}
+
+static int
+dm_journal_pwrite(int fd, const void *buf, size_t len, off_t offset)
+{
+    ssize_t ret = 0;
+    size_t done = 0;
+
+    while (done < len) {
+        ret = pwrite(fd, (const char *) buf + done, len - done, offset + done);
+        if (-1 == ret && EINTR == errno) {
+            continue;
+        }
+        if (ret <= 0) {
+            SR_LOG_ERR("Failed to write into the journal: %s", sr_strerror_safe(errno));
+            return SR_ERR_IO;
+        }
+        done += ret;
+    }
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Drops the index of the records.
+ */
+static void
+dm_journal_index_reset(dm_journal_t *journal, uint64_t base_seq)
+{
+    journal->rec_count = 0;
+    journal->base_seq = base_seq;
+    journal->last_seq = base_seq;
+    journal->indexed_size = DM_JOURNAL_HEADER_SIZE;
+}
+
+static int
+dm_journal_write_header(dm_journal_t *journal, uint64_t base_seq)
+{
+    char header[DM_JOURNAL_HEADER_SIZE] = {0};
+
+    memcpy(header, DM_JOURNAL_MAGIC, DM_JOURNAL_MAGIC_LEN);
+    memcpy(header + DM_JOURNAL_MAGIC_LEN, &base_seq, sizeof(base_seq));
+    return dm_journal_pwrite(journal->fd, header, DM_JOURNAL_HEADER_SIZE, 0);
+}
+
+/**
+ * @brief Brings the index of the records up to date with the journal file, parses only the records
+ * appended since the last refresh. A torn record at the end of the file (e.g. after a crash
+ * during append) and all that follow it are ignored.
+ */
+static int
+dm_journal_refresh(dm_journal_t *journal)
+{
+    struct stat st = {0};
+    char header[DM_JOURNAL_HEADER_SIZE] = {0};
+    uint64_t base_seq = 0, seq = 0;
+    uint32_t frame[2] = {0};
+    uint8_t kind = 0;
+    char *buf = NULL, *tmp = NULL;
+    size_t buf_size = 0;
+    dm_journal_rec_t *records = NULL;
+    off_t pos = 0;
+    int rc = SR_ERR_OK;
+
+    if (-1 == journal->fd) {
+        /* the journal has not been created yet */
+        dm_journal_index_reset(journal, 0);
+        return SR_ERR_OK;
+    }
+    if (-1 == fstat(journal->fd, &st)) {
+        SR_LOG_ERR("Stat of the journal %s failed: %s", journal->file_name, sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
+    if (st.st_size < (off_t) DM_JOURNAL_HEADER_SIZE) {
+        /* new journal */
+        if (journal->write_locked) {
+            rc = dm_journal_write_header(journal, 0);
+            CHECK_RC_LOG_RETURN(rc, "Failed to initialize the journal %s", journal->file_name);
+        }
+        dm_journal_index_reset(journal, 0);
+        return SR_ERR_OK;
+    }
+
+    rc = dm_journal_pread(journal->fd, header, DM_JOURNAL_HEADER_SIZE, 0);
+    CHECK_RC_LOG_RETURN(rc, "Failed to read the header of the journal %s", journal->file_name);
+    if (0 != memcmp(header, DM_JOURNAL_MAGIC, DM_JOURNAL_MAGIC_LEN)) {
+        SR_LOG_ERR("File %s is not a sysrepo journal", journal->file_name);
+        return SR_ERR_MALFORMED_MSG;
+    }
+    memcpy(&base_seq, header + DM_JOURNAL_MAGIC_LEN, sizeof(base_seq));
+
+    if (base_seq != journal->base_seq || st.st_size < journal->indexed_size) {
+        /* checkpoint has been made since the last refresh */
+        dm_journal_index_reset(journal, base_seq);
+    }
+
+    pos = journal->indexed_size;
+    while (pos + (off_t) DM_JOURNAL_FRAME_SIZE <= st.st_size) {
+        if (SR_ERR_OK != dm_journal_pread(journal->fd, frame, sizeof(frame), pos) ||
+                frame[0] < DM_JOURNAL_RECORD_HEAD_SIZE || pos + (off_t) DM_JOURNAL_FRAME_SIZE + frame[0] > st.st_size) {
+            break;
+        }
+        if (frame[0] > buf_size) {
+            tmp = realloc(buf, frame[0]);
+            CHECK_NULL_NOMEM_GOTO(tmp, rc, cleanup);
+            buf = tmp;
+            buf_size = frame[0];
+        }
+        if (SR_ERR_OK != dm_journal_pread(journal->fd, buf, frame[0], pos + DM_JOURNAL_FRAME_SIZE) ||
+                frame[1] != dm_journal_checksum(buf, frame[0])) {
+            break;
+        }
+        memcpy(&seq, buf, sizeof(seq));
+        memcpy(&kind, buf + sizeof(seq), sizeof(kind));
+        if (seq <= journal->last_seq || (DM_JOURNAL_RECORD_CHANGES != kind && DM_JOURNAL_RECORD_IMAGE != kind)) {
+            /* records already folded into the data file or malformed record */
+            if (seq > base_seq) {
+                break;
+            }
+            pos += DM_JOURNAL_FRAME_SIZE + frame[0];
+            continue;
+        }
+
+        if (journal->rec_count == journal->rec_size) {
+            records = realloc(journal->records, (journal->rec_size ? journal->rec_size * 2 : 16) * sizeof(*records));
+            CHECK_NULL_NOMEM_GOTO(records, rc, cleanup);
+            journal->records = records;
+            journal->rec_size = journal->rec_size ? journal->rec_size * 2 : 16;
+        }
+        records = &journal->records[journal->rec_count];
+        records->seq = seq;
+        records->image = (DM_JOURNAL_RECORD_IMAGE == kind);
+        records->offset = pos + DM_JOURNAL_FRAME_SIZE + DM_JOURNAL_RECORD_HEAD_SIZE;
+        records->size = frame[0] - DM_JOURNAL_RECORD_HEAD_SIZE;
+        journal->rec_count++;
+        journal->last_seq = seq;
+
+        pos += DM_JOURNAL_FRAME_SIZE + frame[0];
+    }
+    journal->indexed_size = pos;
+
+cleanup:
+    free(buf);
+    return rc;
+}
+
+int
+dm_journal_init(const char *data_search_dir, const char *module_name, sr_datastore_t ds, dm_journal_t **journal_p)
+{
+    CHECK_NULL_ARG3(data_search_dir, module_name, journal_p);
+    dm_journal_t *journal = NULL;
+    int rc = SR_ERR_OK;
+
+    journal = calloc(1, sizeof(*journal));
+    CHECK_NULL_NOMEM_RETURN(journal);
+    journal->fd = -1;
+    journal->indexed_size = DM_JOURNAL_HEADER_SIZE;
+    pthread_mutex_init(&journal->mutex, NULL);
+
+    rc = sr_get_data_file_name(data_search_dir, module_name, ds, &journal->data_file_name);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Get data file name failed");
+    rc = sr_str_join(journal->data_file_name, SR_JOURNAL_FILE_EXT, &journal->file_name);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "String join failed");
+
+cleanup:
+    if (SR_ERR_OK == rc) {
+        *journal_p = journal;
+    } else {
+        dm_journal_cleanup(journal);
+    }
+    return rc;
+}
+
+/**
+ * @brief Creates the journal file with the owner and the permissions of the data file, so that
+ * exactly the users allowed to write the data of the module can append to the journal.
+ */
+static int
+dm_journal_create(dm_journal_t *journal)
+{
+    struct stat st = {0};
+    mode_t mode = S_IRUSR | S_IWUSR;
+    bool have_owner = false;
+    int fd = -1;
+
+    if (0 == stat(journal->data_file_name, &st)) {
+        mode = st.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO);
+        have_owner = true;
+    }
+
+    fd = open(journal->file_name, O_RDWR | O_CREAT | O_EXCL, mode);
+    if (-1 == fd) {
+        return EEXIST == errno ? SR_ERR_OK : (EACCES == errno ? SR_ERR_UNAUTHORIZED : SR_ERR_IO);
+    }
+    /* the mode might have been reduced by umask */
+    if (0 != fchmod(fd, mode)) {
+        SR_LOG_WRN("Unable to execute chmod on '%s': %s.", journal->file_name, sr_strerror_safe(errno));
+    }
+    if (have_owner && 0 != fchown(fd, st.st_uid, st.st_gid) && 0 != fchown(fd, -1, st.st_gid)) {
+        /* non-privileged process may not be able to change the owner, correct permissions
+         * can be set up at any time using sysrepoctl */
+        SR_LOG_WRN("Unable to execute chown on '%s': %s.", journal->file_name, sr_strerror_safe(errno));
+    }
+    journal->fd = fd;
+    SR_LOG_DBG("Journal %s created", journal->file_name);
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Opens the journal file if it has not been opened yet.
+ * @param [in] journal
+ * @param [in] create Flag whether the journal should be created if it does not exist.
+ */
+static int
+dm_journal_open(dm_journal_t *journal, bool create)
+{
+    int rc = SR_ERR_OK;
+
+    if (-1 != journal->fd) {
+        return SR_ERR_OK;
+    }
+
+    journal->fd = open(journal->file_name, O_RDWR);
+    journal->read_only = false;
+    if (-1 == journal->fd && EACCES == errno) {
+        /* the journal can be still read, the module can not be committed by this user */
+        journal->fd = open(journal->file_name, O_RDONLY);
+        journal->read_only = true;
+    }
+    if (-1 == journal->fd && ENOENT == errno) {
+        if (!create) {
+            /* no records have been appended yet */
+            return SR_ERR_OK;
+        }
+        rc = dm_journal_create(journal);
+        if (SR_ERR_OK == rc && -1 == journal->fd) {
+            /* created by another process in the meantime */
+            journal->fd = open(journal->file_name, O_RDWR);
+        }
+    }
+    if (SR_ERR_OK != rc || -1 == journal->fd) {
+        SR_LOG_ERR("Unable to open the journal %s: %s", journal->file_name, sr_strerror_safe(errno));
+        journal->fd = -1;
+        return (SR_ERR_OK != rc) ? rc : (EACCES == errno ? SR_ERR_UNAUTHORIZED : SR_ERR_IO);
+    }
+    SR_LOG_DBG("Journal %s opened%s", journal->file_name, journal->read_only ? " for reading" : "");
+    return rc;
+}
+
+void
+dm_journal_cleanup(dm_journal_t *journal)
+{
+    if (NULL != journal) {
+        dm_journal_index_reset(journal, 0);
+        free(journal->records);
+        if (-1 != journal->fd) {
+            close(journal->fd);
+        }
+        pthread_mutex_destroy(&journal->mutex);
+        free(journal->file_name);
+        free(journal->data_file_name);
+        free(journal);
+    }
+}
+
+int
+dm_journal_lock(dm_journal_t *journal, bool write)
+{
+    CHECK_NULL_ARG(journal);
+    int rc = SR_ERR_OK;
+
+    if (journal->lock_depth > 0 && pthread_equal(journal->owner, pthread_self())) {
+        if (write && !journal->write_locked) {
+            SR_LOG_ERR("Journal %s locked for reading can not be locked for writing", journal->file_name);
+            return SR_ERR_INTERNAL;
+        }
+        journal->lock_depth++;
+        return SR_ERR_OK;
+    }
+
+    pthread_mutex_lock(&journal->mutex);
+    rc = dm_journal_open(journal, write);
+    if (SR_ERR_OK == rc && write && journal->read_only) {
+        SR_LOG_ERR("Journal %s can not be written", journal->file_name);
+        rc = SR_ERR_UNAUTHORIZED;
+    }
+    if (SR_ERR_OK == rc && -1 != journal->fd) {
+        rc = sr_lock_fd(journal->fd, write, true);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Failed to lock the journal %s", journal->file_name);
+        }
+    }
+    if (SR_ERR_OK != rc) {
+        pthread_mutex_unlock(&journal->mutex);
+        return rc;
+    }
+    journal->owner = pthread_self();
+    journal->lock_depth = 1;
+    journal->write_locked = write;
+
+    rc = dm_journal_refresh(journal);
+    if (SR_ERR_OK != rc) {
+        dm_journal_unlock(journal);
+    }
+    return rc;
+}
+
+void
+dm_journal_unlock(dm_journal_t *journal)
+{
+    CHECK_NULL_ARG_VOID(journal);
+
+    if (0 == journal->lock_depth || !pthread_equal(journal->owner, pthread_self())) {
+        SR_LOG_WRN("Journal %s is not locked by this thread", journal->file_name);
+        return;
+    }
+    if (0 == --journal->lock_depth) {
+        if (-1 != journal->fd) {
+            sr_unlock_fd(journal->fd);
+        }
+        journal->write_locked = false;
+        pthread_mutex_unlock(&journal->mutex);
+    }
+}
+
+/**
+ * @brief Returns the index of the last image record, the number of records if there is none.
+ * Journal must be locked.
+ */
+static size_t
+dm_journal_last_image(dm_journal_t *journal)
+{
+    for (size_t i = journal->rec_count; i > 0; i--) {
+        if (journal->records[i - 1].image) {
+            return i - 1;
+        }
+    }
+    return journal->rec_count;
+}
+
+int
+dm_journal_get_seq(dm_journal_t *journal, uint64_t *seq)
+{
+    CHECK_NULL_ARG2(journal, seq);
+    int rc = SR_ERR_OK;
+
+    rc = dm_journal_lock(journal, false);
+    CHECK_RC_MSG_RETURN(rc, "Failed to lock the journal");
+    *seq = journal->last_seq;
+    dm_journal_unlock(journal);
+
+    return rc;
+}
+
+int
+dm_journal_get_image(dm_journal_t *journal, char **image)
+{
+    CHECK_NULL_ARG2(journal, image);
+    dm_journal_rec_t *record = NULL;
+    size_t last = 0;
+    int rc = SR_ERR_OK;
+
+    *image = NULL;
+    rc = dm_journal_lock(journal, false);
+    CHECK_RC_MSG_RETURN(rc, "Failed to lock the journal");
+
+    last = dm_journal_last_image(journal);
+    if (last < journal->rec_count) {
+        record = &journal->records[last];
+        *image = calloc(record->size + 1, sizeof(**image));
+        CHECK_NULL_NOMEM_GOTO(*image, rc, cleanup);
+        if (record->size > 0) {
+            rc = dm_journal_pread(journal->fd, *image, record->size, record->offset);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to read journal record %"PRIu64, record->seq);
+        }
+        SR_LOG_DBG("Image of the module taken from journal record %"PRIu64, record->seq);
+    }
+
+cleanup:
+    if (SR_ERR_OK != rc) {
+        free(*image);
+        *image = NULL;
+    }
+    dm_journal_unlock(journal);
+    return rc;
+}
+
+/**
+ * @brief Moves the pointer to the first of the top-level siblings.
+ */
+static void
+dm_journal_first_sibling(struct lyd_node **root)
+{
+    while (NULL != *root && NULL != (*root)->prev->next) {
+        *root = (*root)->prev;
+    }
+}
+
+/**
+ * @brief Applies the operations of one record.
+ */
+static int
+dm_journal_apply_record(dm_journal_t *journal, const dm_journal_rec_t *record, struct ly_ctx *ly_ctx, struct lyd_node **root)
+{
+    char *buf = NULL, *path = NULL, *value = NULL;
+    size_t pos = 0;
+    uint32_t path_len = 0, value_len = 0;
+    uint8_t op = 0;
+    struct lyd_node *node = NULL;
+    struct ly_set *set = NULL;
+    int rc = SR_ERR_OK;
+
+    if (0 == record->size) {
+        return SR_ERR_OK;
+    }
+    buf = malloc(record->size);
+    CHECK_NULL_NOMEM_RETURN(buf);
+    rc = dm_journal_pread(journal->fd, buf, record->size, record->offset);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to read journal record %"PRIu64, record->seq);
+
+    while (pos < record->size) {
+        if (pos + sizeof(op) + sizeof(path_len) > record->size) {
+            rc = SR_ERR_MALFORMED_MSG;
+            break;
+        }
+        memcpy(&op, buf + pos, sizeof(op));
+        memcpy(&path_len, buf + pos + sizeof(op), sizeof(path_len));
+        pos += sizeof(op) + sizeof(path_len);
+        if (pos + path_len + sizeof(value_len) > record->size) {
+            rc = SR_ERR_MALFORMED_MSG;
+            break;
+        }
+        path = strndup(buf + pos, path_len);
+        CHECK_NULL_NOMEM_GOTO(path, rc, cleanup);
+        pos += path_len;
+        memcpy(&value_len, buf + pos, sizeof(value_len));
+        pos += sizeof(value_len);
+        if (DM_JOURNAL_NO_VALUE != value_len) {
+            if (pos + value_len > record->size) {
+                rc = SR_ERR_MALFORMED_MSG;
+                break;
+            }
+            value = strndup(buf + pos, value_len);
+            CHECK_NULL_NOMEM_GOTO(value, rc, cleanup);
+            pos += value_len;
+        }
+
+        if (DM_JOURNAL_OP_SET == op) {
+            ly_errno = LY_SUCCESS;
+            node = lyd_new_path(*root, ly_ctx, path, value, 0, LYD_PATH_OPT_UPDATE);
+            if (NULL == node && LY_SUCCESS != ly_errno) {
+                SR_LOG_ERR("Failed to set %s from journal: %s", path, ly_errmsg());
+                rc = SR_ERR_INTERNAL;
+                goto cleanup;
+            }
+            if (NULL == *root) {
+                *root = node;
+            }
+        } else if (DM_JOURNAL_OP_DELETE == op) {
+            if (NULL != *root) {
+                set = lyd_find_xpath(*root, path);
+                if (NULL == set) {
+                    SR_LOG_ERR("Failed to find %s from journal: %s", path, ly_errmsg());
+                    rc = SR_ERR_INTERNAL;
+                    goto cleanup;
+                }
+                for (unsigned int i = 0; i < set->number; i++) {
+                    if (*root == set->set.d[i]) {
+                        *root = (*root)->next;
+                    }
+                    lyd_free(set->set.d[i]);
+                }
+                ly_set_free(set);
+                set = NULL;
+            }
+        } else {
+            SR_LOG_ERR("Unknown operation %u in journal record %"PRIu64, op, record->seq);
+            rc = SR_ERR_MALFORMED_MSG;
+            goto cleanup;
+        }
+        dm_journal_first_sibling(root);
+
+        free(path);
+        free(value);
+        path = NULL;
+        value = NULL;
+    }
+    if (SR_ERR_MALFORMED_MSG == rc) {
+        SR_LOG_ERR("Malformed journal record %"PRIu64, record->seq);
+    }
+
+cleanup:
+    ly_set_free(set);
+    free(path);
+    free(value);
+    free(buf);
+    return rc;
+}
+
+int
+dm_journal_replay(dm_journal_t *journal, struct ly_ctx *ly_ctx, struct lyd_node **root, uint64_t *seq)
+{
+    CHECK_NULL_ARG4(journal, ly_ctx, root, seq);
+    size_t first = 0, applied = 0;
+    int rc = SR_ERR_OK;
+
+    rc = dm_journal_lock(journal, false);
+    CHECK_RC_MSG_RETURN(rc, "Failed to lock the journal");
+
+    *seq = journal->last_seq;
+    first = dm_journal_last_image(journal);
+    first = (first < journal->rec_count) ? first + 1 : 0;
+    for (size_t i = first; i < journal->rec_count; i++) {
+        /* records at or below the base sequence number are already in the data file (or in the image),
+         * the operations are not idempotent so they must not be applied again */
+        rc = dm_journal_apply_record(journal, &journal->records[i], ly_ctx, root);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to apply journal record %"PRIu64" of %s",
+                journal->records[i].seq, journal->file_name);
+        applied++;
+    }
+    if (applied > 0) {
+        SR_LOG_DBG("%zu journal record(s) of %s applied", applied, journal->file_name);
+    }
+
+cleanup:
+    dm_journal_unlock(journal);
+    return rc;
+}
+
+int
+dm_journal_truncate(dm_journal_t *journal, uint64_t *seq)
+{
+    CHECK_NULL_ARG2(journal, seq);
+    uint64_t base_seq = journal->last_seq;
+    int rc = SR_ERR_OK;
+
+    if (!journal->write_locked) {
+        SR_LOG_ERR("Journal %s must be locked for writing", journal->file_name);
+        return SR_ERR_INTERNAL;
+    }
+    if (-1 == journal->fd) {
+        *seq = base_seq;
+        return SR_ERR_OK;
+    }
+
+    /* records up to the new base are ignored even if the truncation does not finish */
+    rc = dm_journal_write_header(journal, base_seq);
+    if (SR_ERR_OK == rc && 0 != fsync(journal->fd)) {
+        rc = SR_ERR_IO;
+    }
+    if (SR_ERR_OK == rc && (0 != ftruncate(journal->fd, DM_JOURNAL_HEADER_SIZE) || 0 != fsync(journal->fd))) {
+        rc = SR_ERR_IO;
+    }
+    CHECK_RC_LOG_RETURN(rc, "Failed to truncate the journal %s: %s", journal->file_name, sr_strerror_safe(errno));
+
+    dm_journal_index_reset(journal, base_seq);
+    *seq = base_seq;
+    SR_LOG_DBG("Journal %s truncated at sequence number %"PRIu64, journal->file_name, base_seq);
+    return rc;
+}
+
+size_t
+dm_journal_size(dm_journal_t *journal)
+{
+    struct stat st = {0};
+    int ret = 0;
+
+    if (NULL == journal) {
+        return 0;
+    }
+    /* the journal might have been created by another process */
+    ret = (-1 != journal->fd) ? fstat(journal->fd, &st) : stat(journal->file_name, &st);
+    if (-1 == ret || st.st_size <= (off_t) DM_JOURNAL_HEADER_SIZE) {
+        return 0;
+    }
+    return st.st_size - DM_JOURNAL_HEADER_SIZE;
+}
+
+int
+dm_journal_batch_new(dm_journal_batch_t **batch)
+{
+    CHECK_NULL_ARG(batch);
+
+    *batch = calloc(1, sizeof(**batch));
+    CHECK_NULL_NOMEM_RETURN(*batch);
+    return SR_ERR_OK;
+}
+
+void
+dm_journal_batch_free(dm_journal_batch_t *batch)
+{
+    if (NULL != batch) {
+        free(batch->data);
+        free(batch);
+    }
+}
+
+size_t
+dm_journal_batch_count(const dm_journal_batch_t *batch)
+{
+    return NULL != batch ? batch->count : 0;
+}
+
+static int
+dm_journal_batch_write(dm_journal_batch_t *batch, const void *data, size_t len)
+{
+    char *tmp = NULL;
+    size_t new_size = 0;
+
+    if (batch->used + len > batch->size) {
+        new_size = batch->size ? batch->size : 1024;
+        while (batch->used + len > new_size) {
+            new_size *= 2;
+        }
+        tmp = realloc(batch->data, new_size);
+        CHECK_NULL_NOMEM_RETURN(tmp);
+        batch->data = tmp;
+        batch->size = new_size;
+    }
+    memcpy(batch->data + batch->used, data, len);
+    batch->used += len;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Starts a new record in the batch, the frame and the sequence number are left blank.
+ */
+static int
+dm_journal_batch_start_record(dm_journal_batch_t *batch, uint8_t kind)
+{
+    char blank[DM_JOURNAL_FRAME_SIZE + sizeof(uint64_t)] = {0};
+    int rc = SR_ERR_OK;
+
+    rc = dm_journal_batch_write(batch, blank, sizeof(blank));
+    if (SR_ERR_OK == rc) {
+        rc = dm_journal_batch_write(batch, &kind, sizeof(kind));
+    }
+    return rc;
+}
+
+/**
+ * @brief Finishes the record started at the offset, fills in its length.
+ */
+static int
+dm_journal_batch_end_record(dm_journal_batch_t *batch, size_t start)
+{
+    size_t len = batch->used - start - DM_JOURNAL_FRAME_SIZE;
+    uint32_t len32 = len;
+
+    if (len > UINT32_MAX) {
+        return SR_ERR_INVAL_ARG;
+    }
+    memcpy(batch->data + start, &len32, sizeof(len32));
+    batch->count++;
+    return SR_ERR_OK;
+}
+
+static int
+dm_journal_batch_add_op(dm_journal_batch_t *batch, uint8_t op, const char *path, const char *value)
+{
+    uint32_t path_len = strlen(path);
+    uint32_t value_len = NULL != value ? strlen(value) : DM_JOURNAL_NO_VALUE;
+    int rc = SR_ERR_OK;
+
+    rc = dm_journal_batch_write(batch, &op, sizeof(op));
+    if (SR_ERR_OK == rc) {
+        rc = dm_journal_batch_write(batch, &path_len, sizeof(path_len));
+    }
+    if (SR_ERR_OK == rc) {
+        rc = dm_journal_batch_write(batch, path, path_len);
+    }
+    if (SR_ERR_OK == rc) {
+        rc = dm_journal_batch_write(batch, &value_len, sizeof(value_len));
+    }
+    if (SR_ERR_OK == rc && NULL != value) {
+        rc = dm_journal_batch_write(batch, value, value_len);
+    }
+    return rc;
+}
+
+/**
+ * @brief Adds an operation for the node, for leaves and leaf-lists the value is included.
+ */
+static int
+dm_journal_batch_add_node(dm_journal_batch_t *batch, uint8_t op, const struct lyd_node *node)
+{
+    char *path = NULL;
+    int rc = SR_ERR_OK;
+
+    path = lyd_path((struct lyd_node *) node);
+    CHECK_NULL_NOMEM_RETURN(path);
+    rc = dm_journal_batch_add_op(batch, op, path, (DM_JOURNAL_OP_SET == op && ((LYS_LEAF | LYS_LEAFLIST) & node->schema->nodetype)) ?
+            ((struct lyd_node_leaf_list *) node)->value_str : NULL);
+    free(path);
+    return rc;
+}
+
+/**
+ * @brief Returns true if the node is a key of its parent list instance.
+ */
+static bool
+dm_journal_is_list_key(const struct lyd_node *node)
+{
+    const struct lys_node_list *list = NULL;
+
+    if (NULL == node->parent || LYS_LIST != node->parent->schema->nodetype) {
+        return false;
+    }
+    list = (const struct lys_node_list *) node->parent->schema;
+    for (size_t k = 0; k < list->keys_size; k++) {
+        if ((const struct lys_node *) list->keys[k] == node->schema) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Adds set operations for all explicit nodes of the created subtree.
+ */
+static int
+dm_journal_batch_add_subtree(dm_journal_batch_t *batch, const struct lyd_node *subtree)
+{
+    struct lyd_node *next = NULL, *iter = NULL;
+    int rc = SR_ERR_OK;
+
+    LY_TREE_DFS_BEGIN((struct lyd_node *) subtree, next, iter) {
+        if (!iter->dflt && !dm_journal_is_list_key(iter)) {
+            if (!((LYS_CONTAINER | LYS_LIST | LYS_LEAF | LYS_LEAFLIST) & iter->schema->nodetype)) {
+                SR_LOG_DBG("Node %s can not be journaled", iter->schema->name);
+                return SR_ERR_UNSUPPORTED;
+            }
+            rc = dm_journal_batch_add_node(batch, DM_JOURNAL_OP_SET, iter);
+            CHECK_RC_MSG_RETURN(rc, "Failed to add journal operation");
+        }
+        LYD_TREE_DFS_END(subtree, next, iter);
+    }
+    return rc;
+}
+
+/**
+ * @brief Returns true if the data node belongs to the data tree of the module.
+ */
+static bool
+dm_journal_node_in_module(const struct lyd_node *node, const struct lys_module *module)
+{
+    while (NULL != node->parent) {
+        node = node->parent;
+    }
+    return module == lys_node_module(node->schema);
+}
+
+int
+dm_journal_batch_add_diff(dm_journal_batch_t *batch, const struct lys_module *module, struct lyd_difflist *diff)
+{
+    CHECK_NULL_ARG4(batch, module, module->name, diff);
+    size_t start = batch->used;
+    size_t ops = 0;
+    int rc = SR_ERR_OK;
+
+    rc = dm_journal_batch_start_record(batch, DM_JOURNAL_RECORD_CHANGES);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to start journal record");
+
+    for (size_t d = 0; LYD_DIFF_END != diff->type[d]; d++) {
+        switch (diff->type[d]) {
+        case LYD_DIFF_DELETED:
+            if (dm_journal_node_in_module(diff->first[d], module)) {
+                rc = dm_journal_batch_add_node(batch, DM_JOURNAL_OP_DELETE, diff->first[d]);
+            }
+            break;
+        case LYD_DIFF_CHANGED:
+            if (dm_journal_node_in_module(diff->second[d], module)) {
+                rc = dm_journal_batch_add_node(batch, DM_JOURNAL_OP_SET, diff->second[d]);
+            }
+            break;
+        case LYD_DIFF_CREATED:
+            if (dm_journal_node_in_module(diff->second[d], module)) {
+                rc = dm_journal_batch_add_subtree(batch, diff->second[d]);
+            }
+            break;
+        default:
+            /* order of user-ordered lists is not journaled */
+            SR_LOG_DBG("Move in module %s can not be journaled", module->name);
+            rc = SR_ERR_UNSUPPORTED;
+            break;
+        }
+        if (SR_ERR_OK != rc) {
+            goto cleanup;
+        }
+        ops++;
+    }
+
+    if (0 == ops) {
+        /* nothing to record */
+        batch->used = start;
+        return SR_ERR_OK;
+    }
+    rc = dm_journal_batch_end_record(batch, start);
+
+cleanup:
+    if (SR_ERR_OK != rc) {
+        /* drop the partial record */
+        batch->used = start;
+    } else {
+        SR_LOG_DBG("Journal record with %zu change(s) of module %s prepared", ops, module->name);
+    }
+    return rc;
+}
+
+int
+dm_journal_batch_add_image(dm_journal_batch_t *batch, const struct lyd_node *root)
+{
+    CHECK_NULL_ARG(batch);
+    size_t start = batch->used;
+    char *data = NULL;
+    int rc = SR_ERR_OK;
+
+    rc = dm_journal_batch_start_record(batch, DM_JOURNAL_RECORD_IMAGE);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to start journal record");
+
+    if (NULL != root) {
+        ly_errno = LY_SUCCESS;
+        if (0 != lyd_print_mem(&data, root, LYD_XML, LYP_WITHSIBLINGS)) {
+            SR_LOG_ERR("Printing of the journal image failed: %s", ly_errmsg());
+            rc = SR_ERR_INTERNAL;
+            goto cleanup;
+        }
+        if (NULL != data) {
+            rc = dm_journal_batch_write(batch, data, strlen(data));
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to add journal image");
+        }
+    }
+    rc = dm_journal_batch_end_record(batch, start);
+
+cleanup:
+    if (SR_ERR_OK != rc) {
+        batch->used = start;
+    }
+    free(data);
+    return rc;
+}
+
+int
+dm_journal_append(dm_journal_t *journal, dm_journal_batch_t *batch, uint64_t *first_seq)
+{
+    CHECK_NULL_ARG3(journal, batch, first_seq);
+    struct stat st = {0};
+    uint32_t len = 0, checksum = 0;
+    uint64_t seq = 0;
+    size_t pos = 0;
+    int rc = SR_ERR_OK;
+
+    if (0 == batch->count) {
+        return SR_ERR_OK;
+    }
+
+    rc = dm_journal_lock(journal, true);
+    CHECK_RC_MSG_RETURN(rc, "Failed to lock the journal");
+
+    if (0 == fstat(journal->fd, &st) && st.st_size > journal->indexed_size) {
+        SR_LOG_WRN("Dropping incomplete record at the end of the journal %s", journal->file_name);
+        if (0 != ftruncate(journal->fd, journal->indexed_size)) {
+            SR_LOG_ERR("Failed to truncate the journal %s: %s", journal->file_name, sr_strerror_safe(errno));
+            rc = SR_ERR_IO;
+            goto cleanup;
+        }
+    }
+
+    /* assign sequence numbers and checksums */
+    seq = journal->last_seq + 1;
+    *first_seq = seq;
+    while (pos < batch->used) {
+        memcpy(&len, batch->data + pos, sizeof(len));
+        memcpy(batch->data + pos + DM_JOURNAL_FRAME_SIZE, &seq, sizeof(seq));
+        checksum = dm_journal_checksum(batch->data + pos + DM_JOURNAL_FRAME_SIZE, len);
+        memcpy(batch->data + pos + sizeof(len), &checksum, sizeof(checksum));
+        pos += DM_JOURNAL_FRAME_SIZE + len;
+        seq++;
+    }
+
+    rc = dm_journal_pwrite(journal->fd, batch->data, batch->used, journal->indexed_size);
+    if (SR_ERR_OK == rc && 0 != fsync(journal->fd)) {
+        SR_LOG_ERR("Failed to sync the journal %s: %s", journal->file_name, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+    }
+    if (SR_ERR_OK != rc) {
+        /* the records must not be considered committed */
+        if (0 != ftruncate(journal->fd, journal->indexed_size)) {
+            SR_LOG_WRN("Failed to drop unsynced records from the journal %s", journal->file_name);
+        }
+        goto cleanup;
+    }
+
+    rc = dm_journal_refresh(journal);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to index appended journal records");
+    if (journal->last_seq != seq - 1) {
+        SR_LOG_ERR("Appended records not found in the journal %s", journal->file_name);
+        rc = SR_ERR_INTERNAL;
+        goto cleanup;
+    }
+    SR_LOG_DBG("%zu record(s) appended to the journal %s, last sequence number %"PRIu64,
+            batch->count, journal->file_name, journal->last_seq);
+
+cleanup:
+    dm_journal_unlock(journal);
+    return rc;
+}
@@ -0,0 +1,193 @@
+/**
+ * @defgroup dm_journal Commit journal
+ * @ingroup dm
+ * @{
+ * @brief Write-ahead journal of the changes committed into the modules of a datastore.
+ * @file dm_journal.h
+ * @author agent <agent@local>
+ *
+ * @copyright
+ * Copyright 2026 agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DM_JOURNAL_H_
+#define DM_JOURNAL_H_
+
+#include <libyang/libyang.h>
+
+#include "sr_common.h"
+
+/**
+ * @brief Journal of one module in one datastore. Instead of rewriting the whole data file of the module,
+ * a commit appends a record with the changes of the module to the journal. Content of the module is given
+ * by its data file with the journal records applied on top of it. A record can also hold the complete content
+ * of the module (image), the data file and the records preceding the last image are not used then.
+ *
+ * Each record has a sequence number, the sequence number of the last record identifies the content
+ * of the module (see ::dm_journal_get_seq). Records are periodically folded into the data file (checkpoint):
+ * an image is appended first, then the data file is rewritten and the journal is truncated, so that
+ * an interrupted checkpoint never replays the records on the rewritten data file. Sequence numbers keep
+ * growing across checkpoints.
+ *
+ * The journal file is created next to the data file with the same owner and permissions.
+ * Access to the journal is serialized by a mutex inside of the process and by a file lock
+ * between the processes.
+ */
+typedef struct dm_journal_s dm_journal_t;
+
+/**
+ * @brief Set of journal records prepared to be appended by one commit.
+ */
+typedef struct dm_journal_batch_s dm_journal_batch_t;
+
+/**
+ * @brief Allocates the journal of the module. The journal file is not created until the first record
+ * is appended.
+ * @param [in] data_search_dir Location of the data files.
+ * @param [in] module_name Module of the journal.
+ * @param [in] ds Datastore of the journal.
+ * @param [out] journal Allocated journal.
+ * @return Error code (SR_ERR_OK on success).
+ */
+int dm_journal_init(const char *data_search_dir, const char *module_name, sr_datastore_t ds, dm_journal_t **journal);
+
+/**
+ * @brief Closes the journal and frees all the resources held by it.
+ * @param [in] journal
+ */
+void dm_journal_cleanup(dm_journal_t *journal);
+
+/**
+ * @brief Locks the journal. The lock is recursive within a thread, a thread holding
+ * the write lock can acquire the lock again for both reading and writing.
+ * @param [in] journal
+ * @param [in] write Flag whether the write lock is requested, the journal file is created if it does not exist.
+ * @return Error code (SR_ERR_OK on success), SR_ERR_UNAUTHORIZED if the write lock is requested
+ * by a user not allowed to write the journal.
+ */
+int dm_journal_lock(dm_journal_t *journal, bool write);
+
+/**
+ * @brief Releases the lock acquired by ::dm_journal_lock.
+ * @param [in] journal
+ */
+void dm_journal_unlock(dm_journal_t *journal);
+
+/**
+ * @brief Returns the sequence number identifying the content of the module, i.e. the sequence number
+ * of the last record, or the sequence number of the last checkpoint if there is none.
+ * @note Expects that the data file of the module is locked, otherwise the returned value
+ * may be outdated immediately.
+ * @param [in] journal
+ * @param [out] seq
+ * @return Error code (SR_ERR_OK on success).
+ */
+int dm_journal_get_seq(dm_journal_t *journal, uint64_t *seq);
+
+/**
+ * @brief Returns the content of the last image record, the data file of the module must not be used
+ * if an image is found.
+ * @note Expects that the data file of the module is locked.
+ * @param [in] journal
+ * @param [out] image Data tree of the module in the XML format (to be freed by the caller), NULL if the journal
+ * contains no image. Empty string denotes an empty data tree.
+ * @return Error code (SR_ERR_OK on success).
+ */
+int dm_journal_get_image(dm_journal_t *journal, char **image);
+
+/**
+ * @brief Applies the change records following the last image on the data tree loaded from the data file
+ * (or from the image returned by ::dm_journal_get_image).
+ * @note Expects that the data file of the module is locked.
+ * @param [in] journal
+ * @param [in] ly_ctx Context of the data tree.
+ * @param [in,out] root Data tree of the module, can be NULL or replaced.
+ * @param [out] seq Sequence number identifying the resulting content (see ::dm_journal_get_seq).
+ * @return Error code (SR_ERR_OK on success).
+ */
+int dm_journal_replay(dm_journal_t *journal, struct ly_ctx *ly_ctx, struct lyd_node **root, uint64_t *seq);
+
+/**
+ * @brief Removes all records from the journal, called once the content of the module has been written
+ * into the data file.
+ * @note Expects that the journal is locked for writing.
+ * @param [in] journal
+ * @param [out] seq Sequence number identifying the content of the module after the checkpoint.
+ * @return Error code (SR_ERR_OK on success).
+ */
+int dm_journal_truncate(dm_journal_t *journal, uint64_t *seq);
+
+/**
+ * @brief Returns the size of the records in the journal file in bytes.
+ * @param [in] journal
+ * @return Size of the records, 0 if the journal contains no records or does not exist.
+ */
+size_t dm_journal_size(dm_journal_t *journal);
+
+/**
+ * @brief Allocates an empty batch of records.
+ * @param [out] batch
+ * @return Error code (SR_ERR_OK on success).
+ */
+int dm_journal_batch_new(dm_journal_batch_t **batch);
+
+/**
+ * @brief Frees the batch.
+ * @param [in] batch
+ */
+void dm_journal_batch_free(dm_journal_batch_t *batch);
+
+/**
+ * @brief Adds a record with the changes of the module to the batch. The changes are converted
+ * into a sequence of create/update and delete operations identified by paths.
+ * @param [in] batch
+ * @param [in] module Module the changes belong to, changes in data trees of other modules are ignored.
+ * @param [in] diff Changes made by the commit.
+ * @return Error code (SR_ERR_OK on success), SR_ERR_UNSUPPORTED if the changes can not be journaled
+ * (e.g. moves in user-ordered lists or anydata), nothing is added to the batch in such case. No record
+ * is added if there are no changes in the module.
+ */
+int dm_journal_batch_add_diff(dm_journal_batch_t *batch, const struct lys_module *module, struct lyd_difflist *diff);
+
+/**
+ * @brief Adds a record with the complete content of the module, the preceding records and the data file
+ * are not used once the record is appended.
+ * @param [in] batch
+ * @param [in] root Data tree of the module, can be NULL.
+ * @return Error code (SR_ERR_OK on success).
+ */
+int dm_journal_batch_add_image(dm_journal_batch_t *batch, const struct lyd_node *root);
+
+/**
+ * @brief Returns the number of records in the batch.
+ * @param [in] batch
+ * @return Number of records.
+ */
+size_t dm_journal_batch_count(const dm_journal_batch_t *batch);
+
+/**
+ * @brief Appends all records of the batch to the journal and makes them durable with a single fsync.
+ * Records are assigned consecutive sequence numbers in the order they were added to the batch.
+ * @note Expects that the data file of the module is locked for writing.
+ * @param [in] journal
+ * @param [in] batch
+ * @param [out] first_seq Sequence number assigned to the first record of the batch.
+ * @return Error code (SR_ERR_OK on success).
+ */
+int dm_journal_append(dm_journal_t *journal, dm_journal_batch_t *batch, uint64_t *first_seq);
+
+/**@} dm_journal */
+
+#endif /* DM_JOURNAL_H_ */
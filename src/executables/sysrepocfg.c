@@ -394,254 +394,6 @@ cleanup:
     return SR_ERR_OK;
 }
 
-/**
- * @brief Convert data tree difference of type LYD_DIFF_CHANGED to corresponding set of Sysrepo public API calls.
- */
-static int
-srcfg_convert_lydiff_changed(const char *xpath, struct lyd_node *node)
-{
-    int rc = SR_ERR_INTERNAL;
-    sr_val_t value = { 0, 0, SR_UNKNOWN_T };
-    struct lyd_node_leaf_list *data_leaf = NULL;
-    struct lyd_node_anydata *sch_any = NULL;
-
-    CHECK_NULL_ARG2(xpath, node);
-
-    switch (node->schema->nodetype) {
-        case LYS_LEAF:
-        case LYS_LEAFLIST:
-            data_leaf = (struct lyd_node_leaf_list *) node;
-            value.type = sr_libyang_leaf_get_type(data_leaf);
-            rc = sr_libyang_leaf_copy_value(data_leaf, &value);
-            if (SR_ERR_OK != rc) {
-                SR_LOG_ERR("Error returned from sr_libyang_leaf_copy_value: %s.", sr_strerror(rc));
-                goto cleanup;
-            }
-            break;
-        case LYS_ANYXML:
-        case LYS_ANYDATA:
-            sch_any = (struct lyd_node_anydata *) node;
-            if (NULL == sch_any->value.str) {
-                /* skip empty anydata / anyxml */
-                rc = SR_ERR_OK;
-                goto cleanup;
-            }
-            value.type = (LYS_ANYXML == node->schema->nodetype) ? SR_ANYXML_T : SR_ANYDATA_T;
-            rc = sr_libyang_anydata_copy_value(sch_any, &value);
-            CHECK_RC_LOG_GOTO(rc, cleanup, "Error returned from sr_libyang_anydata_copy_value: %s.", sr_strerror(rc));
-            break;
-        default:
-            SR_LOG_ERR_MSG("Unexpected node type for LYD_DIFF_CHANGED.");
-            goto cleanup;
-    }
-    rc = sr_set_item(srcfg_session, xpath, &value, SR_EDIT_NON_RECURSIVE);
-    if (SR_ERR_OK != rc) {
-        SR_LOG_ERR("Error returned from sr_set_item: %s.", sr_strerror(rc));
-    }
-
-cleanup:
-    sr_free_val_content(&value);
-    return rc;
-}
-
-/**
- * @brief Convert data tree difference of type LYD_DIFF_DELETED to corresponding set of Sysrepo public API calls.
- */
-static int
-srcfg_convert_lydiff_deleted(const char *xpath)
-{
-    CHECK_NULL_ARG(xpath);
-    int rc = sr_delete_item(srcfg_session, xpath, SR_EDIT_STRICT);
-    if (SR_ERR_OK != rc) {
-        SR_LOG_ERR("Error returned from sr_delete_item: %s.", sr_strerror(rc));
-    }
-    return rc;
-}
-
-/**
- * @brief Convert data tree difference of type LYD_DIFF_CREATED to corresponding set of Sysrepo public API calls.
- */
-static int
-srcfg_convert_lydiff_created(struct lyd_node *node)
-{
-    int rc = SR_ERR_INTERNAL;
-    struct lyd_node *elem = node;
-    bool process_children = true;
-    sr_val_t value = { 0, 0, SR_UNKNOWN_T };
-    struct lyd_node_leaf_list *data_leaf = NULL;
-    struct lys_node_list *slist = NULL;
-    struct lyd_node_anydata *sch_any = NULL;
-    char *xpath = NULL, *delim = NULL;
-
-    CHECK_NULL_ARG(node);
-
-    /* non-recursive DFS post-order */
-    do {
-        /* go as deep as possible */
-        if (process_children) {
-            while (!(elem->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYXML)) && elem->child) {
-                elem = elem->child;
-            }
-        }
-
-        /* skip implicitly added default nodes */
-        if (elem->dflt) {
-            SR_LOG_DBG("Skipping default node '%s'.", elem->schema->name);
-            goto next_node;
-        }
-
-        /* get appropriate xpath and value */
-        free(xpath);
-        xpath = value.xpath = NULL;
-        value.type = SR_UNKNOWN_T;
-        value.data.uint64_val = 0;
-        switch (elem->schema->nodetype) {
-            case LYS_LEAF: /* e.g.: /test-module:user[name='nameE']/name */
-                /* get value */
-                data_leaf = (struct lyd_node_leaf_list *)elem;
-                value.type = sr_libyang_leaf_get_type(data_leaf);
-                rc = sr_libyang_leaf_copy_value(data_leaf, &value);
-                if (SR_ERR_OK != rc) {
-                    SR_LOG_ERR("Error returned from sr_libyang_leaf_copy_value: %s.", sr_strerror(rc));
-                    goto cleanup;
-                }
-                /* get xpath */
-                xpath = lyd_path(elem);
-                if (NULL == xpath) {
-                    SR_LOG_ERR("Error returned from lyd_path: %s.", ly_errmsg());
-                    goto cleanup;
-                }
-                /* key value of a list cannot be set directly */
-                if (elem->parent && (elem->parent->schema->nodetype == LYS_LIST)) {
-                    slist = (struct lys_node_list *)elem->parent->schema;
-                    for (unsigned i = 0; i < slist->keys_size; ++i) {
-                        if (slist->keys[i]->name == elem->schema->name) {
-                            /* key */
-                            if (i == 0) {
-                                delim = strrchr(xpath, '/');
-                                if (delim) {
-                                    *delim = '\0';
-                                }
-                                /* set type to SR_UNKNOWN_T in order to pass NULL to sr_set_item when a list is created */
-                                if (SR_UNKNOWN_T != value.type) {
-                                    sr_free_val_content(&value);
-                                    value.type = SR_UNKNOWN_T;
-                                }
-                                goto set_value;
-                            } else {
-                                /* create list instance (directly) only once - with the first key */
-                                goto next_node;
-                            }
-                        }
-                    }
-                }
-                break;
-
-            case LYS_LEAFLIST: /* e.g.: /test-module:main/numbers[.='10'] */
-                /* get value */
-                data_leaf = (struct lyd_node_leaf_list *)elem;
-                value.type = sr_libyang_leaf_get_type(data_leaf);
-                rc = sr_libyang_leaf_copy_value(data_leaf, &value);
-                if (SR_ERR_OK != rc) {
-                    SR_LOG_ERR("Error returned from sr_libyang_leaf_copy_value: %s.", sr_strerror(rc));
-                    goto cleanup;
-                }
-                /* get xpath */
-                xpath = lyd_path(elem);
-                if (NULL == xpath) {
-                    SR_LOG_ERR("Error returned from lyd_path: %s.", ly_errmsg());
-                    goto cleanup;
-                }
-                /* strip away the predicate */
-                delim = strrchr(xpath, '[');
-                if (delim) {
-                    *delim = '\0';
-                }
-                break;
-
-            case LYS_ANYXML:
-            case LYS_ANYDATA:
-                sch_any = (struct lyd_node_anydata *) elem;
-                value.type = (LYS_ANYXML == node->schema->nodetype) ? SR_ANYXML_T : SR_ANYDATA_T;
-                rc = sr_libyang_anydata_copy_value(sch_any, &value);
-                CHECK_RC_LOG_GOTO(rc, cleanup, "Error returned from sr_libyang_anydata_copy_value: %s.", sr_strerror(rc));
-                /* get xpath */
-                xpath = lyd_path(elem);
-                if (NULL == xpath) {
-                    SR_LOG_ERR("Error returned from lyd_path: %s.", ly_errmsg());
-                    goto cleanup;
-                }
-                break;
-
-            case LYS_CONTAINER:
-                /* explicitly create only presence containers */
-                if (((struct lys_node_container *)elem->schema)->presence) {
-                    xpath = lyd_path(elem);
-                } else {
-                    goto next_node;
-                }
-                break;
-
-            default:
-                /* no data to set */
-                goto next_node;
-        }
-
-set_value:
-        /* set value */
-        rc = sr_set_item(srcfg_session, xpath, SR_UNKNOWN_T != value.type ? &value : NULL, SR_EDIT_DEFAULT);
-        if (SR_ERR_OK != rc) {
-            SR_LOG_ERR("Error returned from sr_set_item: %s.", sr_strerror(rc));
-            goto cleanup;
-        }
-        if (SR_UNKNOWN_T != value.type) {
-            sr_free_val_content(&value);
-            value.type = SR_UNKNOWN_T;
-        }
-
-next_node:
-        /* backtracking + automatically moving to the next sibling if there is any */
-        if (elem != node) {
-            if (elem->next) {
-                elem = elem->next;
-                process_children = true;
-            } else {
-                assert(elem->parent);
-                elem = elem->parent;
-                process_children = false;
-            }
-        } else {
-            break;
-        }
-    } while (true);
-
-    rc = SR_ERR_OK;
-
-cleanup:
-    if (NULL != xpath) {
-        free(xpath);
-    }
-    if (SR_UNKNOWN_T != value.type) {
-        sr_free_val_content(&value);
-    }
-    return rc;
-}
-
-/**
- * @brief Convert data tree difference of type LYD_DIFF_MOVEDAFTER1 or LYD_DIFF_MOVEDAFTER2 to corresponding
- * set of Sysrepo public API calls.
- */
-static int
-srcfg_convert_lydiff_movedafter(const char *target_xpath, const char *after_xpath)
-{
-    CHECK_NULL_ARG(target_xpath);
-    int rc = sr_move_item(srcfg_session, target_xpath, after_xpath ? SR_MOVE_AFTER : SR_MOVE_FIRST, after_xpath);
-    if (SR_ERR_OK != rc) {
-        SR_LOG_ERR("Error returned from sr_move_item: %s.", sr_strerror(rc));
-    }
-    return rc;
-}
-
 /**
  * @brief Import content of the specified datastore for the given module from a file
  * referenced by the descriptor 'fd_in'
@@ -651,13 +403,11 @@ srcfg_import_datastore(struct ly_ctx *ly_ctx, int fd_in, md_module_t *module, sr
                        LYD_FORMAT format, bool permanent)
 {
     int rc = SR_ERR_INTERNAL;
-    unsigned i = 0;
     struct lyd_node *new_dt = NULL;
-    struct lyd_node *current_dt = NULL;
     struct lyd_node *deps_dt = NULL;
-    struct lyd_difflist *diff = NULL;
-    char *first_xpath = NULL, *second_xpath = NULL;
+    struct lyd_node *node = NULL, *next = NULL;
     char *input_data = NULL;
+    char *import_data = NULL;
     int ret = 0;
     struct stat info;
 
@@ -702,116 +452,59 @@ srcfg_import_datastore(struct ly_ctx *ly_ctx, int fd_in, md_module_t *module, sr
     CHECK_ZERO_LOG_GOTO(ret, rc, SR_ERR_INTERNAL, cleanup, "Input data are not valid: %s (%s)",
                         ly_errmsg(), ly_errpath());
 
-    /* get data tree of currently stored configuration and validate it */
-    rc = srcfg_get_module_data(ly_ctx, module, &current_dt);
-    if (SR_ERR_OK == rc) {
-        rc = srcfg_merge_data_trees(&current_dt, deps_dt);
-    }
-    if (SR_ERR_OK == rc) {
-        ret = lyd_validate(&current_dt, LYD_OPT_STRICT | LYD_OPT_CONFIG, ly_ctx);
-        CHECK_ZERO_LOG_GOTO(ret, rc, SR_ERR_INTERNAL, cleanup, "Data returned by sysrepo are not valid: %s (%s)",
-                            ly_errmsg(), ly_errpath());
-    } else {
-        goto cleanup;
+    /* keep only the data of the imported module */
+    LY_TREE_FOR_SAFE(new_dt, next, node) {
+        if (0 != strcmp(lyd_node_module(node)->name, module->name)) {
+            if (node == new_dt) {
+                new_dt = next;
+            }
+            lyd_free(node);
+        }
     }
 
-    /* get the list of changes made by the user */
-    diff = lyd_diff(current_dt, new_dt, LYD_DIFFOPT_WITHDEFAULTS);
-    if (NULL == diff) {
-        SR_LOG_ERR("Unable to get the list of changes: %s", ly_errmsg());
+    /* serialize the data and import them into the datastore within a single request */
+    if (NULL != new_dt) {
+        ret = lyd_print_mem(&import_data, new_dt, LYD_XML, LYP_WITHSIBLINGS);
+        CHECK_ZERO_LOG_GOTO(ret, rc, SR_ERR_INTERNAL, cleanup, "Unable to print the input data: %s", ly_errmsg());
+    }
+    rc = sr_import_data(srcfg_session, module->name, NULL != import_data ? import_data : "", SR_DATA_XML,
+            SR_IMPORT_REPLACE);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Error returned from sr_import_data: %s.", sr_strerror(rc));
         goto cleanup;
     }
 
-    /* iterate over the list of differences and for each issue corresponding Sysrepo command(s) */
-    while (diff->type && LYD_DIFF_END != diff->type[i]) {
-        if (NULL != diff->first[i]) {
-            first_xpath = lyd_path(diff->first[i]);
-            if (NULL == first_xpath) {
-                SR_LOG_ERR("Error returned from lyd_path: %s.", ly_errmsg());
-                goto cleanup;
-            }
-        }
-        if (NULL != diff->second[i]) {
-            second_xpath = lyd_path(diff->second[i]);
-            if (NULL == second_xpath) {
-                free(first_xpath);
-                first_xpath = NULL;
-                SR_LOG_ERR("Error returned from lyd_path: %s.", ly_errmsg());
-                goto cleanup;
-            }
-        }
-        switch (diff->type[i]) {
-            case LYD_DIFF_DELETED:
-                SR_LOG_DBG("<LYD_DIFF_DELETED> node: %s", first_xpath);
-                rc = srcfg_convert_lydiff_deleted(first_xpath);
-                break;
-            case LYD_DIFF_CHANGED:
-                SR_LOG_DBG("<LYD_DIFF_CHANGED> orig: %s, new: %s", first_xpath, second_xpath);
-                rc = srcfg_convert_lydiff_changed(first_xpath, diff->second[i]);
-                break;
-            case LYD_DIFF_MOVEDAFTER1:
-                SR_LOG_DBG("<LYD_DIFF_MOVEDAFTER1> moved: %s, after: %s", first_xpath, second_xpath);
-                rc = srcfg_convert_lydiff_movedafter(first_xpath, second_xpath);
-                break;
-            case LYD_DIFF_CREATED:
-                SR_LOG_DBG("<LYD_DIFF_CREATED> parent: %s, new node: %s", first_xpath, second_xpath);
-                rc = srcfg_convert_lydiff_created(diff->second[i]);
-                break;
-            case LYD_DIFF_MOVEDAFTER2:
-                SR_LOG_DBG("<LYD_DIFF_MOVEDAFTER2> after: %s, this new node was inserted: %s", first_xpath, second_xpath);
-                rc = srcfg_convert_lydiff_movedafter(second_xpath, first_xpath);
-                break;
-            default:
-                assert(0 && "not reachable");
-        }
-        free(first_xpath);
-        free(second_xpath);
-        first_xpath = second_xpath = NULL;
-        if (SR_ERR_OK != rc) {
-            goto cleanup;
+    /* commit the changes */
+    rc = sr_commit(srcfg_session);
+    if (SR_ERR_OK != rc) {
+        const sr_error_info_t *err = NULL;
+        size_t err_cnt = 0;
+        SR_LOG_ERR("Error returned from sr_commit: %s.", sr_strerror(rc));
+        sr_get_last_errors(srcfg_session, &err, &err_cnt);
+        for (size_t j = 0; j < err_cnt; j++) {
+            SR_LOG_ERR("%s : %s", err[j].xpath, err[j].message);
         }
-        ++i;
+        goto cleanup;
     }
-    if (0 == i) {
-        SR_LOG_DBG_MSG("No changes were made.");
-    } else {
-        /* commit the changes */
-        rc = sr_commit(srcfg_session);
+    if (SRCFG_STORE_RUNNING == datastore && permanent) {
+        /* copy running datastore data into the startup datastore */
+        rc = sr_copy_config(srcfg_session, module->name, SR_DS_RUNNING, SR_DS_STARTUP);
         if (SR_ERR_OK != rc) {
-            const sr_error_info_t *err = NULL;
-            size_t err_cnt = 0;
-            SR_LOG_ERR("Error returned from sr_commit: %s.", sr_strerror(rc));
-            sr_get_last_errors(srcfg_session, &err, &err_cnt);
-            for (size_t j = 0; j < err_cnt; j++) {
-                SR_LOG_ERR("%s : %s", err[j].xpath, err[j].message);
-            }
+            SR_LOG_ERR("Error returned from sr_copy_config: %s.", sr_strerror(rc));
             goto cleanup;
         }
-        if (SRCFG_STORE_RUNNING == datastore && permanent) {
-            /* copy running datastore data into the startup datastore */
-            rc = sr_copy_config(srcfg_session, module->name, SR_DS_RUNNING, SR_DS_STARTUP);
-            if (SR_ERR_OK != rc) {
-                SR_LOG_ERR("Error returned from sr_copy_config: %s.", sr_strerror(rc));
-                goto cleanup;
-            }
-        }
     }
 
     rc = SR_ERR_OK;
 
 cleanup:
-    if (NULL != diff) {
-        lyd_free_diff(diff);
-    }
     if (NULL != deps_dt) {
         lyd_free_withsiblings(deps_dt);
     }
-    if (NULL != current_dt) {
-        lyd_free_withsiblings(current_dt);
-    }
     if (NULL != new_dt) {
         lyd_free_withsiblings(new_dt);
     }
+    free(import_data);
     if (input_data) {
         free(input_data);
     }
@@ -63,7 +63,7 @@ srd_print_help()
     srd_print_version();
 
     printf("Usage:\n");
-    printf("  sysrepod [-h] [-v] [-d] [-l <level>]\n\n");
+    printf("  sysrepod [-h] [-v] [-d] [-l <level>] [-t <count>] [-i <count>]\n\n");
     printf("Options:\n");
     printf("  -h\t\tPrints usage help.\n");
     printf("  -v\t\tPrints version.\n");
@@ -74,6 +74,8 @@ srd_print_help()
     printf("\t\t\t2 = (default) log error and warning messages\n");
     printf("\t\t\t3 = log error, warning and informational messages\n");
     printf("\t\t\t4 = log everything, including development debug messages\n");
+    printf("  -t <count>\tSets the number of request processing threads (overrides %s).\n", SR_RP_THREAD_COUNT_ENV);
+    printf("  -i <count>\tSets the number of connection I/O threads (overrides %s).\n", SR_CM_IO_LOOP_COUNT_ENV);
 }
 
 /**
@@ -90,7 +92,7 @@ main(int argc, char* argv[])
     int log_level = -1;
     int rc = SR_ERR_OK;
 
-    while ((c = getopt (argc, argv, "hvdl:")) != -1) {
+    while ((c = getopt (argc, argv, "hvdl:t:i:")) != -1) {
         switch (c) {
             case 'v':
                 srd_print_version();
@@ -102,6 +104,14 @@ main(int argc, char* argv[])
             case 'l':
                 log_level = atoi(optarg);
                 break;
+            case 't':
+                /* picked up by the Request Processor during its initialization */
+                setenv(SR_RP_THREAD_COUNT_ENV, optarg, 1);
+                break;
+            case 'i':
+                /* picked up by the Connection Manager during its initialization */
+                setenv(SR_CM_IO_LOOP_COUNT_ENV, optarg, 1);
+                break;
             default:
                 srd_print_help();
                 return 0;
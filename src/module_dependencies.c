@@ -23,6 +23,7 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdarg.h>
@@ -34,6 +35,12 @@
 #define MD_MODULE_NAME      "sysrepo-module-dependencies"
 #define MD_SCHEMA_FILENAME  MD_MODULE_NAME ".yang"
 #define MD_DATA_FILENAME    MD_MODULE_NAME ".xml"
+#define MD_CACHE_FILENAME   MD_MODULE_NAME ".cache"
+
+/* Header of the cache of the internal data file */
+#define MD_CACHE_MAGIC      "SRMD"
+#define MD_CACHE_MAGIC_LEN  4
+#define MD_CACHE_VERSION    1    /* to be incremented with each change of the format of the cache */
 
 /* A list of frequently used xpaths for the internal module with dependency info */
 #define MD_XPATH_MODULE                      "/sysrepo-module-dependencies:module[name='%s'][revision='%s']"
@@ -72,6 +79,281 @@ md_get_data_file_path(const char *internal_data_search_dir, char **file_path)
     return rc;
 }
 
+/**
+ * @brief Header of the cache of the internal data file. The cache contains the data tree
+ * with dependencies in the sysrepo binary format, so that it can be loaded without parsing XML,
+ * followed by the default flags of its nodes, which the binary format does not preserve.
+ */
+typedef struct md_cache_header_s {
+    char magic[MD_CACHE_MAGIC_LEN]; /**< MD_CACHE_MAGIC */
+    uint32_t version;               /**< MD_CACHE_VERSION of the cache */
+    uint64_t schema_hash;           /**< hash of the content of the internal schema file the data tree was created with */
+    uint64_t data_size;             /**< size of the internal data file the cache was created from */
+    uint64_t data_hash;             /**< hash of the content of the internal data file */
+    uint64_t tree_size;             /**< size of the data tree in the binary format following the header */
+    uint64_t node_count;            /**< number of the nodes of the data tree, their default flags follow the data tree
+                                         (one byte per node in the depth-first order) */
+} md_cache_header_t;
+
+/**
+ * @brief Computes FNV-1a hash of the content of an internal file, used to validate the cache.
+ *
+ * @param [in] fd File descriptor of the file.
+ * @param [in] file_name Name of the file for logging.
+ * @param [out] size Size of the file.
+ * @param [out] hash Hash of the content of the file.
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+md_file_hash(int fd, const char *file_name, uint64_t *size, uint64_t *hash)
+{
+    CHECK_NULL_ARG3(file_name, size, hash);
+    struct stat st = { 0, };
+    const unsigned char *addr = MAP_FAILED;
+    uint64_t h = 14695981039346656037ULL;
+
+    if (-1 == fstat(fd, &st)) {
+        SR_LOG_ERR("Unable to stat %s file: %s.", file_name, sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
+
+    if (st.st_size > 0) {
+        addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == addr) {
+            SR_LOG_ERR("Unable to map %s file: %s.", file_name, sr_strerror_safe(errno));
+            return SR_ERR_IO;
+        }
+        for (off_t i = 0; i < st.st_size; ++i) {
+            h ^= addr[i];
+            h *= 1099511628211ULL;
+        }
+        munmap((void *) addr, st.st_size);
+    }
+
+    *size = st.st_size;
+    *hash = h;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Walks the nodes of the data tree in the depth-first order, in which their default flags are stored
+ * in the cache. The flags are either recorded into or restored from the array.
+ *
+ * @param [in] data_tree Data tree with dependencies.
+ * @param [in,out] flags Default flags, one item per node. Can be NULL if the nodes are only counted.
+ * @param [in] restore Flag whether the default flags of the nodes are set from the array instead of being recorded.
+ * @return Number of the nodes of the data tree.
+ */
+static size_t
+md_cache_dflt_flags(struct lyd_node *data_tree, uint8_t *flags, bool restore)
+{
+    struct lyd_node *root = NULL, *next = NULL, *iter = NULL;
+    size_t count = 0;
+
+    LY_TREE_FOR(data_tree, root) {
+        LY_TREE_DFS_BEGIN(root, next, iter) {
+            if (NULL != flags) {
+                if (restore) {
+                    iter->dflt = flags[count] ? 1 : 0;
+                } else {
+                    flags[count] = iter->dflt ? 1 : 0;
+                }
+            }
+            count++;
+            LY_TREE_DFS_END(root, next, iter);
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Loads the data tree with dependencies from the cache of the internal data file.
+ * The cache is used only if it was created by the same version of the cache format from the current
+ * content of the internal schema and data files.
+ *
+ * @param [in] ly_ctx libyang context with the internal schema for dependencies.
+ * @param [in] cache_filepath Path to the cache.
+ * @param [in] schema_hash Hash of the content of the internal schema file.
+ * @param [in] data_size Size of the internal data file.
+ * @param [in] data_hash Hash of the content of the internal data file.
+ * @param [out] data_tree Loaded data tree, NULL if the data file contains no data. The tree is not validated,
+ * it was valid when the cache was stored and the header ties it to the same content of the data file.
+ * @return Error code (SR_ERR_OK on success), SR_ERR_NOT_FOUND if the cache is missing or outdated.
+ */
+static int
+md_load_cache(struct ly_ctx *ly_ctx, const char *cache_filepath, uint64_t schema_hash, uint64_t data_size,
+        uint64_t data_hash, struct lyd_node **data_tree)
+{
+    CHECK_NULL_ARG3(ly_ctx, cache_filepath, data_tree);
+    int rc = SR_ERR_OK, fd = -1;
+    struct stat st = { 0, };
+    void *addr = MAP_FAILED;
+    md_cache_header_t header = { { 0, }, };
+    struct lyd_node *tree = NULL;
+    const char *tree_data = NULL;
+
+    fd = open(cache_filepath, O_RDONLY);
+    if (-1 == fd) {
+        return SR_ERR_NOT_FOUND;
+    }
+
+    if (-1 == fstat(fd, &st) || (size_t) st.st_size < sizeof header) {
+        rc = SR_ERR_NOT_FOUND;
+        goto cleanup;
+    }
+
+    addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == addr) {
+        SR_LOG_WRN("Unable to map " MD_CACHE_FILENAME " file: %s.", sr_strerror_safe(errno));
+        rc = SR_ERR_NOT_FOUND;
+        goto cleanup;
+    }
+
+    memcpy(&header, addr, sizeof header);
+    if (0 != memcmp(header.magic, MD_CACHE_MAGIC, MD_CACHE_MAGIC_LEN) || MD_CACHE_VERSION != header.version ||
+        header.schema_hash != schema_hash || header.data_size != data_size || header.data_hash != data_hash ||
+        header.tree_size > (uint64_t) st.st_size - sizeof header ||
+        header.node_count != (uint64_t) st.st_size - sizeof header - header.tree_size) {
+        SR_LOG_DBG_MSG(MD_CACHE_FILENAME " is outdated, " MD_DATA_FILENAME " will be parsed.");
+        rc = SR_ERR_NOT_FOUND;
+        goto cleanup;
+    }
+
+    tree_data = (const char *) addr + sizeof header;
+    if (header.tree_size > 0) {
+        rc = sr_lyd_parse_binary_mem(ly_ctx, tree_data, header.tree_size, &tree);
+        if (SR_ERR_OK != rc || header.node_count != md_cache_dflt_flags(tree, NULL, false)) {
+            SR_LOG_WRN_MSG("Unable to load " MD_CACHE_FILENAME " file, " MD_DATA_FILENAME " will be parsed.");
+            rc = SR_ERR_NOT_FOUND;
+            goto cleanup;
+        }
+        /* the tree is printed back into the data file, default nodes must stay implicit */
+        md_cache_dflt_flags(tree, (uint8_t *) tree_data + header.tree_size, true);
+    }
+
+cleanup:
+    if (MAP_FAILED != addr) {
+        munmap(addr, st.st_size);
+    }
+    close(fd);
+    if (SR_ERR_OK == rc) {
+        *data_tree = tree;
+    } else {
+        lyd_free_withsiblings(tree);
+    }
+    return rc;
+}
+
+/**
+ * @brief Writes the whole buffer into the file.
+ */
+static int
+md_write_all(int fd, const void *buf, size_t len)
+{
+    const char *data = (const char *) buf;
+    ssize_t ret = 0;
+
+    while (len > 0) {
+        ret = write(fd, data, len);
+        if (-1 == ret) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return SR_ERR_IO;
+        }
+        data += ret;
+        len -= ret;
+    }
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Stores the data tree with dependencies into the cache of the internal data file.
+ * The cache is replaced atomically, failures are only logged since the cache is optional.
+ *
+ * @param [in] cache_filepath Path to the cache.
+ * @param [in] schema_hash Hash of the content of the internal schema file.
+ * @param [in] data_size Size of the internal data file.
+ * @param [in] data_hash Hash of the content of the internal data file.
+ * @param [in] data_tree Data tree loaded from the internal data file.
+ */
+static void
+md_store_cache(const char *cache_filepath, uint64_t schema_hash, uint64_t data_size, uint64_t data_hash,
+        const struct lyd_node *data_tree)
+{
+    int rc = SR_ERR_OK, fd = -1;
+    char *tmp_filepath = NULL;
+    md_cache_header_t header = { { 0, }, };
+    off_t offset = 0;
+    uint8_t *flags = NULL;
+    struct lyd_node *cache_tree = NULL, *root = NULL, *next = NULL, *iter = NULL;
+
+    rc = sr_asprintf(&tmp_filepath, "%s.XXXXXX", cache_filepath);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_WRN_MSG("Unable to create the path of temporary " MD_CACHE_FILENAME " file.");
+        return;
+    }
+
+    fd = mkstemp(tmp_filepath);
+    if (-1 == fd) {
+        SR_LOG_WRN("Unable to create temporary " MD_CACHE_FILENAME " file: %s.", sr_strerror_safe(errno));
+        free(tmp_filepath);
+        return;
+    }
+    fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    memcpy(header.magic, MD_CACHE_MAGIC, MD_CACHE_MAGIC_LEN);
+    header.version = MD_CACHE_VERSION;
+    header.schema_hash = schema_hash;
+    header.data_size = data_size;
+    header.data_hash = data_hash;
+
+    /* the header is completed once the data tree is written */
+    rc = md_write_all(fd, &header, sizeof header);
+
+    if (SR_ERR_OK == rc && NULL != data_tree) {
+        header.node_count = md_cache_dflt_flags((struct lyd_node *) data_tree, NULL, false);
+        flags = calloc(header.node_count, sizeof *flags);
+        /* the binary format skips default nodes, store them as explicit ones together with their default flags */
+        cache_tree = sr_dup_datatree((struct lyd_node *) data_tree);
+        if (NULL == flags || NULL == cache_tree) {
+            rc = SR_ERR_NOMEM;
+        } else {
+            md_cache_dflt_flags((struct lyd_node *) data_tree, flags, false);
+        }
+        LY_TREE_FOR(cache_tree, root) {
+            LY_TREE_DFS_BEGIN(root, next, iter) {
+                iter->dflt = 0;
+                LY_TREE_DFS_END(root, next, iter);
+            }
+        }
+        if (SR_ERR_OK == rc) {
+            rc = sr_lyd_print_binary_fd(fd, cache_tree);
+        }
+        if (SR_ERR_OK == rc) {
+            offset = lseek(fd, 0, SEEK_CUR);
+            rc = (-1 == offset) ? SR_ERR_IO : SR_ERR_OK;
+        }
+        if (SR_ERR_OK == rc) {
+            header.tree_size = offset - sizeof header;
+            rc = md_write_all(fd, flags, header.node_count);
+        }
+        lyd_free_withsiblings(cache_tree);
+        free(flags);
+    }
+    if (SR_ERR_OK == rc && sizeof header != pwrite(fd, &header, sizeof header, 0)) {
+        rc = SR_ERR_IO;
+    }
+
+    close(fd);
+    if (SR_ERR_OK != rc || -1 == rename(tmp_filepath, cache_filepath)) {
+        SR_LOG_WRN_MSG("Unable to store " MD_CACHE_FILENAME " file.");
+        unlink(tmp_filepath);
+    }
+    free(tmp_filepath);
+}
+
 /**
  * @brief Return file path of the internal schema file used to represent module dependencies.
  *
@@ -1007,6 +1289,8 @@ md_init(const char *schema_search_dir,
     md_module_t *module = NULL;
     sr_llist_node_t *module_ll_node = NULL;
     struct stat file_stat = { 0, };
+    uint64_t schema_size = 0, data_size = 0, data_hash = 0;
+    int schema_fd = -1;
 
     CHECK_NULL_ARG4(schema_search_dir, internal_schema_search_dir, internal_data_search_dir, md_ctx);
 
@@ -1048,6 +1332,8 @@ md_init(const char *schema_search_dir,
     CHECK_RC_MSG_GOTO(rc, fail, "Unable to get the filepath of " MD_SCHEMA_FILENAME " data file.");
     rc = md_get_data_file_path(internal_data_search_dir, &data_filepath);
     CHECK_RC_MSG_GOTO(rc, fail, "Unable to get the filepath of " MD_DATA_FILENAME " schema file.");
+    rc = sr_path_join(internal_data_search_dir, MD_CACHE_FILENAME, &ctx->cache_filepath);
+    CHECK_RC_MSG_GOTO(rc, fail, "Unable to get the filepath of " MD_CACHE_FILENAME " file.");
 
     /* load internal schema for model dependencies */
     module_schema = lys_parse_path(ctx->ly_ctx, schema_filepath, LYS_IN_YANG);
@@ -1056,6 +1342,17 @@ md_init(const char *schema_search_dir,
         goto fail;
     }
 
+    /* the cache is tied to the internal schema as well */
+    schema_fd = open(schema_filepath, O_RDONLY);
+    if (-1 == schema_fd) {
+        SR_LOG_ERR("Unable to open " MD_SCHEMA_FILENAME " schema file: %s.", sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto fail;
+    }
+    rc = md_file_hash(schema_fd, MD_SCHEMA_FILENAME, &schema_size, &ctx->schema_hash);
+    close(schema_fd);
+    CHECK_RC_MSG_GOTO(rc, fail, "Unable to compute the hash of " MD_SCHEMA_FILENAME " schema file.");
+
     /* create directory for internal data files if it doesn't exist yet */
     if (-1 == stat(internal_data_search_dir, &file_stat)) {
         rc = sr_mkdir_recursive(internal_data_search_dir, 0755);
@@ -1080,13 +1377,23 @@ md_init(const char *schema_search_dir,
         goto fail;
     }
 
-    /* parse the data file */
-    ly_errno = LY_SUCCESS;
-    ctx->data_tree = lyd_parse_fd(ctx->ly_ctx, ctx->fd, LYD_XML, LYD_OPT_STRICT | LYD_OPT_CONFIG);
-    if (NULL == ctx->data_tree && LY_SUCCESS != ly_errno) {
-        SR_LOG_ERR("Unable to parse " MD_DATA_FILENAME " data file: %s", ly_errmsg());
-        goto fail;
+    /* try to load the data from the cache first, parse the data file if the cache is not valid */
+    rc = md_file_hash(ctx->fd, MD_DATA_FILENAME, &data_size, &data_hash);
+    if (SR_ERR_OK == rc) {
+        rc = md_load_cache(ctx->ly_ctx, ctx->cache_filepath, ctx->schema_hash, data_size, data_hash, &ctx->data_tree);
     }
+    if (SR_ERR_OK != rc) {
+        ly_errno = LY_SUCCESS;
+        ctx->data_tree = lyd_parse_fd(ctx->ly_ctx, ctx->fd, LYD_XML, LYD_OPT_STRICT | LYD_OPT_CONFIG);
+        if (NULL == ctx->data_tree && LY_SUCCESS != ly_errno) {
+            SR_LOG_ERR("Unable to parse " MD_DATA_FILENAME " data file: %s", ly_errmsg());
+            goto fail;
+        }
+        if (SR_ERR_NOT_FOUND == rc) {
+            md_store_cache(ctx->cache_filepath, ctx->schema_hash, data_size, data_hash, ctx->data_tree);
+        }
+    }
+    rc = SR_ERR_OK;
 
     /* close file if it is no longer needed */
     if (!write_lock) {
@@ -1240,6 +1547,7 @@ md_destroy(md_ctx_t *md_ctx)
         if (md_ctx->schema_search_dir) {
             free(md_ctx->schema_search_dir);
         }
+        free(md_ctx->cache_filepath);
         if (md_ctx->data_tree) {
             lyd_free_withsiblings(md_ctx->data_tree);
         }
@@ -2659,6 +2967,7 @@ int
 md_flush(md_ctx_t *md_ctx)
 {
     int ret = 0;
+    uint64_t data_size = 0, data_hash = 0;
 
     if (-1 == md_ctx->fd) {
         SR_LOG_ERR_MSG(MD_DATA_FILENAME " is not open with write-access and write-lock.");
@@ -2674,5 +2983,10 @@ md_flush(md_ctx_t *md_ctx)
         return SR_ERR_INTERNAL;
     }
 
+    /* refresh the cache so that the next initialization does not need to parse the file */
+    if (SR_ERR_OK == md_file_hash(md_ctx->fd, MD_DATA_FILENAME, &data_size, &data_hash)) {
+        md_store_cache(md_ctx->cache_filepath, md_ctx->schema_hash, data_size, data_hash, md_ctx->data_tree);
+    }
+
     return SR_ERR_OK;
 }
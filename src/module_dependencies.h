@@ -120,6 +120,8 @@ typedef struct md_ctx_s {
     char *schema_search_dir;         /**< Path to the directory with schema files. */
     int fd;                          /**< file descriptor associated with sysrepo-module-dependencies.xml,
                                           held only if the file is locked for RW-access, otherwise has value "-1". */
+    char *cache_filepath;            /**< Path to the cache of the internal data file (sysrepo-module-dependencies.cache). */
+    uint64_t schema_hash;            /**< Hash of the internal schema file (sysrepo-module-dependencies.yang), stored in the cache. */
 
     struct ly_ctx *ly_ctx;           /**< libyang context used for manipulation with the internal data file for dependencies. */
 
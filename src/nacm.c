@@ -468,10 +468,9 @@ nacm_load_config(nacm_ctx_t *nacm_ctx, const sr_datastore_t ds)
     fd = open(ds_filepath, O_RDONLY);
     CHECK_NOT_MINUS1_LOG_GOTO(fd, rc, SR_ERR_IO, cleanup, "Unable to open the NACM startup datastore ('%s'): %s.",
                               ds_filepath, sr_strerror_safe(errno));
-    ly_errno = 0;
-    data_tree = lyd_parse_fd(nacm_ctx->schema_info->ly_ctx, fd, LYD_XML, LYD_OPT_TRUSTED | LYD_OPT_CONFIG);
-    if (NULL == data_tree && LY_SUCCESS != ly_errno) {
-        SR_LOG_ERR("Parsing of data tree from file %s failed: %s", ds_filepath, ly_errmsg());
+    rc = sr_lyd_parse_data_fd(nacm_ctx->schema_info->ly_ctx, fd, LYD_OPT_TRUSTED | LYD_OPT_CONFIG, &data_tree);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Parsing of data tree from file %s failed.", ds_filepath);
         goto cleanup;
     }
     close(fd);
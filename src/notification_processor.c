@@ -29,6 +29,8 @@
 #include <dirent.h>
 #include <math.h>
 #include <time.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 
 #include "sr_common.h"
 #include "rp_internal.h"
@@ -38,9 +40,39 @@
 #include "data_manager.h"
 
 #define NP_NS_SCHEMA_FILE                  "sysrepo-notification-store.yang"  /**< Schema of notification store. */
-#define NP_NS_XPATH_NOTIFICATION           "/sysrepo-notification-store:notifications/notification[xpath='%s'][generated-time='%s'][logged-time='%u']"
 #define NP_NS_XPATH_NOTIFICATION_BY_XPATH  "/sysrepo-notification-store:notifications/notification[xpath='%s']"
 
+#define NP_NOTIF_DATA_FILE_EXT             ".notif"      /**< File extension of notification store segment data files. */
+#define NP_NOTIF_INDEX_FILE_EXT            ".idx"        /**< File extension of notification store segment index files. */
+#define NP_NOTIF_LEGACY_FILE_EXT           ".xml"        /**< File extension of notification store files in the old XML format. */
+#define NP_NOTIF_INDEX_MAGIC               0x494e5253    /**< Magic number of notification store index files ("SRNI"). */
+#define NP_NOTIF_INDEX_UNSORTED            0x1           /**< Index flag: entries are not ordered by generated time. */
+
+/**
+ * @brief Header of a notification store segment index file.
+ *
+ * Notification store consists of append-only segments, one per SR_NOTIF_TIME_WINDOW. Each segment
+ * is formed by a data file with concatenated records (notification xpath immediately followed by
+ * notification content in XML) and an index file with the header followed by fixed-size entries,
+ * one per record, in the order of appending.
+ */
+typedef struct np_notif_index_hdr_s {
+    uint32_t magic;                  /**< NP_NOTIF_INDEX_MAGIC. */
+    uint32_t flags;                  /**< Index flags (NP_NOTIF_INDEX_UNSORTED). */
+} np_notif_index_hdr_t;
+
+/**
+ * @brief Entry of a notification store segment index file.
+ */
+typedef struct np_notif_index_entry_s {
+    int64_t generated_time;          /**< Time when the notification has been generated. */
+    uint64_t offset;                 /**< Offset of the record in the segment data file. */
+    uint32_t xpath_len;              /**< Length of the notification xpath in the record. */
+    uint32_t data_len;               /**< Length of the notification content in the record. */
+    uint32_t xpath_hash;             /**< Hash of the notification xpath, used to skip non-matching records. */
+    uint32_t logged_time;            /**< Time when the notification has been logged (in hundreds of seconds). */
+} np_notif_index_entry_t;
+
 /**
  * @brief Information about a notification destination.
  */
@@ -347,133 +379,537 @@ np_commit_error_add(np_commit_ctx_t *commit_ctx, const char *err_subs_xpath, boo
 }
 
 /**
- * @brief Loads the data tree from provided file.
+ * @brief Opens a file of the notification store segment as the proper user.
  */
 static int
-np_load_data_tree(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const char *data_filename,
-        const bool read_only, struct lyd_node **data_tree, int *fd_p)
+np_notif_segment_open(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const char *filename, int flags, int *fd_p)
 {
     int fd = -1;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG4(np_ctx, np_ctx->rp_ctx, data_filename, data_tree);
+    CHECK_NULL_ARG4(np_ctx, np_ctx->rp_ctx, filename, fd_p);
 
     /* open the file as the proper user */
     if (NULL != user_cred) {
         ac_set_user_identity(np_ctx->rp_ctx->ac_ctx, user_cred);
     }
 
-    fd = open(data_filename, (read_only ? O_RDONLY : O_RDWR));
+    fd = open(filename, flags);
 
     if (NULL != user_cred) {
         ac_unset_user_identity(np_ctx->rp_ctx->ac_ctx);
     }
 
     if (-1 == fd) {
-        /* error by open */
         if (ENOENT == errno) {
-            SR_LOG_DBG("Data file '%s' does not exist.", data_filename);
-            if (read_only) {
-                SR_LOG_DBG("No data for '%s' will be loaded.", data_filename);
-                rc = SR_ERR_DATA_MISSING;
-            } else {
-                /* create new persist file */
-                ac_set_user_identity(np_ctx->rp_ctx->ac_ctx, user_cred);
-                fd = open(data_filename, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
-                ac_unset_user_identity(np_ctx->rp_ctx->ac_ctx);
-                if (-1 == fd) {
-                    SR_LOG_ERR("Unable to create a new data file '%s': %s", data_filename, sr_strerror_safe(errno));
-                    rc = SR_ERR_INTERNAL;
-                }
-            }
+            SR_LOG_DBG("Notification store file '%s' does not exist.", filename);
+            rc = SR_ERR_DATA_MISSING;
         } else if (EACCES == errno) {
-            SR_LOG_ERR("Insufficient permissions to access the data file '%s'.", data_filename);
+            SR_LOG_ERR("Insufficient permissions to access the notification store file '%s'.", filename);
             rc = SR_ERR_UNAUTHORIZED;
         } else {
-            SR_LOG_ERR("Unable to open the data file '%s': %s.", data_filename, sr_strerror_safe(errno));
+            SR_LOG_ERR("Unable to open the notification store file '%s': %s.", filename, sr_strerror_safe(errno));
             rc = SR_ERR_INTERNAL;
         }
-        if (SR_ERR_OK != rc) {
-            goto cleanup;
+        return rc;
+    }
+
+    *fd_p = fd;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Writes whole buffer into the file.
+ */
+static int
+np_notif_segment_write(int fd, const void *buff, size_t size)
+{
+    ssize_t ret = 0;
+    size_t written = 0;
+
+    while (written < size) {
+        ret = write(fd, (const char*)buff + written, size - written);
+        if (-1 == ret) {
+            if (EINTR == errno) {
+                continue;
+            }
+            SR_LOG_ERR("Unable to write into the notification store: %s", sr_strerror_safe(errno));
+            return SR_ERR_IO;
         }
+        written += ret;
     }
 
-    /* lock & load the data tree */
-    rc = sr_locking_set_lock_fd(np_ctx->lock_ctx, fd, data_filename, (read_only ? false : true), true);
-    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to lock data file '%s'.", data_filename);
+    return SR_ERR_OK;
+}
 
-    *data_tree = lyd_parse_fd(np_ctx->ly_ctx, fd, LYD_XML, LYD_OPT_STRICT | LYD_OPT_CONFIG | LYD_OPT_NOAUTODEL);
-    if (NULL == *data_tree && LY_SUCCESS != ly_errno) {
-        SR_LOG_ERR("Parsing data from file '%s' failed: %s", data_filename, ly_errmsg());
-        rc = SR_ERR_INTERNAL;
-    } else {
-        SR_LOG_DBG("Data successfully loaded from file '%s'.", data_filename);
+/**
+ * @brief Appends a notification at the end of the notification store segment. The record is appended
+ * into the data file, then its entry is added at the end of the index file. The index file is locked
+ * for the whole operation, which serializes all writers of the segment.
+ */
+static int
+np_notif_segment_append(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const char *segment_name,
+        const char *xpath, const time_t generated_time, const char *data)
+{
+    char index_filename[PATH_MAX] = { 0, }, data_filename[PATH_MAX] = { 0, };
+    np_notif_index_hdr_t hdr = { 0, };
+    np_notif_index_entry_t entry = { 0, }, last_entry = { 0, };
+    struct timespec logged_time_spec = { 0, };
+    struct stat st = { 0, };
+    size_t entry_cnt = 0;
+    int index_fd = -1, data_fd = -1;
+    int ret = 0, rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(np_ctx, segment_name, xpath, data);
+
+    snprintf(index_filename, PATH_MAX, "%s%s", segment_name, NP_NOTIF_INDEX_FILE_EXT);
+    snprintf(data_filename, PATH_MAX, "%s%s", segment_name, NP_NOTIF_DATA_FILE_EXT);
+
+    rc = np_notif_segment_open(np_ctx, user_cred, index_filename, O_RDWR, &index_fd);
+    CHECK_RC_LOG_RETURN(rc, "Unable to open notification store index '%s'.", index_filename);
+
+    rc = sr_locking_set_lock_fd(np_ctx->lock_ctx, index_fd, index_filename, true, true);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Unable to lock notification store index '%s'.", index_filename);
+        close(index_fd);
+        return rc;
     }
 
-    if ((SR_ERR_OK != rc) || (true == read_only) || (NULL == fd_p)) {
-        /* unlock and close fd in case of read_only has been requested */
-        sr_locking_set_unlock_close_fd(np_ctx->lock_ctx, fd);
+    rc = np_notif_segment_open(np_ctx, user_cred, data_filename, O_WRONLY | O_APPEND, &data_fd);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to open notification store data file '%s'.", data_filename);
+
+    /* read the index header, write a new one into an empty index */
+    ret = fstat(index_fd, &st);
+    CHECK_NOT_MINUS1_LOG_GOTO(ret, rc, SR_ERR_IO, cleanup, "Stat of '%s' failed: %s", index_filename, sr_strerror_safe(errno));
+    if ((size_t)st.st_size < sizeof(hdr)) {
+        hdr.magic = NP_NOTIF_INDEX_MAGIC;
+        ret = pwrite(index_fd, &hdr, sizeof(hdr), 0);
+        CHECK_NOT_MINUS1_LOG_GOTO(ret, rc, SR_ERR_IO, cleanup, "Unable to write '%s': %s", index_filename, sr_strerror_safe(errno));
     } else {
-        /* return open fd to locked file otherwise */
-        *fd_p = fd;
+        ret = pread(index_fd, &hdr, sizeof(hdr), 0);
+        if (sizeof(hdr) != ret || NP_NOTIF_INDEX_MAGIC != hdr.magic) {
+            SR_LOG_ERR("Notification store index '%s' is corrupted.", index_filename);
+            rc = SR_ERR_MALFORMED_MSG;
+            goto cleanup;
+        }
+        /* any partially written entry at the end of the index is ignored and overwritten */
+        entry_cnt = (st.st_size - sizeof(hdr)) / sizeof(entry);
+    }
+
+    /* the index stays binary-searchable as long as the notifications are appended in order */
+    if (entry_cnt > 0 && !(hdr.flags & NP_NOTIF_INDEX_UNSORTED)) {
+        ret = pread(index_fd, &last_entry, sizeof(last_entry), sizeof(hdr) + (entry_cnt - 1) * sizeof(last_entry));
+        if (sizeof(last_entry) == ret && last_entry.generated_time > generated_time) {
+            hdr.flags |= NP_NOTIF_INDEX_UNSORTED;
+            ret = pwrite(index_fd, &hdr, sizeof(hdr), 0);
+            CHECK_NOT_MINUS1_LOG_GOTO(ret, rc, SR_ERR_IO, cleanup, "Unable to write '%s': %s", index_filename, sr_strerror_safe(errno));
+        }
+    }
+
+    /* append the record into the data file */
+    ret = fstat(data_fd, &st);
+    CHECK_NOT_MINUS1_LOG_GOTO(ret, rc, SR_ERR_IO, cleanup, "Stat of '%s' failed: %s", data_filename, sr_strerror_safe(errno));
+
+    sr_clock_get_time(CLOCK_REALTIME, &logged_time_spec);
+    entry.generated_time = generated_time;
+    entry.offset = st.st_size;
+    entry.xpath_len = strlen(xpath);
+    entry.data_len = strlen(data);
+    entry.xpath_hash = sr_str_hash(xpath);
+    /* logged-time in hundreds of seconds */
+    entry.logged_time = (uint32_t) (((logged_time_spec.tv_sec * 100) + (uint32_t)(logged_time_spec.tv_nsec / 1.0e7)) % UINT32_MAX);
+
+    rc = np_notif_segment_write(data_fd, xpath, entry.xpath_len);
+    if (SR_ERR_OK == rc) {
+        rc = np_notif_segment_write(data_fd, data, entry.data_len);
+    }
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to append notification into '%s'.", data_filename);
+
+    /* add the index entry */
+    ret = pwrite(index_fd, &entry, sizeof(entry), sizeof(hdr) + entry_cnt * sizeof(entry));
+    if (sizeof(entry) != ret) {
+        SR_LOG_ERR("Unable to write notification store index '%s': %s", index_filename, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+
+    /* flush in-core data to the disc, readers ignore index entries pointing behind the end of the data file */
+    ret = fdatasync(data_fd);
+    if (0 == ret) {
+        ret = fdatasync(index_fd);
     }
+    CHECK_ZERO_LOG_GOTO(ret, rc, SR_ERR_IO, cleanup, "File synchronization failed: %s", sr_strerror_safe(errno));
 
 cleanup:
+    if (-1 != data_fd) {
+        close(data_fd);
+    }
+    sr_locking_set_unlock_close_fd(np_ctx->lock_ctx, index_fd);
     return rc;
 }
 
 /**
- * @brief Saves the data tree into the file specified by file descriptor.
+ * @brief Loads the notification referenced by an index entry of the notification store segment
+ * and converts it into the requested API variant.
  */
 static int
-np_save_data_tree(struct lyd_node *data_tree, int fd)
+np_notif_segment_load_entry(np_ctx_t *np_ctx, const rp_session_t *rp_session, int data_fd, off_t data_size,
+        const np_notif_index_entry_t *entry, const char *xpath, const sr_api_variant_t api_variant,
+        np_ev_notification_t **notification_p)
 {
-    int ret = 0;
+    np_ev_notification_t *notification = NULL;
+    struct lyxml_elem *xml = NULL;
+    char *record = NULL;
+    ssize_t ret = 0;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(np_ctx, rp_session, entry, notification_p);
+
+    *notification_p = NULL;
+
+    if (entry->offset + entry->xpath_len + entry->data_len > (uint64_t)data_size) {
+        SR_LOG_WRN_MSG("Skipping notification store entry pointing behind the end of the data file.");
+        return SR_ERR_OK;
+    }
+
+    record = malloc(entry->xpath_len + entry->data_len + 1);
+    CHECK_NULL_NOMEM_RETURN(record);
+
+    ret = pread(data_fd, record, entry->xpath_len + entry->data_len, entry->offset);
+    if (ret != (ssize_t)(entry->xpath_len + entry->data_len)) {
+        SR_LOG_ERR("Unable to read the notification store data file: %s", sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+    record[entry->xpath_len + entry->data_len] = '\0';
+
+    if (0 != strncmp(record, xpath, entry->xpath_len)) {
+        /* hash collision */
+        goto cleanup;
+    }
+
+    notification = calloc(1, sizeof(*notification));
+    CHECK_NULL_NOMEM_GOTO(notification, rc, cleanup);
+
+    notification->xpath = strndup(record, entry->xpath_len);
+    CHECK_NULL_NOMEM_GOTO(notification->xpath, rc, cleanup);
+    notification->timestamp = entry->generated_time;
+
+    xml = lyxml_parse_mem(np_ctx->ly_ctx, record + entry->xpath_len, 0);
+    if (NULL == xml) {
+        SR_LOG_ERR("Unable to parse notification '%s' from the notification store: %s", notification->xpath, ly_errmsg());
+        rc = SR_ERR_INTERNAL;
+        goto cleanup;
+    }
+    notification->data.xml = xml;
+    notification->data_type = NP_EV_NOTIF_DATA_XML;
+
+    /* parse notification data */
+    rc = dm_parse_event_notif(np_ctx->rp_ctx->dm_ctx, rp_session->dm_session, NULL, notification, api_variant);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Error by parsing notification '%s'.", notification->xpath);
+
+    *notification_p = notification;
+    notification = NULL;
+
+cleanup:
+    if (NULL != xml) {
+        lyxml_free(np_ctx->ly_ctx, xml);
+    }
+    if (NULL != notification) {
+        notification->data_type = NP_EV_NOTIF_DATA_NONE;
+        np_event_notification_cleanup(notification);
+    }
+    free(record);
+    return rc;
+}
+
+/**
+ * @brief Loads notifications matching given xpath and time interval from the notification store segment.
+ * If the segment index is sorted, the first matching entry is found by binary search.
+ */
+static int
+np_notif_segment_load(np_ctx_t *np_ctx, const rp_session_t *rp_session, const char *index_filename,
+        const char *xpath, const time_t start_time, const time_t stop_time, const sr_api_variant_t api_variant,
+        sr_list_t *notif_list)
+{
+    char data_filename[PATH_MAX] = { 0, };
+    const np_notif_index_hdr_t *hdr = NULL;
+    const np_notif_index_entry_t *entries = NULL;
+    np_ev_notification_t *notification = NULL;
+    void *addr = MAP_FAILED;
+    struct stat index_st = { 0, }, data_st = { 0, };
+    size_t entry_cnt = 0, lo = 0, hi = 0, mid = 0, xpath_len = 0;
+    uint32_t xpath_hash = 0;
+    bool sorted = false;
+    int index_fd = -1, data_fd = -1;
+    int ret = 0, rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG5(np_ctx, rp_session, index_filename, xpath, notif_list);
+
+    snprintf(data_filename, PATH_MAX, "%.*s%s", (int)(strlen(index_filename) - strlen(NP_NOTIF_INDEX_FILE_EXT)),
+            index_filename, NP_NOTIF_DATA_FILE_EXT);
+
+    rc = np_notif_segment_open(np_ctx, rp_session->user_credentials, index_filename, O_RDONLY, &index_fd);
+    if (SR_ERR_DATA_MISSING == rc) {
+        /* segment has been dropped in the meantime */
+        return SR_ERR_OK;
+    }
+    CHECK_RC_LOG_RETURN(rc, "Unable to open notification store index '%s'.", index_filename);
+
+    rc = sr_locking_set_lock_fd(np_ctx->lock_ctx, index_fd, index_filename, false, true);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Unable to lock notification store index '%s'.", index_filename);
+        close(index_fd);
+        return rc;
+    }
+
+    ret = fstat(index_fd, &index_st);
+    CHECK_NOT_MINUS1_LOG_GOTO(ret, rc, SR_ERR_IO, cleanup, "Stat of '%s' failed: %s", index_filename, sr_strerror_safe(errno));
+    if ((size_t)index_st.st_size < sizeof(*hdr)) {
+        /* empty segment */
+        goto cleanup;
+    }
+
+    rc = np_notif_segment_open(np_ctx, rp_session->user_credentials, data_filename, O_RDONLY, &data_fd);
+    if (SR_ERR_DATA_MISSING == rc) {
+        /* segment is just being dropped */
+        rc = SR_ERR_OK;
+        goto cleanup;
+    }
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to open notification store data file '%s'.", data_filename);
+    ret = fstat(data_fd, &data_st);
+    CHECK_NOT_MINUS1_LOG_GOTO(ret, rc, SR_ERR_IO, cleanup, "Stat of '%s' failed: %s", data_filename, sr_strerror_safe(errno));
+
+    addr = mmap(NULL, index_st.st_size, PROT_READ, MAP_PRIVATE, index_fd, 0);
+    if (MAP_FAILED == addr) {
+        SR_LOG_ERR("Unable to map notification store index '%s': %s", index_filename, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+    hdr = addr;
+    if (NP_NOTIF_INDEX_MAGIC != hdr->magic) {
+        SR_LOG_ERR("Notification store index '%s' is corrupted.", index_filename);
+        rc = SR_ERR_MALFORMED_MSG;
+        goto cleanup;
+    }
+    entries = (const np_notif_index_entry_t *)(hdr + 1);
+    entry_cnt = (index_st.st_size - sizeof(*hdr)) / sizeof(*entries);
+    sorted = !(hdr->flags & NP_NOTIF_INDEX_UNSORTED);
+
+    /* seek to the first entry not older than start_time */
+    if (sorted) {
+        hi = entry_cnt;
+        while (lo < hi) {
+            mid = lo + ((hi - lo) >> 1);
+            if (entries[mid].generated_time < start_time) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+    }
+
+    xpath_len = strlen(xpath);
+    xpath_hash = sr_str_hash(xpath);
 
-    CHECK_NULL_ARG(data_tree);
+    for (size_t i = lo; i < entry_cnt; i++) {
+        if (entries[i].generated_time > stop_time) {
+            if (sorted) {
+                break;
+            }
+            continue;
+        }
+        if (entries[i].generated_time < start_time || entries[i].xpath_hash != xpath_hash || entries[i].xpath_len != xpath_len) {
+            continue;
+        }
+        rc = np_notif_segment_load_entry(np_ctx, rp_session, data_fd, data_st.st_size, &entries[i], xpath,
+                api_variant, &notification);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load notification from '%s'.", data_filename);
+        if (NULL != notification) {
+            SR_LOG_DBG("Adding a new notification: '%s' (time=%ld)", notification->xpath, notification->timestamp);
+            rc = sr_list_add(notif_list, notification);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Error by adding notification into list.");
+            notification = NULL;
+        }
+    }
 
-    /* empty file content */
-    ret = ftruncate(fd, 0);
-    CHECK_ZERO_LOG_RETURN(ret, SR_ERR_INTERNAL, "File truncate failed: %s", sr_strerror_safe(errno));
+cleanup:
+    np_event_notification_cleanup(notification);
+    if (MAP_FAILED != addr) {
+        munmap(addr, index_st.st_size);
+    }
+    if (-1 != data_fd) {
+        close(data_fd);
+    }
+    sr_locking_set_unlock_close_fd(np_ctx->lock_ctx, index_fd);
+    return rc;
+}
 
-    /* print data tree to file */
-    ret = lyd_print_fd(fd, data_tree, LYD_XML, LYP_WITHSIBLINGS | LYP_FORMAT | LYP_WD_EXPLICIT);
-    CHECK_ZERO_LOG_RETURN(ret, SR_ERR_INTERNAL, "Saving notification store data tree failed: %s", ly_errmsg());
+/**
+ * @brief Fills event notification details from libyang's list instance of a notification
+ * stored in the old XML notification store format.
+ */
+static int
+np_legacy_notification_entry_fill(np_ev_notification_t *notification, struct lyd_node *node)
+{
+    struct lyd_node_leaf_list *node_ll = NULL;
+    struct lyd_node_anydata *node_anydata = NULL;
+    int rc = SR_ERR_OK;
 
-    /* flush in-core data to the disc */
-    ret = fsync(fd);
-    CHECK_ZERO_LOG_RETURN(ret, SR_ERR_INTERNAL, "File synchronization failed: %s", sr_strerror_safe(errno));
+    CHECK_NULL_ARG3(notification, node, node->schema);
 
-    SR_LOG_DBG_MSG("Data tree successfully saved.");
+    while (NULL != node) {
+        if (NULL != node->schema && NULL != node->schema->name) {
+            node_ll = (struct lyd_node_leaf_list*)node;
+            if (0 == strcmp(node->schema->name, "xpath") && NULL != node_ll->value_str) {
+                notification->xpath = strdup(node_ll->value_str);
+                CHECK_NULL_NOMEM_RETURN(notification->xpath);
+            }
+            if (0 == strcmp(node->schema->name, "generated-time") && NULL != node_ll->value_str) {
+                rc = sr_str_to_time((char*)node_ll->value_str, &notification->timestamp);
+                CHECK_RC_MSG_RETURN(rc, "String to time conversion failed.");
+            }
+            if (0 == strcmp(node->schema->name, "data") && LYS_ANYDATA == node->schema->nodetype) {
+                node_anydata = (struct lyd_node_anydata*)node;
+                if (LYD_ANYDATA_XML == node_anydata->value_type) {
+                    /* owned by the data tree */
+                    notification->data.xml = node_anydata->value.xml;
+                    notification->data_type = NP_EV_NOTIF_DATA_XML;
+                }
+            }
+        }
+        node = node->next;
+    }
 
     return SR_ERR_OK;
 }
 
 /**
- * @brief Cleans up specified data tree and closes specified file descriptor.
+ * @brief Loads notifications matching given xpath and time interval from a notification store file
+ * written in the old XML format (before the store was split into indexed segments). Such files are
+ * only read, they are dropped by the notification store cleanup once aged out.
  */
-static void
-np_cleanup_data_tree(np_ctx_t *np_ctx, struct lyd_node *data_tree, int fd)
+static int
+np_legacy_store_load(np_ctx_t *np_ctx, const rp_session_t *rp_session, const char *filename,
+        const char *xpath, const time_t start_time, const time_t stop_time, const sr_api_variant_t api_variant,
+        sr_list_t *notif_list)
 {
-    if (NULL != data_tree) {
-        lyd_free_withsiblings(data_tree);
+    char req_xpath[PATH_MAX] = { 0, };
+    struct lyd_node *data_tree = NULL;
+    struct ly_set *node_set = NULL;
+    np_ev_notification_t *notification = NULL;
+    int fd = -1;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG5(np_ctx, rp_session, filename, xpath, notif_list);
+
+    rc = np_notif_segment_open(np_ctx, rp_session->user_credentials, filename, O_RDONLY, &fd);
+    if (SR_ERR_DATA_MISSING == rc) {
+        /* file has been dropped in the meantime */
+        return SR_ERR_OK;
     }
-    if (-1 != fd && NULL != np_ctx) {
-        sr_locking_set_unlock_close_fd(np_ctx->lock_ctx, fd);
+    CHECK_RC_LOG_RETURN(rc, "Unable to open notification store file '%s'.", filename);
+
+    rc = sr_locking_set_lock_fd(np_ctx->lock_ctx, fd, filename, false, true);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Unable to lock notification store file '%s'.", filename);
+        close(fd);
+        return rc;
+    }
+
+    ly_errno = LY_SUCCESS;
+    data_tree = lyd_parse_fd(np_ctx->ly_ctx, fd, LYD_XML, LYD_OPT_STRICT | LYD_OPT_CONFIG | LYD_OPT_NOAUTODEL);
+    if (NULL == data_tree) {
+        if (LY_SUCCESS != ly_errno) {
+            SR_LOG_ERR("Parsing data from file '%s' failed: %s", filename, ly_errmsg());
+            rc = SR_ERR_INTERNAL;
+        }
+        goto cleanup;
+    }
+
+    /* get all notifications matching the xpath */
+    snprintf(req_xpath, PATH_MAX, NP_NS_XPATH_NOTIFICATION_BY_XPATH, xpath);
+    node_set = lyd_find_xpath(data_tree, req_xpath);
+
+    for (size_t i = 0; NULL != node_set && i < node_set->number; i++) {
+        notification = calloc(1, sizeof(*notification));
+        CHECK_NULL_NOMEM_GOTO(notification, rc, cleanup);
+
+        rc = np_legacy_notification_entry_fill(notification, node_set->set.d[i]->child);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Error by filling a notification entry.");
+
+        /* filter out notifications not exactly matching the time interval */
+        if (NP_EV_NOTIF_DATA_XML != notification->data_type ||
+                notification->timestamp < start_time || notification->timestamp > stop_time) {
+            notification->data_type = NP_EV_NOTIF_DATA_NONE;
+            np_event_notification_cleanup(notification);
+            notification = NULL;
+            continue;
+        }
+
+        /* parse notification data */
+        rc = dm_parse_event_notif(np_ctx->rp_ctx->dm_ctx, rp_session->dm_session, NULL, notification, api_variant);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Error by parsing notification '%s'.", notification->xpath);
+
+        SR_LOG_DBG("Adding a new notification: '%s' (time=%ld)", notification->xpath, notification->timestamp);
+        rc = sr_list_add(notif_list, notification);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Error by adding notification into list.");
+        notification = NULL;
+    }
+
+cleanup:
+    if (NULL != notification) {
+        if (NP_EV_NOTIF_DATA_XML == notification->data_type) {
+            /* XML content is owned by the data tree */
+            notification->data_type = NP_EV_NOTIF_DATA_NONE;
+        }
+        np_event_notification_cleanup(notification);
+    }
+    ly_set_free(node_set);
+    lyd_free_withsiblings(data_tree);
+    sr_locking_set_unlock_close_fd(np_ctx->lock_ctx, fd);
+    return rc;
+}
+
+/**
+ * @brief Creates a notification store file (if it does not exist) & applies access permissions.
+ */
+static void
+np_notif_segment_create_file(const char *module_name, const char *filename)
+{
+    mode_t old_umask = 0;
+    int fd = -1;
+    int rc = SR_ERR_OK;
+
+    if (-1 == access(filename, F_OK)) {
+        old_umask = umask(0);
+        fd = open(filename, O_CREAT, S_IRUSR | S_IWUSR);
+        umask(old_umask);
+        if (-1 == fd) {
+            SR_LOG_WRN("Error by opening file '%s': %s.", filename, sr_strerror_safe(errno));
+        } else {
+            /* close and apply access permissions */
+            close(fd);
+            rc = sr_set_data_file_permissions(filename, false, SR_DATA_SEARCH_DIR, module_name, false);
+            if (SR_ERR_OK != rc) {
+                SR_LOG_WRN("Error by applying correct data file permissions on file '%s'.", filename);
+            }
+        }
     }
 }
 
 /**
- * @brief Returns the name of a file that can be used to store a notification received in given time.
+ * @brief Returns the name (without file extension) of the notification store segment that can be used
+ * to store a notification generated in given time. Creates the segment files if they do not exist yet.
  */
 static int
-np_get_notif_store_filename(const char *module_name, time_t received_time, char *filename_buff, size_t filename_buff_size)
+np_get_notif_segment_name(const char *module_name, time_t generated_time, char *filename_buff, size_t filename_buff_size)
 {
+    char filename[PATH_MAX] = { 0, };
     mode_t old_umask = 0;
     time_t raw_time = 0;
     struct tm *tm_time = { 0, };
-    int fd = -1;
-    int ret = 0, rc = SR_ERR_OK;
+    int ret = 0;
 
     /* create the parent directory for notifications (if it does not exist already) */
     strncat(filename_buff, SR_NOTIF_DATA_SEARCH_DIR, filename_buff_size - 1);
@@ -497,30 +933,19 @@ np_get_notif_store_filename(const char *module_name, time_t received_time, char
                 sr_strerror_safe(errno));
     }
 
-    /* generate data filename according to the current time */
-    raw_time = received_time;
+    /* generate segment name according to the generated time */
+    raw_time = generated_time;
     tm_time = localtime(&raw_time);
-    /* move raw_time back to the beginning of the current NP_NOTIF_FILE_WINDOW */
+    /* move raw_time back to the beginning of the current SR_NOTIF_TIME_WINDOW */
     raw_time -= (((tm_time->tm_hour * 60) + tm_time->tm_min) % SR_NOTIF_TIME_WINDOW) * 60;
     strftime(filename_buff + strlen(filename_buff), filename_buff_size - strlen(filename_buff) - 1,
-            "%Y-%m-%d_%H-%M.xml", localtime(&raw_time));
+            "%Y-%m-%d_%H-%M", localtime(&raw_time));
 
-    /* create file if not exists & apply access permissions */
-    if (-1 == access(filename_buff, F_OK)) {
-        old_umask = umask(0);
-        fd = open(filename_buff, O_CREAT, S_IRUSR | S_IWUSR);
-        if (-1 == fd) {
-            SR_LOG_WRN("Error by opening file '%s': %s.", filename_buff, sr_strerror_safe(errno));
-        } else {
-            /* close and apply access permissions */
-            close(fd);
-            umask(old_umask);
-            rc = sr_set_data_file_permissions(filename_buff, false, SR_DATA_SEARCH_DIR, module_name, false);
-            if (SR_ERR_OK != rc) {
-                SR_LOG_WRN("Error by applying correct data file permissions on file '%s'.", filename_buff);
-            }
-        }
-    }
+    /* create segment files if not exist & apply access permissions */
+    snprintf(filename, PATH_MAX, "%s%s", filename_buff, NP_NOTIF_DATA_FILE_EXT);
+    np_notif_segment_create_file(module_name, filename);
+    snprintf(filename, PATH_MAX, "%s%s", filename_buff, NP_NOTIF_INDEX_FILE_EXT);
+    np_notif_segment_create_file(module_name, filename);
 
     return SR_ERR_OK;
 }
@@ -577,6 +1002,63 @@ np_get_notification_files(np_ctx_t *np_ctx, const char *module_name, time_t time
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Get index files of notification store segments of given module whose time window
+ * overlaps with provided time interval. Segments are returned in chronological order.
+ * Notification store files in the old XML format covering the interval are returned as well.
+ */
+static int
+np_get_notif_segments(np_ctx_t *np_ctx, const char *module_name, time_t time_from, time_t time_to,
+        sr_list_t *file_list)
+{
+    char dirname[PATH_MAX] = { 0, };
+    char filename[PATH_MAX] = { 0, };
+    struct dirent **entries = NULL;
+    int dir_elem_cnt = 0;
+    struct tm tm_time = { 0, };
+    time_t window_start = 0;
+    char *end = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(np_ctx, module_name, file_list);
+
+    snprintf(dirname, PATH_MAX - 1, "%s/%s", SR_NOTIF_DATA_SEARCH_DIR, module_name);
+
+    /* scan files in the directory with the data files (in alphabetical = chronological order) */
+    dir_elem_cnt = scandir(dirname, &entries, NULL, alphasort);
+    if (dir_elem_cnt < 0) {
+        SR_LOG_DBG("No notification store segments found in '%s': %s.", dirname, sr_strerror_safe(errno));
+        return SR_ERR_OK;
+    }
+
+    for (size_t i = 0; i < dir_elem_cnt; i++) {
+        if ((DT_DIR != entries[i]->d_type) && (sr_str_ends_with(entries[i]->d_name, NP_NOTIF_INDEX_FILE_EXT) ||
+                sr_str_ends_with(entries[i]->d_name, NP_NOTIF_LEGACY_FILE_EXT))) {
+            /* the segment (or legacy file) name encodes the beginning of its time window */
+            memset(&tm_time, 0, sizeof(tm_time));
+            tm_time.tm_isdst = -1;
+            end = strptime(entries[i]->d_name, "%Y-%m-%d_%H-%M", &tm_time);
+            if (NULL == end || (0 != strcmp(end, NP_NOTIF_INDEX_FILE_EXT) && 0 != strcmp(end, NP_NOTIF_LEGACY_FILE_EXT))) {
+                SR_LOG_WRN("Skipping unexpected notification store file '%s'.", entries[i]->d_name);
+            } else {
+                window_start = mktime(&tm_time);
+                if (window_start <= time_to && (window_start + (SR_NOTIF_TIME_WINDOW * 60)) > time_from) {
+                    snprintf(filename, PATH_MAX - 1, "%s/%s", dirname, entries[i]->d_name);
+                    SR_LOG_DBG("Adding notification store segment '%s'.", filename);
+                    rc = sr_list_add(file_list, strdup(filename));
+                    if (SR_ERR_OK != rc) {
+                        SR_LOG_WRN("Error by adding file '%s' to the list: %s.", filename, sr_strerror(rc));
+                    }
+                }
+            }
+        }
+        free(entries[i]);
+    }
+    free(entries);
+
+    return SR_ERR_OK;
+}
+
 /**
  * @brief Get notification files of all modules with last modification time from provided time interval.
  */
@@ -640,47 +1122,6 @@ np_event_notification_content_cleanup(np_ev_notification_t *notification)
     }
 }
 
-/**
- * @brief Fills event notification details from libyang's list instance of a notification.
- */
-static int
-np_event_notification_entry_fill(np_ev_notification_t *notification, struct lyd_node *node)
-{
-    struct lyd_node_leaf_list *node_ll = NULL;
-    struct lyd_node_anydata *node_anydata = NULL;
-    int rc = SR_ERR_OK;
-
-    CHECK_NULL_ARG3(notification, node, node->schema);
-
-    while (NULL != node) {
-        if (NULL != node->schema && NULL != node->schema->name) {
-            node_ll = (struct lyd_node_leaf_list*)node;
-            if (0 == strcmp(node->schema->name, "xpath") && NULL != node_ll->value_str) {
-                notification->xpath = strdup(node_ll->value_str);
-                CHECK_NULL_NOMEM_GOTO(notification->xpath, rc, cleanup);
-            }
-            if (0 == strcmp(node->schema->name, "generated-time") && NULL != node_ll->value_str) {
-                rc = sr_str_to_time((char*)node_ll->value_str, &notification->timestamp);
-                CHECK_RC_MSG_GOTO(rc, cleanup, "String to time conversion failed.");
-            }
-            if (0 == strcmp(node->schema->name, "data") && LYS_ANYDATA == node->schema->nodetype) {
-                node_anydata = (struct lyd_node_anydata*)node;
-                if (LYD_ANYDATA_XML == node_anydata->value_type) {
-                    notification->data.xml = node_anydata->value.xml;
-                    notification->data_type = NP_EV_NOTIF_DATA_XML;
-                }
-            }
-        }
-        node = node->next;
-    }
-
-    return SR_ERR_OK;
-
-cleanup:
-    np_event_notification_content_cleanup(notification);
-    return rc;
-}
-
 /**
  * @brief Sets up notification store cleanup timer.
  */
@@ -943,6 +1384,10 @@ np_notification_subscribe(np_ctx_t *np_ctx, const rp_session_t *rp_session, Sr__
     subscription->priority = priority;
     subscription->enable_running = (opts & NP_SUBSCR_ENABLE_RUNNING);
     subscription->enable_nacm = (rp_session->options & SR_SESS_ENABLE_NACM);
+    subscription->inline_changes = (opts & NP_SUBSCR_INLINE_CHANGES);
+    if (SR__SUBSCRIPTION_TYPE__DP_GET_ITEMS_SUBS == type) {
+        subscription->dp_cache_ttl = (opts >> NP_SUBSCR_DP_CACHE_TTL_SHIFT);
+    }
     subscription->api_variant = api_variant;
 
     if (NULL != xpath) {
@@ -1308,7 +1753,8 @@ np_get_data_provider_subscriptions(np_ctx_t *np_ctx, const rp_session_t *rp_sess
 }
 
 int
-np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_notif_event_t event, uint32_t commit_id)
+np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_notif_event_t event, uint32_t commit_id,
+        sr_list_t *changes)
 {
     Sr__Msg *notif = NULL;
     int rc = SR_ERR_OK;
@@ -1327,11 +1773,23 @@ np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_not
             notif->notification->module_change_notif->event = sr_notification_event_sr_to_gpb(event);
             notif->notification->module_change_notif->module_name = strdup(subscription->module_name);
             CHECK_NULL_NOMEM_ERROR(notif->notification->module_change_notif->module_name, rc);
+            if (SR_ERR_OK == rc && NULL != changes) {
+                rc = sr_changes_sr_to_gpb(changes, NULL, &notif->notification->module_change_notif->changes,
+                        &notif->notification->module_change_notif->n_changes);
+                notif->notification->module_change_notif->has_inline_changes = true;
+                notif->notification->module_change_notif->inline_changes = true;
+            }
         }
         if (SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS == subscription->type) {
             notif->notification->subtree_change_notif->event = sr_notification_event_sr_to_gpb(event);
             notif->notification->subtree_change_notif->xpath = strdup(subscription->xpath);
             CHECK_NULL_NOMEM_ERROR(notif->notification->subtree_change_notif->xpath, rc);
+            if (SR_ERR_OK == rc && NULL != changes) {
+                rc = sr_changes_sr_to_gpb(changes, NULL, &notif->notification->subtree_change_notif->changes,
+                        &notif->notification->subtree_change_notif->n_changes);
+                notif->notification->subtree_change_notif->has_inline_changes = true;
+                notif->notification->subtree_change_notif->inline_changes = true;
+            }
         }
     }
 
@@ -1353,22 +1811,39 @@ np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_not
 }
 
 int
-np_data_provider_request(np_ctx_t *np_ctx, np_subscription_t *subscription, rp_session_t *session, const char *xpath)
+np_data_provider_request(np_ctx_t *np_ctx, np_subscription_t *subscription, rp_session_t *session,
+        char **xpaths, size_t xpath_cnt)
 {
+    Sr__DataProvideReq *dp_req = NULL;
     Sr__Msg *req = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG5(np_ctx, np_ctx->rp_ctx, subscription, subscription->dst_address, xpath);
+    CHECK_NULL_ARG5(np_ctx, np_ctx->rp_ctx, subscription, subscription->dst_address, xpaths);
     CHECK_NULL_ARG2(session, session->req);
+    if (0 == xpath_cnt) {
+        return SR_ERR_INVAL_ARG;
+    }
 
-    SR_LOG_DBG("Requesting operational data of '%s' from '%s' @ %"PRIu32".", subscription->xpath,
-            subscription->dst_address, subscription->dst_id);
+    SR_LOG_DBG("Requesting operational data of '%s' (%zu xpaths) from '%s' @ %"PRIu32".", subscription->xpath,
+            xpath_cnt, subscription->dst_address, subscription->dst_id);
 
     rc = sr_gpb_req_alloc(NULL, SR__OPERATION__DATA_PROVIDE, session->id, &req);
 
     if (SR_ERR_OK == rc) {
-        req->request->data_provide_req->xpath = strdup(xpath);
-        CHECK_NULL_NOMEM_ERROR(req->request->data_provide_req->xpath, rc);
+        dp_req = req->request->data_provide_req;
+        dp_req->xpath = strdup(xpaths[0]);
+        CHECK_NULL_NOMEM_ERROR(dp_req->xpath, rc);
+
+        if (SR_ERR_OK == rc && xpath_cnt > 1) {
+            /* batched request */
+            dp_req->xpaths = calloc(xpath_cnt, sizeof(*dp_req->xpaths));
+            CHECK_NULL_NOMEM_ERROR(dp_req->xpaths, rc);
+            for (size_t i = 0; SR_ERR_OK == rc && i < xpath_cnt; i++) {
+                dp_req->xpaths[i] = strdup(xpaths[i]);
+                CHECK_NULL_NOMEM_ERROR(dp_req->xpaths[i], rc);
+                dp_req->n_xpaths = i + 1;
+            }
+        }
 
         if (SR_ERR_OK == rc) {
             req->request->data_provide_req->subscription_id = subscription->dst_id;
@@ -1595,15 +2070,9 @@ int
 np_store_event_notification(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const char *xpath, const time_t generated_time,
         struct lyd_node **notif_data_tree)
 {
-#define TIME_BUF_SIZE 64
-
     char *module_name = NULL;
-    char data_filename[PATH_MAX] = { 0, };
-    char data_xpath[PATH_MAX] = { 0, };
-    char generated_time_buf[TIME_BUF_SIZE] = { 0, };
-    struct timespec logged_time_spec = { 0, };
-    struct lyd_node *data_tree = NULL, *new_node = NULL;
-    int fd = -1;
+    char segment_name[PATH_MAX] = { 0, };
+    char *data = NULL;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG3(np_ctx, xpath, notif_data_tree);
@@ -1614,51 +2083,28 @@ np_store_event_notification(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const
     rc = sr_copy_first_ns(xpath, &module_name);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Error by extracting module name from xpath.");
 
-    /* get current notification data filename */
-    rc = np_get_notif_store_filename(module_name, generated_time, data_filename, PATH_MAX);
-    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to compose notification data file name for '%s'.", module_name);
-
-    /* load notif. data */
-    rc = np_load_data_tree(np_ctx, user_cred, data_filename, false, &data_tree, &fd);
-    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load notification store data for module '%s'.", module_name);
-
-    /* format the time & retrieve current time */
-    sr_time_to_str(generated_time, generated_time_buf, TIME_BUF_SIZE);
-    sr_clock_get_time(CLOCK_REALTIME, &logged_time_spec);
+    /* get current notification store segment */
+    rc = np_get_notif_segment_name(module_name, generated_time, segment_name, PATH_MAX);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to compose notification store segment name for '%s'.", module_name);
 
-    /* create data subtree to be stored in the notif. data file */
-    snprintf(data_xpath, PATH_MAX - 1, NP_NS_XPATH_NOTIFICATION, xpath, generated_time_buf,
-            /* logged-time in hundreds of seconds */
-            (uint32_t) (((logged_time_spec.tv_sec * 100) + (uint32_t)(logged_time_spec.tv_nsec / 1.0e7)) % UINT32_MAX));
-    new_node = lyd_new_path(data_tree, np_ctx->ly_ctx, data_xpath, NULL, 0, 0);
-    if (NULL == new_node) {
-        SR_LOG_WRN("Error by adding new notification entry: %s.", ly_errmsg());
-        goto cleanup; /* do not set error code - it may be just too much notifications within the same hundred of second */
-    }
-    if (NULL == data_tree) {
-        /* if the new data tree has been just created */
-        data_tree = new_node;
-        new_node = new_node->child; /* new_node is 'notifications' container */
-    }
-
-    /* store notification data as anydata */
-    new_node = lyd_new_anydata(new_node, NULL, "data", (void*)*notif_data_tree, LYD_ANYDATA_DATATREE);
-    if (NULL == new_node) {
-        SR_LOG_ERR("Error by adding notification content into notification store: %s.", ly_errmsg());
+    /* serialize notification content */
+    if (0 != lyd_print_mem(&data, *notif_data_tree, LYD_XML, LYP_WITHSIBLINGS) || NULL == data) {
+        SR_LOG_ERR("Error by printing notification content: %s.", ly_errmsg());
         rc = SR_ERR_INTERNAL;
         goto cleanup;
-    } else {
-        *notif_data_tree = NULL; /* data tree freed in lyd_new_anydata */
     }
 
-    /* save notif. data */
-    rc = np_save_data_tree(data_tree, fd);
-    if (SR_ERR_OK == rc) {
-        SR_LOG_DBG("Notification successfully logged into '%s' notification store.", module_name);
-    }
+    /* append the notification at the end of the segment */
+    rc = np_notif_segment_append(np_ctx, user_cred, segment_name, xpath, generated_time, data);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to store notification into '%s' notification store.", module_name);
+
+    SR_LOG_DBG("Notification successfully logged into '%s' notification store.", module_name);
+
+    lyd_free_withsiblings(*notif_data_tree);
+    *notif_data_tree = NULL;
 
 cleanup:
-    np_cleanup_data_tree(np_ctx, data_tree, fd);
+    free(data);
     free(module_name);
     return rc;
 }
@@ -1668,15 +2114,11 @@ np_get_event_notifications(np_ctx_t *np_ctx, const rp_session_t *rp_session, con
         const time_t start_time, const time_t stop_time, const sr_api_variant_t api_variant, sr_list_t **notifications)
 {
     char *module_name = NULL;
-    char req_xpath[PATH_MAX] = { 0, };
     sr_list_t *file_list = NULL, *notif_list = NULL;
-    struct lyd_node *data_tree = NULL, *main_tree = NULL;
-    struct ly_set *node_set = NULL;
-    np_ev_notification_t *notification = NULL;
     time_t effective_stop_time = 0;
-    int rc = SR_ERR_OK, ret = 0;
+    int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG3(np_ctx, xpath, notifications);
+    CHECK_NULL_ARG4(np_ctx, rp_session, xpath, notifications);
 
     effective_stop_time = (0 == stop_time) ? time(NULL) : stop_time;
 
@@ -1686,71 +2128,37 @@ np_get_event_notifications(np_ctx_t *np_ctx, const rp_session_t *rp_session, con
     rc = sr_copy_first_ns(xpath, &module_name);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Error by extracting module name from xpath.");
 
-    /* get all notification files matching module name and time interval */
     rc = sr_list_init(&file_list);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to initialize file list.");
 
-    /* get all notification files matching module name and provided time interval */
-    rc = np_get_notification_files(np_ctx, module_name,
-            (0 == start_time) ? 0 : (start_time - (SR_NOTIF_TIME_WINDOW * 60)),
-            (effective_stop_time + (SR_NOTIF_TIME_WINDOW * 60)),
-            file_list);
+    /* get indices of all notification store segments matching module name and provided time interval */
+    rc = np_get_notif_segments(np_ctx, module_name, start_time, effective_stop_time, file_list);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to retrieve notification file list.");
 
-    /* load all notification files */
+    rc = sr_list_init(&notif_list);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to initialize notification list.");
+
+    /* load matching notifications from each segment (segments are ordered by time) */
     for (size_t i = 0; i < file_list->count; i++) {
-        rc = np_load_data_tree(np_ctx, rp_session->user_credentials, file_list->data[i], true, &data_tree, NULL);
-        CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load notification store data for module '%s'.", module_name);
-        if (NULL == main_tree) {
-            main_tree = data_tree;
+        if (sr_str_ends_with(file_list->data[i], NP_NOTIF_LEGACY_FILE_EXT)) {
+            rc = np_legacy_store_load(np_ctx, rp_session, file_list->data[i], xpath, start_time, effective_stop_time,
+                    api_variant, notif_list);
         } else {
-            ret = lyd_merge(main_tree, data_tree, LYD_OPT_DESTRUCT);
-            CHECK_ZERO_LOG_GOTO(ret, rc, SR_ERR_INTERNAL, cleanup, "Unable to merge notification trees: %s", ly_errmsg());
+            rc = np_notif_segment_load(np_ctx, rp_session, file_list->data[i], xpath, start_time, effective_stop_time,
+                    api_variant, notif_list);
         }
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load notification store data for module '%s'.", module_name);
     }
 
-    /* get all notifications matching the xpath */
-    snprintf(req_xpath, PATH_MAX, NP_NS_XPATH_NOTIFICATION_BY_XPATH, xpath);
-    node_set = lyd_find_xpath(main_tree, req_xpath);
-
-    if (NULL != node_set && node_set->number > 0) {
-        /* init the notification list */
-        rc = sr_list_init(&notif_list);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to initialize notification list.");
-
-        for (size_t i = 0; i < node_set->number; i++) {
-            /* allocate a new notification entry */
-            notification = calloc(1, sizeof(*notification));
-            CHECK_NULL_NOMEM_GOTO(notification, rc, cleanup);
-            /* fill in the notification details */
-            rc = np_event_notification_entry_fill(notification, node_set->set.d[i]->child);
-            CHECK_RC_MSG_GOTO(rc, cleanup, "Error by filling a notification entry.");
-
-            /* filter out notifications not exactly matching the time interval */
-            if (notification->timestamp < start_time || notification->timestamp > effective_stop_time) {
-                np_event_notification_cleanup(notification);
-                notification = NULL;
-                continue;
-            }
-
-            /* parse notification data */
-            rc = dm_parse_event_notif(np_ctx->rp_ctx->dm_ctx, rp_session->dm_session, NULL, notification, api_variant);
-            CHECK_RC_LOG_GOTO(rc, cleanup, "Error by parsing notification '%s'.", notification->xpath);
-
-            SR_LOG_DBG("Adding a new notification: '%s' (time=%ld)", notification->xpath, notification->timestamp);
-
-            /* add the notification into notification list */
-            rc = sr_list_add(notif_list, notification);
-            CHECK_RC_MSG_GOTO(rc, cleanup, "Error by adding notification into list.");
-            notification = NULL;
-        }
+    if (0 == notif_list->count) {
+        sr_list_cleanup(notif_list);
+        notif_list = NULL;
     }
 
     *notifications = notif_list;
     notif_list = NULL;
 
 cleanup:
-    np_event_notification_cleanup(notification);
     if (NULL != notif_list) {
         /* in case of error */
         for (size_t i = 0; i < notif_list->count; i++) {
@@ -1758,8 +2166,6 @@ cleanup:
         }
         sr_list_cleanup(notif_list);
     }
-    ly_set_free(node_set);
-    lyd_free_withsiblings(main_tree);
     sr_free_list_of_strings(file_list);
     free(module_name);
     return rc;
@@ -1778,6 +2184,8 @@ int
 np_notification_store_cleanup(np_ctx_t *np_ctx, bool reschedule)
 {
     sr_list_t *file_list = NULL;
+    char data_filename[PATH_MAX] = { 0, };
+    char *filename = NULL;
     int ret = 0, rc = SR_ERR_OK;
 
     CHECK_NULL_ARG(np_ctx);
@@ -1790,11 +2198,26 @@ np_notification_store_cleanup(np_ctx_t *np_ctx, bool reschedule)
     rc = np_get_all_notification_files(np_ctx, 0, (time(NULL) - (SR_NOTIF_AGE_TIMEOUT * 60)), file_list);
 
     for (size_t i = 0; i < file_list->count; i++) {
-        SR_LOG_DBG("Deleting old notification data file '%s'.", (char*)file_list->data[i]);
-        ret = unlink((char*)file_list->data[i]);
+        filename = (char*)file_list->data[i];
+        if (sr_str_ends_with(filename, NP_NOTIF_DATA_FILE_EXT)) {
+            /* data files are dropped together with their segment index */
+            continue;
+        }
+        if (sr_str_ends_with(filename, NP_NOTIF_INDEX_FILE_EXT)) {
+            /* drop the whole segment, readers consider a segment without the data file to be empty */
+            snprintf(data_filename, PATH_MAX, "%.*s%s", (int)(strlen(filename) - strlen(NP_NOTIF_INDEX_FILE_EXT)),
+                    filename, NP_NOTIF_DATA_FILE_EXT);
+            SR_LOG_DBG("Deleting old notification store segment '%s'.", data_filename);
+            ret = unlink(data_filename);
+            if (-1 == ret && ENOENT != errno) {
+                SR_LOG_WRN("Unable to delete notification data file '%s': %s.", data_filename, sr_strerror_safe(errno));
+                continue;
+            }
+        }
+        SR_LOG_DBG("Deleting old notification data file '%s'.", filename);
+        ret = unlink(filename);
         if (-1 == ret) {
-            SR_LOG_WRN("Unable to delete notification data file '%s': %s.",
-                    (char*)file_list->data[i], sr_strerror_safe(ret));
+            SR_LOG_WRN("Unable to delete notification data file '%s': %s.", filename, sr_strerror_safe(errno));
         }
     }
 
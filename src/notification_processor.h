@@ -55,6 +55,8 @@ typedef struct np_subscription_s {
     uint32_t priority;                 /**< Priority of the subscription by delivering notifications (0 is the lowest priority). */
     bool enable_running;               /**< TRUE if the subscription enables specified subtree in the running datastore. */
     bool enable_nacm;                  /**< TRUE if the NETCONF Access Control is enabled for this subscription. */
+    bool inline_changes;               /**< TRUE if the changes should be sent together with the change notifications. */
+    uint32_t dp_cache_ttl;             /**< Seconds for which the data provided by the subscriber can be cached (0 = no caching). */
     sr_api_variant_t api_variant;      /**< API variant -- values vs. trees (relevant for the callback type only). */
     size_t copy_cnt;                   /**< Count of other references to the primary structure. 0 means no other copies exist. */
 } np_subscription_t;
@@ -111,6 +113,7 @@ typedef enum np_subscr_flag_e {
     NP_SUBSCR_ENABLE_RUNNING = 1,
     NP_SUBSCR_EXCLUSIVE = 2,
     NP_SUBSCR_EV_EVENT = 4,
+    NP_SUBSCR_INLINE_CHANGES = 8,
 } np_subscr_flag_t;
 
 /**
@@ -119,6 +122,11 @@ typedef enum np_subscr_flag_e {
  */
 typedef uint32_t np_subscr_options_t;
 
+/**
+ * @brief Position of the operational data cache TTL (in seconds) within ::np_subscr_options_t.
+ */
+#define NP_SUBSCR_DP_CACHE_TTL_SHIFT 16
+
 /**
  * @brief Subscribe the client to notifications on specified event.
  *
@@ -241,22 +249,30 @@ int np_get_data_provider_subscriptions(np_ctx_t *np_ctx, const rp_session_t *rp_
  * @param[in] subscription Subscription context acquired by ::np_get_module_change_subscriptions call.
  * @param[in] type of event to be sent to subscription
  * @param[in] commit_id ID of the commit to be used for starting a new notification session from client library.
+ * @param[in] changes Changes matching the subscription to be sent together with the notification (list of sr_change_t),
+ * NULL if the subscriber should retrieve them using GET_CHANGES requests.
  *
  * @return Error code (SR_ERR_OK on success).
  */
-int np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_notif_event_t event, uint32_t commit_id);
+int np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_notif_event_t event, uint32_t commit_id,
+        sr_list_t *changes);
 
 /**
  * @brief Request operational data from a data provider subscription.
  *
+ * All xpaths are requested within one message, the data provider replies with one response
+ * containing the data of all of them.
+ *
  * @param[in] np_ctx Notification Processor context acquired by ::np_init call.
  * @param[in] subscription Subscription context acquired by ::np_get_data_provider_subscriptions call.
  * @param[in] session Request Processor session that is requesting the data.
- * @param[in] xpath XPath identifying requested operational data subtree.
+ * @param[in] xpaths XPaths identifying requested operational data subtrees.
+ * @param[in] xpath_cnt Number of xpaths in the array.
  *
  * @return Error code (SR_ERR_OK on success).
  */
-int np_data_provider_request(np_ctx_t *np_ctx, np_subscription_t *subscription, rp_session_t *session, const char *xpath);
+int np_data_provider_request(np_ctx_t *np_ctx, np_subscription_t *subscription, rp_session_t *session,
+        char **xpaths, size_t xpath_cnt);
 
 /**
  * @brief Notify NP that all notifications has been sent to the given subscribers.
@@ -53,6 +53,8 @@
 #define PM_XPATH_SUBSCRIPTION_PRIORITY        PM_XPATH_SUBSCRIPTION      "/priority"
 #define PM_XPATH_SUBSCRIPTION_ENABLE_RUNNING  PM_XPATH_SUBSCRIPTION      "/enable-running"
 #define PM_XPATH_SUBSCRIPTION_ENABLE_NACM     PM_XPATH_SUBSCRIPTION      "/enable-nacm"
+#define PM_XPATH_SUBSCRIPTION_INLINE_CHANGES  PM_XPATH_SUBSCRIPTION      "/inline-changes"
+#define PM_XPATH_SUBSCRIPTION_DP_CACHE_TTL    PM_XPATH_SUBSCRIPTION      "/dp-cache-ttl"
 #define PM_XPATH_SUBSCRIPTION_API_VARIANT     PM_XPATH_SUBSCRIPTION      "/api-variant"
 
 #define PM_XPATH_SUBSCRIPTIONS_BY_TYPE        PM_XPATH_SUBSCRIPTION_LIST "[type='%s']"
@@ -73,29 +75,71 @@ typedef struct pm_ctx_s {
     const struct lys_module *schema;    /**< Schema tree of sysrepo-persistent-data YANG. */
     const char *data_search_dir;        /**< Directory containing the data files. */
     sr_locking_set_t *lock_ctx;         /**< Context for locking persist data files. */
-    sr_btree_t *module_data;            /**< Binary tree holding cached data of a module. */
+    sr_btree_t *module_data;            /**< Binary tree holding in-memory subscriptions of the modules. */
     pthread_rwlock_t module_data_lock;  /**< RW lock for accessing ::module_data. */
 } pm_ctx_t;
 
+/**
+ * @brief Version of a persist data file, used to detect changes made by other processes.
+ */
+typedef struct pm_file_version_s {
+    uint64_t timestamp;         /**< Timestamp of the data file (0 if the file does not exist). */
+    bool use_xattr;             /**< Use file extended attributes to store timestamp. */
+} pm_file_version_t;
+
 /**
  * @brief PM module data info structure.
+ *
+ * Subscriptions of the module held in memory are authoritative within this process, changes made by
+ * subscribe / unsubscribe requests are applied to them immediately and recorded in the list of pending
+ * operations. The request then waits until its operation is written into the persist file: the first waiting
+ * request writes all pending operations of the module in one batch (see ::pm_module_data_sync), the requests
+ * whose operations were recorded in the meantime wait for it and form the next batch (see ::pm_module_data_commit).
+ * The subscriptions are reloaded from the persist file only if it has been modified by another process.
  */
 typedef struct pm_module_data_s {
     const char *module_name;    /**< Name of the module. */
-    sr_list_t *cached_data;     /**< Cached data of the module. */
-    uint64_t timestamp;         /**< Timestamp of the cached data file. */
-    bool use_xattr;             /**< Use file extended attributes to store timestamp. */
-
+    sr_list_t *subscriptions;   /**< Subscriptions of the module, grouped by the subscription type (::pm_subscription_set_t). */
+    bool loaded;                /**< Flag whether the subscriptions have been loaded from the persist file. */
+    pm_file_version_t version;  /**< Version of the persist file the subscriptions correspond to. */
+    sr_list_t *pending_ops;     /**< Operations not yet written into the persist file (::pm_subscription_op_t). */
+    uint64_t last_seq;          /**< Sequence number of the last recorded operation. */
+    pthread_mutex_t sync_lock;  /**< Serializes the access to the persist file of the module within this process. */
+    pthread_mutex_t commit_lock;/**< Guards the state of the batches written into the persist file (commit_* members). */
+    pthread_cond_t commit_cond; /**< Signaled when a batch has been written into the persist file. */
+    bool committing;            /**< Flag whether a request is writing a batch into the persist file. */
+    uint64_t commit_seq;        /**< Sequence number of the last operation of the last finished batch. */
+    uint64_t failed_first;      /**< Sequence number of the first operation of the last failed batch, 0 if none. */
+    uint64_t failed_last;       /**< Sequence number of the last operation of the last failed batch. */
+    int failed_rc;              /**< Error code of the last failed batch. */
 } pm_module_data_t;
 
 /**
- * @brief Structure used to store cached data of a module.
+ * @brief Subscriptions of one type within a module.
+ */
+typedef struct pm_subscription_set_s {
+    Sr__SubscriptionType subscription_type;  /**< Type of the subscriptions in this set. */
+    sr_list_t *subscriptions;                /**< List of the subscriptions (::np_subscription_t). */
+} pm_subscription_set_t;
+
+/**
+ * @brief Type of the operation with persistent subscriptions.
+ */
+typedef enum pm_subscription_op_type_e {
+    PM_SUBSCRIPTION_ADD,            /**< Add a subscription. */
+    PM_SUBSCRIPTION_ADD_EXCLUSIVE,  /**< Add a subscription, remove the subscriptions with the same type and xpath. */
+    PM_SUBSCRIPTION_REMOVE,         /**< Remove the subscription with matching type, destination address and ID. */
+    PM_SUBSCRIPTION_REMOVE_DST,     /**< Remove all subscriptions with matching destination address. */
+} pm_subscription_op_type_t;
+
+/**
+ * @brief Operation with persistent subscriptions waiting to be written into the persist file.
  */
-typedef struct pm_cached_data_s {
-    Sr__SubscriptionType subscription_type;  /**< Type of the subscriptions that are cached in this entry. */
-    sr_list_t *subscriptions;                /**< List of the cached subscriptions. */
-    bool valid;                              /**< Flag that marks whether the cached data is valid or invalidated. */
-} pm_cached_data_t;
+typedef struct pm_subscription_op_s {
+    pm_subscription_op_type_t type;    /**< Type of the operation. */
+    np_subscription_t *subscription;   /**< Subscription being added, or identification of the removed subscription(s). */
+    uint64_t seq;                      /**< Sequence number of the operation within the module. */
+} pm_subscription_op_t;
 
 /**
  * @brief Compares two module data structures by module name.
@@ -118,6 +162,48 @@ pm_module_data_cmp(const void *a, const void *b)
     }
 }
 
+/**
+ * @brief Frees the operation with persistent subscriptions.
+ */
+static void
+pm_subscription_op_free(pm_subscription_op_t *op)
+{
+    if (NULL != op) {
+        np_subscription_cleanup(op->subscription);
+        free(op);
+    }
+}
+
+/**
+ * @brief Frees the list of operations with persistent subscriptions.
+ */
+static void
+pm_subscription_ops_cleanup(sr_list_t *ops)
+{
+    if (NULL != ops) {
+        for (size_t i = 0; i < ops->count; i++) {
+            pm_subscription_op_free(ops->data[i]);
+        }
+        sr_list_cleanup(ops);
+    }
+}
+
+/**
+ * @brief Removes all subscriptions held in memory for the module.
+ */
+static void
+pm_module_data_clear(pm_module_data_t *md)
+{
+    pm_subscription_set_t *set = NULL;
+
+    for (size_t i = 0; i < md->subscriptions->count; i++) {
+        set = md->subscriptions->data[i];
+        np_subscriptions_list_cleanup(set->subscriptions);
+        free(set);
+    }
+    md->subscriptions->count = 0;
+}
+
 /**
  * @brief Cleans up the module data structure.
  */
@@ -125,19 +211,17 @@ static void
 pm_free_module_data(void *module_data)
 {
     pm_module_data_t *md = (pm_module_data_t *) module_data;
-    pm_cached_data_t *cd = NULL;
 
     CHECK_NULL_ARG_VOID(md);
 
-    /* cleanup cached_data */
-    for (size_t i = 0; i < md->cached_data->count; i++) {
-        cd = md->cached_data->data[i];
-        if (cd->valid) {
-            np_subscriptions_list_cleanup(cd->subscriptions);
-        }
-        free(cd);
+    if (NULL != md->subscriptions) {
+        pm_module_data_clear(md);
+        sr_list_cleanup(md->subscriptions);
     }
-    sr_list_cleanup(md->cached_data);
+    pm_subscription_ops_cleanup(md->pending_ops);
+    pthread_mutex_destroy(&md->sync_lock);
+    pthread_mutex_destroy(&md->commit_lock);
+    pthread_cond_destroy(&md->commit_cond);
 
     free((void*)md->module_name);
     free(md);
@@ -194,22 +278,16 @@ pm_cleanup_data_tree(pm_ctx_t *pm_ctx, struct lyd_node *data_tree, int fd)
 }
 
 /**
- * @brief Loads the data tree of persistent data file tied to specified YANG module.
+ * @brief Opens the persistent data file as the proper user, creates it if it does not exist
+ * and read-write access has been requested.
  */
 static int
-pm_load_data_tree(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *module_name,
-        bool read_only, struct lyd_node **data_tree, int *fd_p)
+pm_open_data_file(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *data_filename, bool read_only, int *fd_p)
 {
-    char *data_filename = NULL;
     int fd = -1;
     int rc = SR_ERR_OK;
     int error = 0;
 
-    CHECK_NULL_ARG4(pm_ctx, pm_ctx->rp_ctx, module_name, data_tree);
-
-    rc = sr_get_persist_data_file_name(pm_ctx->data_search_dir, module_name, &data_filename);
-    CHECK_RC_LOG_RETURN(rc, "Unable to compose persist data file name for '%s'.", module_name);
-
     /* open the file as the proper user */
     if (NULL != user_cred) {
         ac_set_user_identity(pm_ctx->rp_ctx->ac_ctx, user_cred);
@@ -227,7 +305,6 @@ pm_load_data_tree(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *mod
         if (ENOENT == error) {
             SR_LOG_DBG("Persist data file '%s' does not exist.", data_filename);
             if (read_only) {
-                SR_LOG_DBG("No persistent data for module '%s' will be loaded.", module_name);
                 rc = SR_ERR_DATA_MISSING;
             } else {
                 /* create new persist file */
@@ -246,9 +323,34 @@ pm_load_data_tree(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *mod
             SR_LOG_ERR("Unable to open persist data file '%s': %s.", data_filename, sr_strerror_safe(error));
             rc = SR_ERR_INTERNAL;
         }
-        if (SR_ERR_OK != rc) {
-            goto cleanup;
-        }
+    }
+
+    *fd_p = fd;
+    return rc;
+}
+
+/**
+ * @brief Loads the data tree of persistent data file tied to specified YANG module.
+ */
+static int
+pm_load_data_tree(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *module_name,
+        bool read_only, struct lyd_node **data_tree, int *fd_p)
+{
+    char *data_filename = NULL;
+    int fd = -1;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(pm_ctx, pm_ctx->rp_ctx, module_name, data_tree);
+
+    rc = sr_get_persist_data_file_name(pm_ctx->data_search_dir, module_name, &data_filename);
+    CHECK_RC_LOG_RETURN(rc, "Unable to compose persist data file name for '%s'.", module_name);
+
+    rc = pm_open_data_file(pm_ctx, user_cred, data_filename, read_only, &fd);
+    if (SR_ERR_DATA_MISSING == rc) {
+        SR_LOG_DBG("No persistent data for module '%s' will be loaded.", module_name);
+    }
+    if (SR_ERR_OK != rc) {
+        goto cleanup;
     }
 
     /* lock & load the data tree */
@@ -466,6 +568,12 @@ pm_subscription_entry_fill(const char *module_name, np_subscription_t *subscript
             if (0 == strcmp(node->schema->name, "enable-nacm")) {
                 subscription->enable_nacm = true;
             }
+            if (0 == strcmp(node->schema->name, "inline-changes")) {
+                subscription->inline_changes = true;
+            }
+            if (0 == strcmp(node->schema->name, "dp-cache-ttl") && NULL != node_ll->value_str) {
+                subscription->dp_cache_ttl = atoi(node_ll->value_str);
+            }
             if (0 == strcmp(node->schema->name, "api-variant") && NULL != node_ll->value_str) {
                 subscription->api_variant = sr_api_variant_from_str(node_ll->value_str);
             }
@@ -482,10 +590,10 @@ cleanup:
 }
 
 /**
- * @brief Store persist data file version in the module_data context.
+ * @brief Store version of the persist data file.
  */
 static int
-pm_module_data_version_save(pm_ctx_t *pm_ctx, const char *module_name, pm_module_data_t *md)
+pm_file_version_save(pm_ctx_t *pm_ctx, const char *module_name, pm_file_version_t *version)
 {
     char file_name[PATH_MAX] = {0,};
     struct stat file_stat = { 0, };
@@ -496,27 +604,30 @@ pm_module_data_version_save(pm_ctx_t *pm_ctx, const char *module_name, pm_module
 
 #if defined(HAVE_FSETXATTR) && defined(__linux__)
     /* xattr supported, try to read it */
-    ret = getxattr(file_name, PM_XATTR_NAME, &md->timestamp, sizeof(md->timestamp));
+    ret = getxattr(file_name, PM_XATTR_NAME, &version->timestamp, sizeof(version->timestamp));
     if (0 == ret) {
-        md->use_xattr = true;
+        version->use_xattr = true;
     } else {
         /* xattr not present/supported, fallback to stat */
-        md->use_xattr = false;
+        version->use_xattr = false;
     }
 #else
     /* xattr not supported */
-    md->use_xattr = false;
+    version->use_xattr = false;
 #endif
 
-    if (!md->use_xattr) {
+    if (!version->use_xattr) {
         /* use stat to determine modification time */
         ret = stat(file_name, &file_stat);
         if (0 == ret) {
 #ifdef HAVE_STAT_ST_MTIM
-            md->timestamp = (PM_BILLION * file_stat.st_mtim.tv_sec) + file_stat.st_mtim.tv_nsec + file_stat.st_size;
+            version->timestamp = (PM_BILLION * file_stat.st_mtim.tv_sec) + file_stat.st_mtim.tv_nsec + file_stat.st_size;
 #else
-            md->timestamp = file_stat.st_mtime + file_stat.st_size;
+            version->timestamp = file_stat.st_mtime + file_stat.st_size;
 #endif
+        } else if (ENOENT == errno) {
+            /* the file has not been created yet */
+            version->timestamp = 0;
         } else {
             SR_LOG_ERR("Unable to stat file '%s': %s", file_name, sr_strerror_safe(errno));
             rc = SR_ERR_INTERNAL;
@@ -528,10 +639,10 @@ cleanup:
 }
 
 /**
- * @brief Check whether persist file version changed since storing its data in the module_data context.
+ * @brief Check whether persist file version changed since it has been stored by ::pm_file_version_save.
  */
 static int
-pm_module_data_version_changed(pm_ctx_t *pm_ctx, const char *module_name, pm_module_data_t *md, bool *changed)
+pm_file_version_changed(pm_ctx_t *pm_ctx, const char *module_name, const pm_file_version_t *version, bool *changed)
 {
     char file_name[PATH_MAX] = {0,};
     struct stat file_stat = { 0, };
@@ -543,11 +654,11 @@ pm_module_data_version_changed(pm_ctx_t *pm_ctx, const char *module_name, pm_mod
     rc = sr_get_persist_data_file_name_buf(pm_ctx->data_search_dir, module_name, file_name, PATH_MAX);
     CHECK_RC_MSG_RETURN(rc, "Unable to get persist data file name.");
 
-    if (md->use_xattr) {
+    if (version->use_xattr) {
 #if defined(HAVE_FSETXATTR) && defined(__linux__)
         /* use xattr */
         ret = getxattr(file_name, PM_XATTR_NAME, &timestamp, sizeof(timestamp));
-        if (0 == ret && timestamp == md->timestamp) {
+        if (0 == ret && timestamp == version->timestamp) {
             SR_LOG_DBG("Module '%s' version matches with cached one(%"PRIu64")", module_name, timestamp);
             *changed = false;
         }
@@ -558,13 +669,15 @@ pm_module_data_version_changed(pm_ctx_t *pm_ctx, const char *module_name, pm_mod
     } else {
         /* use stat */
         ret = stat(file_name, &file_stat);
-        if (0 == ret) {
+        if (0 == ret || ENOENT == errno) {
+            if (0 == ret) {
 #ifdef HAVE_STAT_ST_MTIM
-            timestamp = (PM_BILLION * file_stat.st_mtim.tv_sec) + file_stat.st_mtim.tv_nsec + file_stat.st_size;
+                timestamp = (PM_BILLION * file_stat.st_mtim.tv_sec) + file_stat.st_mtim.tv_nsec + file_stat.st_size;
 #else
-            timestamp = file_stat.st_mtime + file_stat.st_size;
+                timestamp = file_stat.st_mtime + file_stat.st_size;
 #endif
-            if (timestamp == md->timestamp) {
+            }
+            if (timestamp == version->timestamp) {
                 *changed = false;
             }
         } else {
@@ -583,282 +696,848 @@ pm_module_data_version_changed(pm_ctx_t *pm_ctx, const char *module_name, pm_mod
 }
 
 /**
- * @brief Invalidates cache of subscriptions of given module.
+ * @brief Checks that the user is allowed to modify the persist data file of the module
+ * (creates the file as the user if it does not exist yet).
  */
 static int
-pm_invalidate_cached_subscriptions(pm_ctx_t *pm_ctx, const char *module_name, Sr__SubscriptionType subscription_type,
-        bool all_types)
+pm_check_file_access(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *module_name)
 {
-    pm_module_data_t *md = NULL, lookup_md = {0};
-    pm_cached_data_t *cd = NULL;
-
-    CHECK_NULL_ARG2(pm_ctx, module_name);
-
-    RWLOCK_WRLOCK_TIMED_CHECK_RETURN(&pm_ctx->module_data_lock);
-
-    /* find module data info */
-    lookup_md.module_name = module_name;
-    md = sr_btree_search(pm_ctx->module_data, &lookup_md);
+    char file_name[PATH_MAX] = {0,};
+    int fd = -1;
+    int rc = SR_ERR_OK;
 
-    if (NULL == md) {
-        /* module data does not exist */
-        pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+    if (NULL == user_cred) {
         return SR_ERR_OK;
     }
 
-    /* find cached info of given type */
-    for (size_t i = 0; i < md->cached_data->count; i++) {
-        cd = md->cached_data->data[i];
-        if (cd->valid) {
-            if (all_types || (cd->subscription_type == subscription_type)) {
-                cd->valid = false;
-                np_subscriptions_list_cleanup(cd->subscriptions);
-                cd->subscriptions = NULL;
-                if (!all_types) {
-                    break;
-                }
-            }
-        }
+    rc = sr_get_persist_data_file_name_buf(pm_ctx->data_search_dir, module_name, file_name, PATH_MAX);
+    CHECK_RC_MSG_RETURN(rc, "Unable to get persist data file name.");
+
+    rc = pm_open_data_file(pm_ctx, user_cred, file_name, false, &fd);
+    if (-1 != fd) {
+        close(fd);
     }
 
-    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+    return rc;
+}
 
-    return SR_ERR_OK;
+/**
+ * @brief Returns true if both strings are set and equal.
+ */
+static bool
+pm_str_equal(const char *a, const char *b)
+{
+    return (NULL != a) && (NULL != b) && (0 == strcmp(a, b));
 }
 
 /**
- * @brief Return cached subscriptions of requested module and type, if present in the cache.
+ * @brief Duplicates the details of the subscription that are stored in the persist data file.
  */
 static int
-pm_get_cached_subscriptions(pm_ctx_t *pm_ctx, const char *module_name, Sr__SubscriptionType subscription_type,
-        sr_list_t **subscriptions_p, bool *cache_hit)
+pm_subscription_dup(const char *module_name, const np_subscription_t *subscription, np_subscription_t **dup_p)
 {
-    pm_module_data_t *md = NULL, lookup_md = {0};
-    pm_cached_data_t *cd = NULL, *lookup_cd = NULL;
-    sr_list_t *res_subscriptions = NULL;
-    np_subscription_t *subscription = NULL;
-    bool data_changed = false;
+    np_subscription_t *dup = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG4(pm_ctx, module_name, subscriptions_p, cache_hit);
-
-    *cache_hit = false;
+    CHECK_NULL_ARG3(module_name, subscription, dup_p);
 
-    RWLOCK_RDLOCK_TIMED_CHECK_RETURN(&pm_ctx->module_data_lock);
+    dup = calloc(1, sizeof(*dup));
+    CHECK_NULL_NOMEM_RETURN(dup);
 
-    /* find module data info */
-    lookup_md.module_name = module_name;
-    md = sr_btree_search(pm_ctx->module_data, &lookup_md);
+    dup->type = subscription->type;
+    dup->dst_id = subscription->dst_id;
+    dup->enable_running = subscription->enable_running;
 
-    if (NULL == md) {
-        /* module data does not exist */
-        goto cleanup;
+    dup->module_name = strdup(module_name);
+    CHECK_NULL_NOMEM_GOTO(dup->module_name, rc, cleanup);
+    if (NULL != subscription->dst_address) {
+        dup->dst_address = strdup(subscription->dst_address);
+        CHECK_NULL_NOMEM_GOTO(dup->dst_address, rc, cleanup);
     }
-
-    /* check whether data hasn't changed in the meantime */
-    rc = pm_module_data_version_changed(pm_ctx, module_name, md, &data_changed);
-    CHECK_RC_MSG_GOTO(rc, cleanup, "Cached module data version check failed.");
-
-    if (data_changed) {
-        /* data has changed */
-        goto cleanup;
+    if (NULL != subscription->xpath) {
+        dup->xpath = strdup(subscription->xpath);
+        CHECK_NULL_NOMEM_GOTO(dup->xpath, rc, cleanup);
     }
-
-    /* find cached info of given type */
-    for (size_t i = 0; i < md->cached_data->count; i++) {
-        lookup_cd = md->cached_data->data[i];
-        if (lookup_cd->subscription_type == subscription_type) {
-            cd = lookup_cd;
-            break;
+    if (SR__SUBSCRIPTION_TYPE__EVENT_NOTIF_SUBS == subscription->type) {
+        if (NULL != subscription->username) {
+            dup->username = strdup(subscription->username);
+            CHECK_NULL_NOMEM_GOTO(dup->username, rc, cleanup);
         }
+        dup->enable_nacm = subscription->enable_nacm;
     }
-
-    if (NULL == cd) {
-        /* cached info of given type does not exist */
-        goto cleanup;
+    if (SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS == subscription->type ||
+            SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS == subscription->type) {
+        dup->notif_event = subscription->notif_event;
+        dup->inline_changes = subscription->inline_changes;
+        dup->priority = subscription->priority;
     }
-
-    if (!cd->valid) {
-        /* cache is invalid */
-        goto cleanup;
+    if (SR__SUBSCRIPTION_TYPE__DP_GET_ITEMS_SUBS == subscription->type) {
+        dup->dp_cache_ttl = subscription->dp_cache_ttl;
     }
-
-    if (NULL != cd->subscriptions) {
-        rc = sr_list_init(&res_subscriptions);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to initialize subscriptions list.");
-
-        for (size_t i = 0; i < cd->subscriptions->count; i++) {
-            subscription = cd->subscriptions->data[i];
-
-            rc = sr_list_add(res_subscriptions, subscription);
-            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add a subscription into the subscription list.");
-
-            /* increase copy refcount */
-            subscription->copy_cnt += 1;
-        }
+    if (SR__SUBSCRIPTION_TYPE__RPC_SUBS == subscription->type ||
+            SR__SUBSCRIPTION_TYPE__EVENT_NOTIF_SUBS == subscription->type ||
+            SR__SUBSCRIPTION_TYPE__ACTION_SUBS == subscription->type) {
+        dup->api_variant = subscription->api_variant;
     }
 
-    *subscriptions_p = res_subscriptions;
-    res_subscriptions = NULL;
-    *cache_hit = true;
+    *dup_p = dup;
+    return SR_ERR_OK;
 
 cleanup:
-    if (NULL != res_subscriptions) {
-        np_subscriptions_list_cleanup(res_subscriptions);
-    }
-    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
-
-    if (data_changed) {
-        pm_invalidate_cached_subscriptions(pm_ctx, module_name, subscription_type, true);
-    }
-
+    np_subscription_cleanup(dup);
     return rc;
 }
 
 /**
- * @brief Store the subscriptions in the cache.
+ * @brief Allocates a new operation with persistent subscriptions.
  */
 static int
-pm_cache_subscriptions(pm_ctx_t *pm_ctx, const char *module_name, Sr__SubscriptionType subscription_type,
-        sr_list_t *orig_subscriptions)
+pm_subscription_op_new(const char *module_name, pm_subscription_op_type_t type, const np_subscription_t *subscription,
+        pm_subscription_op_t **op_p)
 {
-    pm_module_data_t *md = NULL, *md_tmp = NULL, lookup_md = {0};
-    pm_cached_data_t *cd = NULL, *cd_tmp = NULL, *lookup_cd = NULL;
-    sr_list_t *cached_subscriptions = NULL;
-    np_subscription_t *subscription = NULL;
+    pm_subscription_op_t *op = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG2(pm_ctx, module_name);
-
-    RWLOCK_WRLOCK_TIMED_CHECK_RETURN(&pm_ctx->module_data_lock);
+    op = calloc(1, sizeof(*op));
+    CHECK_NULL_NOMEM_RETURN(op);
 
-    /* find module data info */
-    lookup_md.module_name = module_name;
-    md = sr_btree_search(pm_ctx->module_data, &lookup_md);
+    op->type = type;
+    rc = pm_subscription_dup(module_name, subscription, &op->subscription);
+    if (SR_ERR_OK != rc) {
+        free(op);
+        return rc;
+    }
 
-    if (NULL == md) {
-        /* module data does not exist, create it */
-        md_tmp = calloc(1, sizeof(*md));
-        CHECK_NULL_NOMEM_GOTO(md_tmp, rc, cleanup);
+    *op_p = op;
+    return SR_ERR_OK;
+}
 
-        md_tmp->module_name = strdup(module_name);
-        CHECK_NULL_NOMEM_GOTO(md_tmp->module_name, rc, cleanup);
+/**
+ * @brief Returns the set of in-memory subscriptions of given type, NULL if there is none.
+ */
+static pm_subscription_set_t *
+pm_module_data_get_set(pm_module_data_t *md, Sr__SubscriptionType type)
+{
+    pm_subscription_set_t *set = NULL;
 
-        rc = sr_list_init(&md_tmp->cached_data);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Cached data list init failed.");
+    for (size_t i = 0; i < md->subscriptions->count; i++) {
+        set = md->subscriptions->data[i];
+        if (set->subscription_type == type) {
+            return set;
+        }
+    }
 
-        rc = sr_btree_insert(pm_ctx->module_data, md_tmp);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Module data btree insert failed.");
+    return NULL;
+}
 
-        md = md_tmp;
-        md_tmp = NULL;
-    }
+/**
+ * @brief Adds the subscription into the in-memory subscriptions of the module. The module data takes
+ * over one reference to the subscription.
+ */
+static int
+pm_module_data_add_subscription(pm_module_data_t *md, np_subscription_t *subscription)
+{
+    pm_subscription_set_t *set = NULL;
+    int rc = SR_ERR_OK;
 
-    /* save file version info */
-    pm_module_data_version_save(pm_ctx, module_name, md);
+    set = pm_module_data_get_set(md, subscription->type);
+    if (NULL == set) {
+        set = calloc(1, sizeof(*set));
+        CHECK_NULL_NOMEM_RETURN(set);
+        set->subscription_type = subscription->type;
 
-    /* find cached info of given type */
-    for (size_t i = 0; i < md->cached_data->count; i++) {
-        lookup_cd = md->cached_data->data[i];
-        if (lookup_cd->subscription_type == subscription_type) {
-            cd = lookup_cd;
-            break;
+        rc = sr_list_init(&set->subscriptions);
+        if (SR_ERR_OK == rc) {
+            rc = sr_list_add(md->subscriptions, set);
+        }
+        if (SR_ERR_OK != rc) {
+            sr_list_cleanup(set->subscriptions);
+            free(set);
+            SR_LOG_ERR_MSG("Unable to create a new set of subscriptions.");
+            return rc;
         }
     }
 
-    if (NULL == cd) {
-        /* cached info of given type does not exist, create it */
-        cd_tmp = calloc(1, sizeof(*cd_tmp));
-        CHECK_NULL_NOMEM_GOTO(cd_tmp, rc, cleanup);
+    rc = sr_list_add(set->subscriptions, subscription);
+    CHECK_RC_MSG_RETURN(rc, "Unable to add the subscription into the set of subscriptions.");
+
+    return SR_ERR_OK;
+}
 
-        cd_tmp->subscription_type = subscription_type;
+/**
+ * @brief Applies the operation on the in-memory subscriptions of the module.
+ *
+ * @return SR_ERR_DATA_EXISTS if the added subscription already exists, SR_ERR_DATA_MISSING
+ * if no subscription has been removed, the subscriptions are left untouched in both cases.
+ */
+static int
+pm_module_data_apply_op(pm_module_data_t *md, const pm_subscription_op_t *op, bool *running_affected)
+{
+    const np_subscription_t *op_subscription = op->subscription;
+    pm_subscription_set_t *set = NULL;
+    np_subscription_t *subscription = NULL;
+    bool exclusive = (PM_SUBSCRIPTION_ADD_EXCLUSIVE == op->type), match = false, found = false;
+    int rc = SR_ERR_OK;
 
-        rc = sr_list_add(md->cached_data, cd_tmp);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Cached data add failed.");
+    if (PM_SUBSCRIPTION_ADD == op->type || PM_SUBSCRIPTION_ADD_EXCLUSIVE == op->type) {
+        set = pm_module_data_get_set(md, op_subscription->type);
+        /* check for duplicates among the subscriptions that will be kept */
+        for (size_t i = 0; NULL != set && i < set->subscriptions->count; i++) {
+            subscription = set->subscriptions->data[i];
+            if (exclusive && pm_str_equal(subscription->xpath, op_subscription->xpath)) {
+                continue;
+            }
+            if (subscription->dst_id == op_subscription->dst_id &&
+                    pm_str_equal(subscription->dst_address, op_subscription->dst_address)) {
+                SR_LOG_ERR("Subscription of type %s for '%s' @ %"PRIu32" already exists.",
+                        sr_subscription_type_gpb_to_str(op_subscription->type), op_subscription->dst_address,
+                        op_subscription->dst_id);
+                return SR_ERR_DATA_EXISTS;
+            }
+        }
+        /* remove the subscriptions replaced by an exclusive one */
+        for (size_t i = 0; exclusive && NULL != set && i < set->subscriptions->count; ) {
+            subscription = set->subscriptions->data[i];
+            if (pm_str_equal(subscription->xpath, op_subscription->xpath)) {
+                sr_list_rm_at(set->subscriptions, i);
+                np_subscription_cleanup(subscription);
+            } else {
+                i++;
+            }
+        }
+        /* the module data holds its own reference to the subscription */
+        op->subscription->copy_cnt += 1;
+        rc = pm_module_data_add_subscription(md, op->subscription);
+        if (SR_ERR_OK != rc) {
+            op->subscription->copy_cnt -= 1;
+        }
+        return rc;
+    }
 
-        cd = cd_tmp;
-        cd_tmp = NULL;
+    /* remove the subscriptions */
+    for (size_t i = 0; i < md->subscriptions->count; i++) {
+        set = md->subscriptions->data[i];
+        if (PM_SUBSCRIPTION_REMOVE == op->type && set->subscription_type != op_subscription->type) {
+            continue;
+        }
+        for (size_t j = 0; j < set->subscriptions->count; ) {
+            subscription = set->subscriptions->data[j];
+            match = pm_str_equal(subscription->dst_address, op_subscription->dst_address);
+            if (PM_SUBSCRIPTION_REMOVE == op->type) {
+                match = match && (subscription->dst_id == op_subscription->dst_id);
+            }
+            if (match) {
+                if (NULL != running_affected && subscription->enable_running) {
+                    *running_affected = true;
+                }
+                sr_list_rm_at(set->subscriptions, j);
+                np_subscription_cleanup(subscription);
+                found = true;
+            } else {
+                j++;
+            }
+        }
     }
 
-    SR_LOG_DBG("Caching %zu subscriptions from '%s' persist file.",
-            (NULL != orig_subscriptions) ? orig_subscriptions->count : 0, module_name);
+    if (!found) {
+        SR_LOG_DBG("No subscription for '%s' to be removed from module '%s'.", op_subscription->dst_address,
+                md->module_name);
+        rc = SR_ERR_DATA_MISSING;
+    }
 
-    /* fill in the list of pointers to subscriptions & store it in the cache */
-    if (NULL != orig_subscriptions) {
-        rc = sr_list_init(&cached_subscriptions);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to initialize cached subscriptions list.");
+    return rc;
+}
 
-        for (size_t i = 0; i < orig_subscriptions->count; i++) {
-            subscription = orig_subscriptions->data[i];
+/**
+ * @brief Applies the operation on the in-memory subscriptions of the module and records it to be written
+ * into the persist file. The operation is taken over by the module data on success, its sequence number
+ * is assigned to be waited for by ::pm_module_data_commit.
+ */
+static int
+pm_module_data_add_op(pm_module_data_t *md, pm_subscription_op_t *op, bool *running_affected)
+{
+    int rc = SR_ERR_OK;
 
-            rc = sr_list_add(cached_subscriptions, subscription);
-            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add a subscription into the cache list.");
+    /* record the operation first, so that the applied operation can not get lost */
+    if (NULL == md->pending_ops) {
+        rc = sr_list_init(&md->pending_ops);
+        CHECK_RC_MSG_RETURN(rc, "Unable to initialize the list of pending operations.");
+    }
+    rc = sr_list_add(md->pending_ops, op);
+    CHECK_RC_MSG_RETURN(rc, "Unable to record the operation with persistent subscriptions.");
+    op->seq = ++md->last_seq;
 
-            /* increase copy refcount */
-            subscription->copy_cnt += 1;
+    rc = pm_module_data_apply_op(md, op, running_affected);
+    if (SR_ERR_OK != rc) {
+        /* nothing to be written into the persist file */
+        sr_list_rm_at(md->pending_ops, md->pending_ops->count - 1);
+        if (0 == md->pending_ops->count) {
+            sr_list_cleanup(md->pending_ops);
+            md->pending_ops = NULL;
         }
+        md->last_seq--;
     }
 
-    cd->valid = true;
-    cd->subscriptions = cached_subscriptions;
-    cached_subscriptions = NULL;
+    return rc;
+}
 
-cleanup:
-    if (NULL != cached_subscriptions) {
-        np_subscriptions_list_cleanup(cached_subscriptions);
-    }
-    if (NULL != md_tmp) {
-        sr_list_cleanup(md_tmp->cached_data);
-        free((void*)md_tmp->module_name);
-        free(md_tmp);
-    }
-    if (NULL != cd_tmp) {
-        free(cd_tmp);
+/**
+ * @brief Returns true if some of the in-memory subscriptions of the module enable running datastore.
+ */
+static bool
+pm_module_data_running_enabled(pm_module_data_t *md)
+{
+    pm_subscription_set_t *set = NULL;
+    np_subscription_t *subscription = NULL;
+
+    for (size_t i = 0; i < md->subscriptions->count; i++) {
+        set = md->subscriptions->data[i];
+        for (size_t j = 0; j < set->subscriptions->count; j++) {
+            subscription = set->subscriptions->data[j];
+            if (subscription->enable_running) {
+                return true;
+            }
+        }
     }
-    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
 
-    return rc;
+    return false;
 }
 
 /**
- * @brief Checks whether there are some subscriptions that enable running datastore
- * within the data tree.
+ * @brief Replaces the in-memory subscriptions of the module with the subscriptions from the persist data tree.
  */
 static int
-pm_dt_has_running_enable_susbscriptions(struct lyd_node *data_tree, const char *module_name, bool *result)
+pm_module_data_load(pm_module_data_t *md, struct lyd_node *data_tree)
 {
     char xpath[PATH_MAX] = { 0, };
     struct ly_set *node_set = NULL;
+    np_subscription_t *subscription = NULL;
+    int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG3(data_tree, module_name, result);
+    pm_module_data_clear(md);
 
-    snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTIONS_WITH_E_RUNNING, module_name);
+    if (NULL == data_tree) {
+        /* empty data file */
+        return SR_ERR_OK;
+    }
+
+    snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_LIST, md->module_name);
     node_set = lyd_find_xpath(data_tree, xpath);
-    if (NULL == node_set || 0 == node_set->number) {
-        *result = false;
-    } else {
-        *result = true;
+
+    for (size_t i = 0; NULL != node_set && i < node_set->number; i++) {
+        subscription = calloc(1, sizeof(*subscription));
+        CHECK_NULL_NOMEM_GOTO(subscription, rc, cleanup);
+
+        rc = pm_subscription_entry_fill(md->module_name, subscription, node_set->set.d[i]->child);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to fill subscription details.");
+
+        rc = pm_module_data_add_subscription(md, subscription);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add the subscription into module data.");
+        subscription = NULL;
     }
 
+    SR_LOG_DBG("%zu subscriptions loaded from '%s' persist file.", (NULL != node_set) ? node_set->number : 0,
+            md->module_name);
+
+cleanup:
     if (NULL != node_set) {
         ly_set_free(node_set);
     }
-
-    return SR_ERR_OK;
+    np_subscription_cleanup(subscription);
+    return rc;
 }
 
-int
-pm_init(rp_ctx_t *rp_ctx, const char *schema_search_dir, const char *data_search_dir, pm_ctx_t **pm_ctx)
+/**
+ * @brief Adds the subscription into the persist data tree.
+ */
+static int
+pm_subscription_add_to_tree(pm_ctx_t *pm_ctx, const char *module_name, const np_subscription_t *subscription,
+        bool exclusive, struct lyd_node **data_tree)
 {
-    pm_ctx_t *ctx = NULL;
-    char *schema_filename = NULL;
-    pthread_rwlockattr_t attr;
+    char xpath[PATH_MAX] = { 0, }, buff[15] = { 0, };
+    const char *value = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG4(rp_ctx, schema_search_dir, data_search_dir, pm_ctx);
-
-    /* allocate and initialize the context */
-    ctx = calloc(1, sizeof(*ctx));
+    if (exclusive) {
+        /* first, delete existing subscriptions of given type */
+        SR_LOG_DBG("Removing all existing %s subscriptions from '%s' persist data tree.",
+                sr_subscription_type_gpb_to_str(subscription->type), module_name);
+
+        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTIONS_BY_TYPE_XPATH, module_name,
+                sr_subscription_type_gpb_to_str(subscription->type), subscription->xpath);
+        rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, NULL, false, true, NULL);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_WRN("Unable to delete existing %s subscriptions.", sr_subscription_type_gpb_to_str(subscription->type));
+        }
+    }
+
+    /* create the subscription */
+    snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION, module_name,
+            sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+    rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, NULL, true, true, NULL);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new subscription into the data tree.");
+
+    /* set subscription details */
+    if (subscription->enable_running) {
+        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_ENABLE_RUNNING, module_name,
+                sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+        rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, NULL, true, true, NULL);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+    }
+    if (NULL != subscription->xpath) {
+        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_XPATH, module_name,
+                sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+        value = subscription->xpath;
+        rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, value, true, true, NULL);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+    }
+    if (SR__SUBSCRIPTION_TYPE__EVENT_NOTIF_SUBS == subscription->type) {
+        if (NULL != subscription->username) {
+            snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_USERNAME, module_name,
+                    sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+            value = subscription->username;
+            rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, value, true, true, NULL);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+        }
+        if (subscription->enable_nacm) {
+            snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_ENABLE_NACM, module_name,
+                     sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+            rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, NULL, true, true, NULL);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+        }
+    }
+    if (SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS == subscription->type ||
+            SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS == subscription->type) {
+        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_EVENT, module_name,
+                sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+        value = sr_notification_event_gpb_to_str(subscription->notif_event);
+        rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, value, true, true, NULL);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+        if (subscription->inline_changes) {
+            snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_INLINE_CHANGES, module_name,
+                    sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+            rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, NULL, true, true, NULL);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+        }
+    }
+    if (SR__SUBSCRIPTION_TYPE__DP_GET_ITEMS_SUBS == subscription->type && subscription->dp_cache_ttl > 0) {
+        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_DP_CACHE_TTL, module_name,
+                sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+        snprintf(buff, sizeof(buff), "%"PRIu32, subscription->dp_cache_ttl);
+        value = buff;
+        rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, value, true, true, NULL);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+    }
+    if (SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS == subscription->type ||
+            SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS == subscription->type) {
+        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_PRIORITY, module_name,
+                sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+        snprintf(buff, sizeof(buff), "%"PRIu32, subscription->priority);
+        value = buff;
+        rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, value, true, true, NULL);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+    }
+    if (SR__SUBSCRIPTION_TYPE__RPC_SUBS == subscription->type ||
+            SR__SUBSCRIPTION_TYPE__EVENT_NOTIF_SUBS == subscription->type ||
+            SR__SUBSCRIPTION_TYPE__ACTION_SUBS == subscription->type) {
+        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_API_VARIANT, module_name,
+                sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+        value = sr_api_variant_to_str(subscription->api_variant);
+        rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, value, true, true, NULL);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+    }
+
+cleanup:
+    return rc;
+}
+
+/**
+ * @brief Applies the operation on the persist data tree.
+ */
+static int
+pm_subscription_op_apply_tree(pm_ctx_t *pm_ctx, const char *module_name, const pm_subscription_op_t *op,
+        struct lyd_node **data_tree)
+{
+    const np_subscription_t *subscription = op->subscription;
+    char xpath[PATH_MAX] = { 0, };
+    int rc = SR_ERR_OK;
+
+    switch (op->type) {
+        case PM_SUBSCRIPTION_ADD:
+        case PM_SUBSCRIPTION_ADD_EXCLUSIVE:
+            rc = pm_subscription_add_to_tree(pm_ctx, module_name, subscription,
+                    (PM_SUBSCRIPTION_ADD_EXCLUSIVE == op->type), data_tree);
+            break;
+        case PM_SUBSCRIPTION_REMOVE:
+            snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION, module_name,
+                    sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+            rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, NULL, false, false, NULL);
+            break;
+        case PM_SUBSCRIPTION_REMOVE_DST:
+            snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTIONS_BY_DST_ADDR, module_name, subscription->dst_address);
+            rc = pm_modify_persist_data_tree(pm_ctx, data_tree, xpath, NULL, false, false, NULL);
+            break;
+    }
+
+    if (SR_ERR_DATA_EXISTS == rc || SR_ERR_DATA_MISSING == rc) {
+        /* the persist file has been modified by another process in the meantime */
+        SR_LOG_DBG("Subscription for '%s' @ %"PRIu32" already added to / removed from '%s' persist file.",
+                subscription->dst_address, subscription->dst_id, module_name);
+        rc = SR_ERR_OK;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Returns the operations that could not be written into the persist file back to the module data,
+ * so that they are written by the next synchronization.
+ */
+static void
+pm_module_data_requeue_ops(pm_ctx_t *pm_ctx, pm_module_data_t *md, sr_list_t *ops)
+{
+    size_t ops_cnt = ops->count;
+    int rc = SR_ERR_OK;
+
+    pthread_rwlock_wrlock(&pm_ctx->module_data_lock);
+
+    /* keep the original order of the operations */
+    for (size_t i = 0; NULL != md->pending_ops && i < md->pending_ops->count; i++) {
+        rc = sr_list_add(ops, md->pending_ops->data[i]);
+        if (SR_ERR_OK != rc) {
+            break;
+        }
+    }
+    if (SR_ERR_OK == rc) {
+        sr_list_cleanup(md->pending_ops);
+        md->pending_ops = ops;
+    } else {
+        SR_LOG_ERR("Unable to keep %zu subscription changes of module '%s'.", ops_cnt, md->module_name);
+        ops->count = ops_cnt;
+        pm_subscription_ops_cleanup(ops);
+    }
+
+    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+}
+
+/**
+ * @brief Records the result of writing the batch of operations into the persist file and wakes up
+ * the requests waiting for it.
+ */
+static void
+pm_module_data_batch_done(pm_module_data_t *md, uint64_t first, uint64_t last, int rc)
+{
+    pthread_mutex_lock(&md->commit_lock);
+    if (SR_ERR_OK == rc) {
+        /* failed operations are written as a part of the following batch */
+        if (first <= md->failed_first && md->failed_last <= last) {
+            md->failed_first = md->failed_last = 0;
+        }
+    } else {
+        md->failed_first = first;
+        md->failed_last = last;
+        md->failed_rc = rc;
+    }
+    if (last > md->commit_seq) {
+        md->commit_seq = last;
+    }
+    pthread_cond_broadcast(&md->commit_cond);
+    pthread_mutex_unlock(&md->commit_lock);
+}
+
+/**
+ * @brief Synchronizes the in-memory subscriptions of the module with its persist data file. Writes the pending
+ * operations into the file and reloads the subscriptions if the file has been modified by another process.
+ *
+ * @note Must be called without ::pm_ctx_t::module_data_lock held. Version and load status of the module
+ * data are modified only from this function with the sync lock of the module held.
+ */
+static int
+pm_module_data_sync(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, pm_module_data_t *md)
+{
+    struct lyd_node *data_tree = NULL;
+    sr_list_t *ops = NULL;
+    uint64_t batch_first = 0, batch_last = 0;
+    pm_file_version_t version = { 0, };
+    bool changed = true;
+    int fd = -1;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(pm_ctx, md);
+
+    MUTEX_LOCK_TIMED_CHECK_RETURN(&md->sync_lock);
+
+    /* take over the pending operations */
+    RWLOCK_WRLOCK_TIMED_CHECK_GOTO(&pm_ctx->module_data_lock, rc, cleanup);
+    ops = md->pending_ops;
+    md->pending_ops = NULL;
+    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+
+    if (NULL != ops) {
+        batch_first = ((pm_subscription_op_t *) ops->data[0])->seq;
+        batch_last = ((pm_subscription_op_t *) ops->data[ops->count - 1])->seq;
+
+        rc = pm_load_data_tree(pm_ctx, NULL, md->module_name, false, &data_tree, &fd);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load persist data tree for module '%s'.", md->module_name);
+
+        /* the file is locked now, check whether it has been modified by another process */
+        if (md->loaded) {
+            rc = pm_file_version_changed(pm_ctx, md->module_name, &md->version, &changed);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Persist data file version check failed.");
+        }
+
+        for (size_t i = 0; i < ops->count; i++) {
+            rc = pm_subscription_op_apply_tree(pm_ctx, md->module_name, ops->data[i], &data_tree);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to apply subscription changes on the persist data tree.");
+        }
+        if (NULL != data_tree) {
+            rc = pm_save_data_tree(data_tree, fd);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to save persist data tree.");
+        }
+        SR_LOG_DBG("%zu subscription changes written into '%s' persist file.", ops->count, md->module_name);
+        pm_subscription_ops_cleanup(ops);
+        ops = NULL;
+
+        rc = pm_file_version_save(pm_ctx, md->module_name, &version);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to store persist data file version.");
+    } else {
+        if (md->loaded) {
+            rc = pm_file_version_changed(pm_ctx, md->module_name, &md->version, &changed);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Persist data file version check failed.");
+        }
+        if (!changed) {
+            goto cleanup;
+        }
+
+        /* version is stored before loading, a modification in between is detected by the next check */
+        rc = pm_file_version_save(pm_ctx, md->module_name, &version);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to store persist data file version.");
+
+        rc = pm_load_data_tree(pm_ctx, user_cred, md->module_name, true, &data_tree, NULL);
+        if (SR_ERR_DATA_MISSING == rc) {
+            rc = SR_ERR_OK;
+        }
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load persist data tree for module '%s'.", md->module_name);
+    }
+
+    RWLOCK_WRLOCK_TIMED_CHECK_GOTO(&pm_ctx->module_data_lock, rc, cleanup);
+    if (changed) {
+        /* reload the subscriptions, re-apply the operations recorded in the meantime */
+        rc = pm_module_data_load(md, data_tree);
+        for (size_t i = 0; SR_ERR_OK == rc && NULL != md->pending_ops && i < md->pending_ops->count; i++) {
+            pm_module_data_apply_op(md, md->pending_ops->data[i], NULL);
+        }
+    }
+    md->version = version;
+    md->loaded = (SR_ERR_OK == rc);
+    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+
+cleanup:
+    pm_cleanup_data_tree(pm_ctx, data_tree, fd);
+    if (NULL != ops) {
+        pm_module_data_requeue_ops(pm_ctx, md, ops);
+    }
+    if (0 != batch_last) {
+        pm_module_data_batch_done(md, batch_first, batch_last, rc);
+    }
+    pthread_mutex_unlock(&md->sync_lock);
+    return rc;
+}
+
+/**
+ * @brief Writes the operation with the given sequence number into the persist file of the module
+ * and returns once it is written (group commit). If no batch of the module is being written, the pending
+ * operations are written by the caller, otherwise the caller waits for the batch being written, its operation
+ * is either part of it or is written by the next one.
+ *
+ * @note Must be called without ::pm_ctx_t::module_data_lock held.
+ */
+static int
+pm_module_data_commit(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, pm_module_data_t *md, uint64_t seq)
+{
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(pm_ctx, md);
+
+    MUTEX_LOCK_TIMED_CHECK_RETURN(&md->commit_lock);
+    while (md->commit_seq < seq) {
+        if (md->committing) {
+            pthread_cond_wait(&md->commit_cond, &md->commit_lock);
+            continue;
+        }
+        md->committing = true;
+        pthread_mutex_unlock(&md->commit_lock);
+
+        rc = pm_module_data_sync(pm_ctx, user_cred, md);
+
+        pthread_mutex_lock(&md->commit_lock);
+        md->committing = false;
+        pthread_cond_broadcast(&md->commit_cond);
+        if (SR_ERR_OK != rc && md->commit_seq < seq) {
+            /* the operation has not been taken by any batch */
+            pthread_mutex_unlock(&md->commit_lock);
+            return rc;
+        }
+    }
+    rc = SR_ERR_OK;
+    if (0 != md->failed_first && md->failed_first <= seq && seq <= md->failed_last) {
+        /* the operation stays pending, it is written by the next batch */
+        rc = md->failed_rc;
+    }
+    pthread_mutex_unlock(&md->commit_lock);
+
+    return rc;
+}
+
+/**
+ * @brief Returns the data of the module, creates it if it does not exist yet.
+ */
+static int
+pm_module_data_get(pm_ctx_t *pm_ctx, const char *module_name, pm_module_data_t **md_p)
+{
+    pm_module_data_t *md = NULL, lookup_md = {0};
+    int rc = SR_ERR_OK;
+
+    lookup_md.module_name = module_name;
+
+    RWLOCK_RDLOCK_TIMED_CHECK_RETURN(&pm_ctx->module_data_lock);
+    md = sr_btree_search(pm_ctx->module_data, &lookup_md);
+    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+
+    if (NULL != md) {
+        *md_p = md;
+        return SR_ERR_OK;
+    }
+
+    RWLOCK_WRLOCK_TIMED_CHECK_RETURN(&pm_ctx->module_data_lock);
+
+    md = sr_btree_search(pm_ctx->module_data, &lookup_md);
+    if (NULL == md) {
+        /* module data does not exist, create it */
+        md = calloc(1, sizeof(*md));
+        CHECK_NULL_NOMEM_GOTO(md, rc, cleanup);
+        pthread_mutex_init(&md->sync_lock, NULL);
+        pthread_mutex_init(&md->commit_lock, NULL);
+        pthread_cond_init(&md->commit_cond, NULL);
+
+        md->module_name = strdup(module_name);
+        CHECK_NULL_NOMEM_GOTO(md->module_name, rc, cleanup);
+
+        rc = sr_list_init(&md->subscriptions);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Subscriptions list init failed.");
+
+        rc = sr_btree_insert(pm_ctx->module_data, md);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Module data btree insert failed.");
+    }
+    *md_p = md;
+    md = NULL;
+
+cleanup:
+    if (NULL != md) {
+        pm_free_module_data(md);
+    }
+    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+
+    return rc;
+}
+
+/**
+ * @brief Returns the data of the module with its subscriptions up to date with the persist data file
+ * and ::pm_ctx_t::module_data_lock locked for reading or writing.
+ */
+static int
+pm_module_data_lock(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *module_name, bool write,
+        pm_module_data_t **md_p)
+{
+    pm_module_data_t *md = NULL;
+    bool changed = true;
+    int rc = SR_ERR_OK;
+
+    rc = pm_module_data_get(pm_ctx, module_name, &md);
+    CHECK_RC_LOG_RETURN(rc, "Unable to get module data of '%s'.", module_name);
+
+    if (write) {
+        RWLOCK_WRLOCK_TIMED_CHECK_RETURN(&pm_ctx->module_data_lock);
+    } else {
+        RWLOCK_RDLOCK_TIMED_CHECK_RETURN(&pm_ctx->module_data_lock);
+    }
+
+    if (md->loaded) {
+        /* check whether the file hasn't been modified by another process */
+        rc = pm_file_version_changed(pm_ctx, module_name, &md->version, &changed);
+        if (SR_ERR_OK != rc) {
+            pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+            return rc;
+        }
+    }
+
+    if (changed) {
+        pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+
+        rc = pm_module_data_sync(pm_ctx, user_cred, md);
+        CHECK_RC_LOG_RETURN(rc, "Unable to load subscriptions of module '%s'.", module_name);
+
+        if (write) {
+            RWLOCK_WRLOCK_TIMED_CHECK_RETURN(&pm_ctx->module_data_lock);
+        } else {
+            RWLOCK_RDLOCK_TIMED_CHECK_RETURN(&pm_ctx->module_data_lock);
+        }
+    }
+
+    *md_p = md;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Writes the pending subscription changes of all modules into their persist data files,
+ * the changes left pending by failed batches are written by the cleanup.
+ */
+static void
+pm_flush_all(pm_ctx_t *pm_ctx)
+{
+    pm_module_data_t *md = NULL;
+    sr_list_t *modules = NULL;
+    size_t i = 0;
+    int rc = SR_ERR_OK;
+
+    rc = sr_list_init(&modules);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR_MSG("Unable to initialize the list of modules to be flushed.");
+        return;
+    }
+
+    /* module data are never removed before the cleanup, the pointers stay valid */
+    pthread_rwlock_rdlock(&pm_ctx->module_data_lock);
+    while (NULL != (md = sr_btree_get_at(pm_ctx->module_data, i++))) {
+        if (NULL != md->pending_ops && SR_ERR_OK != sr_list_add(modules, md)) {
+            SR_LOG_ERR("Unable to schedule flushing of '%s' persist data file.", md->module_name);
+        }
+    }
+    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+
+    for (i = 0; i < modules->count; i++) {
+        md = modules->data[i];
+        rc = pm_module_data_sync(pm_ctx, NULL, md);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Unable to write subscription changes into '%s' persist data file.", md->module_name);
+        }
+    }
+
+    sr_list_cleanup(modules);
+}
+
+int
+pm_init(rp_ctx_t *rp_ctx, const char *schema_search_dir, const char *data_search_dir, pm_ctx_t **pm_ctx)
+{
+    pm_ctx_t *ctx = NULL;
+    char *schema_filename = NULL;
+    pthread_rwlockattr_t attr;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(rp_ctx, schema_search_dir, data_search_dir, pm_ctx);
+
+    /* allocate and initialize the context */
+    ctx = calloc(1, sizeof(*ctx));
     CHECK_NULL_NOMEM_GOTO(ctx, rc, cleanup);
 
     ctx->rp_ctx = rp_ctx;
@@ -917,6 +1596,10 @@ void
 pm_cleanup(pm_ctx_t *pm_ctx)
 {
     if (NULL != pm_ctx) {
+        if (NULL != pm_ctx->module_data) {
+            /* write the changes that have not been flushed yet */
+            pm_flush_all(pm_ctx);
+        }
         if (NULL != pm_ctx->ly_ctx) {
             ly_ctx_destroy(pm_ctx->ly_ctx, NULL);
         }
@@ -973,6 +1656,7 @@ pm_get_module_info(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *mo
     size_t subtrees_enabled_cnt = 0, feature_cnt = 0;
     np_subscription_t subscription = { 0, };
     sr_mem_snapshot_t snapshot = { 0, };
+    pm_module_data_t *md = NULL;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG3(pm_ctx, module_name, module_enabled);
@@ -988,6 +1672,13 @@ pm_get_module_info(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *mo
         sr_mem_snapshot(sr_mem_features, &snapshot);
     }
 
+    /* write the pending subscription changes, the persist file is read directly */
+    rc = pm_module_data_get(pm_ctx, module_name, &md);
+    if (SR_ERR_OK == rc) {
+        rc = pm_module_data_sync(pm_ctx, user_cred, md);
+    }
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to write subscriptions of module '%s'.", module_name);
+
     /* load the data tree from persist file */
     rc = pm_load_data_tree(pm_ctx, user_cred, module_name, true, &data_tree, NULL);
     if (SR_ERR_DATA_MISSING != rc) {
@@ -1088,98 +1779,38 @@ int
 pm_add_subscription(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *module_name,
         const np_subscription_t *subscription, const bool exclusive)
 {
-    char xpath[PATH_MAX] = { 0, }, buff[15] = { 0, };
-    const char *value = NULL;
-    struct lyd_node *data_tree = NULL;
-    int fd = -1;
+    pm_module_data_t *md = NULL;
+    pm_subscription_op_t *op = NULL;
+    uint64_t seq = 0;
     int rc = SR_ERR_OK;
 
-    rc = pm_load_data_tree(pm_ctx, user_cred, module_name, false, &data_tree, &fd);
-    CHECK_RC_LOG_RETURN(rc, "Unable to load persist data tree for module '%s'.", module_name);
+    CHECK_NULL_ARG3(pm_ctx, module_name, subscription);
 
-    if (exclusive) {
-        /* first, delete existing subscriptions of given type */
-        SR_LOG_DBG("Removing all existing %s subscriptions from '%s' persist data tree.",
-                sr_subscription_type_gpb_to_str(subscription->type), module_name);
+    rc = pm_check_file_access(pm_ctx, user_cred, module_name);
+    CHECK_RC_LOG_RETURN(rc, "Unable to access persist data file for module '%s'.", module_name);
 
-        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTIONS_BY_TYPE_XPATH, module_name,
-                sr_subscription_type_gpb_to_str(subscription->type), subscription->xpath);
-        rc = pm_modify_persist_data_tree(pm_ctx, &data_tree, xpath, NULL, false, true, NULL);
-        if (SR_ERR_OK != rc) {
-            SR_LOG_WRN("Unable to delete existing %s subscriptions.", sr_subscription_type_gpb_to_str(subscription->type));
-        }
-    }
+    rc = pm_subscription_op_new(module_name, (exclusive ? PM_SUBSCRIPTION_ADD_EXCLUSIVE : PM_SUBSCRIPTION_ADD),
+            subscription, &op);
+    CHECK_RC_MSG_RETURN(rc, "Unable to create new subscription entry.");
 
-    /* create the subscription */
-    snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION, module_name,
-            sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
-    rc = pm_modify_persist_data_tree(pm_ctx, &data_tree, xpath, NULL, true, true, NULL);
-    CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new subscription into the data tree.");
+    rc = pm_module_data_lock(pm_ctx, user_cred, module_name, true, &md);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load subscriptions of module '%s'.", module_name);
 
-    /* set subscription details */
-    if (subscription->enable_running) {
-        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_ENABLE_RUNNING, module_name,
-                sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
-        rc = pm_modify_persist_data_tree(pm_ctx, &data_tree, xpath, NULL, true, true, NULL);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
-    }
-    if (NULL != subscription->xpath) {
-        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_XPATH, module_name,
-                sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
-        value = subscription->xpath;
-        rc = pm_modify_persist_data_tree(pm_ctx, &data_tree, xpath, value, true, true, NULL);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
-    }
-    if (SR__SUBSCRIPTION_TYPE__EVENT_NOTIF_SUBS == subscription->type) {
-        if (NULL != subscription->username) {
-            snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_USERNAME, module_name,
-                    sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
-            value = subscription->username;
-            rc = pm_modify_persist_data_tree(pm_ctx, &data_tree, xpath, value, true, true, NULL);
-            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
-        }
-        if (subscription->enable_nacm) {
-            snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_ENABLE_NACM, module_name,
-                     sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
-            rc = pm_modify_persist_data_tree(pm_ctx, &data_tree, xpath, NULL, true, true, NULL);
-            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
-        }
-    }
-    if (SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS == subscription->type ||
-            SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS == subscription->type) {
-        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_EVENT, module_name,
-                sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
-        value = sr_notification_event_gpb_to_str(subscription->notif_event);
-        rc = pm_modify_persist_data_tree(pm_ctx, &data_tree, xpath, value, true, true, NULL);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
-    }
-    if (SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS == subscription->type ||
-            SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS == subscription->type) {
-        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_PRIORITY, module_name,
-                sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
-        snprintf(buff, sizeof(buff), "%"PRIu32, subscription->priority);
-        value = buff;
-        rc = pm_modify_persist_data_tree(pm_ctx, &data_tree, xpath, value, true, true, NULL);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
-    }
-    if (SR__SUBSCRIPTION_TYPE__RPC_SUBS == subscription->type ||
-            SR__SUBSCRIPTION_TYPE__EVENT_NOTIF_SUBS == subscription->type ||
-            SR__SUBSCRIPTION_TYPE__ACTION_SUBS == subscription->type) {
-        snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_API_VARIANT, module_name,
-                sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
-        value = sr_api_variant_to_str(subscription->api_variant);
-        rc = pm_modify_persist_data_tree(pm_ctx, &data_tree, xpath, value, true, true, NULL);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+    rc = pm_module_data_add_op(md, op, NULL);
+    if (SR_ERR_OK == rc) {
+        seq = op->seq;
+        op = NULL;
     }
+    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new subscription.");
 
-    rc = pm_save_data_tree(data_tree, fd);
+    rc = pm_module_data_commit(pm_ctx, user_cred, md, seq);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to write new subscription into '%s' persist file.", module_name);
 
-    if (SR_ERR_OK == rc) {
-        SR_LOG_DBG("Subscription entry successfully added into '%s' persist data tree.", module_name);
-    }
+    SR_LOG_DBG("Subscription entry successfully added into '%s' persistent data.", module_name);
 
 cleanup:
-    pm_cleanup_data_tree(pm_ctx, data_tree, fd);
+    pm_subscription_op_free(op);
     return rc;
 }
 
@@ -1187,37 +1818,44 @@ int
 pm_remove_subscription(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *module_name,
         const np_subscription_t *subscription, bool *disable_running)
 {
-    char xpath[PATH_MAX] = { 0, };
-    struct lyd_node *data_tree = NULL;
-    bool running_affected = false, has_running_enable_susbscriptions = false;
+    pm_module_data_t *md = NULL;
+    pm_subscription_op_t *op = NULL;
+    uint64_t seq = 0;
+    bool running_affected = false;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG5(pm_ctx, user_cred, module_name, subscription, disable_running);
 
-    /* invalidate the subscription cache for this module and subscription type */
-    pm_invalidate_cached_subscriptions(pm_ctx, module_name, subscription->type, false);
-
     *disable_running = false;
 
-    snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION, module_name,
-            sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+    rc = pm_check_file_access(pm_ctx, user_cred, module_name);
+    CHECK_RC_LOG_RETURN(rc, "Unable to access persist data file for module '%s'.", module_name);
 
-    rc = pm_save_persistent_data(pm_ctx, user_cred, module_name, xpath, NULL, false, true, &data_tree, &running_affected);
-    if (NULL != data_tree) {
-        if (running_affected) {
-            /* check if some subscriptions that enable running left */
-            rc = pm_dt_has_running_enable_susbscriptions(data_tree, module_name, &has_running_enable_susbscriptions);
-            if (SR_ERR_OK == rc && !has_running_enable_susbscriptions) {
-                *disable_running = true;
-            }
-        }
-        lyd_free_withsiblings(data_tree);
-    }
+    rc = pm_subscription_op_new(module_name, PM_SUBSCRIPTION_REMOVE, subscription, &op);
+    CHECK_RC_MSG_RETURN(rc, "Unable to create subscription removal entry.");
+
+    rc = pm_module_data_lock(pm_ctx, user_cred, module_name, true, &md);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load subscriptions of module '%s'.", module_name);
 
+    rc = pm_module_data_add_op(md, op, &running_affected);
     if (SR_ERR_OK == rc) {
-        SR_LOG_DBG("Subscription entry successfully removed from '%s' persist file.", module_name);
+        seq = op->seq;
+        op = NULL;
+        /* check if some subscriptions that enable running left */
+        if (running_affected && !pm_module_data_running_enabled(md)) {
+            *disable_running = true;
+        }
     }
+    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to remove the subscription.");
+
+    rc = pm_module_data_commit(pm_ctx, user_cred, md, seq);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to write subscription removal into '%s' persist file.", module_name);
 
+    SR_LOG_DBG("Subscription entry successfully removed from '%s' persistent data.", module_name);
+
+cleanup:
+    pm_subscription_op_free(op);
     return rc;
 }
 
@@ -1225,39 +1863,45 @@ int
 pm_remove_subscriptions_for_destination(pm_ctx_t *pm_ctx, const char *module_name, const char *dst_address,
         bool *disable_running)
 {
-    char xpath[PATH_MAX] = { 0, };
-    struct lyd_node *data_tree = NULL;
-    bool running_affected = false, has_running_enable_susbscriptions = false;
+    pm_module_data_t *md = NULL;
+    pm_subscription_op_t *op = NULL;
+    np_subscription_t subscription_lookup = { 0, };
+    uint64_t seq = 0;
+    bool running_affected = false;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG4(pm_ctx, module_name, dst_address, disable_running);
 
-    /* invalidate the subscription cache for this module */
-    pm_invalidate_cached_subscriptions(pm_ctx, module_name, 0, true);
-
     *disable_running = false;
 
-    snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTIONS_BY_DST_ADDR, module_name, dst_address);
+    subscription_lookup.dst_address = dst_address;
+    rc = pm_subscription_op_new(module_name, PM_SUBSCRIPTION_REMOVE_DST, &subscription_lookup, &op);
+    CHECK_RC_MSG_RETURN(rc, "Unable to create subscription removal entry.");
+
+    rc = pm_module_data_lock(pm_ctx, NULL, module_name, true, &md);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load subscriptions of module '%s'.", module_name);
 
     /* remove the subscriptions */
-    rc = pm_save_persistent_data(pm_ctx, NULL, module_name, xpath, NULL, false, true, &data_tree, &running_affected);
-    if (NULL != data_tree) {
+    rc = pm_module_data_add_op(md, op, &running_affected);
+    if (SR_ERR_OK == rc) {
+        seq = op->seq;
+        op = NULL;
         /* check if some subscriptions that enable running left */
-        if (running_affected) {
-            /* check if some subscriptions that enable running left */
-            rc = pm_dt_has_running_enable_susbscriptions(data_tree, module_name, &has_running_enable_susbscriptions);
-            if (SR_ERR_OK == rc && !has_running_enable_susbscriptions) {
-                *disable_running = true;
-            }
+        if (running_affected && !pm_module_data_running_enabled(md)) {
+            *disable_running = true;
         }
-        lyd_free_withsiblings(data_tree);
     }
+    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to remove subscriptions for destination '%s'.", dst_address);
 
-    if (SR_ERR_OK == rc) {
-        SR_LOG_DBG("Subscription entries for destination '%s' successfully removed from '%s' persist file.",
-                dst_address, module_name);
-    }
+    rc = pm_module_data_commit(pm_ctx, NULL, md, seq);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to write subscription removal into '%s' persist file.", module_name);
 
+    SR_LOG_DBG("Subscription entries for destination '%s' successfully removed from '%s' persistent data.",
+            dst_address, module_name);
+
+cleanup:
+    pm_subscription_op_free(op);
     return rc;
 }
 
@@ -1265,76 +1909,42 @@ int
 pm_get_subscriptions(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *module_name, Sr__SubscriptionType type,
         sr_list_t **subscriptions_p)
 {
-    char xpath[PATH_MAX] = { 0, };
-    struct lyd_node *data_tree = NULL;
-    struct ly_set *node_set = NULL;
+    pm_module_data_t *md = NULL;
+    pm_subscription_set_t *set = NULL;
     sr_list_t *subscriptions_list = NULL;
     np_subscription_t *subscription = NULL;
-    bool cache_hit = false;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG3(pm_ctx, module_name, subscriptions_p);
 
-    /* attempt to satisfy the request from cache */
-    rc = pm_get_cached_subscriptions(pm_ctx, module_name, type, subscriptions_p, &cache_hit);
-    if (cache_hit) {
-        SR_LOG_DBG("Returning %zu subscriptions from '%s' persist file cache.",
-                (NULL != *subscriptions_p) ? (*subscriptions_p)->count : 0, module_name);
-        return rc;
-    }
+    rc = pm_module_data_lock(pm_ctx, user_cred, module_name, false, &md);
+    CHECK_RC_LOG_RETURN(rc, "Unable to load subscriptions of module '%s'.", module_name);
 
-    /* load the data tree from persist file */
-    rc = pm_load_data_tree(pm_ctx, user_cred, module_name, true, &data_tree, NULL);
-    if (SR_ERR_DATA_MISSING != rc) {
-        CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load persist data tree for module '%s' %s.", module_name, sr_strerror(rc));
-    }
-
-    if (NULL == data_tree) {
-        /* empty data file */
-        *subscriptions_p = NULL;
-        rc = SR_ERR_OK;
-        goto cleanup;
-    }
-
-    snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTIONS_BY_TYPE, module_name, sr_subscription_type_gpb_to_str(type));
-    node_set = lyd_find_xpath(data_tree, xpath);
-
-    if (NULL != node_set && node_set->number > 0) {
+    set = pm_module_data_get_set(md, type);
+    if (NULL != set && set->subscriptions->count > 0) {
         rc = sr_list_init(&subscriptions_list);
         CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to init subscription list.");
 
-        for (size_t i = 0; i < node_set->number; i++) {
-            subscription = calloc(1, sizeof(*subscription));
-            CHECK_NULL_NOMEM_GOTO(subscription, rc, cleanup);
-
-            rc = pm_subscription_entry_fill(module_name, subscription, node_set->set.d[i]->child);
-            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to fill subscription details.");
+        for (size_t i = 0; i < set->subscriptions->count; i++) {
+            subscription = set->subscriptions->data[i];
 
             rc = sr_list_add(subscriptions_list, subscription);
-            subscription = NULL;
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add a subscription into the subscription list.");
+
+            /* increase copy refcount */
+            subscription->copy_cnt += 1;
         }
     }
 
-    /* store the result in the cache */
-    pm_cache_subscriptions(pm_ctx, module_name, type, subscriptions_list);
-
-    SR_LOG_DBG("Returning %zu subscriptions found in '%s' persist file.",
+    SR_LOG_DBG("Returning %zu subscriptions of module '%s'.",
             (NULL == subscriptions_list ? 0 : subscriptions_list->count), module_name);
 
     *subscriptions_p = subscriptions_list;
+    subscriptions_list = NULL;
 
 cleanup:
-    if (NULL != node_set) {
-        ly_set_free(node_set);
-    }
-    if (NULL != data_tree) {
-        lyd_free_withsiblings(data_tree);
-    }
-
-    if (SR_ERR_OK != rc) {
-        np_subscriptions_list_cleanup(subscriptions_list);
-        np_subscription_cleanup(subscription);
-    }
+    np_subscriptions_list_cleanup(subscriptions_list);
+    pthread_rwlock_unlock(&pm_ctx->module_data_lock);
 
     return rc;
 }
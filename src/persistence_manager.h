@@ -93,7 +93,8 @@ int pm_get_module_info(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char
         char ***features, size_t *features_cnt);
 
 /**
- * @brief Adds a new subscription into module's persistent storage.
+ * @brief Adds a new subscription into module's persistent storage. Returns once the subscription
+ * is written into the persist file, together with the changes made by concurrent requests.
  *
  * @param[in] pm_ctx Persistence Manager context acquired by ::pm_init call.
  * @param[in] user_cred User credentials.
@@ -108,7 +109,8 @@ int pm_add_subscription(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const cha
         const np_subscription_t *subscription, const bool exclusive);
 
 /**
- * @brief Removes the subscription from module's persistent storage.
+ * @brief Removes the subscription from module's persistent storage. Returns once the removal
+ * is written into the persist file, together with the changes made by concurrent requests.
  *
  * @param[in] pm_ctx Persistence Manager context acquired by ::pm_init call.
  * @param[in] user_cred User credentials.
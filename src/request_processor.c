@@ -35,16 +35,14 @@
 #include "rp_dt_edit.h"
 #include "rp_dt_xpath.h"
 
-#define RP_INIT_REQ_QUEUE_SIZE   10  /**< Initial size of the request queue. */
+#define RP_REQ_QUEUE_SIZE        1024  /**< Capacity of the lock-free request queue. */
+#define RP_INIT_REQ_OVERFLOW_SIZE  10  /**< Initial size of the request overflow queue. */
 
 /*
  * Attributes that can significantly affect performance of the threadpool.
  */
-#define RP_REQ_PER_THREADS 2           /**< Number of requests that can be WAITING in queue per each thread before waking up another thread. */
-#define RP_THREAD_SPIN_TIMEOUT 500000  /**< Time in nanoseconds (500000 equals to a half of a millisecond).
-                                            Enables thread spinning if a thread needs to be woken up again in less than this timeout. */
-#define RP_THREAD_SPIN_MIN 1000        /**< Minimum number of cycles that a thread will spin before going to sleep, if spin is enabled. */
-#define RP_THREAD_SPIN_MAX 1000000     /**< Maximum number of cycles that a thread can spin before going to sleep. */
+#define RP_REQ_PER_THREADS 2      /**< Number of requests that can be WAITING in queue per each thread before waking up another thread. */
+#define RP_THREAD_SPIN_LIMIT 100  /**< Number of attempts to dequeue a request that a thread does before going to sleep. */
 
 /**
  * @brief Request context (for storing requests inside of the request queue).
@@ -768,7 +766,7 @@ cleanup:
 static int
 rp_get_items_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *skip_msg_cleanup)
 {
-    sr_val_t *values = NULL;
+    Sr__Value **values = NULL;
     size_t count = 0, limit = 0, offset = 0;
     char *xpath = NULL;
     int rc = SR_ERR_OK;
@@ -814,12 +812,10 @@ rp_get_items_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg,
     offset = msg->request->get_items_req->offset;
     limit = msg->request->get_items_req->limit;
 
-    if (msg->request->get_items_req->has_offset || msg->request->get_items_req->has_limit) {
-        rc = rp_dt_get_values_wrapper_with_opts(rp_ctx, session, &session->get_items_ctx, sr_mem, xpath,
-                offset, limit, &values, &count);
-    } else {
-        rc = rp_dt_get_values_wrapper(rp_ctx, session, sr_mem, xpath, &values, &count);
-    }
+    /* values are copied from the data tree directly into the response */
+    rc = rp_dt_get_gpb_values_wrapper(rp_ctx, session,
+            (msg->request->get_items_req->has_offset || msg->request->get_items_req->has_limit) ?
+            &session->get_items_ctx : NULL, sr_mem, xpath, offset, limit, &values, &count);
 
     if (SR_ERR_OK != rc) {
         if (SR_ERR_NOT_FOUND != rc) {
@@ -835,7 +831,6 @@ rp_get_items_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg,
         *skip_msg_cleanup = true;
         /* setup timeout */
         rc = rp_set_oper_request_timeout(rp_ctx, session, msg, SR_OPER_DATA_PROVIDE_TIMEOUT);
-        sr_free_values(values, count);
         sr_msg_free(resp);
         pthread_mutex_unlock(&session->cur_req_mutex);
         return rc;
@@ -844,9 +839,8 @@ rp_get_items_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg,
     SR_LOG_DBG("%zu items found for '%s', session id=%"PRIu32".", count, xpath, session->id);
     pthread_mutex_unlock(&session->cur_req_mutex);
 
-    /* copy values to gpb */
-    rc = sr_values_sr_to_gpb(values, count, &resp->response->get_items_resp->values, &resp->response->get_items_resp->n_values);
-    CHECK_RC_MSG_GOTO(rc, cleanup, "Copying values to GPB failed.");
+    resp->response->get_items_resp->values = values;
+    resp->response->get_items_resp->n_values = count;
 
 cleanup:
     session->req = NULL;
@@ -859,7 +853,6 @@ cleanup:
         SR_LOG_ERR_MSG("Copying errors to gpb failed");
     }
 
-    sr_free_values(values, count);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -963,7 +956,7 @@ cleanup:
 static int
 rp_get_subtrees_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *skip_msg_cleanup)
 {
-    sr_node_t *trees = NULL;
+    Sr__Node **trees = NULL;
     size_t count = 0;
     char *xpath = NULL;
     int rc = SR_ERR_OK;
@@ -1006,7 +999,8 @@ rp_get_subtrees_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *ms
     session->req = msg;
 
     xpath = msg->request->get_subtrees_req->xpath;
-    rc = rp_dt_get_subtrees_wrapper(rp_ctx, session, sr_mem, xpath, &trees, &count);
+    /* subtrees are copied from the data tree directly into the response */
+    rc = rp_dt_get_gpb_subtrees_wrapper(rp_ctx, session, sr_mem, xpath, &trees, &count);
 
     if (SR_ERR_OK != rc) {
         if (SR_ERR_NOT_FOUND != rc) {
@@ -1022,7 +1016,6 @@ rp_get_subtrees_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *ms
         *skip_msg_cleanup = true;
         /* setup timeout */
         rc = rp_set_oper_request_timeout(rp_ctx, session, msg, SR_OPER_DATA_PROVIDE_TIMEOUT);
-        sr_free_trees(trees, count);
         sr_msg_free(resp);
         pthread_mutex_unlock(&session->cur_req_mutex);
         return rc;
@@ -1031,9 +1024,8 @@ rp_get_subtrees_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *ms
     SR_LOG_DBG("%zu subtrees found for '%s', session id=%"PRIu32".", count, xpath, session->id);
     pthread_mutex_unlock(&session->cur_req_mutex);
 
-    /* copy subtrees to gpb */
-    rc = sr_trees_sr_to_gpb(trees, count, &resp->response->get_subtrees_resp->trees, &resp->response->get_subtrees_resp->n_trees);
-    CHECK_RC_MSG_GOTO(rc, cleanup, "Copying values to GPB failed.");
+    resp->response->get_subtrees_resp->trees = trees;
+    resp->response->get_subtrees_resp->n_trees = count;
 
 cleanup:
     session->req = NULL;
@@ -1046,7 +1038,6 @@ cleanup:
         SR_LOG_ERR_MSG("Copying errors to gpb failed");
     }
 
-    sr_free_trees(trees, count);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1392,6 +1383,199 @@ rp_move_item_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
     return rc;
 }
 
+/**
+ * @brief Processes an edit_batch request.
+ */
+static int
+rp_edit_batch_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
+{
+    Sr__Msg *resp = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    Sr__EditBatchReq *req = NULL;
+    Sr__EditBatchResp *batch_resp = NULL;
+    Sr__EditOperation *op = NULL;
+    Sr__EditResult *result = NULL;
+    const char *xpath = NULL;
+    sr_val_t *value = NULL;
+    char *str_value = NULL;
+    int rc = SR_ERR_OK, op_rc = SR_ERR_OK, first_rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG5(rp_ctx, session, msg, msg->request, msg->request->edit_batch_req);
+
+    req = msg->request->edit_batch_req;
+
+    SR_LOG_DBG("Processing edit_batch request (%zu operations).", req->n_operations);
+
+    /* allocate the response */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_RETURN(rc, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_resp_alloc(sr_mem, SR__OPERATION__EDIT_BATCH, session->id, &resp);
+    if (SR_ERR_OK != rc) {
+        sr_mem_free(sr_mem);
+        SR_LOG_ERR_MSG("Allocation of edit_batch response failed.");
+        return SR_ERR_NOMEM;
+    }
+    batch_resp = resp->response->edit_batch_resp;
+
+    if (0 == req->n_operations) {
+        goto cleanup;
+    }
+
+    /* make room for all operations in the session operation list at once */
+    rc = dm_reserve_operations(session->dm_session, req->n_operations);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to allocate session operation list.");
+
+    batch_resp->failed = sr_calloc(sr_mem, req->n_operations, sizeof(*batch_resp->failed));
+    CHECK_NULL_NOMEM_GOTO(batch_resp->failed, rc, cleanup);
+
+    for (size_t i = 0; i < req->n_operations; i++) {
+        op = req->operations[i];
+        xpath = NULL;
+        value = NULL;
+        str_value = NULL;
+        op_rc = SR_ERR_OK;
+
+        if (NULL != op->set_item) {
+            xpath = op->set_item->xpath;
+            if (NULL != op->set_item->value) {
+                /* copy the value from gpb */
+                op_rc = sr_dup_gpb_to_val_t((sr_mem_ctx_t *)msg->_sysrepo_mem_ctx, op->set_item->value, &value);
+            }
+            if (SR_ERR_OK == op_rc) {
+                op_rc = rp_dt_set_item_wrapper(rp_ctx, session, xpath, value, NULL, op->set_item->options);
+            }
+        } else if (NULL != op->set_item_str) {
+            xpath = op->set_item_str->xpath;
+            if (NULL != op->set_item_str->value) {
+                str_value = strdup(op->set_item_str->value);
+                if (NULL == str_value) {
+                    op_rc = SR_ERR_NOMEM;
+                }
+            }
+            if (SR_ERR_OK == op_rc) {
+                op_rc = rp_dt_set_item_wrapper(rp_ctx, session, xpath, NULL, str_value, op->set_item_str->options);
+            }
+        } else if (NULL != op->delete_item) {
+            xpath = op->delete_item->xpath;
+            op_rc = rp_dt_delete_item_wrapper(rp_ctx, session, xpath, op->delete_item->options);
+        } else if (NULL != op->move_item) {
+            xpath = op->move_item->xpath;
+            op_rc = rp_dt_move_list_wrapper(rp_ctx, session, xpath,
+                    sr_move_direction_gpb_to_sr(op->move_item->position), op->move_item->relative_item);
+        } else {
+            op_rc = dm_report_error(session->dm_session, "Empty operation in the edit batch", NULL, SR_ERR_INVAL_ARG);
+        }
+
+        if (SR_ERR_OK == op_rc) {
+            continue;
+        }
+
+        SR_LOG_ERR("Operation %zu of the edit batch failed for '%s', session id=%"PRIu32".",
+                i, (NULL != xpath ? xpath : ""), session->id);
+        if (SR_ERR_OK == first_rc) {
+            first_rc = op_rc;
+        }
+
+        /* record the result of the failed operation */
+        result = sr_calloc(sr_mem, 1, sizeof(*result));
+        CHECK_NULL_NOMEM_GOTO(result, rc, cleanup);
+        sr__edit_result__init(result);
+        result->index = i;
+        result->result = op_rc;
+        batch_resp->failed[batch_resp->n_failed++] = result;
+
+        if (dm_has_error(session->dm_session)) {
+            result->error = sr_calloc(sr_mem, 1, sizeof(*result->error));
+            CHECK_NULL_NOMEM_GOTO(result->error, rc, cleanup);
+            sr__error__init(result->error);
+            rc = dm_copy_errors(session->dm_session, sr_mem, &result->error->message, &result->error->xpath);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Copying errors to gpb failed");
+            dm_clear_session_errors(session->dm_session);
+        }
+    }
+
+cleanup:
+    /* set response code */
+    resp->response->result = (SR_ERR_OK != rc) ? rc : first_rc;
+
+    /* send the response */
+    rc = cm_msg_send(rp_ctx->cm_ctx, resp);
+
+    return rc;
+}
+
+/**
+ * @brief Processes an import_data request.
+ */
+static int
+rp_import_data_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
+{
+    Sr__Msg *resp = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    Sr__ImportDataReq *import_req = NULL;
+    char *data = NULL;
+    LYD_FORMAT format = LYD_XML;
+    int rc = SR_ERR_OK, oper_rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG5(rp_ctx, session, msg, msg->request, msg->request->import_data_req);
+
+    SR_LOG_DBG_MSG("Processing import_data request.");
+
+    import_req = msg->request->import_data_req;
+
+    /* allocate the response */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_RETURN(rc, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_resp_alloc(sr_mem, SR__OPERATION__IMPORT_DATA, session->id, &resp);
+    if (SR_ERR_OK != rc) {
+        sr_mem_free(sr_mem);
+        SR_LOG_ERR_MSG("Allocation of import_data response failed.");
+        return SR_ERR_NOMEM;
+    }
+
+    CHECK_NULL_ARG_NORET2(oper_rc, import_req->module_name, import_req->data);
+    if (SR_ERR_OK != oper_rc) {
+        goto cleanup;
+    }
+
+    switch (import_req->format) {
+        case SR__IMPORT_DATA_REQ__FORMAT__XML:
+            format = LYD_XML;
+            break;
+        case SR__IMPORT_DATA_REQ__FORMAT__JSON:
+            format = LYD_JSON;
+            break;
+        default:
+            SR_LOG_ERR("Unsupported format of imported data: %d.", import_req->format);
+            oper_rc = SR_ERR_INVAL_ARG;
+            goto cleanup;
+    }
+
+    /* the data are kept in the session's operation list */
+    data = strdup(import_req->data);
+    CHECK_NULL_NOMEM_GOTO(data, oper_rc, cleanup);
+
+    /* import the data in data manager, the data are taken over even on error */
+    oper_rc = rp_dt_import_data_wrapper(rp_ctx, session, import_req->module_name, data, format, import_req->replace);
+    if (SR_ERR_OK != oper_rc) {
+        SR_LOG_ERR("Import of data failed for module '%s', session id=%"PRIu32".", import_req->module_name, session->id);
+    }
+
+cleanup:
+    /* set response code */
+    resp->response->result = oper_rc;
+
+    rc = rp_resp_fill_errors(resp, session->dm_session);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR_MSG("Copying errors to gpb failed");
+    }
+
+    /* send the response */
+    rc = cm_msg_send(rp_ctx->cm_ctx, resp);
+
+    return rc;
+}
+
 /**
  * @brief Processes a validate request.
  */
@@ -1856,6 +2040,12 @@ rp_subscribe_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr
     if (subscribe_req->has_enable_event && subscribe_req->enable_event) {
         options |= NP_SUBSCR_EV_EVENT;
     }
+    if (subscribe_req->has_inline_changes && subscribe_req->inline_changes) {
+        options |= NP_SUBSCR_INLINE_CHANGES;
+    }
+    if (subscribe_req->has_dp_cache_ttl) {
+        options |= (subscribe_req->dp_cache_ttl & 0xFFFF) << NP_SUBSCR_DP_CACHE_TTL_SHIFT;
+    }
 
     /* subscribe to the notification */
     rc = np_notification_subscribe(rp_ctx->np_ctx, session, subscribe_req->type,
@@ -1974,6 +2164,47 @@ rp_check_enabled_running_req_process(const rp_ctx_t *rp_ctx, const rp_session_t
     return rc;
 }
 
+/**
+ * @brief Processes an operational data cache invalidation request.
+ */
+static int
+rp_dp_cache_invalidate_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__Msg *msg)
+{
+    Sr__Msg *resp = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG5(rp_ctx, session, msg, msg->request, msg->request->dp_cache_invalidate_req);
+
+    SR_LOG_DBG_MSG("Processing dp-cache-invalidate request.");
+
+    /* allocate the response */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_RETURN(rc, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_resp_alloc(sr_mem, SR__OPERATION__DP_CACHE_INVALIDATE, session->id, &resp);
+    if (SR_ERR_OK != rc) {
+        sr_mem_free(sr_mem);
+        SR_LOG_ERR_MSG("Allocation of dp-cache-invalidate response failed.");
+        return SR_ERR_NOMEM;
+    }
+
+    /* only sessions allowed to read the data can invalidate them */
+    rc = ac_check_node_permissions(session->ac_session, msg->request->dp_cache_invalidate_req->xpath, AC_OPER_READ);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Access control check failed for xpath '%s'", msg->request->dp_cache_invalidate_req->xpath);
+    } else {
+        /* drop the cached data */
+        rc = rp_dp_cache_invalidate(rp_ctx->dp_cache, msg->request->dp_cache_invalidate_req->xpath);
+    }
+
+    /* set response code */
+    resp->response->result = rc;
+
+    /* send the response */
+    rc = cm_msg_send(rp_ctx->cm_ctx, resp);
+    return rc;
+}
+
 /**
  * @brief Process get changes request.
  */
@@ -2370,42 +2601,70 @@ finalize:
 }
 
 /**
- * @brief Checks if the received xpath was requested and find corresponding schema node
+ * @brief Checks if the received xpaths were requested and find corresponding schema node.
+ * All xpaths of a batch correspond to the same schema node.
  */
 static int
-rp_data_provide_resp_validate (rp_ctx_t *rp_ctx, rp_session_t *session, const char *xpath, sr_val_t *values, size_t values_cnt, struct lys_node **sch_node)
+rp_data_provide_resp_validate (rp_ctx_t *rp_ctx, rp_session_t *session, char **xpaths, size_t xpath_cnt, sr_val_t *values,
+        size_t values_cnt, struct lys_node **sch_node)
 {
-    CHECK_NULL_ARG3(rp_ctx, session, sch_node);
+    CHECK_NULL_ARG4(rp_ctx, session, xpaths, sch_node);
     if (values_cnt > 0) {
         CHECK_NULL_ARG(values);
     }
     int rc = SR_ERR_OK;
     bool found = false;
+    size_t hint = 0;
     dm_schema_info_t *si = NULL;
     struct lys_node *value_sch_node = NULL;
+    sr_list_t *requested = session->state_data_ctx.requested_xpaths;
+
+    if (0 == xpath_cnt) {
+        SR_LOG_ERR_MSG("Data provider response doesn't contain any xpath");
+        return SR_ERR_INVAL_ARG;
+    }
 
     rc = dm_get_module_and_lock(rp_ctx->dm_ctx, session->module_name, &si);
     CHECK_RC_MSG_RETURN(rc, "Get schema info failed");
 
-    /* verify that provided xpath was requested */
-    for (size_t i = 0; i < session->state_data_ctx.requested_xpaths->count; i++) {
-        char *xp = (char *) session->state_data_ctx.requested_xpaths->data[i];
-        if (0 == strcmp(xp, xpath)) {
-            found = true;
-            *sch_node = sr_find_schema_node(si->module->data, xp, 0);
-            if (NULL == *sch_node) {
-                SR_LOG_ERR("Schema node not found for %s", xp);
-                rc = SR_ERR_INVAL_ARG;
-                goto unlock;
+    *sch_node = sr_find_schema_node(si->module->data, xpaths[0], 0);
+    if (NULL == *sch_node) {
+        SR_LOG_ERR("Schema node not found for %s", xpaths[0]);
+        rc = SR_ERR_INVAL_ARG;
+        goto unlock;
+    }
+
+    /* verify that provided xpaths were requested, matched entries are only marked
+     * and removed at once afterwards, xpaths of a batch are usually stored consecutively */
+    for (size_t x = 0; x < xpath_cnt; x++) {
+        found = false;
+        for (size_t n = 0; n < requested->count; n++) {
+            size_t i = (hint + n) % requested->count;
+            char *xp = (char *) requested->data[i];
+            if (NULL != xp && 0 == strcmp(xp, xpaths[x])) {
+                found = true;
+                free(xp);
+                requested->data[i] = NULL;
+                hint = i + 1;
+                break;
             }
-            free(xp);
-            sr_list_rm_at(session->state_data_ctx.requested_xpaths, i);
+        }
+        if (!found) {
+            SR_LOG_ERR("Data provider sent data for unexpected xpath %s", xpaths[x]);
+            rc = SR_ERR_INVAL_ARG;
             break;
         }
     }
-    if (!found) {
-        SR_LOG_ERR("Data provider sent data for unexpected xpath %s", xpath);
-        rc = SR_ERR_INVAL_ARG;
+
+    /* compact the list of requested xpaths */
+    size_t remaining = 0;
+    for (size_t i = 0; i < requested->count; i++) {
+        if (NULL != requested->data[i]) {
+            requested->data[remaining++] = requested->data[i];
+        }
+    }
+    requested->count = remaining;
+    if (SR_ERR_OK != rc) {
         goto unlock;
     }
 
@@ -2432,31 +2691,42 @@ unlock:
 }
 
 /**
- * @brief Generate requests for nested data
+ * @brief Generate requests for nested data. Xpaths of all instances of a child node
+ * are requested from the data provider in a single batch.
  */
 static int
-rp_data_provide_request_nested(rp_ctx_t *rp_ctx, rp_session_t *session, const char *xpath, struct lys_node *sch_node)
+rp_data_provide_request_nested(rp_ctx_t *rp_ctx, rp_session_t *session, char **parent_xpaths, size_t parent_cnt,
+        struct lys_node *sch_node)
 {
     int rc = SR_ERR_OK;
     struct lys_node *iter = NULL;
     size_t subs_index = 0;
     char **xpaths = NULL;
     size_t xp_count = 0;
-    char *request_xp = NULL;
+    char **request_xps = NULL;
+    size_t request_cnt = 0;
 
     /* prepare xpaths where nested data will be requested */
     if (LYS_LIST == sch_node->nodetype) {
         rc = rp_dt_create_instance_xps(session, sch_node, &xpaths, &xp_count);
         CHECK_RC_MSG_RETURN(rc, "Failed to create xpaths for instances of sch node");
     } else {
-        xpaths = calloc(1, sizeof(*xpaths));
+        xpaths = calloc(parent_cnt, sizeof(*xpaths));
         CHECK_NULL_NOMEM_GOTO(xpaths, rc, cleanup);
 
-        xpaths[0] = strdup(xpath);
-        CHECK_NULL_NOMEM_GOTO(xpaths[0], rc, cleanup);
-        xp_count = 1;
+        for (xp_count = 0; xp_count < parent_cnt; xp_count++) {
+            xpaths[xp_count] = strdup(parent_xpaths[xp_count]);
+            CHECK_NULL_NOMEM_GOTO(xpaths[xp_count], rc, cleanup);
+        }
+    }
+
+    if (0 == xp_count) {
+        goto cleanup;
     }
 
+    request_xps = calloc(xp_count, sizeof(*request_xps));
+    CHECK_NULL_NOMEM_GOTO(request_xps, rc, cleanup);
+
     /* loop through the node children */
     LY_TREE_FOR(sch_node->child, iter) {
         subs_index = session->state_data_ctx.subscription_nodes->count;
@@ -2465,7 +2735,7 @@ rp_data_provide_request_nested(rp_ctx_t *rp_ctx, rp_session_t *session, const ch
              * this must exists since the a parent node has been already requested
              */
             if (!rp_dt_find_subscription_covering_subtree(session, iter, &subs_index)) {
-                SR_LOG_ERR("Failed to find subscription for nested requests %s", xpath);
+                SR_LOG_ERR("Failed to find subscription for nested requests %s", xpaths[0]);
                 rc = SR_ERR_INTERNAL;
                 goto cleanup;
             }
@@ -2474,23 +2744,20 @@ rp_data_provide_request_nested(rp_ctx_t *rp_ctx, rp_session_t *session, const ch
             rp_dt_find_exact_match_subscription_for_node(session, iter, &subs_index);
         }
         if (subs_index < session->state_data_ctx.subscription_nodes->count) {
-            for (size_t i = 0; i < xp_count; i++) {
-                size_t len = strlen(xpaths[i]) + strlen(iter->name) + 2 /* slash + zero byte */;
-                request_xp = calloc(len, sizeof(*request_xp));
-                CHECK_NULL_NOMEM_GOTO(request_xp, rc, cleanup);
-
-                snprintf(request_xp, len, "%s/%s", xpaths[i], iter->name);
-
-                rc = np_data_provider_request(rp_ctx->np_ctx, session->state_data_ctx.subscriptions->data[subs_index],
-                        session, request_xp);
-                SR_LOG_DBG("Sending request for nested state data: %s using subs index %zu", request_xp, subs_index);
+            for (request_cnt = 0; request_cnt < xp_count; request_cnt++) {
+                size_t len = strlen(xpaths[request_cnt]) + strlen(iter->name) + 2 /* slash + zero byte */;
+                request_xps[request_cnt] = calloc(len, sizeof(**request_xps));
+                CHECK_NULL_NOMEM_GOTO(request_xps[request_cnt], rc, cleanup);
 
-                session->dp_req_waiting += 1;
-
-                rc = sr_list_add(session->state_data_ctx.requested_xpaths, request_xp);
-                CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
-                request_xp = NULL;
+                snprintf(request_xps[request_cnt], len, "%s/%s", xpaths[request_cnt], iter->name);
             }
+
+            SR_LOG_DBG("Requesting nested state data: %s (%zu xpaths in the batch) using subs index %zu",
+                    request_xps[0], request_cnt, subs_index);
+            rc = rp_dt_request_dp_data(rp_ctx, session, session->state_data_ctx.subscriptions->data[subs_index],
+                    request_xps, request_cnt);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Request for nested state data %s failed", iter->name);
+            request_cnt = 0;
         }
     }
 cleanup:
@@ -2498,7 +2765,12 @@ cleanup:
         free(xpaths[i]);
     }
     free(xpaths);
-    free(request_xp);
+    if (NULL != request_xps) {
+        for (size_t i = 0; i < request_cnt; i++) {
+            free(request_xps[i]);
+        }
+        free(request_xps);
+    }
 
     return rc;
 }
@@ -2526,15 +2798,31 @@ rp_data_provide_resp_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *m
         goto error;
     }
 
-    char *xpath = msg->response->data_provide_resp->xpath;
+    Sr__DataProvideResp *dp_resp = msg->response->data_provide_resp;
+    char **xpaths = dp_resp->n_xpaths > 0 ? dp_resp->xpaths : &dp_resp->xpath;
+    size_t xpath_cnt = dp_resp->n_xpaths > 0 ? dp_resp->n_xpaths : 1;
     struct lys_node *sch_node = NULL;
+    np_subscription_t *subscription = NULL;
+    size_t subs_index = 0;
 
     session->dp_req_waiting -= 1;
     SR_LOG_DBG("Data provide response received, waiting for %zu more data providers.", session->dp_req_waiting);
 
-    rc = rp_data_provide_resp_validate(rp_ctx, session, xpath, values, values_cnt, &sch_node);
+    rc = rp_data_provide_resp_validate(rp_ctx, session, xpaths, xpath_cnt, values, values_cnt, &sch_node);
     CHECK_RC_MSG_GOTO(rc, finish, "Data validation failed.");
 
+    /* remember the data if the data provider allows caching */
+    if (SR_ERR_OK == msg->response->result &&
+            rp_dt_find_subscription_covering_subtree(session, sch_node, &subs_index)) {
+        subscription = session->state_data_ctx.subscriptions->data[subs_index];
+        for (size_t i = 0; subscription->dp_cache_ttl > 0 && i < xpath_cnt; i++) {
+            if (SR_ERR_OK != rp_dp_cache_store(rp_ctx->dp_cache, session->datastore, subscription, xpaths[i],
+                    values, values_cnt)) {
+                SR_LOG_WRN("Failed to cache operational data for xpath '%s'.", xpaths[i]);
+            }
+        }
+    }
+
     for (size_t i = 0; i < values_cnt; i++) {
         SR_LOG_DBG("Received value from data provider for xpath '%s'.", values[i].xpath);
         rc = rp_dt_set_item(rp_ctx->dm_ctx, session->dm_session, values[i].xpath, SR_EDIT_DEFAULT, &values[i], NULL);
@@ -2546,9 +2834,9 @@ rp_data_provide_resp_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *m
 
     /* handle nested data */
     if ((LYS_CONTAINER | LYS_LIST) & sch_node->nodetype) {
-        rc = rp_data_provide_request_nested(rp_ctx, session, xpath, sch_node);
+        rc = rp_data_provide_request_nested(rp_ctx, session, xpaths, xpath_cnt, sch_node);
         if (SR_ERR_OK != rc) {
-            SR_LOG_WRN("Requesting nested data for xpath %s was not successful", xpath);
+            SR_LOG_WRN("Requesting nested data for xpath %s was not successful", xpaths[0]);
         }
     }
 
@@ -2850,15 +3138,14 @@ rp_delayed_msg_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg * ms
 }
 
 /**
- * @brief Sends an event notification to specified notification subscriber.
+ * @brief Creates an event notification request with the content of the notification, without subscriber details.
  */
 static int
-rp_event_notif_send(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__EventNotifReq__NotifType type,
-        const char *xpath, time_t timestamp, sr_api_variant_t api_variant, const sr_val_t *sr_values, size_t sr_values_cnt,
-        const sr_node_t *sr_trees, size_t sr_trees_cnt, const char *subscription_address, uint32_t subscription_id,
-        time_t delivery_time)
+rp_event_notif_req_create(const rp_session_t *session, Sr__EventNotifReq__NotifType type, const char *xpath,
+        time_t timestamp, sr_api_variant_t api_variant, const sr_val_t *sr_values, size_t sr_values_cnt,
+        const sr_node_t *sr_trees, size_t sr_trees_cnt, Sr__Msg **req_p)
 {
-    Sr__Msg *req = NULL, *internal_req = NULL;
+    Sr__Msg *req = NULL;
     int rc = SR_ERR_OK;
 
     rc = sr_gpb_req_alloc(NULL, SR__OPERATION__EVENT_NOTIF, (NULL != session ? session->id : 0), &req);
@@ -2883,6 +3170,27 @@ rp_event_notif_send(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__Eve
     }
     CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to duplicate event notification (%s) input data.", xpath);
 
+    *req_p = req;
+    req = NULL;
+
+cleanup:
+    if (NULL != req) {
+        sr_msg_free(req);
+    }
+    return rc;
+}
+
+/**
+ * @brief Sends an event notification request to the subscriber identified in the request, either immediately
+ * or at the specified delivery time.
+ */
+static int
+rp_event_notif_req_send(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__Msg *req,
+        const char *subscription_address, uint32_t subscription_id, time_t delivery_time)
+{
+    Sr__Msg *internal_req = NULL;
+    int rc = SR_ERR_OK;
+
     /* set subscription info */
     req->request->event_notif_req->subscriber_address = strdup(subscription_address);
     CHECK_NULL_NOMEM_GOTO(req->request->event_notif_req->subscriber_address, rc, cleanup);
@@ -2916,6 +3224,80 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Sends an event notification to specified notification subscriber.
+ */
+static int
+rp_event_notif_send(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__EventNotifReq__NotifType type,
+        const char *xpath, time_t timestamp, sr_api_variant_t api_variant, const sr_val_t *sr_values, size_t sr_values_cnt,
+        const sr_node_t *sr_trees, size_t sr_trees_cnt, const char *subscription_address, uint32_t subscription_id,
+        time_t delivery_time)
+{
+    Sr__Msg *req = NULL;
+    int rc = SR_ERR_OK;
+
+    rc = rp_event_notif_req_create(session, type, xpath, timestamp, api_variant, sr_values, sr_values_cnt,
+            sr_trees, sr_trees_cnt, &req);
+    CHECK_RC_MSG_RETURN(rc, "Failed to create event notification request.");
+
+    return rp_event_notif_req_send(rp_ctx, session, req, subscription_address, subscription_id, delivery_time);
+}
+
+/**
+ * @brief Packs the content of an event notification once, so that it can be shared by the requests delivering
+ * the notification to all subscribers using the same API variant.
+ */
+static int
+rp_event_notif_payload_create(const rp_session_t *session, Sr__EventNotifReq__NotifType type, const char *xpath,
+        time_t timestamp, sr_api_variant_t api_variant, const sr_val_t *sr_values, size_t sr_values_cnt,
+        const sr_node_t *sr_trees, size_t sr_trees_cnt, sr_packed_payload_t **payload)
+{
+    Sr__Msg *req = NULL;
+    int rc = SR_ERR_OK;
+
+    rc = rp_event_notif_req_create(session, type, xpath, timestamp, api_variant, sr_values, sr_values_cnt,
+            sr_trees, sr_trees_cnt, &req);
+    CHECK_RC_MSG_RETURN(rc, "Failed to create event notification request.");
+
+    rc = sr_gpb_event_notif_payload_pack(req->request->event_notif_req, payload);
+    sr_msg_free(req);
+
+    return rc;
+}
+
+/**
+ * @brief Sends an event notification with pre-packed content to specified notification subscriber.
+ * The request itself carries only the subscriber details, the content is spliced in when the request is packed.
+ */
+static int
+rp_event_notif_payload_send(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__EventNotifReq__NotifType type,
+        const char *xpath, time_t timestamp, sr_packed_payload_t *payload, const char *subscription_address,
+        uint32_t subscription_id)
+{
+    Sr__Msg *req = NULL;
+    int rc = SR_ERR_OK;
+
+    rc = sr_gpb_req_alloc(NULL, SR__OPERATION__EVENT_NOTIF, (NULL != session ? session->id : 0), &req);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to allocate event notification request (%s).", xpath);
+
+    req->request->event_notif_req->type = type;
+    req->request->event_notif_req->xpath = strdup(xpath);
+    CHECK_NULL_NOMEM_GOTO(req->request->event_notif_req->xpath, rc, cleanup);
+    req->request->event_notif_req->timestamp = timestamp;
+
+    rc = sr_gpb_msg_attach_payload(req, payload);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to attach the content of event notification (%s).", xpath);
+
+    rc = rp_event_notif_req_send(rp_ctx, session, req, subscription_address, subscription_id, 0);
+    req = NULL;
+
+cleanup:
+    if (NULL != req) {
+        sr_msg_free(req);
+    }
+    return rc;
+}
+
 /**
  * @brief Processes an event notification request.
  */
@@ -2938,6 +3320,7 @@ rp_event_notif_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session,
     nacm_action_t nacm_action = NACM_ACTION_PERMIT;
     char *nacm_rule = NULL, *nacm_rule_info = NULL;
     dm_session_t *dm_session = NULL;
+    sr_packed_payload_t *payloads[SR_API_TREES + 1] = { NULL, };
     int rc = SR_ERR_OK, rc_tmp = SR_ERR_OK;
 
     CHECK_NULL_ARG_NORET4(rc, rp_ctx, msg, msg->request, msg->request->event_notif_req);
@@ -3018,10 +3401,6 @@ rp_event_notif_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session,
         for (size_t i = 0; i < subscriptions_list->count; i++) {
             subscription = subscriptions_list->data[i];
             if (NULL != subscription->xpath && 0 == strcmp(subscription->xpath, msg->request->event_notif_req->xpath)) {
-                /* duplicate msg into req with values and subscription details
-                 * @note we are not using memory context for the *req* message because with so many
-                 * duplications it would be actually less efficient than normally.
-                 */
                 sub_match = true;
 #ifdef ENABLE_NACM
                 /* NACM access control */
@@ -3039,9 +3418,16 @@ rp_event_notif_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session,
                     }
                 }
 #endif
-                rc = rp_event_notif_send(rp_ctx, session, msg->request->event_notif_req->type, subscription->xpath,
-                        msg->request->event_notif_req->timestamp, subscription->api_variant, with_def, with_def_cnt,
-                        with_def_tree, with_def_tree_cnt, subscription->dst_address, subscription->dst_id, 0);
+                /* the content is packed once per API variant and shared by the requests of all subscribers */
+                if (NULL == payloads[subscription->api_variant]) {
+                    rc = rp_event_notif_payload_create(session, msg->request->event_notif_req->type, xpath,
+                            msg->request->event_notif_req->timestamp, subscription->api_variant, with_def, with_def_cnt,
+                            with_def_tree, with_def_tree_cnt, &payloads[subscription->api_variant]);
+                    CHECK_RC_LOG_GOTO(rc, finalize, "Failed to pack the content of the notification '%s'.", xpath);
+                }
+                rc = rp_event_notif_payload_send(rp_ctx, session, msg->request->event_notif_req->type, subscription->xpath,
+                        msg->request->event_notif_req->timestamp, payloads[subscription->api_variant],
+                        subscription->dst_address, subscription->dst_id);
                 CHECK_RC_LOG_GOTO(rc, finalize, "Error by sending the notification '%s' to the subscriber '%s'.",
                         subscription->xpath, subscription->dst_address);
             }
@@ -3061,6 +3447,8 @@ finalize:
     free(nacm_rule);
     free(nacm_rule_info);
     np_subscriptions_list_cleanup(subscriptions_list);
+    sr_packed_payload_release(payloads[SR_API_VALUES]);
+    sr_packed_payload_release(payloads[SR_API_TREES]);
 
     if (!sub_match && SR_ERR_OK == rc) {
         /* no subscription for this event notification */
@@ -3217,13 +3605,118 @@ rp_notification_ack_process(rp_ctx_t *rp_ctx, Sr__Msg *msg)
     return rc;
 }
 
+/**
+ * @brief Adds the module identified by the first namespace of the xpath into the commit lock set.
+ */
+static int
+rp_commit_lock_set_add_xpath(rp_ctx_t *rp_ctx, dm_commit_lock_set_t *set, const char *xpath, bool write)
+{
+    char *module_name = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(rp_ctx, set);
+
+    if (NULL == xpath || SR_ERR_OK != sr_copy_first_ns(xpath, &module_name)) {
+        /* malformed xpath, the error is reported by the request processing */
+        return SR_ERR_OK;
+    }
+    rc = dm_commit_lock_set_add(rp_ctx->dm_ctx, set, module_name, write);
+    free(module_name);
+
+    return rc;
+}
+
+/**
+ * @brief Collects the modules whose commit locks have to be held during the processing of the request.
+ * Requests reading or editing data lock the touched modules for reading, commit and copy-config lock
+ * the modules they modify for writing.
+ */
+static int
+rp_commit_lock_set_fill(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, dm_commit_lock_set_t *set)
+{
+    Sr__EditBatchReq *batch_req = NULL;
+    Sr__EditOperation *op = NULL;
+    const char *xpath = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG5(rp_ctx, session, msg, msg->request, set);
+
+    switch (msg->request->operation) {
+        case SR__OPERATION__GET_ITEM:
+            rc = rp_commit_lock_set_add_xpath(rp_ctx, set, msg->request->get_item_req->xpath, false);
+            break;
+        case SR__OPERATION__GET_ITEMS:
+            rc = rp_commit_lock_set_add_xpath(rp_ctx, set, msg->request->get_items_req->xpath, false);
+            break;
+        case SR__OPERATION__GET_SUBTREE:
+            rc = rp_commit_lock_set_add_xpath(rp_ctx, set, msg->request->get_subtree_req->xpath, false);
+            break;
+        case SR__OPERATION__GET_SUBTREES:
+            rc = rp_commit_lock_set_add_xpath(rp_ctx, set, msg->request->get_subtrees_req->xpath, false);
+            break;
+        case SR__OPERATION__GET_SUBTREE_CHUNK:
+            rc = rp_commit_lock_set_add_xpath(rp_ctx, set, msg->request->get_subtree_chunk_req->xpath, false);
+            break;
+        case SR__OPERATION__SET_ITEM:
+            rc = rp_commit_lock_set_add_xpath(rp_ctx, set, msg->request->set_item_req->xpath, false);
+            break;
+        case SR__OPERATION__SET_ITEM_STR:
+            rc = rp_commit_lock_set_add_xpath(rp_ctx, set, msg->request->set_item_str_req->xpath, false);
+            break;
+        case SR__OPERATION__DELETE_ITEM:
+            rc = rp_commit_lock_set_add_xpath(rp_ctx, set, msg->request->delete_item_req->xpath, false);
+            break;
+        case SR__OPERATION__MOVE_ITEM:
+            rc = rp_commit_lock_set_add_xpath(rp_ctx, set, msg->request->move_item_req->xpath, false);
+            break;
+        case SR__OPERATION__EDIT_BATCH:
+            batch_req = msg->request->edit_batch_req;
+            for (size_t i = 0; SR_ERR_OK == rc && i < batch_req->n_operations; i++) {
+                op = batch_req->operations[i];
+                xpath = NULL;
+                if (NULL != op->set_item) {
+                    xpath = op->set_item->xpath;
+                } else if (NULL != op->set_item_str) {
+                    xpath = op->set_item_str->xpath;
+                } else if (NULL != op->delete_item) {
+                    xpath = op->delete_item->xpath;
+                } else if (NULL != op->move_item) {
+                    xpath = op->move_item->xpath;
+                }
+                rc = rp_commit_lock_set_add_xpath(rp_ctx, set, xpath, false);
+            }
+            break;
+        case SR__OPERATION__IMPORT_DATA:
+            rc = dm_commit_lock_set_add(rp_ctx->dm_ctx, set, msg->request->import_data_req->module_name, false);
+            break;
+        case SR__OPERATION__SESSION_REFRESH:
+            rc = dm_commit_lock_set_add_session_modules(rp_ctx->dm_ctx, set, session->dm_session, false, false);
+            break;
+        case SR__OPERATION__COMMIT:
+            rc = dm_commit_lock_set_add_session_modules(rp_ctx->dm_ctx, set, session->dm_session, true, true);
+            break;
+        case SR__OPERATION__COPY_CONFIG:
+            if (NULL != msg->request->copy_config_req->module_name) {
+                rc = dm_commit_lock_set_add(rp_ctx->dm_ctx, set, msg->request->copy_config_req->module_name, true);
+            } else {
+                rc = dm_commit_lock_set_add_all(rp_ctx->dm_ctx, set, session->dm_session, true);
+            }
+            break;
+        default:
+            break;
+    }
+
+    return rc;
+}
+
 /**
  * @brief Dispatches received request message.
  */
 static int
 rp_req_dispatch(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *skip_msg_cleanup)
 {
-    bool locked = false;
+    dm_commit_lock_set_t lock_set = { 0, };
+    bool lock = false;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG4(rp_ctx, msg, msg->request, skip_msg_cleanup);
@@ -3234,7 +3727,7 @@ rp_req_dispatch(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *ski
         dm_clear_session_errors(session->dm_session);
     }
 
-    /* acquire lock for operation accessing data */
+    /* acquire commit locks of the modules accessed by the operation */
     switch (msg->request->operation) {
         case SR__OPERATION__GET_ITEM:
         case SR__OPERATION__GET_ITEMS:
@@ -3245,22 +3738,30 @@ rp_req_dispatch(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *ski
         case SR__OPERATION__SET_ITEM_STR:
         case SR__OPERATION__DELETE_ITEM:
         case SR__OPERATION__MOVE_ITEM:
+        case SR__OPERATION__EDIT_BATCH:
+        case SR__OPERATION__IMPORT_DATA:
         case SR__OPERATION__SESSION_REFRESH:
-            pthread_rwlock_rdlock(&rp_ctx->commit_lock);
-            locked = true;
+            lock = (NULL != session);
             break;
         case SR__OPERATION__COMMIT:
         case SR__OPERATION__COPY_CONFIG:
             MUTEX_LOCK_TIMED_CHECK_RETURN(&rp_ctx->commit_block_mutex);
-            if (!rp_ctx->block_further_commits) {
-                pthread_rwlock_wrlock(&rp_ctx->commit_lock);
-                locked = true;
-            }
+            lock = (NULL != session && !rp_ctx->block_further_commits);
             pthread_mutex_unlock(&rp_ctx->commit_block_mutex);
             break;
         default:
             break;
     }
+    if (lock) {
+        rc = rp_commit_lock_set_fill(rp_ctx, session, msg, &lock_set);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Failed to determine modules to be locked (session id=%"PRIu32", operation=%d).",
+                    session->id, msg->request->operation);
+            dm_commit_lock_set_cleanup(&lock_set);
+            return rc;
+        }
+        dm_commit_lock_set_acquire(&lock_set);
+    }
 
     switch (msg->request->operation) {
         case SR__OPERATION__SESSION_SWITCH_DS:
@@ -3308,6 +3809,12 @@ rp_req_dispatch(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *ski
         case SR__OPERATION__MOVE_ITEM:
             rc = rp_move_item_req_process(rp_ctx, session, msg);
             break;
+        case SR__OPERATION__EDIT_BATCH:
+            rc = rp_edit_batch_req_process(rp_ctx, session, msg);
+            break;
+        case SR__OPERATION__IMPORT_DATA:
+            rc = rp_import_data_req_process(rp_ctx, session, msg);
+            break;
         case SR__OPERATION__VALIDATE:
             rc = rp_validate_req_process(rp_ctx, session, msg);
             break;
@@ -3338,6 +3845,9 @@ rp_req_dispatch(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *ski
         case SR__OPERATION__CHECK_ENABLED_RUNNING:
             rc = rp_check_enabled_running_req_process(rp_ctx, session, msg);
             break;
+        case SR__OPERATION__DP_CACHE_INVALIDATE:
+            rc = rp_dp_cache_invalidate_req_process(rp_ctx, session, msg);
+            break;
         case SR__OPERATION__GET_CHANGES:
             rc = rp_get_changes_req_process(rp_ctx, session, msg);
             break;
@@ -3363,10 +3873,8 @@ rp_req_dispatch(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *ski
             break;
     }
 
-    /* release lock */
-    if (locked) {
-        pthread_rwlock_unlock(&rp_ctx->commit_lock);
-    }
+    /* release commit locks */
+    dm_commit_lock_set_cleanup(&lock_set);
 
     return rc;
 }
@@ -3561,6 +4069,65 @@ rp_session_cleanup(const rp_ctx_t *rp_ctx, rp_session_t *session)
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Enqueues a request into the request queue. Does not take any lock
+ * unless the lock-free queue is full.
+ */
+static int
+rp_request_enqueue(rp_ctx_t *rp_ctx, rp_request_t *req)
+{
+    int rc = SR_ERR_OK;
+
+    /* use the lock-free queue unless some requests already overflowed (to keep them in order) */
+    if (0 == __atomic_load_n(&rp_ctx->request_overflow_count, __ATOMIC_ACQUIRE) &&
+            sr_mpmc_queue_enqueue(rp_ctx->request_queue, req)) {
+        return SR_ERR_OK;
+    }
+
+    pthread_mutex_lock(&rp_ctx->request_overflow_mutex);
+    rc = sr_cbuff_enqueue(rp_ctx->request_overflow, req);
+    if (SR_ERR_OK == rc) {
+        __atomic_add_fetch(&rp_ctx->request_overflow_count, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&rp_ctx->request_overflow_mutex);
+
+    return rc;
+}
+
+/**
+ * @brief Dequeues a request from the request queue, returns false if there is none.
+ */
+static bool
+rp_request_dequeue(rp_ctx_t *rp_ctx, rp_request_t *req)
+{
+    bool dequeued = false;
+
+    if (sr_mpmc_queue_dequeue(rp_ctx->request_queue, req)) {
+        return true;
+    }
+
+    if (0 != __atomic_load_n(&rp_ctx->request_overflow_count, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&rp_ctx->request_overflow_mutex);
+        dequeued = sr_cbuff_dequeue(rp_ctx->request_overflow, req);
+        if (dequeued) {
+            __atomic_sub_fetch(&rp_ctx->request_overflow_count, 1, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&rp_ctx->request_overflow_mutex);
+    }
+
+    return dequeued;
+}
+
+/**
+ * @brief Returns the number of requests waiting in the request queue (approximate).
+ */
+static size_t
+rp_request_queue_size(rp_ctx_t *rp_ctx)
+{
+    return sr_mpmc_queue_items_in_queue(rp_ctx->request_queue) +
+            __atomic_load_n(&rp_ctx->request_overflow_count, __ATOMIC_RELAXED);
+}
+
 /**
  * @brief Executes the work of a worker thread.
  */
@@ -3572,90 +4139,95 @@ rp_worker_thread_execute(void *rp_ctx_p)
     }
     rp_ctx_t *rp_ctx = (rp_ctx_t*)rp_ctx_p;
     rp_request_t req = { 0 };
-    bool dequeued = false, dequeued_prev = false, exit = false;
+    bool dequeued = false, exit = false;
+    size_t spin = 0;
 
     SR_LOG_DBG("Starting worker thread id=%lu.", (unsigned long)pthread_self());
 
-    pthread_mutex_lock(&rp_ctx->request_queue_mutex);
-    rp_ctx->active_threads++;
-    pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+    __atomic_add_fetch(&rp_ctx->active_threads, 1, __ATOMIC_SEQ_CST);
 
     do {
-        /* process requests while there are some */
-        dequeued_prev = false;
-        do {
-            /* dequeue a request */
-            pthread_mutex_lock(&rp_ctx->request_queue_mutex);
-            dequeued = sr_cbuff_dequeue(rp_ctx->request_queue, &req);
-            pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+        /* dequeue a request, spin for a while if there is none */
+        dequeued = false;
+        for (spin = 0; !dequeued && spin < RP_THREAD_SPIN_LIMIT; spin++) {
+            dequeued = rp_request_dequeue(rp_ctx, &req);
+        }
 
-            if (dequeued) {
-                /* process the request */
-                if (NULL == req.msg) {
-                    SR_LOG_DBG("Thread id=%lu received an empty request, exiting.", (unsigned long)pthread_self());
-                    exit = true;
-                } else {
-                    rp_msg_dispatch(rp_ctx, req.session, req.msg);
-                    if (NULL != req.session) {
-                        /* update message count and release session if needed */
-                        pthread_mutex_lock(&req.session->msg_count_mutex);
-                        req.session->msg_count -= 1;
-                        if (0 == req.session->msg_count && req.session->stop_requested) {
-                            pthread_mutex_unlock(&req.session->msg_count_mutex);
-                            rp_session_cleanup(rp_ctx, req.session);
-                        } else {
-                            pthread_mutex_unlock(&req.session->msg_count_mutex);
-                        }
-                    }
-                }
-                dequeued_prev = true;
-            } else {
-                /* no items in queue - spin for a while */
-                if (dequeued_prev) {
-                    /* only if the thread has actually processed something since the last wakeup */
-                    size_t count = 0;
-                    while ((0 == sr_cbuff_items_in_queue(rp_ctx->request_queue)) && (count < rp_ctx->thread_spin_limit)) {
-                        count++;
-                    }
-                }
-                pthread_mutex_lock(&rp_ctx->request_queue_mutex);
-                if (0 != sr_cbuff_items_in_queue(rp_ctx->request_queue)) {
-                    /* some items are in queue - process them */
-                    pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
-                    dequeued = true;
-                    continue;
-                } else {
-                    /* no items in queue - go to sleep */
-                    rp_ctx->active_threads--;
-                    pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
-                }
+        if (!dequeued) {
+            /* no items in queue - go to sleep */
+            pthread_mutex_lock(&rp_ctx->request_queue_mutex);
+            __atomic_sub_fetch(&rp_ctx->active_threads, 1, __ATOMIC_SEQ_CST);
+            /* pairs with the fence in rp_msg_process: either the producer sees this thread
+             * sleeping and signals it, or its request is visible to the check below */
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            while (!(dequeued = rp_request_dequeue(rp_ctx, &req)) &&
+                    !__atomic_load_n(&rp_ctx->stop_requested, __ATOMIC_ACQUIRE)) {
+                SR_LOG_DBG("Thread id=%lu will wait.",  (unsigned long)pthread_self());
+                pthread_cond_wait(&rp_ctx->request_queue_cv, &rp_ctx->request_queue_mutex);
+                SR_LOG_DBG("Thread id=%lu signaled.",  (unsigned long)pthread_self());
             }
-        } while (dequeued && !exit);
-
-        if (!exit) {
-            /* wait until new request comes */
-            SR_LOG_DBG("Thread id=%lu will wait.",  (unsigned long)pthread_self());
+            __atomic_add_fetch(&rp_ctx->active_threads, 1, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
 
-            /* wait for a signal */
-            pthread_mutex_lock(&rp_ctx->request_queue_mutex);
-            if (rp_ctx->stop_requested) {
-                /* stop has been requested, do not wait anymore */
-                pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+            if (!dequeued) {
+                /* stop has been requested and there is nothing more to process */
                 break;
             }
-            pthread_cond_wait(&rp_ctx->request_queue_cv, &rp_ctx->request_queue_mutex);
-            rp_ctx->active_threads++;
+        }
 
-            SR_LOG_DBG("Thread id=%lu signaled.",  (unsigned long)pthread_self());
-            pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+        /* process the request */
+        if (NULL == req.msg) {
+            SR_LOG_DBG("Thread id=%lu received an empty request, exiting.", (unsigned long)pthread_self());
+            exit = true;
+        } else {
+            rp_msg_dispatch(rp_ctx, req.session, req.msg);
+            if (NULL != req.session) {
+                /* update message count and release session if needed */
+                pthread_mutex_lock(&req.session->msg_count_mutex);
+                req.session->msg_count -= 1;
+                if (0 == req.session->msg_count && req.session->stop_requested) {
+                    pthread_mutex_unlock(&req.session->msg_count_mutex);
+                    rp_session_cleanup(rp_ctx, req.session);
+                } else {
+                    pthread_mutex_unlock(&req.session->msg_count_mutex);
+                }
+            }
         }
     } while (!exit);
 
+    __atomic_sub_fetch(&rp_ctx->active_threads, 1, __ATOMIC_SEQ_CST);
+
     SR_LOG_DBG("Worker thread id=%lu is exiting.",  (unsigned long)pthread_self());
 
     return NULL;
 }
 
+/**
+ * @brief Returns the number of worker threads to be started - RP_THREAD_COUNT,
+ * unless overridden by the environment variable SR_RP_THREAD_COUNT_ENV.
+ */
+static size_t
+rp_get_thread_count()
+{
+    const char *env_str = NULL;
+    char *endptr = NULL;
+    long count = 0;
+
+    env_str = getenv(SR_RP_THREAD_COUNT_ENV);
+    if (NULL == env_str) {
+        return RP_THREAD_COUNT;
+    }
+
+    count = strtol(env_str, &endptr, 10);
+    if ('\0' == *env_str || '\0' != *endptr || count < 1 || count > RP_THREAD_COUNT_MAX) {
+        SR_LOG_WRN("Invalid value '%s' of %s (expected 1-%d), using %d threads.", env_str, SR_RP_THREAD_COUNT_ENV,
+                RP_THREAD_COUNT_MAX, RP_THREAD_COUNT);
+        return RP_THREAD_COUNT;
+    }
+
+    return (size_t)count;
+}
+
 static void
 rp_cleanup_internal_state_data_records(rp_ctx_t *rp_ctx)
 {
@@ -3760,7 +4332,7 @@ rp_init(cm_ctx_t *cm_ctx, rp_ctx_t **rp_ctx_p)
 {
     size_t i = 0, j = 0;
     rp_ctx_t *ctx = NULL;
-    int ret = 0, rc = SR_ERR_OK;
+    int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG(rp_ctx_p);
 
@@ -3782,21 +4354,15 @@ rp_init(cm_ctx_t *cm_ctx, rp_ctx_t **rp_ctx_p)
     }
 
     /* initialize request queue */
-    rc = sr_cbuff_init(RP_INIT_REQ_QUEUE_SIZE, sizeof(rp_request_t), &ctx->request_queue);
+    rc = sr_mpmc_queue_init(RP_REQ_QUEUE_SIZE, sizeof(rp_request_t), &ctx->request_queue);
+    if (SR_ERR_OK == rc) {
+        rc = sr_cbuff_init(RP_INIT_REQ_OVERFLOW_SIZE, sizeof(rp_request_t), &ctx->request_overflow);
+    }
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR_MSG("RP request queue initialization failed.");
         goto cleanup;
     }
 
-    pthread_rwlockattr_t attr;
-    pthread_rwlockattr_init(&attr);
-#if defined(HAVE_PTHREAD_RWLOCKATTR_SETKIND_NP)
-    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
-#endif
-    ret = pthread_rwlock_init(&ctx->commit_lock, &attr);
-    pthread_rwlockattr_destroy(&attr);
-    CHECK_ZERO_MSG_GOTO(ret, rc, SR_ERR_INIT_FAILED, cleanup, "Commit rwlock initialization failed.");
-
 #ifndef ENABLE_CONFIG_CHANGE_NOTIF
     ctx->do_not_generate_config_change = true;
 #endif
@@ -3826,13 +4392,24 @@ rp_init(cm_ctx_t *cm_ctx, rp_ctx_t **rp_ctx_p)
     rc = rp_setup_internal_state_data(ctx);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Set up of internal state data failed");
 
+    /* initialize operational data cache */
+    rc = rp_dp_cache_init(&ctx->dp_cache);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Operational data cache initialization failed.");
+
     pthread_mutex_init(&ctx->commit_block_mutex, NULL);
 
     /* run worker threads */
+    pthread_mutex_init(&ctx->request_overflow_mutex, NULL);
     pthread_mutex_init(&ctx->request_queue_mutex, NULL);
     pthread_cond_init(&ctx->request_queue_cv, NULL);
 
-    for (i = 0; i < RP_THREAD_COUNT; i++) {
+    ctx->thread_count = rp_get_thread_count();
+    ctx->thread_pool = calloc(ctx->thread_count, sizeof(*ctx->thread_pool));
+    CHECK_NULL_NOMEM_GOTO(ctx->thread_pool, rc, cleanup);
+
+    SR_LOG_DBG("Starting %zu Request Processor worker threads.", ctx->thread_count);
+
+    for (i = 0; i < ctx->thread_count; i++) {
         rc = pthread_create(&ctx->thread_pool[i], NULL, rp_worker_thread_execute, ctx);
         if (0 != rc) {
             SR_LOG_ERR("Error by creating a new thread: %s", sr_strerror_safe(errno));
@@ -3852,7 +4429,10 @@ cleanup:
     np_cleanup(ctx->np_ctx);
     pm_cleanup(ctx->pm_ctx);
     ac_cleanup(ctx->ac_ctx);
-    sr_cbuff_cleanup(ctx->request_queue);
+    rp_dp_cache_cleanup(ctx->dp_cache);
+    sr_mpmc_queue_cleanup(ctx->request_queue);
+    sr_cbuff_cleanup(ctx->request_overflow);
+    free(ctx->thread_pool);
     free(ctx);
     return rc;
 }
@@ -3866,36 +4446,39 @@ rp_cleanup(rp_ctx_t *rp_ctx)
     SR_LOG_DBG_MSG("Request Processor cleanup started, requesting cancel of each worker thread.");
 
     if (NULL != rp_ctx) {
-        /* enqueue RP_THREAD_COUNT "empty" messages and send signal to all threads */
+        /* enqueue thread_count "empty" messages and send signal to all threads */
         pthread_mutex_lock(&rp_ctx->request_queue_mutex);
-        rp_ctx->stop_requested = true;
+        __atomic_store_n(&rp_ctx->stop_requested, true, __ATOMIC_RELEASE);
         /* enqueue empty requests to request thread exits */
-        for (i = 0; i < RP_THREAD_COUNT; i++) {
-            sr_cbuff_enqueue(rp_ctx->request_queue, &req);
+        for (i = 0; i < rp_ctx->thread_count; i++) {
+            rp_request_enqueue(rp_ctx, &req);
         }
         pthread_cond_broadcast(&rp_ctx->request_queue_cv);
         pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
 
         /* wait for threads to exit */
-        for (i = 0; i < RP_THREAD_COUNT; i++) {
+        for (i = 0; i < rp_ctx->thread_count; i++) {
             pthread_join(rp_ctx->thread_pool[i], NULL);
         }
         pthread_mutex_destroy(&rp_ctx->request_queue_mutex);
         pthread_cond_destroy(&rp_ctx->request_queue_cv);
 
-        while (sr_cbuff_dequeue(rp_ctx->request_queue, &req)) {
+        while (rp_request_dequeue(rp_ctx, &req)) {
             if (NULL != req.msg) {
                 sr_msg_free(req.msg);
             }
         }
-        pthread_rwlock_destroy(&rp_ctx->commit_lock);
         pthread_mutex_destroy(&rp_ctx->commit_block_mutex);
         dm_cleanup(rp_ctx->dm_ctx);
         np_cleanup(rp_ctx->np_ctx);
         pm_cleanup(rp_ctx->pm_ctx);
         ac_cleanup(rp_ctx->ac_ctx);
-        sr_cbuff_cleanup(rp_ctx->request_queue);
+        rp_dp_cache_cleanup(rp_ctx->dp_cache);
+        pthread_mutex_destroy(&rp_ctx->request_overflow_mutex);
+        sr_mpmc_queue_cleanup(rp_ctx->request_queue);
+        sr_cbuff_cleanup(rp_ctx->request_overflow);
         rp_cleanup_internal_state_data_records(rp_ctx);
+        free(rp_ctx->thread_pool);
         free(rp_ctx);
     }
 
@@ -3980,7 +4563,7 @@ int
 rp_msg_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
 {
     rp_request_t req = { 0 };
-    struct timespec now = { 0 };
+    size_t active_threads = 0, queue_size = 0;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG_NORET2(rc, rp_ctx, msg);
@@ -4001,43 +4584,25 @@ rp_msg_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
     req.session = session;
     req.msg = msg;
 
-    pthread_mutex_lock(&rp_ctx->request_queue_mutex);
-
-    /* enqueue the request into buffer */
-    rc = sr_cbuff_enqueue(rp_ctx->request_queue, &req);
-
-    if (0 == rp_ctx->active_threads) {
-        /* there is no active (non-sleeping) thread - if this is happening too
-         * frequently, instruct the threads to spin before going to sleep */
-        sr_clock_get_time(CLOCK_MONOTONIC, &now);
-        uint64_t diff = (1000000000L * (now.tv_sec - rp_ctx->last_thread_wakeup.tv_sec)) + now.tv_nsec - rp_ctx->last_thread_wakeup.tv_nsec;
-        if (diff < RP_THREAD_SPIN_TIMEOUT) {
-            /* a thread has been woken up in less than RP_THREAD_SPIN_TIMEOUT, increase the spin */
-            if (0 == rp_ctx->thread_spin_limit) {
-                /* no spin set yet, set to initial value */
-                rp_ctx->thread_spin_limit = RP_THREAD_SPIN_MIN;
-            } else if(rp_ctx->thread_spin_limit < RP_THREAD_SPIN_MAX) {
-                /* double the spin limit */
-                rp_ctx->thread_spin_limit *= 2;
-            }
-        } else {
-            /* reset spin to 0 if wakaups are not too frequent */
-            rp_ctx->thread_spin_limit = 0;
-        }
-        rp_ctx->last_thread_wakeup = now;
-    }
+    /* enqueue the request */
+    rc = rp_request_enqueue(rp_ctx, &req);
 
-    SR_LOG_DBG("Threads: active=%zu/%d, %zu requests in queue", rp_ctx->active_threads, RP_THREAD_COUNT,
-            sr_cbuff_items_in_queue(rp_ctx->request_queue));
+    if (SR_ERR_OK == rc) {
+        /* pairs with the fence in rp_worker_thread_execute (see the comment there) */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        active_threads = __atomic_load_n(&rp_ctx->active_threads, __ATOMIC_SEQ_CST);
+        queue_size = rp_request_queue_size(rp_ctx);
 
-    /* send signal if there is no active thread ready to process the request */
-    if (0 == rp_ctx->active_threads ||
-            (((sr_cbuff_items_in_queue(rp_ctx->request_queue) / rp_ctx->active_threads) > RP_REQ_PER_THREADS) &&
-             rp_ctx->active_threads < RP_THREAD_COUNT)) {
-        pthread_cond_signal(&rp_ctx->request_queue_cv);
-    }
+        SR_LOG_DBG("Threads: active=%zu/%zu, %zu requests in queue", active_threads, rp_ctx->thread_count, queue_size);
 
-    pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+        /* send signal if there is no active thread ready to process the request */
+        if (active_threads < rp_ctx->thread_count &&
+                (0 == active_threads || (queue_size / active_threads) > RP_REQ_PER_THREADS)) {
+            pthread_mutex_lock(&rp_ctx->request_queue_mutex);
+            pthread_cond_signal(&rp_ctx->request_queue_cv);
+            pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+        }
+    }
 
     if (SR_ERR_OK != rc) {
         /* release the message by error */
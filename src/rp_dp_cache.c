@@ -0,0 +1,335 @@
+/**
+ * @file rp_dp_cache.c
+ * @author agent <agent@local>
+ * @brief Cache of the data provided by operational data providers.
+ *
+ * @copyright
+ * Copyright 2026 agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <assert.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "sr_common.h"
+#include "rp_dp_cache.h"
+
+#define RP_DP_CACHE_PURGE_INTERVAL 1  /**< Minimal interval (in seconds) between two purges of expired entries. */
+
+/**
+ * @brief Cached response of a data provider for one requested xpath.
+ */
+typedef struct rp_dp_cache_entry_s {
+    sr_datastore_t datastore;  /**< Datastore of the request. */
+    char *xpath;               /**< Requested xpath. */
+    char *dst_address;         /**< Destination address of the subscription that provided the data. */
+    uint32_t dst_id;           /**< Destination ID of the subscription that provided the data. */
+    time_t expiry;             /**< Monotonic time (in seconds) when the entry expires. */
+    sr_val_t *values;          /**< Provided values. */
+    size_t values_cnt;         /**< Number of provided values. */
+} rp_dp_cache_entry_t;
+
+/**
+ * @brief Operational data cache context.
+ */
+struct rp_dp_cache_s {
+    sr_btree_t *entries;       /**< Cached entries ordered by datastore and xpath. */
+    pthread_rwlock_t lock;     /**< RW-lock guarding the entries. */
+    time_t last_purge;         /**< Monotonic time (in seconds) of the last purge of expired entries. */
+};
+
+/**
+ * @brief Compares two cache entries by datastore and xpath.
+ */
+static int
+rp_dp_cache_entry_cmp(const void *a, const void *b)
+{
+    assert(a);
+    assert(b);
+    const rp_dp_cache_entry_t *entry_a = (const rp_dp_cache_entry_t *) a;
+    const rp_dp_cache_entry_t *entry_b = (const rp_dp_cache_entry_t *) b;
+
+    if (entry_a->datastore != entry_b->datastore) {
+        return entry_a->datastore < entry_b->datastore ? -1 : 1;
+    }
+    return strcmp(entry_a->xpath, entry_b->xpath);
+}
+
+/**
+ * @brief Frees a cache entry.
+ */
+static void
+rp_dp_cache_entry_free(void *item)
+{
+    rp_dp_cache_entry_t *entry = (rp_dp_cache_entry_t *) item;
+
+    if (NULL != entry) {
+        free(entry->xpath);
+        free(entry->dst_address);
+        sr_free_values(entry->values, entry->values_cnt);
+        free(entry);
+    }
+}
+
+/**
+ * @brief Returns current monotonic time in seconds.
+ */
+static time_t
+rp_dp_cache_now(void)
+{
+    struct timespec ts = { 0, };
+
+    sr_clock_get_time(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec;
+}
+
+/**
+ * @brief Returns TRUE if the xpath is equal to the prefix or identifies a node under it.
+ */
+static bool
+rp_dp_cache_xpath_under(const char *xpath, const char *prefix)
+{
+    size_t len = strlen(prefix);
+
+    if (0 != strncmp(xpath, prefix, len)) {
+        return false;
+    }
+    return '\0' == xpath[len] || '/' == xpath[len] || '[' == xpath[len];
+}
+
+/**
+ * @brief Returns TRUE if the entry has been provided by the subscription and has not expired yet.
+ */
+static bool
+rp_dp_cache_entry_valid(const rp_dp_cache_entry_t *entry, const np_subscription_t *subscription, time_t now)
+{
+    return now < entry->expiry && entry->dst_id == subscription->dst_id &&
+            0 == strcmp(entry->dst_address, subscription->dst_address);
+}
+
+/**
+ * @brief Removes all entries matching the xpath (or all expired entries if the xpath is NULL).
+ * Cache must be write-locked.
+ */
+static int
+rp_dp_cache_remove_entries(rp_dp_cache_t *cache, const char *xpath, time_t now)
+{
+    rp_dp_cache_entry_t *entry = NULL;
+    sr_list_t *to_remove = NULL;
+    size_t i = 0;
+    int rc = SR_ERR_OK;
+
+    rc = sr_list_init(&to_remove);
+    CHECK_RC_MSG_RETURN(rc, "List init failed");
+
+    while (NULL != (entry = sr_btree_get_at(cache->entries, i++))) {
+        if (NULL == xpath ? (now >= entry->expiry) :
+                (rp_dp_cache_xpath_under(entry->xpath, xpath) || rp_dp_cache_xpath_under(xpath, entry->xpath))) {
+            rc = sr_list_add(to_remove, entry);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
+        }
+    }
+
+cleanup:
+    for (i = 0; i < to_remove->count; i++) {
+        sr_btree_delete(cache->entries, to_remove->data[i]);
+    }
+    if (to_remove->count > 0) {
+        SR_LOG_DBG("%zu entries removed from the operational data cache.", to_remove->count);
+    }
+    sr_list_cleanup(to_remove);
+    return rc;
+}
+
+int
+rp_dp_cache_init(rp_dp_cache_t **cache_p)
+{
+    rp_dp_cache_t *cache = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG(cache_p);
+
+    cache = calloc(1, sizeof(*cache));
+    CHECK_NULL_NOMEM_RETURN(cache);
+
+    rc = sr_btree_init(rp_dp_cache_entry_cmp, rp_dp_cache_entry_free, &cache->entries);
+    if (SR_ERR_OK != rc) {
+        free(cache);
+        SR_LOG_ERR_MSG("Cannot allocate binary tree for the operational data cache.");
+        return rc;
+    }
+    pthread_rwlock_init(&cache->lock, NULL);
+
+    *cache_p = cache;
+    return SR_ERR_OK;
+}
+
+void
+rp_dp_cache_cleanup(rp_dp_cache_t *cache)
+{
+    if (NULL != cache) {
+        sr_btree_cleanup(cache->entries);
+        pthread_rwlock_destroy(&cache->lock);
+        free(cache);
+    }
+}
+
+int
+rp_dp_cache_lookup(rp_dp_cache_t *cache, sr_datastore_t datastore, const np_subscription_t *subscription,
+        const char *xpath, Sr__Value ***values_p, size_t *values_cnt_p)
+{
+    rp_dp_cache_entry_t lookup = { 0, }, *entry = NULL;
+    Sr__Value **values = NULL;
+    size_t values_cnt = 0, orig_cnt = 0;
+    sr_val_t value = { 0, };
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG5(cache, subscription, xpath, values_p, values_cnt_p);
+
+    if (0 == subscription->dp_cache_ttl) {
+        return SR_ERR_NOT_FOUND;
+    }
+
+    lookup.datastore = datastore;
+    lookup.xpath = (char *) xpath;
+
+    pthread_rwlock_rdlock(&cache->lock);
+
+    entry = sr_btree_search(cache->entries, &lookup);
+    if (NULL == entry || !rp_dp_cache_entry_valid(entry, subscription, rp_dp_cache_now())) {
+        rc = SR_ERR_NOT_FOUND;
+        goto unlock;
+    }
+
+    orig_cnt = values_cnt = *values_cnt_p;
+    if (entry->values_cnt > 0) {
+        values = realloc(*values_p, (values_cnt + entry->values_cnt) * sizeof(*values));
+        CHECK_NULL_NOMEM_GOTO(values, rc, unlock);
+        *values_p = values;
+
+        for (size_t i = 0; i < entry->values_cnt; i++) {
+            /* the GPB values must not share memory with the cache entry */
+            value = entry->values[i];
+            value._sr_mem = NULL;
+            rc = sr_dup_val_t_to_gpb(&value, &values[values_cnt]);
+            CHECK_RC_MSG_GOTO(rc, unlock, "Unable to duplicate sr_val_t to GPB.");
+            values_cnt++;
+        }
+    }
+    SR_LOG_DBG("Operational data for %s served from the cache.", xpath);
+
+unlock:
+    if (SR_ERR_OK == rc) {
+        *values_cnt_p = values_cnt;
+    } else {
+        /* drop partially copied values of this entry */
+        for (size_t i = orig_cnt; i < values_cnt; i++) {
+            sr__value__free_unpacked(values[i], NULL);
+        }
+    }
+    pthread_rwlock_unlock(&cache->lock);
+    return rc;
+}
+
+int
+rp_dp_cache_store(rp_dp_cache_t *cache, sr_datastore_t datastore, const np_subscription_t *subscription,
+        const char *xpath, const sr_val_t *values, size_t values_cnt)
+{
+    rp_dp_cache_entry_t lookup = { 0, }, *entry = NULL, *existing = NULL;
+    sr_val_t *selected = NULL;
+    size_t selected_cnt = 0;
+    time_t now = 0;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(cache, subscription, subscription->dst_address, xpath);
+
+    if (0 == subscription->dp_cache_ttl) {
+        return SR_ERR_OK;
+    }
+
+    /* pick the values provided for the xpath */
+    if (values_cnt > 0) {
+        selected = calloc(values_cnt, sizeof(*selected));
+        CHECK_NULL_NOMEM_RETURN(selected);
+        for (size_t i = 0; i < values_cnt; i++) {
+            if (NULL != values[i].xpath && rp_dp_cache_xpath_under(values[i].xpath, xpath)) {
+                selected[selected_cnt++] = values[i];
+            }
+        }
+    }
+
+    entry = calloc(1, sizeof(*entry));
+    CHECK_NULL_NOMEM_GOTO(entry, rc, cleanup);
+
+    entry->datastore = datastore;
+    entry->dst_id = subscription->dst_id;
+    entry->xpath = strdup(xpath);
+    CHECK_NULL_NOMEM_GOTO(entry->xpath, rc, cleanup);
+    entry->dst_address = strdup(subscription->dst_address);
+    CHECK_NULL_NOMEM_GOTO(entry->dst_address, rc, cleanup);
+    if (selected_cnt > 0) {
+        rc = sr_dup_values(selected, selected_cnt, &entry->values);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to duplicate provided values.");
+        entry->values_cnt = selected_cnt;
+    }
+
+    pthread_rwlock_wrlock(&cache->lock);
+
+    now = rp_dp_cache_now();
+    entry->expiry = now + subscription->dp_cache_ttl;
+
+    if (now - cache->last_purge >= RP_DP_CACHE_PURGE_INTERVAL) {
+        rp_dp_cache_remove_entries(cache, NULL, now);
+        cache->last_purge = now;
+    }
+
+    lookup.datastore = datastore;
+    lookup.xpath = (char *) xpath;
+    existing = sr_btree_search(cache->entries, &lookup);
+    if (NULL != existing) {
+        if (rp_dp_cache_entry_valid(existing, subscription, now)) {
+            /* keep the original expiry of fresh data (e.g. data just served from the cache) */
+            pthread_rwlock_unlock(&cache->lock);
+            goto cleanup;
+        }
+        sr_btree_delete(cache->entries, existing);
+    }
+
+    rc = sr_btree_insert(cache->entries, entry);
+    pthread_rwlock_unlock(&cache->lock);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to cache operational data for %s.", xpath);
+    entry = NULL;
+
+cleanup:
+    rp_dp_cache_entry_free(entry);
+    free(selected);
+    return rc;
+}
+
+int
+rp_dp_cache_invalidate(rp_dp_cache_t *cache, const char *xpath)
+{
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(cache, xpath);
+
+    SR_LOG_DBG("Invalidating cached operational data for %s.", xpath);
+
+    pthread_rwlock_wrlock(&cache->lock);
+    rc = rp_dp_cache_remove_entries(cache, xpath, 0);
+    pthread_rwlock_unlock(&cache->lock);
+
+    return rc;
+}
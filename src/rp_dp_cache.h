@@ -0,0 +1,100 @@
+/**
+ * @defgroup rp_dp_cache Operational data cache
+ * @ingroup rp
+ * @{
+ * @brief Cache of the data provided by operational data providers.
+ * @file rp_dp_cache.h
+ * @author agent <agent@local>
+ *
+ * @copyright
+ * Copyright 2026 agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RP_DP_CACHE_H_
+#define RP_DP_CACHE_H_
+
+#include "sr_common.h"
+#include "notification_processor.h"
+
+/**
+ * @brief Cache of the operational data provider responses. Entries are keyed
+ * by the datastore and the requested xpath and belong to the data provider
+ * subscription that provided them. Data expire after the TTL declared by
+ * the subscription (see ::np_subscription_t::dp_cache_ttl).
+ */
+typedef struct rp_dp_cache_s rp_dp_cache_t;
+
+/**
+ * @brief Allocates and initializes an empty operational data cache.
+ *
+ * @param[out] cache Allocated cache.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int rp_dp_cache_init(rp_dp_cache_t **cache);
+
+/**
+ * @brief Releases the cache including all cached data.
+ *
+ * @param[in] cache Cache to be freed.
+ */
+void rp_dp_cache_cleanup(rp_dp_cache_t *cache);
+
+/**
+ * @brief Looks up fresh data provided by the subscription for given xpath. If found, copies
+ * of the cached values are appended to the provided GPB values array.
+ *
+ * @param[in] cache Operational data cache.
+ * @param[in] datastore Datastore of the request.
+ * @param[in] subscription Data provider subscription the data would be requested from.
+ * @param[in] xpath Requested xpath.
+ * @param[in,out] values Array of GPB values (can be reallocated).
+ * @param[in,out] values_cnt Number of values in the array.
+ *
+ * @return Error code (SR_ERR_OK on cache hit, SR_ERR_NOT_FOUND on cache miss).
+ */
+int rp_dp_cache_lookup(rp_dp_cache_t *cache, sr_datastore_t datastore, const np_subscription_t *subscription,
+        const char *xpath, Sr__Value ***values, size_t *values_cnt);
+
+/**
+ * @brief Stores data provided by the subscription for given xpath, picking the values that
+ * belong to the xpath from the provided array. Does nothing if the subscription does not
+ * allow caching or fresh data for the xpath are already cached.
+ *
+ * @param[in] cache Operational data cache.
+ * @param[in] datastore Datastore of the request.
+ * @param[in] subscription Data provider subscription that provided the data.
+ * @param[in] xpath Requested xpath.
+ * @param[in] values Values provided by the data provider (for this and possibly other xpaths).
+ * @param[in] values_cnt Number of values.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int rp_dp_cache_store(rp_dp_cache_t *cache, sr_datastore_t datastore, const np_subscription_t *subscription,
+        const char *xpath, const sr_val_t *values, size_t values_cnt);
+
+/**
+ * @brief Drops all cached data at, under or above given xpath in all datastores.
+ *
+ * @param[in] cache Operational data cache.
+ * @param[in] xpath XPath of changed operational data.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int rp_dp_cache_invalidate(rp_dp_cache_t *cache, const char *xpath);
+
+/**@} rp_dp_cache */
+
+#endif /* RP_DP_CACHE_H_ */
@@ -301,7 +301,9 @@ cleanup:
     ly_set_free(parents);
     ly_set_free(nodes);
     /* mark to session copy that some change has been made */
-    info->modified = SR_ERR_OK == rc ? true : info->modified;
+    if (SR_ERR_OK == rc) {
+        dm_data_info_set_modified(info, xpath);
+    }
     return rc;
 }
 
@@ -446,8 +448,8 @@ rp_dt_set_item(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath, const
 
 cleanup:
     free(new_value);
-    if (NULL != info) {
-        info->modified = SR_ERR_OK == rc ? true : info->modified;
+    if (NULL != info && SR_ERR_OK == rc) {
+        dm_data_info_set_modified(info, xpath);
     }
     return rc;
 }
@@ -532,7 +534,83 @@ rp_dt_move_list(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath, sr_m
     CHECK_RC_MSG_GOTO(rc, cleanup, "Moving of the node failed");
 
 cleanup:
-    info->modified = SR_ERR_OK == rc ? true : info->modified;
+    if (SR_ERR_OK == rc) {
+        dm_data_info_set_modified(info, xpath);
+    }
+    return rc;
+}
+
+/**
+ * @brief Checks that all nodes of the subtree are enabled in running datastore.
+ */
+static bool
+rp_dt_is_subtree_enabled(const struct lyd_node *node)
+{
+    const struct lyd_node *child = NULL;
+
+    if (!dm_is_enabled_check_recursively(node->schema)) {
+        return false;
+    }
+    if (dm_is_node_enabled_with_children(node->schema) || !((LYS_CONTAINER | LYS_LIST) & node->schema->nodetype)) {
+        return true;
+    }
+    LY_TREE_FOR(node->child, child) {
+        if (!rp_dt_is_subtree_enabled(child)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int
+rp_dt_import_data(dm_ctx_t *dm_ctx, dm_session_t *session, const char *module_name, const char *data, LYD_FORMAT format, bool replace)
+{
+    CHECK_NULL_ARG4(dm_ctx, session, module_name, data);
+    int rc = SR_ERR_OK;
+    dm_data_info_t *info = NULL;
+    struct lyd_node *new_tree = NULL, *node = NULL;
+
+    /* get data tree to be updated */
+    rc = dm_get_data_info(dm_ctx, session, module_name, &info);
+    CHECK_RC_LOG_RETURN(rc, "Getting data tree failed for module '%s'", module_name);
+
+    /* parse the data in the context of the module, validation is postponed to the commit */
+    ly_errno = LY_SUCCESS;
+    new_tree = lyd_parse_mem(info->schema->ly_ctx, data, format, LYD_OPT_CONFIG | LYD_OPT_STRICT | LYD_OPT_TRUSTED);
+    if (NULL == new_tree && LY_SUCCESS != ly_errno) {
+        SR_LOG_ERR("Unable to parse the imported data of module '%s': %s", module_name, ly_errmsg());
+        return dm_report_error(session, ly_errmsg(), ly_errpath(), SR_ERR_INVAL_ARG);
+    }
+
+    /* only the data of the module can be imported */
+    LY_TREE_FOR(new_tree, node) {
+        if (lyd_node_module(node) != info->schema->module) {
+            SR_LOG_ERR("Imported data of module '%s' contain a node of module '%s'", module_name, lyd_node_module(node)->name);
+            rc = dm_report_error(session, "Imported data contain a node of another module", node->schema->name, SR_ERR_INVAL_ARG);
+            goto cleanup;
+        }
+        if (dm_is_running_ds_session(session) && !rp_dt_is_subtree_enabled(node)) {
+            SR_LOG_ERR("Imported data of module '%s' contain nodes not enabled in running datastore", module_name);
+            rc = dm_report_error(session, "The node is not enabled in running datastore", node->schema->name, SR_ERR_INVAL_ARG);
+            goto cleanup;
+        }
+    }
+
+    if (replace || NULL == info->node) {
+        lyd_free_withsiblings(info->node);
+        info->node = new_tree;
+        new_tree = NULL;
+    } else if (NULL != new_tree) {
+        if (0 != lyd_merge(info->node, new_tree, LYD_OPT_EXPLICIT)) {
+            SR_LOG_ERR("Merge of the imported data of module '%s' failed: %s", module_name, ly_errmsg());
+            rc = dm_report_error(session, ly_errmsg(), ly_errpath(), SR_ERR_INVAL_ARG);
+            goto cleanup;
+        }
+    }
+    dm_data_info_set_modified(info, NULL);
+
+cleanup:
+    lyd_free_withsiblings(new_tree);
     return rc;
 }
 
@@ -611,6 +689,41 @@ rp_dt_delete_item_wrapper(rp_ctx_t *rp_ctx, rp_session_t *session, const char *x
     return rc;
 }
 
+int
+rp_dt_import_data_wrapper(rp_ctx_t *rp_ctx, rp_session_t *session, const char *module_name, char *data, LYD_FORMAT format, bool replace)
+{
+    int rc = SR_ERR_OK;
+    CHECK_NULL_ARG_NORET3(rc, rp_ctx, session, module_name);
+    if (SR_ERR_OK == rc) {
+        CHECK_NULL_ARG_NORET2(rc, rp_ctx->dm_ctx, session->dm_session);
+    }
+    if (SR_ERR_OK != rc) {
+        /* data are taken over in any case */
+        free(data);
+        return rc;
+    }
+
+    SR_LOG_INF("Import data request %s datastore, module: %s", sr_ds_to_str(session->datastore), module_name);
+
+    rc = ac_check_module_permissions(session->ac_session, module_name, AC_OPER_READ_WRITE);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Access control check failed for module '%s'", module_name);
+        free(data);
+        return rc;
+    }
+
+    rc = dm_add_import_operation(session->dm_session, module_name, data, format, replace);
+    /* data is freed by dm_add_import_operation */
+    CHECK_RC_MSG_RETURN(rc, "Adding operation to session op list failed");
+
+    rc = rp_dt_import_data(rp_ctx->dm_ctx, session->dm_session, module_name, data, format, replace);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR_MSG("Import of data failed");
+        dm_remove_last_operation(session->dm_session);
+    }
+    return rc;
+}
+
 /**
  * @brief Perform the list of provided operations on the session. Stops
  * on the first error, if continue on error is false. If the continue on error
@@ -660,6 +773,10 @@ rp_dt_replay_operations(dm_ctx_t *ctx, dm_session_t *session, dm_sess_op_t *oper
         case DM_MOVE_OP:
             rc = rp_dt_move_list(ctx, session, op->xpath, op->detail.mov.position, op->detail.mov.relative_item);
             break;
+        case DM_IMPORT_OP:
+            rc = rp_dt_import_data(ctx, session, op->detail.imp.module_name, op->detail.imp.data,
+                    op->detail.imp.format, op->detail.imp.replace);
+            break;
         }
 
         if (SR_ERR_OK != rc) {
@@ -938,6 +1055,9 @@ rp_dt_create_refresh_errors(const dm_sess_op_t *ops, size_t op_count, sr_error_i
         case DM_MOVE_OP:
             (*errors)[*err_cnt].message = strdup("MOVE Operation can not be merged with current datastore state");
             break;
+        case DM_IMPORT_OP:
+            (*errors)[*err_cnt].message = strdup("IMPORT Operation can not be merged with current datastore state");
+            break;
         default:
             (*errors)[*err_cnt].message = strdup("An operation can not be merged with current datastore state");
         }
@@ -1032,7 +1152,7 @@ rp_dt_copy_config_to_running(rp_ctx_t* rp_ctx, rp_session_t* session, const char
         /* load data tree if it was not copied from backup session */
         rc = dm_get_data_info(rp_ctx->dm_ctx, session->dm_session, module_name, &info);
         CHECK_RC_MSG_GOTO(rc, cleanup, "Get data info failed");
-        info->modified = true;
+        dm_data_info_set_modified(info, NULL);
     } else {
 
         /* load all enabled models */
@@ -1046,7 +1166,7 @@ rp_dt_copy_config_to_running(rp_ctx_t* rp_ctx, rp_session_t* session, const char
             char *module = modules->data[i];
             rc = dm_get_data_info(rp_ctx->dm_ctx, session->dm_session, module, &info);
             CHECK_RC_LOG_GOTO(rc, cleanup, "Get data info failed %s", module);
-            info->modified = true;
+            dm_data_info_set_modified(info, NULL);
         }
 
     }
@@ -67,6 +67,33 @@ int rp_dt_set_item(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath, c
  */
 int rp_dt_move_list(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath, sr_move_position_t position, const char *relative_item);
 
+/**
+ * @brief Imports the serialized data tree of the module into the session. The data are either merged
+ * into the current data tree of the module or replace it. Only the data nodes of the specified module
+ * can be imported, validation is postponed to the commit.
+ * @param [in] dm_ctx
+ * @param [in] session
+ * @param [in] module_name
+ * @param [in] data - serialized data tree
+ * @param [in] format - format of the serialized data tree (LYD_XML or LYD_JSON)
+ * @param [in] replace - replace the data of the module instead of merging
+ * @return Error code (SR_ERR_OK on success) SR_ERR_UNKNOWN_MODEL, SR_ERR_INVAL_ARG
+ */
+int rp_dt_import_data(dm_ctx_t *dm_ctx, dm_session_t *session, const char *module_name, const char *data, LYD_FORMAT format, bool replace);
+
+/**
+ * @brief Wraps ::rp_dt_import_data call, in case of success logs the import as a single operation
+ * to the session's operation list. Data are freed with the operation list (or right away in case of error).
+ * @param [in] rp_ctx
+ * @param [in] session
+ * @param [in] module_name
+ * @param [in] data - serialized data tree, must be allocated, it is taken over (freed) even in case of error
+ * @param [in] format
+ * @param [in] replace
+ * @return Error code (SR_ERR_OK on success)
+ */
+int rp_dt_import_data_wrapper(rp_ctx_t *rp_ctx, rp_session_t *session, const char *module_name, char *data, LYD_FORMAT format, bool replace);
+
 /**
  * @brief Wraps ::rp_dt_move_list call, in case of success logs the operation to the session's operation list.
  * @param [in] rp_ctx
@@ -102,12 +129,12 @@ int rp_dt_delete_item_wrapper(rp_ctx_t *rp_ctx, rp_session_t *session, const cha
 
 /**
  * @brief Saves the changes made in the session to the file system. To make sure that only one commit
- * can be in progress at the same time commit_lock in rp_ctx is used. To solve potential
- * conflict with sysrepo library, each individual data file is locked. In case of
+ * of a module can be in progress at the same time, the caller holds commit locks of the modified
+ * modules for writing (see ::dm_commit_lock_set_t). Commits of disjoint sets of modules can run
+ * in parallel. To solve potential conflict with sysrepo library, each individual data file is locked. In case of
  * failure to lock data file, the commit process is stopped and SR_ERR_COMMIT_FAILED is returned.
  * The commit process can be divided into 5 steps:
- * - validation of modified data trees (in case of error SR_ERR_VALIDATION_FAILED is returned),
- * after successful validation commit_lock is acquired.
+ * - validation of modified data trees (in case of error SR_ERR_VALIDATION_FAILED is returned)
  * - initialization of the commit session where all modified models are loaded
  * from file system
  * - operation made in session are applied to the commit session
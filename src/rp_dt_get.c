@@ -175,6 +175,56 @@ rp_dt_get_values_from_nodes(sr_mem_ctx_t *sr_mem, struct ly_set *nodes, sr_val_t
     return rc;
 }
 
+int
+rp_dt_get_gpb_values_from_nodes(sr_mem_ctx_t *sr_mem, struct ly_set *nodes, Sr__Value ***values, size_t *value_cnt)
+{
+    CHECK_NULL_ARG4(sr_mem, nodes, values, value_cnt);
+    int rc = SR_ERR_OK;
+    Sr__Value **vals = NULL;
+    sr_val_t val = { 0, };
+    sr_mem_snapshot_t snapshot = { 0, };
+    size_t cnt = 0;
+    struct lyd_node *node = NULL;
+
+    if (0 == nodes->number) {
+        *values = NULL;
+        *value_cnt = 0;
+        return rc;
+    }
+
+    sr_mem_snapshot(sr_mem, &snapshot);
+
+    vals = sr_calloc(sr_mem, nodes->number, sizeof(*vals));
+    CHECK_NULL_NOMEM_RETURN(vals);
+
+    for (size_t i = 0; i < nodes->number; i++) {
+        node = nodes->set.d[i];
+        if (NULL == node || NULL == node->schema || LYS_RPC == node->schema->nodetype ||
+            LYS_NOTIF == node->schema->nodetype || LYS_ACTION == node->schema->nodetype) {
+            /* ignore this node */
+            continue;
+        }
+        /* the value is only a carrier, its strings are allocated in sr_mem and shared with GPB */
+        memset(&val, 0, sizeof(val));
+        val._sr_mem = sr_mem;
+        rc = rp_dt_get_value_from_node(node, &val);
+        if (SR_ERR_OK == rc) {
+            rc = sr_dup_val_t_to_gpb(&val, &vals[cnt]);
+        }
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Getting value from node %s failed", node->schema->name);
+            sr_mem_restore(&snapshot);
+            return SR_ERR_INTERNAL;
+        }
+        cnt++;
+    }
+
+    *values = vals;
+    *value_cnt = cnt;
+
+    return rc;
+}
+
 int
 rp_dt_get_value(dm_ctx_t *dm_ctx, rp_session_t *rp_session, struct lyd_node *data_tree, sr_mem_ctx_t *sr_mem,
         const char *xpath, bool check_enabled, sr_val_t **value)
@@ -254,6 +304,42 @@ cleanup:
     return rc;
 }
 
+int
+rp_dt_get_gpb_values(dm_ctx_t *dm_ctx, rp_session_t *rp_session, struct lyd_node *data_tree, sr_mem_ctx_t *sr_mem,
+        const char *xpath, bool check_enable, Sr__Value ***values, size_t *count)
+{
+    CHECK_NULL_ARG5(dm_ctx, data_tree, xpath, values, count);
+
+    int rc = SR_ERR_OK;
+    struct ly_set *nodes = NULL;
+
+    rc = rp_dt_find_nodes(dm_ctx, data_tree, xpath, check_enable, &nodes);
+    if (SR_ERR_OK != rc) {
+        if (SR_ERR_NOT_FOUND != rc) {
+            SR_LOG_ERR("Get nodes for xpath %s failed (%d)", xpath, rc);
+        }
+        goto cleanup;
+    }
+
+    rc = rp_dt_nacm_filtering(dm_ctx, rp_session, data_tree, nodes->set.d, &nodes->number);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to filter nodes by NACM read access.");
+    if (0 == nodes->number) {
+        rc = SR_ERR_NOT_FOUND;
+        goto cleanup;
+    }
+
+    rc = rp_dt_get_gpb_values_from_nodes(sr_mem, nodes, values, count);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Copying values from nodes failed for xpath '%s'", xpath);
+    }
+
+cleanup:
+    if (NULL != nodes) {
+        ly_set_free(nodes);
+    }
+    return rc;
+}
+
 int
 rp_dt_get_subtree(dm_ctx_t *dm_ctx, rp_session_t *rp_session, struct lyd_node *data_tree, sr_mem_ctx_t *sr_mem,
         const char *xpath, bool check_enabled, sr_node_t **subtree)
@@ -402,6 +488,43 @@ cleanup:
     return rc;
 }
 
+int
+rp_dt_get_gpb_subtrees(dm_ctx_t *dm_ctx, rp_session_t *rp_session, struct lyd_node *data_tree, sr_mem_ctx_t *sr_mem,
+        const char *xpath, bool check_enable, Sr__Node ***subtrees, size_t *count)
+{
+    CHECK_NULL_ARG5(dm_ctx, data_tree, xpath, subtrees, count);
+    int rc = SR_ERR_OK;
+    struct ly_set *nodes = NULL;
+    sr_tree_pruning_cb pruning_cb = NULL;
+    rp_tree_pruning_ctx_t *pruning_ctx = NULL;
+
+    rc = rp_dt_find_nodes(dm_ctx, data_tree, xpath, check_enable, &nodes);
+    if (SR_ERR_OK != rc) {
+        if (SR_ERR_NOT_FOUND != rc) {
+            SR_LOG_ERR("Get nodes for xpath %s failed (%d)", xpath, rc);
+        }
+        return rc;
+    }
+
+    rc = rp_dt_init_tree_pruning(dm_ctx, rp_session, NULL, data_tree, check_enable, &pruning_cb, &pruning_ctx);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to initialize sysrepo tree pruning.");
+
+    rc = sr_nodes_to_gpb_trees(nodes, sr_mem, pruning_cb, (void *)pruning_ctx, subtrees, count);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Conversion of nodes to GPB trees failed for xpath '%s'", xpath);
+        goto cleanup;
+    }
+    if (0 == *count) {
+        rc = SR_ERR_NOT_FOUND;
+        goto cleanup;
+    }
+
+cleanup:
+    rp_dt_cleanup_tree_pruning(pruning_ctx);
+    ly_set_free(nodes);
+    return rc;
+}
+
 int
 rp_dt_get_subtrees_chunks(dm_ctx_t *dm_ctx, rp_session_t *rp_session, struct lyd_node *data_tree, sr_mem_ctx_t *sr_mem,
         const char *xpath, size_t slice_offset, size_t slice_width, size_t child_limit, size_t depth_limit,
@@ -924,6 +1047,144 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Adds the xpaths to the list of requested xpaths of the session, the strings are moved to the list.
+ */
+static int
+rp_dt_add_requested_xpaths(rp_session_t *rp_session, char **xpaths, size_t xpath_cnt)
+{
+    int rc = SR_ERR_OK;
+
+    for (size_t i = 0; i < xpath_cnt; i++) {
+        rc = sr_list_add(rp_session->state_data_ctx.requested_xpaths, xpaths[i]);
+        CHECK_RC_MSG_RETURN(rc, "Failed to add requested xpath");
+        xpaths[i] = NULL;
+    }
+    return rc;
+}
+
+/**
+ * @brief Enqueues a data provide response built from the data found in the operational data cache,
+ * so that it is processed the same way as the response of the data provider.
+ */
+static int
+rp_dt_enqueue_cached_dp_data(rp_ctx_t *rp_ctx, rp_session_t *rp_session, char **xpaths, size_t xpath_cnt,
+        Sr__Value **values, size_t values_cnt)
+{
+    Sr__Msg *resp = NULL;
+    Sr__DataProvideResp *dp_resp = NULL;
+    int rc = SR_ERR_OK;
+
+    rc = sr_gpb_resp_alloc(NULL, SR__OPERATION__DATA_PROVIDE, rp_session->id, &resp);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to allocate data provide response");
+
+    dp_resp = resp->response->data_provide_resp;
+    dp_resp->request_id = (intptr_t) rp_session->req;
+    dp_resp->xpath = strdup(xpaths[0]);
+    CHECK_NULL_NOMEM_GOTO(dp_resp->xpath, rc, cleanup);
+
+    if (xpath_cnt > 1) {
+        dp_resp->xpaths = calloc(xpath_cnt, sizeof(*dp_resp->xpaths));
+        CHECK_NULL_NOMEM_GOTO(dp_resp->xpaths, rc, cleanup);
+        for (size_t i = 0; i < xpath_cnt; i++) {
+            dp_resp->xpaths[i] = strdup(xpaths[i]);
+            CHECK_NULL_NOMEM_GOTO(dp_resp->xpaths[i], rc, cleanup);
+            dp_resp->n_xpaths = i + 1;
+        }
+    }
+
+    /* the values are moved to the message */
+    dp_resp->values = values;
+    dp_resp->n_values = values_cnt;
+    values = NULL;
+    values_cnt = 0;
+
+    rc = rp_msg_process(rp_ctx, rp_session, resp);
+    resp = NULL;
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to enqueue message");
+
+cleanup:
+    sr_msg_free(resp);
+    for (size_t i = 0; i < values_cnt; i++) {
+        sr__value__free_unpacked(values[i], NULL);
+    }
+    free(values);
+    return rc;
+}
+
+int
+rp_dt_request_dp_data(rp_ctx_t *rp_ctx, rp_session_t *rp_session, np_subscription_t *subscription, char **xpaths, size_t xpath_cnt)
+{
+    CHECK_NULL_ARG4(rp_ctx, rp_session, subscription, xpaths);
+    char **hits = NULL;
+    size_t hit_cnt = 0, miss_cnt = 0;
+    Sr__Value **values = NULL;
+    size_t values_cnt = 0;
+    int rc = SR_ERR_OK;
+
+    if (0 == xpath_cnt) {
+        return SR_ERR_OK;
+    }
+
+    /* split the xpaths into the ones served from the cache and the ones requested from the data provider */
+    miss_cnt = xpath_cnt;
+    if (subscription->dp_cache_ttl > 0) {
+        hits = calloc(xpath_cnt, sizeof(*hits));
+        CHECK_NULL_NOMEM_GOTO(hits, rc, cleanup);
+
+        miss_cnt = 0;
+        for (size_t i = 0; i < xpath_cnt; i++) {
+            if (SR_ERR_OK == rp_dp_cache_lookup(rp_ctx->dp_cache, rp_session->datastore, subscription, xpaths[i],
+                    &values, &values_cnt)) {
+                hits[hit_cnt++] = xpaths[i];
+            } else {
+                xpaths[miss_cnt++] = xpaths[i];
+            }
+        }
+    }
+
+    if (miss_cnt > 0) {
+        SR_LOG_DBG("Sending request for state data: %s (%zu xpaths in the batch)", xpaths[0], miss_cnt);
+        rc = np_data_provider_request(rp_ctx->np_ctx, subscription, rp_session, xpaths, miss_cnt);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_WRN("Request for operational data failed with xpath %s on subscription %s", xpaths[0], subscription->xpath);
+            goto cleanup;
+        }
+        rp_session->dp_req_waiting += 1;
+        rc = rp_dt_add_requested_xpaths(rp_session, xpaths, miss_cnt);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to add requested xpaths");
+    }
+
+    if (hit_cnt > 0) {
+        SR_LOG_DBG("State data for %s (%zu xpaths) served from the cache", hits[0], hit_cnt);
+        rc = rp_dt_enqueue_cached_dp_data(rp_ctx, rp_session, hits, hit_cnt, values, values_cnt);
+        values = NULL;
+        values_cnt = 0;
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to enqueue cached state data");
+        rp_session->dp_req_waiting += 1;
+        rc = rp_dt_add_requested_xpaths(rp_session, hits, hit_cnt);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to add requested xpaths");
+    }
+
+cleanup:
+    for (size_t i = 0; i < miss_cnt; i++) {
+        free(xpaths[i]);
+    }
+    for (size_t i = 0; i < hit_cnt; i++) {
+        free(hits[i]);
+    }
+    /* the moved-out entries must not be freed by the caller */
+    for (size_t i = 0; i < xpath_cnt; i++) {
+        xpaths[i] = NULL;
+    }
+    free(hits);
+    for (size_t i = 0; i < values_cnt; i++) {
+        sr__value__free_unpacked(values[i], NULL);
+    }
+    free(values);
+    return rc;
+}
+
 /**
  *
  * @param [in] rp_ctx
@@ -971,35 +1232,28 @@ rp_dt_send_request_to_dp_subscription(rp_ctx_t *rp_ctx, rp_session_t *rp_session
 
         size_t suffix_len = strlen(ptr);
 
+        /* requested xpaths replace instance xpaths in place, all of them are sent in a single request */
         for (size_t i = 0; i < xp_cnt; i++) {
             size_t len = strlen(xpaths[i]) + suffix_len + 2 /* slash + zero byte */;
             request_xp = calloc(len, sizeof(*request_xp));
             CHECK_NULL_NOMEM_GOTO(request_xp, rc, cleanup);
 
             snprintf(request_xp, len, "%s/%s", xpaths[i], ptr);
-
-            rc = np_data_provider_request(rp_ctx->np_ctx, subscription, rp_session, request_xp);
-            SR_LOG_DBG("Sending request for state data: %s", request_xp);
-            if (SR_ERR_OK != rc) {
-                SR_LOG_WRN("Request for operational data failed with xpath %s on subscription %s", request_xp, subscription->xpath);
-                free(request_xp);
-            } else {
-                rp_session->dp_req_waiting += 1;
-                rc = sr_list_add(rp_session->state_data_ctx.requested_xpaths, request_xp);
-            }
+            free(xpaths[i]);
+            xpaths[i] = request_xp;
+            request_xp = NULL;
         }
         free(xp);
         xp = NULL;
 
-    } else {
-        rc = np_data_provider_request(rp_ctx->np_ctx, subscription, rp_session, xp);
-        SR_LOG_DBG("Sending request for state data: %s", xp);
-        if (SR_ERR_OK != rc) {
-            SR_LOG_WRN("Request for operational data failed with xpath %s on subscription %s", xp, subscription->xpath);
-        } else {
-            rp_session->dp_req_waiting += 1;
-            rc = sr_list_add(rp_session->state_data_ctx.requested_xpaths, xp);
+        if (0 == xp_cnt) {
+            goto cleanup;
         }
+
+        rc = rp_dt_request_dp_data(rp_ctx, rp_session, subscription, xpaths, xp_cnt);
+    } else {
+        rc = rp_dt_request_dp_data(rp_ctx, rp_session, subscription, &xp, 1);
+        xp = NULL;
     }
 
 cleanup:
@@ -1169,7 +1423,7 @@ rp_dt_prepare_data(rp_ctx_t *rp_ctx, rp_session_t *rp_session, const char *xpath
 {
     CHECK_NULL_ARG4(rp_ctx, rp_session, xpath, data_tree);
     int rc = SR_ERR_OK;
-    bool has_state_data = false;
+    bool has_state_data = false, needs_state_data = false;
     dm_data_info_t *data_info = NULL;
 
     if (RP_REQ_NEW == rp_session->state) {
@@ -1188,7 +1442,17 @@ rp_dt_prepare_data(rp_ctx_t *rp_ctx, rp_session_t *rp_session, const char *xpath
         rc = ac_check_node_permissions(rp_session->ac_session, xpath, AC_OPER_READ);
         CHECK_RC_LOG_GOTO(rc, cleanup, "Access control check failed for xpath '%s'", xpath);
 
-        rc = dm_get_data_info(rp_ctx->dm_ctx, rp_session->dm_session, rp_session->module_name, &data_info);
+        needs_state_data = (SR_DS_RUNNING == rp_session->datastore || SR_DS_CANDIDATE == rp_session->datastore) &&
+            (!(SR_SESS_CONFIG_ONLY & rp_session->options)) &&
+            (!(SR__SESSION_FLAGS__SESS_NOTIFICATION & rp_session->options)) &&
+            (SR_ERR_OK == dm_has_state_data(rp_ctx->dm_ctx, rp_session->module_name, &has_state_data) && has_state_data);
+
+        /* provided state data are added into the data tree, otherwise the data tree is only read and can be shared */
+        if (needs_state_data) {
+            rc = dm_get_data_info(rp_ctx->dm_ctx, rp_session->dm_session, rp_session->module_name, &data_info);
+        } else {
+            rc = dm_get_data_info_rdonly(rp_ctx->dm_ctx, rp_session->dm_session, rp_session->module_name, &data_info);
+        }
 
         /* check of data tree's emptiness is performed outside of this function -> ignore SR_ERR_NOT_FOUND */
         rc = SR_ERR_NOT_FOUND == rc ? SR_ERR_OK : rc;
@@ -1196,10 +1460,7 @@ rp_dt_prepare_data(rp_ctx_t *rp_ctx, rp_session_t *rp_session, const char *xpath
         *data_tree = data_info->node;
 
         /* if the request requires operational data pause the processing and wait for data to be provided */
-        if ((SR_DS_RUNNING == rp_session->datastore || SR_DS_CANDIDATE == rp_session->datastore) &&
-            (!(SR_SESS_CONFIG_ONLY & rp_session->options)) &&
-            (!(SR__SESSION_FLAGS__SESS_NOTIFICATION & rp_session->options)) &&
-            (SR_ERR_OK == dm_has_state_data(rp_ctx->dm_ctx, rp_session->module_name, &has_state_data) && has_state_data)) {
+        if (needs_state_data) {
 
             rp_dt_free_state_data_ctx_content(&rp_session->state_data_ctx);
             rp_session->dp_req_waiting = 0;
@@ -1392,6 +1653,79 @@ cleanup:
     return rc;
 }
 
+int
+rp_dt_get_gpb_values_wrapper(rp_ctx_t *rp_ctx, rp_session_t *rp_session, rp_dt_get_items_ctx_t *get_items_ctx, sr_mem_ctx_t *sr_mem,
+        const char *xpath, size_t offset, size_t limit, Sr__Value ***values, size_t *count)
+{
+    CHECK_NULL_ARG4(rp_ctx, rp_ctx->dm_ctx, rp_session, rp_session->dm_session);
+    CHECK_NULL_ARG4(sr_mem, xpath, values, count);
+    if (NULL != get_items_ctx) {
+        SR_LOG_INF("Get items request %s datastore, xpath: %s, offset: %zu, limit: %zu", sr_ds_to_str(rp_session->datastore), xpath, offset, limit);
+    } else {
+        SR_LOG_INF("Get items request %s datastore, xpath: %s", sr_ds_to_str(rp_session->datastore), xpath);
+    }
+
+    int rc = SR_ERR_OK;
+    struct lyd_node *data_tree = NULL;
+    struct ly_set *nodes = NULL;
+
+    if (NULL != get_items_ctx && get_items_ctx->xpath != NULL && 0 == strcmp(xpath, get_items_ctx->xpath) &&
+            offset == get_items_ctx->offset) {
+        /* cache hit do not load data from data providers */
+        rp_session->state = RP_REQ_DATA_LOADED;
+    }
+
+    rc = rp_dt_prepare_data(rp_ctx, rp_session, xpath, SR_API_VALUES, 0, &data_tree);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "rp_dt_prepare_data failed");
+
+    if (RP_REQ_WAITING_FOR_DATA == rp_session->state) {
+        SR_LOG_DBG("Session id = %u is waiting for the data", rp_session->id);
+        return rc;
+    }
+
+    if (NULL == data_tree) {
+        goto cleanup;
+    }
+
+    if (NULL != get_items_ctx) {
+        rc = rp_dt_find_nodes_with_opts(rp_ctx->dm_ctx, rp_session, get_items_ctx, data_tree, xpath, offset, limit, &nodes);
+        if (SR_ERR_OK != rc) {
+            if (SR_ERR_NOT_FOUND != rc) {
+                SR_LOG_ERR("Get nodes for xpath %s failed (%d)", xpath, rc);
+            }
+            goto cleanup;
+        }
+        rc = rp_dt_get_gpb_values_from_nodes(sr_mem, nodes, values, count);
+    } else {
+        rc = rp_dt_get_gpb_values(rp_ctx->dm_ctx, rp_session, data_tree, sr_mem, xpath,
+                dm_is_running_ds_session(rp_session->dm_session), values, count);
+    }
+    if (SR_ERR_OK != rc && SR_ERR_NOT_FOUND != rc) {
+        SR_LOG_ERR("Get values failed for xpath '%s'", xpath);
+    }
+
+cleanup:
+    if (SR_ERR_NOT_FOUND == rc || (SR_ERR_OK == rc && NULL == data_tree)) {
+        rc = rp_dt_validate_node_xpath(rp_ctx->dm_ctx, rp_session->dm_session, xpath, NULL, NULL);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Validation of xpath %s failed.", xpath);
+        } else {
+            rc = SR_ERR_NOT_FOUND;
+        }
+    } else if (SR_ERR_UNAUTHORIZED == rc) {
+        rc = SR_ERR_NOT_FOUND;
+    }
+
+    ly_set_free(nodes);
+    rp_session->state = RP_REQ_FINISHED;
+    if (NULL == get_items_ctx) {
+        /* with paging the module name is kept for the next request */
+        free(rp_session->module_name);
+        rp_session->module_name = NULL;
+    }
+    return rc;
+}
+
 int
 rp_dt_get_subtree_wrapper(rp_ctx_t *rp_ctx, rp_session_t *rp_session, sr_mem_ctx_t *sr_mem, const char *xpath, sr_node_t **subtree)
 {
@@ -1573,6 +1907,52 @@ cleanup:
     return rc;
 }
 
+int
+rp_dt_get_gpb_subtrees_wrapper(rp_ctx_t *rp_ctx, rp_session_t *rp_session, sr_mem_ctx_t *sr_mem, const char *xpath,
+        Sr__Node ***subtrees, size_t *count)
+{
+    CHECK_NULL_ARG4(rp_ctx, rp_ctx->dm_ctx, rp_session, rp_session->dm_session);
+    CHECK_NULL_ARG4(sr_mem, xpath, subtrees, count);
+    SR_LOG_INF("Get subtrees request %s datastore, xpath: %s", sr_ds_to_str(rp_session->datastore), xpath);
+
+    int rc = SR_ERR_OK;
+    struct lyd_node *data_tree = NULL;
+
+    rc = rp_dt_prepare_data(rp_ctx, rp_session, xpath, SR_API_TREES, SIZE_MAX, &data_tree);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "rp_dt_prepare_data failed");
+
+    if (RP_REQ_WAITING_FOR_DATA == rp_session->state) {
+        SR_LOG_DBG("Session id = %u is waiting for the data", rp_session->id);
+        return rc;
+    }
+
+    if (NULL == data_tree) {
+        goto cleanup;
+    }
+
+    rc = rp_dt_get_gpb_subtrees(rp_ctx->dm_ctx, rp_session, data_tree, sr_mem, xpath,
+            dm_is_running_ds_session(rp_session->dm_session), subtrees, count);
+    if (SR_ERR_OK != rc && SR_ERR_NOT_FOUND != rc) {
+        SR_LOG_ERR("Get subtrees failed for xpath '%s'", xpath);
+    }
+
+cleanup:
+    if (SR_ERR_NOT_FOUND == rc || (SR_ERR_OK == rc && NULL == data_tree)) {
+        rc = rp_dt_validate_node_xpath(rp_ctx->dm_ctx, rp_session->dm_session, xpath, NULL, NULL);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Validation of xpath %s failed.", xpath);
+        } else {
+            rc = SR_ERR_NOT_FOUND;
+        }
+    } else if (SR_ERR_UNAUTHORIZED == rc) {
+        rc = SR_ERR_NOT_FOUND;
+    }
+    rp_session->state = RP_REQ_FINISHED;
+    free(rp_session->module_name);
+    rp_session->module_name = NULL;
+    return rc;
+}
+
 /**
  * @brief generates changes for the children of created/deleted container/list
  *
@@ -44,6 +44,22 @@
 int rp_dt_get_values(dm_ctx_t *dm_ctx, rp_session_t *rp_session, struct lyd_node *data_tree, sr_mem_ctx_t *sr_mem, const char *xpath, bool check_enable,
         sr_val_t **values, size_t *count);
 
+/**
+ * @brief Retrieves all nodes matching xpath using ::rp_dt_find_nodes and copies them directly
+ * into GPB values allocated in the memory context, without intermediate sr_val_t copies.
+ * @param [in] dm_ctx
+ * @param [in] rp_session
+ * @param [in] data_tree
+ * @param [in] sr_mem Sysrepo memory context of the response (cannot be NULL).
+ * @param [in] xpath
+ * @param [in] check_enable
+ * @param [out] values
+ * @param [out] count
+ * @return Error code (SR_ERR_OK on success)
+ */
+int rp_dt_get_gpb_values(dm_ctx_t *dm_ctx, rp_session_t *rp_session, struct lyd_node *data_tree, sr_mem_ctx_t *sr_mem,
+        const char *xpath, bool check_enable, Sr__Value ***values, size_t *count);
+
 /**
  * @brief Returns the value for the specified xpath. If more than one node matching xpath,
  * SR_ERR_INVAL_ARG is returned.
@@ -110,6 +126,35 @@ int rp_dt_get_values_wrapper_with_opts(rp_ctx_t *rp_ctx, rp_session_t *rp_sessio
  */
 int rp_dt_get_values_from_nodes(sr_mem_ctx_t *sr_mem, struct ly_set *nodes, sr_val_t **values, size_t *value_cnt);
 
+/**
+ * @brief Fills the GPB values from the array of nodes. Values are allocated in the memory context,
+ * the strings are shared by the GPB values and the memory context.
+ * @param [in] sr_mem Sysrepo memory context to use for memory allocation (cannot be NULL).
+ * @param [in] nodes
+ * @param [out] values
+ * @param [out] value_cnt
+ * @return Error code (SR_ERR_OK on success)
+ */
+int rp_dt_get_gpb_values_from_nodes(sr_mem_ctx_t *sr_mem, struct ly_set *nodes, Sr__Value ***values, size_t *value_cnt);
+
+/**
+ * @brief Returns the values for the specified xpath as GPB values ready to be put into a response.
+ * If get_items_ctx is set, the nodes are found by ::rp_dt_find_nodes_with_opts and
+ * the selection of returned values is specified by limit and offset.
+ * @param [in] rp_ctx
+ * @param [in] rp_session
+ * @param [in] get_items_ctx Context of get_items with options, NULL if offset and limit are not used.
+ * @param [in] sr_mem Sysrepo memory context of the response (cannot be NULL).
+ * @param [in] xpath
+ * @param [in] offset - return the values with index and above
+ * @param [in] limit - the maximum count of values that can be returned
+ * @param [out] values
+ * @param [out] count
+ * @return Error code (SR_ERR_OK on success), SR_ERR_NOT_FOUND, SR_ERR_UNKNOWN_MODEL, SR_ERR_BAD_ELEMENT
+ */
+int rp_dt_get_gpb_values_wrapper(rp_ctx_t *rp_ctx, rp_session_t *rp_session, rp_dt_get_items_ctx_t *get_items_ctx, sr_mem_ctx_t *sr_mem,
+        const char *xpath, size_t offset, size_t limit, Sr__Value ***values, size_t *count);
+
 /**
  * @brief Returns subtree with the root node at the specified xpath. If more than one node matching xpath,
  * SR_ERR_INVAL_ARG is returned.
@@ -160,6 +205,22 @@ int rp_dt_get_subtree_chunk(dm_ctx_t *dm_ctx, rp_session_t *rp_session, struct l
 int rp_dt_get_subtrees(dm_ctx_t *dm_ctx, rp_session_t *rp_session, struct lyd_node *data_tree, sr_mem_ctx_t *sr_mem, const char *xpath, bool check_enable,
         sr_node_t **subtrees, size_t *count);
 
+/**
+ * @brief Retrieves all subtrees with root nodes matching the specified xpath and copies them
+ * directly into GPB trees allocated in the memory context, without intermediate sr_node_t copies.
+ * @param [in] dm_ctx
+ * @param [in] rp_session
+ * @param [in] data_tree
+ * @param [in] sr_mem Sysrepo memory context of the response (cannot be NULL).
+ * @param [in] xpath
+ * @param [in] check_enable
+ * @param [out] subtrees
+ * @param [out] count
+ * @return Error code (SR_ERR_OK on success)
+ */
+int rp_dt_get_gpb_subtrees(dm_ctx_t *dm_ctx, rp_session_t *rp_session, struct lyd_node *data_tree, sr_mem_ctx_t *sr_mem,
+        const char *xpath, bool check_enable, Sr__Node ***subtrees, size_t *count);
+
 /**
  * @brief Retrieves all subtree *chunks* with root nodes matching the specified xpath.
  * @param [in] dm_ctx
@@ -222,6 +283,20 @@ int rp_dt_get_subtree_wrapper_with_opts(rp_ctx_t *rp_ctx, rp_session_t *rp_sessi
 int rp_dt_get_subtrees_wrapper(rp_ctx_t *rp_ctx, rp_session_t *rp_session, sr_mem_ctx_t *sr_mem, const char *xpath,
         sr_node_t **subtrees, size_t *count);
 
+/**
+ * @brief Retrieves all subtrees with root nodes matching the specified xpath as GPB trees
+ * ready to be put into a response.
+ * @param [in] rp_ctx
+ * @param [in] rp_session
+ * @param [in] sr_mem Sysrepo memory context of the response (cannot be NULL).
+ * @param [in] xpath
+ * @param [out] subtrees
+ * @param [out] count
+ * @return Error code (SR_ERR_OK on success), SR_ERR_NOT_FOUND, SR_ERR_UNKNOWN_MODEL, SR_ERR_BAD_ELEMENT
+ */
+int rp_dt_get_gpb_subtrees_wrapper(rp_ctx_t *rp_ctx, rp_session_t *rp_session, sr_mem_ctx_t *sr_mem, const char *xpath,
+        Sr__Node ***subtrees, size_t *count);
+
 /**
  * @brief Retrieves all subtree *chunks* with root nodes matching the specified xpath.
  * @param [in] rp_ctx
@@ -316,6 +391,21 @@ bool rp_dt_find_exact_match_subscription_for_node(rp_session_t *rp_session, stru
  */
 int rp_dt_create_instance_xps(rp_session_t *session, struct lys_node *sch_node, char ***xps, size_t *xp_count);
 
+/**
+ * @brief Requests data for the xpaths from the data provider subscription. If the subscription
+ * allows caching, the xpaths with fresh data in the operational data cache are served from the cache
+ * (the response is enqueued as if it was sent by the data provider) and only the rest is sent
+ * to the data provider in a single request.
+ * @param [in] rp_ctx
+ * @param [in] rp_session
+ * @param [in] subscription - data provider subscription
+ * @param [in] xpaths - requested xpaths, the strings are consumed (moved to the list of requested xpaths
+ * or freed) and the array items are set to NULL even in case of error
+ * @param [in] xpath_cnt
+ * @return Error code (SR_ERR_OK on success)
+ */
+int rp_dt_request_dp_data(rp_ctx_t *rp_ctx, rp_session_t *rp_session, np_subscription_t *subscription, char **xpaths, size_t xpath_cnt);
+
 #endif /* RP_DT_GET_H */
 
 /**
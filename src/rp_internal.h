@@ -27,8 +27,10 @@
 #include "data_manager.h"
 #include "notification_processor.h"
 #include "persistence_manager.h"
+#include "rp_dp_cache.h"
 
-#define RP_THREAD_COUNT 4  /**< Number of threads that RP uses for processing. */
+#define RP_THREAD_COUNT 4             /**< Default number of threads that RP uses for processing. */
+#define RP_THREAD_COUNT_MAX 128       /**< Maximum number of threads that RP can use for processing. */
 
 /**
  * @brief Structure that holds the context of an instance of Request Processor.
@@ -39,25 +41,27 @@ typedef struct rp_ctx_s {
     dm_ctx_t *dm_ctx;                        /**< Data Manager Context. */
     np_ctx_t *np_ctx;                        /**< Notification Processor context. */
     pm_ctx_t *pm_ctx;                        /**< Persistence Manager context. */
+    rp_dp_cache_t *dp_cache;                 /**< Cache of the data provided by operational data providers. */
 
-    pthread_t thread_pool[RP_THREAD_COUNT];  /**< Thread pool. */
-    size_t active_threads;                   /**< Number of active (non-sleeping) threads. */
-    struct timespec last_thread_wakeup;      /**< Timestamp of the last thread wake-up event. */
-    size_t thread_spin_limit;                /**< Current limit of thread spinning before going to sleep. */
-    bool stop_requested;                     /**< Stopping of all threads has been requested. */
+    pthread_t *thread_pool;                  /**< Thread pool. */
+    size_t thread_count;                     /**< Number of threads in the thread pool. */
+    size_t active_threads;                   /**< Number of active (non-sleeping) threads, accessed atomically. */
+    bool stop_requested;                     /**< Stopping of all threads has been requested, accessed atomically. */
 
     bool block_further_commits;              /**< Flag that allows commit to be processed */
     pthread_mutex_t commit_block_mutex;      /**< Mutex guarding block_further_commits flag */
 
-    sr_cbuff_t *request_queue;               /**< Input request queue. */
-    pthread_mutex_t request_queue_mutex;     /**< Request queue mutex. */
-    pthread_cond_t request_queue_cv;         /**< Request queue condition variable. */
+    sr_mpmc_queue_t *request_queue;          /**< Input request queue (lock-free). */
+    sr_cbuff_t *request_overflow;            /**< Queue for requests that did not fit into request_queue. */
+    size_t request_overflow_count;           /**< Number of requests in request_overflow, accessed atomically. */
+    pthread_mutex_t request_overflow_mutex;  /**< Mutex guarding request_overflow. */
+    pthread_mutex_t request_queue_mutex;     /**< Mutex used for putting worker threads to sleep. */
+    pthread_cond_t request_queue_cv;         /**< Condition variable used to wake up sleeping worker threads. */
 
     sr_list_t *modules_incl_intern_op_data;  /**< List of modules that contains state data that is handled internally in sysrepo
                                               *   and requests are not send to a subscriber */
     sr_list_t *inter_op_data_xpath;          /**< List of list containing subtree of the module that are handled by sysrepo */
 
-    pthread_rwlock_t commit_lock;            /**< Lock to synchronize commit in this instance */
     bool do_not_generate_config_change;      /**< Config-change notification will not be generated */
 } rp_ctx_t;
 
@@ -0,0 +1,917 @@
+/**
+ * @file benchmark.c
+ * @author agent <agent@local>
+ * @brief Configurable benchmark of the sysrepo operations reporting latency percentiles.
+ *
+ * The benchmark generates data files of the requested size, starts the requested number
+ * of concurrent clients (each with its own connection and sessions) and lets each of them
+ * perform a pseudo-random sequence of operations given by the operation mix. The sequence
+ * depends only on the seed, so the runs are reproducible. Latency of each operation is
+ * measured and the throughput and p50/p99/p999 latencies are written into a JSON file.
+ *
+ * The Sysrepo Engine either runs in the benchmark process (library-local engine) or in
+ * a separate sysrepod process started by the benchmark (--daemon).
+ *
+ * The data of example-module and ietf-interfaces in the repository are overwritten, so the benchmark
+ * must not run concurrently with the tests. The exit status is non-zero if any operation failed.
+ *
+ * @copyright
+ * Copyright 2026 agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "sysrepo.h"
+#include "sysrepo/values.h"
+#include "sysrepo/xpath.h"
+#include "sr_common.h"
+#include "test_module_helper.h"
+
+#define BENCH_DEFAULT_DATA_SIZE 20     /**< Default number of list instances in the data files. */
+#define BENCH_DEFAULT_OP_COUNT 10000   /**< Default number of measured operations per client. */
+#define BENCH_DAEMON_START_TIMEOUT 5   /**< Timeout (in seconds) for the started daemon to accept connections. */
+#define BENCH_XPATH_LEN 128            /**< Maximum length of the xpaths built by the benchmark. */
+
+/**
+ * @brief Operations that can be benchmarked.
+ */
+typedef enum bench_op_e {
+    BENCH_OP_GET,      /**< sr_get_items on all list leaves of example-module */
+    BENCH_OP_SET,      /**< sr_set_item of one leaf without commit */
+    BENCH_OP_COMMIT,   /**< sr_set_item of one leaf followed by sr_commit */
+    BENCH_OP_RPC,      /**< sr_rpc_send with one input and one output value */
+    BENCH_OP_NOTIF,    /**< sr_event_notif_send of an ephemeral notification */
+    BENCH_OP_DP,       /**< sr_get_items on state data provided by a data provider */
+    BENCH_OP_COUNT,
+} bench_op_t;
+
+static const char * const bench_op_names[BENCH_OP_COUNT] = { "get", "set", "commit", "rpc", "notif", "dp" };
+
+/**
+ * @brief Benchmark configuration.
+ */
+typedef struct bench_opts_s {
+    size_t data_size;                   /**< Number of list instances in the data files. */
+    size_t clients;                     /**< Number of concurrent clients (threads with own connection). */
+    size_t sessions;                    /**< Number of sessions per client. */
+    size_t op_count;                    /**< Number of measured operations per client. */
+    size_t warmup;                      /**< Number of not measured operations per client. */
+    unsigned mix[BENCH_OP_COUNT];       /**< Weight of each operation in the mix. */
+    unsigned mix_total;                 /**< Sum of the weights. */
+    unsigned seed;                      /**< Seed of the pseudo-random operation sequence. */
+    const char *output;                 /**< Output JSON file, "-" for stdout. */
+    const char *daemon_path;            /**< Path to sysrepod, NULL to use library-local engine. */
+    bool shm;                           /**< Use shared-memory transport. */
+} bench_opts_t;
+
+/**
+ * @brief Latency samples of one operation.
+ */
+typedef struct bench_samples_s {
+    uint64_t *latency;                  /**< Latencies of the successful operations in nanoseconds. */
+    size_t count;                       /**< Number of samples. */
+    size_t errors;                      /**< Number of failed operations. */
+} bench_samples_t;
+
+/**
+ * @brief Gate the clients pass once all of them finished the warmup, so that the measured
+ * window does not include the warmup of the slower clients.
+ */
+typedef struct bench_gate_s {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    size_t expected;                    /**< Number of clients that have to arrive. */
+    size_t arrived;                     /**< Number of clients that finished the warmup. */
+    bool aborted;                       /**< Not all clients have been started, the run is aborted. */
+    uint64_t start;                     /**< Start of the measured window, set by the last arriving client. */
+} bench_gate_t;
+
+/**
+ * @brief Context of one benchmark client.
+ */
+typedef struct bench_client_s {
+    pthread_t thread;
+    size_t id;
+    const bench_opts_t *opts;
+    bench_gate_t *gate;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t **sessions;
+    unsigned seed;
+    bench_samples_t samples[BENCH_OP_COUNT];
+} bench_client_t;
+
+/**
+ * @brief Subscriptions the operations depend on, held by a separate connection.
+ */
+typedef struct bench_subscriber_s {
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *session;
+    sr_subscription_ctx_t *subscription;
+    size_t if_count;
+} bench_subscriber_t;
+
+static uint64_t
+bench_now(void)
+{
+    struct timespec ts = { 0, };
+
+    sr_clock_get_time(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int
+bench_module_change_cb(sr_session_ctx_t *session, const char *module_name, sr_notif_event_t event, void *private_ctx)
+{
+    return SR_ERR_OK;
+}
+
+static int
+bench_rpc_cb(const char *xpath, const sr_val_t *input, const size_t input_cnt,
+        sr_val_t **output, size_t *output_cnt, void *private_ctx)
+{
+    sr_val_t *v = NULL;
+    int rc = SR_ERR_OK;
+
+    rc = sr_new_val("/test-module:activate-software-image/status", &v);
+    if (SR_ERR_OK != rc) {
+        return rc;
+    }
+    sr_val_set_str_data(v, SR_STRING_T, "The image acmefw-2.3 is being installed.");
+
+    *output = v;
+    *output_cnt = 1;
+    return SR_ERR_OK;
+}
+
+static void
+bench_event_notif_cb(const sr_ev_notif_type_t notif_type, const char *xpath,
+        const sr_val_t *values, const size_t values_cnt, time_t timestamp, void *private_ctx)
+{
+}
+
+static int
+bench_dp_cb(const char *xpath, sr_val_t **values, size_t *values_cnt, void *private_ctx)
+{
+    size_t if_count = *((size_t *) private_ctx);
+    sr_val_t *v = NULL;
+    int rc = SR_ERR_OK;
+
+    *values = NULL;
+    *values_cnt = 0;
+
+    if (!sr_xpath_node_name_eq(xpath, "interface") || 0 == if_count) {
+        return SR_ERR_OK;
+    }
+
+    rc = sr_new_values(if_count * 4, &v);
+    if (SR_ERR_OK != rc) {
+        return rc;
+    }
+    for (size_t i = 0; i < if_count; i++) {
+        sr_val_build_xpath(&v[4*i], "/ietf-interfaces:interfaces-state/interface[name='eth%zu']", i);
+        v[4*i].type = SR_LIST_T;
+
+        sr_val_build_xpath(&v[4*i+1], "/ietf-interfaces:interfaces-state/interface[name='eth%zu']/oper-status", i);
+        sr_val_set_str_data(&v[4*i+1], SR_ENUM_T, "up");
+
+        sr_val_build_xpath(&v[4*i+2], "/ietf-interfaces:interfaces-state/interface[name='eth%zu']/statistics/in-octets", i);
+        v[4*i+2].type = SR_UINT64_T;
+        v[4*i+2].data.uint64_val = 456213;
+
+        sr_val_build_xpath(&v[4*i+3], "/ietf-interfaces:interfaces-state/interface[name='eth%zu']/statistics/in-unicast-pkts", i);
+        v[4*i+3].type = SR_UINT64_T;
+        v[4*i+3].data.uint64_val = 45213;
+    }
+
+    *values = v;
+    *values_cnt = if_count * 4;
+    return SR_ERR_OK;
+}
+
+static sr_conn_options_t
+bench_conn_options(const bench_opts_t *opts)
+{
+    sr_conn_options_t conn_opts = SR_CONN_DEFAULT;
+
+    if (NULL != opts->daemon_path) {
+        conn_opts |= SR_CONN_DAEMON_REQUIRED;
+    }
+    if (opts->shm) {
+        conn_opts |= SR_CONN_SHM_TRANSPORT;
+    }
+    return conn_opts;
+}
+
+/**
+ * @brief Subscribes for changes of the modules (which enables them in running datastore),
+ * for the RPC, for the event notification and as the operational data provider.
+ */
+static int
+bench_subscriber_start(const bench_opts_t *opts, bench_subscriber_t *sub)
+{
+    int rc = SR_ERR_OK;
+
+    sub->if_count = opts->data_size;
+
+    rc = sr_connect("sr_benchmark_subscriber", bench_conn_options(opts), &sub->conn);
+    CHECK_RC_MSG_RETURN(rc, "Subscriber connection failed");
+
+    rc = sr_session_start(sub->conn, SR_DS_RUNNING, SR_SESS_DEFAULT, &sub->session);
+    CHECK_RC_MSG_RETURN(rc, "Subscriber session start failed");
+
+    rc = sr_module_change_subscribe(sub->session, "example-module", bench_module_change_cb, NULL, 0,
+            SR_SUBSCR_DEFAULT, &sub->subscription);
+    CHECK_RC_MSG_RETURN(rc, "Module change subscription failed");
+
+    rc = sr_module_change_subscribe(sub->session, "ietf-interfaces", bench_module_change_cb, NULL, 0,
+            SR_SUBSCR_CTX_REUSE, &sub->subscription);
+    CHECK_RC_MSG_RETURN(rc, "Module change subscription failed");
+
+    rc = sr_rpc_subscribe(sub->session, "/test-module:activate-software-image", bench_rpc_cb, NULL,
+            SR_SUBSCR_CTX_REUSE, &sub->subscription);
+    CHECK_RC_MSG_RETURN(rc, "RPC subscription failed");
+
+    rc = sr_event_notif_subscribe(sub->session, "/test-module:link-discovered", bench_event_notif_cb, NULL,
+            SR_SUBSCR_CTX_REUSE, &sub->subscription);
+    CHECK_RC_MSG_RETURN(rc, "Event notification subscription failed");
+
+    rc = sr_dp_get_items_subscribe(sub->session, "/ietf-interfaces:interfaces-state/interface", bench_dp_cb,
+            &sub->if_count, SR_SUBSCR_CTX_REUSE, &sub->subscription);
+    CHECK_RC_MSG_RETURN(rc, "Data provider subscription failed");
+
+    return rc;
+}
+
+static void
+bench_subscriber_stop(bench_subscriber_t *sub)
+{
+    if (NULL != sub->subscription) {
+        sr_unsubscribe(sub->session, sub->subscription);
+    }
+    if (NULL != sub->session) {
+        sr_session_stop(sub->session);
+    }
+    if (NULL != sub->conn) {
+        sr_disconnect(sub->conn);
+    }
+}
+
+/**
+ * @brief Performs one operation, returns the error code of the operation.
+ */
+static int
+bench_op_run(bench_client_t *client, sr_session_ctx_t *session, bench_op_t op, size_t seq)
+{
+    char xpath[BENCH_XPATH_LEN] = { 0, };
+    char value[BENCH_XPATH_LEN] = { 0, };
+    sr_val_t *values = NULL, *output = NULL;
+    sr_val_t input = { 0, }, notif[2] = { { 0, }, };
+    size_t count = 0;
+    size_t list_idx = client->id % client->opts->data_size;
+    int rc = SR_ERR_OK;
+
+    switch (op) {
+        case BENCH_OP_GET:
+            rc = sr_get_items(session, "/example-module:container/list/leaf", &values, &count);
+            sr_free_values(values, count);
+            break;
+        case BENCH_OP_SET:
+        case BENCH_OP_COMMIT:
+            /* each client modifies its own list instance to avoid needless conflicts */
+            snprintf(xpath, BENCH_XPATH_LEN, "/example-module:container/list[key1='k1%zu'][key2='k2%zu']/leaf",
+                    list_idx, list_idx);
+            snprintf(value, BENCH_XPATH_LEN, "value-%zu-%zu", client->id, seq);
+            rc = sr_set_item_str(session, xpath, value, SR_EDIT_DEFAULT);
+            if (SR_ERR_OK == rc && BENCH_OP_COMMIT == op) {
+                rc = sr_commit(session);
+                if (SR_ERR_OK != rc) {
+                    sr_discard_changes(session);
+                }
+            }
+            break;
+        case BENCH_OP_RPC:
+            input.xpath = "/test-module:activate-software-image/image-name";
+            input.type = SR_STRING_T;
+            input.data.string_val = "acmefw-2.3";
+            rc = sr_rpc_send(session, "/test-module:activate-software-image", &input, 1, &output, &count);
+            sr_free_values(output, count);
+            break;
+        case BENCH_OP_NOTIF:
+            notif[0].xpath = "/test-module:link-discovered/source/address";
+            notif[0].type = SR_STRING_T;
+            notif[0].data.string_val = "10.10.1.5";
+            notif[1].xpath = "/test-module:link-discovered/source/interface";
+            notif[1].type = SR_STRING_T;
+            notif[1].data.string_val = "eth1";
+            rc = sr_event_notif_send(session, "/test-module:link-discovered", notif, 2, SR_EV_NOTIF_EPHEMERAL);
+            break;
+        case BENCH_OP_DP:
+            rc = sr_get_items(session, "/ietf-interfaces:interfaces-state/interface/statistics//*", &values, &count);
+            sr_free_values(values, count);
+            break;
+        default:
+            rc = SR_ERR_INVAL_ARG;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Picks the next operation from the mix.
+ */
+static bench_op_t
+bench_op_pick(bench_client_t *client)
+{
+    unsigned r = rand_r(&client->seed) % client->opts->mix_total;
+
+    for (size_t op = 0; op < BENCH_OP_COUNT; op++) {
+        if (r < client->opts->mix[op]) {
+            return op;
+        }
+        r -= client->opts->mix[op];
+    }
+    return BENCH_OP_GET;
+}
+
+/**
+ * @brief Waits until all clients finished the warmup. The last arriving client starts the measured window.
+ * @return False if the run has been aborted.
+ */
+static bool
+bench_gate_pass(bench_gate_t *gate)
+{
+    bool aborted = false;
+
+    pthread_mutex_lock(&gate->lock);
+    gate->arrived++;
+    if (gate->arrived == gate->expected) {
+        gate->start = bench_now();
+        pthread_cond_broadcast(&gate->cond);
+    }
+    while (gate->arrived < gate->expected && !gate->aborted) {
+        pthread_cond_wait(&gate->cond, &gate->lock);
+    }
+    aborted = gate->aborted;
+    pthread_mutex_unlock(&gate->lock);
+
+    return !aborted;
+}
+
+/**
+ * @brief Releases the clients waiting in the gate when not all of them could be started.
+ */
+static void
+bench_gate_abort(bench_gate_t *gate)
+{
+    pthread_mutex_lock(&gate->lock);
+    gate->aborted = true;
+    pthread_cond_broadcast(&gate->cond);
+    pthread_mutex_unlock(&gate->lock);
+}
+
+static void *
+bench_client_run(void *arg)
+{
+    bench_client_t *client = (bench_client_t *) arg;
+    const bench_opts_t *opts = client->opts;
+    sr_session_ctx_t *session = NULL;
+    bench_samples_t *samples = NULL;
+    bench_op_t op = BENCH_OP_GET;
+    uint64_t start = 0;
+    int rc = SR_ERR_OK;
+
+    for (size_t i = 0; i < opts->warmup + opts->op_count; i++) {
+        session = client->sessions[i % opts->sessions];
+        op = bench_op_pick(client);
+
+        if (i == opts->warmup && !bench_gate_pass(client->gate)) {
+            break;
+        }
+        start = bench_now();
+        rc = bench_op_run(client, session, op, i);
+        if (i < opts->warmup) {
+            continue;
+        }
+        samples = &client->samples[op];
+        if (SR_ERR_OK == rc) {
+            samples->latency[samples->count++] = bench_now() - start;
+        } else {
+            samples->errors++;
+        }
+    }
+
+    return NULL;
+}
+
+static int
+bench_client_init(const bench_opts_t *opts, size_t id, bench_client_t *client)
+{
+    int rc = SR_ERR_OK;
+
+    client->id = id;
+    client->opts = opts;
+    /* each client has its own reproducible sequence of operations */
+    client->seed = opts->seed + id;
+
+    for (size_t op = 0; op < BENCH_OP_COUNT; op++) {
+        if (0 != opts->mix[op]) {
+            client->samples[op].latency = calloc(opts->op_count, sizeof(*client->samples[op].latency));
+            CHECK_NULL_NOMEM_RETURN(client->samples[op].latency);
+        }
+    }
+
+    rc = sr_connect("sr_benchmark", bench_conn_options(opts), &client->conn);
+    CHECK_RC_LOG_RETURN(rc, "Connection of client %zu failed", id);
+
+    client->sessions = calloc(opts->sessions, sizeof(*client->sessions));
+    CHECK_NULL_NOMEM_RETURN(client->sessions);
+    for (size_t i = 0; i < opts->sessions; i++) {
+        rc = sr_session_start(client->conn, SR_DS_RUNNING, SR_SESS_DEFAULT, &client->sessions[i]);
+        CHECK_RC_LOG_RETURN(rc, "Session start of client %zu failed", id);
+    }
+
+    return rc;
+}
+
+static void
+bench_client_cleanup(bench_client_t *client)
+{
+    if (NULL != client->sessions) {
+        for (size_t i = 0; i < client->opts->sessions; i++) {
+            if (NULL != client->sessions[i]) {
+                sr_session_stop(client->sessions[i]);
+            }
+        }
+        free(client->sessions);
+    }
+    if (NULL != client->conn) {
+        sr_disconnect(client->conn);
+    }
+    for (size_t op = 0; op < BENCH_OP_COUNT; op++) {
+        free(client->samples[op].latency);
+    }
+}
+
+static int
+bench_latency_cmp(const void *a, const void *b)
+{
+    uint64_t la = *(const uint64_t *) a, lb = *(const uint64_t *) b;
+    return (la > lb) - (la < lb);
+}
+
+/**
+ * @brief Returns the nearest-rank percentile of sorted samples in microseconds.
+ */
+static double
+bench_percentile(const uint64_t *sorted, size_t count, double percentile)
+{
+    size_t rank = 0;
+
+    if (0 == count) {
+        return 0.0;
+    }
+    rank = (size_t) (percentile * count + 0.999999);
+    rank = (0 == rank) ? 1 : (rank > count ? count : rank);
+    return sorted[rank - 1] / 1000.0;
+}
+
+/**
+ * @brief Merges the samples of all clients, sorts them and prints one JSON object with the statistics.
+ */
+static int
+bench_print_stats(FILE *out, const char *name, bench_client_t *clients, size_t client_cnt, int op, bool last)
+{
+    uint64_t *merged = NULL;
+    size_t count = 0, errors = 0, pos = 0;
+    double sum = 0.0;
+
+    for (size_t i = 0; i < client_cnt; i++) {
+        for (size_t o = 0; o < BENCH_OP_COUNT; o++) {
+            if (-1 == op || (int) o == op) {
+                count += clients[i].samples[o].count;
+                errors += clients[i].samples[o].errors;
+            }
+        }
+    }
+
+    if (count > 0) {
+        merged = calloc(count, sizeof(*merged));
+        CHECK_NULL_NOMEM_RETURN(merged);
+        for (size_t i = 0; i < client_cnt; i++) {
+            for (size_t o = 0; o < BENCH_OP_COUNT; o++) {
+                if (-1 == op || (int) o == op) {
+                    memcpy(merged + pos, clients[i].samples[o].latency, clients[i].samples[o].count * sizeof(*merged));
+                    pos += clients[i].samples[o].count;
+                }
+            }
+        }
+        qsort(merged, count, sizeof(*merged), bench_latency_cmp);
+        for (size_t i = 0; i < count; i++) {
+            sum += merged[i];
+        }
+    }
+
+    fprintf(out, "    \"%s\": {\"count\": %zu, \"errors\": %zu, \"mean_us\": %.3f, \"p50_us\": %.3f, "
+            "\"p99_us\": %.3f, \"p999_us\": %.3f, \"max_us\": %.3f}%s\n",
+            name, count, errors, count > 0 ? sum / count / 1000.0 : 0.0,
+            bench_percentile(merged, count, 0.50), bench_percentile(merged, count, 0.99),
+            bench_percentile(merged, count, 0.999), count > 0 ? merged[count - 1] / 1000.0 : 0.0,
+            last ? "" : ",");
+
+    free(merged);
+    return SR_ERR_OK;
+}
+
+static int
+bench_write_report(const bench_opts_t *opts, bench_client_t *clients, double duration)
+{
+    FILE *out = stdout;
+    size_t total = 0, errors = 0;
+    int rc = SR_ERR_OK;
+
+    if (0 != strcmp("-", opts->output)) {
+        out = fopen(opts->output, "w");
+        if (NULL == out) {
+            SR_LOG_ERR("Unable to open the output file %s: %s", opts->output, sr_strerror_safe(errno));
+            return SR_ERR_IO;
+        }
+    }
+
+    for (size_t i = 0; i < opts->clients; i++) {
+        for (size_t op = 0; op < BENCH_OP_COUNT; op++) {
+            total += clients[i].samples[op].count;
+            errors += clients[i].samples[op].errors;
+        }
+    }
+
+    fprintf(out, "{\n  \"config\": {\n");
+    fprintf(out, "    \"engine\": \"%s\",\n", NULL != opts->daemon_path ? "daemon" : "in-process");
+    fprintf(out, "    \"transport\": \"%s\",\n", opts->shm ? "shm" : "socket");
+    fprintf(out, "    \"data_size\": %zu,\n", opts->data_size);
+    fprintf(out, "    \"clients\": %zu,\n", opts->clients);
+    fprintf(out, "    \"sessions\": %zu,\n", opts->sessions);
+    fprintf(out, "    \"ops_per_client\": %zu,\n", opts->op_count);
+    fprintf(out, "    \"warmup\": %zu,\n", opts->warmup);
+    fprintf(out, "    \"seed\": %u,\n", opts->seed);
+    fprintf(out, "    \"mix\": {");
+    for (size_t op = 0; op < BENCH_OP_COUNT; op++) {
+        fprintf(out, "\"%s\": %u%s", bench_op_names[op], opts->mix[op], op + 1 < BENCH_OP_COUNT ? ", " : "");
+    }
+    fprintf(out, "}\n  },\n");
+    fprintf(out, "  \"duration_s\": %.6f,\n", duration);
+    fprintf(out, "  \"ops\": %zu,\n", total);
+    fprintf(out, "  \"errors\": %zu,\n", errors);
+    fprintf(out, "  \"throughput_ops_per_s\": %.1f,\n", duration > 0 ? total / duration : 0.0);
+    fprintf(out, "  \"latency\": {\n");
+
+    for (size_t op = 0; op < BENCH_OP_COUNT && SR_ERR_OK == rc; op++) {
+        if (0 != opts->mix[op]) {
+            rc = bench_print_stats(out, bench_op_names[op], clients, opts->clients, op, false);
+        }
+    }
+    if (SR_ERR_OK == rc) {
+        rc = bench_print_stats(out, "all", clients, opts->clients, -1, true);
+    }
+    fprintf(out, "  }\n}\n");
+
+    if (stdout != out) {
+        fclose(out);
+    }
+    return rc;
+}
+
+/**
+ * @brief Starts sysrepod in foreground (debug) mode and waits until it accepts connections.
+ */
+static int
+bench_daemon_start(const bench_opts_t *opts, pid_t *pid_p)
+{
+    sr_conn_ctx_t *conn = NULL;
+    pid_t pid = 0;
+    int rc = SR_ERR_OK;
+
+    pid = fork();
+    if (-1 == pid) {
+        SR_LOG_ERR("Unable to fork: %s", sr_strerror_safe(errno));
+        return SR_ERR_INTERNAL;
+    }
+    if (0 == pid) {
+        execl(opts->daemon_path, opts->daemon_path, "-d", "-l0", (char *) NULL);
+        fprintf(stderr, "Unable to execute %s: %s\n", opts->daemon_path, strerror(errno));
+        _exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < BENCH_DAEMON_START_TIMEOUT * 100; i++) {
+        rc = sr_connect("sr_benchmark", SR_CONN_DAEMON_REQUIRED, &conn);
+        if (SR_ERR_OK == rc) {
+            sr_disconnect(conn);
+            *pid_p = pid;
+            return SR_ERR_OK;
+        }
+        if (pid == waitpid(pid, NULL, WNOHANG)) {
+            break;
+        }
+        usleep(10000);
+    }
+
+    SR_LOG_ERR("Sysrepo daemon %s did not start.", opts->daemon_path);
+    kill(pid, SIGTERM);
+    waitpid(pid, NULL, 0);
+    return SR_ERR_DISCONNECT;
+}
+
+static void
+bench_daemon_stop(pid_t pid)
+{
+    if (pid > 0) {
+        kill(pid, SIGTERM);
+        waitpid(pid, NULL, 0);
+    }
+}
+
+/**
+ * @brief Parses a non-negative decimal number not greater than max.
+ */
+static int
+bench_parse_number(const char *str, unsigned long max, unsigned long *value)
+{
+    char *endptr = NULL;
+
+    errno = 0;
+    *value = strtoul(str, &endptr, 10);
+    if ('\0' == *str || '-' == *str || '\0' != *endptr || ERANGE == errno || *value > max) {
+        return SR_ERR_INVAL_ARG;
+    }
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Parses the operation mix, e.g. "get=60,set=10,commit=10,rpc=10,notif=5,dp=5".
+ * Operations not listed are not performed.
+ */
+static int
+bench_parse_mix(const char *mix_str, bench_opts_t *opts)
+{
+    char *mix = NULL, *item = NULL, *save_ptr = NULL, *eq = NULL;
+    unsigned long weight = 0;
+    size_t op = 0;
+    int rc = SR_ERR_OK;
+
+    mix = strdup(mix_str);
+    CHECK_NULL_NOMEM_RETURN(mix);
+
+    memset(opts->mix, 0, sizeof(opts->mix));
+    opts->mix_total = 0;
+
+    for (item = strtok_r(mix, ",", &save_ptr); NULL != item; item = strtok_r(NULL, ",", &save_ptr)) {
+        eq = strchr(item, '=');
+        if (NULL == eq) {
+            rc = SR_ERR_INVAL_ARG;
+            break;
+        }
+        *eq = '\0';
+        for (op = 0; op < BENCH_OP_COUNT && 0 != strcmp(item, bench_op_names[op]); op++);
+        if (BENCH_OP_COUNT == op) {
+            rc = SR_ERR_INVAL_ARG;
+            break;
+        }
+        rc = bench_parse_number(eq + 1, UINT_MAX - opts->mix_total, &weight);
+        if (SR_ERR_OK != rc) {
+            break;
+        }
+        opts->mix[op] = weight;
+        opts->mix_total += opts->mix[op];
+    }
+    free(mix);
+
+    if (SR_ERR_OK == rc && 0 == opts->mix_total) {
+        rc = SR_ERR_INVAL_ARG;
+    }
+    if (SR_ERR_OK != rc) {
+        fprintf(stderr, "Invalid operation mix '%s'.\n", mix_str);
+    }
+    return rc;
+}
+
+static void
+bench_print_help()
+{
+    printf("Usage:\n");
+    printf("  sr_benchmark [options]\n\n");
+    printf("Available options:\n");
+    printf("  -h, --help             Prints this help.\n");
+    printf("  -d, --data-size <n>    Number of list instances in the data files (default: %d).\n", BENCH_DEFAULT_DATA_SIZE);
+    printf("  -c, --clients <n>      Number of concurrent clients, each with its own connection (default: 1).\n");
+    printf("  -s, --sessions <n>     Number of sessions per client (default: 1).\n");
+    printf("  -n, --ops <n>          Number of measured operations per client (default: %d).\n", BENCH_DEFAULT_OP_COUNT);
+    printf("  -w, --warmup <n>       Number of not measured operations per client (default: 0).\n");
+    printf("  -m, --mix <mix>        Operation mix as comma-separated op=weight pairs, operations are\n");
+    printf("                         get, set, commit, rpc, notif, dp (default: get=50,set=15,commit=10,rpc=10,notif=10,dp=5).\n");
+    printf("  -r, --seed <n>         Seed of the pseudo-random operation sequence (default: 1).\n");
+    printf("  -o, --output <file>    Output JSON file, '-' for stdout (default: -).\n");
+    printf("  -D, --daemon <path>    Start the given sysrepod and connect to it instead of using library-local engine.\n");
+    printf("  -S, --shm              Use shared-memory transport between the clients and the engine.\n");
+}
+
+int
+main(int argc, char **argv)
+{
+    bench_opts_t opts = { 0, };
+    bench_subscriber_t subscriber = { 0, };
+    bench_client_t *clients = NULL;
+    bench_gate_t gate = { .lock = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER, };
+    size_t started = 0, errors = 0;
+    unsigned long number = 0;
+    pid_t daemon_pid = 0;
+    uint64_t end = 0;
+    int c = 0, rc = SR_ERR_OK;
+
+    struct option longopts[] = {
+       { "help",      no_argument,       NULL, 'h' },
+       { "data-size", required_argument, NULL, 'd' },
+       { "clients",   required_argument, NULL, 'c' },
+       { "sessions",  required_argument, NULL, 's' },
+       { "ops",       required_argument, NULL, 'n' },
+       { "warmup",    required_argument, NULL, 'w' },
+       { "mix",       required_argument, NULL, 'm' },
+       { "seed",      required_argument, NULL, 'r' },
+       { "output",    required_argument, NULL, 'o' },
+       { "daemon",    required_argument, NULL, 'D' },
+       { "shm",       no_argument,       NULL, 'S' },
+       { 0, 0, 0, 0 }
+    };
+
+    opts.data_size = BENCH_DEFAULT_DATA_SIZE;
+    opts.clients = 1;
+    opts.sessions = 1;
+    opts.op_count = BENCH_DEFAULT_OP_COUNT;
+    opts.seed = 1;
+    opts.output = "-";
+    bench_parse_mix("get=50,set=15,commit=10,rpc=10,notif=10,dp=5", &opts);
+
+    while ((c = getopt_long(argc, argv, "hd:c:s:n:w:m:r:o:D:S", longopts, NULL)) != -1) {
+        switch (c) {
+            case 'h':
+                bench_print_help();
+                return EXIT_SUCCESS;
+            case 'd':
+                if (SR_ERR_OK != bench_parse_number(optarg, SIZE_MAX, &number)) {
+                    fprintf(stderr, "Invalid number '%s' of option -d.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                opts.data_size = number;
+                break;
+            case 'c':
+                if (SR_ERR_OK != bench_parse_number(optarg, SIZE_MAX, &number)) {
+                    fprintf(stderr, "Invalid number '%s' of option -c.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                opts.clients = number;
+                break;
+            case 's':
+                if (SR_ERR_OK != bench_parse_number(optarg, SIZE_MAX, &number)) {
+                    fprintf(stderr, "Invalid number '%s' of option -s.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                opts.sessions = number;
+                break;
+            case 'n':
+                if (SR_ERR_OK != bench_parse_number(optarg, SIZE_MAX, &number)) {
+                    fprintf(stderr, "Invalid number '%s' of option -n.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                opts.op_count = number;
+                break;
+            case 'w':
+                if (SR_ERR_OK != bench_parse_number(optarg, SIZE_MAX, &number)) {
+                    fprintf(stderr, "Invalid number '%s' of option -w.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                opts.warmup = number;
+                break;
+            case 'm':
+                if (SR_ERR_OK != bench_parse_mix(optarg, &opts)) {
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'r':
+                if (SR_ERR_OK != bench_parse_number(optarg, UINT_MAX, &number)) {
+                    fprintf(stderr, "Invalid number '%s' of option -r.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                opts.seed = number;
+                break;
+            case 'o':
+                opts.output = optarg;
+                break;
+            case 'D':
+                opts.daemon_path = optarg;
+                break;
+            case 'S':
+                opts.shm = true;
+                break;
+            default:
+                bench_print_help();
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (0 == opts.data_size || 0 == opts.clients || 0 == opts.sessions || 0 == opts.op_count) {
+        fprintf(stderr, "Data size, number of clients, sessions and operations have to be positive.\n");
+        return EXIT_FAILURE;
+    }
+    if (opts.clients > opts.data_size) {
+        /* each client modifies its own list instance, shared instances would make the commits conflict */
+        fprintf(stderr, "Number of clients can not exceed the data size.\n");
+        return EXIT_FAILURE;
+    }
+
+    sr_log_stderr(SR_LL_ERR);
+    sr_log_syslog(SR_LL_NONE);
+
+    /* generate the data before the engine is started */
+    createDataTreeLargeExampleModule(opts.data_size);
+    createDataTreeLargeIETFinterfacesModule(opts.data_size);
+
+    if (NULL != opts.daemon_path) {
+        rc = bench_daemon_start(&opts, &daemon_pid);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to start the daemon");
+    }
+
+    rc = bench_subscriber_start(&opts, &subscriber);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to subscribe");
+
+    clients = calloc(opts.clients, sizeof(*clients));
+    CHECK_NULL_NOMEM_GOTO(clients, rc, cleanup);
+    for (size_t i = 0; i < opts.clients; i++) {
+        clients[i].opts = &opts;
+        clients[i].gate = &gate;
+        rc = bench_client_init(&opts, i, &clients[i]);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to initialize a client");
+    }
+
+    gate.expected = opts.clients;
+    for (started = 0; started < opts.clients; started++) {
+        if (0 != pthread_create(&clients[started].thread, NULL, bench_client_run, &clients[started])) {
+            SR_LOG_ERR_MSG("Unable to start a client thread.");
+            rc = SR_ERR_INTERNAL;
+            bench_gate_abort(&gate);
+            break;
+        }
+    }
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(clients[i].thread, NULL);
+    }
+    end = bench_now();
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Benchmark has not been completed");
+
+    rc = bench_write_report(&opts, clients, (end - gate.start) / 1000000000.0);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to write the report");
+
+    /* the report is written in any case, but a run with failed operations is not successful */
+    for (size_t i = 0; i < opts.clients; i++) {
+        for (size_t op = 0; op < BENCH_OP_COUNT; op++) {
+            errors += clients[i].samples[op].errors;
+        }
+    }
+    if (errors > 0) {
+        fprintf(stderr, "%zu operation(s) failed.\n", errors);
+        rc = SR_ERR_OPERATION_FAILED;
+    }
+
+cleanup:
+    if (NULL != clients) {
+        for (size_t i = 0; i < opts.clients; i++) {
+            bench_client_cleanup(&clients[i]);
+        }
+        free(clients);
+    }
+    bench_subscriber_stop(&subscriber);
+    bench_daemon_stop(daemon_pid);
+
+    return SR_ERR_OK == rc ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -314,6 +314,64 @@ cl_get_changes_modified_test(void **state)
     assert_int_equal(rc, SR_ERR_OK);
 }
 
+static void
+cl_get_changes_inline_test(void **state)
+{
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+    sr_session_ctx_t *session = NULL;
+    sr_subscription_ctx_t *subscription = NULL;
+    changes_t changes = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cv = PTHREAD_COND_INITIALIZER, 0};
+    struct timespec ts;
+    int rc = SR_ERR_OK;
+
+    /* start session */
+    rc = sr_session_start(conn, SR_DS_RUNNING, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* changes are delivered together with the notification */
+    rc = sr_module_change_subscribe(session, "test-module", list_changes_cb, &changes,
+            0, SR_SUBSCR_INLINE_CHANGES, &subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    sr_val_t v = {0};
+    v.type = SR_UINT8_T;
+    v.data.uint8_val = 19;
+
+    rc = sr_set_item(session, "/test-module:main/ui8", &v, SR_EDIT_DEFAULT);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* save changes to running */
+    pthread_mutex_lock(&changes.mutex);
+    rc = sr_commit(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    sr_clock_get_time(CLOCK_REALTIME, &ts);
+    ts.tv_sec += COND_WAIT_SEC;
+    pthread_cond_timedwait(&changes.cv, &changes.mutex, &ts);
+
+    assert_int_equal(changes.events_received, VERIFY_CALLED | APPLY_CALLED);
+    assert_int_equal(changes.cnt, 1);
+    assert_non_null(changes.new_values[0]);
+    assert_string_equal("/test-module:main/ui8", changes.new_values[0]->xpath);
+    assert_int_equal(19, changes.new_values[0]->data.uint8_val);
+
+    for (size_t i = 0; i < changes.cnt; i++) {
+        sr_free_val(changes.new_values[i]);
+        sr_free_val(changes.old_values[i]);
+    }
+    pthread_mutex_unlock(&changes.mutex);
+
+    pthread_mutex_destroy(&changes.mutex);
+    pthread_cond_destroy(&changes.cv);
+
+    rc = sr_unsubscribe(NULL, subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+}
+
 static void
 cl_get_changes_deleted_test(void **state)
 {
@@ -2611,6 +2669,7 @@ main()
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup_teardown(cl_get_changes_create_test, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_get_changes_modified_test, sysrepo_setup, sysrepo_teardown),
+        cmocka_unit_test_setup_teardown(cl_get_changes_inline_test, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_get_changes_deleted_test, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_get_changes_moved_test, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_get_changes_deleted_default_test, sysrepo_setup, sysrepo_teardown),
@@ -29,6 +29,7 @@
 #include <inttypes.h>
 #include <pthread.h>
 #include <stdarg.h>
+#include <sys/stat.h>
 
 #include "sysrepo.h"
 #include "client_library.h"
@@ -714,6 +715,60 @@ cl_dp_traffic_light(const char *xpath, sr_val_t **values, size_t *values_cnt, vo
     return 0;
 }
 
+/**
+ * @brief Batch data provider delegating to ::cl_dp_traffic_stats, records the number of xpaths of each batch.
+ */
+static int
+cl_dp_traffic_stats_batch(const char **xpaths, size_t xpath_cnt, sr_val_t **values, size_t *values_cnt, void *private_ctx)
+{
+    sr_list_t **lists = (sr_list_t **) private_ctx;
+    sr_val_t *partial[MAX_LEN] = { NULL, }, *v = NULL;
+    size_t partial_cnt[MAX_LEN] = { 0, }, total = 0, k = 0;
+    int rc = SR_ERR_OK;
+
+    if (xpath_cnt > MAX_LEN || 0 != sr_list_add(lists[1], (void *) xpath_cnt)) {
+        return SR_ERR_INTERNAL;
+    }
+
+    for (size_t i = 0; i < xpath_cnt; i++) {
+        rc = cl_dp_traffic_stats(xpaths[i], &partial[i], &partial_cnt[i], lists[0]);
+        if (SR_ERR_OK != rc) {
+            goto cleanup;
+        }
+        total += partial_cnt[i];
+    }
+
+    if (0 == total) {
+        *values = NULL;
+        *values_cnt = 0;
+        goto cleanup;
+    }
+
+    rc = sr_new_values(total, &v);
+    if (SR_ERR_OK != rc) {
+        goto cleanup;
+    }
+    for (size_t i = 0; i < xpath_cnt; i++) {
+        for (size_t j = 0; j < partial_cnt[i]; j++, k++) {
+            sr_val_set_xpath(&v[k], partial[i][j].xpath);
+            if (SR_ENUM_T == partial[i][j].type || SR_STRING_T == partial[i][j].type) {
+                sr_val_set_str_data(&v[k], partial[i][j].type, partial[i][j].data.string_val);
+            } else {
+                v[k].type = partial[i][j].type;
+                v[k].data = partial[i][j].data;
+            }
+        }
+    }
+    *values = v;
+    *values_cnt = total;
+
+cleanup:
+    for (size_t i = 0; i < xpath_cnt; i++) {
+        sr_free_values(partial[i], partial_cnt[i]);
+    }
+    return rc;
+}
+
 static int
 cl_dp_card_state(const char *xpath, sr_val_t **values, size_t *values_cnt, void *private_ctx)
 {
@@ -1745,6 +1800,79 @@ cl_nested_data_subscription(void **state)
     sr_list_cleanup(xpath_retrieved);
 }
 
+static void
+cl_nested_data_subscription_batch(void **state)
+{
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+    sr_session_ctx_t *session = NULL;
+    sr_subscription_ctx_t *subscription = NULL;
+    sr_list_t *xpath_retrieved = NULL, *batch_sizes = NULL;
+    sr_list_t *lists[2] = { NULL, };
+    sr_val_t *values = NULL;
+    size_t cnt = 0;
+    int rc = SR_ERR_OK;
+
+    rc = sr_list_init(&xpath_retrieved);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_list_init(&batch_sizes);
+    assert_int_equal(rc, SR_ERR_OK);
+    lists[0] = xpath_retrieved;
+    lists[1] = batch_sizes;
+
+    /* start session */
+    rc = sr_session_start(conn, SR_DS_RUNNING, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_module_change_subscribe(session, "state-module", cl_whole_module_cb, NULL,
+            0, SR_SUBSCR_DEFAULT, &subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* subscribe batch data provider */
+    rc = sr_dp_get_items_batch_subscribe(session, "/state-module:traffic_stats", cl_dp_traffic_stats_batch, lists, SR_SUBSCR_CTX_REUSE, &subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* retrieve data */
+    rc = sr_get_items(session, "/state-module:traffic_stats/*", &values, &cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* check data */
+    assert_non_null(values);
+    assert_int_equal(5, cnt);
+
+    sr_free_values(values, cnt);
+
+    /* check xpath that were retrieved */
+    const char *xpath_expected_to_be_loaded [] = {
+        "/state-module:traffic_stats",
+        "/state-module:traffic_stats/cross_road",
+        "/state-module:traffic_stats/cross_road[id='0']/traffic_light",
+        "/state-module:traffic_stats/cross_road[id='0']/advanced_info",
+        "/state-module:traffic_stats/cross_road[id='1']/traffic_light",
+        "/state-module:traffic_stats/cross_road[id='1']/advanced_info",
+        "/state-module:traffic_stats/cross_road[id='2']/traffic_light",
+        "/state-module:traffic_stats/cross_road[id='2']/advanced_info",
+    };
+    CHECK_LIST_OF_STRINGS(xpath_retrieved, xpath_expected_to_be_loaded);
+
+    /* nested nodes of all list instances were requested in a single batch */
+    assert_int_equal(4, batch_sizes->count);
+    assert_int_equal(1, (size_t) batch_sizes->data[0]);
+    assert_int_equal(1, (size_t) batch_sizes->data[1]);
+    assert_int_equal(3, (size_t) batch_sizes->data[2]);
+    assert_int_equal(3, (size_t) batch_sizes->data[3]);
+
+    /* cleanup */
+    sr_unsubscribe(session, subscription);
+    sr_session_stop(session);
+
+    for (size_t i = 0; i < xpath_retrieved->count; i++) {
+        free(xpath_retrieved->data[i]);
+    }
+    sr_list_cleanup(xpath_retrieved);
+    sr_list_cleanup(batch_sizes);
+}
+
 static void
 cl_nested_data_subscription_tree(void **state)
 {
@@ -2202,6 +2330,107 @@ cl_nested_data_subscription_tree(void **state)
     sr_list_cleanup(xpath_retrieved);
 }
 
+static void
+cl_dp_cache_ttl(void **state)
+{
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+    sr_session_ctx_t *session = NULL, *denied_session = NULL;
+    sr_subscription_ctx_t *subscription = NULL;
+    sr_list_t *xpath_retrieved = NULL;
+    sr_val_t *values = NULL, *value = NULL;
+    size_t cnt = 0, retrieved_cnt = 0;
+    struct stat file_stat = { 0, };
+    int rc = SR_ERR_OK;
+
+    rc = sr_list_init(&xpath_retrieved);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* start session */
+    rc = sr_session_start(conn, SR_DS_RUNNING, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_module_change_subscribe(session, "state-module", cl_whole_module_cb, NULL,
+            0, SR_SUBSCR_DEFAULT, &subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* subscribe data providers, only one of them allows caching */
+    rc = sr_dp_get_items_subscribe(session, "/state-module:bus/distance_travelled", cl_dp_distance_travelled, xpath_retrieved,
+            SR_SUBSCR_CTX_REUSE | SR_SUBSCR_DP_CACHE_TTL(60), &subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_dp_get_items_subscribe(session, "/state-module:bus/gps_located", cl_dp_gps_located, xpath_retrieved, SR_SUBSCR_CTX_REUSE, &subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    for (size_t i = 0; i < 3; i++) {
+        if (2 == i) {
+            /* data provider announces a change of its data */
+            rc = sr_dp_cache_invalidate(session, "/state-module:bus/distance_travelled");
+            assert_int_equal(rc, SR_ERR_OK);
+            /* xpath of an unknown module is rejected */
+            rc = sr_dp_cache_invalidate(session, "/unknown-module:bus/distance_travelled");
+            assert_int_not_equal(rc, SR_ERR_OK);
+        }
+        retrieved_cnt = xpath_retrieved->count;
+
+        /* retrieve data */
+        rc = sr_get_items(session, "/state-module:bus//*", &values, &cnt);
+        assert_int_equal(rc, SR_ERR_OK);
+
+        value = sr_val_get_by_xpath(values, cnt, "/state-module:bus/gps_located");
+        assert_non_null(value);
+        assert_int_equal(false, value->data.bool_val);
+
+        value = sr_val_get_by_xpath(values, cnt, "/state-module:bus/distance_travelled");
+        assert_non_null(value);
+        assert_int_equal(SR_UINT32_T, value->type);
+        assert_int_equal(999, value->data.uint32_val);
+
+        sr_free_values(values, cnt);
+
+        /* the second read is served from the cache, the third one after invalidation is not */
+        assert_int_equal(1 == i ? 1 : 2, xpath_retrieved->count - retrieved_cnt);
+    }
+
+    /* a session without read access to the data is not allowed to invalidate them */
+    rc = stat(TEST_DATA_SEARCH_DIR "state-module.startup", &file_stat);
+    assert_int_equal(0, rc);
+    rc = chmod(TEST_DATA_SEARCH_DIR "state-module.startup", S_IWUSR);
+    assert_int_equal(0, rc);
+    if (0 == getuid()) {
+        rc = sr_session_start_user(conn, "nobody", SR_DS_RUNNING, SR_SESS_DEFAULT, &denied_session);
+    } else {
+        rc = sr_session_start(conn, SR_DS_RUNNING, SR_SESS_DEFAULT, &denied_session);
+    }
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_dp_cache_invalidate(denied_session, "/state-module:bus/distance_travelled");
+    assert_int_equal(rc, SR_ERR_UNAUTHORIZED);
+
+    sr_session_stop(denied_session);
+    rc = chmod(TEST_DATA_SEARCH_DIR "state-module.startup", file_stat.st_mode & 07777);
+    assert_int_equal(0, rc);
+
+    /* the cached data are still used */
+    retrieved_cnt = xpath_retrieved->count;
+    rc = sr_get_items(session, "/state-module:bus//*", &values, &cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    value = sr_val_get_by_xpath(values, cnt, "/state-module:bus/distance_travelled");
+    assert_non_null(value);
+    assert_int_equal(999, value->data.uint32_val);
+    sr_free_values(values, cnt);
+    assert_int_equal(1, xpath_retrieved->count - retrieved_cnt);
+
+    /* cleanup */
+    sr_unsubscribe(session, subscription);
+    sr_session_stop(session);
+
+    for (size_t i = 0; i < xpath_retrieved->count; i++) {
+        free(xpath_retrieved->data[i]);
+    }
+    sr_list_cleanup(xpath_retrieved);
+}
+
 static void
 cl_nested_data_subscription2(void **state)
 {
@@ -3114,6 +3343,8 @@ main()
         cmocka_unit_test_setup_teardown(cl_dp_neg_subscription, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_nested_data_subscription, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_nested_data_subscription_tree, sysrepo_setup, sysrepo_teardown),
+        cmocka_unit_test_setup_teardown(cl_nested_data_subscription_batch, sysrepo_setup, sysrepo_teardown),
+        cmocka_unit_test_setup_teardown(cl_dp_cache_ttl, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_nested_data_subscription2, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_nested_data_subscription2_tree, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_all_state_data, sysrepo_setup, sysrepo_teardown),
@@ -29,10 +29,12 @@
 #include <pthread.h>
 #include <signal.h>
 #include <fcntl.h>
+#include <sys/socket.h>
 
 #include "sr_constants.h"
 #include "sysrepo.h"
 #include "client_library.h"
+#include "cl_common.h"
 
 #include "sr_common.h"
 #include "test_module_helper.h"
@@ -290,6 +292,137 @@ cl_disconnect_test(void **state)
     sr_disconnect(conn);
 }
 
+static void
+cl_shm_transport_test(void **state)
+{
+    sr_conn_ctx_t *conn_shm = NULL, *conn_sock = NULL;
+    sr_session_ctx_t *sess_shm = NULL, *sess_sock = NULL;
+    sr_val_t value = { 0, }, *val = NULL, *values = NULL;
+    size_t value_cnt = 0;
+    int rc = 0;
+
+    createDataTreeExampleModule();
+
+    rc = sr_connect("cl_test", SR_CONN_SHM_TRANSPORT, &conn_shm);
+    assert_int_equal(rc, SR_ERR_OK);
+#ifdef HAVE_MEMFD_CREATE
+    assert_non_null(conn_shm->shm);
+#else
+    /* the engine cannot create the segment, the connection uses the socket only */
+    assert_null(conn_shm->shm);
+#endif
+    rc = sr_connect("cl_test", SR_CONN_DEFAULT, &conn_sock);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_null(conn_sock->shm);
+
+    rc = sr_session_start(conn_shm, SR_DS_STARTUP, SR_SESS_DEFAULT, &sess_shm);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_session_start(conn_sock, SR_DS_STARTUP, SR_SESS_DEFAULT, &sess_sock);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* many requests in a row, the responses are announced by the doorbells */
+    for (size_t i = 0; i < 1000; i++) {
+        rc = sr_get_item(sess_shm, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &val);
+        assert_int_equal(rc, SR_ERR_OK);
+        assert_string_equal("Leaf value", val->data.string_val);
+        sr_free_val(val);
+    }
+
+    /* changes committed over the shared memory are visible to the socket-only connection */
+    value.type = SR_STRING_T;
+    value.data.string_val = "shm";
+    rc = sr_set_item(sess_shm, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &value, SR_EDIT_DEFAULT);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_set_item(sess_shm, "/example-module:container/list[key1='abc'][key2='def']/leaf", &value, SR_EDIT_DEFAULT);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_commit(sess_shm);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_get_item(sess_sock, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &val);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_string_equal("shm", val->data.string_val);
+    sr_free_val(val);
+
+    rc = sr_session_refresh(sess_shm);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_get_items(sess_shm, "/example-module:container/list/leaf", &values, &value_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(2, value_cnt);
+    for (size_t i = 0; i < value_cnt; i++) {
+        assert_string_equal("shm", values[i].data.string_val);
+    }
+    sr_free_values(values, value_cnt);
+
+    rc = sr_session_stop(sess_shm);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_session_stop(sess_sock);
+    assert_int_equal(rc, SR_ERR_OK);
+    sr_disconnect(conn_shm);
+    sr_disconnect(conn_sock);
+
+    createDataTreeExampleModule();
+}
+
+/**
+ * @brief Negotiates the shared-memory channel with a fake engine on the other side of the socket pair,
+ * which has already answered with the given control code.
+ */
+static int
+cl_shm_negotiate_with_answer(uint32_t answer, sr_conn_ctx_t **conn_p)
+{
+    uint8_t frame[SR_MSG_CTRL_SIZE] = { 0, };
+    int sv[2] = { -1, -1 };
+    int rc = 0;
+
+    assert_int_equal(SR_ERR_OK, cl_connection_create(conn_p));
+    assert_int_equal(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    (*conn_p)->fd = sv[0];
+
+    if (0 != answer) {
+        sr_uint32_to_buff(0, frame);
+        sr_uint32_to_buff(answer, frame + SR_MSG_PREAM_SIZE);
+        assert_int_equal(SR_MSG_CTRL_SIZE, send(sv[1], frame, SR_MSG_CTRL_SIZE, 0));
+    } else {
+        /* the engine disconnects */
+        shutdown(sv[1], SHUT_WR);
+    }
+
+    rc = cl_shm_channel_negotiate(*conn_p);
+
+    /* the request has been sent in any case */
+    assert_int_equal(SR_MSG_CTRL_SIZE, recv(sv[1], frame, SR_MSG_CTRL_SIZE, MSG_WAITALL));
+    assert_int_equal(0, sr_buff_to_uint32(frame));
+    assert_int_equal(SR_MSG_CTRL_SHM_REQUEST, sr_buff_to_uint32(frame + SR_MSG_PREAM_SIZE));
+    close(sv[1]);
+
+    return rc;
+}
+
+static void
+cl_shm_transport_fallback_test(void **state)
+{
+    sr_conn_ctx_t *conn = NULL;
+    int rc = 0;
+
+    /* rejected channel, the connection continues over the socket */
+    rc = cl_shm_negotiate_with_answer(SR_MSG_CTRL_SHM_REJECT, &conn);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_null(conn->shm);
+    cl_connection_cleanup(conn);
+
+    /* accepted channel without the segment */
+    rc = cl_shm_negotiate_with_answer(SR_MSG_CTRL_SHM_ACCEPT, &conn);
+    assert_int_equal(SR_ERR_MALFORMED_MSG, rc);
+    assert_null(conn->shm);
+    cl_connection_cleanup(conn);
+
+    /* engine disconnected during the negotiation */
+    rc = cl_shm_negotiate_with_answer(0, &conn);
+    assert_int_equal(SR_ERR_DISCONNECT, rc);
+    assert_null(conn->shm);
+    cl_connection_cleanup(conn);
+}
+
 static void
 cl_list_schemas_test(void **state)
 {
@@ -1295,6 +1428,218 @@ cl_delete_item_test(void **state)
     assert_int_equal(rc, SR_ERR_OK);
 }
 
+static void
+cl_async_requests_test(void **state)
+{
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+
+    createDataTreeIETFinterfacesModule();
+    sr_session_ctx_t *session = NULL, *session2 = NULL;
+    sr_async_req_t *req[6] = { NULL, };
+    sr_val_t value = { 0 }, *values = NULL;
+    size_t values_cnt = 0;
+    int rc = 0;
+
+    /* start two sessions on the same connection */
+    rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session2);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* pipeline requests in both sessions without waiting for the responses */
+    value.type = SR_STRING_T;
+    value.data.string_val = "async";
+    rc = sr_set_item_async(session, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &value, SR_EDIT_DEFAULT, &req[0]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_get_items_async(session2, "/ietf-interfaces:interfaces/interface", &req[1]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_get_items_async(session, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &req[2]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_delete_item_async(session, "/example-module:container/list[key1='key1'][key2='key2']/leaf", SR_EDIT_DEFAULT, &req[3]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_get_items_async(session, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &req[4]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_get_items_async(session2, "/unknown-model:abc", &req[5]);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* wait for the responses in a different order than requests were sent */
+    rc = sr_async_wait(req[5], &values, &values_cnt);
+    assert_int_equal(rc, SR_ERR_UNKNOWN_MODEL);
+
+    rc = sr_async_wait(req[2], &values, &values_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(1, values_cnt);
+    assert_string_equal("async", values[0].data.string_val);
+    sr_free_values(values, values_cnt);
+
+    rc = sr_async_wait(req[0], NULL, NULL);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_async_wait(req[4], &values, &values_cnt);
+    assert_int_equal(rc, SR_ERR_NOT_FOUND);
+
+    rc = sr_async_wait(req[3], NULL, NULL);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_async_wait(req[1], &values, &values_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(3, values_cnt);
+    sr_free_values(values, values_cnt);
+
+    /* synchronous requests still work on the connection */
+    rc = sr_get_items(session2, "/ietf-interfaces:interfaces/interface", &values, &values_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    sr_free_values(values, values_cnt);
+
+    /* stop the sessions */
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_session_stop(session2);
+    assert_int_equal(rc, SR_ERR_OK);
+}
+
+static void
+cl_edit_batch_test(void **state)
+{
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+
+    sr_session_ctx_t *session = NULL;
+    sr_edit_op_t ops[5] = {{ 0, }};
+    sr_val_t value = { 0 }, *values = NULL;
+    const sr_error_info_t *error_info = NULL;
+    size_t values_cnt = 0, error_cnt = 0;
+    int results[5] = { 0, };
+    int rc = 0;
+
+    /* start a session */
+    rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* set a leaf, set two list entries from string, delete one of them and set a non-presence container */
+    value.type = SR_STRING_T;
+    value.data.string_val = "batch";
+    ops[0].type = SR_EDIT_OP_SET;
+    ops[0].xpath = "/example-module:container/list[key1='key1'][key2='key2']/leaf";
+    ops[0].value = &value;
+    ops[1].type = SR_EDIT_OP_SET_STR;
+    ops[1].xpath = "/example-module:container/list[key1='batch'][key2='b1']/leaf";
+    ops[1].str_value = "b1";
+    ops[2].type = SR_EDIT_OP_SET;
+    ops[2].xpath = "/test-module:main";
+    ops[3].type = SR_EDIT_OP_SET_STR;
+    ops[3].xpath = "/example-module:container/list[key1='batch'][key2='b2']/leaf";
+    ops[3].str_value = "b2";
+    ops[4].type = SR_EDIT_OP_DELETE;
+    ops[4].xpath = "/example-module:container/list[key1='batch'][key2='b1']";
+    ops[4].opts = SR_EDIT_STRICT;
+
+    rc = sr_edit_batch(session, ops, 5, results);
+    assert_int_equal(rc, SR_ERR_INVAL_ARG);
+    assert_int_equal(results[0], SR_ERR_OK);
+    assert_int_equal(results[1], SR_ERR_OK);
+    assert_int_equal(results[2], SR_ERR_INVAL_ARG);
+    assert_int_equal(results[3], SR_ERR_OK);
+    assert_int_equal(results[4], SR_ERR_OK);
+
+    rc = sr_get_last_errors(session, &error_info, &error_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(error_cnt, 1);
+
+    /* verify the result of the successful operations */
+    rc = sr_get_items(session, "/example-module:container/list[key1='batch']/leaf", &values, &values_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(values_cnt, 1);
+    assert_string_equal(values[0].data.string_val, "b2");
+    sr_free_values(values, values_cnt);
+
+    rc = sr_get_items(session, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &values, &values_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_string_equal(values[0].data.string_val, "batch");
+    sr_free_values(values, values_cnt);
+
+    /* empty batch */
+    rc = sr_edit_batch(session, ops, 0, NULL);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* stop the session */
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+}
+
+static void
+cl_import_data_test(void **state)
+{
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+
+    sr_session_ctx_t *session = NULL;
+    sr_val_t *values = NULL;
+    size_t values_cnt = 0;
+    int rc = 0;
+
+    const char *xml_data =
+            "<container xmlns=\"urn:ietf:params:xml:ns:yang:example\">"
+            "<list><key1>imp</key1><key2>i1</key2><leaf>i1</leaf></list>"
+            "<list><key1>imp</key1><key2>i2</key2><leaf>i2</leaf></list>"
+            "</container>";
+    const char *json_data =
+            "{\"example-module:container\":{\"list\":[{\"key1\":\"imp\",\"key2\":\"i3\",\"leaf\":\"i3\"}]}}";
+
+    /* start a session */
+    rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* merge XML data with the current content */
+    rc = sr_import_data(session, "example-module", xml_data, SR_DATA_XML, SR_IMPORT_MERGE);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_get_items(session, "/example-module:container/list", &values, &values_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(values_cnt, 3);
+    sr_free_values(values, values_cnt);
+
+    /* replace the content with JSON data */
+    rc = sr_import_data(session, "example-module", json_data, SR_DATA_JSON, SR_IMPORT_REPLACE);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_get_items(session, "/example-module:container/list", &values, &values_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(values_cnt, 1);
+    assert_string_equal(values[0].xpath, "/example-module:container/list[key1='imp'][key2='i3']");
+    sr_free_values(values, values_cnt);
+
+    /* the import survives the commit */
+    rc = sr_commit(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_session_refresh(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_get_items(session, "/example-module:container/list[key1='imp']/leaf", &values, &values_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(values_cnt, 1);
+    assert_string_equal(values[0].data.string_val, "i3");
+    sr_free_values(values, values_cnt);
+
+    /* data of another module */
+    rc = sr_import_data(session, "test-module", xml_data, SR_DATA_XML, SR_IMPORT_MERGE);
+    assert_int_equal(rc, SR_ERR_INVAL_ARG);
+
+    /* malformed data */
+    rc = sr_import_data(session, "example-module", "<container", SR_DATA_XML, SR_IMPORT_MERGE);
+    assert_int_equal(rc, SR_ERR_INVAL_ARG);
+
+    /* unknown module */
+    rc = sr_import_data(session, "unknown-module", xml_data, SR_DATA_XML, SR_IMPORT_MERGE);
+    assert_int_equal(rc, SR_ERR_UNKNOWN_MODEL);
+
+    /* stop the session */
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+}
+
 static void
 cl_move_item_test(void **state)
 {
@@ -5880,6 +6225,8 @@ main()
             cmocka_unit_test_setup_teardown(cl_connection_test, logging_setup, NULL),
             cmocka_unit_test_setup_teardown(cl_multiconnect_test, logging_setup, NULL),
             cmocka_unit_test_setup_teardown(cl_disconnect_test, logging_setup, NULL),
+            cmocka_unit_test_setup_teardown(cl_shm_transport_test, logging_setup, NULL),
+            cmocka_unit_test_setup_teardown(cl_shm_transport_fallback_test, logging_setup, NULL),
             cmocka_unit_test_setup_teardown(cl_list_schemas_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_get_schema_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_get_item_test, sysrepo_setup, sysrepo_teardown),
@@ -5891,6 +6238,9 @@ main()
             cmocka_unit_test_setup_teardown(cl_iterative_trees_traversal, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_set_item_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_delete_item_test, sysrepo_setup, sysrepo_teardown),
+            cmocka_unit_test_setup_teardown(cl_async_requests_test, sysrepo_setup, sysrepo_teardown),
+            cmocka_unit_test_setup_teardown(cl_edit_batch_test, sysrepo_setup, sysrepo_teardown),
+            cmocka_unit_test_setup_teardown(cl_import_data_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_move_item_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_validate_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_commit_test, sysrepo_setup, sysrepo_teardown),
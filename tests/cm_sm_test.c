@@ -37,7 +37,7 @@ setup(void **state) {
     sr_logger_init("sm_test");
     sr_log_stderr(SR_LL_DBG);
 
-    sm_init(NULL, NULL, &ctx);
+    sm_init(NULL, NULL, 1, &ctx);
     *state = ctx;
 
     return 0;
@@ -217,12 +217,63 @@ session_find_fd(void **state) {
 #endif
 }
 
+/**
+ * Distributes connections across 4 I/O loops, checks that the session IDs encode
+ * the I/O loop of their connection and that destination lookups are per I/O loop.
+ */
+static void
+session_io_loop(void **state) {
+#ifdef __linux__
+    sm_ctx_t *ctx = NULL;
+    sm_connection_t *conn[4] = { NULL, }, *found = NULL;
+    sm_session_t *sess = NULL;
+    int sockets[2] = { 0, };
+    int rc = SR_ERR_OK;
+
+    rc = sm_init(NULL, NULL, 4, &ctx);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+        rc = sm_connection_start(ctx, CM_AF_UNIX_SERVER, sockets[0], &conn[i]);
+        assert_int_equal(rc, SR_ERR_OK);
+        conn[i]->io_loop = i;
+        rc = sm_connection_assign_dst(ctx, conn[i], "/tmp/sm-test-dst.sock");
+        assert_int_equal(rc, SR_ERR_OK);
+
+        for (size_t j = 0; j < 10; j++) {
+            rc = sm_session_create(ctx, conn[i], NULL, &sess);
+            assert_int_equal(rc, SR_ERR_OK);
+            assert_int_equal(sm_session_io_loop(ctx, sess->id), i);
+        }
+    }
+    assert_int_equal(sm_session_io_loop(ctx, 0), 0);
+
+    /* each I/O loop has its own connection to the destination */
+    for (uint32_t i = 0; i < 4; i++) {
+        rc = sm_connection_find_dst(ctx, "/tmp/sm-test-dst.sock", i, &found);
+        assert_int_equal(rc, SR_ERR_OK);
+        assert_ptr_equal(found, conn[i]);
+    }
+    rc = sm_connection_stop(ctx, conn[2]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sm_connection_find_dst(ctx, "/tmp/sm-test-dst.sock", 2, &found);
+    assert_int_equal(rc, SR_ERR_NOT_FOUND);
+    rc = sm_connection_find_dst(ctx, "/tmp/sm-test-dst.sock", 3, &found);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_ptr_equal(found, conn[3]);
+
+    sm_cleanup(ctx);
+#endif
+}
+
 int
 main() {
     const struct CMUnitTest tests[] = {
             cmocka_unit_test_setup_teardown(session_create_drop, setup, teardown),
             cmocka_unit_test_setup_teardown(session_find_id, setup, teardown),
             cmocka_unit_test_setup_teardown(session_find_fd, setup, teardown),
+            cmocka_unit_test_setup_teardown(session_io_loop, setup, teardown),
     };
 
     watchdog_start(300);
@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <limits.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <signal.h>
@@ -31,6 +32,7 @@
 #include <time.h>
 
 #include "sr_common.h"
+#include "sr_shm_channel.h"
 #include "connection_manager.h"
 #include "sysrepo.pb-c.h"
 
@@ -265,6 +267,93 @@ session_start_stop(int fd)
     sr__msg__free_unpacked(msg, NULL);
 }
 
+static void
+cm_ctrl_send(const int fd, uint32_t code)
+{
+    uint8_t frame[SR_MSG_CTRL_SIZE] = { 0, };
+    int rc = 0;
+
+    sr_uint32_to_buff(0, frame);
+    sr_uint32_to_buff(code, frame + SR_MSG_PREAM_SIZE);
+    rc = send(fd, frame, SR_MSG_CTRL_SIZE, 0);
+    assert_int_equal(rc, SR_MSG_CTRL_SIZE);
+}
+
+/**
+ * @brief Receives a control frame, the descriptor passed along with it is returned in shm_fd (-1 if none).
+ */
+static uint32_t
+cm_ctrl_recv(const int fd, int *shm_fd)
+{
+    uint8_t frame[SR_MSG_CTRL_SIZE] = { 0, };
+    struct msghdr msgh = { 0, };
+    struct iovec iov = { 0, };
+    struct cmsghdr *cmsg = NULL;
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    size_t pos = 0;
+    ssize_t len = 0;
+
+    *shm_fd = -1;
+    while (pos < SR_MSG_CTRL_SIZE) {
+        memset(&msgh, 0, sizeof(msgh));
+        memset(&control, 0, sizeof(control));
+        iov.iov_base = frame + pos;
+        iov.iov_len = SR_MSG_CTRL_SIZE - pos;
+        msgh.msg_iov = &iov;
+        msgh.msg_iovlen = 1;
+        msgh.msg_control = control.buf;
+        msgh.msg_controllen = sizeof(control.buf);
+        len = recvmsg(fd, &msgh, 0);
+        assert_true(len > 0);
+        for (cmsg = CMSG_FIRSTHDR(&msgh); NULL != cmsg; cmsg = CMSG_NXTHDR(&msgh, cmsg)) {
+            if (SOL_SOCKET == cmsg->cmsg_level && SCM_RIGHTS == cmsg->cmsg_type) {
+                memcpy(shm_fd, CMSG_DATA(cmsg), sizeof(int));
+            }
+        }
+        pos += len;
+    }
+    assert_int_equal(0, sr_buff_to_uint32(frame));
+
+    return sr_buff_to_uint32(frame + SR_MSG_PREAM_SIZE);
+}
+
+/**
+ * @brief Places the message into the shared-memory channel and rings the doorbell.
+ */
+static void
+cm_shm_message_send(const int fd, sr_shm_channel_t *shm, const void *msg_buf, const size_t msg_size)
+{
+    uint8_t *data = NULL;
+
+    assert_true(sr_shm_channel_reserve(shm, msg_size, &data));
+    memcpy(data, msg_buf, msg_size);
+    sr_shm_channel_commit(shm);
+    cm_ctrl_send(fd, SR_MSG_CTRL_SHM_DOORBELL);
+}
+
+/**
+ * @brief Receives a message announced by a doorbell from the shared-memory channel.
+ */
+static Sr__Msg *
+cm_shm_message_recv(const int fd, sr_shm_channel_t *shm)
+{
+    const uint8_t *data = NULL;
+    size_t size = 0;
+    int shm_fd = -1;
+    Sr__Msg *msg = NULL;
+
+    assert_int_equal(SR_MSG_CTRL_SHM_DOORBELL, cm_ctrl_recv(fd, &shm_fd));
+    assert_int_equal(-1, shm_fd);
+    assert_int_equal(SR_ERR_OK, sr_shm_channel_peek(shm, &data, &size));
+    msg = sr__msg__unpack(NULL, size, data);
+    sr_shm_channel_consume(shm);
+
+    return msg;
+}
+
 /**
  * Session start / stop test.
  */
@@ -502,6 +591,331 @@ cm_buffers_test(void **state)
     /* let the connection manager to be stopped in teardown before reading responses */
 }
 
+/**
+ * Shared-memory transport test.
+ */
+static void
+cm_shm_transport_test(void **state)
+{
+    sr_shm_channel_t *shm = NULL;
+    Sr__Msg *msg = NULL;
+    uint8_t *msg_buf = NULL;
+    size_t msg_size = 0;
+    uint32_t session_id = 0;
+    int fd = -1, shm_fd = -1;
+    uint32_t code = 0;
+
+    fd = cm_connect_to_server();
+
+    /* negotiate the channel */
+    cm_ctrl_send(fd, SR_MSG_CTRL_SHM_REQUEST);
+    code = cm_ctrl_recv(fd, &shm_fd);
+#ifndef HAVE_MEMFD_CREATE
+    /* the engine cannot create the segment, the socket is used for everything */
+    assert_int_equal(SR_MSG_CTRL_SHM_REJECT, code);
+    assert_int_equal(-1, shm_fd);
+    session_start_stop(fd);
+    close(fd);
+    return;
+#endif
+    assert_int_equal(SR_MSG_CTRL_SHM_ACCEPT, code);
+    assert_int_not_equal(-1, shm_fd);
+    assert_int_equal(SR_ERR_OK, sr_shm_channel_attach(shm_fd, &shm));
+    close(shm_fd);
+
+    /* session_start through the shared memory, the response comes the same way */
+    cm_session_start_generate("nobody", &msg_buf, &msg_size);
+    cm_shm_message_send(fd, shm, msg_buf, msg_size);
+    free(msg_buf);
+    msg = cm_shm_message_recv(fd, shm);
+    assert_non_null(msg);
+    assert_int_equal(msg->type, SR__MSG__MSG_TYPE__RESPONSE);
+    assert_int_equal(msg->response->result, SR_ERR_OK);
+    assert_int_equal(msg->response->operation, SR__OPERATION__SESSION_START);
+    assert_non_null(msg->response->session_start_resp);
+    session_id = msg->response->session_start_resp->session_id;
+    sr__msg__free_unpacked(msg, NULL);
+
+    /* requests sent inline over the socket and through the shared memory can be mixed,
+     * responses are kept in the order of the requests */
+    for (size_t i = 0; i < 100; i++) {
+        cm_get_item_generate(session_id, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &msg_buf, &msg_size);
+        if (0 == i % 2) {
+            cm_shm_message_send(fd, shm, msg_buf, msg_size);
+        } else {
+            cm_message_send(fd, msg_buf, msg_size);
+        }
+        free(msg_buf);
+    }
+    for (size_t i = 0; i < 100; i++) {
+        msg = cm_shm_message_recv(fd, shm);
+        assert_non_null(msg);
+        assert_int_equal(msg->response->result, SR_ERR_OK);
+        assert_int_equal(msg->response->operation, SR__OPERATION__GET_ITEM);
+        assert_non_null(msg->response->get_item_resp);
+        assert_non_null(msg->response->get_item_resp->value);
+        assert_string_equal("Leaf value", msg->response->get_item_resp->value->string_val);
+        sr__msg__free_unpacked(msg, NULL);
+    }
+
+    /* the channel can be set up only once per connection, the established one stays in use */
+    cm_ctrl_send(fd, SR_MSG_CTRL_SHM_REQUEST);
+    assert_int_equal(SR_MSG_CTRL_SHM_REJECT, cm_ctrl_recv(fd, &shm_fd));
+    assert_int_equal(-1, shm_fd);
+
+    cm_session_stop_generate(session_id, &msg_buf, &msg_size);
+    cm_shm_message_send(fd, shm, msg_buf, msg_size);
+    free(msg_buf);
+    msg = cm_shm_message_recv(fd, shm);
+    assert_non_null(msg);
+    assert_int_equal(msg->response->result, SR_ERR_OK);
+    assert_int_equal(msg->response->operation, SR__OPERATION__SESSION_STOP);
+    sr__msg__free_unpacked(msg, NULL);
+
+    sr_shm_channel_cleanup(shm);
+    close(fd);
+}
+
+/**
+ * Shared-memory transport negative test.
+ */
+static void
+cm_shm_transport_neg_test(void **state)
+{
+    uint8_t frame[SR_MSG_CTRL_SIZE] = { 0, };
+    int fd = -1;
+
+    /* doorbell without a channel drops the connection */
+    fd = cm_connect_to_server();
+    cm_ctrl_send(fd, SR_MSG_CTRL_SHM_DOORBELL);
+    assert_int_equal(0, recv(fd, frame, sizeof(frame), 0));
+    close(fd);
+
+    /* unknown control code drops the connection */
+    fd = cm_connect_to_server();
+    cm_ctrl_send(fd, 0xff);
+    assert_int_equal(0, recv(fd, frame, sizeof(frame), 0));
+    close(fd);
+
+    /* connections without the channel are not affected */
+    fd = cm_connect_to_server();
+    session_start_stop(fd);
+    close(fd);
+}
+
+#define CM_TEST_SUBSCRIBER_CNT 3  /* number of subscribers of the event notification */
+
+/**
+ * @brief Creates a unix-domain socket listening at the address of a subscriber.
+ */
+static int
+cm_subscriber_listen(const char *socket_path)
+{
+    struct sockaddr_un addr;
+    int fd = -1, rc = -1;
+
+    unlink(socket_path);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    assert_int_not_equal(fd, -1);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path)-1);
+
+    rc = bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+    assert_int_not_equal(rc, -1);
+    rc = listen(fd, 1);
+    assert_int_not_equal(rc, -1);
+
+    return fd;
+}
+
+static void
+cm_event_notif_subscribe_generate(uint32_t session_id, bool subscribe, const char *destination, uint32_t subscription_id,
+        uint8_t **msg_buf, size_t *msg_size)
+{
+    Sr__Msg *msg = NULL;
+
+    if (subscribe) {
+        sr_gpb_req_alloc(NULL, SR__OPERATION__SUBSCRIBE, session_id, &msg);
+        assert_non_null(msg);
+        assert_non_null(msg->request->subscribe_req);
+        msg->request->subscribe_req->type = SR__SUBSCRIPTION_TYPE__EVENT_NOTIF_SUBS;
+        msg->request->subscribe_req->destination = strdup(destination);
+        msg->request->subscribe_req->subscription_id = subscription_id;
+        msg->request->subscribe_req->module_name = strdup("test-module");
+        msg->request->subscribe_req->xpath = strdup("/test-module:link-discovered");
+        msg->request->subscribe_req->api_variant = SR__API_VARIANT__VALUES;
+    } else {
+        sr_gpb_req_alloc(NULL, SR__OPERATION__UNSUBSCRIBE, session_id, &msg);
+        assert_non_null(msg);
+        assert_non_null(msg->request->unsubscribe_req);
+        msg->request->unsubscribe_req->type = SR__SUBSCRIPTION_TYPE__EVENT_NOTIF_SUBS;
+        msg->request->unsubscribe_req->destination = strdup(destination);
+        msg->request->unsubscribe_req->subscription_id = subscription_id;
+        msg->request->unsubscribe_req->module_name = strdup("test-module");
+    }
+
+    cm_msg_pack_to_buff(msg, msg_buf, msg_size);
+}
+
+static void
+cm_event_notif_generate(uint32_t session_id, const sr_val_t *values, size_t values_cnt, time_t timestamp,
+        uint8_t **msg_buf, size_t *msg_size)
+{
+    Sr__Msg *msg = NULL;
+    int rc = SR_ERR_OK;
+
+    sr_gpb_req_alloc(NULL, SR__OPERATION__EVENT_NOTIF, session_id, &msg);
+    assert_non_null(msg);
+    assert_non_null(msg->request->event_notif_req);
+    msg->request->event_notif_req->type = SR__EVENT_NOTIF_REQ__NOTIF_TYPE__REALTIME;
+    msg->request->event_notif_req->xpath = strdup("/test-module:link-discovered");
+    msg->request->event_notif_req->timestamp = timestamp;
+    rc = sr_values_sr_to_gpb(values, values_cnt, &msg->request->event_notif_req->values,
+            &msg->request->event_notif_req->n_values);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    cm_msg_pack_to_buff(msg, msg_buf, msg_size);
+}
+
+/**
+ * Delivery of an event notification to multiple subscribers. The content of the notification is packed once
+ * and spliced into the request of each subscriber, the subscribers must receive regular messages.
+ */
+static void
+cm_event_notif_delivery_test(void **state)
+{
+    Sr__Msg *msg = NULL;
+    Sr__EventNotifReq *req = NULL;
+    uint8_t *msg_buf = NULL;
+    size_t msg_size = 0;
+    uint32_t session_id = 0;
+    int fd = -1, listen_fd[CM_TEST_SUBSCRIBER_CNT] = { 0, }, sub_fd[CM_TEST_SUBSCRIBER_CNT] = { 0, };
+    char socket_path[CM_TEST_SUBSCRIBER_CNT][PATH_MAX] = { { 0, }, };
+    /* multi-byte subscription ids */
+    const uint32_t subscription_id = 100000;
+    const time_t timestamp = time(NULL);
+    sr_val_t values[4];
+
+    memset(&values, 0, sizeof(values));
+    values[0].xpath = "/test-module:link-discovered/source/address";
+    values[0].type = SR_STRING_T;
+    values[0].data.string_val = "10.10.1.5";
+    values[1].xpath = "/test-module:link-discovered/source/interface";
+    values[1].type = SR_STRING_T;
+    values[1].data.string_val = "eth1";
+    values[2].xpath = "/test-module:link-discovered/destination/address";
+    values[2].type = SR_STRING_T;
+    values[2].data.string_val = "10.10.1.8";
+    values[3].xpath = "/test-module:link-discovered/destination/interface";
+    values[3].type = SR_STRING_T;
+    values[3].data.string_val = "eth0";
+
+    fd = cm_connect_to_server();
+
+    /* start a session */
+    cm_session_start_generate(NULL, &msg_buf, &msg_size);
+    cm_message_send(fd, msg_buf, msg_size);
+    free(msg_buf);
+    msg = cm_message_recv(fd);
+    assert_non_null(msg);
+    assert_non_null(msg->response);
+    assert_int_equal(msg->response->result, SR_ERR_OK);
+    session_id = msg->response->session_start_resp->session_id;
+    sr__msg__free_unpacked(msg, NULL);
+
+    /* subscribe */
+    for (size_t i = 0; i < CM_TEST_SUBSCRIBER_CNT; i++) {
+        snprintf(socket_path[i], PATH_MAX, "/tmp/sysrepo-test-subscriber-%zu.sock", i);
+        listen_fd[i] = cm_subscriber_listen(socket_path[i]);
+
+        cm_event_notif_subscribe_generate(session_id, true, socket_path[i], subscription_id + i, &msg_buf, &msg_size);
+        cm_message_send(fd, msg_buf, msg_size);
+        free(msg_buf);
+        msg = cm_message_recv(fd);
+        assert_non_null(msg);
+        assert_non_null(msg->response);
+        assert_int_equal(msg->response->operation, SR__OPERATION__SUBSCRIBE);
+        assert_int_equal(msg->response->result, SR_ERR_OK);
+        sr__msg__free_unpacked(msg, NULL);
+
+        /* initial hello notification */
+        sub_fd[i] = accept(listen_fd[i], NULL, NULL);
+        assert_int_not_equal(sub_fd[i], -1);
+        msg = cm_message_recv(sub_fd[i]);
+        assert_non_null(msg);
+        assert_int_equal(msg->type, SR__MSG__MSG_TYPE__NOTIFICATION);
+        sr__msg__free_unpacked(msg, NULL);
+    }
+
+    /* send the event notification */
+    cm_event_notif_generate(session_id, values, 4, timestamp, &msg_buf, &msg_size);
+    cm_message_send(fd, msg_buf, msg_size);
+    free(msg_buf);
+    msg = cm_message_recv(fd);
+    assert_non_null(msg);
+    assert_non_null(msg->response);
+    assert_int_equal(msg->response->operation, SR__OPERATION__EVENT_NOTIF);
+    assert_int_equal(msg->response->result, SR_ERR_OK);
+    sr__msg__free_unpacked(msg, NULL);
+
+    /* every subscriber receives the same content with its own details */
+    for (size_t i = 0; i < CM_TEST_SUBSCRIBER_CNT; i++) {
+        msg = cm_message_recv(sub_fd[i]);
+        assert_non_null(msg);
+        assert_int_equal(msg->type, SR__MSG__MSG_TYPE__REQUEST);
+        assert_int_equal(msg->session_id, session_id);
+        assert_false(msg->has_request_id);
+        assert_non_null(msg->request);
+        assert_int_equal(msg->request->operation, SR__OPERATION__EVENT_NOTIF);
+        req = msg->request->event_notif_req;
+        assert_non_null(req);
+        assert_string_equal(req->subscriber_address, socket_path[i]);
+        assert_true(req->has_subscription_id);
+        assert_int_equal(req->subscription_id, subscription_id + i);
+        assert_int_equal(req->type, SR__EVENT_NOTIF_REQ__NOTIF_TYPE__REALTIME);
+        assert_string_equal(req->xpath, "/test-module:link-discovered");
+        assert_true(req->timestamp == (uint64_t)timestamp);
+        assert_int_equal(req->n_trees, 0);
+        assert_int_equal(req->n_values, 4);
+        for (size_t j = 0; j < 4; j++) {
+            assert_string_equal(req->values[j]->xpath, values[j].xpath);
+            assert_string_equal(req->values[j]->string_val, values[j].data.string_val);
+        }
+        sr__msg__free_unpacked(msg, NULL);
+    }
+
+    /* unsubscribe */
+    for (size_t i = 0; i < CM_TEST_SUBSCRIBER_CNT; i++) {
+        cm_event_notif_subscribe_generate(session_id, false, socket_path[i], subscription_id + i, &msg_buf, &msg_size);
+        cm_message_send(fd, msg_buf, msg_size);
+        free(msg_buf);
+        msg = cm_message_recv(fd);
+        assert_non_null(msg);
+        assert_non_null(msg->response);
+        assert_int_equal(msg->response->operation, SR__OPERATION__UNSUBSCRIBE);
+        assert_int_equal(msg->response->result, SR_ERR_OK);
+        sr__msg__free_unpacked(msg, NULL);
+
+        close(sub_fd[i]);
+        close(listen_fd[i]);
+        unlink(socket_path[i]);
+    }
+
+    /* stop the session */
+    cm_session_stop_generate(session_id, &msg_buf, &msg_size);
+    cm_message_send(fd, msg_buf, msg_size);
+    free(msg_buf);
+    msg = cm_message_recv(fd);
+    assert_non_null(msg);
+    assert_non_null(msg->response);
+    assert_int_equal(msg->response->result, SR_ERR_OK);
+    sr__msg__free_unpacked(msg, NULL);
+
+    close(fd);
+}
+
 static void
 cm_test_signal_callback(cm_ctx_t *cm_ctx, int signum)
 {
@@ -538,6 +952,9 @@ main() {
             cmocka_unit_test_setup_teardown(cm_session_test, cm_setup, cm_teardown),
             cmocka_unit_test_setup_teardown(cm_session_neg_test, cm_setup, NULL),
             cmocka_unit_test_setup_teardown(cm_buffers_test, cm_setup, cm_teardown),
+            cmocka_unit_test_setup_teardown(cm_shm_transport_test, cm_setup, cm_teardown),
+            cmocka_unit_test_setup_teardown(cm_shm_transport_neg_test, cm_setup, cm_teardown),
+            cmocka_unit_test_setup_teardown(cm_event_notif_delivery_test, cm_setup, cm_teardown),
             cmocka_unit_test_setup_teardown(cm_signals_test, cm_setup, cm_teardown),
     };
 
@@ -21,12 +21,14 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <setjmp.h>
 #include <cmocka.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <sched.h>
 #include <pwd.h>
 #include <sys/stat.h>
 
@@ -450,6 +452,189 @@ circular_buffer_test3(void **state)
     sr_cbuff_cleanup(buffer);
 }
 
+/*
+ * Tests lock-free MPMC queue - single thread.
+ */
+static void
+mpmc_queue_test1(void **state)
+{
+    sr_mpmc_queue_t *queue = NULL;
+    int rc = 0, i = 0;
+    int tmp = 0;
+
+    rc = sr_mpmc_queue_init(5, sizeof(int), &queue);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* capacity is rounded up to 8 */
+    for (i = 1; i <= 8; i++) {
+        assert_true(sr_mpmc_queue_enqueue(queue, &i));
+    }
+    assert_false(sr_mpmc_queue_enqueue(queue, &i));
+    assert_int_equal(sr_mpmc_queue_items_in_queue(queue), 8);
+
+    /* wrap around several times */
+    for (i = 9; i <= 50; i++) {
+        assert_true(sr_mpmc_queue_dequeue(queue, &tmp));
+        assert_int_equal(tmp, i - 8);
+        assert_true(sr_mpmc_queue_enqueue(queue, &i));
+    }
+
+    for (i = 43; i <= 50; i++) {
+        assert_true(sr_mpmc_queue_dequeue(queue, &tmp));
+        assert_int_equal(tmp, i);
+    }
+
+    /* queue should be empty now */
+    assert_false(sr_mpmc_queue_dequeue(queue, &tmp));
+    assert_int_equal(sr_mpmc_queue_items_in_queue(queue), 0);
+
+    sr_mpmc_queue_cleanup(queue);
+}
+
+#define MPMC_TEST_THREADS 4       /**< Number of producer and consumer threads used in mpmc_queue_test2. */
+#define MPMC_TEST_ITEMS   100000  /**< Number of items enqueued by each producer in mpmc_queue_test2. */
+
+static sr_mpmc_queue_t *mpmc_test_queue = NULL;
+static uint64_t mpmc_test_sum = 0;
+
+static void *
+mpmc_queue_producer(void *arg)
+{
+    for (uint64_t i = 1; i <= MPMC_TEST_ITEMS; i++) {
+        while (!sr_mpmc_queue_enqueue(mpmc_test_queue, &i)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *
+mpmc_queue_consumer(void *arg)
+{
+    uint64_t item = 0, sum = 0;
+
+    for (size_t i = 0; i < MPMC_TEST_ITEMS; i++) {
+        while (!sr_mpmc_queue_dequeue(mpmc_test_queue, &item)) {
+            sched_yield();
+        }
+        sum += item;
+    }
+    __atomic_add_fetch(&mpmc_test_sum, sum, __ATOMIC_SEQ_CST);
+    return NULL;
+}
+
+/*
+ * Tests lock-free MPMC queue - multiple producers and consumers.
+ */
+static void
+mpmc_queue_test2(void **state)
+{
+    pthread_t producers[MPMC_TEST_THREADS], consumers[MPMC_TEST_THREADS];
+    int rc = 0;
+
+    rc = sr_mpmc_queue_init(64, sizeof(uint64_t), &mpmc_test_queue);
+    assert_int_equal(rc, SR_ERR_OK);
+    mpmc_test_sum = 0;
+
+    for (size_t i = 0; i < MPMC_TEST_THREADS; i++) {
+        assert_int_equal(0, pthread_create(&producers[i], NULL, mpmc_queue_producer, NULL));
+        assert_int_equal(0, pthread_create(&consumers[i], NULL, mpmc_queue_consumer, NULL));
+    }
+    for (size_t i = 0; i < MPMC_TEST_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+
+    /* each item has been dequeued exactly once */
+    assert_true(mpmc_test_sum == (uint64_t)MPMC_TEST_THREADS * MPMC_TEST_ITEMS * (MPMC_TEST_ITEMS + 1) / 2);
+    assert_int_equal(sr_mpmc_queue_items_in_queue(mpmc_test_queue), 0);
+
+    sr_mpmc_queue_cleanup(mpmc_test_queue);
+    mpmc_test_queue = NULL;
+}
+
+/*
+ * Tests shared-memory channel.
+ */
+static void
+shm_channel_test(void **state)
+{
+    sr_shm_channel_t *creator = NULL, *peer = NULL;
+    uint8_t *data = NULL;
+    const uint8_t *msg = NULL;
+    size_t size = 0;
+    int fd = -1, rc = SR_ERR_OK;
+
+    rc = sr_shm_channel_create(256, &fd, &creator);
+    if (SR_ERR_UNSUPPORTED == rc) {
+        return;
+    }
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* the peer cannot resize the segment */
+    assert_int_not_equal(0, ftruncate(fd, 128));
+
+    rc = sr_shm_channel_attach(fd, &peer);
+    assert_int_equal(rc, SR_ERR_OK);
+    close(fd);
+
+    /* empty rings */
+    assert_int_equal(SR_ERR_NOT_FOUND, sr_shm_channel_peek(peer, &msg, &size));
+    assert_int_equal(SR_ERR_NOT_FOUND, sr_shm_channel_peek(creator, &msg, &size));
+
+    /* message larger than the ring */
+    assert_false(sr_shm_channel_reserve(creator, 256, &data));
+
+    /* two messages of 100 bytes fit into the ring, the third one does not */
+    for (int i = 0; i < 2; i++) {
+        assert_true(sr_shm_channel_reserve(creator, 100, &data));
+        memset(data, 'a' + i, 100);
+        sr_shm_channel_commit(creator);
+    }
+    assert_false(sr_shm_channel_reserve(creator, 100, &data));
+
+    /* a reserved, but not committed message is not visible */
+    assert_true(sr_shm_channel_reserve(creator, 8, &data));
+
+    for (int i = 0; i < 2; i++) {
+        rc = sr_shm_channel_peek(peer, &msg, &size);
+        assert_int_equal(rc, SR_ERR_OK);
+        assert_int_equal(size, 100);
+        assert_int_equal(msg[0], 'a' + i);
+        assert_int_equal(msg[99], 'a' + i);
+        sr_shm_channel_consume(peer);
+    }
+    assert_int_equal(SR_ERR_NOT_FOUND, sr_shm_channel_peek(peer, &msg, &size));
+
+    /* wrap around several times */
+    for (int i = 0; i < 20; i++) {
+        assert_true(sr_shm_channel_reserve(creator, 60 + i, &data));
+        memset(data, 'a' + i, 60 + i);
+        sr_shm_channel_commit(creator);
+
+        rc = sr_shm_channel_peek(peer, &msg, &size);
+        assert_int_equal(rc, SR_ERR_OK);
+        assert_int_equal(size, 60 + i);
+        assert_int_equal(msg[0], 'a' + i);
+        assert_int_equal(msg[size - 1], 'a' + i);
+        sr_shm_channel_consume(peer);
+    }
+
+    /* the other direction */
+    assert_true(sr_shm_channel_reserve(peer, 5, &data));
+    memcpy(data, "hello", 5);
+    sr_shm_channel_commit(peer);
+    assert_int_equal(SR_ERR_NOT_FOUND, sr_shm_channel_peek(peer, &msg, &size));
+    rc = sr_shm_channel_peek(creator, &msg, &size);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(size, 5);
+    assert_memory_equal(msg, "hello", 5);
+    sr_shm_channel_consume(creator);
+
+    sr_shm_channel_cleanup(peer);
+    sr_shm_channel_cleanup(creator);
+}
+
 /*
  * Tests sysrepo bitset DS.
  */
@@ -1530,6 +1715,278 @@ sr_dup_data_tree_to_ctx_test(void **state)
     ly_ctx_destroy(ctx_B, NULL);
 }
 
+static void
+sr_lyd_binary_format_test(void **state)
+{
+    int rc = SR_ERR_OK;
+    int fd = -1;
+    char filename[] = "/tmp/sr_binary_data_XXXXXX";
+    struct ly_ctx *ctx = ly_ctx_new(TEST_SCHEMA_SEARCH_DIR);
+    struct lyd_node *data_tree = NULL, *loaded_tree = NULL;
+    struct ly_set *set = NULL;
+    char *orig_xml = NULL, *loaded_xml = NULL;
+
+    ly_ctx_load_module(ctx, "test-module", NULL);
+
+    data_tree = lyd_new_path(NULL, ctx, "/test-module:list[key='a']", NULL, 0, 0);
+    assert_non_null(data_tree);
+    lyd_new_path(data_tree, ctx, "/test-module:list[key='b']", NULL, 0, 0);
+    lyd_new_path(data_tree, ctx, "/test-module:main/string", "binary data", 0, 0);
+    lyd_new_path(data_tree, ctx, "/test-module:main/ui8", "8", 0, 0);
+
+    fd = mkstemp(filename);
+    assert_int_not_equal(-1, fd);
+
+    /* empty file is an empty data tree */
+    rc = sr_lyd_parse_data_fd(ctx, fd, LYD_OPT_TRUSTED | LYD_OPT_CONFIG, &loaded_tree);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_null(loaded_tree);
+
+    /* binary round-trip */
+    rc = sr_lyd_print_data_fd(fd, data_tree, true);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = sr_lyd_parse_data_fd(ctx, fd, LYD_OPT_TRUSTED | LYD_OPT_CONFIG, &loaded_tree);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_non_null(loaded_tree);
+
+    lyd_print_mem(&orig_xml, data_tree, LYD_XML, LYP_WITHSIBLINGS);
+    lyd_print_mem(&loaded_xml, loaded_tree, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(orig_xml, loaded_xml);
+    free(loaded_xml);
+    loaded_xml = NULL;
+
+    /* default nodes are not stored, but they are recreated the same way as for XML */
+    set = lyd_find_xpath(loaded_tree, "/test-module:top-level-default");
+    assert_non_null(set);
+    assert_int_equal(1, set->number);
+    assert_true(set->set.d[0]->dflt);
+    ly_set_free(set);
+    set = NULL;
+    lyd_free_withsiblings(loaded_tree);
+    loaded_tree = NULL;
+
+    /* XML file is still recognized */
+    assert_int_equal(0, ftruncate(fd, 0));
+    assert_int_equal(0, lseek(fd, 0, SEEK_SET));
+    rc = sr_lyd_print_data_fd(fd, data_tree, false);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(0, lseek(fd, 0, SEEK_SET));
+    rc = sr_lyd_parse_data_fd(ctx, fd, LYD_OPT_TRUSTED | LYD_OPT_CONFIG, &loaded_tree);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_non_null(loaded_tree);
+
+    lyd_print_mem(&loaded_xml, loaded_tree, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(orig_xml, loaded_xml);
+
+    set = lyd_find_xpath(loaded_tree, "/test-module:top-level-default");
+    assert_non_null(set);
+    assert_int_equal(1, set->number);
+    assert_true(set->set.d[0]->dflt);
+    ly_set_free(set);
+
+    free(orig_xml);
+    free(loaded_xml);
+    lyd_free_withsiblings(loaded_tree);
+    lyd_free_withsiblings(data_tree);
+    close(fd);
+    unlink(filename);
+    ly_ctx_destroy(ctx, NULL);
+}
+
+static void
+sr_gpb_msg_peek_request_id_test(void **state)
+{
+    int rc = SR_ERR_OK;
+    Sr__Msg *msg = NULL;
+    uint8_t *buff = NULL;
+    size_t size = 0;
+    uint64_t request_id = 0;
+    bool has_request_id = false;
+
+    rc = sr_gpb_resp_alloc(NULL, SR__OPERATION__GET_ITEM, 123, &msg);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* no request ID */
+    size = sr__msg__get_packed_size(msg);
+    buff = calloc(1, size);
+    assert_non_null(buff);
+    sr__msg__pack(msg, buff);
+    rc = sr_gpb_msg_peek_request_id(buff, size, &has_request_id, &request_id);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_false(has_request_id);
+    free(buff);
+
+    /* multi-byte request ID after a nested message */
+    msg->has_request_id = true;
+    msg->request_id = 0x123456789ULL;
+    size = sr__msg__get_packed_size(msg);
+    buff = calloc(1, size);
+    assert_non_null(buff);
+    sr__msg__pack(msg, buff);
+    rc = sr_gpb_msg_peek_request_id(buff, size, &has_request_id, &request_id);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_true(has_request_id);
+    assert_true(0x123456789ULL == request_id);
+
+    /* truncated message */
+    rc = sr_gpb_msg_peek_request_id(buff, size - 1, &has_request_id, &request_id);
+    assert_int_equal(SR_ERR_MALFORMED_MSG, rc);
+    free(buff);
+
+    sr_msg_free(msg);
+}
+
+/**
+ * @brief Packs the event notification request with the content attached as a shared payload and checks
+ * that the result decodes to the same message as the complete request packed by protobuf-c.
+ */
+static void
+sr_gpb_event_notif_payload_check(Sr__Msg *full, sr_packed_payload_t *payload)
+{
+    Sr__EventNotifReq *full_req = full->request->event_notif_req;
+    Sr__Msg *msg = NULL, *unpacked = NULL;
+    uint8_t *buff = NULL, *expected = NULL, *repacked = NULL;
+    size_t size = 0, expected_size = 0;
+    uint64_t request_id = 0;
+    bool has_request_id = false;
+    int rc = SR_ERR_OK;
+
+    /* the request of one subscriber carries only the subscriber details */
+    rc = sr_gpb_req_alloc(NULL, SR__OPERATION__EVENT_NOTIF, full->session_id, &msg);
+    assert_int_equal(SR_ERR_OK, rc);
+    msg->has_request_id = full->has_request_id;
+    msg->request_id = full->request_id;
+    if (NULL != full_req->subscriber_address) {
+        msg->request->event_notif_req->subscriber_address = strdup(full_req->subscriber_address);
+        assert_non_null(msg->request->event_notif_req->subscriber_address);
+    }
+    msg->request->event_notif_req->has_subscription_id = full_req->has_subscription_id;
+    msg->request->event_notif_req->subscription_id = full_req->subscription_id;
+    rc = sr_gpb_msg_attach_payload(msg, payload);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    expected_size = sr__msg__get_packed_size(full);
+    expected = calloc(1, expected_size);
+    assert_non_null(expected);
+    sr__msg__pack(full, expected);
+
+    size = sr_gpb_msg_get_packed_size(msg);
+    assert_int_equal(expected_size, size);
+    buff = calloc(1, size);
+    assert_non_null(buff);
+    assert_int_equal(size, sr_gpb_msg_pack(msg, buff));
+
+    rc = sr_gpb_msg_peek_request_id(buff, size, &has_request_id, &request_id);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(full->has_request_id, has_request_id);
+    assert_true(full->request_id == request_id);
+
+    /* fields are spliced in a different order, repacking the decoded message must give the same bytes */
+    unpacked = sr__msg__unpack(NULL, size, buff);
+    assert_non_null(unpacked);
+    assert_int_equal(expected_size, sr__msg__get_packed_size(unpacked));
+    repacked = calloc(1, expected_size);
+    assert_non_null(repacked);
+    sr__msg__pack(unpacked, repacked);
+    assert_memory_equal(expected, repacked, expected_size);
+
+    if (NULL != full_req->subscriber_address) {
+        assert_string_equal(full_req->subscriber_address, unpacked->request->event_notif_req->subscriber_address);
+    } else {
+        assert_null(unpacked->request->event_notif_req->subscriber_address);
+    }
+    assert_int_equal(full_req->has_subscription_id, unpacked->request->event_notif_req->has_subscription_id);
+    assert_int_equal(full_req->subscription_id, unpacked->request->event_notif_req->subscription_id);
+
+    sr__msg__free_unpacked(unpacked, NULL);
+    free(repacked);
+    free(buff);
+    free(expected);
+    sr_msg_free(msg);
+}
+
+static void
+sr_gpb_event_notif_payload_test(void **state)
+{
+    int rc = SR_ERR_OK;
+    Sr__Msg *full = NULL;
+    Sr__EventNotifReq *req = NULL;
+    sr_packed_payload_t *payload = NULL;
+    sr_val_t *values = NULL;
+    char xpath[PATH_MAX] = { 0, }, address[PATH_MAX] = { 0, };
+    const size_t values_cnt = 1000;
+
+    /* content large enough for multi-byte lengths of the nested messages, values without memory context,
+     * so that the GPB values are allocated the same way as the rest of the message */
+    values = calloc(values_cnt, sizeof(*values));
+    assert_non_null(values);
+    for (size_t i = 0; i < values_cnt; i++) {
+        snprintf(xpath, PATH_MAX, "/test-module:link-discovered/value[index='%zu']", i);
+        values[i].xpath = strdup(xpath);
+        assert_non_null(values[i].xpath);
+        values[i].type = SR_UINT32_T;
+        values[i].data.uint32_val = i;
+    }
+
+    rc = sr_gpb_req_alloc(NULL, SR__OPERATION__EVENT_NOTIF, 300, &full);
+    assert_int_equal(SR_ERR_OK, rc);
+    req = full->request->event_notif_req;
+    req->type = SR__EVENT_NOTIF_REQ__NOTIF_TYPE__REALTIME;
+    req->xpath = strdup("/test-module:link-discovered");
+    assert_non_null(req->xpath);
+    req->timestamp = 1500000000;
+    rc = sr_values_sr_to_gpb(values, values_cnt, &req->values, &req->n_values);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    rc = sr_gpb_event_notif_payload_pack(req, &payload);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* multiple subscribers share one payload, with and without the optional details */
+    for (size_t i = 0; i < 3; i++) {
+        free(req->subscriber_address);
+        req->subscriber_address = NULL;
+        req->has_subscription_id = false;
+        req->subscription_id = 0;
+        full->has_request_id = false;
+        full->request_id = 0;
+        if (i > 0) {
+            /* address longer than 127 bytes, subscription id and request id with multi-byte varints */
+            memset(address, 'a' + i, 200);
+            address[200] = '\0';
+            req->subscriber_address = strdup(address);
+            assert_non_null(req->subscriber_address);
+            req->has_subscription_id = true;
+            req->subscription_id = 100000 * i;
+            full->has_request_id = true;
+            full->request_id = 0x123456789ULL * i;
+        }
+        sr_gpb_event_notif_payload_check(full, payload);
+    }
+    assert_int_equal(1, payload->ref_count);
+    sr_packed_payload_release(payload);
+    payload = NULL;
+    sr_msg_free(full);
+    sr_free_values(values, values_cnt);
+
+    /* notification without any values */
+    rc = sr_gpb_req_alloc(NULL, SR__OPERATION__EVENT_NOTIF, 0, &full);
+    assert_int_equal(SR_ERR_OK, rc);
+    req = full->request->event_notif_req;
+    req->type = SR__EVENT_NOTIF_REQ__NOTIF_TYPE__REPLAY_COMPLETE;
+    req->xpath = strdup("");
+    assert_non_null(req->xpath);
+    req->subscriber_address = strdup("/tmp/subscriber.sock");
+    assert_non_null(req->subscriber_address);
+    req->has_subscription_id = true;
+    req->subscription_id = 0;
+
+    rc = sr_gpb_event_notif_payload_pack(req, &payload);
+    assert_int_equal(SR_ERR_OK, rc);
+    sr_gpb_event_notif_payload_check(full, payload);
+    sr_packed_payload_release(payload);
+    sr_msg_free(full);
+}
+
 int
 main() {
     const struct CMUnitTest tests[] = {
@@ -1539,6 +1996,9 @@ main() {
             cmocka_unit_test_setup_teardown(circular_buffer_test1, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(circular_buffer_test2, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(circular_buffer_test3, logging_setup, logging_cleanup),
+            cmocka_unit_test_setup_teardown(mpmc_queue_test1, logging_setup, logging_cleanup),
+            cmocka_unit_test_setup_teardown(mpmc_queue_test2, logging_setup, logging_cleanup),
+            cmocka_unit_test_setup_teardown(shm_channel_test, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(sr_bitset_test, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(logger_callback_test, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(sr_locking_set_test, logging_setup, logging_cleanup),
@@ -1553,6 +2013,9 @@ main() {
             cmocka_unit_test_setup_teardown(sr_get_system_groups_test, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(sr_free_list_of_strings_test, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(sr_dup_data_tree_to_ctx_test, logging_setup, logging_cleanup),
+            cmocka_unit_test_setup_teardown(sr_lyd_binary_format_test, logging_setup, logging_cleanup),
+            cmocka_unit_test_setup_teardown(sr_gpb_msg_peek_request_id_test, logging_setup, logging_cleanup),
+            cmocka_unit_test_setup_teardown(sr_gpb_event_notif_payload_test, logging_setup, logging_cleanup),
     };
 
     watchdog_start(300);
@@ -25,6 +25,10 @@
 #include <cmocka.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include "data_manager.h"
 #include "test_data.h"
 #include "sr_common.h"
@@ -32,6 +36,9 @@
 #include "rp_dt_lookup.h"
 #include "rp_dt_xpath.h"
 #include "system_helper.h"
+#include "dm_journal.h"
+#include "rp_dt_edit.h"
+#include "rp_dt_context_helper.h"
 
 int setup(void **state)
 {
@@ -110,6 +117,328 @@ void dm_get_data_tree(void **state)
 
 }
 
+void
+dm_shared_data_tree_test(void **state)
+{
+    int rc;
+    dm_ctx_t *ctx;
+    dm_session_t *ses_a = NULL, *ses_b = NULL, *ses_c = NULL;
+    dm_data_info_t *info_a = NULL, *info_b = NULL, *info_c = NULL;
+
+    rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* only data files older than the mtime threshold are cached */
+    usleep(20000);
+
+    dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_a);
+    dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_b);
+
+    rc = dm_get_data_info_rdonly(ctx, ses_a, "example-module", &info_a);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_get_data_info_rdonly(ctx, ses_b, "example-module", &info_b);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* both sessions read the same snapshot */
+    assert_non_null(info_a->node);
+    assert_true(info_a->shared);
+    assert_ptr_equal(info_a->node, info_b->node);
+
+    /* editable data tree is a private copy */
+    rc = dm_get_data_info(ctx, ses_b, "example-module", &info_b);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_false(info_b->shared);
+    assert_ptr_not_equal(info_a->node, info_b->node);
+
+    /* snapshot outlives the session that created it */
+    dm_session_stop(ctx, ses_a);
+    dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_c);
+    rc = dm_get_data_info_rdonly(ctx, ses_c, "example-module", &info_c);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_true(info_c->shared);
+
+    dm_session_stop(ctx, ses_b);
+    dm_session_stop(ctx, ses_c);
+    dm_cleanup(ctx);
+}
+
+/**
+ * @brief Returns the value of the leaf identified by the xpath, NULL if it does not exist.
+ */
+static const char *
+dm_test_leaf_value(struct lyd_node *root, const char *xpath)
+{
+    struct ly_set *set = NULL;
+    const char *value = NULL;
+
+    if (NULL == root) {
+        return NULL;
+    }
+    set = lyd_find_xpath(root, xpath);
+    assert_non_null(set);
+    if (1 == set->number) {
+        value = ((struct lyd_node_leaf_list *) set->set.d[0])->value_str;
+    }
+    ly_set_free(set);
+    return value;
+}
+
+/**
+ * @brief Appends the changes between the two data trees to the journal.
+ */
+static void
+dm_test_journal_append_diff(dm_journal_t *journal, const struct lys_module *module, struct lyd_node *prev,
+        struct lyd_node *data, uint64_t exp_seq)
+{
+    dm_journal_batch_t *batch = NULL;
+    struct lyd_difflist *diff = NULL;
+    uint64_t seq = 0;
+
+    diff = lyd_diff(prev, data, 0);
+    assert_non_null(diff);
+    assert_int_equal(SR_ERR_OK, dm_journal_batch_new(&batch));
+    assert_int_equal(SR_ERR_OK, dm_journal_batch_add_diff(batch, module, diff));
+    assert_int_equal(1, dm_journal_batch_count(batch));
+    lyd_free_diff(diff);
+    assert_int_equal(SR_ERR_OK, dm_journal_append(journal, batch, &seq));
+    assert_int_equal(exp_seq, seq);
+    dm_journal_batch_free(batch);
+}
+
+/**
+ * @brief Loads the content of the module from the image and the records of the journal.
+ */
+static struct lyd_node *
+dm_test_journal_load(dm_journal_t *journal, struct ly_ctx *ly_ctx, uint64_t exp_seq)
+{
+    struct lyd_node *root = NULL;
+    char *image = NULL;
+    uint64_t seq = 0;
+
+    assert_int_equal(SR_ERR_OK, dm_journal_get_image(journal, &image));
+    if (NULL != image) {
+        root = lyd_parse_mem(ly_ctx, image, LYD_XML, LYD_OPT_TRUSTED | LYD_OPT_CONFIG);
+        free(image);
+    }
+    assert_int_equal(SR_ERR_OK, dm_journal_replay(journal, ly_ctx, &root, &seq));
+    assert_int_equal(exp_seq, seq);
+    return root;
+}
+
+void
+dm_journal_test(void **state)
+{
+    int rc;
+    dm_ctx_t *ctx = NULL;
+    dm_schema_info_t *si = NULL;
+    dm_journal_t *journal = NULL;
+    dm_journal_batch_t *batch = NULL;
+    struct lyd_node *prev = NULL, *data = NULL, *replayed = NULL;
+    struct ly_set *set = NULL;
+    struct stat st = {0};
+    char dir[] = "/tmp/sr_journal_XXXXXX", dir_path[PATH_MAX] = {0}, journal_file[PATH_MAX] = {0};
+    const uint32_t partial_frame[2] = {64, 0};
+    char last_byte = 0;
+    uint64_t seq = 0;
+    int fd = -1;
+
+    rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_get_module_and_lock(ctx, "example-module", &si);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    assert_non_null(mkdtemp(dir));
+    snprintf(dir_path, PATH_MAX, "%s/", dir);
+    snprintf(journal_file, PATH_MAX, "%s/example-module%s%s", dir, SR_RUNNING_FILE_EXT, SR_JOURNAL_FILE_EXT);
+    rc = dm_journal_init(dir_path, "example-module", SR_DS_RUNNING, &journal);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(0, dm_journal_size(journal));
+
+    /* the journal is created by the first append */
+    test_file_exists(journal_file, false);
+    data = lyd_new_path(NULL, si->ly_ctx, "/example-module:container/list[key1='a'][key2='b']/leaf", "x", 0, 0);
+    assert_non_null(data);
+    dm_test_journal_append_diff(journal, si->module, NULL, data, 1);
+    test_file_exists(journal_file, true);
+
+    /* second commit changes the leaf and adds another entry */
+    prev = sr_dup_datatree(data);
+    assert_non_null(lyd_new_path(data, si->ly_ctx, "/example-module:container/list[key1='a'][key2='b']/leaf", "y", 0, LYD_PATH_OPT_UPDATE));
+    assert_non_null(lyd_new_path(data, si->ly_ctx, "/example-module:container/list[key1='c'][key2='d']/leaf", "z", 0, 0));
+    dm_test_journal_append_diff(journal, si->module, prev, data, 2);
+    lyd_free_withsiblings(prev);
+    lyd_free_withsiblings(data);
+    assert_true(dm_journal_size(journal) > 0);
+
+    /* replay on an empty data file reconstructs the data */
+    replayed = dm_test_journal_load(journal, si->ly_ctx, 2);
+    assert_non_null(replayed);
+    set = lyd_find_xpath(replayed, "/example-module:container/list");
+    assert_non_null(set);
+    assert_int_equal(2, set->number);
+    ly_set_free(set);
+    assert_string_equal("y", dm_test_leaf_value(replayed, "/example-module:container/list[key1='a'][key2='b']/leaf"));
+    lyd_free_withsiblings(replayed);
+
+    /* image supersedes the data file and the preceding records */
+    data = lyd_new_path(NULL, si->ly_ctx, "/example-module:container/list[key1='e'][key2='f']/leaf", "image", 0, 0);
+    assert_non_null(data);
+    assert_int_equal(SR_ERR_OK, dm_journal_batch_new(&batch));
+    assert_int_equal(SR_ERR_OK, dm_journal_batch_add_image(batch, data));
+    assert_int_equal(SR_ERR_OK, dm_journal_append(journal, batch, &seq));
+    assert_int_equal(3, seq);
+    dm_journal_batch_free(batch);
+    prev = sr_dup_datatree(data);
+    assert_non_null(lyd_new_path(data, si->ly_ctx, "/example-module:container/list[key1='g'][key2='h']/leaf", "after", 0, 0));
+    dm_test_journal_append_diff(journal, si->module, prev, data, 4);
+    lyd_free_withsiblings(prev);
+
+    replayed = dm_test_journal_load(journal, si->ly_ctx, 4);
+    assert_null(dm_test_leaf_value(replayed, "/example-module:container/list[key1='a'][key2='b']/leaf"));
+    assert_string_equal("image", dm_test_leaf_value(replayed, "/example-module:container/list[key1='e'][key2='f']/leaf"));
+    assert_string_equal("after", dm_test_leaf_value(replayed, "/example-module:container/list[key1='g'][key2='h']/leaf"));
+    lyd_free_withsiblings(replayed);
+
+    /* record truncated by a crash is ignored and dropped by the next append */
+    fd = open(journal_file, O_WRONLY | O_APPEND);
+    assert_int_not_equal(-1, fd);
+    assert_int_equal(sizeof(partial_frame), write(fd, partial_frame, sizeof(partial_frame)));
+    assert_int_equal(4, write(fd, "part", 4));
+    close(fd);
+    dm_journal_cleanup(journal);
+    rc = dm_journal_init(dir_path, "example-module", SR_DS_RUNNING, &journal);
+    assert_int_equal(SR_ERR_OK, rc);
+    replayed = dm_test_journal_load(journal, si->ly_ctx, 4);
+    assert_string_equal("after", dm_test_leaf_value(replayed, "/example-module:container/list[key1='g'][key2='h']/leaf"));
+    lyd_free_withsiblings(replayed);
+
+    prev = sr_dup_datatree(data);
+    assert_non_null(lyd_new_path(data, si->ly_ctx, "/example-module:container/list[key1='i'][key2='j']/leaf", "last", 0, 0));
+    dm_test_journal_append_diff(journal, si->module, prev, data, 5);
+    lyd_free_withsiblings(prev);
+    replayed = dm_test_journal_load(journal, si->ly_ctx, 5);
+    assert_string_equal("last", dm_test_leaf_value(replayed, "/example-module:container/list[key1='i'][key2='j']/leaf"));
+    lyd_free_withsiblings(replayed);
+
+    /* corrupted final record fails the checksum and is not replayed */
+    assert_int_equal(0, stat(journal_file, &st));
+    fd = open(journal_file, O_RDWR);
+    assert_int_not_equal(-1, fd);
+    assert_int_equal(1, pread(fd, &last_byte, 1, st.st_size - 1));
+    last_byte ^= 0xff;
+    assert_int_equal(1, pwrite(fd, &last_byte, 1, st.st_size - 1));
+    close(fd);
+    dm_journal_cleanup(journal);
+    rc = dm_journal_init(dir_path, "example-module", SR_DS_RUNNING, &journal);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(SR_ERR_OK, dm_journal_get_seq(journal, &seq));
+    assert_int_equal(4, seq);
+    replayed = dm_test_journal_load(journal, si->ly_ctx, 4);
+    assert_null(dm_test_leaf_value(replayed, "/example-module:container/list[key1='i'][key2='j']/leaf"));
+    assert_string_equal("after", dm_test_leaf_value(replayed, "/example-module:container/list[key1='g'][key2='h']/leaf"));
+    lyd_free_withsiblings(replayed);
+
+    /* checkpoint drops all records including the image */
+    assert_int_equal(SR_ERR_OK, dm_journal_lock(journal, true));
+    assert_int_equal(SR_ERR_OK, dm_journal_truncate(journal, &seq));
+    dm_journal_unlock(journal);
+    assert_int_equal(4, seq);
+    assert_int_equal(0, dm_journal_size(journal));
+    replayed = dm_test_journal_load(journal, si->ly_ctx, 4);
+    assert_null(replayed);
+
+    dm_journal_cleanup(journal);
+    unlink(journal_file);
+    rmdir(dir);
+    lyd_free_withsiblings(data);
+    pthread_rwlock_unlock(&si->model_lock);
+    dm_cleanup(ctx);
+}
+
+void
+dm_journal_commit_test(void **state)
+{
+    int rc;
+    rp_ctx_t *ctx = NULL;
+    rp_session_t *session = NULL;
+    dm_ctx_t *dm_ctx = NULL;
+    dm_session_t *dm_session = NULL;
+    dm_journal_t *journal = NULL;
+    struct lyd_node *data_tree = NULL;
+    sr_val_t *value = NULL;
+    sr_error_info_t *errors = NULL;
+    size_t e_cnt = 0;
+    struct stat st = {0};
+    FILE *fp = NULL;
+    const char *xpath = "/example-module:container/list[key1='key1'][key2='key2']/leaf";
+    char persistence_file[PATH_MAX] = {0}, journal_file[PATH_MAX] = {0}, cmd[3 * PATH_MAX] = {0};
+
+    snprintf(persistence_file, PATH_MAX, "%s%s", TEST_DATA_SEARCH_DIR, SR_DATA_PERSISTENCE_FILE);
+    snprintf(journal_file, PATH_MAX, "%s%s", EXAMPLE_MODULE_DATA_FILE_NAME, SR_JOURNAL_FILE_EXT);
+    createDataTreeExampleModule();
+    unlink(journal_file);
+    fp = fopen(persistence_file, "w");
+    assert_non_null(fp);
+    fputs("journal\n", fp);
+    fclose(fp);
+
+    /* commit is appended to the journal of the module, the data file is left untouched */
+    test_rp_ctx_create(CM_MODE_LOCAL, &ctx);
+    test_rp_session_create(ctx, SR_DS_STARTUP, &session);
+    value = calloc(1, sizeof(*value));
+    assert_non_null(value);
+    value->type = SR_STRING_T;
+    value->data.string_val = strdup("journaled");
+    assert_non_null(value->data.string_val);
+    rc = rp_dt_set_item_wrapper(ctx, session, xpath, value, NULL, SR_EDIT_DEFAULT);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = rp_dt_commit(ctx, session, NULL, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(0, stat(journal_file, &st));
+    assert_true(st.st_size > 0);
+    test_file_content(EXAMPLE_MODULE_DATA_FILE_NAME, "!journaled", true);
+
+    /* keep the state preceding the checkpoint to simulate a crash */
+    snprintf(cmd, sizeof(cmd), "cp -p %s %s.bak && cp -p %s %s.bak", EXAMPLE_MODULE_DATA_FILE_NAME,
+            EXAMPLE_MODULE_DATA_FILE_NAME, journal_file, journal_file);
+    exec_shell_command(cmd, ".*", true, 0);
+
+    /* the checkpoint is made on cleanup */
+    test_rp_session_cleanup(ctx, session);
+    test_rp_ctx_cleanup(ctx);
+    assert_int_equal(SR_ERR_OK, dm_journal_init(TEST_DATA_SEARCH_DIR, "example-module", SR_DS_STARTUP, &journal));
+    assert_int_equal(0, dm_journal_size(journal));
+    dm_journal_cleanup(journal);
+    test_file_content(EXAMPLE_MODULE_DATA_FILE_NAME, "journaled", true);
+
+    /* checkpointed data are loaded from the data file */
+    rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &dm_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    dm_session_start(dm_ctx, NULL, SR_DS_STARTUP, &dm_session);
+    assert_int_equal(SR_ERR_OK, dm_get_datatree(dm_ctx, dm_session, "example-module", &data_tree));
+    assert_string_equal("journaled", dm_test_leaf_value(data_tree, xpath));
+    dm_session_stop(dm_ctx, dm_session);
+    dm_cleanup(dm_ctx);
+
+    /* records left after a crash are replayed on load */
+    snprintf(cmd, sizeof(cmd), "mv %s.bak %s && mv %s.bak %s", EXAMPLE_MODULE_DATA_FILE_NAME,
+            EXAMPLE_MODULE_DATA_FILE_NAME, journal_file, journal_file);
+    exec_shell_command(cmd, ".*", true, 0);
+    test_file_content(EXAMPLE_MODULE_DATA_FILE_NAME, "!journaled", true);
+    rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &dm_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    dm_session_start(dm_ctx, NULL, SR_DS_STARTUP, &dm_session);
+    assert_int_equal(SR_ERR_OK, dm_get_datatree(dm_ctx, dm_session, "example-module", &data_tree));
+    assert_string_equal("journaled", dm_test_leaf_value(data_tree, xpath));
+    dm_session_stop(dm_ctx, dm_session);
+    dm_cleanup(dm_ctx);
+    test_file_content(EXAMPLE_MODULE_DATA_FILE_NAME, "journaled", true);
+
+    unlink(persistence_file);
+    unlink(journal_file);
+    createDataTreeExampleModule();
+}
+
 void
 dm_list_schema_test(void **state)
 {
@@ -291,6 +620,405 @@ dm_validate_data_trees_test(void **state)
     dm_cleanup(ctx);
 }
 
+void
+dm_parallel_validation_test(void **state)
+{
+    int rc;
+    dm_ctx_t *ctx = NULL;
+    dm_session_t *ses_ctx = NULL;
+    dm_data_info_t *info = NULL;
+    sr_error_info_t *errors = NULL;
+    size_t err_cnt = 0;
+    const char *modules[] = { "example-module", "small-module", "top-level-mandatory" };
+
+    /* the same result with modules validated by the calling thread and by the work pool */
+    for (int pool = 0; pool < 2; pool++) {
+        if (0 == pool) {
+            setenv(SR_COMMIT_THREAD_COUNT_ENV, "0", 1);
+        }
+        rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx);
+        unsetenv(SR_COMMIT_THREAD_COUNT_ENV);
+        assert_int_equal(SR_ERR_OK, rc);
+
+        rc = dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_ctx);
+        assert_int_equal(SR_ERR_OK, rc);
+
+        for (size_t i = 0; i < sizeof(modules) / sizeof(*modules); i++) {
+            rc = dm_get_data_info(ctx, ses_ctx, modules[i], &info);
+            assert_int_equal(SR_ERR_OK, rc);
+            info->modified = true;
+            info->modified_untracked = true;
+        }
+
+        /* only the module with the missing mandatory node is invalid */
+        rc = dm_validate_session_data_trees(ctx, ses_ctx, &errors, &err_cnt);
+        assert_int_equal(SR_ERR_VALIDATION_FAILED, rc);
+        assert_int_equal(1, err_cnt);
+        sr_free_errors(errors, err_cnt);
+        errors = NULL;
+        err_cnt = 0;
+
+        dm_session_stop(ctx, ses_ctx);
+        dm_cleanup(ctx);
+    }
+}
+
+void
+dm_shared_schema_ctx_test(void **state)
+{
+    int rc;
+    dm_ctx_t *ctx = NULL;
+    dm_session_t *ses_ctx = NULL;
+    dm_schema_info_t *si_a = NULL, *si_b = NULL;
+    dm_data_info_t *info = NULL;
+    sr_error_info_t *errors = NULL;
+    size_t err_cnt = 0;
+
+    setenv(SR_SHARED_SCHEMA_CTX_ENV, "1", 1);
+    rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx);
+    unsetenv(SR_SHARED_SCHEMA_CTX_ENV);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* all installed modules are loaded in one context */
+    rc = dm_get_module_without_lock(ctx, "example-module", &si_a);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_get_module_without_lock(ctx, "test-module", &si_b);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_true(si_a->shared_ly_ctx);
+    assert_true(si_b->shared_ly_ctx);
+    assert_ptr_equal(si_a->ly_ctx, si_b->ly_ctx);
+    assert_ptr_equal(si_a->module, ly_ctx_get_module(si_b->ly_ctx, "example-module", NULL));
+    assert_true(si_b->has_instance_id);
+
+    rc = dm_get_module_without_lock(ctx, "not-existing-module", &si_a);
+    assert_int_equal(SR_ERR_UNKNOWN_MODEL, rc);
+
+    /* data referencing other modules are loaded and validated in the shared context */
+    rc = dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    rc = dm_get_data_info(ctx, ses_ctx, "test-module", &info);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_non_null(info->node);
+    assert_ptr_equal(si_b->ly_ctx, info->node->schema->module->ctx);
+
+    info->modified = true;
+    rc = dm_validate_session_data_trees(ctx, ses_ctx, &errors, &err_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    sr_free_errors(errors, err_cnt);
+    assert_non_null(info->node);
+    assert_ptr_equal(si_b->ly_ctx, info->node->schema->module->ctx);
+
+    dm_session_stop(ctx, ses_ctx);
+    dm_cleanup(ctx);
+}
+
+void
+dm_shared_schema_ctx_modify_test(void **state)
+{
+    int rc;
+    dm_ctx_t *ctx = NULL;
+    dm_session_t *ses_ctx = NULL;
+    dm_schema_info_t *si = NULL, *si_if = NULL;
+    dm_data_info_t *info = NULL;
+    sr_list_t *implicitly = NULL;
+    const struct lys_module *module = NULL;
+
+    setenv(SR_SHARED_SCHEMA_CTX_ENV, "1", 1);
+    rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx);
+    unsetenv(SR_SHARED_SCHEMA_CTX_ENV);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    rc = dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_get_data_info(ctx, ses_ctx, "test-module", &info);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* data of the other modules do not prevent the modification of the shared context */
+    rc = dm_feature_enable(ctx, "ietf-ip", "ipv6-privacy-autoconf", true);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_feature_enable(ctx, "ietf-ip", "ipv6-privacy-autoconf", false);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* the module and the modules it augments can not be modified while they are being used */
+    rc = dm_get_data_info(ctx, ses_ctx, "ietf-interfaces", &info);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_feature_enable(ctx, "ietf-interfaces", "pre-provisioning", true);
+    assert_int_equal(SR_ERR_OPERATION_FAILED, rc);
+    rc = dm_feature_enable(ctx, "ietf-ip", "ipv6-privacy-autoconf", true);
+    assert_int_equal(SR_ERR_OPERATION_FAILED, rc);
+    rc = dm_uninstall_module(ctx, "ietf-ip", NULL, &implicitly);
+    assert_int_equal(SR_ERR_OPERATION_FAILED, rc);
+    rc = dm_get_module_without_lock(ctx, "ietf-ip", &si);
+    assert_int_equal(SR_ERR_OK, rc);
+    dm_session_stop(ctx, ses_ctx);
+    ses_ctx = NULL;
+
+    /* feature toggle */
+    rc = dm_feature_enable(ctx, "ietf-interfaces", "pre-provisioning", true);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_get_module_without_lock(ctx, "ietf-interfaces", &si_if);
+    assert_int_equal(SR_ERR_OK, rc);
+    module = ly_ctx_get_module(si_if->ly_ctx, "ietf-interfaces", NULL);
+    assert_non_null(module);
+    assert_int_equal(1, lys_features_state(module, "pre-provisioning"));
+
+    rc = dm_feature_enable(ctx, "ietf-interfaces", "pre-provisioning", false);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(0, lys_features_state(module, "pre-provisioning"));
+
+    rc = dm_feature_enable(ctx, "ietf-interfaces", "unknown", true);
+    assert_int_not_equal(SR_ERR_OK, rc);
+    rc = dm_feature_enable(ctx, "unknown-module", "unknown", true);
+    assert_int_equal(SR_ERR_UNKNOWN_MODEL, rc);
+
+    /* uninstall, data of the other modules stay loaded */
+    rc = dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_get_data_info(ctx, ses_ctx, "test-module", &info);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_non_null(info->node);
+
+    rc = dm_uninstall_module(ctx, "example-module", NULL, &implicitly);
+    assert_int_equal(SR_ERR_OK, rc);
+    md_free_module_key_list(implicitly);
+    implicitly = NULL;
+
+    rc = dm_get_module_without_lock(ctx, "example-module", &si);
+    assert_int_equal(SR_ERR_UNKNOWN_MODEL, rc);
+    rc = dm_get_module_without_lock(ctx, "ietf-interfaces", &si_if);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_true(si_if->shared_ly_ctx);
+    assert_null(ly_ctx_get_module(si_if->ly_ctx, "example-module", NULL));
+    assert_ptr_equal(si_if->ly_ctx, info->node->schema->module->ctx);
+    assert_ptr_equal(info->schema->module, ly_ctx_get_module(si_if->ly_ctx, "test-module", NULL));
+    dm_session_stop(ctx, ses_ctx);
+    ses_ctx = NULL;
+
+    /* install */
+    rc = dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_install_module(ctx, ses_ctx, "example-module", NULL, TEST_SCHEMA_SEARCH_DIR "example-module.yang", &implicitly);
+    assert_int_equal(SR_ERR_OK, rc);
+    md_free_module_key_list(implicitly);
+    implicitly = NULL;
+
+    rc = dm_get_module_without_lock(ctx, "example-module", &si);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_true(si->shared_ly_ctx);
+    assert_ptr_equal(si_if->ly_ctx, si->ly_ctx);
+    assert_ptr_equal(si->module, ly_ctx_get_module(si->ly_ctx, "example-module", NULL));
+
+    /* data of the reinstalled module are loaded in the shared context */
+    rc = dm_get_data_info(ctx, ses_ctx, "example-module", &info);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_non_null(info->node);
+    assert_ptr_equal(si->ly_ctx, info->node->schema->module->ctx);
+
+    dm_session_stop(ctx, ses_ctx);
+    dm_cleanup(ctx);
+}
+
+static void
+dm_tmp_ly_ctx_pool_test(void **state)
+{
+    int rc;
+    dm_ctx_t *ctx = NULL;
+    dm_tmp_ly_ctx_t *tmp_ctx = NULL, *slots[4] = { NULL, };
+    sr_list_t *sets[5] = { NULL, };
+    const char *modules[5] = { "example-module", "test-module", "small-module", "info-module", "state-module" };
+    const char *marker = "top-level-mandatory";
+
+    rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* each set consists of one module, there is one more set than the pool can hold */
+    for (size_t i = 0; i < 5; i++) {
+        rc = sr_list_init(&sets[i]);
+        assert_int_equal(SR_ERR_OK, rc);
+        rc = sr_list_add(sets[i], (void *) modules[i]);
+        assert_int_equal(SR_ERR_OK, rc);
+    }
+
+    /* an idle context with the same set of modules is reused, a module loaded into it is kept */
+    rc = dm_get_tmp_ly_ctx(ctx, sets[0], &slots[0]);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_non_null(ly_ctx_get_module(slots[0]->ctx, modules[0], NULL));
+    assert_non_null(lys_parse_path(slots[0]->ctx, TEST_SCHEMA_SEARCH_DIR "top-level-mandatory.yang", LYS_IN_YANG));
+    rc = dm_release_tmp_ly_ctx(ctx, slots[0]);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    rc = dm_get_tmp_ly_ctx(ctx, sets[0], &tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_ptr_equal(slots[0], tmp_ctx);
+    assert_non_null(ly_ctx_get_module(tmp_ctx->ctx, marker, NULL));
+
+    /* a context in use is not handed out again */
+    rc = dm_get_tmp_ly_ctx(ctx, sets[1], &slots[1]);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_ptr_not_equal(slots[0], slots[1]);
+    rc = dm_release_tmp_ly_ctx(ctx, slots[1]);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_release_tmp_ly_ctx(ctx, tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* fill the pool */
+    for (size_t i = 2; i < 4; i++) {
+        rc = dm_get_tmp_ly_ctx(ctx, sets[i], &slots[i]);
+        assert_int_equal(SR_ERR_OK, rc);
+        assert_non_null(ly_ctx_get_module(slots[i]->ctx, modules[i], NULL));
+        for (size_t j = 0; j < i; j++) {
+            assert_ptr_not_equal(slots[j], slots[i]);
+        }
+        rc = dm_release_tmp_ly_ctx(ctx, slots[i]);
+        assert_int_equal(SR_ERR_OK, rc);
+    }
+
+    /* the pool is full, the least recently used context is rebuilt with the new set of modules */
+    rc = dm_get_tmp_ly_ctx(ctx, sets[4], &tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_ptr_equal(slots[0], tmp_ctx);
+    assert_non_null(ly_ctx_get_module(tmp_ctx->ctx, modules[4], NULL));
+    assert_null(ly_ctx_get_module(tmp_ctx->ctx, modules[0], NULL));
+    assert_null(ly_ctx_get_module(tmp_ctx->ctx, marker, NULL));
+    rc = dm_release_tmp_ly_ctx(ctx, tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* the other contexts stay in the pool */
+    for (size_t i = 1; i < 4; i++) {
+        rc = dm_get_tmp_ly_ctx(ctx, sets[i], &tmp_ctx);
+        assert_int_equal(SR_ERR_OK, rc);
+        assert_ptr_equal(slots[i], tmp_ctx);
+        rc = dm_release_tmp_ly_ctx(ctx, tmp_ctx);
+        assert_int_equal(SR_ERR_OK, rc);
+    }
+
+    /* the evicted set is rebuilt in place of the now least recently used context */
+    rc = dm_get_tmp_ly_ctx(ctx, sets[0], &tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_ptr_equal(slots[0], tmp_ctx);
+    assert_non_null(ly_ctx_get_module(tmp_ctx->ctx, modules[0], NULL));
+    assert_null(ly_ctx_get_module(tmp_ctx->ctx, modules[4], NULL));
+    rc = dm_release_tmp_ly_ctx(ctx, tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* mark a pooled context, then change the features - pooled contexts are not reused anymore */
+    rc = dm_get_tmp_ly_ctx(ctx, sets[1], &tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_ptr_equal(slots[1], tmp_ctx);
+    assert_non_null(lys_parse_path(tmp_ctx->ctx, TEST_SCHEMA_SEARCH_DIR "top-level-mandatory.yang", LYS_IN_YANG));
+    rc = dm_release_tmp_ly_ctx(ctx, tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    rc = dm_feature_enable(ctx, "example-module", "featureX", true);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    for (size_t i = 0; i < 4; i++) {
+        rc = dm_get_tmp_ly_ctx(ctx, sets[i], &tmp_ctx);
+        assert_int_equal(SR_ERR_OK, rc);
+        assert_non_null(ly_ctx_get_module(tmp_ctx->ctx, modules[i], NULL));
+        assert_null(ly_ctx_get_module(tmp_ctx->ctx, marker, NULL));
+        rc = dm_release_tmp_ly_ctx(ctx, tmp_ctx);
+        assert_int_equal(SR_ERR_OK, rc);
+    }
+
+    /* contexts rebuilt after the change are reused again */
+    rc = dm_get_tmp_ly_ctx(ctx, sets[3], &tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_non_null(lys_parse_path(tmp_ctx->ctx, TEST_SCHEMA_SEARCH_DIR "top-level-mandatory.yang", LYS_IN_YANG));
+    slots[3] = tmp_ctx;
+    rc = dm_release_tmp_ly_ctx(ctx, tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_get_tmp_ly_ctx(ctx, sets[3], &tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_ptr_equal(slots[3], tmp_ctx);
+    assert_non_null(ly_ctx_get_module(tmp_ctx->ctx, marker, NULL));
+    rc = dm_release_tmp_ly_ctx(ctx, tmp_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    rc = dm_feature_enable(ctx, "example-module", "featureX", false);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    for (size_t i = 0; i < 5; i++) {
+        sr_list_cleanup(sets[i]);
+    }
+    dm_cleanup(ctx);
+}
+
+void
+dm_parallel_write_test(void **state)
+{
+    int rc;
+    dm_ctx_t *ctx = NULL;
+    dm_session_t *ses_ctx = NULL;
+    dm_data_info_t *info = NULL;
+    dm_commit_context_t *c_ctx = NULL;
+    sr_error_info_t *errors = NULL;
+    size_t err_cnt = 0;
+    struct stat st = { 0, };
+    char *file_names[3] = { NULL, };
+    /* modules are written in the order of their names, the file of the second one can not be written */
+    const char *modules[] = { "example-module", "ietf-interfaces", "test-module" };
+
+    /* the same result with files written by the calling thread and by the work pool */
+    for (int pool = 0; pool < 2; pool++) {
+        if (0 == pool) {
+            setenv(SR_COMMIT_THREAD_COUNT_ENV, "0", 1);
+        }
+        rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx);
+        unsetenv(SR_COMMIT_THREAD_COUNT_ENV);
+        assert_int_equal(SR_ERR_OK, rc);
+
+        rc = dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_ctx);
+        assert_int_equal(SR_ERR_OK, rc);
+
+        for (size_t i = 0; i < sizeof(modules) / sizeof(*modules); i++) {
+            rc = dm_get_data_info(ctx, ses_ctx, modules[i], &info);
+            assert_int_equal(SR_ERR_OK, rc);
+            assert_non_null(info->node);
+            info->modified = true;
+            rc = sr_get_data_file_name(TEST_DATA_SEARCH_DIR, modules[i], SR_DS_STARTUP, &file_names[i]);
+            assert_int_equal(SR_ERR_OK, rc);
+        }
+
+        rc = dm_commit_prepare_context(ctx, ses_ctx, &c_ctx);
+        assert_int_equal(SR_ERR_OK, rc);
+        assert_int_equal(3, c_ctx->modif_count);
+        rc = dm_commit_load_modified_models(ctx, ses_ctx, c_ctx, &errors, &err_cnt);
+        assert_int_equal(SR_ERR_OK, rc);
+
+        /* empty the data files, so that the rewrites can be told apart */
+        for (size_t i = 0; i < sizeof(modules) / sizeof(*modules); i++) {
+            assert_int_equal(0, truncate(file_names[i], 0));
+        }
+        close(c_ctx->fds[1]);
+        c_ctx->fds[1] = open(file_names[1], O_RDONLY);
+        assert_int_not_equal(-1, c_ctx->fds[1]);
+
+        /* the failed write does not prevent the others */
+        rc = dm_commit_write_files(ses_ctx, c_ctx);
+        assert_int_equal(SR_ERR_INTERNAL, rc);
+
+        assert_int_equal(0, stat(file_names[0], &st));
+        assert_true(st.st_size > 0);
+        assert_int_equal(0, stat(file_names[1], &st));
+        assert_int_equal(0, st.st_size);
+        assert_int_equal(0, stat(file_names[2], &st));
+        assert_true(st.st_size > 0);
+
+        dm_free_commit_context(c_ctx);
+        c_ctx = NULL;
+        dm_session_stop(ctx, ses_ctx);
+        dm_cleanup(ctx);
+
+        for (size_t i = 0; i < sizeof(modules) / sizeof(*modules); i++) {
+            free(file_names[i]);
+            file_names[i] = NULL;
+        }
+        createDataTreeIETFinterfacesModule();
+    }
+}
+
 void
 dm_discard_changes_test(void **state)
 {
@@ -1115,8 +1843,16 @@ main()
     const struct CMUnitTest tests[] = {
             cmocka_unit_test(dm_create_cleanup),
             cmocka_unit_test(dm_get_data_tree),
+            cmocka_unit_test(dm_shared_data_tree_test),
+            cmocka_unit_test(dm_journal_test),
+            cmocka_unit_test(dm_journal_commit_test),
             cmocka_unit_test(dm_list_schema_test),
             cmocka_unit_test(dm_validate_data_trees_test),
+            cmocka_unit_test(dm_parallel_validation_test),
+            cmocka_unit_test(dm_parallel_write_test),
+            cmocka_unit_test(dm_shared_schema_ctx_test),
+            cmocka_unit_test(dm_shared_schema_ctx_modify_test),
+            cmocka_unit_test(dm_tmp_ly_ctx_pool_test),
             cmocka_unit_test(dm_discard_changes_test),
             cmocka_unit_test(dm_get_schema_test),
             cmocka_unit_test(dm_get_schema_negative_test),
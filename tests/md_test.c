@@ -26,6 +26,8 @@
 #include <cmocka.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "module_dependencies.h"
 #include "sr_common.h"
 #include "test_data.h"
@@ -722,6 +724,92 @@ md_test_init_and_destroy(void **state)
     md_destroy(md_ctx);
 }
 
+/**
+ * @brief Returns the number of modules in the context and checks that all of them are present
+ * with the same attributes in the other context (if provided).
+ */
+static size_t
+md_test_compare_modules(md_ctx_t *md_ctx, md_ctx_t *other_ctx)
+{
+    int rc;
+    size_t count = 0;
+    md_module_t *module = NULL, *other = NULL;
+    sr_llist_node_t *ll_node = md_ctx->modules->first;
+
+    while (ll_node) {
+        module = (md_module_t *)ll_node->data;
+        if (NULL != other_ctx) {
+            rc = md_get_module_info(other_ctx, module->name, module->revision_date, &other);
+            assert_int_equal(SR_ERR_OK, rc);
+            assert_string_equal(module->filepath, other->filepath);
+            assert_int_equal(module->latest_revision, other->latest_revision);
+            assert_int_equal(module->implemented, other->implemented);
+            assert_int_equal(module->submodule, other->submodule);
+            assert_int_equal(module->has_data, other->has_data);
+            assert_int_equal(module->has_persist, other->has_persist);
+        }
+        ++count;
+        ll_node = ll_node->next;
+    }
+    return count;
+}
+
+/**
+ * @brief Test the cache of the internal data file with dependencies.
+ */
+static void
+md_test_cache(void **state)
+{
+    int rc;
+    md_ctx_t *md_ctx = NULL, *cached_ctx = NULL;
+    FILE *fp = NULL;
+    struct stat st = { 0, };
+    char *parsed_xml = NULL, *cached_xml = NULL;
+    const char *cache_filepath = TEST_DATA_SEARCH_DIR "internal/sysrepo-module-dependencies.cache";
+
+    /* the cache is created when the data file is parsed */
+    unlink(cache_filepath);
+    rc = md_init(TEST_SCHEMA_SEARCH_DIR, TEST_SCHEMA_SEARCH_DIR "internal",
+                 TEST_DATA_SEARCH_DIR "internal", false, &md_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(0, stat(cache_filepath, &st));
+
+    /* the same dependencies are loaded from the cache */
+    rc = md_init(TEST_SCHEMA_SEARCH_DIR, TEST_SCHEMA_SEARCH_DIR "internal",
+                 TEST_DATA_SEARCH_DIR "internal", false, &cached_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(md_test_compare_modules(md_ctx, NULL), md_test_compare_modules(cached_ctx, md_ctx));
+    md_test_compare_modules(md_ctx, cached_ctx);
+
+    /* default nodes stay implicit, the data file is printed the same way */
+    assert_int_equal(0, lyd_print_mem(&parsed_xml, md_ctx->data_tree, LYD_XML, LYP_WITHSIBLINGS | LYP_FORMAT));
+    assert_int_equal(0, lyd_print_mem(&cached_xml, cached_ctx->data_tree, LYD_XML, LYP_WITHSIBLINGS | LYP_FORMAT));
+    assert_string_equal(parsed_xml, cached_xml);
+    free(parsed_xml);
+    free(cached_xml);
+    md_destroy(cached_ctx);
+
+    /* corrupted cache is ignored and replaced */
+    fp = fopen(cache_filepath, "w");
+    assert_non_null(fp);
+    fprintf(fp, "SRMD corrupted cache content");
+    fclose(fp);
+
+    rc = md_init(TEST_SCHEMA_SEARCH_DIR, TEST_SCHEMA_SEARCH_DIR "internal",
+                 TEST_DATA_SEARCH_DIR "internal", false, &cached_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(md_test_compare_modules(md_ctx, NULL), md_test_compare_modules(cached_ctx, md_ctx));
+    md_destroy(cached_ctx);
+
+    rc = md_init(TEST_SCHEMA_SEARCH_DIR, TEST_SCHEMA_SEARCH_DIR "internal",
+                 TEST_DATA_SEARCH_DIR "internal", false, &cached_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(md_test_compare_modules(md_ctx, NULL), md_test_compare_modules(cached_ctx, md_ctx));
+    md_destroy(cached_ctx);
+
+    md_destroy(md_ctx);
+}
+
 static bool
 inserted_module(const char *module_name)
 {
@@ -1894,6 +1982,7 @@ md_test_has_data(void **state)
 int main(){
     const struct CMUnitTest tests[] = {
             cmocka_unit_test(md_test_init_and_destroy),
+            cmocka_unit_test(md_test_cache),
             cmocka_unit_test(md_test_insert_module),
             cmocka_unit_test(md_test_remove_module),
             cmocka_unit_test(md_test_grouping_and_uses),
@@ -26,8 +26,11 @@
 #include <setjmp.h>
 #include <cmocka.h>
 #include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
 #include <libyang/libyang.h>
 #include "sysrepo.h"
+#include "sr_common.h"
 #include "test_module_helper.h"
 #include "sysrepo/xpath.h"
 
@@ -44,6 +47,9 @@
 
 int instance_cnt = 1;
 
+/**@brief worst-case latency of an operation (in seconds), printed if set by the test */
+double max_latency = -1.0;
+
 /* Computes diff of two timeval structures
  * @see http://www.gnu.org/software/libc/manual/html_node/Elapsed-Time.html
  */
@@ -112,6 +118,7 @@ measure(void (*func)(void **, int, int *), const char *name, int op_count, void
     int items = 0;
 
     setup(&state);
+    max_latency = -1.0;
 
     gettimeofday(&tv1, NULL);
 
@@ -125,6 +132,9 @@ measure(void (*func)(void **, int, int *), const char *name, int op_count, void
     seconds = diff.tv_sec + 0.000001*diff.tv_usec;
     printf("%-32s| %10.0f | %10d | %13d | %10.0f | %10.2f\n",
             name, ((double) op_count)/ seconds, items, op_count, ((double) op_count * items)/ seconds, seconds);
+    if (max_latency >= 0.0) {
+        printf("%-32s| %10.3f ms\n", "  max latency", max_latency * 1000);
+    }
 }
 
 void
@@ -719,6 +729,158 @@ perf_set_delete_100_test(void **state, int op_num, int *items) {
     *items = 100 /* list instances */ * 3 /* leaves */ * 2 /* set + delete */ ;
 }
 
+static void
+perf_edit_batch_100_test(void **state, int op_num, int *items) {
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+    sr_session_ctx_t *session = NULL;
+    char set_xpath[101][128] = { { 0, }, };
+    char del_xpath[101][128] = { { 0, }, };
+    sr_edit_op_t ops[101] = { { 0, }, };
+    sr_val_t value = {0,};
+    int rc = 0;
+
+    /* start a session */
+    rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    value.type = SR_STRING_T;
+    value.data.string_val = "Leaf";
+    for (size_t j = 0; j <= 100; j++) {
+        sprintf(set_xpath[j], "/example-module:container/list[key1='set_del'][key2='set_%zu']/leaf", j);
+        sprintf(del_xpath[j], "/example-module:container/list[key1='set_del'][key2='set_%zu']", j);
+    }
+
+    /* perform the same edits as perf_set_delete_100_test, one request per 100 operations */
+    for (size_t i = 0; i < op_num; i++) {
+
+        /* set 100 list instances */
+        for (size_t j = 0; j <= 100; j++) {
+            ops[j].type = SR_EDIT_OP_SET;
+            ops[j].xpath = set_xpath[j];
+            ops[j].value = &value;
+            ops[j].opts = SR_EDIT_DEFAULT;
+        }
+        rc = sr_edit_batch(session, ops, 101, NULL);
+        assert_int_equal(rc, SR_ERR_OK);
+
+        /* delete 100 list instances */
+        for (size_t j = 0; j <= 100; j++) {
+            ops[j].type = SR_EDIT_OP_DELETE;
+            ops[j].xpath = del_xpath[j];
+            ops[j].value = NULL;
+            ops[j].opts = SR_EDIT_DEFAULT;
+        }
+        rc = sr_edit_batch(session, ops, 101, NULL);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+
+    /* stop the session */
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    *items = 100 /* list instances */ * 3 /* leaves */ * 2 /* set + delete */ ;
+}
+
+typedef struct commit_thread_ctx_s {
+    sr_conn_ctx_t *conn;
+    bool stop;          /**< accessed atomically */
+    int commit_cnt;
+    int rc;             /**< first error of the thread, checked by the main thread after join */
+} commit_thread_ctx_t;
+
+/**
+ * @brief Keeps committing changes of ietf-interfaces module until stopped or until an error occurs.
+ * Errors are only recorded, cmocka asserts must not be used outside of the main thread.
+ */
+static void *
+commit_thread_run(void *arg)
+{
+    commit_thread_ctx_t *ctx = (commit_thread_ctx_t *) arg;
+    sr_session_ctx_t *session = NULL;
+    char xpath[PATH_MAX] = { 0, };
+    sr_val_t value = { 0, };
+    int rc = 0;
+
+    rc = sr_session_start(ctx->conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+    if (SR_ERR_OK != rc) {
+        ctx->rc = rc;
+        return NULL;
+    }
+
+    value.type = SR_STRING_T;
+    while (SR_ERR_OK == rc && !__atomic_load_n(&ctx->stop, __ATOMIC_ACQUIRE)) {
+        /* change all interfaces to make the commit take longer */
+        for (int i = 0; SR_ERR_OK == rc && i < instance_cnt; i++) {
+            snprintf(xpath, PATH_MAX, "/ietf-interfaces:interfaces/interface[name='eth%d']/description", i);
+            value.data.string_val = (ctx->commit_cnt % 2) ? "odd" : "even";
+            rc = sr_set_item(session, xpath, &value, SR_EDIT_DEFAULT);
+        }
+        if (SR_ERR_OK == rc) {
+            rc = sr_commit(session);
+        }
+        if (SR_ERR_OK == rc) {
+            ctx->commit_cnt++;
+        }
+    }
+    ctx->rc = rc;
+
+    rc = sr_session_stop(session);
+    if (SR_ERR_OK == ctx->rc) {
+        ctx->rc = rc;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Reads a leaf of example-module while another session keeps committing ietf-interfaces.
+ * Reads of the module not touched by the commits should not be blocked by them.
+ */
+static void
+perf_get_item_during_commits_test(void **state, int op_num, int *items) {
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+
+    commit_thread_ctx_t commit_ctx = { conn, false, 0, SR_ERR_OK };
+    pthread_t commit_thread;
+    sr_session_ctx_t *session = NULL;
+    sr_val_t *value = NULL;
+    struct timeval tv1 = {0, }, tv2 = {0, }, diff = {0, };
+    double latency = 0.0;
+    int rc = 0;
+
+    /* start a session */
+    rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = pthread_create(&commit_thread, NULL, commit_thread_run, &commit_ctx);
+    assert_int_equal(rc, 0);
+
+    max_latency = 0.0;
+    for (size_t i = 0; i < op_num; i++) {
+        gettimeofday(&tv1, NULL);
+        rc = sr_get_item(session, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &value);
+        gettimeofday(&tv2, NULL);
+        assert_int_equal(rc, SR_ERR_OK);
+        sr_free_val(value);
+
+        timeval_subtract(&diff, &tv2, &tv1);
+        latency = diff.tv_sec + 0.000001*diff.tv_usec;
+        if (latency > max_latency) {
+            max_latency = latency;
+        }
+    }
+
+    __atomic_store_n(&commit_ctx.stop, true, __ATOMIC_RELEASE);
+    pthread_join(commit_thread, NULL);
+    assert_int_equal(commit_ctx.rc, SR_ERR_OK);
+
+    /* stop the session */
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+    *items = 1;
+}
+
 static void
 perf_commit_test(void **state, int op_num, int *items) {
     sr_conn_ctx_t *conn = *state;
@@ -940,6 +1102,124 @@ void test_perf(test_t *ts, int test_count, const char *title,  int selection)
     }
 }
 
+/**@brief number of producer and consumer threads used in request queue tests */
+#define QUEUE_THREAD_COUNT 4
+
+typedef struct queue_test_ctx_s {
+    bool lock_free;              /**< use sr_mpmc_queue_t instead of sr_cbuff_t guarded by a mutex */
+    sr_cbuff_t *cbuff;
+    pthread_mutex_t cbuff_mutex;
+    sr_mpmc_queue_t *mpmc_queue;
+    size_t items_per_thread;
+} queue_test_ctx_t;
+
+void
+queue_setup(void **state)
+{
+    queue_test_ctx_t *ctx = calloc(1, sizeof(*ctx));
+    assert_non_null(ctx);
+
+    assert_int_equal(SR_ERR_OK, sr_cbuff_init(10, sizeof(void *), &ctx->cbuff));
+    assert_int_equal(SR_ERR_OK, sr_mpmc_queue_init(1024, sizeof(void *), &ctx->mpmc_queue));
+    pthread_mutex_init(&ctx->cbuff_mutex, NULL);
+    *state = ctx;
+}
+
+void
+queue_teardown(void **state)
+{
+    queue_test_ctx_t *ctx = *state;
+    assert_non_null(ctx);
+
+    sr_cbuff_cleanup(ctx->cbuff);
+    sr_mpmc_queue_cleanup(ctx->mpmc_queue);
+    pthread_mutex_destroy(&ctx->cbuff_mutex);
+    free(ctx);
+}
+
+static void *
+queue_producer_run(void *arg)
+{
+    queue_test_ctx_t *ctx = arg;
+    void *item = ctx;
+
+    for (size_t i = 0; i < ctx->items_per_thread; i++) {
+        if (ctx->lock_free) {
+            while (!sr_mpmc_queue_enqueue(ctx->mpmc_queue, &item)) {
+                sched_yield();
+            }
+        } else {
+            pthread_mutex_lock(&ctx->cbuff_mutex);
+            sr_cbuff_enqueue(ctx->cbuff, &item);
+            pthread_mutex_unlock(&ctx->cbuff_mutex);
+        }
+    }
+    return NULL;
+}
+
+static void *
+queue_consumer_run(void *arg)
+{
+    queue_test_ctx_t *ctx = arg;
+    void *item = NULL;
+    bool dequeued = false;
+
+    for (size_t i = 0; i < ctx->items_per_thread; i++) {
+        do {
+            if (ctx->lock_free) {
+                dequeued = sr_mpmc_queue_dequeue(ctx->mpmc_queue, &item);
+            } else {
+                pthread_mutex_lock(&ctx->cbuff_mutex);
+                dequeued = sr_cbuff_dequeue(ctx->cbuff, &item);
+                pthread_mutex_unlock(&ctx->cbuff_mutex);
+            }
+            if (!dequeued) {
+                sched_yield();
+            }
+        } while (!dequeued);
+        assert_ptr_equal(item, ctx);
+    }
+    return NULL;
+}
+
+static void
+perf_queue_run(queue_test_ctx_t *ctx, int op_num)
+{
+    pthread_t producers[QUEUE_THREAD_COUNT], consumers[QUEUE_THREAD_COUNT];
+
+    ctx->items_per_thread = op_num / QUEUE_THREAD_COUNT;
+    for (size_t i = 0; i < QUEUE_THREAD_COUNT; i++) {
+        assert_int_equal(0, pthread_create(&producers[i], NULL, queue_producer_run, ctx));
+        assert_int_equal(0, pthread_create(&consumers[i], NULL, queue_consumer_run, ctx));
+    }
+    for (size_t i = 0; i < QUEUE_THREAD_COUNT; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+}
+
+static void
+perf_queue_cbuff_test(void **state, int op_num, int *items)
+{
+    queue_test_ctx_t *ctx = *state;
+    assert_non_null(ctx);
+
+    ctx->lock_free = false;
+    perf_queue_run(ctx, op_num);
+    *items = 1;
+}
+
+static void
+perf_queue_mpmc_test(void **state, int op_num, int *items)
+{
+    queue_test_ctx_t *ctx = *state;
+    assert_non_null(ctx);
+
+    ctx->lock_free = true;
+    perf_queue_run(ctx, op_num);
+    *items = 1;
+}
+
 int
 main (int argc, char **argv)
 {
@@ -956,13 +1236,17 @@ main (int argc, char **argv)
         {perf_get_ietf_intefaces_tree_test, "Get subtrees ietf-if config", OP_COUNT, sysrepo_setup, sysrepo_teardown},
         {perf_set_delete_test, "Set & delete one list", OP_COUNT, sysrepo_setup, sysrepo_teardown},
         {perf_set_delete_100_test, "Set & delete 100 lists", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
+        {perf_edit_batch_100_test, "Set & delete 100 lists in batch", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
         {perf_commit_test, "Commit one leaf change", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
+        {perf_get_item_during_commits_test, "Get item during commits", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
         {perf_data_provide_test, "Operational data provide", OP_COUNT_COMMIT, data_provide_setup, data_provide_teardown},
         {perf_rpc_test, "RPC", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
         {perf_ev_notification_ephemeral_test, "Event notification - ephemeral", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
         {perf_ev_notification_store_test, "Event notification - store", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
         {perf_libyang_get_node, "Libyang get one node", OP_COUNT, libyang_setup, libyang_teardown},
         {perf_libyang_get_all_list, "Libyang get all list", OP_COUNT, libyang_setup, libyang_teardown},
+        {perf_queue_cbuff_test, "Request queue - locked cbuff", OP_COUNT, queue_setup, queue_teardown},
+        {perf_queue_mpmc_test, "Request queue - lock-free", OP_COUNT, queue_setup, queue_teardown},
     };
 
     size_t test_count = sizeof(tests)/sizeof(*tests);
@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <sys/stat.h>
 #include <setjmp.h>
 #include <cmocka.h>
 
@@ -321,7 +322,7 @@ np_module_subscriptions_test(void **state)
                 (SR__NOTIFICATION_EVENT__APPLY_EV == subscription->notif_event));
 
         /* notify */
-        rc = np_subscription_notify(np_ctx, subscription, SR_EV_APPLY, 0);
+        rc = np_subscription_notify(np_ctx, subscription, SR_EV_APPLY, 0, NULL);
         assert_int_equal(rc, SR_ERR_OK);
     }
 
@@ -381,13 +382,14 @@ np_dp_subscriptions_test(void **state)
 
     rc = sr_gpb_req_alloc(NULL, SR__OPERATION__GET_ITEM, test_ctx->rp_session_ctx->id, &test_ctx->rp_session_ctx->req);
     assert_int_equal(rc, SR_ERR_OK);
+    char *xpaths[] = { "/example-module:container" };
     for (size_t i = 0; i < subscriptions_list->count; i++) {
         subscription = subscriptions_list->data[i];
         assert_non_null(subscription);
         assert_true(SR__SUBSCRIPTION_TYPE__DP_GET_ITEMS_SUBS == subscription->type);
 
         /* notify and add into list */
-        rc = np_data_provider_request(np_ctx, subscription, test_ctx->rp_session_ctx, "/example-module:container");
+        rc = np_data_provider_request(np_ctx, subscription, test_ctx->rp_session_ctx, xpaths, 1);
         assert_int_equal(rc, SR_ERR_OK);
     }
 
@@ -453,6 +455,153 @@ np_notif_store_test(void **state)
 #endif
 }
 
+static void
+np_notif_store_time_range_test(void **state)
+{
+#ifndef ENABLE_NOTIF_STORE
+    skip();
+#else
+    int rc = SR_ERR_OK;
+    test_ctx_t *test_ctx = *state;
+    assert_non_null(test_ctx);
+    np_ctx_t *np_ctx = test_ctx->rp_ctx->np_ctx;
+
+    struct ly_ctx *ctx = NULL;
+    const struct lys_module *module = NULL;
+    struct lyd_node *node = NULL;
+    sr_list_t *notif_list = NULL;
+    np_ev_notification_t *notification = NULL;
+    /* notifications generated in the past, in a segment not used by other tests */
+    time_t base_time = time(NULL) - (2 * SR_NOTIF_TIME_WINDOW * 60);
+    time_t gen_times[] = { base_time, base_time + 10, base_time + 20, base_time + 5 /* out of order */ };
+    const char *interfaces[] = { "eth0", "eth1", "eth2", "eth3" };
+
+    ctx = ly_ctx_new(TEST_SCHEMA_SEARCH_DIR);
+    assert_non_null(ctx);
+    module = ly_ctx_load_module(ctx, "test-module", NULL);
+    assert_non_null(module);
+
+    for (size_t i = 0; i < sizeof(gen_times) / sizeof(*gen_times); i++) {
+        node = lyd_new_path(NULL, ctx, "/test-module:link-removed/source/interface", (void*)interfaces[i], 0, 0);
+        assert_non_null(node);
+        rc = np_store_event_notification(np_ctx, test_ctx->rp_session_ctx->user_credentials, "/test-module:link-removed",
+                gen_times[i], &node);
+        assert_int_equal(rc, SR_ERR_OK);
+        assert_null(node);
+        /* notification with another xpath in the same segment */
+        node = lyd_new_path(NULL, ctx, "/test-module:link-discovered/source/interface", (void*)interfaces[i], 0, 0);
+        assert_non_null(node);
+        rc = np_store_event_notification(np_ctx, test_ctx->rp_session_ctx->user_credentials, "/test-module:link-discovered",
+                gen_times[i], &node);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+
+    /* replay from the middle of the segment */
+    rc = np_get_event_notifications(np_ctx, test_ctx->rp_session_ctx, "/test-module:link-removed", base_time + 5,
+            base_time + 10, SR_API_VALUES, &notif_list);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_non_null(notif_list);
+    assert_int_equal(2, notif_list->count);
+
+    for (size_t i = 0; i < notif_list->count; i++) {
+        notification = notif_list->data[i];
+        assert_string_equal(notification->xpath, "/test-module:link-removed");
+        assert_true(notification->timestamp >= base_time + 5 && notification->timestamp <= base_time + 10);
+        assert_int_equal(NP_EV_NOTIF_DATA_VALUES, notification->data_type);
+        np_event_notification_cleanup(notification);
+    }
+    sr_list_cleanup(notif_list);
+    notif_list = NULL;
+
+    /* time interval without notifications */
+    rc = np_get_event_notifications(np_ctx, test_ctx->rp_session_ctx, "/test-module:link-removed", base_time + 21,
+            base_time + 30, SR_API_VALUES, &notif_list);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_null(notif_list);
+
+    rc = np_notification_store_cleanup(np_ctx, false);
+    assert_int_equal(rc, SR_ERR_OK);
+    ly_ctx_destroy(ctx, NULL);
+#endif
+}
+
+static void
+np_notif_store_legacy_test(void **state)
+{
+#ifndef ENABLE_NOTIF_STORE
+    skip();
+#else
+    int rc = SR_ERR_OK;
+    test_ctx_t *test_ctx = *state;
+    assert_non_null(test_ctx);
+    np_ctx_t *np_ctx = test_ctx->rp_ctx->np_ctx;
+
+    sr_list_t *notif_list = NULL;
+    np_ev_notification_t *notification = NULL;
+    char filename[PATH_MAX] = { 0, };
+    char time_buf[64] = { 0, };
+    struct tm *tm_time = NULL;
+    FILE *file = NULL;
+    /* notification stored in the old XML format, in a time window not used by other tests */
+    time_t gen_time = time(NULL) - (4 * SR_NOTIF_TIME_WINDOW * 60);
+    time_t window_start = gen_time;
+
+    tm_time = localtime(&window_start);
+    window_start -= (((tm_time->tm_hour * 60) + tm_time->tm_min) % SR_NOTIF_TIME_WINDOW) * 60;
+
+    mkdir(SR_NOTIF_DATA_SEARCH_DIR, S_IRWXU | S_IRWXG | S_IRWXO);
+    mkdir(SR_NOTIF_DATA_SEARCH_DIR "/test-module", S_IRWXU | S_IRWXG | S_IRWXO);
+    snprintf(filename, PATH_MAX, "%s/test-module/", SR_NOTIF_DATA_SEARCH_DIR);
+    strftime(filename + strlen(filename), PATH_MAX - strlen(filename) - 1, "%Y-%m-%d_%H-%M.xml", localtime(&window_start));
+    sr_time_to_str(gen_time, time_buf, sizeof(time_buf));
+
+    file = fopen(filename, "w");
+    assert_non_null(file);
+    fprintf(file,
+            "<notifications xmlns=\"urn:ietf:params:xml:ns:yang:sysrepo-notification-store\">\n"
+            "  <notification>\n"
+            "    <xpath>/test-module:link-removed</xpath>\n"
+            "    <generated-time>%s</generated-time>\n"
+            "    <logged-time>0</logged-time>\n"
+            "    <data><link-removed xmlns=\"urn:ietf:params:xml:ns:yang:test-module\">"
+            "<source><interface>eth9</interface></source></link-removed></data>\n"
+            "  </notification>\n"
+            "  <notification>\n"
+            "    <xpath>/test-module:link-discovered</xpath>\n"
+            "    <generated-time>%s</generated-time>\n"
+            "    <logged-time>1</logged-time>\n"
+            "    <data><link-discovered xmlns=\"urn:ietf:params:xml:ns:yang:test-module\">"
+            "<source><interface>eth9</interface></source></link-discovered></data>\n"
+            "  </notification>\n"
+            "</notifications>\n", time_buf, time_buf);
+    fclose(file);
+
+    /* notification history in the old format is still replayed */
+    rc = np_get_event_notifications(np_ctx, test_ctx->rp_session_ctx, "/test-module:link-removed", gen_time - 1,
+            gen_time + 1, SR_API_VALUES, &notif_list);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_non_null(notif_list);
+    assert_int_equal(1, notif_list->count);
+
+    notification = notif_list->data[0];
+    assert_string_equal(notification->xpath, "/test-module:link-removed");
+    assert_int_equal(gen_time, notification->timestamp);
+    assert_int_equal(NP_EV_NOTIF_DATA_VALUES, notification->data_type);
+    assert_true(notification->data_cnt > 0);
+    np_event_notification_cleanup(notification);
+    sr_list_cleanup(notif_list);
+    notif_list = NULL;
+
+    /* time interval filter applies as well */
+    rc = np_get_event_notifications(np_ctx, test_ctx->rp_session_ctx, "/test-module:link-removed", gen_time + 1,
+            gen_time + 10, SR_API_VALUES, &notif_list);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_null(notif_list);
+
+    unlink(filename);
+#endif
+}
+
 int
 main() {
     const struct CMUnitTest tests[] = {
@@ -463,6 +612,8 @@ main() {
             cmocka_unit_test_setup_teardown(np_module_subscriptions_test, test_setup, test_teardown),
             cmocka_unit_test_setup_teardown(np_dp_subscriptions_test, test_setup, test_teardown),
             cmocka_unit_test_setup_teardown(np_notif_store_test, test_setup, test_teardown),
+            cmocka_unit_test_setup_teardown(np_notif_store_time_range_test, test_setup, test_teardown),
+            cmocka_unit_test_setup_teardown(np_notif_store_legacy_test, test_setup, test_teardown),
     };
 
     watchdog_start(300);
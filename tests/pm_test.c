@@ -21,9 +21,11 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <sys/types.h>
 #include <setjmp.h>
 #include <cmocka.h>
@@ -86,6 +88,49 @@ __wrap_cm_msg_send(cm_ctx_t *cm_ctx, Sr__Msg *msg)
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Creates another PM instance working with the same persist files, as another process would.
+ */
+static void
+pm_another_init(test_ctx_t *test_ctx, pm_ctx_t **pm_ctx)
+{
+    int rc = SR_ERR_OK;
+
+    rc = pm_init(test_ctx->rp_ctx, SR_INTERNAL_SCHEMA_SEARCH_DIR, SR_DATA_SEARCH_DIR, pm_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+}
+
+/**
+ * @brief Returns the number of subtree-change subscriptions of example-module for the destination,
+ * -1 if the subscription with the given destination ID is not among them (if provided).
+ */
+static int
+pm_dst_subscription_count(test_ctx_t *test_ctx, pm_ctx_t *pm_ctx, const char *dst_address, int64_t dst_id)
+{
+    sr_list_t *subscriptions_list = NULL;
+    np_subscription_t *subscription_p = NULL;
+    bool found = (dst_id < 0);
+    int count = 0;
+    int rc = SR_ERR_OK;
+
+    rc = pm_get_subscriptions(pm_ctx, &test_ctx->user_cred, "example-module", SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS,
+            &subscriptions_list);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    for (size_t i = 0; NULL != subscriptions_list && i < subscriptions_list->count; i++) {
+        subscription_p = subscriptions_list->data[i];
+        if (0 == strcmp(subscription_p->dst_address, dst_address)) {
+            count++;
+            if (subscription_p->dst_id == dst_id) {
+                found = true;
+            }
+        }
+    }
+    np_subscriptions_list_cleanup(subscriptions_list);
+
+    return found ? count : -1;
+}
+
 static void
 pm_feature_test(void **state)
 {
@@ -351,7 +396,7 @@ pm_subscription_cache_test(void **state)
     assert_int_equal(SR_ERR_OK, rc);
     assert_true(disable_running);
 
-    /* retrieve active subscriptions - from disk, cache should be invalidated */
+    /* retrieve active subscriptions - the removed subscriptions are gone */
     rc = pm_get_subscriptions(pm_ctx, &test_ctx->user_cred, "example-module", SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS,
             &subscriptions_list);
     assert_int_equal(SR_ERR_OK, rc);
@@ -382,12 +427,184 @@ pm_subscription_cache_test(void **state)
     assert_false(disable_running);
 }
 
+#define PM_TEST_BATCH_THREADS 10         /**< Number of threads adding subscriptions concurrently. */
+#define PM_TEST_BATCH_SUBSCRIPTIONS 10   /**< Number of subscriptions added by each thread. */
+
+typedef struct pm_batch_thread_ctx_s {
+    test_ctx_t *test_ctx;
+    pm_ctx_t *pm_ctx;
+    uint32_t id;
+} pm_batch_thread_ctx_t;
+
+static void *
+pm_batch_thread(void *arg)
+{
+    pm_batch_thread_ctx_t *thread_ctx = arg;
+    int rc = SR_ERR_OK;
+
+    np_subscription_t subscription = { 0, };
+    subscription.dst_address = "/tmp/test-subscription-address3.sock";
+    subscription.type = SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS;
+    subscription.notif_event = SR__NOTIFICATION_EVENT__APPLY_EV;
+    subscription.xpath = "/example-module:container";
+
+    for (uint32_t i = 0; i < PM_TEST_BATCH_SUBSCRIPTIONS; i++) {
+        subscription.dst_id = thread_ctx->id * PM_TEST_BATCH_SUBSCRIPTIONS + i;
+        rc = pm_add_subscription(thread_ctx->pm_ctx, &thread_ctx->test_ctx->user_cred, "example-module",
+                &subscription, false);
+        assert_int_equal(SR_ERR_OK, rc);
+    }
+
+    return NULL;
+}
+
+static void
+pm_subscription_batch_test(void **state)
+{
+    test_ctx_t *test_ctx = *state;
+    pm_ctx_t *pm_ctx = test_ctx->rp_ctx->pm_ctx, *pm_ctx2 = NULL;
+    pthread_t threads[PM_TEST_BATCH_THREADS];
+    pm_batch_thread_ctx_t thread_ctx[PM_TEST_BATCH_THREADS];
+    const char *dst_address = "/tmp/test-subscription-address3.sock";
+    bool disable_running = false;
+    int rc = SR_ERR_OK;
+
+    /* another PM instance, the changes of concurrent requests are written into the persist file in batches */
+    pm_another_init(test_ctx, &pm_ctx2);
+
+    /* delete old subscriptions, if any */
+    pm_remove_subscriptions_for_destination(pm_ctx2, "example-module", dst_address, &disable_running);
+
+    for (uint32_t i = 0; i < PM_TEST_BATCH_THREADS; i++) {
+        thread_ctx[i].test_ctx = test_ctx;
+        thread_ctx[i].pm_ctx = pm_ctx2;
+        thread_ctx[i].id = i;
+        pthread_create(&threads[i], NULL, pm_batch_thread, &thread_ctx[i]);
+    }
+    for (uint32_t i = 0; i < PM_TEST_BATCH_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    assert_int_equal(PM_TEST_BATCH_THREADS * PM_TEST_BATCH_SUBSCRIPTIONS,
+            pm_dst_subscription_count(test_ctx, pm_ctx2, dst_address, -1));
+
+    /* each request returned after its change had been written, the other instance sees all of them */
+    assert_int_equal(PM_TEST_BATCH_THREADS * PM_TEST_BATCH_SUBSCRIPTIONS,
+            pm_dst_subscription_count(test_ctx, pm_ctx, dst_address, -1));
+
+    pm_cleanup(pm_ctx2);
+
+    rc = pm_remove_subscriptions_for_destination(pm_ctx, "example-module", dst_address, &disable_running);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_false(disable_running);
+    assert_int_equal(0, pm_dst_subscription_count(test_ctx, pm_ctx, dst_address, -1));
+}
+
+static void
+pm_subscription_commit_test(void **state)
+{
+    test_ctx_t *test_ctx = *state;
+    pm_ctx_t *pm_ctx = test_ctx->rp_ctx->pm_ctx, *pm_ctx2 = NULL;
+    bool disable_running = false;
+    int rc = SR_ERR_OK;
+
+    np_subscription_t subscription = { 0, };
+    subscription.dst_address = "/tmp/test-subscription-address4.sock";
+    subscription.type = SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS;
+    subscription.notif_event = SR__NOTIFICATION_EVENT__APPLY_EV;
+    subscription.xpath = "/example-module:container";
+
+    /* delete old subscriptions, if any */
+    pm_remove_subscriptions_for_destination(pm_ctx, "example-module", subscription.dst_address, &disable_running);
+
+    pm_another_init(test_ctx, &pm_ctx2);
+
+    /* each change is written before the request returns */
+    subscription.dst_id = 1;
+    rc = pm_add_subscription(pm_ctx2, &test_ctx->user_cred, "example-module", &subscription, false);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(1, pm_dst_subscription_count(test_ctx, pm_ctx, subscription.dst_address, 1));
+
+    subscription.dst_id = 2;
+    rc = pm_add_subscription(pm_ctx2, &test_ctx->user_cred, "example-module", &subscription, false);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(2, pm_dst_subscription_count(test_ctx, pm_ctx, subscription.dst_address, 2));
+
+    rc = pm_remove_subscription(pm_ctx2, &test_ctx->user_cred, "example-module", &subscription, &disable_running);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(1, pm_dst_subscription_count(test_ctx, pm_ctx, subscription.dst_address, 1));
+
+    rc = pm_remove_subscriptions_for_destination(pm_ctx2, "example-module", subscription.dst_address, &disable_running);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(0, pm_dst_subscription_count(test_ctx, pm_ctx, subscription.dst_address, -1));
+
+    pm_cleanup(pm_ctx2);
+}
+
+static void
+pm_subscription_merge_test(void **state)
+{
+    test_ctx_t *test_ctx = *state;
+    pm_ctx_t *pm_ctx = test_ctx->rp_ctx->pm_ctx, *pm_ctx2 = NULL;
+    bool disable_running = false;
+    int rc = SR_ERR_OK;
+
+    np_subscription_t subscription = { 0, };
+    subscription.dst_address = "/tmp/test-subscription-address5.sock";
+    subscription.type = SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS;
+    subscription.notif_event = SR__NOTIFICATION_EVENT__APPLY_EV;
+    subscription.xpath = "/example-module:container";
+
+    /* delete old subscriptions, if any */
+    pm_remove_subscriptions_for_destination(pm_ctx, "example-module", subscription.dst_address, &disable_running);
+
+    pm_another_init(test_ctx, &pm_ctx2);
+
+    subscription.dst_id = 1;
+    rc = pm_add_subscription(pm_ctx2, &test_ctx->user_cred, "example-module", &subscription, false);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(1, pm_dst_subscription_count(test_ctx, pm_ctx2, subscription.dst_address, 1));
+
+    /* the external change is detected, the changes are written on top of it */
+    subscription.dst_id = 2;
+    rc = pm_add_subscription(pm_ctx, &test_ctx->user_cred, "example-module", &subscription, false);
+    assert_int_equal(SR_ERR_OK, rc);
+    subscription.dst_id = 3;
+    rc = pm_add_subscription(pm_ctx2, &test_ctx->user_cred, "example-module", &subscription, false);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(3, pm_dst_subscription_count(test_ctx, pm_ctx2, subscription.dst_address, 2));
+    assert_int_equal(3, pm_dst_subscription_count(test_ctx, pm_ctx, subscription.dst_address, 1));
+    assert_int_equal(3, pm_dst_subscription_count(test_ctx, pm_ctx, subscription.dst_address, 3));
+
+    /* the subscription added by the other instance is a duplicate */
+    rc = pm_add_subscription(pm_ctx, &test_ctx->user_cred, "example-module", &subscription, false);
+    assert_int_equal(SR_ERR_DATA_EXISTS, rc);
+
+    /* the subscription removed by the other instance is missing */
+    subscription.dst_id = 1;
+    rc = pm_remove_subscription(pm_ctx, &test_ctx->user_cred, "example-module", &subscription, &disable_running);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = pm_remove_subscription(pm_ctx2, &test_ctx->user_cred, "example-module", &subscription, &disable_running);
+    assert_int_equal(SR_ERR_DATA_MISSING, rc);
+    assert_int_equal(2, pm_dst_subscription_count(test_ctx, pm_ctx2, subscription.dst_address, 3));
+
+    pm_cleanup(pm_ctx2);
+
+    assert_int_equal(2, pm_dst_subscription_count(test_ctx, pm_ctx, subscription.dst_address, 2));
+
+    rc = pm_remove_subscriptions_for_destination(pm_ctx, "example-module", subscription.dst_address, &disable_running);
+    assert_int_equal(SR_ERR_OK, rc);
+}
+
 int
 main() {
     const struct CMUnitTest tests[] = {
             cmocka_unit_test_setup_teardown(pm_feature_test, test_setup, test_teardown),
             cmocka_unit_test_setup_teardown(pm_subscription_test, test_setup, test_teardown),
             cmocka_unit_test_setup_teardown(pm_subscription_cache_test, test_setup, test_teardown),
+            cmocka_unit_test_setup_teardown(pm_subscription_batch_test, test_setup, test_teardown),
+            cmocka_unit_test_setup_teardown(pm_subscription_commit_test, test_setup, test_teardown),
+            cmocka_unit_test_setup_teardown(pm_subscription_merge_test, test_setup, test_teardown),
     };
 
     watchdog_start(300);
@@ -1175,6 +1175,99 @@ void get_trees_with_augments_test(void **state){
     test_rp_session_cleanup(rp_ctx, rp_session);
 }
 
+void get_gpb_values_and_trees_test(void **state){
+    int rc = 0;
+    rp_ctx_t *rp_ctx = *state;
+    dm_ctx_t *dm_ctx = rp_ctx->dm_ctx;
+    rp_session_t *rp_session = NULL;
+    struct lyd_node *data_tree = NULL;
+    struct lyd_node *root = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    sr_val_t *values = NULL;
+    sr_node_t *trees = NULL;
+    Sr__Value **gpb_values = NULL, **exp_values = NULL;
+    Sr__Node **gpb_trees = NULL, **exp_trees = NULL;
+    size_t count = 0, gpb_count = 0, exp_count = 0;
+    uint8_t *buf = NULL, *exp_buf = NULL;
+    size_t size = 0;
+
+    test_rp_session_create(rp_ctx, SR_DS_STARTUP, &rp_session);
+    rc = dm_get_datatree(dm_ctx, rp_session->dm_session, "example-module", &data_tree);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    createDataTreeWithAugments(data_tree->schema->module->ctx, &root);
+    assert_non_null(root);
+
+    rc = sr_mem_new(0, &sr_mem);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* values copied directly into GPB have to be the same as the values converted from sr_val_t */
+    rc = rp_dt_get_values(dm_ctx, rp_session, root, NULL, "/small-module:item/*", false, &values, &count);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = sr_values_sr_to_gpb(values, count, &exp_values, &exp_count);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    rc = rp_dt_get_gpb_values(dm_ctx, rp_session, root, sr_mem, "/small-module:item/*", false, &gpb_values, &gpb_count);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(exp_count, gpb_count);
+
+    for (size_t i = 0; i < gpb_count; i++) {
+        size = sr__value__get_packed_size(gpb_values[i]);
+        assert_int_equal(sr__value__get_packed_size(exp_values[i]), size);
+        buf = calloc(1, size);
+        exp_buf = calloc(1, size);
+        assert_non_null(buf);
+        assert_non_null(exp_buf);
+        sr__value__pack(gpb_values[i], buf);
+        sr__value__pack(exp_values[i], exp_buf);
+        assert_memory_equal(exp_buf, buf, size);
+        free(buf);
+        free(exp_buf);
+        sr__value__free_unpacked(exp_values[i], NULL);
+    }
+    free(exp_values);
+    sr_free_values(values, count);
+
+    /* the same for trees, including module names of augment nodes */
+    rc = rp_dt_get_subtrees(dm_ctx, rp_session, root, NULL, "/small-module:item", false, &trees, &count);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = sr_trees_sr_to_gpb(trees, count, &exp_trees, &exp_count);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    rc = rp_dt_get_gpb_subtrees(dm_ctx, rp_session, root, sr_mem, "/small-module:item", false, &gpb_trees, &gpb_count);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(exp_count, gpb_count);
+    assert_string_equal("small-module", gpb_trees[0]->module_name);
+    assert_int_equal(2, gpb_trees[0]->n_children);
+    assert_string_equal("info-module", gpb_trees[0]->children[1]->module_name);
+
+    for (size_t i = 0; i < gpb_count; i++) {
+        size = sr__node__get_packed_size(gpb_trees[i]);
+        assert_int_equal(sr__node__get_packed_size(exp_trees[i]), size);
+        buf = calloc(1, size);
+        exp_buf = calloc(1, size);
+        assert_non_null(buf);
+        assert_non_null(exp_buf);
+        sr__node__pack(gpb_trees[i], buf);
+        sr__node__pack(exp_trees[i], exp_buf);
+        assert_memory_equal(exp_buf, buf, size);
+        free(buf);
+        free(exp_buf);
+        sr__node__free_unpacked(exp_trees[i], NULL);
+    }
+    free(exp_trees);
+    sr_free_trees(trees, count);
+
+    /* nothing found */
+    rc = rp_dt_get_gpb_subtrees(dm_ctx, rp_session, root, sr_mem, "/small-module:item/name[.='abc']",
+            false, &gpb_trees, &gpb_count);
+    assert_int_equal(SR_ERR_NOT_FOUND, rc);
+
+    sr_mem_free(sr_mem);
+    lyd_free_withsiblings(root);
+    test_rp_session_cleanup(rp_ctx, rp_session);
+}
+
 void get_value_test(void **state)
 {
     int rc = 0;
@@ -1883,6 +1976,7 @@ int main(){
             cmocka_unit_test(get_trees_test),
             cmocka_unit_test(get_values_with_augments_test),
             cmocka_unit_test(get_trees_with_augments_test),
+            cmocka_unit_test(get_gpb_values_and_trees_test),
             cmocka_unit_test(ietf_interfaces_test),
             cmocka_unit_test(ietf_interfaces_tree_test),
             cmocka_unit_test(ietf_interfaces_tree_with_opts_test),
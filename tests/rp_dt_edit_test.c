@@ -2566,6 +2566,144 @@ validaton_of_multiple_models(void **state)
 }
 
 
+static size_t
+subtree_idx(const dm_subtree_deps_t *deps, const char *name)
+{
+    for (size_t i = 0; i < deps->count; i++) {
+        if (0 == strcmp(deps->nodes[i]->name, name)) {
+            return i;
+        }
+    }
+    fail_msg("Top-level node %s not found", name);
+    return 0;
+}
+
+static void
+validation_of_modified_subtrees(void **state)
+{
+    int rc = 0;
+    rp_ctx_t *ctx = *state;
+    rp_session_t *session = NULL;
+    dm_data_info_t *info = NULL;
+    sr_error_info_t *errors = NULL;
+    size_t e_cnt = 0;
+    sr_val_t *val = NULL;
+    const dm_subtree_deps_t *deps = NULL;
+    size_t interface = 0, university = 0, tpdfs = 0, kernel_modules = 0;
+
+    test_rp_session_create(ctx, SR_DS_STARTUP, &session);
+
+    rc = rp_dt_set_item_wrapper(ctx, session, "/example-module:container/list[key1='modified'][key2='subtree']", NULL, NULL, SR_EDIT_DEFAULT);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* the change is attributed to the top-level container */
+    rc = dm_get_data_info(ctx->dm_ctx, session->dm_session, "example-module", &info);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_true(info->modified);
+    assert_false(info->modified_untracked);
+    assert_non_null(info->modified_subtrees);
+    assert_int_equal(1, info->modified_subtrees->count);
+    assert_string_equal("container", (char *) info->modified_subtrees->data[0]);
+
+    rc = dm_validate_session_data_trees(ctx->dm_ctx, session->dm_session, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_null(info->modified_subtrees);
+
+    /* data are intact after the validation */
+    session->state = RP_REQ_NEW;
+    rc = rp_dt_get_value_wrapper(ctx, session, NULL, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &val);
+    assert_int_equal(SR_ERR_OK, rc);
+    sr_free_val(val);
+
+    /* unchanged tree validated again */
+    rc = dm_validate_session_data_trees(ctx->dm_ctx, session->dm_session, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_true(info->modified);
+
+    /* change that can not be attributed to a subtree */
+    rc = rp_dt_delete_item_wrapper(ctx, session, "/example-module:*", SR_EDIT_DEFAULT);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_true(info->modified_untracked);
+
+    rc = dm_validate_session_data_trees(ctx->dm_ctx, session->dm_session, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_false(info->modified_untracked);
+    /* the dependencies among the subtrees are cached in the schema info, example-module has no constraints */
+    deps = info->schema->subtree_deps;
+    assert_non_null(deps);
+    assert_true(deps->count > 0);
+    for (size_t i = 0; i < deps->count; i++) {
+        assert_false(deps->refs_any[i]);
+        for (size_t j = 0; j < deps->count; j++) {
+            assert_false(deps->refs[i * deps->count + j]);
+        }
+    }
+
+    /* change breaking a must constraint is rejected although it is attributed to one subtree */
+    val = calloc(1, sizeof(*val));
+    assert_non_null(val);
+    val->type = SR_ENUM_T;
+    val->data.enum_val = strdup("ethernet");
+    rc = rp_dt_set_item_wrapper(ctx, session, "/test-module:interface/ifType", val, NULL, SR_EDIT_DEFAULT);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    rc = dm_get_data_info(ctx->dm_ctx, session->dm_session, "test-module", &info);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_non_null(info->modified_subtrees);
+
+    errors = NULL;
+    e_cnt = 0;
+    rc = dm_validate_session_data_trees(ctx->dm_ctx, session->dm_session, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_VALIDATION_FAILED, rc);
+    assert_int_equal(1, e_cnt);
+    assert_string_equal("An ethernet MTU must be 1500", errors[0].message);
+    sr_free_errors(errors, e_cnt);
+
+    /* the must constraint references only its own subtree */
+    deps = NULL;
+    rc = dm_get_subtree_deps(info->schema, &deps);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_non_null(deps);
+    assert_ptr_equal(deps, info->schema->subtree_deps);
+    interface = subtree_idx(deps, "interface");
+    assert_false(deps->refs_any[interface]);
+    for (size_t j = 0; j < deps->count; j++) {
+        assert_true((j == interface) == deps->refs[interface * deps->count + j]);
+    }
+    /* leafrefs within the subtree and to another subtree */
+    university = subtree_idx(deps, "university");
+    assert_false(deps->refs_any[university]);
+    assert_true(deps->refs[university * deps->count + university]);
+    tpdfs = subtree_idx(deps, "tpdfs");
+    assert_false(deps->refs_any[tpdfs]);
+    assert_true(deps->refs[tpdfs * deps->count + subtree_idx(deps, "list")]);
+    /* instance-identifier can reference any data */
+    assert_true(deps->refs_any[subtree_idx(deps, "list")]);
+    /* constraints in actions and notifications are not validated with the data */
+    kernel_modules = subtree_idx(deps, "kernel-modules");
+    assert_false(deps->refs_any[kernel_modules]);
+    for (size_t j = 0; j < deps->count; j++) {
+        assert_false(deps->refs[kernel_modules * deps->count + j]);
+    }
+
+    /* the failed validation keeps the change recorded, fixing the data makes it pass */
+    assert_non_null(info->modified_subtrees);
+    val = calloc(1, sizeof(*val));
+    assert_non_null(val);
+    val->type = SR_UINT32_T;
+    val->data.uint32_val = 1500;
+    rc = rp_dt_set_item_wrapper(ctx, session, "/test-module:interface/ifMTU", val, NULL, SR_EDIT_DEFAULT);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    errors = NULL;
+    e_cnt = 0;
+    rc = dm_validate_session_data_trees(ctx->dm_ctx, session->dm_session, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    test_rp_session_cleanup(ctx, session);
+}
+
+
 int main(){
 
     sr_log_stderr(SR_LL_DBG);
@@ -2605,6 +2743,7 @@ int main(){
             cmocka_unit_test(candidate_commit_lock_test),
             cmocka_unit_test_setup(edit_union_type, createData),
             cmocka_unit_test_setup(validaton_of_multiple_models, createData),
+            cmocka_unit_test_setup(validation_of_modified_subtrees, createData),
     };
 
     watchdog_start(300);